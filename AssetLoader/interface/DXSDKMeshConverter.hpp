@@ -0,0 +1,73 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "../../../DiligentCore/Primitives/interface/BasicTypes.h"
+
+namespace tinygltf
+{
+class Model;
+} // namespace tinygltf
+
+namespace Diligent
+{
+
+class DXSDKMesh;
+
+namespace GLTF
+{
+
+/// Converts a DXSDKMesh into the glTF object model, so that legacy SDKMESH assets can be
+/// loaded by GLTF::Model and share the resource manager pools and draw batching with glTF models.
+
+/// \param[in]  Mesh       - Source mesh.
+/// \param[out] GltfModel  - glTF model that receives buffer views, accessors, meshes, nodes,
+///                          a scene, materials, textures and images.
+/// \param[out] BufferData - For every buffer in GltfModel, the pointer to the mesh vertex or index
+///                          data the buffer refers to. The buffers themselves are left empty, so the
+///                          data is never copied and the mesh must outlive the glTF model.
+///
+/// \remarks    Every mesh becomes a glTF mesh and every triangle-list subset becomes a primitive.
+///             Vertex accessors cover the vertex buffers starting at the subset's first vertex,
+///             so subsets that share the vertex range share the accessors and are converted only once.
+///             Index accessors address the subset's index range.
+///
+///             Frames become nodes with the frame matrices; if there are no frames,
+///             a root node is created for every mesh.
+///
+///             Images only reference the texture file names through the uri,
+///             the application is responsible for loading the image data.
+void ConvertDXSDKMeshToGltf(const DXSDKMesh&           Mesh,
+                            tinygltf::Model&           GltfModel,
+                            std::vector<const Uint8*>& BufferData);
+
+} // namespace GLTF
+
+} // namespace Diligent
@@ -28,6 +28,7 @@
 #pragma once
 
 #include <vector>
+#include <memory>
 
 #include "../../../DiligentCore/Primitives/interface/BasicTypes.h"
 #include "../../../DiligentCore/Graphics/GraphicsEngine/interface/RenderDevice.h"
@@ -328,10 +329,33 @@ struct SDKANIMATION_FRAME_DATA
 class DXSDKMesh
 {
 public:
+    DXSDKMesh();
     virtual ~DXSDKMesh();
 
+    // clang-format off
+    DXSDKMesh           (const DXSDKMesh&) = delete;
+    DXSDKMesh& operator=(const DXSDKMesh&) = delete;
+    // clang-format on
+
+    /// Loads the mesh from the file.
+
+    /// \remarks   Where the platform supports it, the file is memory-mapped with a private
+    ///             copy-on-write mapping, so only the pages touched by the pointer fixup are copied.
+    ///             Otherwise the file is read into memory.
     bool Create(const Char* szFileName);
-    bool Create(Uint8* pData, Uint32 DataUint8s);
+
+    /// Loads the mesh from memory.
+
+    /// \param [in] pData      - Mesh file data.
+    /// \param [in] DataUint8s - Data size, in bytes.
+    /// \param [in] InPlace    - If false, the data is copied. If true, the mesh
+    ///                          references the data directly and patches the pointers
+    ///                          in it, so the buffer must be writable, 8-byte aligned
+    ///                          and must outlive the mesh.
+    ///
+    /// \remarks   Header, array offsets, buffer ranges and subset index ranges
+    ///             are validated before the data is used.
+    bool Create(Uint8* pData, Uint32 DataUint8s, bool InPlace = false);
     void LoadGPUResources(const Char* ResourceDirectory, IRenderDevice* pDevice, IDeviceContext* pDeviceCtx);
     void Destroy();
 
@@ -348,6 +372,7 @@ public:
     Uint32 GetNumMaterials() const { return m_pMeshHeader ? m_pMeshHeader->NumMaterials : 0; }
     Uint32 GetNumVBs()       const { return m_pMeshHeader ? m_pMeshHeader->NumVertexBuffers : 0; }
     Uint32 GetNumIBs()       const { return m_pMeshHeader ? m_pMeshHeader->NumIndexBuffers : 0; }
+    Uint32 GetNumFrames()    const { return m_pMeshHeader ? m_pMeshHeader->NumFrames : 0; }
     // clang-format on
 
     const Uint8*              GetRawVerticesAt(Uint32 iVB) const { return m_ppVertices[iVB]; }
@@ -371,6 +396,21 @@ public:
         return (Uint32)m_pVertexBufferArray[iVB].StrideUint8s;
     }
 
+    Uint64 GetNumVertices(Uint32 iVB) const
+    {
+        return m_pVertexBufferArray[iVB].NumVertices;
+    }
+
+    Uint64 GetNumIndices(Uint32 iIB) const
+    {
+        return m_pIndexBufferArray[iIB].NumIndices;
+    }
+
+    DXSDKMESH_INDEX_TYPE GetIBIndexType(Uint32 iIB) const
+    {
+        return (DXSDKMESH_INDEX_TYPE)m_pIndexBufferArray[iIB].IndexType;
+    }
+
     Uint64 GetNumMeshVertices(Uint32 iMesh, Uint32 iVB) const
     {
         return m_pVertexBufferArray[m_pMeshArray[iMesh].VertexBuffers[iVB]].NumVertices;
@@ -391,22 +431,28 @@ public:
         return m_IndexBuffers[m_pMeshArray[iMesh].IndexBuffer];
     }
 
-    const DXSDKMESH_VERTEX_ELEMENT* VBElements(Uint32 iVB) const { return m_pVertexBufferArray[0].Decl; }
+    const DXSDKMESH_VERTEX_ELEMENT* VBElements(Uint32 iVB) const { return m_pVertexBufferArray[iVB].Decl; }
 
-    //Uint32                          GetNumFrames();
-    //DXSDKMESH_FRAME*                GetFrame( Uint32 iFrame );
+    const DXSDKMESH_FRAME& GetFrame(Uint32 iFrame) const { return m_pFrameArray[iFrame]; }
     //DXSDKMESH_FRAME*                FindFrame( char* pszName );
 
 protected:
     bool CreateFromFile(const char* szFileName);
 
     bool CreateFromMemory(Uint8* pData,
-                          Uint32 DataUint8s);
+                          Uint32 DataUint8s,
+                          bool   InPlace);
 
     void ComputeBoundingBoxes();
 
     //These are the pointers to the two chunks of data loaded in from the mesh file
     std::vector<Uint8> m_StaticMeshData;
+
+    // Mesh data: points to m_StaticMeshData, the memory-mapped file or the application-provided memory.
+    Uint8* m_pStaticMeshData = nullptr;
+
+    struct MappedFile;
+    std::unique_ptr<MappedFile> m_pMappedFile;
     //Uint8*  m_pAnimationData    = nullptr;
     std::vector<Uint8*> m_ppVertices;
     std::vector<Uint8*> m_ppIndices;
@@ -0,0 +1,144 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "../../../DiligentCore/Primitives/interface/BasicTypes.h"
+#include "../../../DiligentCore/Common/interface/BasicMath.hpp"
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+/// Animation compression parameters.
+///
+/// \remarks    All tolerances are distances in model units. Rotation and scale errors are measured
+///             as the displacement of a virtual vertex located at ShellDistance from the node origin.
+///             The default values are suitable for characters modeled in meters.
+struct AnimationCompressionInfo
+{
+    /// Maximum translation error.
+    float TranslationTolerance = 1e-4f;
+
+    /// Maximum displacement of the virtual vertex caused by the rotation error.
+    float RotationTolerance = 1e-4f;
+
+    /// Maximum displacement of the virtual vertex caused by the scale error.
+    float ScaleTolerance = 1e-4f;
+
+    /// Distance from the node origin to the virtual vertex, e.g. the typical distance
+    /// from a joint to the skinned vertices it influences.
+    float ShellDistance = 0.03f;
+};
+
+/// Animation track with reduced key frames and quantized key values.
+///
+/// \remarks    Rotations are stored as 48-bit quaternions (the three smallest components),
+///             and translation and scale as 16-bit values per component, normalized to the
+///             track value range, so that every key takes 10 bytes instead of 20.
+class CompressedAnimationTrack
+{
+public:
+    enum class TRACK_TYPE : Uint8
+    {
+        TRANSLATION,
+        ROTATION,
+        SCALE
+    };
+
+    CompressedAnimationTrack() = default;
+
+    /// Compresses the track.
+    ///
+    /// \param [in] Type      - track type that defines the key value format and the error metric.
+    /// \param [in] pTimes    - key times, must be increasing.
+    /// \param [in] pValues   - key values. Rotations are stored as (x, y, z, w) quaternions.
+    /// \param [in] NumKeys   - the number of keys.
+    /// \param [in] Step      - whether the track uses step interpolation (linear otherwise).
+    /// \param [in] Info      - compression parameters.
+    ///
+    /// \remarks    Keys are removed as long as the track deviates from the source track by no
+    ///             more than 90% of the tolerance at every source key time and, for linear tracks,
+    ///             in the middle between the source keys. The margin keeps the error between
+    ///             these points, where rotations are not checked exactly, within the tolerance.
+    ///             The first and the last keys are always kept, so that the track duration is preserved.
+    ///             If the quantized key values exceed the tolerance (e.g. for a translation track
+    ///             with a very large range), the track is left empty, see IsEmpty().
+    CompressedAnimationTrack(TRACK_TYPE                      Type,
+                             const float*                    pTimes,
+                             const float4*                   pValues,
+                             Uint32                          NumKeys,
+                             bool                            Step,
+                             const AnimationCompressionInfo& Info);
+
+    /// Samples the track at the given time, which is clamped to the track time range.
+    /// Rotations are interpolated with normalized lerp, which is faster than slerp and is
+    /// accounted for by the compression error checks, and are returned as normalized (x, y, z, w) quaternions.
+    float4 Sample(float Time) const;
+
+    bool IsEmpty() const { return m_KeyTimes.empty(); }
+
+    TRACK_TYPE GetType() const { return m_Type; }
+
+    Uint32 GetKeyCount() const { return static_cast<Uint32>(m_KeyTimes.size()); }
+
+    /// Returns the time of the key with the given index.
+    float GetKeyTime(Uint32 Key) const;
+
+    /// Returns the decoded value of the key with the given index.
+    float4 GetKeyValue(Uint32 Key) const;
+
+    /// Returns the size of the memory used by the key data, in bytes.
+    size_t GetMemorySize() const;
+
+    /// Returns the error between two values of the given track type, see AnimationCompressionInfo.
+    static float ComputeError(TRACK_TYPE Type, const float4& Value0, const float4& Value1, float ShellDistance);
+
+private:
+    void EncodeValue(const float4& Value, Uint16* pEncoded) const;
+
+    float4 DecodeValue(const Uint16* pEncoded) const;
+
+    TRACK_TYPE m_Type = TRACK_TYPE::TRANSLATION;
+    bool       m_Step = false;
+
+    // Translation and scale range
+    float3 m_RangeMin;
+    float3 m_RangeStep;
+
+    std::vector<float>  m_KeyTimes;
+    // Three values per key
+    std::vector<Uint16> m_KeyValues;
+};
+
+} // namespace GLTF
+
+} // namespace Diligent
@@ -31,6 +31,8 @@
 #include <vector>
 #include <algorithm>
 #include <string>
+#include <array>
+#include <limits>
 
 #include "GLTFLoader.hpp"
 #include "GraphicsAccessories.hpp"
@@ -72,15 +74,36 @@ public:
     ModelBuilder(const ModelCreateInfo& _CI, Model& _Model);
     ~ModelBuilder();
 
+    // If pDevice is null and the resource manager is not used, GPU buffers are not created,
+    // and the converted vertex and index data can be read with GetVertexData() and GetIndexData().
     template <typename GltfModelType>
     void Execute(const GltfModelType& GltfModel,
                  int                  SceneIndex,
                  IRenderDevice*       pDevice);
 
+    // Returns the converted vertex data of the given vertex buffer.
+    // The data is moved to the resource manager's allocation if the manager is used.
+    const std::vector<Uint8>& GetVertexData(Uint32 BufferId) const
+    {
+        return m_VertexData[BufferId];
+    }
+
+    // Returns the converted indices of the given type, see Primitive::IndexType.
+    // The data is moved to the resource manager's allocation if the manager is used.
+    const std::vector<Uint8>& GetIndexData(VALUE_TYPE IndexType) const
+    {
+        return (IndexType == VT_UINT16 && m_Model.IndexData16.IndexSize != 0) ? m_IndexData16 : m_IndexData;
+    }
+
     static std::pair<FILTER_TYPE, FILTER_TYPE> GetFilterType(int32_t GltfFilterMode);
 
     static TEXTURE_ADDRESS_MODE GetAddressMode(int32_t GltfWrapMode);
 
+    // Returns tightly packed accessor data with sparse substitutions applied.
+    // Throws an exception if the accessor references data outside of its buffer views.
+    template <typename GltfModelType>
+    static std::vector<Uint8> ReadDenseAccessorData(const GltfModelType& GltfModel, int AccessorId);
+
 private:
     struct PrimitiveKey
     {
@@ -127,8 +150,25 @@ private:
     Light* LoadLight(const GltfModelType& GltfModel,
                      int                  GltfLightIndex);
 
+    // Throws an exception if the model does not fit into the memory budget
+    // after the vertex, index and morph target buffers are created.
+    void CheckMemoryBudget() const;
+
+    // Builds triangle hierarchies of all meshes from the CPU-side vertex and index data,
+    // see ModelCreateInfo::CreateMeshBVHs.
+    void CreateMeshBVHs();
+
+    // Computes joint bounding boxes of all skins from the CPU-side vertex data,
+    // see ModelCreateInfo::ComputeJointBounds.
+    void ComputeJointBounds();
+
+    // Removes redundant animation keys and quantizes the remaining ones,
+    // see ModelCreateInfo::pAnimationCompression.
+    void CompressAnimations();
+
     void InitIndexBuffer(IRenderDevice* pDevice);
     void InitVertexBuffers(IRenderDevice* pDevice);
+    void InitMorphTargetBuffer(IRenderDevice* pDevice);
 
     template <typename GltfModelType>
     bool LoadAnimationAndSkin(const GltfModelType& GltfModel);
@@ -169,11 +209,30 @@ private:
                                       Uint32                       NumElements,
                                       Uint32                       BaseVertex);
 
+    // Converts indices to IndexType and appends them to the corresponding index data.
     template <typename GltfModelType>
     Uint32 ConvertIndexData(const GltfModelType& GltfModel,
                             int                  AccessorId,
+                            VALUE_TYPE           IndexType,
                             Uint32               BaseVertex);
 
+    template <typename GltfModelType, typename GltfPrimitiveType>
+    Primitive::MorphTargetsInfo LoadMorphTargets(const GltfModelType&     GltfModel,
+                                                 const GltfPrimitiveType& GltfPrimitive,
+                                                 Uint32                   VertexCount);
+
+    template <typename GltfModelType>
+    Uint32 ConvertMorphTargetData(const GltfModelType& GltfModel,
+                                  const PrimitiveKey&  Key,
+                                  Uint32               NumTargets,
+                                  Uint32               AttribFlags,
+                                  Uint32               VertexCount);
+
+    template <typename GltfModelType, typename GltfNodeType>
+    void LoadInstances(const GltfModelType& GltfModel,
+                       const GltfNodeType&  GltfNode,
+                       Node&                NewNode);
+
     template <typename GltfModelType>
     void LoadSkins(const GltfModelType& GltfModel);
 
@@ -183,6 +242,11 @@ private:
     template <typename GltfModelType>
     auto GetGltfDataInfo(const GltfModelType& GltfModel, int AccessorId);
 
+    // Returns the data produced by ReadDenseAccessorData.
+    // The data is cached, so that every accessor is expanded only once.
+    template <typename GltfModelType>
+    const std::vector<Uint8>& GetDenseAccessorData(const GltfModelType& GltfModel, int AccessorId);
+
     // Returns the node pointer from the node index in the source GLTF model.
     Node* NodeFromGltfIndex(int GltfIndex) const
     {
@@ -192,6 +256,12 @@ private:
             nullptr;
     }
 
+    // Returns the index data that contains indices of the given type, see ModelCreateInfo::AdaptiveIndexType.
+    std::vector<Uint8>& GetDstIndexData(VALUE_TYPE IndexType)
+    {
+        return (IndexType == VT_UINT16 && m_Model.IndexData16.IndexSize != 0) ? m_IndexData16 : m_IndexData;
+    }
+
     template <typename GltfDataInfoType>
     bool ComputePrimitiveBoundingBox(const GltfDataInfoType& PosData, float3& Min, float3& Max) const;
 
@@ -216,10 +286,19 @@ private:
     std::unordered_map<int, int> m_NodeIdToSkinId;
 
     std::vector<Uint8>              m_IndexData;
+    std::vector<Uint8>              m_IndexData16; // Used with ModelCreateInfo::AdaptiveIndexType
     std::vector<std::vector<Uint8>> m_VertexData;
 
     std::unordered_map<PrimitiveKey, Uint32, PrimitiveKey::Hasher> m_PrimitiveOffsets;
 
+    // Morph target deltas, see Primitive::MorphTargetsInfo.
+    std::vector<Uint8> m_MorphTargetData;
+
+    std::unordered_map<PrimitiveKey, Uint32, PrimitiveKey::Hasher> m_MorphTargetOffsets;
+
+    // Expanded data of sparse accessors and accessors without buffer views.
+    std::unordered_map<int, std::vector<Uint8>> m_DenseAccessorData;
+
     int m_DefaultMaterialId = -1;
 };
 
@@ -379,15 +458,18 @@ Mesh* ModelBuilder::LoadMesh(const GltfModelType& GltfModel,
 
     NewMesh.Name = GltfMesh.GetName();
 
+    const auto& Weights = GltfMesh.GetWeights();
+    NewMesh.Weights.reserve(Weights.size());
+    for (auto Weight : Weights)
+        NewMesh.Weights.push_back(static_cast<float>(Weight));
+
     const size_t PrimitiveCount = GltfMesh.GetPrimitiveCount();
     NewMesh.Primitives.reserve(PrimitiveCount);
     for (size_t prim = 0; prim < PrimitiveCount; ++prim)
     {
         const auto& GltfPrimitive = GltfMesh.GetPrimitive(prim);
 
-        const auto DstIndexSize = m_Model.IndexData.IndexSize;
-
-        uint32_t IndexStart  = static_cast<uint32_t>(m_IndexData.size()) / DstIndexSize;
+        uint32_t IndexStart  = 0;
         uint32_t VertexStart = 0;
         uint32_t IndexCount  = 0;
         uint32_t VertexCount = 0;
@@ -441,9 +523,26 @@ Mesh* ModelBuilder::LoadMesh(const GltfModelType& GltfModel,
         }
 
         // Indices
+        VALUE_TYPE IndexType  = m_Model.IndexData.IndexSize == 4 ? VT_UINT32 : VT_UINT16;
+        Uint32     BaseVertex = 0;
+        if (m_CI.AdaptiveIndexType)
+        {
+            // Make indices relative to the first vertex so that 16-bit
+            // indices can be used whenever the primitive's vertex range fits.
+            IndexType  = VertexCount <= 0xFFFFu ? VT_UINT16 : VT_UINT32;
+            BaseVertex = VertexStart;
+        }
+        IndexStart = static_cast<uint32_t>(GetDstIndexData(IndexType).size() / GetValueSize(IndexType));
         if (GltfPrimitive.GetIndicesId() >= 0)
         {
-            IndexCount = ConvertIndexData(GltfModel, GltfPrimitive.GetIndicesId(), VertexStart);
+            IndexCount = ConvertIndexData(GltfModel, GltfPrimitive.GetIndicesId(), IndexType, VertexStart - BaseVertex);
+        }
+
+        // Morph targets
+        Primitive::MorphTargetsInfo MorphTargets;
+        if (GltfPrimitive.GetTargetCount() > 0)
+        {
+            MorphTargets = LoadMorphTargets(GltfModel, GltfPrimitive, VertexCount);
         }
 
         int MaterialId = GltfPrimitive.GetMaterialId();
@@ -465,6 +564,10 @@ Mesh* ModelBuilder::LoadMesh(const GltfModelType& GltfModel,
             PosMin,
             PosMax //
         );
+        NewMesh.Primitives.back().FirstVertex  = VertexStart;
+        NewMesh.Primitives.back().IndexType    = IndexType;
+        NewMesh.Primitives.back().BaseVertex   = BaseVertex;
+        NewMesh.Primitives.back().MorphTargets = MorphTargets;
 
         if (m_CI.PrimitiveLoadCallback)
             m_CI.PrimitiveLoadCallback(&GltfModel.Get(), &GltfPrimitive.Get(), NewMesh.Primitives.back());
@@ -646,6 +749,9 @@ Node* ModelBuilder::LoadNode(const GltfModelType& GltfModel,
     NewNode.pCamera = LoadCamera(GltfModel, GltfNode.GetCameraId());
     NewNode.pLight  = LoadLight(GltfModel, GltfNode.GetLightId());
 
+    if (NewNode.pMesh != nullptr)
+        LoadInstances(GltfModel, GltfNode, NewNode);
+
     if (m_CI.NodeLoadCallback)
     {
         m_CI.NodeLoadCallback(&GltfModel.Get(), GltfNodeIndex, &GltfNode.Get(), NewNode);
@@ -657,14 +763,29 @@ Node* ModelBuilder::LoadNode(const GltfModelType& GltfModel,
 template <typename GltfModelType>
 auto ModelBuilder::GetGltfDataInfo(const GltfModelType& GltfModel, int AccessorId)
 {
-    const auto  GltfAccessor  = GltfModel.GetAccessor(AccessorId);
-    const auto  GltfView      = GltfModel.GetBufferView(GltfAccessor.GetBufferViewId());
-    const auto  GltfBuffer    = GltfModel.GetBuffer(GltfView.GetBufferId());
-    const auto  SrcCount      = GltfAccessor.GetCount();
-    const auto  SrcByteStride = GltfAccessor.GetByteStride(GltfView);
-    const auto* pSrcData      = SrcCount > 0 ?
-        GltfBuffer.GetData(GltfAccessor.GetByteOffset() + GltfView.GetByteOffset()) :
-        nullptr;
+    const auto GltfAccessor = GltfModel.GetAccessor(AccessorId);
+    const auto SrcCount     = GltfAccessor.GetCount();
+
+    using ByteStrideType = decltype(GltfAccessor.GetByteStride(GltfModel.GetBufferView(GltfAccessor.GetBufferViewId())));
+
+    ByteStrideType SrcByteStride = 0;
+    const void*    pSrcData      = nullptr;
+    if (GltfAccessor.IsSparse() || GltfAccessor.GetBufferViewId() < 0)
+    {
+        // Sparse accessors and accessors without buffer views are expanded into tightly packed arrays
+        SrcByteStride = static_cast<ByteStrideType>(GetValueSize(GltfAccessor.GetComponentType()) * GltfAccessor.GetNumComponents());
+        if (SrcCount > 0)
+            pSrcData = GetDenseAccessorData(GltfModel, AccessorId).data();
+    }
+    else
+    {
+        const auto GltfView   = GltfModel.GetBufferView(GltfAccessor.GetBufferViewId());
+        const auto GltfBuffer = GltfModel.GetBuffer(GltfView.GetBufferId());
+
+        SrcByteStride = GltfAccessor.GetByteStride(GltfView);
+        if (SrcCount > 0)
+            pSrcData = GltfBuffer.GetData(GltfAccessor.GetByteOffset() + GltfView.GetByteOffset());
+    }
 
     struct GltfDataInfo
     {
@@ -678,6 +799,136 @@ auto ModelBuilder::GetGltfDataInfo(const GltfModelType& GltfModel, int AccessorI
     return GltfDataInfo{GltfAccessor, pSrcData, SrcCount, SrcByteStride};
 }
 
+template <typename GltfModelType>
+const std::vector<Uint8>& ModelBuilder::GetDenseAccessorData(const GltfModelType& GltfModel, int AccessorId)
+{
+    auto it = m_DenseAccessorData.find(AccessorId);
+    if (it != m_DenseAccessorData.end())
+        return it->second;
+
+    return m_DenseAccessorData.emplace(AccessorId, ReadDenseAccessorData(GltfModel, AccessorId)).first->second;
+}
+
+template <typename GltfModelType>
+std::vector<Uint8> ModelBuilder::ReadDenseAccessorData(const GltfModelType& GltfModel, int AccessorId)
+{
+    const auto GltfAccessor = GltfModel.GetAccessor(AccessorId);
+    const auto Count        = static_cast<size_t>(GltfAccessor.GetCount());
+    const auto ElementSize  = size_t{GetValueSize(GltfAccessor.GetComponentType())} * GltfAccessor.GetNumComponents();
+    if (ElementSize == 0)
+        LOG_ERROR_AND_THROW("Accessor ", AccessorId, " has invalid component type or number of components");
+    if (Count > std::numeric_limits<size_t>::max() / ElementSize)
+        LOG_ERROR_AND_THROW("Accessor ", AccessorId, " element count (", Count, ") is too large");
+
+    // Returns the size of the range that contains NumElements elements of size ElemSize located ElemStride bytes apart.
+    auto GetRangeSize = [AccessorId](size_t NumElements, size_t ElemStride, size_t ElemSize) {
+        if (NumElements == 0)
+            return size_t{0};
+        if (NumElements - 1 > (std::numeric_limits<size_t>::max() - ElemSize) / ElemStride)
+            LOG_ERROR_AND_THROW("Accessor ", AccessorId, " data range is too large");
+        return (NumElements - 1) * ElemStride + ElemSize;
+    };
+
+    // Returns the pointer to the Size bytes at the given offset from the start of the buffer view.
+    // Throws an exception if the range does not fit into the view or the view does not fit into its buffer.
+    auto GetBufferViewData = [&GltfModel, AccessorId](int ViewId, size_t Offset, size_t Size, const char* DataName) -> const Uint8* {
+        if (ViewId < 0 || static_cast<size_t>(ViewId) >= GltfModel.GetBufferViewCount())
+            LOG_ERROR_AND_THROW("Accessor ", AccessorId, " references invalid ", DataName, " buffer view ", ViewId);
+
+        const auto GltfView = GltfModel.GetBufferView(ViewId);
+        const auto BufferId = GltfView.GetBufferId();
+        if (BufferId < 0 || static_cast<size_t>(BufferId) >= GltfModel.GetBufferCount())
+            LOG_ERROR_AND_THROW("Buffer view ", ViewId, " references invalid buffer ", BufferId);
+
+        const auto GltfBuffer = GltfModel.GetBuffer(BufferId);
+        const auto ViewOffset = static_cast<size_t>(GltfView.GetByteOffset());
+        const auto ViewLength = static_cast<size_t>(GltfView.GetByteLength());
+        const auto BufferSize = static_cast<size_t>(GltfBuffer.GetSize());
+        if (ViewOffset > BufferSize || ViewLength > BufferSize - ViewOffset)
+            LOG_ERROR_AND_THROW("Buffer view ", ViewId, " range [", ViewOffset, ", ", ViewOffset + ViewLength, ") exceeds the size of buffer ", BufferId, " (", BufferSize, ")");
+        if (Offset > ViewLength || Size > ViewLength - Offset)
+            LOG_ERROR_AND_THROW("Accessor ", AccessorId, " ", DataName, " range [", Offset, ", ", Offset + Size, ") exceeds the length of buffer view ", ViewId, " (", ViewLength, ")");
+
+        return Size > 0 ? reinterpret_cast<const Uint8*>(GltfBuffer.GetData(ViewOffset + Offset)) : nullptr;
+    };
+
+    // When the accessor has no buffer view, all values are initialized with zeros
+    std::vector<Uint8> Data(Count * ElementSize);
+
+    const auto ViewId = GltfAccessor.GetBufferViewId();
+    if (ViewId >= 0 && Count > 0)
+    {
+        if (static_cast<size_t>(ViewId) >= GltfModel.GetBufferViewCount())
+            LOG_ERROR_AND_THROW("Accessor ", AccessorId, " references invalid buffer view ", ViewId);
+
+        const auto SrcStride = GltfAccessor.GetByteStride(GltfModel.GetBufferView(ViewId));
+        if (SrcStride <= 0 || static_cast<size_t>(SrcStride) < ElementSize)
+            LOG_ERROR_AND_THROW("Accessor ", AccessorId, " has invalid byte stride (", SrcStride, ")");
+
+        const auto pSrcData = GetBufferViewData(ViewId, static_cast<size_t>(GltfAccessor.GetByteOffset()),
+                                                GetRangeSize(Count, static_cast<size_t>(SrcStride), ElementSize), "element");
+        for (size_t i = 0; i < Count; ++i)
+            memcpy(&Data[i * ElementSize], pSrcData + i * static_cast<size_t>(SrcStride), ElementSize);
+    }
+
+    if (GltfAccessor.IsSparse())
+    {
+        // Negative counts and offsets wrap around and are rejected by the range checks below
+        const auto SparseCount = static_cast<size_t>(GltfAccessor.GetSparseCount());
+        if (SparseCount > Count)
+            LOG_ERROR_AND_THROW("Sparse element count (", GltfAccessor.GetSparseCount(), ") of accessor ", AccessorId, " exceeds the accessor element count (", Count, ")");
+
+        const auto IndexType = GltfAccessor.GetSparseIndicesComponentType();
+        if (IndexType != VT_UINT8 && IndexType != VT_UINT16 && IndexType != VT_UINT32)
+            LOG_ERROR_AND_THROW("Sparse index component type ", GetValueTypeString(IndexType), " of accessor ", AccessorId, " is not supported");
+        const size_t IndexSize = GetValueSize(IndexType);
+
+        // Sparse indices and values are always tightly packed
+        const auto pIndices = GetBufferViewData(GltfAccessor.GetSparseIndicesBufferViewId(), static_cast<size_t>(GltfAccessor.GetSparseIndicesByteOffset()),
+                                                SparseCount * IndexSize, "sparse indices");
+        const auto pValues  = GetBufferViewData(GltfAccessor.GetSparseValuesBufferViewId(), static_cast<size_t>(GltfAccessor.GetSparseValuesByteOffset()),
+                                                SparseCount * ElementSize, "sparse values");
+
+        for (size_t i = 0; i < SparseCount; ++i)
+        {
+            // Sparse data is not required to be aligned
+            size_t DstIdx = 0;
+            switch (IndexType)
+            {
+                case VT_UINT8:
+                    DstIdx = pIndices[i];
+                    break;
+
+                case VT_UINT16:
+                {
+                    Uint16 Idx16 = 0;
+                    memcpy(&Idx16, pIndices + i * sizeof(Uint16), sizeof(Uint16));
+                    DstIdx = Idx16;
+                    break;
+                }
+
+                case VT_UINT32:
+                {
+                    Uint32 Idx32 = 0;
+                    memcpy(&Idx32, pIndices + i * sizeof(Uint32), sizeof(Uint32));
+                    DstIdx = Idx32;
+                    break;
+                }
+
+                default:
+                    UNEXPECTED("Unexpected index type");
+            }
+
+            if (DstIdx >= Count)
+                LOG_ERROR_AND_THROW("Sparse index ", DstIdx, " of accessor ", AccessorId, " is out of range [0, ", Count, ")");
+
+            memcpy(&Data[DstIdx * ElementSize], pValues + i * ElementSize, ElementSize);
+        }
+    }
+
+    return Data;
+}
+
 template <typename GltfModelType>
 Uint32 ModelBuilder::ConvertVertexData(const GltfModelType& GltfModel,
                                        const PrimitiveKey&  Key,
@@ -795,18 +1046,20 @@ inline void ModelBuilder::WriteIndexData(const void*                  pSrc,
 template <typename GltfModelType>
 Uint32 ModelBuilder::ConvertIndexData(const GltfModelType& GltfModel,
                                       int                  AccessorId,
+                                      VALUE_TYPE           IndexType,
                                       Uint32               BaseVertex)
 {
     VERIFY_EXPR(AccessorId >= 0);
 
     const auto GltfIndices = GetGltfDataInfo(GltfModel, AccessorId);
-    const auto IndexSize   = m_Model.IndexData.IndexSize;
+    const auto IndexSize   = GetValueSize(IndexType);
     const auto IndexCount  = static_cast<uint32_t>(GltfIndices.Count);
 
-    auto IndexDataStart = m_IndexData.size();
+    auto& IndexData      = GetDstIndexData(IndexType);
+    auto  IndexDataStart = IndexData.size();
     VERIFY((IndexDataStart % IndexSize) == 0, "Current offset is not a multiple of index size");
-    m_IndexData.resize(IndexDataStart + size_t{IndexCount} * size_t{IndexSize});
-    auto index_it = m_IndexData.begin() + IndexDataStart;
+    IndexData.resize(IndexDataStart + size_t{IndexCount} * size_t{IndexSize});
+    auto index_it = IndexData.begin() + IndexDataStart;
 
     const auto ComponentType = GltfIndices.Accessor.GetComponentType();
     const auto SrcStride     = static_cast<size_t>(GltfIndices.ByteStride);
@@ -843,6 +1096,174 @@ Uint32 ModelBuilder::ConvertIndexData(const GltfModelType& GltfModel,
     return IndexCount;
 }
 
+template <typename GltfModelType, typename GltfPrimitiveType>
+Primitive::MorphTargetsInfo ModelBuilder::LoadMorphTargets(const GltfModelType&     GltfModel,
+                                                           const GltfPrimitiveType& GltfPrimitive,
+                                                           Uint32                   VertexCount)
+{
+    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#morph-targets
+    static constexpr const char* AttribNames[] = {PositionAttributeName, NormalAttributeName, TangentAttributeName};
+    static_assert(_countof(AttribNames) == MORPH_TARGET_ATTRIB_COUNT, "Please update the attribute names array");
+
+    Primitive::MorphTargetsInfo MorphTargets;
+    MorphTargets.Count = static_cast<Uint32>(GltfPrimitive.GetTargetCount());
+
+    PrimitiveKey Key;
+    Key.AccessorIds.resize(size_t{MorphTargets.Count} * MORPH_TARGET_ATTRIB_COUNT, -1);
+    for (Uint32 target = 0; target < MorphTargets.Count; ++target)
+    {
+        for (Uint32 attrib = 0; attrib < MORPH_TARGET_ATTRIB_COUNT; ++attrib)
+        {
+            if (const auto* pAccessorId = GltfPrimitive.GetTargetAttribute(target, AttribNames[attrib]))
+            {
+                Key.AccessorIds[size_t{target} * MORPH_TARGET_ATTRIB_COUNT + attrib] = *pAccessorId;
+                MorphTargets.AttribFlags |= 1u << attrib;
+            }
+        }
+    }
+
+    if (MorphTargets.AttribFlags == 0)
+    {
+        // Targets only contain attributes we don't support
+        MorphTargets.Count = 0;
+        return MorphTargets;
+    }
+
+    // Primitives that use the same targets share the deltas
+    auto offset_it = m_MorphTargetOffsets.find(Key);
+    if (offset_it == m_MorphTargetOffsets.end())
+    {
+        const auto Offset = ConvertMorphTargetData(GltfModel, Key, MorphTargets.Count, MorphTargets.AttribFlags, VertexCount);
+        offset_it         = m_MorphTargetOffsets.emplace(Key, Offset).first;
+    }
+    MorphTargets.FirstDelta = offset_it->second;
+
+    return MorphTargets;
+}
+
+template <typename GltfModelType>
+Uint32 ModelBuilder::ConvertMorphTargetData(const GltfModelType& GltfModel,
+                                            const PrimitiveKey&  Key,
+                                            Uint32               NumTargets,
+                                            Uint32               AttribFlags,
+                                            Uint32               VertexCount)
+{
+    constexpr auto DeltaStride = Model::MorphTargetDeltaStride;
+    VERIFY_EXPR(m_MorphTargetData.size() % DeltaStride == 0);
+
+    const auto FirstDelta = static_cast<Uint32>(m_MorphTargetData.size() / DeltaStride);
+    const auto NumAttribs = PlatformMisc::CountOneBits(AttribFlags);
+
+    // Attributes that are missing in some targets are left zero
+    auto DataOffset = m_MorphTargetData.size();
+    m_MorphTargetData.resize(DataOffset + size_t{NumTargets} * NumAttribs * VertexCount * DeltaStride);
+
+    for (Uint32 target = 0; target < NumTargets; ++target)
+    {
+        for (Uint32 attrib = 0; attrib < MORPH_TARGET_ATTRIB_COUNT; ++attrib)
+        {
+            if ((AttribFlags & (1u << attrib)) == 0)
+                continue;
+
+            const auto AccessorId = Key.AccessorIds[size_t{target} * MORPH_TARGET_ATTRIB_COUNT + attrib];
+            if (AccessorId >= 0)
+            {
+                const auto GltfDeltas = GetGltfDataInfo(GltfModel, AccessorId);
+                if (static_cast<Uint32>(GltfDeltas.Count) == VertexCount)
+                {
+                    WriteGltfData({GltfDeltas.pData,
+                                   GltfDeltas.Accessor.GetComponentType(),
+                                   static_cast<Uint32>(GltfDeltas.Accessor.GetNumComponents()),
+                                   static_cast<Uint32>(GltfDeltas.ByteStride),
+                                   m_MorphTargetData.begin() + DataOffset,
+                                   VT_FLOAT32,
+                                   3,
+                                   DeltaStride,
+                                   VertexCount,
+                                   GltfDeltas.Accessor.IsNormalized()});
+                }
+                else
+                {
+                    LOG_ERROR_MESSAGE("Morph target ", target, " accessor ", AccessorId, " contains ", GltfDeltas.Count,
+                                      " elements, while the primitive contains ", VertexCount, " vertices. The target is ignored.");
+                }
+            }
+
+            DataOffset += size_t{VertexCount} * DeltaStride;
+        }
+    }
+    VERIFY_EXPR(DataOffset == m_MorphTargetData.size());
+
+    return FirstDelta;
+}
+
+template <typename GltfModelType, typename GltfNodeType>
+void ModelBuilder::LoadInstances(const GltfModelType& GltfModel,
+                                 const GltfNodeType&  GltfNode,
+                                 Node&                NewNode)
+{
+    // https://github.com/KhronosGroup/glTF/tree/main/extensions/2.0/Vendor/EXT_mesh_gpu_instancing
+    static constexpr const char* AttribNames[]   = {"TRANSLATION", "ROTATION", "SCALE"};
+    static constexpr Uint32      NumComponents[] = {3, 4, 3};
+
+    // Attributes are unpacked into float4 arrays
+    std::array<std::vector<float4>, _countof(AttribNames)> Values;
+
+    size_t InstanceCount = 0;
+    for (size_t i = 0; i < Values.size(); ++i)
+    {
+        const auto AccessorId = GltfNode.GetInstanceAttribute(AttribNames[i]);
+        if (AccessorId < 0)
+            continue;
+
+        const auto GltfData = GetGltfDataInfo(GltfModel, AccessorId);
+        const auto Count    = static_cast<size_t>(GltfData.Count);
+        if (InstanceCount != 0 && Count != InstanceCount)
+        {
+            LOG_ERROR_MESSAGE("Instance attribute ", AttribNames[i], " of node '", NewNode.Name, "' contains ", Count,
+                              " elements, while other attributes contain ", InstanceCount, ". Instancing is ignored.");
+            return;
+        }
+        InstanceCount = Count;
+
+        std::vector<Uint8> Data(Count * sizeof(float4));
+        WriteGltfData({GltfData.pData,
+                       GltfData.Accessor.GetComponentType(),
+                       static_cast<Uint32>(GltfData.Accessor.GetNumComponents()),
+                       static_cast<Uint32>(GltfData.ByteStride),
+                       Data.begin(),
+                       VT_FLOAT32,
+                       NumComponents[i],
+                       sizeof(float4),
+                       static_cast<Uint32>(Count),
+                       GltfData.Accessor.IsNormalized()});
+        Values[i].resize(Count);
+        memcpy(Values[i].data(), Data.data(), Data.size());
+    }
+
+    if (InstanceCount == 0)
+        return;
+
+    NewNode.InstanceMatrices.resize(InstanceCount);
+    for (size_t inst = 0; inst < InstanceCount; ++inst)
+    {
+        float3      Translation;
+        QuaternionF Rotation;
+        float3      Scale{1, 1, 1};
+        if (!Values[0].empty())
+            Translation = float3{Values[0][inst].x, Values[0][inst].y, Values[0][inst].z};
+        if (!Values[1].empty())
+            Rotation.q = Values[1][inst];
+        if (!Values[2].empty())
+            Scale = float3{Values[2][inst].x, Values[2][inst].y, Values[2][inst].z};
+
+        NewNode.InstanceMatrices[inst] = ComputeNodeLocalMatrix(Scale, Rotation, Translation, float4x4::Identity());
+    }
+
+    NewNode.FirstInstance = m_Model.InstanceCount;
+    m_Model.InstanceCount += static_cast<Uint32>(InstanceCount);
+}
+
 template <typename GltfModelType>
 void ModelBuilder::LoadSkins(const GltfModelType& GltfModel)
 {
@@ -1085,8 +1506,20 @@ void ModelBuilder::Execute(const GltfModelType& GltfModel,
 
     LoadAnimationAndSkin(GltfModel);
 
+    if (m_CI.CreateMeshBVHs)
+        CreateMeshBVHs();
+
+    if (m_CI.ComputeJointBounds)
+        ComputeJointBounds();
+
+    if (m_CI.pAnimationCompression != nullptr)
+        CompressAnimations();
+
+    CheckMemoryBudget();
+
     InitIndexBuffer(pDevice);
     InitVertexBuffers(pDevice);
+    InitMorphTargetBuffer(pDevice);
 }
 
 class MaterialBuilder
@@ -0,0 +1,113 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include "../../../DiligentCore/Primitives/interface/BasicTypes.h"
+#include "../../../DiligentCore/Graphics/GraphicsEngine/interface/GraphicsTypes.h"
+#include "../../../DiligentCore/Common/interface/AdvancedMath.hpp"
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+/// Skinned vertex attributes used to compute joint bounding boxes.
+struct SkinnedVertexData
+{
+    /// Vertex positions (three floats).
+    const void* pPositions = nullptr;
+
+    /// Stride between vertex positions, in bytes.
+    Uint32 PositionStride = sizeof(float3);
+
+    /// Joint indices. Every vertex references NumInfluences joints.
+    const void* pJoints = nullptr;
+
+    /// Joint index type: VT_FLOAT32, VT_UINT8, VT_UINT16 or VT_UINT32.
+    VALUE_TYPE JointType = VT_FLOAT32;
+
+    /// Stride between vertex joint indices, in bytes.
+    Uint32 JointStride = 0;
+
+    /// Joint weights.
+    const void* pWeights = nullptr;
+
+    /// Weight type: VT_FLOAT32, or normalized VT_UINT8 or VT_UINT16.
+    VALUE_TYPE WeightType = VT_FLOAT32;
+
+    /// Stride between vertex weights, in bytes.
+    Uint32 WeightStride = 0;
+
+    /// The number of joint influences per vertex.
+    Uint32 NumInfluences = 4;
+
+    /// The number of vertices.
+    Uint32 NumVertices = 0;
+};
+
+/// Grows joint-space bounding boxes of the vertices influenced by every joint.
+///
+/// \param [in]      Vertices             - skinned vertex data.
+/// \param [in]      pInverseBindMatrices - inverse bind matrices of the joints that transform
+///                                         vertex positions into the joint space, or null if
+///                                         the matrices are identities.
+/// \param [in]      NumJoints            - the number of joints.
+/// \param [in]      WeightThreshold      - influences with weights that are not greater than this value are ignored.
+/// \param [in, out] pJointBounds         - joint bounding boxes to grow. A box of a joint that does not
+///                                         influence any vertex should be initialized with
+///                                         Min = +FLT_MAX and Max = -FLT_MAX.
+///
+/// \remarks    As the skinned position is a convex combination of the positions transformed by
+///             every joint, the union of the transformed joint boxes contains the skinned vertices
+///             in any pose, provided that the weights are normalized and the threshold is zero.
+///             Joint indices that are out of range are ignored.
+void ComputeJointBoundingBoxes(const SkinnedVertexData& Vertices,
+                               const float4x4*          pInverseBindMatrices,
+                               Uint32                   NumJoints,
+                               float                    WeightThreshold,
+                               BoundBox*                pJointBounds);
+
+/// Computes the bounding box of the skinned vertices from the joint bounding boxes.
+///
+/// \param [in] pJointBounds     - joint-space bounding boxes computed by ComputeJointBoundingBoxes().
+/// \param [in] pJointTransforms - transforms from the joint space to the target space,
+///                                e.g. global joint node matrices.
+/// \param [in] NumJoints        - the number of joints.
+///
+/// \return     The bounding box in the target space, or a box with Min = +FLT_MAX and
+///             Max = -FLT_MAX if no joint influences any vertex.
+///
+/// \remarks    The method runs in O(NumJoints) time and does not touch the vertices.
+BoundBox ComputeSkinBoundingBox(const BoundBox* pJointBounds,
+                                const float4x4* pJointTransforms,
+                                Uint32          NumJoints);
+
+} // namespace GLTF
+
+} // namespace Diligent
@@ -0,0 +1,275 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <limits>
+
+#include "../../../DiligentCore/Primitives/interface/BasicTypes.h"
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+/// JSON value type.
+enum JSON_TYPE : Uint8
+{
+    JSON_TYPE_NULL = 0,
+    JSON_TYPE_FALSE,
+    JSON_TYPE_TRUE,
+    JSON_TYPE_NUMBER,
+    JSON_TYPE_STRING,
+    JSON_TYPE_ARRAY,
+    JSON_TYPE_OBJECT
+};
+
+class JsonIndex;
+
+/// A lightweight handle to a value in the JsonIndex.
+///
+/// \remarks    The handle is only valid while the index it was obtained from is alive.
+///             Numbers and strings are decoded from the source text every time they are accessed.
+class JsonValue
+{
+public:
+    JsonValue() noexcept {}
+
+    JsonValue(const JsonIndex* pIndex, Uint32 TokenId) noexcept :
+        m_pIndex{pIndex},
+        m_TokenId{TokenId}
+    {}
+
+    bool IsValid() const
+    {
+        return m_pIndex != nullptr;
+    }
+
+    explicit operator bool() const
+    {
+        return IsValid();
+    }
+
+    /// Returns the value type. Invalid values are reported as JSON_TYPE_NULL.
+    JSON_TYPE GetType() const;
+
+    // clang-format off
+    bool IsNull()   const { return GetType() == JSON_TYPE_NULL;   }
+    bool IsBool()   const { return GetType() == JSON_TYPE_FALSE || GetType() == JSON_TYPE_TRUE; }
+    bool IsNumber() const { return GetType() == JSON_TYPE_NUMBER; }
+    bool IsString() const { return GetType() == JSON_TYPE_STRING; }
+    bool IsArray()  const { return GetType() == JSON_TYPE_ARRAY;  }
+    bool IsObject() const { return GetType() == JSON_TYPE_OBJECT; }
+    // clang-format on
+
+    /// Returns the number of array elements or object members.
+    Uint32 GetSize() const;
+
+    /// Returns the array element with the given index, or invalid value if the index is out of range.
+    ///
+    /// \remarks    The complexity is linear in the index. Use ProcessElements() to iterate over all elements.
+    JsonValue operator[](Uint32 Idx) const;
+
+    /// Returns the value of the object member with the given key, or invalid value if there is no such member.
+    JsonValue Find(const char* Key) const;
+
+    /// Calls Handler(Uint32 Idx, const JsonValue& Element) for every array element.
+    template <typename HandlerType>
+    void ProcessElements(HandlerType&& Handler) const;
+
+    /// Calls Handler(const JsonValue& Key, const JsonValue& Value) for every object member.
+    template <typename HandlerType>
+    void ProcessMembers(HandlerType&& Handler) const;
+
+    /// Returns the number value, or Default if the value is not a number.
+    double GetNumber(double Default = 0) const;
+
+    /// Returns the number value converted to an integer, or Default if the value is not a number
+    /// or is out of the int range.
+    int GetInt(int Default = 0) const
+    {
+        const auto Number = GetNumber(std::numeric_limits<double>::quiet_NaN());
+        // Comparisons with NaN are false
+        return Number > static_cast<double>(std::numeric_limits<int>::min()) - 1 && Number < static_cast<double>(std::numeric_limits<int>::max()) + 1 ?
+            static_cast<int>(Number) :
+            Default;
+    }
+
+    /// Reads the number value as a non-negative integer.
+    ///
+    /// eturn     false if the value is not a number, is negative, has a fractional part,
+    ///             or is greater than MaxValue. Value is not modified in this case.
+    bool GetUint(Uint64& Value, Uint64 MaxValue = ~Uint64{0}) const;
+
+    /// Returns the boolean value, or Default if the value is not a boolean.
+    bool GetBool(bool Default = false) const;
+
+    /// Returns the decoded string, or Default if the value is not a string.
+    std::string GetString(const char* Default = "") const;
+
+    /// Checks if the value is a string equal to Str.
+    bool StringEquals(const char* Str) const;
+
+    /// Returns the elements of a number array. Elements that are not numbers are converted to zero.
+    template <typename T>
+    std::vector<T> GetNumberArray() const
+    {
+        std::vector<T> Values;
+        if (IsArray())
+        {
+            Values.reserve(GetSize());
+            ProcessElements([&Values](Uint32, const JsonValue& Elem) {
+                Values.push_back(static_cast<T>(Elem.GetNumber()));
+            });
+        }
+        return Values;
+    }
+
+    /// Returns a pointer to the source text of the value.
+    const char* GetRawData() const;
+
+    /// Returns the size of the source text of the value, including quotes for strings.
+    size_t GetRawSize() const;
+
+private:
+    friend class JsonIndex;
+
+    Uint32 GetFirstChild() const { return m_TokenId + 1; }
+    Uint32 GetNextSibling(Uint32 TokenId) const;
+
+    const JsonIndex* m_pIndex  = nullptr;
+    Uint32           m_TokenId = 0;
+};
+
+/// Structural index of a JSON document.
+///
+/// The document is tokenized in a single pass into a flat array of value records. Unlike
+/// a DOM, the index does not allocate memory for individual values and does not decode strings
+/// and numbers until they are accessed, which makes it considerably faster to build for large
+/// documents where most of the data is only read once.
+class JsonIndex
+{
+public:
+    /// Indexes the JSON text.
+    ///
+    /// \param [in]  pText  - JSON text. The text must remain valid for the lifetime of the index.
+    /// \param [in]  Size   - Text size, in bytes.
+    /// \param [out] pError - Optional pointer to the string that receives the error message.
+    ///
+    /// \return     true if the text is a valid JSON document, and false otherwise.
+    bool Parse(const char* pText, size_t Size, std::string* pError = nullptr);
+
+    /// Returns the root value, or invalid value if the index is empty.
+    JsonValue GetRoot() const
+    {
+        return !m_Tokens.empty() ? JsonValue{this, 0} : JsonValue{};
+    }
+
+    /// Returns the number of values in the document, including object keys.
+    size_t GetTokenCount() const
+    {
+        return m_Tokens.size();
+    }
+
+private:
+    friend class JsonValue;
+
+    struct Token
+    {
+        // Offset of the first character of the value in the source text.
+        // For strings, the offset of the first character after the opening quote.
+        Uint32 Offset = 0;
+
+        // The length of the value in the source text (excluding quotes for strings).
+        Uint32 Length = 0;
+
+        // Index of the token that follows this value and all its children.
+        Uint32 End = 0;
+
+        // The number of array elements or object members.
+        Uint32 Size = 0;
+
+        JSON_TYPE Type = JSON_TYPE_NULL;
+
+        // Whether the string contains escape sequences.
+        bool Escaped = false;
+    };
+
+    const Token& GetToken(Uint32 TokenId) const
+    {
+        return m_Tokens[TokenId];
+    }
+
+    const char*        m_pText = nullptr;
+    size_t             m_Size  = 0;
+    std::vector<Token> m_Tokens;
+};
+
+
+inline Uint32 JsonValue::GetNextSibling(Uint32 TokenId) const
+{
+    return m_pIndex->GetToken(TokenId).End;
+}
+
+template <typename HandlerType>
+void JsonValue::ProcessElements(HandlerType&& Handler) const
+{
+    if (!IsArray())
+        return;
+
+    const auto Size    = GetSize();
+    Uint32     TokenId = GetFirstChild();
+    for (Uint32 i = 0; i < Size; ++i)
+    {
+        Handler(i, JsonValue{m_pIndex, TokenId});
+        TokenId = GetNextSibling(TokenId);
+    }
+}
+
+template <typename HandlerType>
+void JsonValue::ProcessMembers(HandlerType&& Handler) const
+{
+    if (!IsObject())
+        return;
+
+    const auto Size  = GetSize();
+    Uint32     KeyId = GetFirstChild();
+    for (Uint32 i = 0; i < Size; ++i)
+    {
+        // Object members are stored as key-value pairs
+        Handler(JsonValue{m_pIndex, KeyId}, JsonValue{m_pIndex, KeyId + 1});
+        KeyId = GetNextSibling(KeyId + 1);
+    }
+}
+
+} // namespace GLTF
+
+} // namespace Diligent
@@ -29,6 +29,7 @@
 
 #include <vector>
 #include <array>
+#include <memory>
 #include <cfloat>
 #include <unordered_map>
 #include <mutex>
@@ -46,6 +47,11 @@
 #include "../../../DiligentCore/Common/interface/AdvancedMath.hpp"
 #include "../../../DiligentCore/Common/interface/STDAllocator.hpp"
 #include "GLTFResourceManager.hpp"
+#include "GLTFMemoryUsage.hpp"
+#include "GLTFUploadScheduler.hpp"
+#include "GLTFMeshBVH.hpp"
+#include "GLTFJointBounds.hpp"
+#include "GLTFAnimationCompression.hpp"
 
 namespace tinygltf
 {
@@ -62,12 +68,14 @@ namespace Diligent
 {
 
 enum IMAGE_FILE_FORMAT : Uint8;
+struct IThreadPool;
 
 namespace GLTF
 {
 
 class ModelBuilder;
 class MaterialBuilder;
+class ModelWriter;
 
 /// Texture attribute description.
 struct TextureAttributeDesc
@@ -327,6 +335,16 @@ public:
         return IsTextureAttribActive(Idx) ? TextureAttribs[GetActiveTextureAttribPackedIndex(Idx)] : DefaultAttribs;
     }
 
+    /// Resets the attributes that do not affect the material appearance to their default
+    /// values, so that visually identical materials have identical contents.
+    void Canonicalize();
+
+    /// Computes the hash of the material contents.
+    size_t ComputeHash() const;
+
+    /// Returns true if the contents of two materials are identical.
+    bool operator==(const Material& Rhs) const;
+
     template <typename HandlerType>
     void ProcessActiveTextureAttibs(HandlerType&& Handler) const
     {
@@ -343,15 +361,91 @@ public:
 };
 
 
+/// Morph target attribute.
+enum MORPH_TARGET_ATTRIB : Uint8
+{
+    MORPH_TARGET_ATTRIB_POSITION = 0,
+    MORPH_TARGET_ATTRIB_NORMAL,
+    MORPH_TARGET_ATTRIB_TANGENT,
+    MORPH_TARGET_ATTRIB_COUNT
+};
+
 struct Primitive
 {
     const Uint32 FirstIndex;
     const Uint32 IndexCount;
     const Uint32 VertexCount;
-    const Uint32 MaterialId;
+    Uint32       MaterialId; // May be remapped by Model::DeduplicateMaterials()
+
+    // Index of the primitive's first vertex, relative to Model::GetBaseVertex().
+    // Note that unless ModelCreateInfo::AdaptiveIndexType is used, indices already include this offset.
+    Uint32 FirstVertex = 0;
+
+    // Index type of the primitive. FirstIndex is relative to Model::GetFirstIndexLocation(IndexType)
+    // in the buffer returned by Model::GetIndexBuffer(IndexType).
+    VALUE_TYPE IndexType = VT_UINT32;
+
+    // Value that should be added to the primitive's indices, in addition to Model::GetBaseVertex(),
+    // when drawing the primitive. It is equal to FirstVertex when ModelCreateInfo::AdaptiveIndexType
+    // is used, and zero otherwise.
+    Uint32 BaseVertex = 0;
 
     const BoundBox BB;
 
+    /// Morph target deltas of the primitive.
+    ///
+    /// \remarks    Deltas of all primitives are stored in the model's morph target buffer
+    ///             (see Model::GetMorphTargetBuffer()) as float4 elements (w is zero).
+    ///             For every target, the primitive stores VertexCount deltas for each
+    ///             attribute present in AttribFlags, in the MORPH_TARGET_ATTRIB order:
+    ///
+    ///                 Target 0: [Positions][Normals][Tangents]
+    ///                 Target 1: [Positions][Normals][Tangents]
+    ///                 ...
+    struct MorphTargetsInfo
+    {
+        /// Index of the first delta element, relative to Model::GetBaseMorphTargetDelta().
+        Uint32 FirstDelta = 0;
+
+        /// The number of morph targets.
+        Uint32 Count = 0;
+
+        /// Attributes present in the delta stream, a combination of (1u << MORPH_TARGET_ATTRIB_*) bits.
+        Uint32 AttribFlags = 0;
+
+        bool HasAttrib(MORPH_TARGET_ATTRIB Attrib) const
+        {
+            return (AttribFlags & (1u << Attrib)) != 0;
+        }
+
+        Uint32 GetNumAttribs() const
+        {
+            return PlatformMisc::CountOneBits(AttribFlags);
+        }
+
+        /// Returns the number of delta elements used by the primitive.
+        Uint32 GetDeltaCount(Uint32 VertexCount) const
+        {
+            return Count * GetNumAttribs() * VertexCount;
+        }
+
+        /// Returns the index of the first delta of the given attribute of the given target,
+        /// relative to Model::GetBaseMorphTargetDelta(), or ~0u if the attribute is not present.
+        Uint32 GetDeltaOffset(Uint32 Target, MORPH_TARGET_ATTRIB Attrib, Uint32 VertexCount) const
+        {
+            VERIFY_EXPR(Target < Count);
+            if (!HasAttrib(Attrib))
+                return ~0u;
+
+            const auto Slot = PlatformMisc::CountOneBits(AttribFlags & ((1u << Attrib) - 1u));
+            return FirstDelta + (Target * GetNumAttribs() + Slot) * VertexCount;
+        }
+    };
+    MorphTargetsInfo MorphTargets;
+
+    /// Draw order sort key, see Model::UpdateDrawOrder().
+    Uint64 SortKey = 0;
+
     Primitive(Uint32        _FirstIndex,
               Uint32        _IndexCount,
               Uint32        _VertexCount,
@@ -372,6 +466,11 @@ struct Primitive
     {
         return IndexCount > 0;
     }
+
+    bool HasMorphTargets() const
+    {
+        return MorphTargets.Count > 0;
+    }
 };
 
 struct Mesh
@@ -380,10 +479,16 @@ struct Mesh
     std::vector<Primitive> Primitives;
     BoundBox               BB;
 
+    // Default morph target weights.
+    std::vector<float> Weights;
+
     // Any user-specific data. One way to set this field is from the
     // MeshLoadCallback.
     RefCntAutoPtr<IObject> pUserData;
 
+    // Triangle hierarchy for CPU ray queries, see ModelCreateInfo::CreateMeshBVHs.
+    std::unique_ptr<MeshBVH> pBVH;
+
     // There may be no primitives in the mesh, in which
     // case the bounding box will be invalid.
     bool IsValidBB() const
@@ -413,6 +518,11 @@ struct Skin
     const Node*              pSkeletonRoot = nullptr;
     std::vector<float4x4>    InverseBindMatrices;
     std::vector<const Node*> Joints;
+
+    // Joint-space bounding boxes of the vertices influenced by every joint,
+    // see ModelCreateInfo::ComputeJointBounds.
+    // The box of a joint that does not influence any vertex has Min > Max.
+    std::vector<BoundBox> JointBounds;
 };
 
 struct Camera
@@ -498,11 +608,24 @@ struct Node
     float3      Scale  = float3{1, 1, 1};
     float4x4    Matrix = float4x4::Identity();
 
+    // Per-instance local transforms defined by the EXT_mesh_gpu_instancing extension.
+    // If not empty, the node's mesh is rendered once for every instance, with the instance
+    // transform applied before the node's global transform.
+    std::vector<float4x4> InstanceMatrices;
+
+    // Index of the node's first instance in ModelTransforms.InstanceMatrices array.
+    Uint32 FirstInstance = 0;
+
     explicit Node(int _Index) :
         Index{_Index}
     {}
 
     inline float4x4 ComputeLocalTransform() const;
+
+    bool IsInstanced() const
+    {
+        return !InstanceMatrices.empty();
+    }
 };
 
 struct Scene
@@ -511,6 +634,17 @@ struct Scene
     std::vector<Node*> RootNodes;
     // Linear list of all nodes in the scene.
     std::vector<Node*> LinearNodes;
+
+    struct DrawItem
+    {
+        const Node* pNode = nullptr;
+
+        // Index of the primitive in pNode->pMesh->Primitives array.
+        Uint32 PrimitiveId = 0;
+    };
+    // Primitives of all nodes in the scene, stably sorted by Primitive::SortKey.
+    // See Model::UpdateDrawOrder().
+    std::vector<DrawItem> DrawOrder;
 };
 
 struct AnimationChannel
@@ -549,6 +683,10 @@ struct AnimationSampler
     std::vector<float>  Inputs;
     std::vector<float4> OutputsVec4;
 
+    // Compressed keys (see ModelCreateInfo::pAnimationCompression).
+    // When the track is not empty, Inputs and OutputsVec4 are released.
+    CompressedAnimationTrack Compressed;
+
     // Returns the index of the key frame for the given animation time.
     inline size_t FindKeyFrame(float Time) const;
 
@@ -667,6 +805,10 @@ struct TextureCacheType
 struct ModelCreateInfo
 {
     /// File name.
+    ///
+    /// \remarks    Files with the .sdkmesh extension are loaded with DXSDKMesh and
+    ///             converted into the glTF object model (see ConvertDXSDKMeshToGltf),
+    ///             so that they share the resource manager pools with glTF models.
     const char* FileName = nullptr;
 
     /// Optional texture cache to use when loading the model.
@@ -677,6 +819,12 @@ struct ModelCreateInfo
     /// Optional resource manager to use when allocating resources for the model.
     ResourceManager* pResourceManager = nullptr;
 
+    /// Optional thread pool to use for parallel processing, e.g. decoding
+    /// of EXT_meshopt_compression buffer views.
+    ///
+    /// \remarks    If null is provided, all processing is performed in the calling thread.
+    IThreadPool* pThreadPool = nullptr;
+
     using NodeLoadCallbackType = std::function<void(const void* pSrcModel, int SrcNodeIndex, const void* pSrcNode, Node& DstNode)>;
     /// User-provided node loading callback function that will be called for
     /// every node being loaded.
@@ -737,6 +885,15 @@ struct ModelCreateInfo
     /// Index data type.
     VALUE_TYPE IndexType = VT_UINT32;
 
+    /// Whether to select the index type individually for every primitive.
+    ///
+    /// \remarks    When this flag is set, IndexType is ignored, and indices of every primitive are
+    ///             stored relative to its first vertex (see Primitive::BaseVertex). Primitives with
+    ///             at most 65535 vertices use 16-bit indices, while others use 32-bit indices.
+    ///             16-bit and 32-bit indices are kept in separate index buffers (or separate
+    ///             allocations if the resource manager is used), see Model::GetIndexBuffer(VALUE_TYPE).
+    bool AdaptiveIndexType = false;
+
     /// Index buffer bind flags
     BIND_FLAGS IndBufferBindFlags = BIND_INDEX_BUFFER;
 
@@ -789,6 +946,88 @@ struct ModelCreateInfo
     ///             The buffer will be zero-initialized.
     bool CreateStubVertexBuffers = false;
 
+    /// Whether to merge materials with identical contents after the model is loaded.
+    ///
+    /// \remarks    See Model::DeduplicateMaterials().
+    bool DeduplicateMaterials = false;
+
+    /// Whether to generate the mip levels of normal textures on the CPU by averaging
+    /// and renormalizing the normals instead of box-filtering them.
+    ///
+    /// \remarks    Box-filtered normals get shorter and are biased towards the geometric
+    ///             normal in coarse mip levels, which makes bumpy surfaces look flat and
+    ///             shiny at a distance. See ComputeNormalMapMipLevel().
+    ///             Only applies to 8-bit textures that are not loaded from DDS or KTX files.
+    bool RenormalizeNormalMapMips = false;
+
+    /// Whether to add the variance of the material normal texture to the roughness
+    /// stored in the metallic-roughness texture (Toksvig-style specular anti-aliasing).
+    ///
+    /// \remarks    The mip levels of the metallic-roughness texture are generated on the CPU,
+    ///             and the roughness of every level is increased according to the variance of
+    ///             the normals covered by each texel, see AddNormalVarianceToRoughness().
+    ///             This reduces specular aliasing and preserves the appearance of bumpy
+    ///             surfaces at a distance.
+    ///             If the metallic-roughness texture is used by materials with different normal
+    ///             textures, the first normal texture is used.
+    ///             Only applies to 8-bit textures that are not loaded from DDS or KTX files.
+    bool BakeNormalVarianceToRoughness = false;
+
+    /// Whether to build a triangle hierarchy of every mesh for CPU ray queries.
+    ///
+    /// \remarks    The hierarchies are built from the vertex positions and indices before
+    ///             they are uploaded to the GPU, using pThreadPool if it is provided.
+    ///             See Model::IntersectRay().
+    bool CreateMeshBVHs = false;
+
+    /// Whether to compute joint-space bounding boxes of the vertices influenced by
+    /// every skin joint (see Skin::JointBounds).
+    ///
+    /// \remarks    The boxes let Model::ComputeSkinBoundingBox() and Model::ComputeBoundingBox()
+    ///             compute tight bounds of skinned meshes in any pose in O(joints) time,
+    ///             instead of using the bind-pose bounding box.
+    ///             Morph targets are not taken into account.
+    bool ComputeJointBounds = false;
+
+    /// Influences with weights that are not greater than this value are ignored when
+    /// computing the joint bounding boxes.
+    ///
+    /// \remarks    Non-zero values produce tighter boxes, but the bounds are then not
+    ///             guaranteed to contain all skinned vertices.
+    float JointBoundsWeightThreshold = 0;
+
+    /// Optional animation compression parameters. If not null, keys that can be reconstructed
+    /// by interpolating their neighbors within the given tolerances are removed, and the remaining
+    /// translation, rotation and scale keys are quantized (see GLTF::CompressedAnimationTrack).
+    ///
+    /// \remarks    Cubic spline samplers, morph target weights, and samplers that are shared by
+    ///             channels of different path types are not compressed.
+    ///             The source keys of compressed samplers are released: AnimationSampler::Inputs
+    ///             and AnimationSampler::OutputsVec4 are empty, and the keys must be read from
+    ///             AnimationSampler::Compressed. The first and the last key times are always kept,
+    ///             so the animation duration is not changed.
+    const AnimationCompressionInfo* pAnimationCompression = nullptr;
+
+    /// Optional memory budget. If the model does not fit into the budget,
+    /// the loader fails before allocating the GPU resources that exceed it.
+    ///
+    /// \remarks    See MemoryBudget.
+    const MemoryBudget* pMemoryBudget = nullptr;
+
+    /// Whether to read the scene graph, meshes, accessors, skins and animations
+    /// directly from the JSON index (see JsonIndex) instead of the tinygltf DOM.
+    ///
+    /// \remarks    This considerably reduces the parsing time and memory usage for
+    ///             large documents. Materials, textures, images and buffers are still
+    ///             loaded by tinygltf from the reduced document.
+    ///             In this mode, pSrcModel in NodeLoadCallback, MeshLoadCallback and
+    ///             PrimitiveLoadCallback is a pointer to GLTF::JsonIndex, while pSrcNode,
+    ///             pSrcMesh and pSrcPrim are pointers to GLTF::JsonValue.
+    ///             MaterialLoadCallback still receives tinygltf objects.
+    ///             If the file uses KHR_draco_mesh_compression, the whole document
+    ///             is loaded by tinygltf.
+    bool UseFastJsonParser = false;
+
     ModelCreateInfo() = default;
 
     explicit ModelCreateInfo(const char*                _FileName,
@@ -827,6 +1066,10 @@ struct ModelTransforms
     };
     std::vector<SkinTransforms> Skins;
 
+    // World transform matrices for each mesh instance in the model (see Node::InstanceMatrices).
+    // Instances of the same node are stored contiguously starting at Node::FirstInstance.
+    std::vector<float4x4> InstanceMatrices;
+
     // Animation transforms for each node in the model.
     // This is an intermediate data to compute transform matrices.
     struct AnimationTransforms
@@ -856,6 +1099,9 @@ struct Model
     int SkinTransformsCount = 0;
     int DefaultSceneId      = 0;
 
+    // The total number of mesh instances of all instanced nodes.
+    Uint32 InstanceCount = 0;
+
     Model(const ModelCreateInfo& CI);
 
     Model(IRenderDevice*         pDevice,
@@ -872,6 +1118,29 @@ struct Model
     /// * If the model does not use the resource cache, transitions resources to required states
     void PrepareGPUResources(IRenderDevice* pDevice, IDeviceContext* pCtx);
 
+    /// Adds the uploads of the model's GPU resources to the scheduler, so that they can be
+    /// spread over multiple frames.
+    ///
+    /// \param [in] Scheduler    - The scheduler to add the uploads to.
+    /// \param [in] Priority     - The priority of the model's uploads, e.g. its screen size,
+    ///                            see UploadScheduler::AddGroup().
+    /// \param [in] MaxRangeSize - The maximum number of bytes of a buffer range that is uploaded
+    ///                            by a single work item.
+    ///
+    /// \return    The id of the upload group, or UploadScheduler::InvalidGroupId if the GPU data is
+    ///            already initialized or the uploads have already been scheduled.
+    ///
+    /// \remarks   Every texture mip level and every buffer range is uploaded by a separate work item.
+    ///            The last item transitions the resources to the required states and marks the GPU
+    ///            data as initialized (see IsGPUDataInitialized()), just like PrepareGPUResources() does.
+    ///            PrepareGPUResources() has no effect once the uploads are scheduled.
+    ///
+    ///            The model must not be destroyed while the group is pending; remove the group with
+    ///            UploadScheduler::RemoveGroup() first. The model's GPU data is never initialized then.
+    UploadScheduler::GroupId ScheduleGPUResourceUploads(UploadScheduler& Scheduler,
+                                                        float            Priority,
+                                                        Uint32           MaxRangeSize = 1u << 20u);
+
     bool IsGPUDataInitialized() const
     {
         return GPUDataInitialized.load();
@@ -892,18 +1161,19 @@ struct Model
         }
     }
 
+    /// Returns the index buffer of the model that uses a single index type.
+    ///
+    /// \remarks    If ModelCreateInfo::AdaptiveIndexType is used, the buffer must be
+    ///             queried with GetIndexBuffer(VALUE_TYPE, IRenderDevice*, IDeviceContext*).
     IBuffer* GetIndexBuffer(IRenderDevice* pDevice = nullptr, IDeviceContext* pCtx = nullptr) const
     {
-        if (IndexData.pAllocation != nullptr)
-        {
-            return pDevice != nullptr || pCtx != nullptr ?
-                IndexData.pAllocation->Update(pDevice, pCtx) :
-                IndexData.pAllocation->GetBuffer();
-        }
-        else
-        {
-            return IndexData.pBuffer;
-        }
+        return GetIndexData().GetBuffer(pDevice, pCtx);
+    }
+
+    /// Returns the buffer that contains indices of the given type, see Primitive::IndexType.
+    IBuffer* GetIndexBuffer(VALUE_TYPE IndexType, IRenderDevice* pDevice = nullptr, IDeviceContext* pCtx = nullptr) const
+    {
+        return GetIndexData(IndexType).GetBuffer(pDevice, pCtx);
     }
 
     ITexture* GetTexture(Uint32 Index, IRenderDevice* pDevice = nullptr, IDeviceContext* pCtx = nullptr) const
@@ -949,17 +1219,17 @@ struct Model
         return NullDesc;
     }
 
+    /// Returns the location of the model's first index if the model uses a single index type,
+    /// see GetIndexBuffer().
     Uint32 GetFirstIndexLocation() const
     {
-        VERIFY(IndexData.IndexSize != 0, "Index size is not initialized");
-        if (IndexData.pAllocation)
-        {
-            const auto Offset = IndexData.pAllocation->GetOffset();
-            VERIFY((Offset % IndexData.IndexSize) == 0, "Index data allocation offset is not a multiple of index size (", IndexData.IndexSize, ")");
-            return Offset / IndexData.IndexSize;
-        }
+        return GetIndexData().GetFirstIndexLocation();
+    }
 
-        return 0;
+    /// Returns the location of the model's first index of the given type, see Primitive::IndexType.
+    Uint32 GetFirstIndexLocation(VALUE_TYPE IndexType) const
+    {
+        return GetIndexData(IndexType).GetFirstIndexLocation();
     }
 
     Uint32 GetBaseVertex() const
@@ -969,6 +1239,47 @@ struct Model
             0;
     }
 
+    /// The size of a single morph target delta element (float4).
+    static constexpr Uint32 MorphTargetDeltaStride = sizeof(float4);
+
+    /// Returns the buffer that contains morph target deltas of all primitives,
+    /// see Primitive::MorphTargetsInfo.
+    ///
+    /// \remarks    When resource manager is used, deltas are allocated from the vertex pool
+    ///             with the {MorphTargetDeltaStride, BIND_SHADER_RESOURCE} layout key.
+    IBuffer* GetMorphTargetBuffer(IRenderDevice* pDevice = nullptr, IDeviceContext* pCtx = nullptr) const
+    {
+        if (MorphTargetData.pAllocation != nullptr)
+        {
+            return pDevice != nullptr || pCtx != nullptr ?
+                MorphTargetData.pAllocation->Update(0, pDevice, pCtx) :
+                MorphTargetData.pAllocation->GetBuffer(0);
+        }
+        else
+        {
+            return MorphTargetData.pBuffer;
+        }
+    }
+
+    /// Returns the index of the model's first delta element in the morph target buffer.
+    Uint32 GetBaseMorphTargetDelta() const
+    {
+        return MorphTargetData.pAllocation ?
+            MorphTargetData.pAllocation->GetStartVertex() :
+            0;
+    }
+
+    /// Returns an index of the morph target vertex pool in the resource manager.
+    Uint32 GetMorphTargetPoolIndex() const
+    {
+        return MorphTargetData.PoolId;
+    }
+
+    bool HasMorphTargets() const
+    {
+        return MorphTargetData.pBuffer || MorphTargetData.pAllocation;
+    }
+
     /// Returns an index of the vertex pool in the resource manager.
     ///
     /// \remarks    This index should be passed to the GetVertexPool method of the resource manager.
@@ -980,9 +1291,17 @@ struct Model
     /// Returns an index of the index buffer allocator in the resource manager.
     ///
     /// \remarks    This index should be passed to the GetIndexBuffer method of the resource manager.
+    ///             If ModelCreateInfo::AdaptiveIndexType is used, the index must be queried with
+    ///             GetIndexAllocatorIndex(VALUE_TYPE).
     Uint32 GetIndexAllocatorIndex() const
     {
-        return IndexData.AllocatorId;
+        return GetIndexData().AllocatorId;
+    }
+
+    /// Returns an index of the allocator of the index buffer with the given index type, see Primitive::IndexType.
+    Uint32 GetIndexAllocatorIndex(VALUE_TYPE IndexType) const
+    {
+        return GetIndexData(IndexType).AllocatorId;
     }
 
     struct ImageData
@@ -999,12 +1318,17 @@ struct Model
         const void* pData    = nullptr;
         size_t      DataSize = 0;
     };
+    /// Adds the texture to the model.
+    ///
+    /// \remarks    pRoughnessNormalMap is an optional normal map whose variance is added
+    ///             to the roughness stored in the texture, see ModelCreateInfo::BakeNormalVarianceToRoughness.
     Uint32 AddTexture(IRenderDevice*     pDevice,
                       TextureCacheType*  pTextureCache,
                       ResourceManager*   pResourceMgr,
                       const ImageData&   Image,
                       int                GltfSamplerId,
-                      const std::string& CacheId);
+                      const std::string& CacheId,
+                      const ImageData*   pRoughnessNormalMap = nullptr);
 
     Uint32 GetNumVertexAttributes() const { return NumVertexAttributes; }
     Uint32 GetNumTextureAttributes() const { return NumTextureAttributes; }
@@ -1040,8 +1364,75 @@ struct Model
                            Int32            AnimationIndex = -1,
                            float            Time           = 0) const;
 
+    /// Computes the bounding box of the scene meshes.
+    ///
+    /// \remarks    Skinned meshes use the joint bounding boxes if they have been computed
+    ///             (see ModelCreateInfo::ComputeJointBounds), and the bind-pose bounding box otherwise.
     BoundBox ComputeBoundingBox(Uint32 SceneIndex, const ModelTransforms& Transforms) const;
 
+    /// Computes the world-space bounding box of the vertices skinned by the given skin
+    /// from the joint bounding boxes (see ModelCreateInfo::ComputeJointBounds).
+    ///
+    /// \param [in] skin       - a skin of this model.
+    /// \param [in] Transforms - transforms computed by ComputeTransforms().
+    ///
+    /// \return     The bounding box, or a box with Min > Max if the skin has no joint bounding boxes.
+    ///
+    /// \remarks    The method passes the global joint node matrices to GLTF::ComputeSkinBoundingBox(),
+    ///             so the box is computed in O(joints) time and contains the skinned vertices in any pose.
+    BoundBox ComputeSkinBoundingBox(const Skin& skin, const ModelTransforms& Transforms) const;
+
+    /// Finds the closest intersection of a ray with the meshes of the scene.
+    ///
+    /// \param [in]      SceneIndex - scene index.
+    /// \param [in]      Transforms - transforms computed by ComputeTransforms().
+    /// \param [in]      R          - the ray in the space of the root transform.
+    /// \param [in, out] Hit        - the closest hit. Only hits that are closer than Hit.T are reported.
+    ///
+    /// \return     true if a closer hit was found, and false otherwise.
+    ///
+    /// \remarks    Only meshes with triangle hierarchies are tested (see ModelCreateInfo::CreateMeshBVHs).
+    ///             The hierarchies are built from the static vertex positions, so skinning and
+    ///             morph targets are not taken into account.
+    bool IntersectRay(Uint32 SceneIndex, const ModelTransforms& Transforms, const Ray& R, RayHit& Hit) const;
+
+    /// Finds the closest intersections of multiple rays with the meshes of the scene.
+    ///
+    /// \remarks    For every ray, the method is equivalent to IntersectRay(), but traverses
+    ///             the mesh hierarchies with packets of rays (see MeshBVH::IntersectRays()).
+    void IntersectRays(Uint32 SceneIndex, const ModelTransforms& Transforms, const Ray* pRays, RayHit* pHits, size_t NumRays) const;
+
+    /// Merges materials with identical contents and remaps the material indices of all primitives.
+    ///
+    /// \remarks    Materials are canonicalized first (see Material::Canonicalize()).
+    ///             The first material in every group of identical materials is kept, and the
+    ///             relative order of the remaining materials is preserved.
+    ///             The draw order of all scenes is updated.
+    ///
+    /// \return     The number of removed materials.
+    Uint32 DeduplicateMaterials();
+
+    /// Computes the sort key of every primitive and the draw order of every scene.
+    ///
+    /// \remarks    The 64-bit sort key is composed of the following fields, from the most significant bits:
+    ///             - Alpha mode (2 bits): opaque primitives go first, then masked, then blended.
+    ///             - Double-sidedness (1 bit)
+    ///             - Texture set index (29 bits): index of the unique combination of textures used by the material.
+    ///             - Material index (32 bits)
+    ///
+    ///             Blended primitives only use the alpha mode field, so that they are drawn
+    ///             in the order they are authored in the scene.
+    ///
+    ///             This method is called automatically when the model is loaded. An application must call
+    ///             it again if it modifies materials, meshes or scenes.
+    void UpdateDrawOrder();
+
+    /// Returns the memory usage of the model's resources.
+    ///
+    /// \remarks    GPU memory of the resources allocated from the resource manager is
+    ///             reported as the size of the model's allocations.
+    ModelMemoryUsage GetMemoryUsage() const;
+
     size_t GetTextureCount() const
     {
         return Textures.size();
@@ -1061,6 +1452,7 @@ struct Model
 
 private:
     friend ModelBuilder;
+    friend ModelWriter;
 
     void LoadFromFile(IRenderDevice*         pDevice,
                       IDeviceContext*        pContext,
@@ -1070,18 +1462,45 @@ private:
                       const tinygltf::Model& gltf_model,
                       const std::string&     BaseDir,
                       TextureCacheType*      pTextureCache,
-                      ResourceManager*       pResourceMgr);
+                      ResourceManager*       pResourceMgr,
+                      const ModelCreateInfo& CI);
 
     void LoadTextureSamplers(IRenderDevice* pDevice, const tinygltf::Model& gltf_model);
     void LoadMaterials(const tinygltf::Model& gltf_model, const ModelCreateInfo::MaterialLoadCallbackType& MaterialLoadCallback);
     void UpdateAnimation(Uint32 SceneIndex, Uint32 AnimationIndex, float time, ModelTransforms& Transforms) const;
 
+    // Builds the texture-to-material usage index in a single pass over all materials
+    // and initializes the alpha cutoff value for each of the NumTextures textures.
+    void InitTextureAlphaCutoffValues(size_t NumTextures);
+
     // Returns the alpha cutoff value for the given texture.
     // TextureIdx is the texture index in the GLTF file and also the Textures array.
     float GetTextureAlphaCutoffValue(int TextureIdx) const;
 
+    struct TextureNormalMapInfo
+    {
+        // Whether the texture is used as a normal map whose mip levels are renormalized.
+        bool IsNormalMap = false;
+
+        // Index of the normal map whose variance is added to the roughness stored in the texture, or -1.
+        int RoughnessNormalMap = -1;
+    };
+
+    // Finds the textures that are used as normal maps and pairs the metallic-roughness
+    // textures with the normal maps of the same materials.
+    void InitTextureNormalMapInfo(size_t NumTextures, bool RenormalizeNormalMaps, bool BakeNormalVariance);
+
+    // Returns the normal map info for the given texture.
+    // TextureIdx is the texture index in the GLTF file and also the Textures array.
+    TextureNormalMapInfo GetTextureNormalMapInfo(int TextureIdx) const;
+
+    // Returns the work items that upload the pending initialization data of the GPU resources.
+    // The initialization data is taken from the resources when the items are created.
+    std::vector<UploadScheduler::WorkItem> CreateGPUUploadItems(Uint32 MaxRangeSize);
+
 private:
     std::atomic_bool GPUDataInitialized{false};
+    std::atomic_bool GPUUploadsScheduled{false};
 
     std::unique_ptr<void, STDDeleter<void, IMemoryAllocator>> pAttributesData;
 
@@ -1108,9 +1527,63 @@ private:
 
         Uint32 AllocatorId = 0; // Index buffer allocator index
         Uint32 IndexSize   = 0;
+
+        IBuffer* GetBuffer(IRenderDevice* pDevice, IDeviceContext* pCtx) const
+        {
+            if (pAllocation != nullptr)
+            {
+                return pDevice != nullptr || pCtx != nullptr ?
+                    pAllocation->Update(pDevice, pCtx) :
+                    pAllocation->GetBuffer();
+            }
+            else
+            {
+                return pBuffer;
+            }
+        }
+
+        Uint32 GetFirstIndexLocation() const
+        {
+            VERIFY(IndexSize != 0, "Index size is not initialized");
+            if (pAllocation)
+            {
+                const auto Offset = pAllocation->GetOffset();
+                VERIFY((Offset % IndexSize) == 0, "Index data allocation offset is not a multiple of index size (", IndexSize, ")");
+                return Offset / IndexSize;
+            }
+
+            return 0;
+        }
     };
     IndexDataInfo IndexData;
 
+    // 16-bit indices of the primitives when ModelCreateInfo::AdaptiveIndexType is used.
+    // In this case, IndexData contains 32-bit indices. Otherwise, IndexSize is zero.
+    IndexDataInfo IndexData16;
+
+    // Returns the index data of the model that uses a single index type
+    const IndexDataInfo& GetIndexData() const
+    {
+        VERIFY(IndexData16.IndexSize == 0, "The model uses the adaptive index type. Use the overload that takes the index type.");
+        return IndexData;
+    }
+
+    const IndexDataInfo& GetIndexData(VALUE_TYPE IndexType) const
+    {
+        VERIFY_EXPR(IndexType == VT_UINT16 || IndexType == VT_UINT32);
+        const auto& Data = (IndexType == VT_UINT16 && IndexData16.IndexSize != 0) ? IndexData16 : IndexData;
+        VERIFY(Data.IndexSize == (IndexType == VT_UINT16 ? 2u : 4u), "The model does not contain ", (IndexType == VT_UINT16 ? 16 : 32), "-bit indices");
+        return Data;
+    }
+
+    struct MorphTargetDataInfo
+    {
+        RefCntAutoPtr<IBuffer>               pBuffer;
+        RefCntAutoPtr<IVertexPoolAllocation> pAllocation;
+        Uint32                               PoolId = 0; // Vertex pool index
+    };
+    MorphTargetDataInfo MorphTargetData;
+
     struct TextureInfo
     {
         RefCntAutoPtr<ITexture>                   pTexture;
@@ -1122,6 +1595,15 @@ private:
         }
     };
     std::vector<TextureInfo> Textures;
+
+    // Alpha cutoff value for each texture loaded from the GLTF file, see InitTextureAlphaCutoffValues().
+    std::vector<float> TextureAlphaCutoffs;
+
+    // Normal map info for each texture loaded from the GLTF file, see InitTextureNormalMapInfo().
+    std::vector<TextureNormalMapInfo> TextureNormalMaps;
+
+    // The size of the source GLTF buffers and images, see ModelMemoryUsage::PeakSourceDataSize.
+    Uint64 SourceDataSize = 0;
 };
 
 template <typename T>
@@ -0,0 +1,205 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <functional>
+
+#include "../../../DiligentCore/Primitives/interface/BasicTypes.h"
+#include "../../../DiligentCore/Graphics/GraphicsEngine/interface/Texture.h"
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+/// Memory usage of a group of resources.
+struct MemoryUsage
+{
+    /// CPU memory that is only held until the resources are uploaded to the GPU,
+    /// e.g. pending vertex, index and texture initialization data.
+    Uint64 CPUTransient = 0;
+
+    /// CPU memory that is held for the lifetime of the resources.
+    Uint64 CPUResident = 0;
+
+    /// GPU memory reserved for the resources, including unused space in pools and atlases.
+    Uint64 GPUReserved = 0;
+
+    /// GPU memory actually occupied by the resources. Never exceeds GPUReserved.
+    Uint64 GPUUsed = 0;
+
+    constexpr Uint64 GetCPUTotal() const
+    {
+        return CPUTransient + CPUResident;
+    }
+
+    MemoryUsage& operator+=(const MemoryUsage& RHS)
+    {
+        CPUTransient += RHS.CPUTransient;
+        CPUResident += RHS.CPUResident;
+        GPUReserved += RHS.GPUReserved;
+        GPUUsed += RHS.GPUUsed;
+        return *this;
+    }
+
+    MemoryUsage operator+(const MemoryUsage& RHS) const
+    {
+        MemoryUsage Sum{*this};
+        Sum += RHS;
+        return Sum;
+    }
+
+    constexpr bool operator==(const MemoryUsage& RHS) const
+    {
+        // clang-format off
+        return CPUTransient == RHS.CPUTransient &&
+               CPUResident  == RHS.CPUResident  &&
+               GPUReserved  == RHS.GPUReserved  &&
+               GPUUsed      == RHS.GPUUsed;
+        // clang-format on
+    }
+    constexpr bool operator!=(const MemoryUsage& RHS) const
+    {
+        return !(*this == RHS);
+    }
+};
+
+/// Memory usage of a GLTF model, see Model::GetMemoryUsage().
+struct ModelMemoryUsage
+{
+    /// Vertex buffers or vertex pool allocation.
+    MemoryUsage Vertices;
+
+    /// Index buffer or index buffer allocation.
+    MemoryUsage Indices;
+
+    /// Morph target delta buffer or allocation.
+    MemoryUsage MorphTargets;
+
+    /// Textures or texture atlas allocations.
+    ///
+    /// \remarks    Textures shared through the texture cache or the resource manager
+    ///             are counted by every model that references them.
+    MemoryUsage Textures;
+
+    /// Nodes, meshes, materials, skins, animations and other CPU-side scene data.
+    MemoryUsage Scene;
+
+    /// The size of the source GLTF buffers and decoded images that were held
+    /// while the model was being loaded.
+    ///
+    /// \remarks    This memory is released by the time the model constructor returns
+    ///             and is not included in GetTotal().
+    Uint64 PeakSourceDataSize = 0;
+
+    MemoryUsage GetTotal() const
+    {
+        return Vertices + Indices + MorphTargets + Textures + Scene;
+    }
+};
+
+/// Memory usage of a GLTF resource manager, see ResourceManager::GetMemoryUsage().
+struct ResourceManagerMemoryUsage
+{
+    /// Index buffer suballocators.
+    MemoryUsage IndexBuffers;
+
+    /// Vertex pools, including morph target pools.
+    MemoryUsage VertexPools;
+
+    /// Texture atlases.
+    ///
+    /// \remarks    Used memory is estimated from the fraction of the atlas area that is occupied by allocations.
+    MemoryUsage TextureAtlases;
+
+    MemoryUsage GetTotal() const
+    {
+        return IndexBuffers + VertexPools + TextureAtlases;
+    }
+};
+
+/// Memory budget that is checked by the loader before it allocates resources.
+///
+/// \remarks    The loader checks the budget when the source GLTF data has been parsed
+///             (to account for the source data and the texture memory) and again before
+///             it creates vertex and index buffers. If the budget is exceeded and cannot be
+///             restored by the Evict callback, the loader fails and throws an exception.
+struct MemoryBudget
+{
+    /// Maximum CPU memory (transient and resident), in bytes. Zero means no limit.
+    Uint64 MaxCPUMemory = 0;
+
+    /// Maximum reserved GPU memory, in bytes. Zero means no limit.
+    Uint64 MaxGPUMemory = 0;
+
+    using QueryUsageCallbackType = std::function<MemoryUsage()>;
+    /// Optional callback that returns the memory that is already in use, e.g. the
+    /// sum of the usages of all loaded models and resource managers.
+    /// If null, the budget only accounts for the resources being loaded.
+    QueryUsageCallbackType QueryUsage = nullptr;
+
+    using EvictCallbackType = std::function<bool(Uint64 CPUOverflow, Uint64 GPUOverflow)>;
+    /// Optional callback that is called when the budget would be exceeded.
+    ///
+    /// \param [in] CPUOverflow - the amount of CPU memory, in bytes, that needs to be released.
+    /// \param [in] GPUOverflow - the amount of GPU memory, in bytes, that needs to be released.
+    ///
+    /// \return     true if the application has released some memory and the budget
+    ///             should be checked again, and false otherwise.
+    ///
+    /// \remarks    The callback may be called multiple times. The check fails if the memory
+    ///             usage reported by QueryUsage does not decrease after the eviction.
+    EvictCallbackType Evict = nullptr;
+
+    /// Returns the amount of CPU memory by which Usage exceeds the budget.
+    Uint64 GetCPUOverflow(const MemoryUsage& Usage) const
+    {
+        const auto CPUTotal = Usage.GetCPUTotal();
+        return MaxCPUMemory != 0 && CPUTotal > MaxCPUMemory ? CPUTotal - MaxCPUMemory : 0;
+    }
+
+    /// Returns the amount of GPU memory by which Usage exceeds the budget.
+    Uint64 GetGPUOverflow(const MemoryUsage& Usage) const
+    {
+        return MaxGPUMemory != 0 && Usage.GPUReserved > MaxGPUMemory ? Usage.GPUReserved - MaxGPUMemory : 0;
+    }
+
+    /// Checks if the Required memory fits into the budget on top of the memory reported by
+    /// QueryUsage. Calls Evict as long as the budget is exceeded and eviction makes progress.
+    bool Fits(const MemoryUsage& Required) const;
+};
+
+/// Returns the memory size of all subresources of a texture with the given description.
+///
+/// \remarks    If Desc.MipLevels is zero, the full mip chain is assumed.
+Uint64 GetTextureMemorySize(const TextureDesc& Desc);
+
+} // namespace GLTF
+
+} // namespace Diligent
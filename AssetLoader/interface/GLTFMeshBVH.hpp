@@ -0,0 +1,198 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <cfloat>
+#include <vector>
+
+#include "../../../DiligentCore/Primitives/interface/BasicTypes.h"
+#include "../../../DiligentCore/Graphics/GraphicsEngine/interface/GraphicsTypes.h"
+#include "../../../DiligentCore/Common/interface/BasicMath.hpp"
+
+namespace Diligent
+{
+
+struct IThreadPool;
+
+namespace GLTF
+{
+
+/// Ray used by the CPU ray queries.
+struct Ray
+{
+    float3 Origin;
+
+    /// Ray direction. The direction does not need to be normalized:
+    /// hit distances are measured in units of the direction length.
+    float3 Direction;
+
+    /// Minimum and maximum distance along the ray.
+    float TMin = 0;
+    float TMax = FLT_MAX;
+};
+
+/// Closest hit of a ray returned by the CPU ray queries.
+struct RayHit
+{
+    /// Distance to the hit point: Ray.Origin + Ray.Direction * T.
+    float T = FLT_MAX;
+
+    /// Barycentric coordinates of the hit point relative to the second and the
+    /// third vertex of the triangle. The weight of the first vertex is 1 - x - y.
+    float2 Barycentrics;
+
+    /// Index of the primitive in Mesh::Primitives.
+    Uint32 PrimitiveId = ~0u;
+
+    /// Index of the triangle within the primitive.
+    Uint32 TriangleId = ~0u;
+
+    /// Index of the node whose mesh was hit (see Node::Index), set by Model::IntersectRay().
+    int NodeIndex = -1;
+
+    /// Index of the node instance that was hit, or -1 if the node is not instanced.
+    int InstanceId = -1;
+
+    /// Material of the primitive, set by Model::IntersectRay().
+    Uint32 MaterialId = ~0u;
+
+    bool IsValid() const
+    {
+        return PrimitiveId != ~0u;
+    }
+};
+
+/// Triangle bounding volume hierarchy of a mesh that is used for CPU ray queries.
+///
+/// \remarks    The hierarchy is built with the binned surface area heuristic.
+///             Triangle vertices are copied into the hierarchy, so that it does not
+///             reference the source data after it has been built.
+class MeshBVH
+{
+public:
+    /// Source triangles of a single primitive.
+    struct PrimitiveData
+    {
+        /// Vertex positions (three floats).
+        const void* pPositions = nullptr;
+
+        /// Stride between vertex positions, in bytes.
+        Uint32 PositionStride = sizeof(float3);
+
+        /// The number of vertices in pPositions.
+        Uint32 NumVertices = 0;
+
+        /// Triangle list indices, or null for non-indexed primitives.
+        const void* pIndices = nullptr;
+
+        /// Index type, must be VT_UINT16 or VT_UINT32.
+        VALUE_TYPE IndexType = VT_UINT32;
+
+        /// The number of indices, or the number of vertices for non-indexed primitives.
+        Uint32 IndexCount = 0;
+
+        /// Value added to every index (or to the sequential vertex number for non-indexed primitives).
+        Uint32 BaseVertex = 0;
+    };
+
+    /// Builds the hierarchy for the triangles of the given primitives.
+    ///
+    /// \param [in] pPrimitives   - primitives of the mesh. The primitive index in this array
+    ///                             is returned in RayHit::PrimitiveId.
+    /// \param [in] NumPrimitives - the number of primitives.
+    /// \param [in] pThreadPool   - optional thread pool to use to build the subtrees in parallel.
+    ///
+    /// \remarks    Triangles that reference out-of-range vertices are skipped.
+    MeshBVH(const PrimitiveData* pPrimitives, Uint32 NumPrimitives, IThreadPool* pThreadPool = nullptr);
+
+    /// Finds the closest intersection of the ray with the triangles.
+    ///
+    /// \param [in]      R   - the ray in the mesh space.
+    /// \param [in, out] Hit - the hit information. Only hits that are closer than Hit.T are reported,
+    ///                        so the same hit may be passed to multiple queries.
+    ///
+    /// \return     true if a closer hit was found, and false otherwise.
+    ///
+    /// \remarks    Back faces are not culled.
+    bool IntersectRay(const Ray& R, RayHit& Hit) const;
+
+    /// Finds the closest intersections of multiple rays.
+    ///
+    /// \remarks    The rays are traversed in packets of PacketSize rays that share the node
+    ///             visits, which is much faster than individual queries for coherent rays.
+    ///             For every ray, the method is equivalent to IntersectRay().
+    void IntersectRays(const Ray* pRays, RayHit* pHits, size_t NumRays) const;
+
+    static constexpr Uint32 PacketSize = 8;
+
+    Uint32 GetTriangleCount() const { return static_cast<Uint32>(m_Triangles.size()); }
+    Uint32 GetNodeCount() const { return static_cast<Uint32>(m_Nodes.size()); }
+
+    /// Returns the depth of the hierarchy.
+    Uint32 GetDepth() const { return m_Depth; }
+
+    /// Returns the bounding box of all triangles.
+    void GetBounds(float3& Min, float3& Max) const;
+
+    /// Returns the size of the memory used by the hierarchy, in bytes.
+    size_t GetMemorySize() const;
+
+    struct Node
+    {
+        float3 Min;
+        // For leaves, the index of the first triangle.
+        // For interior nodes, the index of the first child; the second one immediately follows it.
+        Uint32 FirstIndex = 0;
+
+        float3 Max;
+        // The number of triangles in the leaf, or zero for interior nodes.
+        Uint32 NumTriangles = 0;
+
+        bool IsLeaf() const { return NumTriangles > 0; }
+    };
+
+    struct Triangle
+    {
+        float3 V0;
+        float3 E1; // V1 - V0
+        float3 E2; // V2 - V0
+        Uint32 PrimitiveId = 0;
+        Uint32 TriangleId  = 0;
+    };
+
+private:
+    void IntersectPacket(const Ray* pRays, RayHit* pHits, Uint32 NumRays) const;
+
+    std::vector<Node>     m_Nodes;
+    std::vector<Triangle> m_Triangles;
+    Uint32                m_Depth = 0;
+};
+
+} // namespace GLTF
+
+} // namespace Diligent
@@ -0,0 +1,120 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#include "../../../DiligentCore/Primitives/interface/BasicTypes.h"
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+/// EXT_meshopt_compression mode of a compressed buffer view.
+///
+/// \remarks    See https://github.com/KhronosGroup/glTF/tree/main/extensions/2.0/Vendor/EXT_meshopt_compression
+enum MESHOPT_COMPRESSION_MODE : Uint8
+{
+    /// Vertex attribute data compressed with the vertex codec.
+    MESHOPT_COMPRESSION_MODE_ATTRIBUTES = 0,
+
+    /// Triangle list indices compressed with the index codec.
+    MESHOPT_COMPRESSION_MODE_TRIANGLES,
+
+    /// Arbitrary index sequence compressed with the index sequence codec.
+    MESHOPT_COMPRESSION_MODE_INDICES,
+
+    MESHOPT_COMPRESSION_MODE_COUNT
+};
+
+/// EXT_meshopt_compression filter that is applied after the attribute data is decoded.
+enum MESHOPT_COMPRESSION_FILTER : Uint8
+{
+    /// No filter.
+    MESHOPT_COMPRESSION_FILTER_NONE = 0,
+
+    /// Octahedral encoding of unit vectors (4 or 8 bytes per element).
+    MESHOPT_COMPRESSION_FILTER_OCTAHEDRAL,
+
+    /// Smallest-three encoding of unit quaternions (8 bytes per element).
+    MESHOPT_COMPRESSION_FILTER_QUATERNION,
+
+    /// Shared-exponent encoding of floating-point values (multiple of 4 bytes per element).
+    MESHOPT_COMPRESSION_FILTER_EXPONENTIAL,
+
+    MESHOPT_COMPRESSION_FILTER_COUNT
+};
+
+/// Description of a meshopt-compressed buffer view.
+struct MeshoptBufferViewDesc
+{
+    /// Compression mode.
+    MESHOPT_COMPRESSION_MODE Mode = MESHOPT_COMPRESSION_MODE_ATTRIBUTES;
+
+    /// Filter to apply after decoding. Only valid for the ATTRIBUTES mode.
+    MESHOPT_COMPRESSION_FILTER Filter = MESHOPT_COMPRESSION_FILTER_NONE;
+
+    /// The number of elements in the buffer view.
+    ///
+    /// \remarks    For TRIANGLES and INDICES modes, this is the number of indices.
+    size_t Count = 0;
+
+    /// The size of each element, in bytes.
+    ///
+    /// \remarks    For ATTRIBUTES mode, the stride must be a multiple of 4 not greater than 256.
+    ///             For TRIANGLES and INDICES modes, the stride must be 2 or 4.
+    size_t ByteStride = 0;
+};
+
+/// Returns the size of the decoded data, in bytes.
+inline size_t GetMeshoptDecodedSize(const MeshoptBufferViewDesc& Desc)
+{
+    return Desc.Count * Desc.ByteStride;
+}
+
+/// Decodes a meshopt-compressed buffer view.
+
+/// \param[in]  Desc     - Buffer view description, see Diligent::GLTF::MeshoptBufferViewDesc.
+/// \param[in]  pSrc     - Compressed data.
+/// \param[in]  SrcSize  - Compressed data size, in bytes.
+/// \param[out] pDst     - Destination memory that must be at least GetMeshoptDecodedSize(Desc) bytes large.
+///
+/// \return     true if the data was decoded successfully, and false otherwise.
+///
+/// \remarks    The function validates the compressed stream and never reads outside
+///             of the [pSrc, pSrc + SrcSize) range, so it is safe to use with untrusted data.
+bool DecodeMeshoptBufferView(const MeshoptBufferViewDesc& Desc,
+                             const void*                  pSrc,
+                             size_t                       SrcSize,
+                             void*                        pDst);
+
+} // namespace GLTF
+
+} // namespace Diligent
@@ -39,6 +39,7 @@
 #include "../../../DiligentCore/Graphics/GraphicsTools/interface/BufferSuballocator.h"
 #include "../../../DiligentCore/Graphics/GraphicsTools/interface/DynamicTextureAtlas.h"
 #include "../../../DiligentCore/Graphics/GraphicsTools/interface/VertexPoolX.hpp"
+#include "GLTFMemoryUsage.hpp"
 
 namespace Diligent
 {
@@ -285,6 +286,9 @@ public:
     /// Otherwise, returns the net usage stats for all pools.
     VertexPoolUsageStats GetVertexPoolUsageStats(const VertexLayoutKey& Key = VertexLayoutKey{});
 
+    /// Returns the memory usage of all index buffers, vertex pools and texture atlases.
+    ResourceManagerMemoryUsage GetMemoryUsage();
+
     /// Parameters of the TransitionResourceStates() method.
     struct TransitionResourceStatesInfo
     {
@@ -0,0 +1,158 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "../../../DiligentCore/Primitives/interface/BasicTypes.h"
+
+namespace Diligent
+{
+
+struct IRenderDevice;
+struct IDeviceContext;
+
+namespace GLTF
+{
+
+/// Budget of a single UploadScheduler::Execute() call.
+struct UploadBudget
+{
+    /// Maximum number of bytes to upload. Zero means no limit.
+    Uint64 MaxBytes = 0;
+
+    /// Maximum time to spend in the call, in seconds. Zero means no limit.
+    double MaxTime = 0;
+};
+
+/// Upload progress reported by UploadScheduler::Execute().
+struct UploadProgress
+{
+    /// The number of work items executed by the call.
+    Uint32 ExecutedItems = 0;
+
+    /// The number of bytes uploaded by the call.
+    Uint64 ExecutedBytes = 0;
+
+    /// The number of groups whose last item was executed by the call.
+    Uint32 CompletedGroups = 0;
+
+    /// The number of work items that remain in the scheduler.
+    Uint32 PendingItems = 0;
+
+    /// The number of bytes that remain to be uploaded.
+    Uint64 PendingBytes = 0;
+
+    bool IsComplete() const
+    {
+        return PendingItems == 0;
+    }
+};
+
+/// Executes GPU uploads split into resumable work items within a per-call budget,
+/// see Model::ScheduleGPUResourceUploads().
+///
+/// \remarks    Work items are organized in groups, e.g. all uploads of one model.
+///             Groups with higher priority are executed first, and groups with equal
+///             priority are executed in the order they were added. Items of a group are
+///             always executed in order, so the last item may finalize the resources.
+///
+///             Every Execute() call runs at least one item, even if it exceeds the budget,
+///             so that large items (e.g. the top mip level of a big texture) make progress.
+///
+///             The scheduler does not access the device itself: the work items receive the
+///             device and the context passed to Execute(). The scheduler is not thread-safe,
+///             and work items must not add or remove groups.
+class UploadScheduler
+{
+public:
+    using GroupId = Uint64;
+
+    /// Group id that is never returned by AddGroup().
+    static constexpr GroupId InvalidGroupId = 0;
+
+    using WorkFuncType = std::function<void(IRenderDevice* pDevice, IDeviceContext* pCtx)>;
+
+    struct WorkItem
+    {
+        /// The number of bytes uploaded by the item. Items of zero size are not limited by the byte budget.
+        Uint64 Size = 0;
+
+        /// The function that performs the upload.
+        WorkFuncType Func;
+    };
+
+    /// Adds a group of work items and returns its id.
+    ///
+    /// \remarks    The priority is an arbitrary caller-defined key, e.g. the screen size of the model.
+    ///             An empty group is complete immediately, and InvalidGroupId is returned.
+    GroupId AddGroup(std::vector<WorkItem> Items, float Priority);
+
+    /// Changes the priority of the group. Has no effect if the group is not pending.
+    void SetPriority(GroupId Id, float Priority);
+
+    /// Removes the pending items of the group without executing them.
+    void RemoveGroup(GroupId Id);
+
+    /// Returns true if the group has items that have not been executed.
+    bool IsGroupPending(GroupId Id) const;
+
+    /// Returns the number of bytes that remain to be uploaded by the group.
+    Uint64 GetPendingBytes(GroupId Id) const;
+
+    /// Executes work items in priority order until the budget is exhausted or all items are done.
+    UploadProgress Execute(IRenderDevice* pDevice, IDeviceContext* pCtx, const UploadBudget& Budget);
+
+    /// Returns the number of pending items and bytes.
+    UploadProgress GetProgress() const;
+
+private:
+    struct Group
+    {
+        GroupId               Id       = InvalidGroupId;
+        float                 Priority = 0;
+        std::vector<WorkItem> Items;
+        size_t                NextItem     = 0;
+        Uint64                PendingBytes = 0;
+    };
+
+    const Group* FindGroup(GroupId Id) const;
+    Group*       FindGroup(GroupId Id)
+    {
+        return const_cast<Group*>(static_cast<const UploadScheduler*>(this)->FindGroup(Id));
+    }
+
+    std::vector<Group> m_Groups;
+    GroupId            m_NextGroupId = 1;
+};
+
+} // namespace GLTF
+
+} // namespace Diligent
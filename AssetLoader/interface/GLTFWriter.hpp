@@ -0,0 +1,94 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include "GLTFLoader.hpp"
+#include "../../TextureLoader/interface/Image.h"
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+/// Model write attributes, see WriteModel().
+struct ModelWriteInfo
+{
+    /// Output file path.
+    ///
+    /// \remarks    If the file extension is ".glb", the model is written as binary glTF.
+    ///             Otherwise, the JSON document is written to the file and the binary
+    ///             data is written to a .bin file with the same base name.
+    const char* FileName = nullptr;
+
+    /// File format used to re-encode the model images (PNG or JPEG).
+    IMAGE_FILE_FORMAT ImageFileFormat = IMAGE_FILE_FORMAT_PNG;
+
+    /// JPEG quality, when ImageFileFormat is IMAGE_FILE_FORMAT_JPEG.
+    int JpegQuality = 95;
+
+    /// Whether to pretty-print the JSON document.
+    bool PrettyPrint = true;
+};
+
+/// Writes the model to a glTF or GLB file.
+///
+/// \param [in] pDevice   - Render device that is used to create staging resources.
+/// \param [in] pContext  - Device context that is used to read the model data back from the GPU.
+/// \param [in] Model     - Model to write. The model's GPU resources must be initialized,
+///                         see Model::PrepareGPUResources().
+/// \param [in] WriteInfo - Write attributes.
+///
+/// \return     true if the model was written successfully, and false otherwise.
+///
+/// \remarks    The method writes scenes, nodes, meshes, materials (including the KHR material
+///             extensions supported by the loader), textures, cameras, lights, skins and animations.
+///             Every accessor gets its own tightly packed buffer view aligned by 4 bytes. All
+///             buffer views are stored in a single buffer.
+///
+///             Vertex attributes are written in the formats required by the glTF specification:
+///             joint indices are written as unsigned shorts, all other attributes as floats.
+///             Attributes with non-standard names are prefixed with an underscore.
+///
+///             Images are read back from the GPU and re-encoded with Image::Encode().
+///             Textures with 16-bit unorm and 16- or 32-bit float formats are converted to 8 bits
+///             per component; float values are clamped to [0, 1]. The method fails if the model
+///             contains a texture in any other format (e.g. a block-compressed format).
+///             Textures that have no GPU data are replaced with a 1x1 white image.
+///             Texture atlas regions are written as separate images.
+///
+///             The method waits for the GPU to become idle every time it reads back a resource,
+///             and should not be used in performance-critical code.
+bool WriteModel(IRenderDevice*        pDevice,
+                IDeviceContext*       pContext,
+                const Model&          Model,
+                const ModelWriteInfo& WriteInfo);
+
+} // namespace GLTF
+
+} // namespace Diligent
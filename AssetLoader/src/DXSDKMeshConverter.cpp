@@ -0,0 +1,458 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "DXSDKMeshConverter.hpp"
+
+#include <cstring>
+#include <cmath>
+#include <cfloat>
+#include <map>
+#include <string>
+#include <utility>
+#include <algorithm>
+
+#include "DXSDKMeshLoader.hpp"
+
+#include "../../ThirdParty/tinygltf/tiny_gltf.h"
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+namespace
+{
+
+struct GltfVertexFormat
+{
+    int  ComponentType = -1;
+    int  NumComponents = 0;
+    bool Normalized    = false;
+};
+
+GltfVertexFormat GetGltfVertexFormat(Uint8 DataType)
+{
+    switch (DataType)
+    {
+        // clang-format off
+        case DXSDKMESH_VERTEX_DATA_TYPE_FLOAT1:   return {TINYGLTF_COMPONENT_TYPE_FLOAT,          1, false};
+        case DXSDKMESH_VERTEX_DATA_TYPE_FLOAT2:   return {TINYGLTF_COMPONENT_TYPE_FLOAT,          2, false};
+        case DXSDKMESH_VERTEX_DATA_TYPE_FLOAT3:   return {TINYGLTF_COMPONENT_TYPE_FLOAT,          3, false};
+        case DXSDKMESH_VERTEX_DATA_TYPE_FLOAT4:   return {TINYGLTF_COMPONENT_TYPE_FLOAT,          4, false};
+        case DXSDKMESH_VERTEX_DATA_TYPE_UBYTE4:   return {TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE,  4, false};
+        case DXSDKMESH_VERTEX_DATA_TYPE_UBYTE4N:  return {TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE,  4, true};
+        case DXSDKMESH_VERTEX_DATA_TYPE_SHORT2:   return {TINYGLTF_COMPONENT_TYPE_SHORT,          2, false};
+        case DXSDKMESH_VERTEX_DATA_TYPE_SHORT4:   return {TINYGLTF_COMPONENT_TYPE_SHORT,          4, false};
+        case DXSDKMESH_VERTEX_DATA_TYPE_SHORT2N:  return {TINYGLTF_COMPONENT_TYPE_SHORT,          2, true};
+        case DXSDKMESH_VERTEX_DATA_TYPE_SHORT4N:  return {TINYGLTF_COMPONENT_TYPE_SHORT,          4, true};
+        case DXSDKMESH_VERTEX_DATA_TYPE_USHORT2N: return {TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT, 2, true};
+        case DXSDKMESH_VERTEX_DATA_TYPE_USHORT4N: return {TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT, 4, true};
+        // clang-format on
+
+        default:
+            // D3DCOLOR uses BGRA component order, packed 10-bit and half-float formats
+            // have no glTF equivalent.
+            return {};
+    }
+}
+
+int GetGltfType(int NumComponents)
+{
+    switch (NumComponents)
+    {
+        case 1: return TINYGLTF_TYPE_SCALAR;
+        case 2: return TINYGLTF_TYPE_VEC2;
+        case 3: return TINYGLTF_TYPE_VEC3;
+        case 4: return TINYGLTF_TYPE_VEC4;
+        default:
+            UNEXPECTED("Unexpected number of components");
+            return TINYGLTF_TYPE_VEC4;
+    }
+}
+
+// Returns the glTF attribute name for the vertex element, or an empty string
+// if the element has no glTF equivalent.
+std::string GetGltfAttributeName(const DXSDKMESH_VERTEX_ELEMENT& Elem, int NumComponents)
+{
+    switch (Elem.Usage)
+    {
+        case DXSDKMESH_VERTEX_SEMANTIC_POSITION:
+            return NumComponents == 3 ? "POSITION" : "";
+
+        case DXSDKMESH_VERTEX_SEMANTIC_NORMAL:
+            return NumComponents == 3 ? "NORMAL" : "";
+
+        case DXSDKMESH_VERTEX_SEMANTIC_TEXCOORD:
+            return "TEXCOORD_" + std::to_string(Elem.UsageIndex);
+
+        case DXSDKMESH_VERTEX_SEMANTIC_TANGENT:
+            // glTF tangents store the bitangent sign in the w component
+            return NumComponents == 4 ? "TANGENT" : "";
+
+        case DXSDKMESH_VERTEX_SEMANTIC_COLOR:
+            return NumComponents >= 3 ? "COLOR_" + std::to_string(Elem.UsageIndex) : "";
+
+        default:
+            // Skinning data references the mesh frame influences rather than glTF skin joints
+            return "";
+    }
+}
+
+template <size_t N>
+std::string GetName(const char (&Name)[N])
+{
+    return std::string{Name, strnlen(Name, N)};
+}
+
+class DXSDKMeshConverter
+{
+public:
+    DXSDKMeshConverter(const DXSDKMesh&           Mesh,
+                       tinygltf::Model&           GltfModel,
+                       std::vector<const Uint8*>& BufferData) :
+        m_Mesh{Mesh},
+        m_GltfModel{GltfModel},
+        m_BufferData{BufferData}
+    {}
+
+    void Execute()
+    {
+        m_GltfModel = tinygltf::Model{};
+        m_BufferData.clear();
+
+        InitBuffers();
+        ConvertMaterials();
+        ConvertMeshes();
+        ConvertNodes();
+    }
+
+private:
+    void InitBuffers()
+    {
+        // One buffer and one buffer view for every vertex and index buffer
+        for (Uint32 vb = 0; vb < m_Mesh.GetNumVBs(); ++vb)
+        {
+            tinygltf::Buffer Buffer;
+            Buffer.name = "DXSDK Mesh vertex buffer #" + std::to_string(vb);
+            m_GltfModel.buffers.emplace_back(std::move(Buffer));
+            m_BufferData.push_back(m_Mesh.GetRawVerticesAt(vb));
+
+            tinygltf::BufferView View;
+            View.buffer     = static_cast<int>(vb);
+            View.byteOffset = 0;
+            View.byteLength = static_cast<size_t>(m_Mesh.GetNumVertices(vb) * m_Mesh.GetVertexStride(vb));
+            View.byteStride = m_Mesh.GetVertexStride(vb);
+            View.target     = TINYGLTF_TARGET_ARRAY_BUFFER;
+            m_GltfModel.bufferViews.emplace_back(std::move(View));
+        }
+
+        for (Uint32 ib = 0; ib < m_Mesh.GetNumIBs(); ++ib)
+        {
+            tinygltf::Buffer Buffer;
+            Buffer.name = "DXSDK Mesh index buffer #" + std::to_string(ib);
+            m_GltfModel.buffers.emplace_back(std::move(Buffer));
+            m_BufferData.push_back(m_Mesh.GetRawIndicesAt(ib));
+
+            tinygltf::BufferView View;
+            View.buffer     = static_cast<int>(m_Mesh.GetNumVBs() + ib);
+            View.byteOffset = 0;
+            View.byteLength = static_cast<size_t>(m_Mesh.GetNumIndices(ib) * (m_Mesh.GetIBIndexType(ib) == IT_16BIT ? 2 : 4));
+            View.target     = TINYGLTF_TARGET_ELEMENT_ARRAY_BUFFER;
+            m_GltfModel.bufferViews.emplace_back(std::move(View));
+        }
+    }
+
+    int FindOrAddTexture(const char* FileName)
+    {
+        auto it = m_Textures.find(FileName);
+        if (it != m_Textures.end())
+            return it->second;
+
+        const auto TexId = static_cast<int>(m_GltfModel.textures.size());
+
+        tinygltf::Image Image;
+        Image.name = FileName;
+        Image.uri  = FileName;
+        m_GltfModel.images.emplace_back(std::move(Image));
+
+        tinygltf::Texture Texture;
+        Texture.name   = FileName;
+        Texture.source = static_cast<int>(m_GltfModel.images.size() - 1);
+        m_GltfModel.textures.emplace_back(std::move(Texture));
+
+        m_Textures.emplace(FileName, TexId);
+        return TexId;
+    }
+
+    void ConvertMaterials()
+    {
+        m_GltfModel.materials.reserve(m_Mesh.GetNumMaterials());
+        for (Uint32 i = 0; i < m_Mesh.GetNumMaterials(); ++i)
+        {
+            const auto& SrcMat = m_Mesh.GetMaterial(i);
+
+            tinygltf::Material Mat;
+            Mat.name = GetName(SrcMat.Name);
+
+            Mat.values["baseColorFactor"].number_array = {SrcMat.Diffuse.r, SrcMat.Diffuse.g, SrcMat.Diffuse.b, SrcMat.Diffuse.a};
+
+            // Legacy materials are not metallic. The roughness is derived from
+            // the Blinn-Phong specular power.
+            auto& Metallic            = Mat.values["metallicFactor"];
+            Metallic.number_value     = 0;
+            Metallic.has_number_value = true;
+
+            auto& Roughness            = Mat.values["roughnessFactor"];
+            Roughness.number_value     = clamp(std::sqrt(2.0 / (std::max(SrcMat.Power, 0.f) + 2.0)), 0.0, 1.0);
+            Roughness.has_number_value = true;
+
+            Mat.additionalValues["emissiveFactor"].number_array = {SrcMat.Emissive.r, SrcMat.Emissive.g, SrcMat.Emissive.b};
+            if (SrcMat.Diffuse.a < 1)
+                Mat.additionalValues["alphaMode"].string_value = "BLEND";
+
+            const auto DiffuseTexture = GetName(SrcMat.DiffuseTexture);
+            if (!DiffuseTexture.empty())
+                Mat.values["baseColorTexture"].json_double_value["index"] = FindOrAddTexture(DiffuseTexture.c_str());
+
+            const auto NormalTexture = GetName(SrcMat.NormalTexture);
+            if (!NormalTexture.empty())
+                Mat.additionalValues["normalTexture"].json_double_value["index"] = FindOrAddTexture(NormalTexture.c_str());
+
+            m_GltfModel.materials.emplace_back(std::move(Mat));
+        }
+    }
+
+    // Creates accessors for all vertex elements of the mesh starting at the given vertex.
+    // Returns the attribute name -> accessor index map.
+    const std::map<std::string, int>& FindOrAddVertexAccessors(const DXSDKMESH_MESH& SrcMesh, Uint64 VertexStart)
+    {
+        VertexAccessorsKey Key{std::vector<Uint32>{SrcMesh.VertexBuffers, SrcMesh.VertexBuffers + SrcMesh.NumVertexBuffers}, VertexStart};
+
+        auto it = m_VertexAccessors.find(Key);
+        if (it != m_VertexAccessors.end())
+            return it->second;
+
+        std::map<std::string, int> Attributes;
+
+        // All streams are addressed by the same vertex index, so the first
+        // vertex buffer defines the number of vertices.
+        const Uint32 FirstVB     = SrcMesh.VertexBuffers[0];
+        const Uint64 NumVertices = m_Mesh.GetNumVertices(FirstVB) - VertexStart;
+        for (Uint32 s = 0; s < SrcMesh.NumVertexBuffers; ++s)
+        {
+            const Uint32 VB     = SrcMesh.VertexBuffers[s];
+            const Uint32 Stride = m_Mesh.GetVertexStride(VB);
+            if (m_Mesh.GetNumVertices(VB) < VertexStart + NumVertices)
+            {
+                LOG_WARNING_MESSAGE("Vertex buffer ", VB, " has fewer vertices than vertex buffer ", FirstVB, " and will be ignored");
+                continue;
+            }
+
+            const auto* pDecl = m_Mesh.VBElements(VB);
+            for (size_t e = 0; e < DXSDKMESH_VERTEX_BUFFER_HEADER::MaxVertexElements; ++e)
+            {
+                const auto& Elem = pDecl[e];
+                if (Elem.Stream == 0xFF || Elem.Type == DXSDKMESH_VERTEX_DATA_TYPE_UNUSED)
+                    break;
+
+                const auto Format = GetGltfVertexFormat(Elem.Type);
+                if (Format.NumComponents == 0)
+                    continue;
+
+                const auto Name = GetGltfAttributeName(Elem, Format.NumComponents);
+                if (Name.empty() || Attributes.find(Name) != Attributes.end())
+                    continue;
+
+                const auto ElementSize = static_cast<Uint32>(tinygltf::GetComponentSizeInBytes(Format.ComponentType) * Format.NumComponents);
+                if (Elem.Offset + ElementSize > Stride || (Stride % tinygltf::GetComponentSizeInBytes(Format.ComponentType)) != 0)
+                {
+                    LOG_WARNING_MESSAGE("Vertex element ", Name, " of vertex buffer ", VB, " does not fit the vertex stride and will be ignored");
+                    continue;
+                }
+
+                tinygltf::Accessor Accessor;
+                Accessor.bufferView    = static_cast<int>(VB);
+                Accessor.byteOffset    = static_cast<size_t>(VertexStart * Stride + Elem.Offset);
+                Accessor.componentType = Format.ComponentType;
+                Accessor.normalized    = Format.Normalized;
+                Accessor.type          = GetGltfType(Format.NumComponents);
+                Accessor.count         = static_cast<size_t>(NumVertices);
+
+                if (Name == "POSITION")
+                {
+                    // Position accessors must define the bounds
+                    float3 Min{+FLT_MAX, +FLT_MAX, +FLT_MAX};
+                    float3 Max{-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+                    const auto* pPos = m_Mesh.GetRawVerticesAt(VB) + Accessor.byteOffset;
+                    for (Uint64 v = 0; v < NumVertices; ++v, pPos += Stride)
+                    {
+                        float3 Pos;
+                        memcpy(&Pos, pPos, sizeof(Pos));
+                        Min = std::min(Min, Pos);
+                        Max = std::max(Max, Pos);
+                    }
+                    if (NumVertices == 0)
+                        Min = Max = float3{};
+
+                    Accessor.minValues = {Min.x, Min.y, Min.z};
+                    Accessor.maxValues = {Max.x, Max.y, Max.z};
+                }
+
+                Attributes.emplace(Name, static_cast<int>(m_GltfModel.accessors.size()));
+                m_GltfModel.accessors.emplace_back(std::move(Accessor));
+            }
+        }
+
+        return m_VertexAccessors.emplace(std::move(Key), std::move(Attributes)).first->second;
+    }
+
+    void ConvertMeshes()
+    {
+        m_GltfModel.meshes.reserve(m_Mesh.GetNumMeshes());
+        for (Uint32 m = 0; m < m_Mesh.GetNumMeshes(); ++m)
+        {
+            const auto& SrcMesh = m_Mesh.GetMesh(m);
+
+            tinygltf::Mesh Mesh;
+            Mesh.name = GetName(SrcMesh.Name);
+
+            const auto IndexType = m_Mesh.GetIBIndexType(SrcMesh.IndexBuffer);
+            for (Uint32 s = 0; s < SrcMesh.NumSubsets; ++s)
+            {
+                const auto& Subset = m_Mesh.GetSubset(m, s);
+                if (Subset.PrimitiveType != PT_TRIANGLE_LIST)
+                {
+                    LOG_WARNING_MESSAGE("Subset '", GetName(Subset.Name), "' of mesh '", Mesh.name,
+                                        "' uses primitive type ", Subset.PrimitiveType, ". Only triangle lists are supported.");
+                    continue;
+                }
+
+                const auto& Attributes = FindOrAddVertexAccessors(SrcMesh, Subset.VertexStart);
+                if (Attributes.find("POSITION") == Attributes.end())
+                {
+                    LOG_WARNING_MESSAGE("Subset '", GetName(Subset.Name), "' of mesh '", Mesh.name, "' has no positions");
+                    continue;
+                }
+
+                tinygltf::Accessor Indices;
+                Indices.bufferView    = static_cast<int>(m_Mesh.GetNumVBs() + SrcMesh.IndexBuffer);
+                Indices.byteOffset    = static_cast<size_t>(Subset.IndexStart * (IndexType == IT_16BIT ? 2 : 4));
+                Indices.componentType = IndexType == IT_16BIT ? TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT : TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT;
+                Indices.type          = TINYGLTF_TYPE_SCALAR;
+                Indices.count         = static_cast<size_t>(Subset.IndexCount);
+
+                tinygltf::Primitive Prim;
+                Prim.attributes = Attributes;
+                Prim.indices    = static_cast<int>(m_GltfModel.accessors.size());
+                Prim.material   = Subset.MaterialID < m_Mesh.GetNumMaterials() ? static_cast<int>(Subset.MaterialID) : -1;
+                Prim.mode       = TINYGLTF_MODE_TRIANGLES;
+                m_GltfModel.accessors.emplace_back(std::move(Indices));
+
+                Mesh.primitives.emplace_back(std::move(Prim));
+            }
+
+            m_GltfModel.meshes.emplace_back(std::move(Mesh));
+        }
+    }
+
+    void ConvertNodes()
+    {
+        tinygltf::Scene Scene;
+
+        const Uint32 NumFrames = m_Mesh.GetNumFrames();
+        if (NumFrames > 0)
+        {
+            m_GltfModel.nodes.resize(NumFrames);
+            for (Uint32 f = 0; f < NumFrames; ++f)
+            {
+                const auto& Frame = m_Mesh.GetFrame(f);
+
+                auto& Node = m_GltfModel.nodes[f];
+                Node.name  = GetName(Frame.Name);
+                Node.mesh  = Frame.Mesh != INVALID_MESH ? static_cast<int>(Frame.Mesh) : -1;
+
+                // Row-major matrices for row vectors have the same memory layout
+                // as glTF column-major matrices for column vectors.
+                if (Frame.Matrix != float4x4::Identity())
+                {
+                    for (int r = 0; r < 4; ++r)
+                    {
+                        for (int c = 0; c < 4; ++c)
+                            Node.matrix.push_back(Frame.Matrix[r][c]);
+                    }
+                }
+
+                // Frames that are not reachable from the roots (e.g. parent cycles) are ignored
+                if (Frame.ParentFrame == INVALID_FRAME)
+                    Scene.nodes.push_back(static_cast<int>(f));
+                else
+                    m_GltfModel.nodes[Frame.ParentFrame].children.push_back(static_cast<int>(f));
+            }
+        }
+        else
+        {
+            m_GltfModel.nodes.resize(m_Mesh.GetNumMeshes());
+            for (Uint32 m = 0; m < m_Mesh.GetNumMeshes(); ++m)
+            {
+                auto& Node = m_GltfModel.nodes[m];
+                Node.name  = m_GltfModel.meshes[m].name;
+                Node.mesh  = static_cast<int>(m);
+                Scene.nodes.push_back(static_cast<int>(m));
+            }
+        }
+
+        m_GltfModel.scenes.emplace_back(std::move(Scene));
+        m_GltfModel.defaultScene = 0;
+    }
+
+private:
+    const DXSDKMesh&           m_Mesh;
+    tinygltf::Model&           m_GltfModel;
+    std::vector<const Uint8*>& m_BufferData;
+
+    // Texture file name -> glTF texture index
+    std::map<std::string, int> m_Textures;
+
+    // (Vertex buffers, first vertex) -> vertex attribute accessors
+    using VertexAccessorsKey = std::pair<std::vector<Uint32>, Uint64>;
+    std::map<VertexAccessorsKey, std::map<std::string, int>> m_VertexAccessors;
+};
+
+} // namespace
+
+void ConvertDXSDKMeshToGltf(const DXSDKMesh&           Mesh,
+                            tinygltf::Model&           GltfModel,
+                            std::vector<const Uint8*>& BufferData)
+{
+    DXSDKMeshConverter{Mesh, GltfModel, BufferData}.Execute();
+}
+
+} // namespace GLTF
+
+} // namespace Diligent
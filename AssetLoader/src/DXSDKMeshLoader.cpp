@@ -28,6 +28,8 @@
 #include <string>
 #include <sstream>
 #include <cfloat>
+#include <cstring>
+#include <limits>
 
 #include "DXSDKMeshLoader.hpp"
 #include "DataBlobImpl.hpp"
@@ -36,13 +38,126 @@
 #include "TextureUtilities.h"
 #include "GraphicsAccessories.hpp"
 
+#if PLATFORM_WIN32
+#    include "WinHPreface.h"
+#    include <Windows.h>
+#    include "WinHPostface.h"
+#    define DXSDKMESH_USE_MEMORY_MAPPING 1
+#elif PLATFORM_LINUX || PLATFORM_MACOS || PLATFORM_IOS || PLATFORM_ANDROID
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <fcntl.h>
+#    include <unistd.h>
+#    define DXSDKMESH_USE_MEMORY_MAPPING 1
+#else
+#    define DXSDKMESH_USE_MEMORY_MAPPING 0
+#endif
+
 namespace Diligent
 {
 
+// Private copy-on-write mapping of the mesh file.
+// The loader patches pointers inside the data, so the pages it writes to are copied
+// while the vertex and index data are read directly from the file.
+struct DXSDKMesh::MappedFile
+{
+    Uint8* pData = nullptr;
+    size_t Size  = 0;
+
+#if PLATFORM_WIN32
+    HANDLE hFile    = INVALID_HANDLE_VALUE;
+    HANDLE hMapping = nullptr;
+#endif
+
+    MappedFile() = default;
+
+    // clang-format off
+    MappedFile           (const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    // clang-format on
+
+    ~MappedFile()
+    {
+#if PLATFORM_WIN32
+        if (pData != nullptr)
+            UnmapViewOfFile(pData);
+        if (hMapping != nullptr)
+            CloseHandle(hMapping);
+        if (hFile != INVALID_HANDLE_VALUE)
+            CloseHandle(hFile);
+#elif DXSDKMESH_USE_MEMORY_MAPPING
+        if (pData != nullptr)
+            munmap(pData, Size);
+#endif
+    }
+
+    // Returns null if the file can't be mapped, in which case it should be read instead.
+    static std::unique_ptr<MappedFile> Map(const char* szFileName)
+    {
+#if DXSDKMESH_USE_MEMORY_MAPPING
+        std::unique_ptr<MappedFile> pFile{new MappedFile{}};
+#    if PLATFORM_WIN32
+        pFile->hFile = CreateFileA(szFileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (pFile->hFile == INVALID_HANDLE_VALUE)
+            return nullptr;
+
+        LARGE_INTEGER FileSize{};
+        if (!GetFileSizeEx(pFile->hFile, &FileSize) || FileSize.QuadPart <= 0 || static_cast<Uint64>(FileSize.QuadPart) > std::numeric_limits<Uint32>::max())
+            return nullptr;
+        pFile->Size = static_cast<size_t>(FileSize.QuadPart);
+
+        pFile->hMapping = CreateFileMappingA(pFile->hFile, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        if (pFile->hMapping == nullptr)
+            return nullptr;
+
+        pFile->pData = static_cast<Uint8*>(MapViewOfFile(pFile->hMapping, FILE_MAP_COPY, 0, 0, 0));
+        if (pFile->pData == nullptr)
+            return nullptr;
+#    else
+        const int fd = open(szFileName, O_RDONLY);
+        if (fd < 0)
+            return nullptr;
+
+        struct stat FileStat = {};
+        if (fstat(fd, &FileStat) != 0 || FileStat.st_size <= 0 || static_cast<Uint64>(FileStat.st_size) > std::numeric_limits<Uint32>::max())
+        {
+            close(fd);
+            return nullptr;
+        }
+        pFile->Size = static_cast<size_t>(FileStat.st_size);
+
+        void* pData = mmap(nullptr, pFile->Size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        // The mapping keeps its own reference to the file
+        close(fd);
+        if (pData == MAP_FAILED)
+            return nullptr;
+        pFile->pData = static_cast<Uint8*>(pData);
+#    endif
+        return pFile;
+#else
+        (void)szFileName;
+        return nullptr;
+#endif
+    }
+};
+
+DXSDKMesh::DXSDKMesh()
+{
+}
 
 //--------------------------------------------------------------------------------------
 bool DXSDKMesh::CreateFromFile(const char* szFileName)
 {
+    m_pMappedFile = MappedFile::Map(szFileName);
+    if (m_pMappedFile)
+    {
+        if (CreateFromMemory(m_pMappedFile->pData, static_cast<Uint32>(m_pMappedFile->Size), /*InPlace = */ true))
+            return true;
+
+        m_pMappedFile.reset();
+        return false;
+    }
+
     FileWrapper File;
     File.Open(FileOpenAttribs{szFileName});
     if (!File)
@@ -56,12 +171,230 @@ bool DXSDKMesh::CreateFromFile(const char* szFileName)
 
     File.Close();
 
+    // The data blob is released when this function returns, so the data must be copied.
     auto res = CreateFromMemory(reinterpret_cast<Uint8*>(pFileData->GetDataPtr()),
-                                static_cast<Uint32>(pFileData->GetSize()));
+                                static_cast<Uint32>(pFileData->GetSize()),
+                                /*InPlace = */ false);
 
     return res;
 }
 
+static bool IsRangeValid(Uint64 Offset, Uint64 Count, size_t ElementSize, size_t DataSize)
+{
+    return Offset <= DataSize && Count <= (DataSize - Offset) / ElementSize;
+}
+
+// Reads an element of an array that starts at the given offset in the file data.
+// The data is validated before the alignment is known, so the element is copied.
+template <typename T>
+static T ReadElement(const Uint8* pData, Uint64 Offset, Uint64 Index)
+{
+    T Elem;
+    memcpy(&Elem, pData + Offset + Index * sizeof(T), sizeof(T));
+    return Elem;
+}
+
+// Returns the position element of the vertex buffer declaration, or null if there is none.
+static const DXSDKMESH_VERTEX_ELEMENT* FindPositionElement(const DXSDKMESH_VERTEX_BUFFER_HEADER& VBHeader)
+{
+    for (const auto& Elem : VBHeader.Decl)
+    {
+        if (Elem.Stream == 0xFF || Elem.Type == DXSDKMESH_VERTEX_DATA_TYPE_UNUSED)
+            break;
+        if (Elem.Usage == DXSDKMESH_VERTEX_SEMANTIC_POSITION)
+            return &Elem;
+    }
+    return nullptr;
+}
+
+// Checks that all offsets and ranges in the file reference data within [pData, pData + DataSize)
+// and that all indices are within the range of their vertex buffers.
+static bool ValidateDXSDKMeshData(const Uint8* pData, size_t DataSize)
+{
+    if (DataSize < sizeof(DXSDKMESH_HEADER))
+    {
+        LOG_ERROR_MESSAGE("SDK mesh data size (", DataSize, ") is smaller than the header size");
+        return false;
+    }
+
+    DXSDKMESH_HEADER Header;
+    memcpy(&Header, pData, sizeof(Header));
+
+    if (Header.Version != DXSDKMESH_FILE_VERSION)
+    {
+        LOG_ERROR_MESSAGE("Unexpected SDK mesh file version: ", Header.Version, ". Expected: ", DXSDKMESH_FILE_VERSION);
+        return false;
+    }
+
+    if (Header.HeaderSize < sizeof(DXSDKMESH_HEADER) ||
+        !IsRangeValid(Header.HeaderSize, Header.NonBufferDataSize, 1, DataSize) ||
+        !IsRangeValid(Header.HeaderSize + Header.NonBufferDataSize, Header.BufferDataSize, 1, DataSize))
+    {
+        LOG_ERROR_MESSAGE("SDK mesh header, non-buffer data and buffer data sizes exceed the data size (", DataSize, ")");
+        return false;
+    }
+
+    // clang-format off
+    struct
+    {
+        const char* Name;
+        Uint64      Offset;
+        Uint32      Count;
+        size_t      ElementSize;
+        size_t      Alignment;
+    } Arrays[] =
+    {
+        {"vertex buffer headers", Header.VertexStreamHeadersOffset, Header.NumVertexBuffers, sizeof(DXSDKMESH_VERTEX_BUFFER_HEADER), alignof(DXSDKMESH_VERTEX_BUFFER_HEADER)},
+        {"index buffer headers",  Header.IndexStreamHeadersOffset,  Header.NumIndexBuffers,  sizeof(DXSDKMESH_INDEX_BUFFER_HEADER),  alignof(DXSDKMESH_INDEX_BUFFER_HEADER)},
+        {"meshes",                Header.MeshDataOffset,            Header.NumMeshes,        sizeof(DXSDKMESH_MESH),                alignof(DXSDKMESH_MESH)},
+        {"subsets",               Header.SubsetDataOffset,          Header.NumTotalSubsets,  sizeof(DXSDKMESH_SUBSET),              alignof(DXSDKMESH_SUBSET)},
+        {"frames",                Header.FrameDataOffset,           Header.NumFrames,        sizeof(DXSDKMESH_FRAME),               alignof(DXSDKMESH_FRAME)},
+        {"materials",             Header.MaterialDataOffset,        Header.NumMaterials,     sizeof(DXSDKMESH_MATERIAL),            alignof(DXSDKMESH_MATERIAL)},
+    };
+    // clang-format on
+    for (const auto& Arr : Arrays)
+    {
+        if (Arr.Count == 0)
+            continue;
+
+        if (!IsRangeValid(Arr.Offset, Arr.Count, Arr.ElementSize, DataSize))
+        {
+            LOG_ERROR_MESSAGE("SDK mesh ", Arr.Name, " (offset ", Arr.Offset, ", count ", Arr.Count, ") are out of the data bounds");
+            return false;
+        }
+
+        // The arrays are accessed in place, so their offsets must be properly aligned
+        if (Arr.Offset % Arr.Alignment != 0)
+        {
+            LOG_ERROR_MESSAGE("SDK mesh ", Arr.Name, " offset (", Arr.Offset, ") is not a multiple of ", Arr.Alignment);
+            return false;
+        }
+    }
+
+    const auto ReadVBHeader = [&](Uint64 Index) {
+        return ReadElement<DXSDKMESH_VERTEX_BUFFER_HEADER>(pData, Header.VertexStreamHeadersOffset, Index);
+    };
+    const auto ReadIBHeader = [&](Uint64 Index) {
+        return ReadElement<DXSDKMESH_INDEX_BUFFER_HEADER>(pData, Header.IndexStreamHeadersOffset, Index);
+    };
+
+    const Uint64 BufferDataStart = Header.HeaderSize + Header.NonBufferDataSize;
+    for (Uint32 i = 0; i < Header.NumVertexBuffers; ++i)
+    {
+        const auto VB = ReadVBHeader(i);
+        if (VB.DataOffset < BufferDataStart ||
+            !IsRangeValid(VB.DataOffset, VB.SizeUint8s, 1, DataSize) ||
+            VB.StrideUint8s == 0 ||
+            VB.NumVertices > VB.SizeUint8s / VB.StrideUint8s)
+        {
+            LOG_ERROR_MESSAGE("SDK mesh vertex buffer ", i, " is out of the data bounds");
+            return false;
+        }
+    }
+
+    for (Uint32 i = 0; i < Header.NumIndexBuffers; ++i)
+    {
+        const auto IB = ReadIBHeader(i);
+        if (IB.IndexType != IT_16BIT && IB.IndexType != IT_32BIT)
+        {
+            LOG_ERROR_MESSAGE("SDK mesh index buffer ", i, " has unexpected index type ", IB.IndexType);
+            return false;
+        }
+        if (IB.DataOffset < BufferDataStart ||
+            !IsRangeValid(IB.DataOffset, IB.SizeUint8s, 1, DataSize) ||
+            IB.NumIndices > IB.SizeUint8s / (IB.IndexType == IT_16BIT ? 2 : 4))
+        {
+            LOG_ERROR_MESSAGE("SDK mesh index buffer ", i, " is out of the data bounds");
+            return false;
+        }
+    }
+
+    for (Uint32 i = 0; i < Header.NumMeshes; ++i)
+    {
+        const auto Mesh = ReadElement<DXSDKMESH_MESH>(pData, Header.MeshDataOffset, i);
+        if (Mesh.NumVertexBuffers == 0 || Mesh.NumVertexBuffers > DXSDKMESH_MESH::MaxVertexStreams)
+        {
+            LOG_ERROR_MESSAGE("SDK mesh ", i, " has invalid number of vertex buffers: ", Uint32{Mesh.NumVertexBuffers});
+            return false;
+        }
+        for (Uint32 vb = 0; vb < Mesh.NumVertexBuffers; ++vb)
+        {
+            if (Mesh.VertexBuffers[vb] >= Header.NumVertexBuffers)
+            {
+                LOG_ERROR_MESSAGE("SDK mesh ", i, " references invalid vertex buffer ", Mesh.VertexBuffers[vb]);
+                return false;
+            }
+        }
+        if (Mesh.IndexBuffer >= Header.NumIndexBuffers)
+        {
+            LOG_ERROR_MESSAGE("SDK mesh ", i, " references invalid index buffer ", Mesh.IndexBuffer);
+            return false;
+        }
+        if ((Mesh.NumSubsets > 0 && !IsRangeValid(Mesh.SubsetOffset, Mesh.NumSubsets, sizeof(Uint32), DataSize)) ||
+            (Mesh.NumFrameInfluences > 0 && !IsRangeValid(Mesh.FrameInfluenceOffset, Mesh.NumFrameInfluences, sizeof(Uint32), DataSize)))
+        {
+            LOG_ERROR_MESSAGE("SDK mesh ", i, " subset or frame influence list is out of the data bounds");
+            return false;
+        }
+
+        const auto  VB      = ReadVBHeader(Mesh.VertexBuffers[0]);
+        const auto* PosDecl = FindPositionElement(VB);
+        if (PosDecl == nullptr || PosDecl->Type != DXSDKMESH_VERTEX_DATA_TYPE_FLOAT3 || PosDecl->Offset + sizeof(float3) > VB.StrideUint8s)
+        {
+            LOG_ERROR_MESSAGE("The first vertex buffer of SDK mesh ", i, " must contain a 3-component float position within the vertex stride");
+            return false;
+        }
+
+        const auto IB = ReadIBHeader(Mesh.IndexBuffer);
+        for (Uint32 s = 0; s < Mesh.NumSubsets; ++s)
+        {
+            Uint32 SubsetId;
+            memcpy(&SubsetId, pData + Mesh.SubsetOffset + s * sizeof(Uint32), sizeof(SubsetId));
+            if (SubsetId >= Header.NumTotalSubsets)
+            {
+                LOG_ERROR_MESSAGE("SDK mesh ", i, " references invalid subset ", SubsetId);
+                return false;
+            }
+
+            const auto Subset = ReadElement<DXSDKMESH_SUBSET>(pData, Header.SubsetDataOffset, SubsetId);
+            if (Subset.IndexStart > IB.NumIndices || Subset.IndexCount > IB.NumIndices - Subset.IndexStart ||
+                Subset.VertexStart > VB.NumVertices)
+            {
+                LOG_ERROR_MESSAGE("Subset ", SubsetId, " of SDK mesh ", i, " is out of the range of its index or vertex buffer");
+                return false;
+            }
+
+            // Vertices are addressed relative to the subset's first vertex
+            const Uint64 NumSubsetVertices = VB.NumVertices - Subset.VertexStart;
+            for (Uint64 idx = Subset.IndexStart; idx < Subset.IndexStart + Subset.IndexCount; ++idx)
+            {
+                const Uint32 Index = IB.IndexType == IT_16BIT ?
+                    ReadElement<Uint16>(pData, IB.DataOffset, idx) :
+                    ReadElement<Uint32>(pData, IB.DataOffset, idx);
+                if (Index >= NumSubsetVertices)
+                {
+                    LOG_ERROR_MESSAGE("Subset ", SubsetId, " of SDK mesh ", i, " references vertex ", Subset.VertexStart + Index,
+                                      " that is out of the range of vertex buffer ", Mesh.VertexBuffers[0], " (", VB.NumVertices, " vertices)");
+                    return false;
+                }
+            }
+        }
+    }
+
+    for (Uint32 i = 0; i < Header.NumFrames; ++i)
+    {
+        const auto Frame = ReadElement<DXSDKMESH_FRAME>(pData, Header.FrameDataOffset, i);
+        if ((Frame.Mesh != INVALID_MESH && Frame.Mesh >= Header.NumMeshes) ||
+            (Frame.ParentFrame != INVALID_FRAME && Frame.ParentFrame >= Header.NumFrames))
+        {
+            LOG_ERROR_MESSAGE("SDK mesh frame ", i, " references invalid mesh or parent frame");
+            return false;
+        }
+    }
+
+    return true;
+}
+
 void DXSDKMesh::ComputeBoundingBoxes()
 {
     for (Uint32 i = 0; i < m_pMeshHeader->NumMeshes; i++)
@@ -72,10 +405,8 @@ void DXSDKMesh::ComputeBoundingBoxes()
         float3 Max{-FLT_MAX, -FLT_MAX, -FLT_MAX};
 
         const auto& VertexData = m_pVertexBufferArray[Mesh.VertexBuffers[0]];
-        auto*       PosDecl    = VertexData.Decl;
-        while (PosDecl->Stream != 0xFF && PosDecl->Usage != DXSDKMESH_VERTEX_SEMANTIC_POSITION)
-            ++PosDecl;
-        VERIFY(PosDecl->Stream != 0xFF, "Position semantic not found in this buffer");
+        const auto* PosDecl    = FindPositionElement(VertexData);
+        VERIFY(PosDecl != nullptr, "Position semantic not found in this buffer");
         VERIFY(PosDecl->Type == DXSDKMESH_VERTEX_DATA_TYPE_FLOAT3, "Vertex is expected to be a 3-component float vector");
 
         auto        IndexType = GetIndexType(i);
@@ -92,25 +423,53 @@ void DXSDKMesh::ComputeBoundingBoxes()
                     reinterpret_cast<const Uint16*>(Indices)[Subset.IndexStart + v] :
                     reinterpret_cast<const Uint32*>(Indices)[Subset.IndexStart + v];
 
-                const float3& Vertex =
-                    reinterpret_cast<const float3&>(Vertices[Index * Stride + PosDecl->Offset]);
+                // Indices are relative to the first vertex of the subset (the base vertex of the draw call)
+                float3 Vertex;
+                memcpy(&Vertex, &Vertices[(Subset.VertexStart + Index) * Stride + PosDecl->Offset], sizeof(Vertex));
                 Min = std::min(Min, Vertex);
                 Max = std::max(Max, Vertex);
             }
         }
+
+        if (Min.x > Max.x)
+        {
+            // The mesh has no indexed vertices
+            Min = Max = float3{};
+        }
         Mesh.BoundingBoxCenter  = (Max + Min) * 0.5;
         Mesh.BoundingBoxExtents = (Max - Min);
     }
 }
 
 bool DXSDKMesh::CreateFromMemory(Uint8* pData,
-                                 Uint32 DataUint8s)
+                                 Uint32 DataUint8s,
+                                 bool   InPlace)
 {
-    m_StaticMeshData.resize(DataUint8s);
-    memcpy(m_StaticMeshData.data(), pData, DataUint8s);
+    if (pData == nullptr)
+        return false;
+
+    if (InPlace && reinterpret_cast<size_t>(pData) % alignof(DXSDKMESH_HEADER) != 0)
+    {
+        LOG_ERROR_MESSAGE("SDK mesh data must be aligned to ", alignof(DXSDKMESH_HEADER), " bytes to be used in place");
+        return false;
+    }
+
+    if (!ValidateDXSDKMeshData(pData, DataUint8s))
+        return false;
+
+    if (InPlace)
+    {
+        m_pStaticMeshData = pData;
+    }
+    else
+    {
+        m_StaticMeshData.resize(DataUint8s);
+        memcpy(m_StaticMeshData.data(), pData, DataUint8s);
+        m_pStaticMeshData = m_StaticMeshData.data();
+    }
 
     // Pointer fixup
-    auto* pStaticMeshData = m_StaticMeshData.data();
+    auto* pStaticMeshData = m_pStaticMeshData;
     // clang-format off
     m_pMeshHeader        = reinterpret_cast<DXSDKMESH_HEADER*>              (pStaticMeshData);
     m_pVertexBufferArray = reinterpret_cast<DXSDKMESH_VERTEX_BUFFER_HEADER*>(pStaticMeshData + m_pMeshHeader->VertexStreamHeadersOffset);
@@ -139,15 +498,8 @@ bool DXSDKMesh::CreateFromMemory(Uint8* pData,
         m_pMeshArray[i].pFrameInfluences = reinterpret_cast<Uint32*>(pStaticMeshData + m_pMeshArray[i].FrameInfluenceOffset);
     }
 
-    // error condition
-    if (m_pMeshHeader->Version != DXSDKMESH_FILE_VERSION)
-    {
-        LOG_ERROR("Unexpected SDK mesh file version");
-        return false;
-    }
-
     // Setup buffer data pointer
-    Uint8* pBufferData = m_StaticMeshData.data() + m_pMeshHeader->HeaderSize + m_pMeshHeader->NonBufferDataSize;
+    Uint8* pBufferData = m_pStaticMeshData + m_pMeshHeader->HeaderSize + m_pMeshHeader->NonBufferDataSize;
 
     // Get the start of the buffer data
     Uint64 BufferDataStart = m_pMeshHeader->HeaderSize + m_pMeshHeader->NonBufferDataSize;
@@ -277,19 +629,21 @@ DXSDKMesh::~DXSDKMesh()
 //--------------------------------------------------------------------------------------
 bool DXSDKMesh::Create(const Char* szFileName)
 {
+    Destroy();
     return CreateFromFile(szFileName);
 }
 
 //--------------------------------------------------------------------------------------
-bool DXSDKMesh::Create(Uint8* pData, Uint32 DataUint8s)
+bool DXSDKMesh::Create(Uint8* pData, Uint32 DataUint8s, bool InPlace)
 {
-    return CreateFromMemory(pData, DataUint8s);
+    Destroy();
+    return CreateFromMemory(pData, DataUint8s, InPlace);
 }
 
 //--------------------------------------------------------------------------------------
 void DXSDKMesh::Destroy()
 {
-    for (Uint32 i = 0; i < m_pMeshHeader->NumMaterials; i++)
+    for (Uint32 i = 0; i < GetNumMaterials(); i++)
     {
         auto& Mat = m_pMaterialArray[i];
         if (Mat.pDiffuseTexture)
@@ -315,6 +669,8 @@ void DXSDKMesh::Destroy()
     m_IndexBuffers.clear();
 
     m_StaticMeshData.clear();
+    m_pStaticMeshData = nullptr;
+    m_pMappedFile.reset();
 
     //delete[] m_pAdjacencyIndexBufferArray; m_pAdjacencyIndexBufferArray = nullptr;
 
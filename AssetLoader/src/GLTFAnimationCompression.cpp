@@ -0,0 +1,345 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "GLTFAnimationCompression.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+namespace
+{
+
+using TRACK_TYPE = CompressedAnimationTrack::TRACK_TYPE;
+
+// The maximum quantized translation and scale component value
+constexpr float MaxQuantizedValue = 65535.f;
+
+// Smallest three quaternion components are in [-1/sqrt(2), 1/sqrt(2)] range and use 15 bits each
+constexpr float  SmallestThreeRange = 0.70710678f;
+constexpr float  SmallestThreeMax   = 32767.f;
+constexpr Uint16 SmallestThreeMask  = 0x7FFF;
+
+float4 NormalizeQuaternion(const float4& q)
+{
+    const float Len = length(q);
+    return Len > 0 ? q / Len : float4{0, 0, 0, 1};
+}
+
+// Interpolates the source keys the same way as Model::UpdateAnimation() does
+float4 InterpolateValues(TRACK_TYPE Type, const float4& Value0, const float4& Value1, float u)
+{
+    if (Type == TRACK_TYPE::ROTATION)
+    {
+        QuaternionF q0;
+        q0.q = Value0;
+        QuaternionF q1;
+        q1.q = Value1;
+        return normalize(slerp(q0, q1, u)).q;
+    }
+    else
+    {
+        return lerp(Value0, Value1, u);
+    }
+}
+
+// Interpolates two compressed keys. Rotations use normalized linear interpolation, which is
+// considerably faster than slerp. The difference is accounted for by the error checks.
+float4 InterpolateKeys(TRACK_TYPE Type, bool Step, float Time0, const float4& Value0, float Time1, const float4& Value1, float Time)
+{
+    if (Step)
+        return Time >= Time1 ? Value1 : Value0;
+
+    const float u = Time1 > Time0 ? clamp((Time - Time0) / (Time1 - Time0), 0.f, 1.f) : 0.f;
+    if (Type == TRACK_TYPE::ROTATION)
+        return NormalizeQuaternion(lerp(Value0, dot(Value0, Value1) < 0 ? -Value1 : Value1, u));
+    else
+        return lerp(Value0, Value1, u);
+}
+
+} // namespace
+
+float CompressedAnimationTrack::ComputeError(TRACK_TYPE Type, const float4& Value0, const float4& Value1, float ShellDistance)
+{
+    switch (Type)
+    {
+        case TRACK_TYPE::TRANSLATION:
+            return length(float3{Value0.x, Value0.y, Value0.z} - float3{Value1.x, Value1.y, Value1.z});
+
+        case TRACK_TYPE::SCALE:
+            return length(float3{Value0.x, Value0.y, Value0.z} - float3{Value1.x, Value1.y, Value1.z}) * ShellDistance;
+
+        case TRACK_TYPE::ROTATION:
+        {
+            // For unit quaternions q0 and q1 = q0 * r, where r rotates by angle A, |q0 - q1| = 2 * sin(A/4).
+            // A vertex at distance d is displaced by 2 * d * sin(A/2) = 2 * d * |q0 - q1| * sqrt(1 - |q0 - q1|^2 / 4).
+            // Unlike the dot product, the difference is precise for small angles.
+            const float4 q0 = NormalizeQuaternion(Value0);
+            float4       q1 = NormalizeQuaternion(Value1);
+            if (dot(q0, q1) < 0)
+                q1 = -q1;
+            const float Diff = length(q0 - q1);
+            return 2.f * ShellDistance * Diff * std::sqrt(std::max(1.f - Diff * Diff * 0.25f, 0.f));
+        }
+
+        default:
+            UNEXPECTED("Unexpected track type");
+            return 0;
+    }
+}
+
+void CompressedAnimationTrack::EncodeValue(const float4& Value, Uint16* pEncoded) const
+{
+    if (m_Type == TRACK_TYPE::ROTATION)
+    {
+        // Smallest three encoding: the largest component is dropped and restored from the unit length.
+        // Its index is stored in the high bits of the first two values.
+        float4 q = NormalizeQuaternion(Value);
+
+        int Largest = 0;
+        for (int i = 1; i < 4; ++i)
+        {
+            if (std::abs(q[i]) > std::abs(q[Largest]))
+                Largest = i;
+        }
+        // q and -q define the same rotation
+        if (q[Largest] < 0)
+            q = -q;
+
+        Uint16 Components[3];
+        for (int i = 0, c = 0; i < 4; ++i)
+        {
+            if (i == Largest)
+                continue;
+            const float Normalized = (clamp(q[i], -SmallestThreeRange, SmallestThreeRange) + SmallestThreeRange) / (2.f * SmallestThreeRange);
+            Components[c++]        = static_cast<Uint16>(Normalized * SmallestThreeMax + 0.5f);
+        }
+        pEncoded[0] = static_cast<Uint16>(Components[0] | ((Largest >> 1) << 15));
+        pEncoded[1] = static_cast<Uint16>(Components[1] | ((Largest & 1) << 15));
+        pEncoded[2] = Components[2];
+    }
+    else
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            const float Normalized = m_RangeStep[c] > 0 ? (Value[c] - m_RangeMin[c]) / m_RangeStep[c] : 0.f;
+            pEncoded[c]            = static_cast<Uint16>(clamp(Normalized + 0.5f, 0.f, MaxQuantizedValue));
+        }
+    }
+}
+
+float4 CompressedAnimationTrack::DecodeValue(const Uint16* pEncoded) const
+{
+    if (m_Type == TRACK_TYPE::ROTATION)
+    {
+        const int Largest = ((pEncoded[0] >> 15) << 1) | (pEncoded[1] >> 15);
+
+        float4 q;
+        float  SumSq = 0;
+        for (int i = 0, c = 0; i < 4; ++i)
+        {
+            if (i == Largest)
+                continue;
+            q[i] = static_cast<float>(pEncoded[c++] & SmallestThreeMask) / SmallestThreeMax * (2.f * SmallestThreeRange) - SmallestThreeRange;
+            SumSq += q[i] * q[i];
+        }
+        q[Largest] = std::sqrt(std::max(1.f - SumSq, 0.f));
+        return q;
+    }
+    else
+    {
+        return float4{
+            m_RangeMin.x + static_cast<float>(pEncoded[0]) * m_RangeStep.x,
+            m_RangeMin.y + static_cast<float>(pEncoded[1]) * m_RangeStep.y,
+            m_RangeMin.z + static_cast<float>(pEncoded[2]) * m_RangeStep.z,
+            0};
+    }
+}
+
+CompressedAnimationTrack::CompressedAnimationTrack(TRACK_TYPE                      Type,
+                                                   const float*                    pTimes,
+                                                   const float4*                   pValues,
+                                                   Uint32                          NumKeys,
+                                                   bool                            Step,
+                                                   const AnimationCompressionInfo& Info) :
+    m_Type{Type},
+    m_Step{Step}
+{
+    if (NumKeys == 0)
+        return;
+
+    DEV_CHECK_ERR(pTimes != nullptr && pValues != nullptr, "Key times and values must not be null");
+
+    const float Tolerance = Type == TRACK_TYPE::TRANSLATION ?
+        Info.TranslationTolerance :
+        (Type == TRACK_TYPE::ROTATION ? Info.RotationTolerance : Info.ScaleTolerance);
+
+    if (Type != TRACK_TYPE::ROTATION)
+    {
+        float3 Min{+FLT_MAX};
+        float3 Max{-FLT_MAX};
+        for (Uint32 k = 0; k < NumKeys; ++k)
+        {
+            const float3 Value{pValues[k].x, pValues[k].y, pValues[k].z};
+            Min = std::min(Min, Value);
+            Max = std::max(Max, Value);
+        }
+        m_RangeMin  = Min;
+        m_RangeStep = (Max - Min) / MaxQuantizedValue;
+    }
+
+    std::vector<Uint16> EncodedValues(size_t{NumKeys} * 3);
+    for (Uint32 k = 0; k < NumKeys; ++k)
+    {
+        EncodeValue(pValues[k], &EncodedValues[size_t{k} * 3]);
+        if (ComputeError(Type, DecodeValue(&EncodedValues[size_t{k} * 3]), pValues[k], Info.ShellDistance) > Tolerance)
+        {
+            // The quantization error alone exceeds the tolerance
+            return;
+        }
+    }
+
+    // The error is only checked at the source keys and in the middle between them. Translation and scale
+    // errors are linear between the source keys, but spherical interpolation of rotations is not,
+    // so the segments are validated with a margin that keeps the error in between within the tolerance.
+    const float SegmentTolerance = Tolerance * 0.9f;
+
+    // Checks if the source track is reproduced within the tolerance when all keys between A and B are removed
+    auto IsSegmentValid = [&](Uint32 A, Uint32 B) {
+        const float4 ValueA = DecodeValue(&EncodedValues[size_t{A} * 3]);
+        const float4 ValueB = DecodeValue(&EncodedValues[size_t{B} * 3]);
+        for (Uint32 k = A + 1; k < B; ++k)
+        {
+            const float4 Value = InterpolateKeys(Type, Step, pTimes[A], ValueA, pTimes[B], ValueB, pTimes[k]);
+            if (ComputeError(Type, Value, pValues[k], Info.ShellDistance) > SegmentTolerance)
+                return false;
+        }
+        if (!Step)
+        {
+            for (Uint32 k = A; k < B; ++k)
+            {
+                const float  MidTime  = (pTimes[k] + pTimes[k + 1]) * 0.5f;
+                const float4 MidValue = InterpolateKeys(Type, Step, pTimes[A], ValueA, pTimes[B], ValueB, MidTime);
+                const float4 SrcValue = InterpolateValues(Type, pValues[k], pValues[k + 1], 0.5f);
+                if (ComputeError(Type, MidValue, SrcValue, Info.ShellDistance) > SegmentTolerance)
+                    return false;
+            }
+        }
+        return true;
+    };
+
+    // Greedily extend every segment as far as possible. The segment end is found by
+    // doubling the length until the error exceeds the tolerance, followed by a binary search.
+    // The first and the last keys are always kept, so that the track duration is preserved.
+    const Uint32        LastKey = NumKeys - 1;
+    std::vector<Uint32> Keys{0};
+    for (Uint32 A = 0; A < LastKey;)
+    {
+        Uint32 Valid   = A + 1;
+        Uint32 Invalid = LastKey + 1;
+        for (Uint32 Length = 2; Length <= LastKey - A; Length *= 2)
+        {
+            if (IsSegmentValid(A, A + Length))
+            {
+                Valid = A + Length;
+            }
+            else
+            {
+                Invalid = A + Length;
+                break;
+            }
+        }
+        while (Invalid - Valid > 1)
+        {
+            const Uint32 Mid = (Valid + Invalid) / 2;
+            if (IsSegmentValid(A, Mid))
+                Valid = Mid;
+            else
+                Invalid = Mid;
+        }
+
+        Keys.push_back(Valid);
+        A = Valid;
+    }
+
+    m_KeyTimes.reserve(Keys.size());
+    m_KeyValues.reserve(Keys.size() * 3);
+    for (Uint32 Key : Keys)
+    {
+        m_KeyTimes.push_back(pTimes[Key]);
+        m_KeyValues.insert(m_KeyValues.end(), &EncodedValues[size_t{Key} * 3], &EncodedValues[size_t{Key} * 3] + 3);
+    }
+}
+
+float CompressedAnimationTrack::GetKeyTime(Uint32 Key) const
+{
+    VERIFY_EXPR(Key < m_KeyTimes.size());
+    return m_KeyTimes[Key];
+}
+
+float4 CompressedAnimationTrack::GetKeyValue(Uint32 Key) const
+{
+    VERIFY_EXPR(Key < m_KeyTimes.size());
+    return DecodeValue(&m_KeyValues[size_t{Key} * 3]);
+}
+
+float4 CompressedAnimationTrack::Sample(float Time) const
+{
+    if (m_KeyTimes.empty())
+        return float4{};
+
+    // Find the last key that starts at or before the time
+    const auto It = std::upper_bound(m_KeyTimes.begin(), m_KeyTimes.end(), Time);
+    if (It == m_KeyTimes.begin())
+        return GetKeyValue(0);
+
+    const auto Key = static_cast<Uint32>(It - m_KeyTimes.begin()) - 1;
+    if (Key + 1 >= m_KeyTimes.size())
+        return GetKeyValue(Key);
+
+    return InterpolateKeys(m_Type, m_Step,
+                           m_KeyTimes[Key], GetKeyValue(Key),
+                           m_KeyTimes[Key + 1], GetKeyValue(Key + 1),
+                           Time);
+}
+
+size_t CompressedAnimationTrack::GetMemorySize() const
+{
+    return m_KeyTimes.capacity() * sizeof(float) + m_KeyValues.capacity() * sizeof(Uint16);
+}
+
+} // namespace GLTF
+
+} // namespace Diligent
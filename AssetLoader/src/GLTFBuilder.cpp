@@ -27,6 +27,9 @@
 #include "GLTFBuilder.hpp"
 #include "GLTFLoader.hpp"
 #include "GraphicsAccessories.hpp"
+#include "Errors.hpp"
+#include "StringTools.hpp"
+#include "ParallelFor.hpp"
 
 namespace Diligent
 {
@@ -235,49 +238,308 @@ void ModelBuilder::WriteDefaultAttibutes(Uint32 BufferId, size_t StartOffset, si
     }
 }
 
-void ModelBuilder::InitIndexBuffer(IRenderDevice* pDevice)
+void ModelBuilder::CheckMemoryBudget() const
 {
-    if (m_IndexData.empty())
+    if (m_CI.pMemoryBudget == nullptr)
         return;
 
-    VERIFY_EXPR(m_Model.IndexData.IndexSize > 0);
-    VERIFY_EXPR((m_IndexData.size() % m_Model.IndexData.IndexSize) == 0);
-    VERIFY(!m_Model.IndexData.pBuffer && !m_Model.IndexData.pAllocation, "Index buffer has already been initialized");
+    Uint64 BufferDataSize = m_IndexData.size() + m_IndexData16.size() + m_MorphTargetData.size();
+    for (const auto& Data : m_VertexData)
+        BufferDataSize += Data.size();
 
-    const auto DataSize = static_cast<Uint32>(m_IndexData.size());
-    if (m_CI.pResourceManager != nullptr)
+    // Textures have already been created at this point, and the source data is still alive.
+    auto Required = m_Model.GetMemoryUsage().GetTotal();
+    Required.CPUTransient += m_Model.SourceDataSize + BufferDataSize;
+    Required.GPUReserved += BufferDataSize;
+    Required.GPUUsed += BufferDataSize;
+    if (!m_CI.pMemoryBudget->Fits(Required))
     {
-        m_Model.IndexData.pAllocation = m_CI.pResourceManager->AllocateIndices(DataSize, 4);
+        LOG_ERROR_AND_THROW("The model requires ", Required.GetCPUTotal(), " bytes of CPU memory and ",
+                            Required.GPUReserved, " bytes of GPU memory, which exceeds the memory budget");
+    }
+}
 
-        if (m_Model.IndexData.pAllocation)
+void ModelBuilder::CreateMeshBVHs()
+{
+    const VertexAttributeDesc* pPosAttrib = nullptr;
+    for (Uint32 i = 0; i < m_Model.GetNumVertexAttributes(); ++i)
+    {
+        const auto& Attrib = m_Model.VertexAttributes[i];
+        if (SafeStrEqual(Attrib.Name, PositionAttributeName) && (m_Model.VertexData.EnabledAttributeFlags & (1u << i)) != 0)
         {
-            auto pBuffInitData = BufferInitData::Create();
-            pBuffInitData->Data.emplace_back(std::move(m_IndexData));
-            m_Model.IndexData.pAllocation->SetUserData(pBuffInitData);
+            pPosAttrib = &Attrib;
+            break;
+        }
+    }
+    if (pPosAttrib == nullptr || pPosAttrib->ValueType != VT_FLOAT32 || pPosAttrib->NumComponents < 3)
+    {
+        LOG_WARNING_MESSAGE("Mesh BVHs are not created as the model does not have float3 vertex positions");
+        return;
+    }
 
-            m_Model.IndexData.AllocatorId = m_CI.pResourceManager->GetIndexAllocatorIndex(m_Model.IndexData.pAllocation->GetAllocator());
-            VERIFY_EXPR(m_Model.IndexData.AllocatorId != ~0u);
+    const auto& PosData = m_VertexData[pPosAttrib->BufferId];
+    const auto  Stride  = m_Model.VertexData.Strides[pPosAttrib->BufferId];
+    VERIFY_EXPR(Stride > 0 && (PosData.size() % Stride) == 0);
+
+    std::vector<MeshBVH::PrimitiveData> Primitives;
+    for (auto& Mesh : m_Model.Meshes)
+    {
+        Primitives.clear();
+        for (const auto& Prim : Mesh.Primitives)
+        {
+            MeshBVH::PrimitiveData Data;
+            Data.pPositions     = PosData.data() + pPosAttrib->RelativeOffset;
+            Data.PositionStride = Stride;
+            Data.NumVertices    = static_cast<Uint32>(PosData.size() / Stride);
+            if (Prim.HasIndices())
+            {
+                const auto& IndexData = GetIndexData(Prim.IndexType);
+                Data.pIndices         = &IndexData[size_t{Prim.FirstIndex} * GetValueSize(Prim.IndexType)];
+                Data.IndexType        = Prim.IndexType;
+                Data.IndexCount       = Prim.IndexCount;
+                Data.BaseVertex       = Prim.BaseVertex;
+            }
+            else
+            {
+                Data.IndexCount = Prim.VertexCount;
+                Data.BaseVertex = Prim.FirstVertex;
+            }
+            Primitives.push_back(Data);
         }
-        else
+
+        Mesh.pBVH = std::make_unique<MeshBVH>(Primitives.data(), static_cast<Uint32>(Primitives.size()), m_CI.pThreadPool);
+    }
+}
+
+void ModelBuilder::ComputeJointBounds()
+{
+    if (m_Model.Skins.empty())
+        return;
+
+    auto FindAttribute = [&](const char* Name) -> const VertexAttributeDesc* {
+        for (Uint32 i = 0; i < m_Model.GetNumVertexAttributes(); ++i)
         {
-            UNEXPECTED("Failed to allocate indices from the pool.");
+            const auto& Attrib = m_Model.VertexAttributes[i];
+            if (SafeStrEqual(Attrib.Name, Name) && (m_Model.VertexData.EnabledAttributeFlags & (1u << i)) != 0)
+                return &Attrib;
         }
+        return nullptr;
+    };
+
+    const auto* pPosAttrib     = FindAttribute(PositionAttributeName);
+    const auto* pJointsAttrib  = FindAttribute(JointsAttributeName);
+    const auto* pWeightsAttrib = FindAttribute(WeightsAttributeName);
+    if (pPosAttrib == nullptr || pPosAttrib->ValueType != VT_FLOAT32 || pPosAttrib->NumComponents < 3)
+    {
+        LOG_WARNING_MESSAGE("Joint bounding boxes are not computed as the model does not have float3 vertex positions");
+        return;
     }
-    else
+    if (pJointsAttrib == nullptr || pWeightsAttrib == nullptr)
+    {
+        LOG_WARNING_MESSAGE("Joint bounding boxes are not computed as the model does not have vertex joints and weights");
+        return;
+    }
+    if ((pJointsAttrib->ValueType != VT_FLOAT32 && pJointsAttrib->ValueType != VT_UINT8 && pJointsAttrib->ValueType != VT_UINT16 && pJointsAttrib->ValueType != VT_UINT32) ||
+        (pWeightsAttrib->ValueType != VT_FLOAT32 && pWeightsAttrib->ValueType != VT_UINT8 && pWeightsAttrib->ValueType != VT_UINT16))
+    {
+        LOG_WARNING_MESSAGE("Joint bounding boxes are not computed as vertex joints (", GetValueTypeString(pJointsAttrib->ValueType),
+                            ") or weights (", GetValueTypeString(pWeightsAttrib->ValueType), ") have unsupported type");
+        return;
+    }
+
+    auto GetAttribData = [&](const VertexAttributeDesc& Attrib, Uint32 FirstVertex) {
+        return m_VertexData[Attrib.BufferId].data() + size_t{FirstVertex} * m_Model.VertexData.Strides[Attrib.BufferId] + Attrib.RelativeOffset;
+    };
+
+    for (auto& skin : m_Model.Skins)
+    {
+        skin.JointBounds.resize(skin.Joints.size());
+        for (auto& BB : skin.JointBounds)
+        {
+            BB.Min = float3{+FLT_MAX, +FLT_MAX, +FLT_MAX};
+            BB.Max = float3{-FLT_MAX, -FLT_MAX, -FLT_MAX};
+        }
+    }
+
+    // The same mesh may be skinned by the same skin in multiple nodes
+    std::vector<std::pair<const Mesh*, const Skin*>> ProcessedMeshes;
+    for (const auto& N : m_Model.Nodes)
+    {
+        if (N.pMesh == nullptr || N.pSkin == nullptr)
+            continue;
+
+        const auto MeshSkin = std::make_pair(N.pMesh, N.pSkin);
+        if (std::find(ProcessedMeshes.begin(), ProcessedMeshes.end(), MeshSkin) != ProcessedMeshes.end())
+            continue;
+        ProcessedMeshes.push_back(MeshSkin);
+
+        auto& skin = m_Model.Skins[N.pSkin - m_Model.Skins.data()];
+        VERIFY_EXPR(skin.InverseBindMatrices.empty() || skin.InverseBindMatrices.size() >= skin.Joints.size());
+        for (const auto& Prim : N.pMesh->Primitives)
+        {
+            VERIFY_EXPR(size_t{Prim.FirstVertex + Prim.VertexCount} * m_Model.VertexData.Strides[pPosAttrib->BufferId] <= m_VertexData[pPosAttrib->BufferId].size());
+
+            SkinnedVertexData Vertices;
+            Vertices.pPositions     = GetAttribData(*pPosAttrib, Prim.FirstVertex);
+            Vertices.PositionStride = m_Model.VertexData.Strides[pPosAttrib->BufferId];
+            Vertices.pJoints        = GetAttribData(*pJointsAttrib, Prim.FirstVertex);
+            Vertices.JointType      = pJointsAttrib->ValueType;
+            Vertices.JointStride    = m_Model.VertexData.Strides[pJointsAttrib->BufferId];
+            Vertices.pWeights       = GetAttribData(*pWeightsAttrib, Prim.FirstVertex);
+            Vertices.WeightType     = pWeightsAttrib->ValueType;
+            Vertices.WeightStride   = m_Model.VertexData.Strides[pWeightsAttrib->BufferId];
+            Vertices.NumInfluences  = std::min(pJointsAttrib->NumComponents, pWeightsAttrib->NumComponents);
+            Vertices.NumVertices    = Prim.VertexCount;
+            ComputeJointBoundingBoxes(Vertices,
+                                      !skin.InverseBindMatrices.empty() ? skin.InverseBindMatrices.data() : nullptr,
+                                      static_cast<Uint32>(skin.Joints.size()),
+                                      m_CI.JointBoundsWeightThreshold,
+                                      skin.JointBounds.data());
+        }
+    }
+}
+
+void ModelBuilder::CompressAnimations()
+{
+    VERIFY_EXPR(m_CI.pAnimationCompression != nullptr);
+    const auto& CompressionInfo = *m_CI.pAnimationCompression;
+
+    struct SamplerTrack
     {
-        const auto BindFlags = m_CI.IndBufferBindFlags != BIND_NONE ? m_CI.IndBufferBindFlags : BIND_INDEX_BUFFER;
-        BufferDesc BuffDesc{"GLTF index buffer", DataSize, BindFlags, USAGE_IMMUTABLE};
-        if (BuffDesc.BindFlags & (BIND_SHADER_RESOURCE | BIND_UNORDERED_ACCESS))
+        AnimationSampler*                    pSampler = nullptr;
+        CompressedAnimationTrack::TRACK_TYPE Type     = CompressedAnimationTrack::TRACK_TYPE::TRANSLATION;
+        CompressedAnimationTrack             Track;
+    };
+    std::vector<SamplerTrack> Tracks;
+    for (auto& Anim : m_Model.Animations)
+    {
+        // The track type is defined by the channels that reference the sampler.
+        // Samplers referenced by channels with different path types are not compressed.
+        constexpr int UnusedSampler      = -1;
+        constexpr int IncompatibleTracks = -2;
+        std::vector<int> SamplerPaths(Anim.Samplers.size(), UnusedSampler);
+        for (const auto& Channel : Anim.Channels)
         {
-            BuffDesc.Mode              = BUFFER_MODE_FORMATTED;
-            BuffDesc.ElementByteStride = m_Model.IndexData.IndexSize;
+            if (Channel.SamplerIndex >= Anim.Samplers.size())
+                continue;
+
+            int& Path = SamplerPaths[Channel.SamplerIndex];
+            if (Path == UnusedSampler)
+                Path = static_cast<int>(Channel.PathType);
+            else if (Path != static_cast<int>(Channel.PathType))
+                Path = IncompatibleTracks;
         }
 
-        BufferData BuffData{m_IndexData.data(), BuffDesc.Size};
-        pDevice->CreateBuffer(BuffDesc, &BuffData, &m_Model.IndexData.pBuffer);
+        for (size_t i = 0; i < Anim.Samplers.size(); ++i)
+        {
+            auto& Sampler = Anim.Samplers[i];
+            if (Sampler.Interpolation == AnimationSampler::INTERPOLATION_TYPE::CUBICSPLINE ||
+                Sampler.Inputs.empty() ||
+                Sampler.Inputs.size() != Sampler.OutputsVec4.size())
+                continue;
+
+            SamplerTrack Track;
+            Track.pSampler = &Sampler;
+            switch (SamplerPaths[i])
+            {
+                case static_cast<int>(AnimationChannel::PATH_TYPE::TRANSLATION):
+                    Track.Type = CompressedAnimationTrack::TRACK_TYPE::TRANSLATION;
+                    break;
+
+                case static_cast<int>(AnimationChannel::PATH_TYPE::ROTATION):
+                    Track.Type = CompressedAnimationTrack::TRACK_TYPE::ROTATION;
+                    break;
+
+                case static_cast<int>(AnimationChannel::PATH_TYPE::SCALE):
+                    Track.Type = CompressedAnimationTrack::TRACK_TYPE::SCALE;
+                    break;
+
+                default:
+                    // Unused samplers, morph target weights, and incompatible channels
+                    continue;
+            }
+            Tracks.push_back(std::move(Track));
+        }
+    }
+
+    auto CompressTrack = [&CompressionInfo](SamplerTrack& Track) {
+        const auto& Sampler = *Track.pSampler;
+        Track.Track         = CompressedAnimationTrack{
+            Track.Type,
+            Sampler.Inputs.data(),
+            Sampler.OutputsVec4.data(),
+            static_cast<Uint32>(Sampler.Inputs.size()),
+            Sampler.Interpolation == AnimationSampler::INTERPOLATION_TYPE::STEP,
+            CompressionInfo,
+        };
+    };
+
+    ParallelFor(m_CI.pThreadPool, static_cast<Uint32>(Tracks.size()), [&](Uint32 i) {
+        CompressTrack(Tracks[i]);
+    });
+
+    for (auto& Track : Tracks)
+    {
+        // Tracks that can't be quantized within the tolerance are kept uncompressed
+        if (Track.Track.IsEmpty())
+            continue;
+
+        auto& Sampler      = *Track.pSampler;
+        Sampler.Compressed = std::move(Track.Track);
+        std::vector<float>{}.swap(Sampler.Inputs);
+        std::vector<float4>{}.swap(Sampler.OutputsVec4);
     }
 }
 
+void ModelBuilder::InitIndexBuffer(IRenderDevice* pDevice)
+{
+    auto InitIndexData = [&](std::vector<Uint8>& Data, Model::IndexDataInfo& IndexData, const char* Name) {
+        if (Data.empty())
+            return;
+
+        VERIFY_EXPR(IndexData.IndexSize > 0);
+        VERIFY_EXPR((Data.size() % IndexData.IndexSize) == 0);
+        VERIFY(!IndexData.pBuffer && !IndexData.pAllocation, "Index buffer has already been initialized");
+
+        const auto DataSize = static_cast<Uint32>(Data.size());
+        if (m_CI.pResourceManager != nullptr)
+        {
+            IndexData.pAllocation = m_CI.pResourceManager->AllocateIndices(DataSize, 4);
+
+            if (IndexData.pAllocation)
+            {
+                auto pBuffInitData = BufferInitData::Create();
+                pBuffInitData->Data.emplace_back(std::move(Data));
+                IndexData.pAllocation->SetUserData(pBuffInitData);
+
+                IndexData.AllocatorId = m_CI.pResourceManager->GetIndexAllocatorIndex(IndexData.pAllocation->GetAllocator());
+                VERIFY_EXPR(IndexData.AllocatorId != ~0u);
+            }
+            else
+            {
+                UNEXPECTED("Failed to allocate indices from the pool.");
+            }
+        }
+        else if (pDevice != nullptr)
+        {
+            const auto BindFlags = m_CI.IndBufferBindFlags != BIND_NONE ? m_CI.IndBufferBindFlags : BIND_INDEX_BUFFER;
+            BufferDesc BuffDesc{Name, DataSize, BindFlags, USAGE_IMMUTABLE};
+            if (BuffDesc.BindFlags & (BIND_SHADER_RESOURCE | BIND_UNORDERED_ACCESS))
+            {
+                BuffDesc.Mode              = BUFFER_MODE_FORMATTED;
+                BuffDesc.ElementByteStride = IndexData.IndexSize;
+            }
+
+            BufferData BuffData{Data.data(), BuffDesc.Size};
+            pDevice->CreateBuffer(BuffDesc, &BuffData, &IndexData.pBuffer);
+        }
+    };
+
+    InitIndexData(m_IndexData, m_Model.IndexData, "GLTF index buffer");
+    // 16-bit indices of the adaptive index type are kept in a separate allocation
+    InitIndexData(m_IndexData16, m_Model.IndexData16, "GLTF 16-bit index buffer");
+}
+
 void ModelBuilder::InitVertexBuffers(IRenderDevice* pDevice)
 {
     if (m_VertexData.empty())
@@ -343,7 +605,7 @@ void ModelBuilder::InitVertexBuffers(IRenderDevice* pDevice)
         for (Uint32 i = 0; i < VBCount; ++i)
         {
             const auto& Data = m_VertexData[i];
-            if (Data.empty())
+            if (Data.empty() || pDevice == nullptr)
                 continue;
 
             const auto DataSize  = static_cast<Uint32>(Data.size());
@@ -368,6 +630,49 @@ void ModelBuilder::InitVertexBuffers(IRenderDevice* pDevice)
     }
 }
 
+void ModelBuilder::InitMorphTargetBuffer(IRenderDevice* pDevice)
+{
+    if (m_MorphTargetData.empty())
+        return;
+
+    constexpr auto DeltaStride = Model::MorphTargetDeltaStride;
+    VERIFY_EXPR(m_MorphTargetData.size() % DeltaStride == 0);
+    const auto NumDeltas = static_cast<Uint32>(m_MorphTargetData.size() / DeltaStride);
+
+    if (m_CI.pResourceManager != nullptr)
+    {
+        ResourceManager::VertexLayoutKey LayoutKey;
+        LayoutKey.Elements.emplace_back(DeltaStride, BIND_SHADER_RESOURCE);
+
+        VERIFY(!m_Model.MorphTargetData.pAllocation, "Morph target buffer has already been initialized");
+        m_Model.MorphTargetData.pAllocation = m_CI.pResourceManager->AllocateVertices(LayoutKey, NumDeltas);
+        if (m_Model.MorphTargetData.pAllocation)
+        {
+            auto pBuffInitData = BufferInitData::Create();
+            pBuffInitData->Data.emplace_back(std::move(m_MorphTargetData));
+            m_Model.MorphTargetData.pAllocation->SetUserData(pBuffInitData);
+            m_Model.MorphTargetData.PoolId = m_CI.pResourceManager->GetVertexPoolIndex(LayoutKey, m_Model.MorphTargetData.pAllocation->GetPool());
+            VERIFY_EXPR(m_Model.MorphTargetData.PoolId != ~0u);
+        }
+        else
+        {
+            UNEXPECTED("Failed to allocate morph target deltas from the pool. Make sure that you proived the required layout when creating the pool.");
+        }
+    }
+    else if (pDevice != nullptr)
+    {
+        VERIFY(!m_Model.MorphTargetData.pBuffer, "Morph target buffer has already been initialized");
+
+        const auto DataSize = static_cast<Uint32>(m_MorphTargetData.size());
+        BufferDesc BuffDesc{"GLTF morph target buffer", DataSize, BIND_SHADER_RESOURCE, USAGE_IMMUTABLE};
+        BuffDesc.Mode              = BUFFER_MODE_STRUCTURED;
+        BuffDesc.ElementByteStride = DeltaStride;
+
+        BufferData BuffData{m_MorphTargetData.data(), DataSize};
+        pDevice->CreateBuffer(BuffDesc, &BuffData, &m_Model.MorphTargetData.pBuffer);
+    }
+}
+
 std::pair<FILTER_TYPE, FILTER_TYPE> ModelBuilder::GetFilterType(int32_t GltfFilterMode)
 {
     switch (GltfFilterMode)
@@ -0,0 +1,154 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "GLTFJointBounds.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+namespace
+{
+
+template <typename T>
+T ReadElement(const void* pData, size_t Offset)
+{
+    T Value;
+    memcpy(&Value, static_cast<const Uint8*>(pData) + Offset, sizeof(Value));
+    return Value;
+}
+
+Uint32 ReadJointIndex(const void* pJoints, VALUE_TYPE Type, size_t Offset, Uint32 Influence)
+{
+    switch (Type)
+    {
+        case VT_FLOAT32:
+        {
+            const auto Joint = ReadElement<float>(pJoints, Offset + Influence * sizeof(float));
+            // Negative or NaN values are invalid
+            return Joint >= 0 ? static_cast<Uint32>(Joint + 0.5f) : ~0u;
+        }
+
+        case VT_UINT8: return ReadElement<Uint8>(pJoints, Offset + Influence * sizeof(Uint8));
+        case VT_UINT16: return ReadElement<Uint16>(pJoints, Offset + Influence * sizeof(Uint16));
+        case VT_UINT32: return ReadElement<Uint32>(pJoints, Offset + Influence * sizeof(Uint32));
+
+        default:
+            UNEXPECTED("Unexpected joint index type");
+            return ~0u;
+    }
+}
+
+float ReadWeight(const void* pWeights, VALUE_TYPE Type, size_t Offset, Uint32 Influence)
+{
+    switch (Type)
+    {
+        case VT_FLOAT32: return ReadElement<float>(pWeights, Offset + Influence * sizeof(float));
+        case VT_UINT8: return static_cast<float>(ReadElement<Uint8>(pWeights, Offset + Influence * sizeof(Uint8))) / 255.f;
+        case VT_UINT16: return static_cast<float>(ReadElement<Uint16>(pWeights, Offset + Influence * sizeof(Uint16))) / 65535.f;
+
+        default:
+            UNEXPECTED("Unexpected weight type");
+            return 0;
+    }
+}
+
+} // namespace
+
+void ComputeJointBoundingBoxes(const SkinnedVertexData& Vertices,
+                               const float4x4*          pInverseBindMatrices,
+                               Uint32                   NumJoints,
+                               float                    WeightThreshold,
+                               BoundBox*                pJointBounds)
+{
+    if (Vertices.NumVertices == 0 || NumJoints == 0)
+        return;
+
+    DEV_CHECK_ERR(Vertices.pPositions != nullptr && Vertices.pJoints != nullptr && Vertices.pWeights != nullptr,
+                  "Vertex positions, joints and weights must not be null");
+    DEV_CHECK_ERR(pJointBounds != nullptr, "pJointBounds must not be null");
+
+    for (Uint32 v = 0; v < Vertices.NumVertices; ++v)
+    {
+        const auto Pos = ReadElement<float3>(Vertices.pPositions, size_t{v} * Vertices.PositionStride);
+        for (Uint32 i = 0; i < Vertices.NumInfluences; ++i)
+        {
+            const float Weight = ReadWeight(Vertices.pWeights, Vertices.WeightType, size_t{v} * Vertices.WeightStride, i);
+            if (!(Weight > WeightThreshold))
+                continue;
+
+            const Uint32 Joint = ReadJointIndex(Vertices.pJoints, Vertices.JointType, size_t{v} * Vertices.JointStride, i);
+            if (Joint >= NumJoints)
+                continue;
+
+            float3 JointPos = Pos;
+            if (pInverseBindMatrices != nullptr)
+            {
+                const float4 P = float4{Pos, 1} * pInverseBindMatrices[Joint];
+                JointPos       = float3{P.x, P.y, P.z};
+            }
+
+            auto& Box = pJointBounds[Joint];
+            Box.Min   = std::min(Box.Min, JointPos);
+            Box.Max   = std::max(Box.Max, JointPos);
+        }
+    }
+}
+
+BoundBox ComputeSkinBoundingBox(const BoundBox* pJointBounds,
+                                const float4x4* pJointTransforms,
+                                Uint32          NumJoints)
+{
+    BoundBox SkinBB;
+    SkinBB.Min = float3{+FLT_MAX, +FLT_MAX, +FLT_MAX};
+    SkinBB.Max = float3{-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+    for (Uint32 i = 0; i < NumJoints; ++i)
+    {
+        const auto& JointBB = pJointBounds[i];
+        if (JointBB.Min.x > JointBB.Max.x)
+            continue;
+
+        const auto BB = JointBB.Transform(pJointTransforms[i]);
+        SkinBB.Min    = std::min(SkinBB.Min, BB.Min);
+        SkinBB.Max    = std::max(SkinBB.Max, BB.Max);
+    }
+
+    return SkinBB;
+}
+
+} // namespace GLTF
+
+} // namespace Diligent
@@ -0,0 +1,623 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "GLTFJsonIndex.hpp"
+
+#include <cstdlib>
+#include <clocale>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+namespace
+{
+
+inline bool IsWhitespace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+inline bool IsDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+inline int HexDigitValue(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+Uint32 ParseHex4(const char* pHex)
+{
+    Uint32 Value = 0;
+    for (int i = 0; i < 4; ++i)
+        Value = (Value << 4u) | static_cast<Uint32>(HexDigitValue(pHex[i]));
+    return Value;
+}
+
+void AppendUTF8(std::string& Str, Uint32 CodePoint)
+{
+    if (CodePoint < 0x80)
+    {
+        Str.push_back(static_cast<char>(CodePoint));
+    }
+    else if (CodePoint < 0x800)
+    {
+        Str.push_back(static_cast<char>(0xC0 | (CodePoint >> 6)));
+        Str.push_back(static_cast<char>(0x80 | (CodePoint & 0x3F)));
+    }
+    else if (CodePoint < 0x10000)
+    {
+        Str.push_back(static_cast<char>(0xE0 | (CodePoint >> 12)));
+        Str.push_back(static_cast<char>(0x80 | ((CodePoint >> 6) & 0x3F)));
+        Str.push_back(static_cast<char>(0x80 | (CodePoint & 0x3F)));
+    }
+    else
+    {
+        Str.push_back(static_cast<char>(0xF0 | (CodePoint >> 18)));
+        Str.push_back(static_cast<char>(0x80 | ((CodePoint >> 12) & 0x3F)));
+        Str.push_back(static_cast<char>(0x80 | ((CodePoint >> 6) & 0x3F)));
+        Str.push_back(static_cast<char>(0x80 | (CodePoint & 0x3F)));
+    }
+}
+
+// Decodes the escape sequences of the string that has been validated by the parser.
+std::string UnescapeString(const char* pStr, size_t Length)
+{
+    std::string Str;
+    Str.reserve(Length);
+    for (size_t i = 0; i < Length; ++i)
+    {
+        const char c = pStr[i];
+        if (c != '\\')
+        {
+            Str.push_back(c);
+            continue;
+        }
+
+        const char Esc = pStr[++i];
+        switch (Esc)
+        {
+            // clang-format off
+            case 'b': Str.push_back('\b'); break;
+            case 'f': Str.push_back('\f'); break;
+            case 'n': Str.push_back('\n'); break;
+            case 'r': Str.push_back('\r'); break;
+            case 't': Str.push_back('\t'); break;
+            // clang-format on
+
+            case 'u':
+            {
+                Uint32 CodePoint = ParseHex4(pStr + i + 1);
+                i += 4;
+                // Surrogate pair
+                if (CodePoint >= 0xD800 && CodePoint <= 0xDBFF && i + 6 < Length && pStr[i + 1] == '\\' && pStr[i + 2] == 'u')
+                {
+                    const auto Low = ParseHex4(pStr + i + 3);
+                    if (Low >= 0xDC00 && Low <= 0xDFFF)
+                    {
+                        CodePoint = 0x10000 + ((CodePoint - 0xD800) << 10u) + (Low - 0xDC00);
+                        i += 6;
+                    }
+                }
+                AppendUTF8(Str, CodePoint);
+                break;
+            }
+
+            default:
+                // '"', '\\' and '/'
+                Str.push_back(Esc);
+        }
+    }
+    return Str;
+}
+
+// Parses the number that has been validated by the parser.
+double ParseNumber(const char* pNum, size_t Length)
+{
+    // Powers of 10 that are exactly representable as double
+    static constexpr double Pow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    const char* const pEnd = pNum + Length;
+    const char*       pos  = pNum;
+
+    const bool Negative = *pos == '-';
+    if (Negative)
+        ++pos;
+
+    Uint64 Mantissa    = 0;
+    int    NumDigits   = 0;
+    int    Exponent    = 0;
+    bool   Truncated   = false;
+    auto   AppendDigit = [&](char c) {
+        if (NumDigits < 19)
+        {
+            Mantissa = Mantissa * 10 + static_cast<Uint64>(c - '0');
+            if (Mantissa != 0)
+                ++NumDigits;
+            return true;
+        }
+        Truncated = Truncated || c != '0';
+        return false;
+    };
+
+    for (; pos < pEnd && IsDigit(*pos); ++pos)
+    {
+        if (!AppendDigit(*pos))
+            ++Exponent;
+    }
+    if (pos < pEnd && *pos == '.')
+    {
+        for (++pos; pos < pEnd && IsDigit(*pos); ++pos)
+        {
+            if (AppendDigit(*pos))
+                --Exponent;
+        }
+    }
+    if (pos < pEnd && (*pos == 'e' || *pos == 'E'))
+    {
+        ++pos;
+        const bool NegativeExp = *pos == '-';
+        if (*pos == '-' || *pos == '+')
+            ++pos;
+        int Exp = 0;
+        for (; pos < pEnd && IsDigit(*pos); ++pos)
+        {
+            if (Exp < 100000)
+                Exp = Exp * 10 + (*pos - '0');
+        }
+        Exponent += NegativeExp ? -Exp : Exp;
+    }
+
+    // Fast path: both the mantissa and the power of 10 are exactly representable,
+    // so the result is correctly rounded.
+    if (!Truncated && Mantissa <= (Uint64{1} << 53u) && Exponent >= -22 && Exponent <= 22)
+    {
+        double Value = static_cast<double>(Mantissa);
+        Value        = Exponent < 0 ? Value / Pow10[-Exponent] : Value * Pow10[Exponent];
+        return Negative ? -Value : Value;
+    }
+
+    // Slow path
+    std::string Str{pNum, Length};
+    // strtod uses the current locale's decimal point
+    const char DecimalPoint = std::localeconv()->decimal_point[0];
+    if (DecimalPoint != '.')
+    {
+        const auto dot_pos = Str.find('.');
+        if (dot_pos != std::string::npos)
+            Str[dot_pos] = DecimalPoint;
+    }
+    return std::strtod(Str.c_str(), nullptr);
+}
+
+} // namespace
+
+bool JsonIndex::Parse(const char* pText, size_t Size, std::string* pError)
+{
+    m_pText = pText;
+    m_Size  = Size;
+    m_Tokens.clear();
+
+    size_t Pos = 0;
+
+    auto Fail = [&](const char* Msg) {
+        if (pError != nullptr)
+            *pError = std::string{Msg} + " at offset " + std::to_string(Pos);
+        m_Tokens.clear();
+        return false;
+    };
+
+    if (pText == nullptr || Size >= std::numeric_limits<Uint32>::max())
+        return Fail("Invalid JSON text");
+
+    auto SkipWhitespace = [&]() {
+        while (Pos < Size && IsWhitespace(pText[Pos]))
+            ++Pos;
+    };
+
+    // Parses the string that starts at Pos and adds the string token.
+    auto ParseString = [&]() {
+        VERIFY_EXPR(pText[Pos] == '"');
+        Token Tok;
+        Tok.Type   = JSON_TYPE_STRING;
+        Tok.Offset = static_cast<Uint32>(++Pos);
+        while (true)
+        {
+            if (Pos >= Size)
+                return false;
+
+            const char c = pText[Pos];
+            if (c == '"')
+                break;
+
+            if (c == '\\')
+            {
+                Tok.Escaped = true;
+                if (++Pos >= Size)
+                    return false;
+
+                switch (pText[Pos])
+                {
+                    case '"':
+                    case '\\':
+                    case '/':
+                    case 'b':
+                    case 'f':
+                    case 'n':
+                    case 'r':
+                    case 't':
+                        break;
+
+                    case 'u':
+                        if (Pos + 4 >= Size)
+                            return false;
+                        for (size_t i = 1; i <= 4; ++i)
+                        {
+                            if (HexDigitValue(pText[Pos + i]) < 0)
+                                return false;
+                        }
+                        Pos += 4;
+                        break;
+
+                    default:
+                        return false;
+                }
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+                // Control characters must be escaped
+                return false;
+            }
+            ++Pos;
+        }
+        Tok.Length = static_cast<Uint32>(Pos - Tok.Offset);
+        Tok.End    = static_cast<Uint32>(m_Tokens.size() + 1);
+        m_Tokens.push_back(Tok);
+        ++Pos; // Skip closing quote
+        return true;
+    };
+
+    // Parses the number that starts at Pos and adds the number token.
+    auto ParseNumberToken = [&]() {
+        const size_t Start = Pos;
+        if (pText[Pos] == '-')
+            ++Pos;
+
+        if (Pos >= Size || !IsDigit(pText[Pos]))
+            return false;
+        if (pText[Pos] == '0')
+        {
+            ++Pos;
+        }
+        else
+        {
+            while (Pos < Size && IsDigit(pText[Pos]))
+                ++Pos;
+        }
+
+        if (Pos < Size && pText[Pos] == '.')
+        {
+            ++Pos;
+            if (Pos >= Size || !IsDigit(pText[Pos]))
+                return false;
+            while (Pos < Size && IsDigit(pText[Pos]))
+                ++Pos;
+        }
+
+        if (Pos < Size && (pText[Pos] == 'e' || pText[Pos] == 'E'))
+        {
+            ++Pos;
+            if (Pos < Size && (pText[Pos] == '+' || pText[Pos] == '-'))
+                ++Pos;
+            if (Pos >= Size || !IsDigit(pText[Pos]))
+                return false;
+            while (Pos < Size && IsDigit(pText[Pos]))
+                ++Pos;
+        }
+
+        Token Tok;
+        Tok.Type   = JSON_TYPE_NUMBER;
+        Tok.Offset = static_cast<Uint32>(Start);
+        Tok.Length = static_cast<Uint32>(Pos - Start);
+        Tok.End    = static_cast<Uint32>(m_Tokens.size() + 1);
+        m_Tokens.push_back(Tok);
+        return true;
+    };
+
+    // Parses the literal that starts at Pos and adds the literal token.
+    auto ParseLiteral = [&](const char* Literal, JSON_TYPE Type) {
+        const size_t Len = strlen(Literal);
+        if (Size - Pos < Len || memcmp(pText + Pos, Literal, Len) != 0)
+            return false;
+
+        Token Tok;
+        Tok.Type   = Type;
+        Tok.Offset = static_cast<Uint32>(Pos);
+        Tok.Length = static_cast<Uint32>(Len);
+        Tok.End    = static_cast<Uint32>(m_Tokens.size() + 1);
+        m_Tokens.push_back(Tok);
+        Pos += Len;
+        return true;
+    };
+
+    // Parses the object member key and the colon that follows it.
+    auto ParseKey = [&]() {
+        SkipWhitespace();
+        if (Pos >= Size || pText[Pos] != '"' || !ParseString())
+            return false;
+        SkipWhitespace();
+        if (Pos >= Size || pText[Pos] != ':')
+            return false;
+        ++Pos;
+        return true;
+    };
+
+    // A rough estimate that avoids most reallocations for typical glTF documents
+    m_Tokens.reserve(Size / 6 + 16);
+
+    // Indices of the open containers
+    std::vector<Uint32> Stack;
+
+    static constexpr size_t MaxDepth = 512;
+
+    bool ExpectValue = true;
+    while (true)
+    {
+        if (ExpectValue)
+        {
+            SkipWhitespace();
+            if (Pos >= Size)
+                return Fail("Unexpected end of data");
+
+            const char c = pText[Pos];
+            if (c == '{' || c == '[')
+            {
+                if (Stack.size() >= MaxDepth)
+                    return Fail("Maximum nesting depth exceeded");
+
+                const auto TokenId = static_cast<Uint32>(m_Tokens.size());
+
+                Token Tok;
+                Tok.Type   = c == '{' ? JSON_TYPE_OBJECT : JSON_TYPE_ARRAY;
+                Tok.Offset = static_cast<Uint32>(Pos);
+                m_Tokens.push_back(Tok);
+                ++Pos;
+
+                SkipWhitespace();
+                const char Close = c == '{' ? '}' : ']';
+                if (Pos < Size && pText[Pos] == Close)
+                {
+                    // Empty container
+                    ++Pos;
+                    m_Tokens[TokenId].Length = static_cast<Uint32>(Pos - Tok.Offset);
+                    m_Tokens[TokenId].End    = TokenId + 1;
+                }
+                else
+                {
+                    Stack.push_back(TokenId);
+                    if (c == '{' && !ParseKey())
+                        return Fail("Expected object member key");
+                    continue;
+                }
+            }
+            else if (c == '"')
+            {
+                if (!ParseString())
+                    return Fail("Invalid string");
+            }
+            else if (c == '-' || IsDigit(c))
+            {
+                if (!ParseNumberToken())
+                    return Fail("Invalid number");
+            }
+            else if (c == 't' || c == 'f' || c == 'n')
+            {
+                const bool IsValid =
+                    c == 't' ? ParseLiteral("true", JSON_TYPE_TRUE) :
+                    c == 'f' ? ParseLiteral("false", JSON_TYPE_FALSE) :
+                               ParseLiteral("null", JSON_TYPE_NULL);
+                if (!IsValid)
+                    return Fail("Invalid literal");
+            }
+            else
+            {
+                return Fail("Unexpected character");
+            }
+        }
+
+        // A value has been completed
+        if (Stack.empty())
+            break;
+
+        SkipWhitespace();
+        if (Pos >= Size)
+            return Fail("Unexpected end of data");
+
+        const auto ContainerId = Stack.back();
+        auto&      Container   = m_Tokens[ContainerId];
+        ++Container.Size;
+
+        const bool IsObject = Container.Type == JSON_TYPE_OBJECT;
+        const char c        = pText[Pos];
+        if (c == ',')
+        {
+            ++Pos;
+            if (IsObject && !ParseKey())
+                return Fail("Expected object member key");
+            ExpectValue = true;
+        }
+        else if (c == (IsObject ? '}' : ']'))
+        {
+            ++Pos;
+            Container.Length = static_cast<Uint32>(Pos - Container.Offset);
+            Container.End    = static_cast<Uint32>(m_Tokens.size());
+            Stack.pop_back();
+            ExpectValue = false;
+        }
+        else
+        {
+            return Fail(IsObject ? "Expected ',' or '}'" : "Expected ',' or ']'");
+        }
+    }
+
+    SkipWhitespace();
+    if (Pos != Size)
+        return Fail("Unexpected data after the root value");
+
+    return true;
+}
+
+JSON_TYPE JsonValue::GetType() const
+{
+    return m_pIndex != nullptr ? m_pIndex->GetToken(m_TokenId).Type : JSON_TYPE_NULL;
+}
+
+Uint32 JsonValue::GetSize() const
+{
+    return m_pIndex != nullptr ? m_pIndex->GetToken(m_TokenId).Size : 0;
+}
+
+JsonValue JsonValue::operator[](Uint32 Idx) const
+{
+    if (!IsArray() || Idx >= GetSize())
+        return {};
+
+    Uint32 TokenId = GetFirstChild();
+    for (Uint32 i = 0; i < Idx; ++i)
+        TokenId = GetNextSibling(TokenId);
+    return JsonValue{m_pIndex, TokenId};
+}
+
+JsonValue JsonValue::Find(const char* Key) const
+{
+    if (!IsObject())
+        return {};
+
+    const auto Size  = GetSize();
+    Uint32     KeyId = GetFirstChild();
+    for (Uint32 i = 0; i < Size; ++i)
+    {
+        if (JsonValue{m_pIndex, KeyId}.StringEquals(Key))
+            return JsonValue{m_pIndex, KeyId + 1};
+        KeyId = GetNextSibling(KeyId + 1);
+    }
+    return {};
+}
+
+double JsonValue::GetNumber(double Default) const
+{
+    if (!IsNumber())
+        return Default;
+
+    const auto& Tok = m_pIndex->GetToken(m_TokenId);
+    return ParseNumber(m_pIndex->m_pText + Tok.Offset, Tok.Length);
+}
+
+bool JsonValue::GetUint(Uint64& Value, Uint64 MaxValue) const
+{
+    if (!IsNumber())
+        return false;
+
+    // Doubles represent all integers up to 2^53 exactly
+    const double Number = GetNumber();
+    if (!(Number >= 0 && Number <= static_cast<double>(std::min(MaxValue, Uint64{1} << 53))) || Number != std::floor(Number))
+        return false;
+
+    Value = static_cast<Uint64>(Number);
+    return true;
+}
+
+bool JsonValue::GetBool(bool Default) const
+{
+    switch (GetType())
+    {
+        case JSON_TYPE_TRUE: return true;
+        case JSON_TYPE_FALSE: return false;
+        default: return Default;
+    }
+}
+
+std::string JsonValue::GetString(const char* Default) const
+{
+    if (!IsString())
+        return Default != nullptr ? Default : "";
+
+    const auto& Tok  = m_pIndex->GetToken(m_TokenId);
+    const auto* pStr = m_pIndex->m_pText + Tok.Offset;
+    return Tok.Escaped ? UnescapeString(pStr, Tok.Length) : std::string{pStr, Tok.Length};
+}
+
+bool JsonValue::StringEquals(const char* Str) const
+{
+    if (!IsString() || Str == nullptr)
+        return false;
+
+    const auto& Tok = m_pIndex->GetToken(m_TokenId);
+    if (Tok.Escaped)
+        return GetString() == Str;
+
+    return strncmp(m_pIndex->m_pText + Tok.Offset, Str, Tok.Length) == 0 && Str[Tok.Length] == '\0';
+}
+
+const char* JsonValue::GetRawData() const
+{
+    if (m_pIndex == nullptr)
+        return nullptr;
+
+    const auto& Tok = m_pIndex->GetToken(m_TokenId);
+    return m_pIndex->m_pText + Tok.Offset - (Tok.Type == JSON_TYPE_STRING ? 1 : 0);
+}
+
+size_t JsonValue::GetRawSize() const
+{
+    if (m_pIndex == nullptr)
+        return 0;
+
+    const auto& Tok = m_pIndex->GetToken(m_TokenId);
+    return Tok.Length + (Tok.Type == JSON_TYPE_STRING ? 2 : 0);
+}
+
+} // namespace GLTF
+
+} // namespace Diligent
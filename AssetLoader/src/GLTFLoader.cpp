@@ -27,8 +27,12 @@
 
 #include <vector>
 #include <memory>
+#include <algorithm>
+#include <cstring>
 #include <cmath>
 #include <limits>
+#include <atomic>
+#include <unordered_map>
 
 #include "GLTFLoader.hpp"
 #include "MapHelper.hpp"
@@ -45,6 +49,13 @@
 #include "GLTFBuilder.hpp"
 #include "FixedLinearAllocator.hpp"
 #include "DefaultRawMemoryAllocator.hpp"
+#include "ParallelFor.hpp"
+#include "GLTFMeshoptDecoder.hpp"
+#include "GLTFJsonIndex.hpp"
+#include "HashUtils.hpp"
+#include "StringTools.hpp"
+#include "DXSDKMeshLoader.hpp"
+#include "DXSDKMeshConverter.hpp"
 
 #define TINYGLTF_IMPLEMENTATION
 #define TINYGLTF_NO_STB_IMAGE
@@ -116,6 +127,17 @@ struct TinyGltfNodeWrapper
     auto        GetLightId()     const { return Node.light; }
     auto        GetSkinId()      const { return Node.skin; }
     // clang-format on
+
+    // Returns the accessor index of the EXT_mesh_gpu_instancing attribute, or -1 if the attribute is not present.
+    int GetInstanceAttribute(const char* Name) const
+    {
+        auto ext_it = Node.extensions.find("EXT_mesh_gpu_instancing");
+        if (ext_it == Node.extensions.end() || !ext_it->second.Has("attributes"))
+            return -1;
+
+        const auto& Attributes = ext_it->second.Get("attributes");
+        return Attributes.Has(Name) ? Attributes.Get(Name).GetNumberAsInt() : -1;
+    }
 };
 
 struct TinyGltfPrimitiveWrapper
@@ -134,6 +156,17 @@ struct TinyGltfPrimitiveWrapper
 
     auto GetIndicesId() const { return Primitive.indices; }
     auto GetMaterialId() const { return Primitive.material; }
+
+    auto GetTargetCount() const { return Primitive.targets.size(); }
+
+    const int* GetTargetAttribute(size_t TargetId, const char* Name) const
+    {
+        const auto& Target    = Primitive.targets[TargetId];
+        auto        attrib_it = Target.find(Name);
+        return attrib_it != Target.end() ?
+            &attrib_it->second :
+            nullptr;
+    }
 };
 
 struct TinyGltfMeshWrapper
@@ -143,6 +176,8 @@ struct TinyGltfMeshWrapper
     const auto& Get() const { return Mesh; }
     const auto& GetName() const { return Mesh.name; }
 
+    const auto& GetWeights() const { return Mesh.weights; }
+
     auto GetPrimitiveCount() const { return Mesh.primitives.size(); }
     auto GetPrimitive(size_t Idx) const { return TinyGltfPrimitiveWrapper{Mesh.primitives[Idx]}; };
 };
@@ -176,6 +211,15 @@ struct TinyGltfAccessorWrapper
     auto GetComponentType() const { return TinyGltfComponentTypeToValueType(Accessor.componentType); }
     auto GetNumComponents() const { return tinygltf::GetNumComponentsInType(Accessor.type); }
     bool IsNormalized()     const { return Accessor.normalized; }
+
+    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#sparse-accessors
+    bool IsSparse()                        const { return Accessor.sparse.isSparse; }
+    auto GetSparseCount()                  const { return Accessor.sparse.count; }
+    auto GetSparseIndicesBufferViewId()    const { return Accessor.sparse.indices.bufferView; }
+    auto GetSparseIndicesByteOffset()      const { return Accessor.sparse.indices.byteOffset; }
+    auto GetSparseIndicesComponentType()   const { return TinyGltfComponentTypeToValueType(Accessor.sparse.indices.componentType); }
+    auto GetSparseValuesBufferViewId()     const { return Accessor.sparse.values.bufferView; }
+    auto GetSparseValuesByteOffset()       const { return Accessor.sparse.values.byteOffset; }
     // clang-format on
     auto GetByteStride(const TinyGltfBufferViewWrapper& View) const;
 };
@@ -235,6 +279,7 @@ struct TinyGltfBufferViewWrapper
 
     auto GetBufferId() const { return View.buffer; }
     auto GetByteOffset() const { return View.byteOffset; }
+    auto GetByteLength() const { return View.byteLength; }
 };
 
 struct TinyGltfBufferWrapper
@@ -242,6 +287,7 @@ struct TinyGltfBufferWrapper
     const tinygltf::Buffer& Buffer;
 
     const auto* GetData(size_t Offset) const { return &Buffer.data[Offset]; }
+    auto        GetSize() const { return Buffer.data.size(); }
 };
 
 struct TinyGltfSkinWrapper
@@ -343,11 +389,13 @@ struct TinyGltfModelWrapper
     auto GetSkin      (size_t idx) const { return TinyGltfSkinWrapper      {Model.skins      [idx]}; }
     auto GetAnimation (size_t idx) const { return TinyGltfAnimationWrapper {Model.animations [idx]}; }
 
-    auto GetNodeCount()      const { return Model.nodes.size();      }
-    auto GetSceneCount()     const { return Model.scenes.size();     }
-    auto GetMeshCount()      const { return Model.meshes.size();     }
-    auto GetSkinCount()      const { return Model.skins.size();      }
-    auto GetAnimationCount() const { return Model.animations.size(); }
+    auto GetNodeCount()       const { return Model.nodes.size();       }
+    auto GetSceneCount()      const { return Model.scenes.size();      }
+    auto GetMeshCount()       const { return Model.meshes.size();      }
+    auto GetSkinCount()       const { return Model.skins.size();       }
+    auto GetAnimationCount()  const { return Model.animations.size();  }
+    auto GetBufferViewCount() const { return Model.bufferViews.size(); }
+    auto GetBufferCount()     const { return Model.buffers.size();     }
 
     auto GetDefaultSceneId() const { return Model.defaultScene; }
     // clang-format on
@@ -358,6 +406,471 @@ auto TinyGltfAccessorWrapper::GetByteStride(const TinyGltfBufferViewWrapper& Vie
     return Accessor.ByteStride(View.View);
 }
 
+struct DXSDKMeshBufferWrapper
+{
+    const Uint8* pData;
+    const size_t Size;
+
+    const auto* GetData(size_t Offset) const { return pData + Offset; }
+    auto        GetSize() const { return Size; }
+};
+
+// Reads the vertex and index data directly from the DXSDKMesh the glTF model
+// was converted from (see ConvertDXSDKMeshToGltf).
+struct DXSDKMeshGltfModelWrapper : TinyGltfModelWrapper
+{
+    const std::vector<const Uint8*>& BufferData;
+
+    DXSDKMeshGltfModelWrapper(const tinygltf::Model& _Model, const std::vector<const Uint8*>& _BufferData) :
+        TinyGltfModelWrapper{_Model},
+        BufferData{_BufferData}
+    {}
+
+    // Every buffer is covered by the buffer view with the same index
+    auto GetBuffer(int idx) const { return DXSDKMeshBufferWrapper{BufferData[idx], Model.bufferViews[idx].byteLength}; }
+};
+
+
+// Wrappers that read the scene graph, meshes, accessors, skins and animations directly from the JSON index.
+// Buffers, buffer views and lights are taken from the tinygltf model that is parsed from the reduced document
+// (see GetReducedGltfJson).
+
+int JsonGltfAccessorTypeToTinyGltfType(const JsonValue& Type)
+{
+    static constexpr std::pair<const char*, int> Types[] = {
+        {"SCALAR", TINYGLTF_TYPE_SCALAR},
+        {"VEC2", TINYGLTF_TYPE_VEC2},
+        {"VEC3", TINYGLTF_TYPE_VEC3},
+        {"VEC4", TINYGLTF_TYPE_VEC4},
+        {"MAT2", TINYGLTF_TYPE_MAT2},
+        {"MAT3", TINYGLTF_TYPE_MAT3},
+        {"MAT4", TINYGLTF_TYPE_MAT4},
+    };
+    for (const auto& It : Types)
+    {
+        if (Type.StringEquals(It.first))
+            return It.second;
+    }
+    return -1;
+}
+
+std::vector<JsonValue> GetJsonArrayElements(const JsonValue& Array)
+{
+    std::vector<JsonValue> Elements;
+    Elements.reserve(Array.GetSize());
+    Array.ProcessElements([&Elements](Uint32, const JsonValue& Elem) {
+        Elements.push_back(Elem);
+    });
+    return Elements;
+}
+
+struct JsonGltfNodeWrapper
+{
+    const JsonValue Node;
+
+    const auto& Get() const { return Node; }
+
+    // clang-format off
+    auto GetName()        const { return Node.Find("name").GetString(); }
+    auto GetTranslation() const { return Node.Find("translation").GetNumberArray<double>(); }
+    auto GetRotation()    const { return Node.Find("rotation").GetNumberArray<double>(); }
+    auto GetScale()       const { return Node.Find("scale").GetNumberArray<double>(); }
+    auto GetMatrix()      const { return Node.Find("matrix").GetNumberArray<double>(); }
+    auto GetChildrenIds() const { return Node.Find("children").GetNumberArray<int>(); }
+    auto GetMeshId()      const { return Node.Find("mesh").GetInt(-1); }
+    auto GetCameraId()    const { return Node.Find("camera").GetInt(-1); }
+    auto GetSkinId()      const { return Node.Find("skin").GetInt(-1); }
+    // clang-format on
+
+    auto GetLightId() const
+    {
+        return Node.Find("extensions").Find("KHR_lights_punctual").Find("light").GetInt(-1);
+    }
+
+    // Returns the accessor index of the EXT_mesh_gpu_instancing attribute, or -1 if the attribute is not present.
+    int GetInstanceAttribute(const char* Name) const
+    {
+        return Node.Find("extensions").Find("EXT_mesh_gpu_instancing").Find("attributes").Find(Name).GetInt(-1);
+    }
+};
+
+struct JsonGltfPrimitiveWrapper
+{
+    // The builder keeps pointers to the attribute indices while the wrapper is alive,
+    // so the indices are decoded once and stored in the wrapper.
+    using AttributesType = std::vector<std::pair<JsonValue, int>>;
+
+    const JsonValue             Primitive;
+    AttributesType              Attributes;
+    std::vector<AttributesType> Targets;
+
+    static AttributesType ReadAttributes(const JsonValue& Attribs)
+    {
+        AttributesType Attributes;
+        Attributes.reserve(Attribs.GetSize());
+        Attribs.ProcessMembers([&Attributes](const JsonValue& Key, const JsonValue& Value) {
+            Attributes.emplace_back(Key, Value.GetInt(-1));
+        });
+        return Attributes;
+    }
+
+    static const int* FindAttribute(const AttributesType& Attributes, const char* Name)
+    {
+        for (const auto& Attrib : Attributes)
+        {
+            if (Attrib.first.StringEquals(Name))
+                return &Attrib.second;
+        }
+        return nullptr;
+    }
+
+    explicit JsonGltfPrimitiveWrapper(const JsonValue& Prim) :
+        Primitive{Prim},
+        Attributes{ReadAttributes(Prim.Find("attributes"))}
+    {
+        Prim.Find("targets").ProcessElements([this](Uint32, const JsonValue& Target) {
+            Targets.emplace_back(ReadAttributes(Target));
+        });
+    }
+
+    const int* GetAttribute(const char* Name) const
+    {
+        return FindAttribute(Attributes, Name);
+    }
+
+    const auto& Get() const { return Primitive; }
+
+    auto GetIndicesId() const { return Primitive.Find("indices").GetInt(-1); }
+    auto GetMaterialId() const { return Primitive.Find("material").GetInt(-1); }
+
+    auto GetTargetCount() const { return Targets.size(); }
+
+    const int* GetTargetAttribute(size_t TargetId, const char* Name) const
+    {
+        return FindAttribute(Targets[TargetId], Name);
+    }
+};
+
+struct JsonGltfMeshWrapper
+{
+    const JsonValue              Mesh;
+    const std::vector<JsonValue> Primitives;
+
+    explicit JsonGltfMeshWrapper(const JsonValue& _Mesh) :
+        Mesh{_Mesh},
+        Primitives{GetJsonArrayElements(_Mesh.Find("primitives"))}
+    {}
+
+    const auto& Get() const { return Mesh; }
+    auto        GetName() const { return Mesh.Find("name").GetString(); }
+
+    auto GetWeights() const { return Mesh.Find("weights").GetNumberArray<double>(); }
+
+    auto GetPrimitiveCount() const { return Primitives.size(); }
+    auto GetPrimitive(size_t Idx) const { return JsonGltfPrimitiveWrapper{Primitives[Idx]}; };
+};
+
+// Returns a non-negative integer property of an accessor, or zero if the property is not present.
+template <typename T>
+T GetJsonAccessorSize(const JsonValue& Object, const char* Name)
+{
+    const auto Value = Object.Find(Name);
+    if (!Value)
+        return 0;
+
+    Uint64 Size = 0;
+    if (!Value.GetUint(Size, static_cast<Uint64>(std::numeric_limits<T>::max())))
+        LOG_ERROR_AND_THROW("Accessor property '", Name, "' must be a non-negative integer not greater than ", std::numeric_limits<T>::max());
+
+    return static_cast<T>(Size);
+}
+
+struct JsonGltfAccessorWrapper
+{
+    size_t              Count         = 0;
+    int                 BufferView    = -1;
+    size_t              ByteOffset    = 0;
+    int                 ComponentType = -1;
+    int                 Type          = -1;
+    bool                Normalized    = false;
+    std::vector<double> MinValues;
+    std::vector<double> MaxValues;
+
+    struct SparseInfo
+    {
+        bool IsSparse             = false;
+        int  Count                = 0;
+        int  IndicesBufferView    = -1;
+        int  IndicesByteOffset    = 0;
+        int  IndicesComponentType = -1;
+        int  ValuesBufferView     = -1;
+        int  ValuesByteOffset     = 0;
+    };
+    SparseInfo Sparse;
+
+    explicit JsonGltfAccessorWrapper(const JsonValue& Accessor)
+    {
+        // The wrapper is created every time the accessor data is read, so all
+        // properties are decoded once rather than looked up on every access.
+        // clang-format off
+        Count         = GetJsonAccessorSize<size_t>(Accessor, "count");
+        BufferView    = Accessor.Find("bufferView").GetInt(-1);
+        ByteOffset    = GetJsonAccessorSize<size_t>(Accessor, "byteOffset");
+        ComponentType = Accessor.Find("componentType").GetInt(-1);
+        Type          = JsonGltfAccessorTypeToTinyGltfType(Accessor.Find("type"));
+        Normalized    = Accessor.Find("normalized").GetBool();
+        MinValues     = Accessor.Find("min").GetNumberArray<double>();
+        MaxValues     = Accessor.Find("max").GetNumberArray<double>();
+        // clang-format on
+
+        if (const auto SparseVal = Accessor.Find("sparse"))
+        {
+            const auto Indices = SparseVal.Find("indices");
+            const auto Values  = SparseVal.Find("values");
+
+            // clang-format off
+            Sparse.IsSparse             = true;
+            Sparse.Count                = GetJsonAccessorSize<int>(SparseVal, "count");
+            Sparse.IndicesBufferView    = Indices.Find("bufferView").GetInt(-1);
+            Sparse.IndicesByteOffset    = GetJsonAccessorSize<int>(Indices, "byteOffset");
+            Sparse.IndicesComponentType = Indices.Find("componentType").GetInt(-1);
+            Sparse.ValuesBufferView     = Values.Find("bufferView").GetInt(-1);
+            Sparse.ValuesByteOffset     = GetJsonAccessorSize<int>(Values, "byteOffset");
+            // clang-format on
+        }
+    }
+
+    auto GetCount() const { return Count; }
+    auto GetMinValues() const
+    {
+        return MinValues.size() >= 3 ?
+            float3{static_cast<float>(MinValues[0]), static_cast<float>(MinValues[1]), static_cast<float>(MinValues[2])} :
+            float3{};
+    }
+    auto GetMaxValues() const
+    {
+        return MaxValues.size() >= 3 ?
+            float3{static_cast<float>(MaxValues[0]), static_cast<float>(MaxValues[1]), static_cast<float>(MaxValues[2])} :
+            float3{};
+    }
+
+    // clang-format off
+    auto GetBufferViewId()  const { return BufferView; }
+    auto GetByteOffset()    const { return ByteOffset; }
+    auto GetComponentType() const { return TinyGltfComponentTypeToValueType(ComponentType); }
+    auto GetNumComponents() const { return tinygltf::GetNumComponentsInType(Type); }
+    bool IsNormalized()     const { return Normalized; }
+
+    bool IsSparse()                        const { return Sparse.IsSparse; }
+    auto GetSparseCount()                  const { return Sparse.Count; }
+    auto GetSparseIndicesBufferViewId()    const { return Sparse.IndicesBufferView; }
+    auto GetSparseIndicesByteOffset()      const { return Sparse.IndicesByteOffset; }
+    auto GetSparseIndicesComponentType()   const { return TinyGltfComponentTypeToValueType(Sparse.IndicesComponentType); }
+    auto GetSparseValuesBufferViewId()     const { return Sparse.ValuesBufferView; }
+    auto GetSparseValuesByteOffset()       const { return Sparse.ValuesByteOffset; }
+    // clang-format on
+
+    // Same as tinygltf::Accessor::ByteStride()
+    int GetByteStride(const TinyGltfBufferViewWrapper& View) const
+    {
+        const auto ComponentSize = tinygltf::GetComponentSizeInBytes(static_cast<uint32_t>(ComponentType));
+        if (ComponentSize <= 0)
+            return -1;
+
+        if (View.View.byteStride == 0)
+        {
+            const auto NumComponents = tinygltf::GetNumComponentsInType(static_cast<uint32_t>(Type));
+            return NumComponents > 0 ? ComponentSize * NumComponents : -1;
+        }
+
+        return (View.View.byteStride % ComponentSize) == 0 ? static_cast<int>(View.View.byteStride) : -1;
+    }
+};
+
+struct JsonGltfPerspectiveCameraWrapper
+{
+    const JsonValue Camera;
+
+    // clang-format off
+    auto GetAspectRatio() const { return Camera.Find("aspectRatio").GetNumber(); }
+    auto GetYFov()        const { return Camera.Find("yfov").GetNumber(); }
+    auto GetZNear()       const { return Camera.Find("znear").GetNumber(); }
+    auto GetZFar()        const { return Camera.Find("zfar").GetNumber(); }
+    // clang-format on
+};
+
+struct JsonGltfOrthoCameraWrapper
+{
+    const JsonValue Camera;
+
+    // clang-format off
+    auto GetXMag()  const { return Camera.Find("xmag").GetNumber(); }
+    auto GetYMag()  const { return Camera.Find("ymag").GetNumber(); }
+    auto GetZNear() const { return Camera.Find("znear").GetNumber(); }
+    auto GetZFar()  const { return Camera.Find("zfar").GetNumber(); }
+    // clang-format on
+};
+
+struct JsonGltfCameraWrapper
+{
+    const JsonValue Camera;
+
+    auto GetName() const { return Camera.Find("name").GetString(); }
+    auto GetType() const { return Camera.Find("type").GetString(); }
+    auto GetPerspective() const { return JsonGltfPerspectiveCameraWrapper{Camera.Find("perspective")}; }
+    auto GetOrthographic() const { return JsonGltfOrthoCameraWrapper{Camera.Find("orthographic")}; }
+};
+
+struct JsonGltfSkinWrapper
+{
+    const JsonValue Skin;
+
+    auto GetName() const { return Skin.Find("name").GetString(); }
+    auto GetSkeletonId() const { return Skin.Find("skeleton").GetInt(-1); }
+    auto GetInverseBindMatricesId() const { return Skin.Find("inverseBindMatrices").GetInt(-1); }
+    auto GetJointIds() const { return Skin.Find("joints").GetNumberArray<int>(); }
+};
+
+struct JsonGltfAnimationSamplerWrapper
+{
+    const JsonValue Sam;
+
+    AnimationSampler::INTERPOLATION_TYPE GetInterpolation() const
+    {
+        const auto Interpolation = Sam.Find("interpolation");
+        if (!Interpolation || Interpolation.StringEquals("LINEAR"))
+            return AnimationSampler::INTERPOLATION_TYPE::LINEAR;
+        else if (Interpolation.StringEquals("STEP"))
+            return AnimationSampler::INTERPOLATION_TYPE::STEP;
+        else if (Interpolation.StringEquals("CUBICSPLINE"))
+            return AnimationSampler::INTERPOLATION_TYPE::CUBICSPLINE;
+        else
+        {
+            UNEXPECTED("Unexpected animation interpolation type: ", Interpolation.GetString());
+            return AnimationSampler::INTERPOLATION_TYPE::LINEAR;
+        }
+    }
+
+    auto GetInputId() const { return Sam.Find("input").GetInt(-1); }
+    auto GetOutputId() const { return Sam.Find("output").GetInt(-1); }
+};
+
+struct JsonGltfAnimationChannelWrapper
+{
+    const JsonValue Channel;
+
+    AnimationChannel::PATH_TYPE GetPathType() const
+    {
+        const auto Path = Channel.Find("target").Find("path");
+        if (Path.StringEquals("rotation"))
+            return AnimationChannel::PATH_TYPE::ROTATION;
+        else if (Path.StringEquals("translation"))
+            return AnimationChannel::PATH_TYPE::TRANSLATION;
+        else if (Path.StringEquals("scale"))
+            return AnimationChannel::PATH_TYPE::SCALE;
+        else if (Path.StringEquals("weights"))
+            return AnimationChannel::PATH_TYPE::WEIGHTS;
+        else
+        {
+            UNEXPECTED("Unsupported animation channel path ", Path.GetString());
+            return AnimationChannel::PATH_TYPE::ROTATION;
+        }
+    }
+
+    auto GetSamplerId() const { return Channel.Find("sampler").GetInt(-1); }
+    auto GetTargetNodeId() const { return Channel.Find("target").Find("node").GetInt(-1); }
+};
+
+struct JsonGltfAnimationWrapper
+{
+    const JsonValue              Anim;
+    const std::vector<JsonValue> Samplers;
+    const std::vector<JsonValue> Channels;
+
+    explicit JsonGltfAnimationWrapper(const JsonValue& _Anim) :
+        Anim{_Anim},
+        Samplers{GetJsonArrayElements(_Anim.Find("samplers"))},
+        Channels{GetJsonArrayElements(_Anim.Find("channels"))}
+    {}
+
+    auto GetName() const { return Anim.Find("name").GetString(); }
+
+    auto GetSamplerCount() const { return Samplers.size(); }
+    auto GetChannelCount() const { return Channels.size(); }
+    auto GetSampler(size_t Id) const { return JsonGltfAnimationSamplerWrapper{Samplers[Id]}; }
+    auto GetChannel(size_t Id) const { return JsonGltfAnimationChannelWrapper{Channels[Id]}; }
+};
+
+struct JsonGltfSceneWrapper
+{
+    const JsonValue        Scene;
+    const std::vector<int> NodeIds;
+
+    explicit JsonGltfSceneWrapper(const JsonValue& _Scene) :
+        Scene{_Scene},
+        NodeIds{_Scene.Find("nodes").GetNumberArray<int>()}
+    {}
+
+    auto GetName() const { return Scene.Find("name").GetString(); }
+    auto GetNodeCount() const { return NodeIds.size(); }
+    auto GetNodeId(size_t Idx) const { return NodeIds[Idx]; }
+};
+
+struct JsonGltfModelWrapper
+{
+    const JsonIndex&       Index;
+    const tinygltf::Model& Model;
+
+    // Root arrays are indexed once so that objects can be accessed in constant time.
+    const std::vector<JsonValue> Nodes;
+    const std::vector<JsonValue> Scenes;
+    const std::vector<JsonValue> Meshes;
+    const std::vector<JsonValue> Accessors;
+    const std::vector<JsonValue> Cameras;
+    const std::vector<JsonValue> Skins;
+    const std::vector<JsonValue> Animations;
+
+    JsonGltfModelWrapper(const JsonIndex& _Index, const tinygltf::Model& _Model) :
+        // clang-format off
+        Index     {_Index},
+        Model     {_Model},
+        Nodes     {GetJsonArrayElements(_Index.GetRoot().Find("nodes"))},
+        Scenes    {GetJsonArrayElements(_Index.GetRoot().Find("scenes"))},
+        Meshes    {GetJsonArrayElements(_Index.GetRoot().Find("meshes"))},
+        Accessors {GetJsonArrayElements(_Index.GetRoot().Find("accessors"))},
+        Cameras   {GetJsonArrayElements(_Index.GetRoot().Find("cameras"))},
+        Skins     {GetJsonArrayElements(_Index.GetRoot().Find("skins"))},
+        Animations{GetJsonArrayElements(_Index.GetRoot().Find("animations"))}
+    // clang-format on
+    {}
+
+    const auto& Get() const { return Index; }
+
+    // clang-format off
+    auto GetNode      (int idx) const { return JsonGltfNodeWrapper      {Nodes    [idx]}; }
+    auto GetScene     (int idx) const { return JsonGltfSceneWrapper     {Scenes   [idx]}; }
+    auto GetMesh      (int idx) const { return JsonGltfMeshWrapper      {Meshes   [idx]}; }
+    auto GetAccessor  (int idx) const { return JsonGltfAccessorWrapper  {Accessors[idx]}; }
+    auto GetCamera    (int idx) const { return JsonGltfCameraWrapper    {Cameras  [idx]}; }
+    auto GetLight     (int idx) const { return TinyGltfLightWrapper     {Model.lights     [idx]}; }
+    auto GetBufferView(int idx) const { return TinyGltfBufferViewWrapper{Model.bufferViews[idx]}; }
+    auto GetBuffer    (int idx) const { return TinyGltfBufferWrapper    {Model.buffers    [idx]}; }
+
+    auto GetSkin      (size_t idx) const { return JsonGltfSkinWrapper      {Skins     [idx]}; }
+    auto GetAnimation (size_t idx) const { return JsonGltfAnimationWrapper {Animations[idx]}; }
+
+    auto GetNodeCount()       const { return Nodes.size();             }
+    auto GetSceneCount()      const { return Scenes.size();            }
+    auto GetMeshCount()       const { return Meshes.size();            }
+    auto GetSkinCount()       const { return Skins.size();             }
+    auto GetAnimationCount()  const { return Animations.size();        }
+    auto GetBufferViewCount() const { return Model.bufferViews.size(); }
+    auto GetBufferCount()     const { return Model.buffers.size();     }
+
+    auto GetDefaultSceneId() const { return Index.GetRoot().Find("scene").GetInt(-1); }
+    // clang-format on
+};
+
 
 struct TextureInitData : public ObjectBase<IObject>
 {
@@ -381,7 +894,7 @@ struct TextureInitData : public ObjectBase<IObject>
 
     RefCntAutoPtr<ITexture> pStagingTex;
 
-    void GenerateMipLevels(Uint32 StartMipLevel)
+    void GenerateMipLevels(Uint32 StartMipLevel, bool IsNormalMap = false)
     {
         VERIFY_EXPR(StartMipLevel > 0);
         VERIFY_EXPR(Format != TEX_FORMAT_UNKNOWN);
@@ -409,7 +922,20 @@ struct TextureInitData : public ObjectBase<IObject>
             Level.Data.resize(static_cast<size_t>(MipSize));
             Level.SubResData.pData = Level.Data.data();
 
-            if (FmtAttribs.ComponentType != COMPONENT_TYPE_COMPRESSED)
+            if (IsNormalMap)
+            {
+                VERIFY_EXPR(FmtAttribs.ComponentSize == 1 && FmtAttribs.NumComponents >= 2);
+                NormalMapMipLevelAttribs NormalMipAttribs;
+                NormalMipAttribs.FineMipWidth    = FineLevel.Width;
+                NormalMipAttribs.FineMipHeight   = FineLevel.Height;
+                NormalMipAttribs.pFineMipData    = FineLevel.Data.data();
+                NormalMipAttribs.FineMipStride   = static_cast<Uint32>(FineLevel.SubResData.Stride);
+                NormalMipAttribs.pCoarseMipData  = Level.Data.data();
+                NormalMipAttribs.CoarseMipStride = static_cast<Uint32>(Level.SubResData.Stride);
+                NormalMipAttribs.ComponentCount  = FmtAttribs.NumComponents;
+                ComputeNormalMapMipLevel(NormalMipAttribs);
+            }
+            else if (FmtAttribs.ComponentType != COMPONENT_TYPE_COMPRESSED)
             {
                 ComputeMipLevel({Format, FineLevel.Width, FineLevel.Height,
                                  FineLevel.Data.data(), StaticCast<size_t>(FineLevel.SubResData.Stride),
@@ -444,11 +970,29 @@ TEXTURE_FORMAT GetModelImageDataTextureFormat(const Model::ImageData& Image)
     }
 }
 
+struct GLTFTextureMipAttribs
+{
+    // Alpha cutoff of the alpha-cut materials that use the texture, or 0.
+    float AlphaCutoff = 0;
+
+    // Whether the texture is a normal map whose mip levels are renormalized.
+    bool IsNormalMap = false;
+
+    // Normal map whose variance is added to the roughness stored in the texture.
+    const Model::ImageData* pRoughnessNormalMap = nullptr;
+
+    // Box-filtered mips that are generated on the GPU are only suitable for regular textures.
+    bool RequireCPUMips() const
+    {
+        return AlphaCutoff > 0 || IsNormalMap || pRoughnessNormalMap != nullptr;
+    }
+};
+
 RefCntAutoPtr<TextureInitData> PrepareGLTFTextureInitData(
-    const Model::ImageData& _Image,
-    float                   AlphaCutoff,
-    Uint32                  NumMipLevels,
-    int                     SizeAlignment = -1)
+    const Model::ImageData&      _Image,
+    const GLTFTextureMipAttribs& MipAttribs,
+    Uint32                       NumMipLevels,
+    int                          SizeAlignment = -1)
 {
     if (_Image.pData == nullptr)
     {
@@ -514,90 +1058,391 @@ RefCntAutoPtr<TextureInitData> PrepareGLTFTextureInitData(
     Level0.Data.resize(static_cast<size_t>(Level0Stride * Image.Height));
     Level0.SubResData.pData = Level0.Data.data();
 
-    const auto* pSrcData  = static_cast<const Uint8*>(Image.pData);
-    const auto  SrcStride = Image.Width * Image.ComponentSize * Image.NumComponents;
-    if (Image.ComponentSize == 1 && Image.NumComponents == 4 && FmtAttribs.NumComponents == 4 && AlphaCutoff > 0)
+    CopyPixelsAttribs CopyAttribs;
+    CopyAttribs.Width            = Image.Width;
+    CopyAttribs.Height           = Image.Height;
+    CopyAttribs.SrcComponentSize = Image.ComponentSize;
+    CopyAttribs.pSrcPixels       = Image.pData;
+    CopyAttribs.SrcStride        = Image.Width * Image.ComponentSize * Image.NumComponents;
+    CopyAttribs.SrcCompCount     = Image.NumComponents;
+    CopyAttribs.pDstPixels       = Level0.Data.data();
+    CopyAttribs.DstComponentSize = FmtAttribs.ComponentSize;
+    CopyAttribs.DstStride        = static_cast<Uint32>(Level0Stride);
+    CopyAttribs.DstCompCount     = FmtAttribs.NumComponents;
+    CopyPixels(CopyAttribs);
+
+    const bool Is8BitFormat = FmtAttribs.ComponentSize == 1 && FmtAttribs.ComponentType != COMPONENT_TYPE_COMPRESSED;
+    UpdateInfo->GenerateMipLevels(1, MipAttribs.IsNormalMap && Is8BitFormat && FmtAttribs.NumComponents >= 2);
+
+    const float AlphaCutoff = MipAttribs.AlphaCutoff;
+    if (FmtAttribs.ComponentSize == 1 && FmtAttribs.NumComponents == 4 && Image.NumComponents == 4 && AlphaCutoff > 0 && Levels.size() > 1)
     {
-        // Remap alpha channel using the following formula to improve mip maps:
+        // Box-filtered mips gradually lose alpha-tested coverage, which makes alpha-tested
+        // geometry fade out at a distance. Scale alpha in every coarser mip level so that
+        // the fraction of pixels that pass the alpha test matches that of the top level.
         //
-        //      A_new = max(A_old; 1/3 * A_old + 2/3 * CutoffThreshold)
-        //
-        // https://asawicki.info/articles/alpha_test.php5
-
+        // http://www.ludicon.com/castano/blog/articles/computing-alpha-mipmaps/
         VERIFY_EXPR(AlphaCutoff > 0 && AlphaCutoff <= 1);
-        AlphaCutoff *= 255.f;
 
-        // Due to depressing performance of iterators in debug MSVC we have to use raw pointers here
-        for (size_t row = 0; row < static_cast<size_t>(Image.Height); ++row)
-        {
-            const auto* src = pSrcData + row * static_cast<size_t>(SrcStride);
-            auto*       dst = &Level0.Data[static_cast<size_t>(row * Level0Stride)];
-            for (int i = 0; i < Image.Width; ++i)
-            {
-                dst[0] = src[0];
-                dst[1] = src[1];
-                dst[2] = src[2];
-                dst[3] = std::max(src[3], static_cast<Uint8>(std::min(1.f / 3.f * src[3] + 2.f / 3.f * AlphaCutoff, 255.f)));
+        AlphaCoverageAttribs CoverageAttribs;
+        CoverageAttribs.ComponentCount = FmtAttribs.NumComponents;
+        CoverageAttribs.ComponentType  = VT_UINT8;
+        CoverageAttribs.AlphaCutoff    = AlphaCutoff;
+
+        const auto GetLevelCoverageAttribs = [&CoverageAttribs](TextureInitData::LevelData& Level) {
+            CoverageAttribs.Width   = Level.Width;
+            CoverageAttribs.Height  = Level.Height;
+            CoverageAttribs.pPixels = Level.Data.data();
+            CoverageAttribs.Stride  = static_cast<Uint32>(Level.SubResData.Stride);
+            return CoverageAttribs;
+        };
 
-                src += 4;
-                dst += 4;
-            }
+        const auto TargetCoverage = ComputeAlphaCoverage(GetLevelCoverageAttribs(Level0));
+        for (size_t mip = 1; mip < Levels.size(); ++mip)
+        {
+            ScaleAlphaToCoverage(GetLevelCoverageAttribs(Levels[mip]), TargetCoverage);
         }
     }
-    else
+
+    const auto* pNormalMap = MipAttribs.pRoughnessNormalMap;
+    if (pNormalMap != nullptr && Is8BitFormat && FmtAttribs.NumComponents >= 2)
     {
-        CopyPixelsAttribs CopyAttribs;
-        CopyAttribs.Width            = Image.Width;
-        CopyAttribs.Height           = Image.Height;
-        CopyAttribs.SrcComponentSize = Image.ComponentSize;
-        CopyAttribs.pSrcPixels       = Image.pData;
-        CopyAttribs.SrcStride        = SrcStride;
-        CopyAttribs.SrcCompCount     = Image.NumComponents;
-        CopyAttribs.pDstPixels       = Level0.Data.data();
-        CopyAttribs.DstComponentSize = FmtAttribs.ComponentSize;
-        CopyAttribs.DstStride        = static_cast<Uint32>(Level0Stride);
-        CopyAttribs.DstCompCount     = FmtAttribs.NumComponents;
-        CopyPixels(CopyAttribs);
+        // Box-filtered normals get shorter in coarse mip levels, so bumpy surfaces become shiny
+        // and alias at a distance. Fold the variance of the normals covered by each texel
+        // into the roughness stored in the green channel of the metallic-roughness texture.
+        VERIFY_EXPR(pNormalMap->pData != nullptr && pNormalMap->ComponentSize == 1 && pNormalMap->NumComponents >= 2);
+
+        NormalVarianceToRoughnessAttribs VarianceAttribs;
+        VarianceAttribs.NormalMapWidth          = static_cast<Uint32>(pNormalMap->Width);
+        VarianceAttribs.NormalMapHeight         = static_cast<Uint32>(pNormalMap->Height);
+        VarianceAttribs.pNormalMapPixels        = pNormalMap->pData;
+        VarianceAttribs.NormalMapStride         = static_cast<Uint32>(pNormalMap->Width * pNormalMap->NumComponents);
+        VarianceAttribs.NormalMapComponentCount = static_cast<Uint32>(pNormalMap->NumComponents);
+        VarianceAttribs.ComponentCount          = FmtAttribs.NumComponents;
+        VarianceAttribs.RoughnessComponent      = 1;
+        for (auto& Level : Levels)
+        {
+            VarianceAttribs.Width   = Level.Width;
+            VarianceAttribs.Height  = Level.Height;
+            VarianceAttribs.pPixels = Level.Data.data();
+            VarianceAttribs.Stride  = static_cast<Uint32>(Level.SubResData.Stride);
+            AddNormalVarianceToRoughness(VarianceAttribs);
+        }
     }
 
-    UpdateInfo->GenerateMipLevels(1);
-
     return UpdateInfo;
 }
 
-} // namespace
-
-Model::Model(const ModelCreateInfo& CI)
-{
-    DEV_CHECK_ERR(CI.IndexType == VT_UINT16 || CI.IndexType == VT_UINT32, "Invalid index type");
-    DEV_CHECK_ERR(CI.NumVertexAttributes == 0 || CI.VertexAttributes != nullptr, "VertexAttributes must not be null when NumVertexAttributes > 0");
-    DEV_CHECK_ERR(CI.NumTextureAttributes == 0 || CI.TextureAttributes != nullptr, "TextureAttributes must not be null when NumTextureAttributes > 0");
-    DEV_CHECK_ERR(CI.NumTextureAttributes <= Material::MaxTextureAttribs, "Too many texture attributes (", CI.NumTextureAttributes, "). Maximum supported: ", Uint32{Material::MaxTextureAttribs});
-
-    const auto* pSrcVertAttribs = CI.VertexAttributes != nullptr ? CI.VertexAttributes : DefaultVertexAttributes.data();
-    const auto* pSrcTexAttribs  = CI.TextureAttributes != nullptr ? CI.TextureAttributes : DefaultTextureAttributes.data();
-    NumVertexAttributes         = CI.VertexAttributes != nullptr ? CI.NumVertexAttributes : static_cast<Uint32>(DefaultVertexAttributes.size());
-    NumTextureAttributes        = CI.TextureAttributes != nullptr ? CI.NumTextureAttributes : static_cast<Uint32>(DefaultTextureAttributes.size());
+// https://github.com/KhronosGroup/glTF/tree/main/extensions/2.0/Vendor/EXT_meshopt_compression
+constexpr char MeshoptCompressionExtension[] = "EXT_meshopt_compression";
 
-    auto&                RawAllocator = DefaultRawMemoryAllocator::GetAllocator();
-    FixedLinearAllocator Allocator{RawAllocator};
-    Allocator.AddSpace<VertexAttributeDesc>(NumVertexAttributes);
-    Allocator.AddSpace<TextureAttributeDesc>(NumTextureAttributes);
+// No meshopt stream decodes to more than 64 bytes per input byte: in the ATTRIBUTES mode,
+// a single header byte covers four groups of 16 bytes, the TRIANGLES mode uses at least one
+// byte per triangle, and the INDICES mode at least one byte per index.
+constexpr size_t MaxMeshoptCompressionRatio = 64;
 
-    Uint32 MaxBufferId = 0;
-    for (size_t i = 0; i < NumVertexAttributes; ++i)
+// Reads a non-negative integer property of the meshopt compression extension.
+size_t GetMeshoptExtensionSize(const tinygltf::Value& Ext, const char* Name, int ViewId)
+{
+    const auto& Value = Ext.Get(Name);
+    if (Value.IsInt())
     {
-        const auto& Attrib = pSrcVertAttribs[i];
+        const auto IntValue = Value.Get<int>();
+        if (IntValue < 0)
+            LOG_ERROR_AND_THROW("Meshopt compression property '", Name, "' of buffer view ", ViewId, " is negative");
+        return static_cast<size_t>(IntValue);
+    }
 
-        DEV_CHECK_ERR(Attrib.Name != nullptr, "Vertex attribute name must not be null");
-        DEV_CHECK_ERR(Attrib.ValueType != VT_UNDEFINED, "Undefined vertex attribute value type");
-        DEV_CHECK_ERR(Attrib.NumComponents != 0, "The number of components must not be null");
+    if (!Value.IsReal())
+        LOG_ERROR_AND_THROW("Meshopt compression property '", Name, "' of buffer view ", ViewId, " is missing or is not a number");
 
-        MaxBufferId = std::max<Uint32>(MaxBufferId, Attrib.BufferId);
+    // Doubles represent all integers up to 2^53 exactly
+    const auto   MaxSize = std::min(Uint64{1} << 53, static_cast<Uint64>(std::numeric_limits<size_t>::max()));
+    const double Number  = Value.Get<double>();
+    // Note that all comparisons with NaN are false
+    if (!(Number >= 0 && Number <= static_cast<double>(MaxSize)) || Number != std::floor(Number))
+        LOG_ERROR_AND_THROW("Meshopt compression property '", Name, "' of buffer view ", ViewId, " is not a valid non-negative integer");
 
-        Allocator.AddSpaceForString(pSrcVertAttribs[i].Name);
-    }
-    VertexData.Strides.resize(size_t{MaxBufferId} + 1);
+    return static_cast<size_t>(Number);
+}
+
+MeshoptBufferViewDesc ParseMeshoptCompressionExtension(const tinygltf::Value& Ext, int ViewId)
+{
+    MeshoptBufferViewDesc Desc;
+
+    Desc.Count      = GetMeshoptExtensionSize(Ext, "count", ViewId);
+    Desc.ByteStride = GetMeshoptExtensionSize(Ext, "byteStride", ViewId);
+
+    const auto& Mode = Ext.Get("mode").Get<std::string>();
+    if (Mode == "ATTRIBUTES")
+        Desc.Mode = MESHOPT_COMPRESSION_MODE_ATTRIBUTES;
+    else if (Mode == "TRIANGLES")
+        Desc.Mode = MESHOPT_COMPRESSION_MODE_TRIANGLES;
+    else if (Mode == "INDICES")
+        Desc.Mode = MESHOPT_COMPRESSION_MODE_INDICES;
+    else
+        LOG_ERROR_AND_THROW("Unknown meshopt compression mode '", Mode, "' in buffer view ", ViewId);
+
+    if (Desc.Mode == MESHOPT_COMPRESSION_MODE_ATTRIBUTES)
+    {
+        if (Desc.ByteStride == 0 || Desc.ByteStride > 256 || Desc.ByteStride % 4 != 0)
+            LOG_ERROR_AND_THROW("Byte stride ", Desc.ByteStride, " of meshopt-compressed buffer view ", ViewId, " is not a multiple of 4 in range [4, 256]");
+    }
+    else
+    {
+        if (Desc.ByteStride != 2 && Desc.ByteStride != 4)
+            LOG_ERROR_AND_THROW("Index size ", Desc.ByteStride, " of meshopt-compressed buffer view ", ViewId, " must be 2 or 4");
+    }
+
+    if (Desc.Count > std::numeric_limits<size_t>::max() / Desc.ByteStride)
+        LOG_ERROR_AND_THROW("Decoded size of meshopt-compressed buffer view ", ViewId, " is too large");
+
+    if (Ext.Has("filter"))
+    {
+        const auto& Filter = Ext.Get("filter").Get<std::string>();
+        if (Filter == "NONE")
+            Desc.Filter = MESHOPT_COMPRESSION_FILTER_NONE;
+        else if (Filter == "OCTAHEDRAL")
+            Desc.Filter = MESHOPT_COMPRESSION_FILTER_OCTAHEDRAL;
+        else if (Filter == "QUATERNION")
+            Desc.Filter = MESHOPT_COMPRESSION_FILTER_QUATERNION;
+        else if (Filter == "EXPONENTIAL")
+            Desc.Filter = MESHOPT_COMPRESSION_FILTER_EXPONENTIAL;
+        else
+            LOG_ERROR_AND_THROW("Unknown meshopt compression filter '", Filter, "' in buffer view ", ViewId);
+    }
+
+    return Desc;
+}
+
+// Decodes all buffer views compressed with EXT_meshopt_compression into a new buffer
+// and redirects the views to the decoded data. After this, the rest of the loader
+// can access the data exactly the same way as the uncompressed views.
+void DecodeMeshoptCompressedBufferViews(tinygltf::Model& gltf_model, IThreadPool* pThreadPool)
+{
+    struct CompressedViewInfo
+    {
+        const int             ViewId;
+        MeshoptBufferViewDesc Desc;
+        const Uint8*          pSrcData  = nullptr;
+        size_t                SrcSize   = 0;
+        size_t                DstOffset = 0;
+    };
+    std::vector<CompressedViewInfo> CompressedViews;
+
+    // Fallback buffers are replaced with placeholders when the file is loaded (see AppendGltfBuffersJson)
+    // and must only be referenced by the compressed views.
+    std::vector<bool> IsFallbackBuffer(gltf_model.buffers.size());
+    for (size_t BufferId = 0; BufferId < gltf_model.buffers.size(); ++BufferId)
+    {
+        auto& Buffer = gltf_model.buffers[BufferId];
+        auto  ext_it = Buffer.extensions.find(MeshoptCompressionExtension);
+        if (ext_it == Buffer.extensions.end())
+            continue;
+
+        const auto& Fallback = ext_it->second.Get("fallback");
+        if (Fallback.IsBool() && Fallback.Get<bool>())
+        {
+            IsFallbackBuffer[BufferId] = true;
+            std::vector<unsigned char>{}.swap(Buffer.data);
+        }
+    }
+    for (size_t ViewId = 0; ViewId < gltf_model.bufferViews.size(); ++ViewId)
+    {
+        const auto& View = gltf_model.bufferViews[ViewId];
+        if (View.buffer >= 0 && static_cast<size_t>(View.buffer) < IsFallbackBuffer.size() && IsFallbackBuffer[View.buffer] &&
+            View.extensions.find(MeshoptCompressionExtension) == View.extensions.end())
+        {
+            LOG_ERROR_AND_THROW("Buffer view ", ViewId, " is not compressed, but references meshopt fallback buffer ", View.buffer);
+        }
+    }
+
+    size_t DecodedSize = 0;
+    for (size_t ViewId = 0; ViewId < gltf_model.bufferViews.size(); ++ViewId)
+    {
+        const auto& View   = gltf_model.bufferViews[ViewId];
+        auto        ext_it = View.extensions.find(MeshoptCompressionExtension);
+        if (ext_it == View.extensions.end())
+            continue;
+
+        const auto& Ext = ext_it->second;
+
+        CompressedViewInfo ViewInfo{static_cast<int>(ViewId), ParseMeshoptCompressionExtension(Ext, static_cast<int>(ViewId))};
+
+        const auto BufferId   = GetMeshoptExtensionSize(Ext, "buffer", static_cast<int>(ViewId));
+        const auto ByteOffset = Ext.Has("byteOffset") ? GetMeshoptExtensionSize(Ext, "byteOffset", static_cast<int>(ViewId)) : size_t{0};
+        const auto ByteLength = GetMeshoptExtensionSize(Ext, "byteLength", static_cast<int>(ViewId));
+        if (BufferId >= gltf_model.buffers.size() || IsFallbackBuffer[BufferId])
+            LOG_ERROR_AND_THROW("Buffer view ", ViewId, " references invalid compressed buffer ", BufferId);
+
+        const auto& SrcBuffer = gltf_model.buffers[BufferId].data;
+        if (ByteOffset > SrcBuffer.size() || ByteLength > SrcBuffer.size() - ByteOffset)
+            LOG_ERROR_AND_THROW("Compressed data of buffer view ", ViewId, " is out of bounds of buffer ", BufferId);
+
+        // Bound the decoded size by the data that is actually present before anything is allocated
+        const auto ViewSize = GetMeshoptDecodedSize(ViewInfo.Desc);
+        if (ViewSize != View.byteLength)
+            LOG_ERROR_AND_THROW("Decoded size ", ViewSize, " of meshopt-compressed buffer view ", ViewId, " does not match its byte length ", View.byteLength);
+        if (ViewSize / MaxMeshoptCompressionRatio > ByteLength)
+            LOG_ERROR_AND_THROW("Compressed data of buffer view ", ViewId, " is too small to hold ", ViewSize, " decoded bytes");
+        if (ViewSize > std::numeric_limits<size_t>::max() - 3 - DecodedSize)
+            LOG_ERROR_AND_THROW("Total size of meshopt-decoded buffer views is too large");
+
+        ViewInfo.pSrcData  = SrcBuffer.data() + ByteOffset;
+        ViewInfo.SrcSize   = ByteLength;
+        ViewInfo.DstOffset = DecodedSize;
+        DecodedSize        = AlignUp(DecodedSize + ViewSize, size_t{4});
+
+        CompressedViews.emplace_back(std::move(ViewInfo));
+    }
+
+    if (CompressedViews.empty())
+        return;
+
+    tinygltf::Buffer DecodedBuffer;
+    DecodedBuffer.name = "Meshopt decoded data";
+    DecodedBuffer.data.resize(DecodedSize);
+
+    std::atomic<bool> Result{true};
+
+    auto DecodeView = [&](const CompressedViewInfo& ViewInfo) {
+        if (!DecodeMeshoptBufferView(ViewInfo.Desc, ViewInfo.pSrcData, ViewInfo.SrcSize, &DecodedBuffer.data[ViewInfo.DstOffset]))
+        {
+            LOG_ERROR_MESSAGE("Failed to decode meshopt-compressed buffer view ", ViewInfo.ViewId);
+            Result.store(false);
+        }
+    };
+
+    ParallelFor(pThreadPool, static_cast<Uint32>(CompressedViews.size()), [&](Uint32 i) {
+        DecodeView(CompressedViews[i]);
+    });
+
+    if (!Result.load())
+        LOG_ERROR_AND_THROW("Failed to decode meshopt-compressed buffer views");
+
+    const auto DecodedBufferId = static_cast<int>(gltf_model.buffers.size());
+    gltf_model.buffers.emplace_back(std::move(DecodedBuffer));
+
+    for (const auto& ViewInfo : CompressedViews)
+    {
+        auto& View = gltf_model.bufferViews[ViewInfo.ViewId];
+
+        View.buffer     = DecodedBufferId;
+        View.byteOffset = ViewInfo.DstOffset;
+        View.byteLength = GetMeshoptDecodedSize(ViewInfo.Desc);
+        if (ViewInfo.Desc.Mode == MESHOPT_COMPRESSION_MODE_ATTRIBUTES)
+            View.byteStride = static_cast<int>(ViewInfo.Desc.ByteStride);
+        View.extensions.erase(MeshoptCompressionExtension);
+    }
+}
+
+// Returns the size of the source data held by the parsed GLTF model.
+Uint64 GetSourceDataSize(const tinygltf::Model& gltf_model)
+{
+    Uint64 Size = 0;
+    for (const auto& Buffer : gltf_model.buffers)
+        Size += Buffer.data.size();
+    for (const auto& Image : gltf_model.images)
+        Size += Image.image.size();
+    return Size;
+}
+
+// Estimates the GPU memory required by the textures that are not found in the cache.
+Uint64 EstimateTextureMemorySize(const tinygltf::Model& gltf_model)
+{
+    Uint64 Size = 0;
+    for (const auto& Image : gltf_model.images)
+    {
+        // Cached images have no data
+        if (Image.image.empty())
+            continue;
+
+        if (Image.width > 0 && Image.height > 0 && Image.component > 0 && Image.bits > 0)
+        {
+            // Decoded image: assume the full mip chain
+            const auto PixelSize = static_cast<Uint64>(Image.component) * static_cast<Uint64>(Image.bits / 8);
+            for (Uint32 w = static_cast<Uint32>(Image.width), h = static_cast<Uint32>(Image.height);; w = std::max(w / 2u, 1u), h = std::max(h / 2u, 1u))
+            {
+                Size += Uint64{w} * Uint64{h} * PixelSize;
+                if (w == 1 && h == 1)
+                    break;
+            }
+        }
+        else
+        {
+            // DDS or KTX file that is stored as is
+            Size += Image.image.size();
+        }
+    }
+    return Size;
+}
+
+template <typename T>
+Uint64 GetVectorMemorySize(const std::vector<T>& Vec)
+{
+    return static_cast<Uint64>(Vec.capacity()) * sizeof(T);
+}
+
+Uint64 GetBufferInitDataSize(IObject* pUserData)
+{
+    RefCntAutoPtr<BufferInitData> pInitData{pUserData, IID_BufferInitData};
+    if (!pInitData)
+        return 0;
+
+    Uint64 Size = 0;
+    for (const auto& Data : pInitData->Data)
+        Size += Data.size();
+    return Size;
+}
+
+Uint64 GetTextureInitDataSize(IObject* pUserData)
+{
+    // Texture user data is only set by the loader
+    auto* pInitData = ClassPtrCast<TextureInitData>(pUserData);
+    if (pInitData == nullptr)
+        return 0;
+
+    Uint64 Size = 0;
+    for (const auto& Level : pInitData->Levels)
+        Size += Level.Data.size();
+    if (pInitData->pStagingTex)
+        Size += GetTextureMemorySize(pInitData->pStagingTex->GetDesc());
+    return Size;
+}
+
+} // namespace
+
+Model::Model(const ModelCreateInfo& CI)
+{
+    DEV_CHECK_ERR(CI.AdaptiveIndexType || CI.IndexType == VT_UINT16 || CI.IndexType == VT_UINT32, "Invalid index type");
+    DEV_CHECK_ERR(CI.NumVertexAttributes == 0 || CI.VertexAttributes != nullptr, "VertexAttributes must not be null when NumVertexAttributes > 0");
+    DEV_CHECK_ERR(CI.NumTextureAttributes == 0 || CI.TextureAttributes != nullptr, "TextureAttributes must not be null when NumTextureAttributes > 0");
+    DEV_CHECK_ERR(CI.NumTextureAttributes <= Material::MaxTextureAttribs, "Too many texture attributes (", CI.NumTextureAttributes, "). Maximum supported: ", Uint32{Material::MaxTextureAttribs});
+
+    const auto* pSrcVertAttribs = CI.VertexAttributes != nullptr ? CI.VertexAttributes : DefaultVertexAttributes.data();
+    const auto* pSrcTexAttribs  = CI.TextureAttributes != nullptr ? CI.TextureAttributes : DefaultTextureAttributes.data();
+    NumVertexAttributes         = CI.VertexAttributes != nullptr ? CI.NumVertexAttributes : static_cast<Uint32>(DefaultVertexAttributes.size());
+    NumTextureAttributes        = CI.TextureAttributes != nullptr ? CI.NumTextureAttributes : static_cast<Uint32>(DefaultTextureAttributes.size());
+
+    auto&                RawAllocator = DefaultRawMemoryAllocator::GetAllocator();
+    FixedLinearAllocator Allocator{RawAllocator};
+    Allocator.AddSpace<VertexAttributeDesc>(NumVertexAttributes);
+    Allocator.AddSpace<TextureAttributeDesc>(NumTextureAttributes);
+
+    Uint32 MaxBufferId = 0;
+    for (size_t i = 0; i < NumVertexAttributes; ++i)
+    {
+        const auto& Attrib = pSrcVertAttribs[i];
+
+        DEV_CHECK_ERR(Attrib.Name != nullptr, "Vertex attribute name must not be null");
+        DEV_CHECK_ERR(Attrib.ValueType != VT_UNDEFINED, "Undefined vertex attribute value type");
+        DEV_CHECK_ERR(Attrib.NumComponents != 0, "The number of components must not be null");
+
+        MaxBufferId = std::max<Uint32>(MaxBufferId, Attrib.BufferId);
+
+        Allocator.AddSpaceForString(pSrcVertAttribs[i].Name);
+    }
+    VertexData.Strides.resize(size_t{MaxBufferId} + 1);
 
     for (size_t i = 0; i < NumTextureAttributes; ++i)
     {
@@ -634,7 +1479,15 @@ Model::Model(const ModelCreateInfo& CI)
     }
 
 
-    IndexData.IndexSize = CI.IndexType == VT_UINT32 ? 4 : 2;
+    if (CI.AdaptiveIndexType)
+    {
+        IndexData.IndexSize   = 4;
+        IndexData16.IndexSize = 2;
+    }
+    else
+    {
+        IndexData.IndexSize = CI.IndexType == VT_UINT32 ? 4 : 2;
+    }
 
     pAttributesData   = decltype(pAttributesData){Allocator.ReleaseOwnership(), RawAllocator};
     VertexAttributes  = pDstVertAttribs;
@@ -669,55 +1522,113 @@ int Model::GetTextureAttributeIndex(const char* Name) const
     return -1;
 }
 
-float Model::GetTextureAlphaCutoffValue(int TextureIndex) const
+void Model::InitTextureAlphaCutoffValues(size_t NumTextures)
 {
+    // Negative value indicates that the texture is not used by any non-opaque material yet.
+    TextureAlphaCutoffs.assign(NumTextures, -1.f);
+
     const auto BaseTexAttribIdx = GetTextureAttributeIndex(BaseColorTextureName);
-    if (BaseTexAttribIdx < 0)
-        return 0;
+    if (BaseTexAttribIdx >= 0)
+    {
+        // Textures that are used in both alpha-cut and alpha-blend materials
+        std::vector<bool> MixedAlphaModes(NumTextures, false);
+
+        for (const auto& Mat : Materials)
+        {
+            const auto TextureIndex = Mat.GetTextureId(BaseTexAttribIdx);
+            if (TextureIndex < 0 || static_cast<size_t>(TextureIndex) >= NumTextures || MixedAlphaModes[TextureIndex])
+                continue;
+
+            if (Mat.Attribs.AlphaMode == Material::ALPHA_MODE_OPAQUE)
+            {
+                // The material is opaque, so alpha remapping mode does not matter.
+                continue;
+            }
+
+            VERIFY_EXPR(Mat.Attribs.AlphaMode == Material::ALPHA_MODE_BLEND || Mat.Attribs.AlphaMode == Material::ALPHA_MODE_MASK);
+            const float NewAlphaCutoff = Mat.Attribs.AlphaMode == Material::ALPHA_MODE_MASK ? Mat.Attribs.AlphaCutoff : 0;
+
+            auto& AlphaCutoff = TextureAlphaCutoffs[TextureIndex];
+            if (AlphaCutoff < 0)
+            {
+                AlphaCutoff = NewAlphaCutoff;
+            }
+            else if (AlphaCutoff != NewAlphaCutoff)
+            {
+                if (AlphaCutoff == 0 || NewAlphaCutoff == 0)
+                {
+                    LOG_WARNING_MESSAGE("Texture ", TextureIndex,
+                                        " is used in an alpha-cut material with threshold ", std::max(AlphaCutoff, NewAlphaCutoff),
+                                        " as well as in an alpha-blend material."
+                                        " Alpha coverage preservation in mipmaps will be disabled.");
+                    AlphaCutoff                   = 0;
+                    MixedAlphaModes[TextureIndex] = true;
+                }
+                else
+                {
+                    LOG_WARNING_MESSAGE("Texture ", TextureIndex,
+                                        " is used in alpha-cut materials with different cutoff thresholds (", AlphaCutoff, " and ", NewAlphaCutoff,
+                                        "). Alpha coverage preservation in mipmaps will use ",
+                                        std::min(AlphaCutoff, NewAlphaCutoff), '.');
+                    AlphaCutoff = std::min(AlphaCutoff, NewAlphaCutoff);
+                }
+            }
+        }
+    }
+
+    for (auto& AlphaCutoff : TextureAlphaCutoffs)
+        AlphaCutoff = std::max(AlphaCutoff, 0.f);
+}
+
+float Model::GetTextureAlphaCutoffValue(int TextureIndex) const
+{
+    // Textures that are not loaded from the GLTF file are not used by any material.
+    return TextureIndex >= 0 && static_cast<size_t>(TextureIndex) < TextureAlphaCutoffs.size() ?
+        TextureAlphaCutoffs[TextureIndex] :
+        0.f;
+}
+
+void Model::InitTextureNormalMapInfo(size_t NumTextures, bool RenormalizeNormalMaps, bool BakeNormalVariance)
+{
+    TextureNormalMaps.assign(NumTextures, TextureNormalMapInfo{});
+
+    const auto NormalTexAttribIdx = GetTextureAttributeIndex(NormalTextureName);
+    const auto MRTexAttribIdx     = GetTextureAttributeIndex(MetallicRoughnessTextureName);
+    if (NormalTexAttribIdx < 0 || (!RenormalizeNormalMaps && !BakeNormalVariance))
+        return;
 
-    float AlphaCutoff = -1.f;
     for (const auto& Mat : Materials)
     {
-        if (Mat.GetTextureId(BaseTexAttribIdx) != TextureIndex)
-        {
-            // The material does not use this texture as base color.
+        const auto NormalTexIdx = Mat.GetTextureId(NormalTexAttribIdx);
+        if (NormalTexIdx < 0 || static_cast<size_t>(NormalTexIdx) >= NumTextures)
             continue;
-        }
 
-        if (Mat.Attribs.AlphaMode == Material::ALPHA_MODE_OPAQUE)
-        {
-            // The material is opaque, so alpha remapping mode does not matter.
+        if (RenormalizeNormalMaps)
+            TextureNormalMaps[NormalTexIdx].IsNormalMap = true;
+
+        const auto MRTexIdx = BakeNormalVariance && MRTexAttribIdx >= 0 ? Mat.GetTextureId(MRTexAttribIdx) : -1;
+        if (MRTexIdx < 0 || static_cast<size_t>(MRTexIdx) >= NumTextures || MRTexIdx == NormalTexIdx)
             continue;
-        }
 
-        VERIFY_EXPR(Mat.Attribs.AlphaMode == Material::ALPHA_MODE_BLEND || Mat.Attribs.AlphaMode == Material::ALPHA_MODE_MASK);
-        const float NewAlphaCutoff = Mat.Attribs.AlphaMode == Material::ALPHA_MODE_MASK ? Mat.Attribs.AlphaCutoff : 0;
-        if (AlphaCutoff < 0)
+        auto& RoughnessNormalMap = TextureNormalMaps[MRTexIdx].RoughnessNormalMap;
+        if (RoughnessNormalMap < 0)
         {
-            AlphaCutoff = NewAlphaCutoff;
+            RoughnessNormalMap = NormalTexIdx;
         }
-        else if (AlphaCutoff != NewAlphaCutoff)
+        else if (RoughnessNormalMap != NormalTexIdx)
         {
-            if (AlphaCutoff == 0 || NewAlphaCutoff == 0)
-            {
-                LOG_WARNING_MESSAGE("Texture ", TextureIndex,
-                                    " is used in an alpha-cut material with threshold ", std::max(AlphaCutoff, NewAlphaCutoff),
-                                    " as well as in an alpha-blend material."
-                                    " Alpha remapping to improve mipmap generation will be disabled.");
-                return 0;
-            }
-            else
-            {
-                LOG_WARNING_MESSAGE("Texture ", TextureIndex,
-                                    " is used in alpha-cut materials with different cutoff thresholds (", AlphaCutoff, " and ", NewAlphaCutoff,
-                                    "). Alpha remapping to improve mipmap generation will use ",
-                                    std::min(AlphaCutoff, NewAlphaCutoff), '.');
-                AlphaCutoff = std::min(AlphaCutoff, NewAlphaCutoff);
-            }
+            LOG_WARNING_MESSAGE("Metallic-roughness texture ", MRTexIdx, " is used with normal textures ", RoughnessNormalMap, " and ", NormalTexIdx,
+                                ". Normal variance will be baked from texture ", RoughnessNormalMap, '.');
         }
     }
+}
 
-    return std::max(AlphaCutoff, 0.f);
+Model::TextureNormalMapInfo Model::GetTextureNormalMapInfo(int TextureIndex) const
+{
+    // Textures that are not loaded from the GLTF file are not used by any material.
+    return TextureIndex >= 0 && static_cast<size_t>(TextureIndex) < TextureNormalMaps.size() ?
+        TextureNormalMaps[TextureIndex] :
+        TextureNormalMapInfo{};
 }
 
 Uint32 Model::AddTexture(IRenderDevice*     pDevice,
@@ -725,7 +1636,8 @@ Uint32 Model::AddTexture(IRenderDevice*     pDevice,
                          ResourceManager*   pResourceMgr,
                          const ImageData&   Image,
                          int                GltfSamplerId,
-                         const std::string& CacheId)
+                         const std::string& CacheId,
+                         const ImageData*   pRoughnessNormalMap)
 {
     const auto NewTexId = static_cast<int>(Textures.size());
 
@@ -783,8 +1695,11 @@ Uint32 Model::AddTexture(IRenderDevice*     pDevice,
             pSampler = TextureSamplers[GltfSamplerId];
         }
 
+        GLTFTextureMipAttribs MipAttribs;
         // Check if the texture is used in an alpha-cut material
-        const float AlphaCutoff = GetTextureAlphaCutoffValue(NewTexId);
+        MipAttribs.AlphaCutoff         = GetTextureAlphaCutoffValue(NewTexId);
+        MipAttribs.IsNormalMap         = GetTextureNormalMapInfo(NewTexId).IsNormalMap;
+        MipAttribs.pRoughnessNormalMap = pRoughnessNormalMap;
 
         if (Image.Width > 0 && Image.Height > 0)
         {
@@ -796,7 +1711,7 @@ Uint32 Model::AddTexture(IRenderDevice*     pDevice,
 
                 // Load all mip levels.
                 const auto AllocationAlignment = pResourceMgr->GetAllocationAlignment(TexFormat, Image.Width, Image.Height);
-                auto       pInitData           = PrepareGLTFTextureInitData(Image, AlphaCutoff, AtlasDesc.MipLevels, AllocationAlignment);
+                auto       pInitData           = PrepareGLTFTextureInitData(Image, MipAttribs, AtlasDesc.MipLevels, AllocationAlignment);
                 VERIFY_EXPR(pInitData->Format == TexFormat);
 
                 // pInitData will be atomically set in the allocation before any other thread may be able to
@@ -812,7 +1727,10 @@ Uint32 Model::AddTexture(IRenderDevice*     pDevice,
             else
             {
                 // Load only the lowest mip level; other mip levels will be generated on the GPU.
-                auto pTexInitData = PrepareGLTFTextureInitData(Image, AlphaCutoff, 1);
+                // Textures of alpha-cut materials need coverage-preserving mips, and normal and roughness
+                // textures need normal-aware mips that are generated on the CPU.
+                const auto NumMipLevels = MipAttribs.RequireCPUMips() ? ComputeMipLevelsCount(static_cast<Uint32>(Image.Width), static_cast<Uint32>(Image.Height)) : 1u;
+                auto       pTexInitData = PrepareGLTFTextureInitData(Image, MipAttribs, NumMipLevels);
 
                 TextureDesc TexDesc;
                 TexDesc.Name      = "GLTF Texture";
@@ -940,8 +1858,12 @@ void Model::LoadTextures(IRenderDevice*         pDevice,
                          const tinygltf::Model& gltf_model,
                          const std::string&     BaseDir,
                          TextureCacheType*      pTextureCache,
-                         ResourceManager*       pResourceMgr)
+                         ResourceManager*       pResourceMgr,
+                         const ModelCreateInfo& CI)
 {
+    InitTextureAlphaCutoffValues(gltf_model.textures.size());
+    InitTextureNormalMapInfo(gltf_model.textures.size(), CI.RenormalizeNormalMapMips, CI.BakeNormalVarianceToRoughness);
+
     Textures.reserve(gltf_model.textures.size());
     for (const tinygltf::Texture& gltf_tex : gltf_model.textures)
     {
@@ -957,26 +1879,73 @@ void Model::LoadTextures(IRenderDevice*         pDevice,
         Image.pData         = gltf_image.image.data();
         Image.DataSize      = gltf_image.image.size();
 
-        AddTexture(pDevice, pTextureCache, pResourceMgr, Image, gltf_tex.sampler, CacheId);
+        // Normal map whose variance is baked into the roughness. Note that AddTexture() assigns the next
+        // index to the texture. The normal map must have been decoded into tightly packed 8-bit pixels.
+        ImageData  NormalMap;
+        const auto NormalMapIdx    = GetTextureNormalMapInfo(static_cast<int>(Textures.size())).RoughnessNormalMap;
+        const auto NormalMapSource = NormalMapIdx >= 0 ? gltf_model.textures[NormalMapIdx].source : -1;
+        if (NormalMapSource >= 0 && static_cast<size_t>(NormalMapSource) < gltf_model.images.size())
+        {
+            const auto& gltf_normal_image = gltf_model.images[NormalMapSource];
+            if (gltf_normal_image.width > 0 && gltf_normal_image.height > 0 && gltf_normal_image.bits == 8 && gltf_normal_image.component >= 2 &&
+                gltf_normal_image.image.size() >= static_cast<size_t>(gltf_normal_image.width) * gltf_normal_image.height * gltf_normal_image.component)
+            {
+                NormalMap.Width         = gltf_normal_image.width;
+                NormalMap.Height        = gltf_normal_image.height;
+                NormalMap.NumComponents = gltf_normal_image.component;
+                NormalMap.ComponentSize = 1;
+                NormalMap.pData         = gltf_normal_image.image.data();
+                NormalMap.DataSize      = gltf_normal_image.image.size();
+            }
+        }
+
+        AddTexture(pDevice, pTextureCache, pResourceMgr, Image, gltf_tex.sampler, CacheId, NormalMap.pData != nullptr ? &NormalMap : nullptr);
     }
 }
 
-void Model::PrepareGPUResources(IRenderDevice* pDevice, IDeviceContext* pCtx)
+using GetUploadBufferFuncType = std::function<IBuffer*(IRenderDevice* pDevice, IDeviceContext* pCtx)>;
+
+// Adds the work items that upload the data in ranges of at most MaxRangeSize bytes.
+// GetBuffer returns the destination buffer when the item is executed.
+static void AddBufferUploadItems(std::vector<UploadScheduler::WorkItem>& Items,
+                                 const RefCntAutoPtr<BufferInitData>&    pInitData,
+                                 size_t                                  DataIdx,
+                                 Uint64                                  DstOffset,
+                                 Uint32                                  MaxRangeSize,
+                                 const GetUploadBufferFuncType&          GetBuffer)
 {
-    if (GPUDataInitialized.load())
-        return;
+    const auto& Data = pInitData->Data[DataIdx];
+    for (size_t RangeStart = 0; RangeStart < Data.size(); RangeStart += MaxRangeSize)
+    {
+        const auto RangeSize = static_cast<Uint32>(std::min(Data.size() - RangeStart, size_t{MaxRangeSize}));
+        UploadScheduler::WorkItem Item;
+        Item.Size = RangeSize;
+        Item.Func = [pInitData, DataIdx, DstOffset, RangeStart, RangeSize, GetBuffer](IRenderDevice* pDevice, IDeviceContext* pCtx) {
+            if (IBuffer* pBuffer = GetBuffer(pDevice, pCtx))
+            {
+                const auto* pData = &pInitData->Data[DataIdx][RangeStart];
+                pCtx->UpdateBuffer(pBuffer, DstOffset + RangeStart, RangeSize, pData, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+            }
+        };
+        Items.emplace_back(std::move(Item));
+    }
+}
+
+std::vector<UploadScheduler::WorkItem> Model::CreateGPUUploadItems(Uint32 MaxRangeSize)
+{
+    VERIFY_EXPR(MaxRangeSize > 0);
 
+    std::vector<UploadScheduler::WorkItem> Items;
+    // Resources that are transitioned to the required states by the last item
     std::vector<StateTransitionDesc> Barriers;
 
     for (Uint32 i = 0; i < Textures.size(); ++i)
     {
-        auto&     DstTexInfo = Textures[i];
-        ITexture* pTexture   = nullptr;
+        auto& DstTexInfo = Textures[i];
 
         RefCntAutoPtr<TextureInitData> pInitData;
         if (DstTexInfo.pAtlasSuballocation)
         {
-            pTexture  = DstTexInfo.pAtlasSuballocation->GetAtlas()->Update(pDevice, pCtx);
             pInitData = ClassPtrCast<TextureInitData>(DstTexInfo.pAtlasSuballocation->GetUserData());
             // User data is only set when the allocation is created, so no other
             // thread can call SetUserData() in parallel.
@@ -984,15 +1953,15 @@ void Model::PrepareGPUResources(IRenderDevice* pDevice, IDeviceContext* pCtx)
         }
         else if (DstTexInfo.pTexture)
         {
-            pTexture  = DstTexInfo.pTexture;
-            pInitData = ClassPtrCast<TextureInitData>(pTexture->GetUserData());
+            pInitData = ClassPtrCast<TextureInitData>(DstTexInfo.pTexture->GetUserData());
             // User data is only set when the texture is created, so no other
             // thread can call SetUserData() in parallel.
-            pTexture->SetUserData(nullptr);
+            DstTexInfo.pTexture->SetUserData(nullptr);
         }
-
-        if (!pTexture)
+        else
+        {
             continue;
+        }
 
         if (pInitData == nullptr)
         {
@@ -1001,29 +1970,33 @@ void Model::PrepareGPUResources(IRenderDevice* pDevice, IDeviceContext* pCtx)
         }
 
         const auto& Levels      = pInitData->Levels;
-        auto&       pStagingTex = pInitData->pStagingTex;
+        const auto& pStagingTex = pInitData->pStagingTex;
         const auto  DstSlice    = DstTexInfo.pAtlasSuballocation ? DstTexInfo.pAtlasSuballocation->GetSlice() : 0;
-        const auto& TexDesc     = pTexture->GetDesc();
 
-        if (!Levels.empty() || pStagingTex)
+        Uint32 DstX = 0;
+        Uint32 DstY = 0;
+        if (DstTexInfo.pAtlasSuballocation)
         {
-            Uint32 DstX = 0;
-            Uint32 DstY = 0;
-            if (DstTexInfo.pAtlasSuballocation)
-            {
-                const auto& Origin = DstTexInfo.pAtlasSuballocation->GetOrigin();
+            const auto& Origin = DstTexInfo.pAtlasSuballocation->GetOrigin();
 
-                DstX = Origin.x;
-                DstY = Origin.y;
-            }
+            DstX = Origin.x;
+            DstY = Origin.y;
+        }
 
-            if (!Levels.empty())
+        if (!Levels.empty())
+        {
+            VERIFY(!pStagingTex, "Staging texture and levels are mutually exclusive");
+            for (Uint32 mip = 0; mip < Levels.size(); ++mip)
             {
-                VERIFY(!pStagingTex, "Staging texture and levels are mutually exclusive");
-                VERIFY_EXPR(Levels.size() == 1 || Levels.size() == TexDesc.MipLevels);
-                for (Uint32 mip = 0; mip < Levels.size(); ++mip)
-                {
-                    const auto& Level = Levels[mip];
+                UploadScheduler::WorkItem Item;
+                Item.Size = Levels[mip].Data.size();
+                Item.Func = [this, i, pInitData, mip, DstX, DstY, DstSlice](IRenderDevice* pDevice, IDeviceContext* pCtx) {
+                    ITexture* pTexture = GetTexture(i, pDevice, pCtx);
+                    if (pTexture == nullptr)
+                        return;
+
+                    VERIFY_EXPR(pInitData->Levels.size() == 1 || pInitData->Levels.size() == pTexture->GetDesc().MipLevels);
+                    const auto& Level = pInitData->Levels[mip];
 
                     Box UpdateBox;
                     UpdateBox.MinX = DstX >> mip;
@@ -1031,42 +2004,55 @@ void Model::PrepareGPUResources(IRenderDevice* pDevice, IDeviceContext* pCtx)
                     UpdateBox.MinY = DstY >> mip;
                     UpdateBox.MaxY = UpdateBox.MinY + Level.Height;
                     pCtx->UpdateTexture(pTexture, mip, DstSlice, UpdateBox, Level.SubResData, RESOURCE_STATE_TRANSITION_MODE_NONE, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
-                }
+                };
+                Items.emplace_back(std::move(Item));
+            }
 
-                if (Levels.size() == 1 && TexDesc.MipLevels > 1 && DstTexInfo.pTexture)
-                {
-                    // Only generate mips when texture atlas is not used
+            if (Levels.size() == 1 && DstTexInfo.pTexture && DstTexInfo.pTexture->GetDesc().MipLevels > 1)
+            {
+                // Only generate mips when texture atlas is not used
+                UploadScheduler::WorkItem Item;
+                Item.Func = [pTexture = DstTexInfo.pTexture](IRenderDevice* pDevice, IDeviceContext* pCtx) {
                     pCtx->GenerateMips(pTexture->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE));
-                }
+                };
+                Items.emplace_back(std::move(Item));
             }
-            else if (pStagingTex)
+        }
+        else if (pStagingTex)
+        {
+            VERIFY(DstTexInfo.pAtlasSuballocation, "Staging texture is expected to be used with the atlas");
+            const auto& SrcTexDesc = pStagingTex->GetDesc();
+            for (Uint32 mip = 0; mip < SrcTexDesc.MipLevels; ++mip)
             {
-                VERIFY(DstTexInfo.pAtlasSuballocation, "Staging texture is expected to be used with the atlas");
-                const auto& FmtAttribs = GetTextureFormatAttribs(TexDesc.Format);
-                const auto& SrcTexDesc = pStagingTex->GetDesc();
+                UploadScheduler::WorkItem Item;
+                Item.Size = GetMipLevelProperties(SrcTexDesc, mip).MipSize;
+                Item.Func = [this, i, pInitData, mip, DstX, DstY, DstSlice](IRenderDevice* pDevice, IDeviceContext* pCtx) {
+                    ITexture* pTexture = GetTexture(i, pDevice, pCtx);
+                    if (pTexture == nullptr)
+                        return;
 
-                auto SrcMips = std::min(SrcTexDesc.MipLevels, TexDesc.MipLevels);
-                if (FmtAttribs.ComponentType == COMPONENT_TYPE_COMPRESSED)
-                {
-                    // Do not copy mip levels that are smaller than the block size
-                    for (; SrcMips > 0; --SrcMips)
+                    const auto& TexDesc    = pTexture->GetDesc();
+                    const auto& FmtAttribs = GetTextureFormatAttribs(TexDesc.Format);
+                    if (mip >= TexDesc.MipLevels)
+                        return;
+
+                    if (FmtAttribs.ComponentType == COMPONENT_TYPE_COMPRESSED)
                     {
-                        const auto MipProps = GetMipLevelProperties(SrcTexDesc, SrcMips - 1);
-                        if (MipProps.LogicalWidth >= FmtAttribs.BlockWidth &&
-                            MipProps.LogicalHeight >= FmtAttribs.BlockHeight)
-                            break;
+                        // Do not copy mip levels that are smaller than the block size
+                        const auto MipProps = GetMipLevelProperties(pInitData->pStagingTex->GetDesc(), mip);
+                        if (MipProps.LogicalWidth < FmtAttribs.BlockWidth || MipProps.LogicalHeight < FmtAttribs.BlockHeight)
+                            return;
                     }
-                }
-                for (Uint32 mip = 0; mip < SrcMips; ++mip)
-                {
-                    CopyTextureAttribs CopyAttribs{pStagingTex, RESOURCE_STATE_TRANSITION_MODE_TRANSITION, pTexture, RESOURCE_STATE_TRANSITION_MODE_TRANSITION};
+
+                    CopyTextureAttribs CopyAttribs{pInitData->pStagingTex, RESOURCE_STATE_TRANSITION_MODE_TRANSITION, pTexture, RESOURCE_STATE_TRANSITION_MODE_TRANSITION};
                     CopyAttribs.SrcMipLevel = mip;
                     CopyAttribs.DstMipLevel = mip;
                     CopyAttribs.DstSlice    = DstSlice;
                     CopyAttribs.DstX        = DstX >> mip;
                     CopyAttribs.DstY        = DstY >> mip;
                     pCtx->CopyTexture(CopyAttribs);
-                }
+                };
+                Items.emplace_back(std::move(Item));
             }
         }
         else
@@ -1078,59 +2064,56 @@ void Model::PrepareGPUResources(IRenderDevice* pDevice, IDeviceContext* pCtx)
         {
             // Note that we may need to transition a texture even if it has been fully initialized,
             // as is the case with KTX/DDS textures.
-            VERIFY_EXPR(pTexture == DstTexInfo.pTexture);
-            Barriers.emplace_back(StateTransitionDesc{pTexture, RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_SHADER_RESOURCE, STATE_TRANSITION_FLAG_UPDATE_STATE});
+            Barriers.emplace_back(StateTransitionDesc{DstTexInfo.pTexture, RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_SHADER_RESOURCE, STATE_TRANSITION_FLAG_UPDATE_STATE});
         }
     }
 
-    if (IndexData.pBuffer || IndexData.pAllocation)
+    for (IndexDataInfo* pIndexData : {&IndexData, &IndexData16})
     {
-        IBuffer* pBuffer = IndexData.pAllocation ?
-            IndexData.pAllocation->Update(pDevice, pCtx) :
-            IndexData.pBuffer;
+        if (!pIndexData->pBuffer && !pIndexData->pAllocation)
+            continue;
 
-        if (pBuffer != nullptr)
+        RefCntAutoPtr<BufferInitData> pInitData;
+        if (pIndexData->pAllocation)
         {
-            RefCntAutoPtr<BufferInitData> pInitData;
-            if (IndexData.pAllocation)
-            {
-                pInitData = RefCntAutoPtr<BufferInitData>{IndexData.pAllocation->GetUserData(), IID_BufferInitData};
-                IndexData.pAllocation->SetUserData(nullptr);
-            }
-            else if (IndexData.pBuffer)
-            {
-                pInitData = RefCntAutoPtr<BufferInitData>{IndexData.pBuffer->GetUserData(), IID_BufferInitData};
-                IndexData.pBuffer->SetUserData(nullptr);
-            }
+            pInitData = RefCntAutoPtr<BufferInitData>{pIndexData->pAllocation->GetUserData(), IID_BufferInitData};
+            pIndexData->pAllocation->SetUserData(nullptr);
+        }
+        else if (pIndexData->pBuffer)
+        {
+            pInitData = RefCntAutoPtr<BufferInitData>{pIndexData->pBuffer->GetUserData(), IID_BufferInitData};
+            pIndexData->pBuffer->SetUserData(nullptr);
+        }
 
-            if (pInitData)
-            {
-                const auto Offset = IndexData.pAllocation ? IndexData.pAllocation->GetOffset() : 0;
+        if (pInitData)
+        {
+            const auto Offset = pIndexData->pAllocation ? pIndexData->pAllocation->GetOffset() : 0;
 
-                VERIFY_EXPR(pInitData->Data.size() == 1);
-                pCtx->UpdateBuffer(pBuffer, Offset, static_cast<Uint32>(pInitData->Data[0].size()), pInitData->Data[0].data(), RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
-            }
-            if (IndexData.pBuffer != nullptr)
-            {
-                VERIFY_EXPR(IndexData.pBuffer == pBuffer);
-                Barriers.emplace_back(StateTransitionDesc{pBuffer, RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_INDEX_BUFFER, STATE_TRANSITION_FLAG_UPDATE_STATE});
-            }
+            VERIFY_EXPR(pInitData->Data.size() == 1);
+            AddBufferUploadItems(Items, pInitData, 0, Offset, MaxRangeSize, [pIndexData](IRenderDevice* pDevice, IDeviceContext* pCtx) {
+                return pIndexData->GetBuffer(pDevice, pCtx);
+            });
+        }
+        if (pIndexData->pBuffer != nullptr)
+        {
+            Barriers.emplace_back(StateTransitionDesc{pIndexData->pBuffer, RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_INDEX_BUFFER, STATE_TRANSITION_FLAG_UPDATE_STATE});
         }
     }
 
-    for (Uint32 BuffId = 0; BuffId < GetVertexBufferCount(); ++BuffId)
+    RefCntAutoPtr<BufferInitData> pVertexPoolInitData;
+    if (VertexData.pAllocation)
     {
-        IBuffer* pBuffer = VertexData.pAllocation ?
-            VertexData.pAllocation->Update(BuffId, pDevice, pCtx) :
-            VertexData.Buffers[BuffId];
-        if (pBuffer == nullptr)
-            continue;
+        pVertexPoolInitData = RefCntAutoPtr<BufferInitData>{VertexData.pAllocation->GetUserData(), IID_BufferInitData};
+        VertexData.pAllocation->SetUserData(nullptr);
+        VERIFY_EXPR(!pVertexPoolInitData || pVertexPoolInitData->Data.size() == GetVertexBufferCount());
+    }
 
+    for (Uint32 BuffId = 0; BuffId < GetVertexBufferCount(); ++BuffId)
+    {
         RefCntAutoPtr<BufferInitData> pInitData;
         if (VertexData.pAllocation)
         {
-            pInitData = RefCntAutoPtr<BufferInitData>{VertexData.pAllocation->GetUserData(), IID_BufferInitData};
-            VERIFY_EXPR(!pInitData || pInitData->Data.size() == GetVertexBufferCount());
+            pInitData = pVertexPoolInitData;
         }
         else if (VertexData.Buffers[BuffId])
         {
@@ -1138,44 +2121,106 @@ void Model::PrepareGPUResources(IRenderDevice* pDevice, IDeviceContext* pCtx)
             VertexData.Buffers[BuffId]->SetUserData(nullptr);
             VERIFY_EXPR(!pInitData || pInitData->Data.size() == 1);
         }
+        else
+        {
+            continue;
+        }
 
         if (pInitData)
         {
             const auto Offset = VertexData.pAllocation ?
-                VertexData.pAllocation->GetStartVertex() * VertexData.Strides[BuffId] :
+                Uint64{VertexData.pAllocation->GetStartVertex()} * VertexData.Strides[BuffId] :
                 0;
 
-            const auto& Data = VertexData.pAllocation ? pInitData->Data[BuffId] : pInitData->Data[0];
-            if (!Data.empty())
-            {
-                pCtx->UpdateBuffer(pBuffer, Offset, static_cast<Uint32>(Data.size()), Data.data(), RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
-            }
+            AddBufferUploadItems(Items, pInitData, VertexData.pAllocation ? BuffId : 0, Offset, MaxRangeSize, [this, BuffId](IRenderDevice* pDevice, IDeviceContext* pCtx) {
+                return GetVertexBuffer(BuffId, pDevice, pCtx);
+            });
         }
 
         if (!VertexData.Buffers.empty() && VertexData.Buffers[BuffId])
         {
-            VERIFY_EXPR(VertexData.Buffers[BuffId] == pBuffer);
+            IBuffer* pBuffer = VertexData.Buffers[BuffId];
             if (pBuffer->GetDesc().BindFlags & BIND_VERTEX_BUFFER)
                 Barriers.emplace_back(StateTransitionDesc{pBuffer, RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_VERTEX_BUFFER, STATE_TRANSITION_FLAG_UPDATE_STATE});
             else if (pBuffer->GetDesc().BindFlags & BIND_SHADER_RESOURCE)
                 Barriers.emplace_back(StateTransitionDesc{pBuffer, RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_SHADER_RESOURCE, STATE_TRANSITION_FLAG_UPDATE_STATE});
         }
     }
-    if (VertexData.pAllocation)
-        VertexData.pAllocation->SetUserData(nullptr);
 
-    if (!Barriers.empty())
-        pCtx->TransitionResourceStates(static_cast<Uint32>(Barriers.size()), Barriers.data());
-
-    GPUDataInitialized.store(true);
-}
-
-void Model::LoadTextureSamplers(IRenderDevice* pDevice, const tinygltf::Model& gltf_model)
-{
-    for (const tinygltf::Sampler& smpl : gltf_model.samplers)
+    if (MorphTargetData.pAllocation)
     {
-        SamplerDesc SamDesc;
-        SamDesc.MagFilter = ModelBuilder::GetFilterType(smpl.magFilter).first;
+        RefCntAutoPtr<BufferInitData> pInitData{MorphTargetData.pAllocation->GetUserData(), IID_BufferInitData};
+        MorphTargetData.pAllocation->SetUserData(nullptr);
+        if (pInitData && !pInitData->Data.empty())
+        {
+            VERIFY_EXPR(pInitData->Data.size() == 1);
+            const auto Offset = Uint64{MorphTargetData.pAllocation->GetStartVertex()} * MorphTargetDeltaStride;
+            AddBufferUploadItems(Items, pInitData, 0, Offset, MaxRangeSize, [this](IRenderDevice* pDevice, IDeviceContext* pCtx) {
+                return GetMorphTargetBuffer(pDevice, pCtx);
+            });
+        }
+    }
+    else if (MorphTargetData.pBuffer)
+    {
+        Barriers.emplace_back(StateTransitionDesc{MorphTargetData.pBuffer, RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_SHADER_RESOURCE, STATE_TRANSITION_FLAG_UPDATE_STATE});
+    }
+
+    UploadScheduler::WorkItem FinalItem;
+    FinalItem.Func = [this, Barriers](IRenderDevice* pDevice, IDeviceContext* pCtx) {
+        // Make sure that the atlases and pools are up to date even if the model
+        // did not upload any data to them
+        for (auto& TexInfo : Textures)
+        {
+            if (TexInfo.pAtlasSuballocation)
+                TexInfo.pAtlasSuballocation->GetAtlas()->Update(pDevice, pCtx);
+        }
+        if (IndexData.pAllocation)
+            IndexData.pAllocation->Update(pDevice, pCtx);
+        if (IndexData16.pAllocation)
+            IndexData16.pAllocation->Update(pDevice, pCtx);
+        if (VertexData.pAllocation)
+        {
+            for (Uint32 BuffId = 0; BuffId < GetVertexBufferCount(); ++BuffId)
+                VertexData.pAllocation->Update(BuffId, pDevice, pCtx);
+        }
+        if (MorphTargetData.pAllocation)
+            MorphTargetData.pAllocation->Update(0, pDevice, pCtx);
+
+        if (!Barriers.empty())
+            pCtx->TransitionResourceStates(static_cast<Uint32>(Barriers.size()), Barriers.data());
+
+        GPUDataInitialized.store(true);
+    };
+    Items.emplace_back(std::move(FinalItem));
+
+    return Items;
+}
+
+void Model::PrepareGPUResources(IRenderDevice* pDevice, IDeviceContext* pCtx)
+{
+    if (GPUDataInitialized.load() || GPUUploadsScheduled.load())
+        return;
+
+    for (auto& Item : CreateGPUUploadItems(std::numeric_limits<Uint32>::max()))
+        Item.Func(pDevice, pCtx);
+}
+
+UploadScheduler::GroupId Model::ScheduleGPUResourceUploads(UploadScheduler& Scheduler, float Priority, Uint32 MaxRangeSize)
+{
+    DEV_CHECK_ERR(MaxRangeSize > 0, "Max range size must not be zero");
+
+    if (GPUDataInitialized.load() || GPUUploadsScheduled.exchange(true))
+        return UploadScheduler::InvalidGroupId;
+
+    return Scheduler.AddGroup(CreateGPUUploadItems(MaxRangeSize), Priority);
+}
+
+void Model::LoadTextureSamplers(IRenderDevice* pDevice, const tinygltf::Model& gltf_model)
+{
+    for (const tinygltf::Sampler& smpl : gltf_model.samplers)
+    {
+        SamplerDesc SamDesc;
+        SamDesc.MagFilter = ModelBuilder::GetFilterType(smpl.magFilter).first;
         auto MinMipFilter = ModelBuilder::GetFilterType(smpl.minFilter);
         SamDesc.MinFilter = MinMipFilter.first;
         SamDesc.MipFilter = MinMipFilter.second;
@@ -1870,6 +2915,298 @@ bool ReadWholeFile(std::vector<unsigned char>* out,
 
 } // namespace Callbacks
 
+// Returns true if the buffer only provides the uncompressed fallback data of the
+// EXT_meshopt_compression buffer views.
+static bool IsMeshoptFallbackBuffer(const JsonValue& Buffer)
+{
+    return Buffer.Find("extensions").Find(MeshoptCompressionExtension).Find("fallback").GetBool();
+}
+
+// Writes the buffers array. The fallback buffers of EXT_meshopt_compression usually have no uri,
+// which tinygltf can't load, and their data is never used as the compressed views are decoded instead.
+// These buffers are replaced with small placeholders that keep the buffer indices intact and are
+// released by DecodeMeshoptCompressedBufferViews().
+static void AppendGltfBuffersJson(std::string& Json, const JsonValue& Buffers)
+{
+    if (!Buffers.IsArray())
+    {
+        Json.append(Buffers.GetRawData(), Buffers.GetRawSize());
+        return;
+    }
+
+    Json += '[';
+    Buffers.ProcessElements([&Json](Uint32 Idx, const JsonValue& Buffer) {
+        if (Idx > 0)
+            Json += ',';
+
+        if (IsMeshoptFallbackBuffer(Buffer))
+        {
+            const auto Extensions = Buffer.Find("extensions");
+            Json += R"({"byteLength":4,"uri":"data:application/octet-stream;base64,AAAAAA==","extensions":)";
+            Json.append(Extensions.GetRawData(), Extensions.GetRawSize());
+            Json += '}';
+        }
+        else
+        {
+            Json.append(Buffer.GetRawData(), Buffer.GetRawSize());
+        }
+    });
+    Json += ']';
+}
+
+// Builds the document that is loaded by tinygltf.
+// When the fast JSON parser is used, the document only contains the root properties loaded by
+// tinygltf. The scene graph, meshes, accessors, skins and animations are read from the JSON index
+// directly (see JsonGltfModelWrapper).
+static std::string GetTinyGltfJson(const JsonIndex& Index, bool Reduced)
+{
+    static constexpr const char* TinyGltfProperties[] = {
+        "asset",
+        "extensionsUsed",
+        "extensionsRequired",
+        "extensions",
+        "materials",
+        "textures",
+        "images",
+        "samplers",
+        "buffers",
+        "bufferViews",
+    };
+
+    std::string Json = "{";
+    Index.GetRoot().ProcessMembers([&Json, Reduced](const JsonValue& Key, const JsonValue& Value) {
+        if (Reduced)
+        {
+            const auto PropertyIt = std::find_if(std::begin(TinyGltfProperties), std::end(TinyGltfProperties),
+                                                 [&Key](const char* Property) { return Key.StringEquals(Property); });
+            if (PropertyIt == std::end(TinyGltfProperties))
+                return;
+        }
+
+        if (Json.size() > 1)
+            Json += ',';
+        Json.append(Key.GetRawData(), Key.GetRawSize());
+        Json += ':';
+        if (Key.StringEquals("buffers"))
+            AppendGltfBuffersJson(Json, Value);
+        else
+            Json.append(Value.GetRawData(), Value.GetRawSize());
+    });
+    Json += '}';
+
+    return Json;
+}
+
+// The contents of a GLTF or GLB file.
+struct GltfFileData
+{
+    std::vector<unsigned char> Data;
+
+    bool   IsBinary   = false;
+    size_t JsonOffset = 0;
+    size_t JsonSize   = 0;
+
+    const char* GetJson() const
+    {
+        return reinterpret_cast<const char*>(Data.data()) + JsonOffset;
+    }
+};
+
+// GLB header: magic, version, length, followed by the JSON chunk length and type
+static constexpr size_t GLBJsonChunkOffset = 20;
+static constexpr Uint32 GLBJsonChunkType   = 0x4E4F534A; // "JSON"
+
+// Reads the GLTF or GLB file and locates its JSON document.
+static bool ReadGltfFile(Callbacks::LoaderData& LoaderData,
+                         const std::string&     filename,
+                         GltfFileData&          File,
+                         std::string&           error)
+{
+    if (!Callbacks::ReadWholeFile(&File.Data, &error, filename, &LoaderData))
+        return false;
+
+    if (File.Data.size() > std::numeric_limits<unsigned int>::max())
+    {
+        error = "File is too large";
+        return false;
+    }
+
+    File.IsBinary   = File.Data.size() >= GLBJsonChunkOffset && memcmp(File.Data.data(), "glTF", 4) == 0;
+    File.JsonOffset = 0;
+    File.JsonSize   = File.Data.size();
+    if (File.IsBinary)
+    {
+        Uint32 ChunkLength = 0;
+        Uint32 ChunkType   = 0;
+        memcpy(&ChunkLength, &File.Data[12], sizeof(ChunkLength));
+        memcpy(&ChunkType, &File.Data[16], sizeof(ChunkType));
+        if (ChunkType != GLBJsonChunkType || ChunkLength > File.Data.size() - GLBJsonChunkOffset)
+        {
+            error = "Invalid GLB JSON chunk";
+            return false;
+        }
+        File.JsonOffset = GLBJsonChunkOffset;
+        File.JsonSize   = ChunkLength;
+    }
+
+    return true;
+}
+
+// Replaces the JSON document of the file, keeping the binary chunk of the GLB file intact.
+static void ReplaceGltfJson(GltfFileData& File, const std::string& Json)
+{
+    if (!File.IsBinary)
+    {
+        File.Data.assign(Json.begin(), Json.end());
+        File.JsonSize = Json.size();
+        return;
+    }
+
+    if (Json.size() <= File.JsonSize)
+    {
+        // The new document is written in place of the JSON chunk padded with spaces
+        memcpy(&File.Data[File.JsonOffset], Json.data(), Json.size());
+        memset(&File.Data[File.JsonOffset + Json.size()], ' ', File.JsonSize - Json.size());
+        return;
+    }
+
+    // The JSON chunk must be padded to 4 bytes with spaces
+    const size_t JsonChunkSize = AlignUp(Json.size(), size_t{4});
+
+    std::vector<unsigned char> Data;
+    Data.reserve(File.Data.size() - File.JsonSize + JsonChunkSize);
+    Data.insert(Data.end(), File.Data.begin(), File.Data.begin() + File.JsonOffset);
+    Data.insert(Data.end(), Json.begin(), Json.end());
+    Data.resize(File.JsonOffset + JsonChunkSize, ' ');
+    Data.insert(Data.end(), File.Data.begin() + File.JsonOffset + File.JsonSize, File.Data.end());
+
+    const Uint32 TotalLength = static_cast<Uint32>(Data.size());
+    const Uint32 ChunkLength = static_cast<Uint32>(JsonChunkSize);
+    memcpy(&Data[8], &TotalLength, sizeof(TotalLength));
+    memcpy(&Data[12], &ChunkLength, sizeof(ChunkLength));
+
+    File.Data     = std::move(Data);
+    File.JsonSize = JsonChunkSize;
+}
+
+static bool LoadTinyGltfModel(tinygltf::TinyGLTF& gltf_context,
+                              const GltfFileData& File,
+                              const std::string&  filename,
+                              tinygltf::Model&    gltf_model,
+                              std::string&        error,
+                              std::string&        warning)
+{
+    const auto        SeparatorPos = filename.find_last_of("/\\");
+    const std::string BaseDir      = SeparatorPos != std::string::npos ? filename.substr(0, SeparatorPos) : "";
+
+    const auto DataSize = static_cast<unsigned int>(File.Data.size());
+    return File.IsBinary ?
+        gltf_context.LoadBinaryFromMemory(&gltf_model, &error, &warning, File.Data.data(), DataSize, BaseDir) :
+        gltf_context.LoadASCIIFromString(&gltf_model, &error, &warning, reinterpret_cast<const char*>(File.Data.data()), DataSize, BaseDir);
+}
+
+// Reads the GLTF or GLB file and loads it with tinygltf.
+// If the file uses EXT_meshopt_compression, its fallback buffers are replaced with placeholders
+// (see AppendGltfBuffersJson).
+static bool LoadGltfModel(tinygltf::TinyGLTF&    gltf_context,
+                          Callbacks::LoaderData& LoaderData,
+                          const std::string&     filename,
+                          tinygltf::Model&       gltf_model,
+                          std::string&           error,
+                          std::string&           warning)
+{
+    GltfFileData File;
+    if (!ReadGltfFile(LoaderData, filename, File, error))
+        return false;
+
+    const char* const pJson = File.GetJson();
+    if (std::search(pJson, pJson + File.JsonSize, std::begin(MeshoptCompressionExtension), std::end(MeshoptCompressionExtension) - 1) != pJson + File.JsonSize)
+    {
+        JsonIndex Index;
+        if (!Index.Parse(pJson, File.JsonSize, &error))
+            return false;
+
+        ReplaceGltfJson(File, GetTinyGltfJson(Index, /*Reduced = */ false));
+    }
+
+    return LoadTinyGltfModel(gltf_context, File, filename, gltf_model, error, warning);
+}
+
+// Reads the GLTF or GLB file, indexes its JSON document and loads the reduced document with tinygltf.
+// If the document can't be loaded from the index (e.g. it uses Draco mesh compression that is
+// decoded by tinygltf), the index is left empty and the whole document is loaded by tinygltf.
+static bool LoadGltfModelWithJsonIndex(tinygltf::TinyGLTF&    gltf_context,
+                                       Callbacks::LoaderData& LoaderData,
+                                       const std::string&     filename,
+                                       tinygltf::Model&       gltf_model,
+                                       std::string&           JsonText,
+                                       JsonIndex&             Index,
+                                       std::string&           error,
+                                       std::string&           warning)
+{
+    GltfFileData File;
+    if (!ReadGltfFile(LoaderData, filename, File, error))
+        return false;
+
+    JsonText.assign(File.GetJson(), File.JsonSize);
+    if (!Index.Parse(JsonText.data(), JsonText.size(), &error))
+        return false;
+
+    bool UsesDraco = false;
+    Index.GetRoot().Find("extensionsUsed").ProcessElements([&UsesDraco](Uint32, const JsonValue& Ext) {
+        UsesDraco = UsesDraco || Ext.StringEquals("KHR_draco_mesh_compression");
+    });
+
+    ReplaceGltfJson(File, GetTinyGltfJson(Index, /*Reduced = */ !UsesDraco));
+    if (UsesDraco)
+    {
+        JsonText.clear();
+        Index = {};
+    }
+
+    return LoadTinyGltfModel(gltf_context, File, filename, gltf_model, error, warning);
+}
+
+// Loads the DXSDKMesh and converts it into the glTF object model.
+// Texture images are loaded the same way tinygltf loads glTF images.
+static bool LoadDXSDKMeshModel(Callbacks::LoaderData&     LoaderData,
+                               const std::string&         filename,
+                               DXSDKMesh&                 SdkMesh,
+                               tinygltf::Model&           gltf_model,
+                               std::vector<const Uint8*>& BufferData,
+                               std::string&               error)
+{
+    if (!SdkMesh.Create(filename.c_str()))
+    {
+        error = "failed to load the SDK mesh";
+        return false;
+    }
+
+    ConvertDXSDKMeshToGltf(SdkMesh, gltf_model, BufferData);
+
+    for (size_t i = 0; i < gltf_model.images.size(); ++i)
+    {
+        auto&             gltf_image = gltf_model.images[i];
+        const std::string FilePath   = LoaderData.BaseDir + gltf_image.uri;
+
+        std::vector<unsigned char> ImageData;
+        std::string                ImageError;
+        if (!Callbacks::FileExists(FilePath, &LoaderData) ||
+            !Callbacks::ReadWholeFile(&ImageData, &ImageError, FilePath, &LoaderData) ||
+            !Callbacks::LoadImageData(&gltf_image, static_cast<int>(i), &ImageError, nullptr, 0, 0, ImageData.data(), static_cast<int>(ImageData.size()), &LoaderData))
+        {
+            LOG_WARNING_MESSAGE("Failed to load texture ", FilePath, " of SDK mesh ", filename, ". ", ImageError);
+
+            // Empty images do not produce textures
+            gltf_image.image.clear();
+            gltf_image.width  = 0;
+            gltf_image.height = 0;
+        }
+    }
+
+    return true;
+}
+
 void Model::LoadFromFile(IRenderDevice*         pDevice,
                          IDeviceContext*        pContext,
                          const ModelCreateInfo& CI)
@@ -1902,22 +3239,35 @@ void Model::LoadFromFile(IRenderDevice*         pDevice,
     fsCallbacks.user_data             = &LoaderData;
     gltf_context.SetFsCallbacks(fsCallbacks);
 
-    bool   binary = false;
-    size_t extpos = filename.rfind('.', filename.length());
+    bool   sdkmesh = false;
+    size_t extpos  = filename.rfind('.', filename.length());
     if (extpos != std::string::npos)
     {
-        binary = (filename.substr(extpos + 1, filename.length() - extpos) == "glb");
+        const auto ext = filename.substr(extpos + 1, filename.length() - extpos);
+
+        sdkmesh = StrCmpNoCase(ext.c_str(), "sdkmesh") == 0;
     }
 
     std::string     error;
     std::string     warning;
     tinygltf::Model gltf_model;
 
+    // The index references the JSON text, so the text must be kept alive until the model is built.
+    std::string JsonText;
+    JsonIndex   JsonIdx;
+
+    // The glTF model converted from the SDK mesh references the mesh data,
+    // so the mesh must be kept alive until the model is built.
+    DXSDKMesh                 SdkMesh;
+    std::vector<const Uint8*> SdkMeshBufferData;
+
     bool fileLoaded = false;
-    if (binary)
-        fileLoaded = gltf_context.LoadBinaryFromFile(&gltf_model, &error, &warning, filename.c_str());
+    if (sdkmesh)
+        fileLoaded = LoadDXSDKMeshModel(LoaderData, filename, SdkMesh, gltf_model, SdkMeshBufferData, error);
+    else if (CI.UseFastJsonParser)
+        fileLoaded = LoadGltfModelWithJsonIndex(gltf_context, LoaderData, filename, gltf_model, JsonText, JsonIdx, error, warning);
     else
-        fileLoaded = gltf_context.LoadASCIIFromFile(&gltf_model, &error, &warning, filename.c_str());
+        fileLoaded = LoadGltfModel(gltf_context, LoaderData, filename, gltf_model, error, warning);
     if (!fileLoaded)
     {
         LOG_ERROR_AND_THROW("Failed to load gltf file ", filename, ": ", error);
@@ -1927,13 +3277,45 @@ void Model::LoadFromFile(IRenderDevice*         pDevice,
         LOG_WARNING_MESSAGE("Loaded gltf file ", filename, " with the following warning:", warning);
     }
 
+    DecodeMeshoptCompressedBufferViews(gltf_model, CI.pThreadPool);
+
+    SourceDataSize = GetSourceDataSize(gltf_model) + JsonText.size();
+    if (sdkmesh)
+    {
+        // Buffers of the converted SDK mesh are empty as the mesh data is referenced directly
+        for (const auto& View : gltf_model.bufferViews)
+            SourceDataSize += View.byteLength;
+    }
+    if (CI.pMemoryBudget != nullptr)
+    {
+        MemoryUsage Required;
+        Required.CPUTransient = SourceDataSize;
+        Required.GPUReserved  = EstimateTextureMemorySize(gltf_model);
+        Required.GPUUsed      = Required.GPUReserved;
+        if (!CI.pMemoryBudget->Fits(Required))
+        {
+            LOG_ERROR_AND_THROW("Failed to load gltf file ", filename, ": the source data (", Required.CPUTransient,
+                                " bytes) and textures (", Required.GPUReserved, " bytes) exceed the memory budget");
+        }
+    }
+
     // Load materials first as the LoadTextures() function needs them to determine the alpha-cut value.
     LoadMaterials(gltf_model, CI.MaterialLoadCallback);
     LoadTextureSamplers(pDevice, gltf_model);
-    LoadTextures(pDevice, gltf_model, LoaderData.BaseDir, pTextureCache, pResourceMgr);
+    LoadTextures(pDevice, gltf_model, LoaderData.BaseDir, pTextureCache, pResourceMgr, CI);
 
     ModelBuilder Builder{CI, *this};
-    Builder.Execute(TinyGltfModelWrapper{gltf_model}, CI.SceneId, pDevice);
+    if (sdkmesh)
+        Builder.Execute(DXSDKMeshGltfModelWrapper{gltf_model, SdkMeshBufferData}, CI.SceneId, pDevice);
+    else if (JsonIdx.GetRoot())
+        Builder.Execute(JsonGltfModelWrapper{JsonIdx, gltf_model}, CI.SceneId, pDevice);
+    else
+        Builder.Execute(TinyGltfModelWrapper{gltf_model}, CI.SceneId, pDevice);
+
+    if (CI.DeduplicateMaterials)
+        DeduplicateMaterials(); // Also updates the draw order
+    else
+        UpdateDrawOrder();
 
     if (pContext != nullptr)
     {
@@ -1958,7 +3340,29 @@ BoundBox Model::ComputeBoundingBox(Uint32 SceneIndex, const ModelTransforms& Tra
         for (const auto* pN : scene.LinearNodes)
         {
             VERIFY_EXPR(pN != nullptr);
-            if (pN->pMesh != nullptr && pN->pMesh->IsValidBB())
+            if (pN->pMesh == nullptr || !pN->pMesh->IsValidBB())
+                continue;
+
+            if (pN->IsInstanced())
+            {
+                // Instanced meshes are only rendered at the instance locations
+                for (size_t i = 0; i < pN->InstanceMatrices.size(); ++i)
+                {
+                    const auto& InstanceMatrix = Transforms.InstanceMatrices[pN->FirstInstance + i];
+                    const auto  InstanceAABB   = pN->pMesh->BB.Transform(InstanceMatrix);
+
+                    ModelAABB.Min = std::min(ModelAABB.Min, InstanceAABB.Min);
+                    ModelAABB.Max = std::max(ModelAABB.Max, InstanceAABB.Max);
+                }
+            }
+            else if (pN->pSkin != nullptr && !pN->pSkin->JointBounds.empty())
+            {
+                const auto SkinAABB = ComputeSkinBoundingBox(*pN->pSkin, Transforms);
+
+                ModelAABB.Min = std::min(ModelAABB.Min, SkinAABB.Min);
+                ModelAABB.Max = std::max(ModelAABB.Max, SkinAABB.Max);
+            }
+            else
             {
                 const auto& GlobalMatrix = Transforms.NodeGlobalMatrices[pN->Index];
                 const auto  NodeAABB     = pN->pMesh->BB.Transform(GlobalMatrix);
@@ -1976,6 +3380,454 @@ BoundBox Model::ComputeBoundingBox(Uint32 SceneIndex, const ModelTransforms& Tra
     return ModelAABB;
 }
 
+BoundBox Model::ComputeSkinBoundingBox(const Skin& skin, const ModelTransforms& Transforms) const
+{
+    BoundBox SkinAABB;
+    SkinAABB.Min = float3{+FLT_MAX, +FLT_MAX, +FLT_MAX};
+    SkinAABB.Max = float3{-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+    if (!CompatibleWithTransforms(Transforms))
+    {
+        UNEXPECTED("Incompatible transforms. Please use the ComputeTransforms() method first.");
+        return SkinAABB;
+    }
+    VERIFY(skin.JointBounds.empty() || skin.JointBounds.size() == skin.Joints.size(),
+           "The number of joint bounding boxes (", skin.JointBounds.size(), ") does not match the number of joints (", skin.Joints.size(), ")");
+
+    // The skinned vertex is transformed by InverseBindMatrix * JointNodeGlobalMatrix,
+    // so the joint node global matrices transform the joint-space boxes into the world space.
+    std::vector<float4x4> JointTransforms(skin.JointBounds.size());
+    for (size_t i = 0; i < JointTransforms.size(); ++i)
+        JointTransforms[i] = Transforms.NodeGlobalMatrices[skin.Joints[i]->Index];
+
+    return GLTF::ComputeSkinBoundingBox(skin.JointBounds.data(), JointTransforms.data(), static_cast<Uint32>(JointTransforms.size()));
+}
+
+// Calls Handler(Node, InstanceId, Matrix) for every instance of the scene meshes that have triangle hierarchies.
+template <typename HandlerType>
+static void ProcessMeshBVHInstances(const Scene& scene, const ModelTransforms& Transforms, HandlerType&& Handler)
+{
+    for (const auto* pN : scene.LinearNodes)
+    {
+        VERIFY_EXPR(pN != nullptr);
+        if (pN->pMesh == nullptr || !pN->pMesh->pBVH)
+            continue;
+
+        if (pN->IsInstanced())
+        {
+            for (size_t i = 0; i < pN->InstanceMatrices.size(); ++i)
+                Handler(*pN, static_cast<int>(i), Transforms.InstanceMatrices[pN->FirstInstance + i]);
+        }
+        else
+        {
+            Handler(*pN, -1, Transforms.NodeGlobalMatrices[pN->Index]);
+        }
+    }
+}
+
+// Transforms the ray into the mesh space. The direction is not normalized,
+// so that hit distances are the same in both spaces.
+static Ray TransformRay(const Ray& R, const float4x4& InvMatrix)
+{
+    const float4 Origin    = float4{R.Origin, 1} * InvMatrix;
+    const float4 Direction = float4{R.Direction, 0} * InvMatrix;
+
+    Ray LocalRay       = R;
+    LocalRay.Origin    = float3{Origin.x, Origin.y, Origin.z};
+    LocalRay.Direction = float3{Direction.x, Direction.y, Direction.z};
+    return LocalRay;
+}
+
+bool Model::IntersectRay(Uint32 SceneIndex, const ModelTransforms& Transforms, const Ray& R, RayHit& Hit) const
+{
+    if (!CompatibleWithTransforms(Transforms))
+    {
+        UNEXPECTED("Incompatible transforms. Please use the ComputeTransforms() method first.");
+        return false;
+    }
+    VERIFY_EXPR(SceneIndex < Scenes.size());
+
+    bool Found = false;
+    ProcessMeshBVHInstances(Scenes[SceneIndex], Transforms, [&](const Node& N, int InstanceId, const float4x4& Matrix) {
+        if (N.pMesh->pBVH->IntersectRay(TransformRay(R, Matrix.Inverse()), Hit))
+        {
+            Hit.NodeIndex  = N.Index;
+            Hit.InstanceId = InstanceId;
+            Hit.MaterialId = N.pMesh->Primitives[Hit.PrimitiveId].MaterialId;
+            Found          = true;
+        }
+    });
+
+    return Found;
+}
+
+void Model::IntersectRays(Uint32 SceneIndex, const ModelTransforms& Transforms, const Ray* pRays, RayHit* pHits, size_t NumRays) const
+{
+    if (!CompatibleWithTransforms(Transforms))
+    {
+        UNEXPECTED("Incompatible transforms. Please use the ComputeTransforms() method first.");
+        return;
+    }
+    VERIFY_EXPR(SceneIndex < Scenes.size());
+
+    std::vector<Ray>    LocalRays(NumRays);
+    std::vector<RayHit> MeshHits(NumRays);
+    ProcessMeshBVHInstances(Scenes[SceneIndex], Transforms, [&](const Node& N, int InstanceId, const float4x4& Matrix) {
+        const auto InvMatrix = Matrix.Inverse();
+        for (size_t i = 0; i < NumRays; ++i)
+        {
+            LocalRays[i]  = TransformRay(pRays[i], InvMatrix);
+            MeshHits[i]   = RayHit{};
+            MeshHits[i].T = pHits[i].T;
+        }
+
+        N.pMesh->pBVH->IntersectRays(LocalRays.data(), MeshHits.data(), NumRays);
+
+        for (size_t i = 0; i < NumRays; ++i)
+        {
+            // Only hits that are closer than the current ones are reported
+            if (!MeshHits[i].IsValid())
+                continue;
+
+            pHits[i]            = MeshHits[i];
+            pHits[i].NodeIndex  = N.Index;
+            pHits[i].InstanceId = InstanceId;
+            pHits[i].MaterialId = N.pMesh->Primitives[MeshHits[i].PrimitiveId].MaterialId;
+        }
+    });
+}
+
+void Material::Canonicalize()
+{
+    // Alpha cutoff is only used in the mask mode
+    if (Attribs.AlphaMode != ALPHA_MODE_MASK)
+        Attribs.AlphaCutoff = ShaderAttribs{}.AlphaCutoff;
+}
+
+template <typename AttribsType>
+static void HashOptionalAttribs(size_t& Hash, const std::unique_ptr<AttribsType>& pAttribs)
+{
+    HashCombine(Hash, pAttribs != nullptr);
+    if (pAttribs)
+        HashCombine(Hash, ComputeHashRaw(pAttribs.get(), sizeof(AttribsType)));
+}
+
+template <typename AttribsType>
+static bool OptionalAttribsEqual(const std::unique_ptr<AttribsType>& pLhs, const std::unique_ptr<AttribsType>& pRhs)
+{
+    if (!pLhs || !pRhs)
+        return !pLhs && !pRhs;
+    return memcmp(pLhs.get(), pRhs.get(), sizeof(AttribsType)) == 0;
+}
+
+size_t Material::ComputeHash() const
+{
+    size_t Hash = ComputeHashRaw(&Attribs, sizeof(Attribs));
+    HashCombine(Hash, DoubleSided, HasClearcoat, pUserData.RawPtr(), ActiveTextureAttribs);
+
+    HashOptionalAttribs(Hash, Sheen);
+    HashOptionalAttribs(Hash, Anisotropy);
+    HashOptionalAttribs(Hash, Iridescence);
+    HashOptionalAttribs(Hash, Transmission);
+    HashOptionalAttribs(Hash, Volume);
+
+    const auto NumActiveTextureAttribs = GetNumActiveTextureAttribs();
+    if (NumActiveTextureAttribs > 0)
+    {
+        HashCombine(Hash, ComputeHashRaw(TextureIds.get(), sizeof(int) * NumActiveTextureAttribs));
+        HashCombine(Hash, ComputeHashRaw(TextureAttribs.get(), sizeof(TextureShaderAttribs) * NumActiveTextureAttribs));
+    }
+
+    return Hash;
+}
+
+bool Material::operator==(const Material& Rhs) const
+{
+    // clang-format off
+    if (memcmp(&Attribs, &Rhs.Attribs, sizeof(Attribs)) != 0 ||
+        DoubleSided          != Rhs.DoubleSided  ||
+        HasClearcoat         != Rhs.HasClearcoat ||
+        pUserData            != Rhs.pUserData    ||
+        ActiveTextureAttribs != Rhs.ActiveTextureAttribs)
+        return false;
+
+    if (!OptionalAttribsEqual(Sheen,        Rhs.Sheen)        ||
+        !OptionalAttribsEqual(Anisotropy,   Rhs.Anisotropy)   ||
+        !OptionalAttribsEqual(Iridescence,  Rhs.Iridescence)  ||
+        !OptionalAttribsEqual(Transmission, Rhs.Transmission) ||
+        !OptionalAttribsEqual(Volume,       Rhs.Volume))
+        return false;
+    // clang-format on
+
+    const auto NumActiveTextureAttribs = GetNumActiveTextureAttribs();
+    return (NumActiveTextureAttribs == 0 ||
+            (memcmp(TextureIds.get(), Rhs.TextureIds.get(), sizeof(int) * NumActiveTextureAttribs) == 0 &&
+             memcmp(TextureAttribs.get(), Rhs.TextureAttribs.get(), sizeof(TextureShaderAttribs) * NumActiveTextureAttribs) == 0));
+}
+
+Uint32 Model::DeduplicateMaterials()
+{
+    // Material hash -> indices of unique materials with this hash
+    std::unordered_multimap<size_t, Uint32> UniqueMaterialIds;
+
+    std::vector<Material> UniqueMaterials;
+    UniqueMaterials.reserve(Materials.size());
+
+    std::vector<Uint32> MaterialRemap(Materials.size());
+    for (size_t i = 0; i < Materials.size(); ++i)
+    {
+        auto& Mat = Materials[i];
+        Mat.Canonicalize();
+
+        const auto Hash  = Mat.ComputeHash();
+        const auto Range = UniqueMaterialIds.equal_range(Hash);
+
+        auto it = Range.first;
+        while (it != Range.second && !(UniqueMaterials[it->second] == Mat))
+            ++it;
+
+        if (it != Range.second)
+        {
+            MaterialRemap[i] = it->second;
+        }
+        else
+        {
+            const auto UniqueId = static_cast<Uint32>(UniqueMaterials.size());
+            UniqueMaterialIds.emplace(Hash, UniqueId);
+            UniqueMaterials.emplace_back(std::move(Mat));
+            MaterialRemap[i] = UniqueId;
+        }
+    }
+
+    const auto NumRemoved = static_cast<Uint32>(Materials.size() - UniqueMaterials.size());
+    Materials             = std::move(UniqueMaterials);
+    if (NumRemoved > 0)
+    {
+        for (auto& mesh : Meshes)
+        {
+            for (auto& prim : mesh.Primitives)
+            {
+                VERIFY(prim.MaterialId < MaterialRemap.size(), "Material index ", prim.MaterialId, " is out of range");
+                prim.MaterialId = MaterialRemap[prim.MaterialId];
+            }
+        }
+    }
+
+    UpdateDrawOrder();
+
+    return NumRemoved;
+}
+
+void Model::UpdateDrawOrder()
+{
+    static constexpr Uint32 TextureSetBits = 29;
+    static constexpr Uint32 MaxTextureSets = 1u << TextureSetBits;
+
+    // Assign a dense index to every unique combination of textures used by materials
+    struct TextureSetHasher
+    {
+        size_t operator()(const std::vector<int>& TextureIds) const noexcept
+        {
+            return TextureIds.empty() ? 0 : ComputeHashRaw(TextureIds.data(), TextureIds.size() * sizeof(int));
+        }
+    };
+    std::unordered_map<std::vector<int>, Uint32, TextureSetHasher> TextureSets;
+
+    std::vector<Uint32> MaterialTextureSets(Materials.size());
+    std::vector<int>    TextureIds;
+    for (size_t i = 0; i < Materials.size(); ++i)
+    {
+        TextureIds.clear();
+        Materials[i].ProcessActiveTextureAttibs(
+            [&TextureIds](Uint32, const Material::TextureShaderAttribs&, int TextureId) {
+                TextureIds.push_back(TextureId);
+                return true;
+            });
+
+        const auto TextureSetId = TextureSets.emplace(TextureIds, static_cast<Uint32>(TextureSets.size())).first->second;
+        if (TextureSetId == MaxTextureSets)
+            LOG_WARNING_MESSAGE("The number of unique texture sets exceeds ", MaxTextureSets, ". Draw order may be suboptimal.");
+        MaterialTextureSets[i] = std::min(TextureSetId, MaxTextureSets - 1);
+    }
+
+    for (auto& mesh : Meshes)
+    {
+        for (auto& prim : mesh.Primitives)
+        {
+            if (prim.MaterialId >= Materials.size())
+            {
+                UNEXPECTED("Material index ", prim.MaterialId, " is out of range");
+                prim.SortKey = ~Uint64{0};
+                continue;
+            }
+            const auto& Mat = Materials[prim.MaterialId];
+
+            const auto AlphaMode = static_cast<Uint64>(std::min(std::max(Mat.Attribs.AlphaMode, 0), 3));
+            if (Mat.Attribs.AlphaMode == Material::ALPHA_MODE_BLEND)
+            {
+                // Reordering blended primitives changes the result, so the stable sort
+                // must keep their authored order.
+                prim.SortKey = AlphaMode << 62u;
+                continue;
+            }
+
+            prim.SortKey =
+                (AlphaMode << 62u) |
+                (Uint64{Mat.DoubleSided ? 1u : 0u} << 61u) |
+                (Uint64{MaterialTextureSets[prim.MaterialId]} << 32u) |
+                Uint64{prim.MaterialId};
+        }
+    }
+
+    for (auto& scene : Scenes)
+    {
+        scene.DrawOrder.clear();
+        for (const auto* pNode : scene.LinearNodes)
+        {
+            if (pNode == nullptr || pNode->pMesh == nullptr)
+                continue;
+
+            for (size_t prim = 0; prim < pNode->pMesh->Primitives.size(); ++prim)
+                scene.DrawOrder.push_back({pNode, static_cast<Uint32>(prim)});
+        }
+
+        std::stable_sort(scene.DrawOrder.begin(), scene.DrawOrder.end(),
+                         [](const Scene::DrawItem& Lhs, const Scene::DrawItem& Rhs) {
+                             return Lhs.pNode->pMesh->Primitives[Lhs.PrimitiveId].SortKey < Rhs.pNode->pMesh->Primitives[Rhs.PrimitiveId].SortKey;
+                         });
+    }
+}
+
+ModelMemoryUsage Model::GetMemoryUsage() const
+{
+    ModelMemoryUsage Usage;
+
+    if (VertexData.pAllocation)
+    {
+        Uint64 VertexSize = 0;
+        for (auto Stride : VertexData.Strides)
+            VertexSize += Stride;
+        Usage.Vertices.GPUReserved  = Uint64{VertexData.pAllocation->GetVertexCount()} * VertexSize;
+        Usage.Vertices.CPUTransient = GetBufferInitDataSize(VertexData.pAllocation->GetUserData());
+    }
+    else
+    {
+        for (const auto& pBuffer : VertexData.Buffers)
+        {
+            if (!pBuffer)
+                continue;
+            Usage.Vertices.GPUReserved += pBuffer->GetDesc().Size;
+            Usage.Vertices.CPUTransient += GetBufferInitDataSize(pBuffer->GetUserData());
+        }
+    }
+    Usage.Vertices.CPUResident = GetVectorMemorySize(VertexData.Strides) + GetVectorMemorySize(VertexData.Buffers);
+    Usage.Vertices.GPUUsed     = Usage.Vertices.GPUReserved;
+
+    for (const IndexDataInfo* pIndexData : {&IndexData, &IndexData16})
+    {
+        if (pIndexData->pAllocation)
+        {
+            Usage.Indices.GPUReserved += pIndexData->pAllocation->GetSize();
+            Usage.Indices.CPUTransient += GetBufferInitDataSize(pIndexData->pAllocation->GetUserData());
+        }
+        else if (pIndexData->pBuffer)
+        {
+            Usage.Indices.GPUReserved += pIndexData->pBuffer->GetDesc().Size;
+            Usage.Indices.CPUTransient += GetBufferInitDataSize(pIndexData->pBuffer->GetUserData());
+        }
+    }
+    Usage.Indices.GPUUsed = Usage.Indices.GPUReserved;
+
+    if (MorphTargetData.pAllocation)
+    {
+        Usage.MorphTargets.GPUReserved  = Uint64{MorphTargetData.pAllocation->GetVertexCount()} * MorphTargetDeltaStride;
+        Usage.MorphTargets.CPUTransient = GetBufferInitDataSize(MorphTargetData.pAllocation->GetUserData());
+    }
+    else if (MorphTargetData.pBuffer)
+    {
+        Usage.MorphTargets.GPUReserved = MorphTargetData.pBuffer->GetDesc().Size;
+    }
+    Usage.MorphTargets.GPUUsed = Usage.MorphTargets.GPUReserved;
+
+    for (const auto& TexInfo : Textures)
+    {
+        if (TexInfo.pTexture)
+        {
+            Usage.Textures.GPUReserved += GetTextureMemorySize(TexInfo.pTexture->GetDesc());
+            Usage.Textures.CPUTransient += GetTextureInitDataSize(TexInfo.pTexture->GetUserData());
+        }
+        else if (TexInfo.pAtlasSuballocation)
+        {
+            const auto& Size = TexInfo.pAtlasSuballocation->GetSize();
+            if (auto* pAtlas = TexInfo.pAtlasSuballocation->GetAtlas())
+            {
+                const auto& AtlasDesc = pAtlas->GetAtlasDesc();
+
+                TextureDesc RegionDesc;
+                RegionDesc.Type      = RESOURCE_DIM_TEX_2D;
+                RegionDesc.Format    = AtlasDesc.Format;
+                RegionDesc.Width     = Size.x;
+                RegionDesc.Height    = Size.y;
+                RegionDesc.MipLevels = std::min(std::max(AtlasDesc.MipLevels, 1u), ComputeMipLevelsCount(Size.x, Size.y));
+                Usage.Textures.GPUReserved += GetTextureMemorySize(RegionDesc);
+            }
+            Usage.Textures.CPUTransient += GetTextureInitDataSize(TexInfo.pAtlasSuballocation->GetUserData());
+        }
+    }
+    Usage.Textures.CPUResident = GetVectorMemorySize(Textures) + GetVectorMemorySize(TextureAlphaCutoffs) + GetVectorMemorySize(TextureNormalMaps) + GetVectorMemorySize(TextureSamplers);
+    Usage.Textures.GPUUsed     = Usage.Textures.GPUReserved;
+
+    auto& SceneMem = Usage.Scene.CPUResident;
+
+    SceneMem += GetVectorMemorySize(Scenes);
+    for (const auto& scene : Scenes)
+        SceneMem += GetVectorMemorySize(scene.RootNodes) + GetVectorMemorySize(scene.LinearNodes) + GetVectorMemorySize(scene.DrawOrder);
+
+    SceneMem += GetVectorMemorySize(Nodes);
+    for (const auto& node : Nodes)
+        SceneMem += GetVectorMemorySize(node.Children) + GetVectorMemorySize(node.InstanceMatrices);
+
+    SceneMem += GetVectorMemorySize(Meshes);
+    for (const auto& mesh : Meshes)
+    {
+        SceneMem += GetVectorMemorySize(mesh.Primitives) + GetVectorMemorySize(mesh.Weights);
+        if (mesh.pBVH)
+            SceneMem += sizeof(MeshBVH) + mesh.pBVH->GetMemorySize();
+    }
+
+    SceneMem += GetVectorMemorySize(Cameras) + GetVectorMemorySize(Lights);
+
+    SceneMem += GetVectorMemorySize(Skins);
+    for (const auto& skin : Skins)
+        SceneMem += GetVectorMemorySize(skin.InverseBindMatrices) + GetVectorMemorySize(skin.Joints) + GetVectorMemorySize(skin.JointBounds);
+
+    SceneMem += GetVectorMemorySize(Materials);
+    for (const auto& Mat : Materials)
+    {
+        SceneMem += Mat.GetNumActiveTextureAttribs() * (sizeof(int) + sizeof(Material::TextureShaderAttribs));
+
+        // clang-format off
+        if (Mat.Sheen)        SceneMem += sizeof(Material::SheenShaderAttribs);
+        if (Mat.Anisotropy)   SceneMem += sizeof(Material::AnisotropyShaderAttribs);
+        if (Mat.Iridescence)  SceneMem += sizeof(Material::IridescenceShaderAttribs);
+        if (Mat.Transmission) SceneMem += sizeof(Material::TransmissionShaderAttribs);
+        if (Mat.Volume)       SceneMem += sizeof(Material::VolumeShaderAttribs);
+        // clang-format on
+    }
+
+    SceneMem += GetVectorMemorySize(Animations);
+    for (const auto& Anim : Animations)
+    {
+        SceneMem += GetVectorMemorySize(Anim.Samplers) + GetVectorMemorySize(Anim.Channels);
+        for (const auto& Sampler : Anim.Samplers)
+            SceneMem += GetVectorMemorySize(Sampler.Inputs) + GetVectorMemorySize(Sampler.OutputsVec4) + Sampler.Compressed.GetMemorySize();
+    }
+
+    Usage.PeakSourceDataSize = SourceDataSize;
+
+    return Usage;
+}
+
 static void UpdateNodeGlobalTransform(const Node& node, const float4x4& ParentMatrix, ModelTransforms& Transforms)
 {
     const auto& LocalMat  = Transforms.NodeLocalMatrices[node.Index];
@@ -2025,6 +3877,22 @@ void Model::ComputeTransforms(Uint32           SceneIndex,
     for (auto* pRoot : scene.RootNodes)
         UpdateNodeGlobalTransform(*pRoot, RootTransform, Transforms);
 
+    // Update instance matrices
+    Transforms.InstanceMatrices.resize(InstanceCount);
+    for (const auto* pNode : scene.LinearNodes)
+    {
+        VERIFY_EXPR(pNode != nullptr);
+        if (!pNode->IsInstanced())
+            continue;
+
+        VERIFY(pNode->FirstInstance + pNode->InstanceMatrices.size() <= InstanceCount,
+               "Node instances exceed the total instance count in this model. This appears to be a bug.");
+        const auto& NodeGlobalMat = Transforms.NodeGlobalMatrices[pNode->Index];
+        auto*       pInstanceMats = &Transforms.InstanceMatrices[pNode->FirstInstance];
+        for (size_t i = 0; i < pNode->InstanceMatrices.size(); ++i)
+            pInstanceMats[i] = pNode->InstanceMatrices[i] * NodeGlobalMat;
+    }
+
     // Update join matrices
     if (!Transforms.Skins.empty())
     {
@@ -2059,7 +3927,8 @@ void Model::ComputeTransforms(Uint32           SceneIndex,
 bool Model::CompatibleWithTransforms(const ModelTransforms& Transforms) const
 {
     return (Transforms.NodeLocalMatrices.size() == Nodes.size() &&
-            Transforms.NodeGlobalMatrices.size() == Nodes.size());
+            Transforms.NodeGlobalMatrices.size() == Nodes.size() &&
+            Transforms.InstanceMatrices.size() == InstanceCount);
 }
 
 void Model::UpdateAnimation(Uint32 SceneIndex, Uint32 AnimationIndex, float time, ModelTransforms& Transforms) const
@@ -2094,6 +3963,31 @@ void Model::UpdateAnimation(Uint32 SceneIndex, Uint32 AnimationIndex, float time
     for (auto& channel : animation.Channels)
     {
         const auto& sampler = animation.Samplers[channel.SamplerIndex];
+        if (!sampler.Compressed.IsEmpty())
+        {
+            // Compressed tracks are sampled directly without decompressing the whole track
+            auto&        NodeAnim = Transforms.NodeAnimations[channel.pNode->Index];
+            const float4 Value    = sampler.Compressed.Sample(time);
+            switch (channel.PathType)
+            {
+                case AnimationChannel::PATH_TYPE::TRANSLATION:
+                    NodeAnim.Translation = float3{Value};
+                    break;
+
+                case AnimationChannel::PATH_TYPE::SCALE:
+                    NodeAnim.Scale = float3{Value};
+                    break;
+
+                case AnimationChannel::PATH_TYPE::ROTATION:
+                    NodeAnim.Rotation.q = Value;
+                    break;
+
+                default:
+                    UNEXPECTED("Only translation, rotation and scale tracks may be compressed");
+            }
+            continue;
+        }
+
         if (sampler.Inputs.size() > sampler.OutputsVec4.size())
         {
             continue;
@@ -0,0 +1,87 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "GLTFMemoryUsage.hpp"
+
+#include <algorithm>
+
+#include "GraphicsAccessories.hpp"
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+bool MemoryBudget::Fits(const MemoryUsage& Required) const
+{
+    if (MaxCPUMemory == 0 && MaxGPUMemory == 0)
+        return true;
+
+    Uint64 PrevOverflow = ~Uint64{0};
+    while (true)
+    {
+        const auto Usage       = QueryUsage ? QueryUsage() + Required : Required;
+        const auto CPUOverflow = GetCPUOverflow(Usage);
+        const auto GPUOverflow = GetGPUOverflow(Usage);
+        if (CPUOverflow == 0 && GPUOverflow == 0)
+            return true;
+
+        // Stop if the previous eviction did not release any memory
+        const auto TotalOverflow = CPUOverflow + GPUOverflow;
+        if (TotalOverflow >= PrevOverflow)
+            return false;
+        PrevOverflow = TotalOverflow;
+
+        if (!Evict || !Evict(CPUOverflow, GPUOverflow))
+            return false;
+    }
+}
+
+Uint64 GetTextureMemorySize(const TextureDesc& Desc)
+{
+    const auto Is3D      = Desc.Type == RESOURCE_DIM_TEX_3D;
+    const auto NumSlices = Is3D ? 1u : std::max(Desc.ArraySize, 1u);
+
+    auto MipLevels = Desc.MipLevels;
+    if (MipLevels == 0)
+    {
+        MipLevels = Is3D ?
+            ComputeMipLevelsCount(Desc.Width, Desc.Height, Desc.Depth) :
+            ComputeMipLevelsCount(Desc.Width, Desc.Height);
+    }
+
+    Uint64 Size = 0;
+    for (Uint32 mip = 0; mip < MipLevels; ++mip)
+        Size += GetMipLevelProperties(Desc, mip).MipSize;
+
+    return Size * NumSlices;
+}
+
+} // namespace GLTF
+
+} // namespace Diligent
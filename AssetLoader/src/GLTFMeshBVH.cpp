@@ -0,0 +1,653 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "GLTFMeshBVH.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "DebugUtilities.hpp"
+#include "ParallelFor.hpp"
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+namespace
+{
+
+// The number of bins used to evaluate the surface area heuristic along every axis.
+constexpr Uint32 NumSAHBins = 16;
+
+// Leaves with up to this number of triangles are created when splitting does not reduce the SAH cost.
+constexpr Uint32 MaxLeafSize = 4;
+
+// The maximum depth of the hierarchy, which also limits the traversal stack size.
+constexpr Uint32 MaxDepth = 48;
+
+// Subtrees with fewer triangles are never built by separate tasks.
+constexpr Uint32 MinParallelSubtreeSize = 2048;
+
+// The cost of a node traversal relative to the cost of a ray-triangle test.
+constexpr float TraversalCost = 1.f;
+
+struct AABB
+{
+    float3 Min{+FLT_MAX};
+    float3 Max{-FLT_MAX};
+
+    void Grow(const float3& Point)
+    {
+        Min = std::min(Min, Point);
+        Max = std::max(Max, Point);
+    }
+
+    void Grow(const AABB& Box)
+    {
+        Min = std::min(Min, Box.Min);
+        Max = std::max(Max, Box.Max);
+    }
+
+    float HalfArea() const
+    {
+        if (Min.x > Max.x)
+            return 0;
+        const auto Size = Max - Min;
+        return Size.x * Size.y + Size.y * Size.z + Size.z * Size.x;
+    }
+};
+
+class BVHBuilder
+{
+public:
+    struct Subtree
+    {
+        Uint32 NodeIdx;
+        Uint32 Begin;
+        Uint32 End;
+        Uint32 Depth;
+    };
+
+    BVHBuilder(const std::vector<AABB>&    _TriBounds,
+               const std::vector<float3>&  _Centroids,
+               std::vector<Uint32>&        _TriIndices,
+               std::vector<MeshBVH::Node>& _Nodes) :
+        TriBounds{_TriBounds},
+        Centroids{_Centroids},
+        TriIndices{_TriIndices},
+        Nodes{_Nodes}
+    {}
+
+    // When pDeferredSubtrees is not null, subtrees with at most MaxSubtreeSize triangles
+    // are not built, but are added to the list to be built later by separate tasks.
+    void Build(Uint32 NodeIdx, Uint32 Begin, Uint32 End, Uint32 NodeDepth);
+
+    std::vector<Subtree>* pDeferredSubtrees = nullptr;
+    Uint32                MaxSubtreeSize    = 0;
+
+    Uint32 Depth = 0;
+
+private:
+    void MakeLeaf(Uint32 NodeIdx, Uint32 Begin, Uint32 End)
+    {
+        Nodes[NodeIdx].FirstIndex   = Begin;
+        Nodes[NodeIdx].NumTriangles = End - Begin;
+    }
+
+    const std::vector<AABB>&    TriBounds;
+    const std::vector<float3>&  Centroids;
+    std::vector<Uint32>&        TriIndices;
+    std::vector<MeshBVH::Node>& Nodes;
+};
+
+void BVHBuilder::Build(Uint32 NodeIdx, Uint32 Begin, Uint32 End, Uint32 NodeDepth)
+{
+    Depth = std::max(Depth, NodeDepth + 1);
+
+    AABB Bounds;
+    AABB CentroidBounds;
+    for (Uint32 i = Begin; i < End; ++i)
+    {
+        Bounds.Grow(TriBounds[TriIndices[i]]);
+        CentroidBounds.Grow(Centroids[TriIndices[i]]);
+    }
+    Nodes[NodeIdx].Min = Bounds.Min;
+    Nodes[NodeIdx].Max = Bounds.Max;
+
+    const Uint32 Count = End - Begin;
+    if (Count <= 1 || NodeDepth + 1 >= MaxDepth)
+    {
+        MakeLeaf(NodeIdx, Begin, End);
+        return;
+    }
+
+    if (pDeferredSubtrees != nullptr && Count <= MaxSubtreeSize)
+    {
+        pDeferredSubtrees->push_back({NodeIdx, Begin, End, NodeDepth});
+        return;
+    }
+
+    // Find the best split with the binned surface area heuristic
+    int    BestAxis  = -1;
+    Uint32 BestSplit = 0;
+    float  BestCost  = FLT_MAX;
+    for (int Axis = 0; Axis < 3; ++Axis)
+    {
+        const float Extent = CentroidBounds.Max[Axis] - CentroidBounds.Min[Axis];
+        if (!(Extent > 0))
+            continue;
+
+        AABB   BinBounds[NumSAHBins];
+        Uint32 BinCounts[NumSAHBins] = {};
+
+        const float Scale = NumSAHBins / Extent;
+        for (Uint32 i = Begin; i < End; ++i)
+        {
+            const Uint32 TriIdx = TriIndices[i];
+            const Uint32 Bin    = std::min(static_cast<Uint32>((Centroids[TriIdx][Axis] - CentroidBounds.Min[Axis]) * Scale), NumSAHBins - 1);
+            BinBounds[Bin].Grow(TriBounds[TriIdx]);
+            ++BinCounts[Bin];
+        }
+
+        // Sweep from the right to compute the costs of the right sides
+        float  RightCosts[NumSAHBins] = {};
+        AABB   RightBounds;
+        Uint32 RightCount = 0;
+        for (Uint32 Bin = NumSAHBins - 1; Bin > 0; --Bin)
+        {
+            RightBounds.Grow(BinBounds[Bin]);
+            RightCount += BinCounts[Bin];
+            RightCosts[Bin - 1] = static_cast<float>(RightCount) * RightBounds.HalfArea();
+        }
+
+        AABB   LeftBounds;
+        Uint32 LeftCount = 0;
+        for (Uint32 Split = 0; Split < NumSAHBins - 1; ++Split)
+        {
+            LeftBounds.Grow(BinBounds[Split]);
+            LeftCount += BinCounts[Split];
+            if (LeftCount == 0 || LeftCount == Count)
+                continue;
+
+            const float Cost = static_cast<float>(LeftCount) * LeftBounds.HalfArea() + RightCosts[Split];
+            if (Cost < BestCost)
+            {
+                BestCost  = Cost;
+                BestAxis  = Axis;
+                BestSplit = Split;
+            }
+        }
+    }
+
+    Uint32 Mid = Begin;
+    if (BestAxis >= 0)
+    {
+        const float Area     = Bounds.HalfArea();
+        const float LeafCost = static_cast<float>(Count);
+        const float SplitCost = TraversalCost + (Area > 0 ? BestCost / Area : LeafCost);
+        if (SplitCost >= LeafCost && Count <= MaxLeafSize)
+        {
+            MakeLeaf(NodeIdx, Begin, End);
+            return;
+        }
+
+        const float MinCentroid = CentroidBounds.Min[BestAxis];
+        const float Scale       = NumSAHBins / (CentroidBounds.Max[BestAxis] - MinCentroid);
+
+        auto MidIt = std::partition(TriIndices.begin() + Begin, TriIndices.begin() + End,
+                                    [&](Uint32 TriIdx) {
+                                        const Uint32 Bin = std::min(static_cast<Uint32>((Centroids[TriIdx][BestAxis] - MinCentroid) * Scale), NumSAHBins - 1);
+                                        return Bin <= BestSplit;
+                                    });
+        Mid = static_cast<Uint32>(MidIt - TriIndices.begin());
+    }
+    else if (Count <= MaxLeafSize)
+    {
+        // All centroids are the same
+        MakeLeaf(NodeIdx, Begin, End);
+        return;
+    }
+
+    if (Mid == Begin || Mid == End)
+    {
+        // All centroids are the same, or the bins are degenerate: split in the middle
+        Mid = Begin + Count / 2;
+    }
+
+    const auto FirstChild = static_cast<Uint32>(Nodes.size());
+    Nodes.resize(Nodes.size() + 2);
+    Nodes[NodeIdx].FirstIndex   = FirstChild;
+    Nodes[NodeIdx].NumTriangles = 0;
+
+    Build(FirstChild, Begin, Mid, NodeDepth + 1);
+    Build(FirstChild + 1, Mid, End, NodeDepth + 1);
+}
+
+inline float3 ReadPosition(const MeshBVH::PrimitiveData& Prim, Uint32 Vertex)
+{
+    float3 Pos;
+    memcpy(&Pos, static_cast<const Uint8*>(Prim.pPositions) + size_t{Vertex} * Prim.PositionStride, sizeof(Pos));
+    return Pos;
+}
+
+inline Uint32 ReadIndex(const MeshBVH::PrimitiveData& Prim, Uint32 i)
+{
+    if (Prim.pIndices == nullptr)
+        return Prim.BaseVertex + i;
+
+    if (Prim.IndexType == VT_UINT16)
+    {
+        Uint16 Index;
+        memcpy(&Index, static_cast<const Uint8*>(Prim.pIndices) + size_t{i} * sizeof(Uint16), sizeof(Index));
+        return Prim.BaseVertex + Index;
+    }
+    else
+    {
+        Uint32 Index;
+        memcpy(&Index, static_cast<const Uint8*>(Prim.pIndices) + size_t{i} * sizeof(Uint32), sizeof(Index));
+        return Prim.BaseVertex + Index;
+    }
+}
+
+inline float3 ComputeInvDirection(const float3& Dir)
+{
+    // Avoid infinities that produce NaNs when the ray origin lies on a slab plane
+    auto Inv = [](float d) {
+        return 1.f / (std::abs(d) > 1e-20f ? d : (d < 0 ? -1e-20f : 1e-20f));
+    };
+    return float3{Inv(Dir.x), Inv(Dir.y), Inv(Dir.z)};
+}
+
+// Returns the entry distance of the ray into the box, or FLT_MAX if the ray misses it.
+inline float IntersectBox(const MeshBVH::Node& Node, const float3& Origin, const float3& InvDir, float TMin, float TMax)
+{
+    const float tx0 = (Node.Min.x - Origin.x) * InvDir.x;
+    const float tx1 = (Node.Max.x - Origin.x) * InvDir.x;
+    const float ty0 = (Node.Min.y - Origin.y) * InvDir.y;
+    const float ty1 = (Node.Max.y - Origin.y) * InvDir.y;
+    const float tz0 = (Node.Min.z - Origin.z) * InvDir.z;
+    const float tz1 = (Node.Max.z - Origin.z) * InvDir.z;
+
+    const float Enter = std::max(std::max(std::min(tx0, tx1), std::min(ty0, ty1)), std::max(std::min(tz0, tz1), TMin));
+    const float Exit  = std::min(std::min(std::max(tx0, tx1), std::max(ty0, ty1)), std::min(std::max(tz0, tz1), TMax));
+    return Enter <= Exit ? Enter : FLT_MAX;
+}
+
+// Moller-Trumbore ray-triangle intersection.
+inline bool IntersectTriangle(const MeshBVH::Triangle& Tri, const float3& Origin, const float3& Dir, float TMin, float TMax, float& T, float& U, float& V)
+{
+    const float3 P   = cross(Dir, Tri.E2);
+    const float  Det = dot(Tri.E1, P);
+    if (Det == 0)
+        return false;
+
+    const float  InvDet = 1.f / Det;
+    const float3 S      = Origin - Tri.V0;
+
+    U = dot(S, P) * InvDet;
+    if (U < 0 || U > 1)
+        return false;
+
+    const float3 Q = cross(S, Tri.E1);
+
+    V = dot(Dir, Q) * InvDet;
+    if (V < 0 || U + V > 1)
+        return false;
+
+    T = dot(Tri.E2, Q) * InvDet;
+    return T >= TMin && T < TMax;
+}
+
+} // namespace
+
+MeshBVH::MeshBVH(const PrimitiveData* pPrimitives, Uint32 NumPrimitives, IThreadPool* pThreadPool)
+{
+    DEV_CHECK_ERR(NumPrimitives == 0 || pPrimitives != nullptr, "pPrimitives must not be null when NumPrimitives > 0");
+
+    size_t MaxTriangles = 0;
+    for (Uint32 i = 0; i < NumPrimitives; ++i)
+        MaxTriangles += pPrimitives[i].IndexCount / 3;
+
+    std::vector<Triangle> Triangles;
+    std::vector<AABB>     TriBounds;
+    std::vector<float3>   Centroids;
+    Triangles.reserve(MaxTriangles);
+    TriBounds.reserve(MaxTriangles);
+    Centroids.reserve(MaxTriangles);
+    for (Uint32 PrimId = 0; PrimId < NumPrimitives; ++PrimId)
+    {
+        const auto& Prim = pPrimitives[PrimId];
+        DEV_CHECK_ERR(Prim.IndexCount == 0 || Prim.pPositions != nullptr, "Vertex positions of primitive ", PrimId, " must not be null");
+        DEV_CHECK_ERR(Prim.pIndices == nullptr || Prim.IndexType == VT_UINT16 || Prim.IndexType == VT_UINT32, "Invalid index type of primitive ", PrimId);
+
+        for (Uint32 TriId = 0; TriId < Prim.IndexCount / 3; ++TriId)
+        {
+            const Uint32 i0 = ReadIndex(Prim, TriId * 3 + 0);
+            const Uint32 i1 = ReadIndex(Prim, TriId * 3 + 1);
+            const Uint32 i2 = ReadIndex(Prim, TriId * 3 + 2);
+            if (i0 >= Prim.NumVertices || i1 >= Prim.NumVertices || i2 >= Prim.NumVertices)
+                continue;
+
+            const float3 V0 = ReadPosition(Prim, i0);
+            const float3 V1 = ReadPosition(Prim, i1);
+            const float3 V2 = ReadPosition(Prim, i2);
+
+            Triangle Tri;
+            Tri.V0          = V0;
+            Tri.E1          = V1 - V0;
+            Tri.E2          = V2 - V0;
+            Tri.PrimitiveId = PrimId;
+            Tri.TriangleId  = TriId;
+            Triangles.push_back(Tri);
+
+            AABB Bounds;
+            Bounds.Grow(V0);
+            Bounds.Grow(V1);
+            Bounds.Grow(V2);
+            TriBounds.push_back(Bounds);
+            Centroids.push_back((Bounds.Min + Bounds.Max) * 0.5f);
+        }
+    }
+
+    if (Triangles.empty())
+        return;
+
+    const auto NumTriangles = static_cast<Uint32>(Triangles.size());
+
+    std::vector<Uint32> TriIndices(NumTriangles);
+    for (Uint32 i = 0; i < NumTriangles; ++i)
+        TriIndices[i] = i;
+
+    m_Nodes.reserve(size_t{NumTriangles} * 2 / MaxLeafSize + 1);
+    m_Nodes.resize(1);
+
+    BVHBuilder Builder{TriBounds, Centroids, TriIndices, m_Nodes};
+    if (pThreadPool != nullptr && NumTriangles > MinParallelSubtreeSize * 2)
+    {
+        // Build the top of the hierarchy in this thread, and the subtrees in parallel
+        std::vector<BVHBuilder::Subtree> Subtrees;
+        Builder.pDeferredSubtrees = &Subtrees;
+        Builder.MaxSubtreeSize    = std::max(MinParallelSubtreeSize, NumTriangles / 64);
+        Builder.Build(0, 0, NumTriangles, 0);
+
+        struct SubtreeResult
+        {
+            std::vector<Node> Nodes;
+            Uint32            Depth = 0;
+        };
+        std::vector<SubtreeResult> Results(Subtrees.size());
+        ParallelFor(pThreadPool, static_cast<Uint32>(Subtrees.size()), [&](Uint32 i) {
+            const auto& Subtree = Subtrees[i];
+            auto&       Result  = Results[i];
+            Result.Nodes.resize(1);
+
+            BVHBuilder SubtreeBuilder{TriBounds, Centroids, TriIndices, Result.Nodes};
+            SubtreeBuilder.Build(0, Subtree.Begin, Subtree.End, Subtree.Depth);
+            Result.Depth = SubtreeBuilder.Depth;
+        });
+
+        // Merge the subtrees: the subtree root replaces the placeholder node,
+        // and the remaining nodes are appended to the end.
+        m_Depth = Builder.Depth;
+        for (size_t i = 0; i < Subtrees.size(); ++i)
+        {
+            const auto& Result = Results[i];
+            const auto  Offset = static_cast<Uint32>(m_Nodes.size()) - 1;
+            for (size_t n = 0; n < Result.Nodes.size(); ++n)
+            {
+                auto SubtreeNode = Result.Nodes[n];
+                if (!SubtreeNode.IsLeaf())
+                    SubtreeNode.FirstIndex += Offset;
+                if (n == 0)
+                    m_Nodes[Subtrees[i].NodeIdx] = SubtreeNode;
+                else
+                    m_Nodes.push_back(SubtreeNode);
+            }
+            m_Depth = std::max(m_Depth, Result.Depth);
+        }
+    }
+    else
+    {
+        Builder.Build(0, 0, NumTriangles, 0);
+        m_Depth = Builder.Depth;
+    }
+    m_Nodes.shrink_to_fit();
+
+    m_Triangles.resize(NumTriangles);
+    for (Uint32 i = 0; i < NumTriangles; ++i)
+        m_Triangles[i] = Triangles[TriIndices[i]];
+}
+
+void MeshBVH::GetBounds(float3& Min, float3& Max) const
+{
+    if (!m_Nodes.empty())
+    {
+        Min = m_Nodes[0].Min;
+        Max = m_Nodes[0].Max;
+    }
+    else
+    {
+        Min = float3{};
+        Max = float3{};
+    }
+}
+
+size_t MeshBVH::GetMemorySize() const
+{
+    return m_Nodes.capacity() * sizeof(Node) + m_Triangles.capacity() * sizeof(Triangle);
+}
+
+bool MeshBVH::IntersectRay(const Ray& R, RayHit& Hit) const
+{
+    if (m_Nodes.empty())
+        return false;
+
+    const float3 InvDir = ComputeInvDirection(R.Direction);
+
+    float TMax = std::min(R.TMax, Hit.T);
+    if (IntersectBox(m_Nodes[0], R.Origin, InvDir, R.TMin, TMax) == FLT_MAX)
+        return false;
+
+    bool   Found = false;
+    Uint32 Stack[MaxDepth];
+    Uint32 StackSize = 0;
+    Uint32 NodeIdx   = 0;
+    while (true)
+    {
+        const auto& N = m_Nodes[NodeIdx];
+        if (N.IsLeaf())
+        {
+            for (Uint32 i = N.FirstIndex; i < N.FirstIndex + N.NumTriangles; ++i)
+            {
+                const auto& Tri = m_Triangles[i];
+
+                float T, U, V;
+                if (IntersectTriangle(Tri, R.Origin, R.Direction, R.TMin, TMax, T, U, V))
+                {
+                    TMax             = T;
+                    Hit.T            = T;
+                    Hit.Barycentrics = float2{U, V};
+                    Hit.PrimitiveId  = Tri.PrimitiveId;
+                    Hit.TriangleId   = Tri.TriangleId;
+                    Found            = true;
+                }
+            }
+        }
+        else
+        {
+            Uint32 Near = N.FirstIndex;
+            Uint32 Far  = N.FirstIndex + 1;
+
+            float NearT = IntersectBox(m_Nodes[Near], R.Origin, InvDir, R.TMin, TMax);
+            float FarT  = IntersectBox(m_Nodes[Far], R.Origin, InvDir, R.TMin, TMax);
+            if (FarT < NearT)
+            {
+                std::swap(Near, Far);
+                std::swap(NearT, FarT);
+            }
+
+            if (NearT != FLT_MAX)
+            {
+                if (FarT != FLT_MAX)
+                {
+                    VERIFY_EXPR(StackSize < MaxDepth);
+                    Stack[StackSize++] = Far;
+                }
+                NodeIdx = Near;
+                continue;
+            }
+        }
+
+        if (StackSize == 0)
+            break;
+        NodeIdx = Stack[--StackSize];
+    }
+
+    return Found;
+}
+
+void MeshBVH::IntersectPacket(const Ray* pRays, RayHit* pHits, Uint32 NumRays) const
+{
+    VERIFY_EXPR(NumRays > 0 && NumRays <= PacketSize);
+
+    // Structure-of-arrays layout lets the compiler vectorize the per-lane box tests.
+    // Inactive lanes never hit anything as their TMax is less than TMin.
+    float OrgX[PacketSize], OrgY[PacketSize], OrgZ[PacketSize];
+    float InvX[PacketSize], InvY[PacketSize], InvZ[PacketSize];
+    float TMin[PacketSize], TMax[PacketSize];
+    for (Uint32 l = 0; l < PacketSize; ++l)
+    {
+        const bool   Active = l < NumRays;
+        const float3 InvDir = Active ? ComputeInvDirection(pRays[l].Direction) : float3{1, 1, 1};
+
+        OrgX[l] = Active ? pRays[l].Origin.x : 0;
+        OrgY[l] = Active ? pRays[l].Origin.y : 0;
+        OrgZ[l] = Active ? pRays[l].Origin.z : 0;
+        InvX[l] = InvDir.x;
+        InvY[l] = InvDir.y;
+        InvZ[l] = InvDir.z;
+        TMin[l] = Active ? pRays[l].TMin : 0;
+        TMax[l] = Active ? std::min(pRays[l].TMax, pHits[l].T) : -1;
+    }
+
+    // Returns the minimum entry distance of all lanes that hit the box, or FLT_MAX if no lane hits it
+    auto IntersectPacketBox = [&](const Node& N) {
+        float MinEnter = FLT_MAX;
+        for (Uint32 l = 0; l < PacketSize; ++l)
+        {
+            const float tx0 = (N.Min.x - OrgX[l]) * InvX[l];
+            const float tx1 = (N.Max.x - OrgX[l]) * InvX[l];
+            const float ty0 = (N.Min.y - OrgY[l]) * InvY[l];
+            const float ty1 = (N.Max.y - OrgY[l]) * InvY[l];
+            const float tz0 = (N.Min.z - OrgZ[l]) * InvZ[l];
+            const float tz1 = (N.Max.z - OrgZ[l]) * InvZ[l];
+
+            const float Enter = std::max(std::max(std::min(tx0, tx1), std::min(ty0, ty1)), std::max(std::min(tz0, tz1), TMin[l]));
+            const float Exit  = std::min(std::min(std::max(tx0, tx1), std::max(ty0, ty1)), std::min(std::max(tz0, tz1), TMax[l]));
+            MinEnter          = std::min(MinEnter, Enter <= Exit ? Enter : FLT_MAX);
+        }
+        return MinEnter;
+    };
+
+    if (IntersectPacketBox(m_Nodes[0]) == FLT_MAX)
+        return;
+
+    Uint32 Stack[MaxDepth];
+    Uint32 StackSize = 0;
+    Uint32 NodeIdx   = 0;
+    while (true)
+    {
+        const auto& N = m_Nodes[NodeIdx];
+        if (N.IsLeaf())
+        {
+            for (Uint32 i = N.FirstIndex; i < N.FirstIndex + N.NumTriangles; ++i)
+            {
+                const auto& Tri = m_Triangles[i];
+                for (Uint32 l = 0; l < NumRays; ++l)
+                {
+                    float T, U, V;
+                    if (IntersectTriangle(Tri, pRays[l].Origin, pRays[l].Direction, TMin[l], TMax[l], T, U, V))
+                    {
+                        TMax[l] = T;
+
+                        auto& Hit        = pHits[l];
+                        Hit.T            = T;
+                        Hit.Barycentrics = float2{U, V};
+                        Hit.PrimitiveId  = Tri.PrimitiveId;
+                        Hit.TriangleId   = Tri.TriangleId;
+                    }
+                }
+            }
+        }
+        else
+        {
+            Uint32 Near = N.FirstIndex;
+            Uint32 Far  = N.FirstIndex + 1;
+
+            float NearT = IntersectPacketBox(m_Nodes[Near]);
+            float FarT  = IntersectPacketBox(m_Nodes[Far]);
+            if (FarT < NearT)
+            {
+                std::swap(Near, Far);
+                std::swap(NearT, FarT);
+            }
+
+            if (NearT != FLT_MAX)
+            {
+                if (FarT != FLT_MAX)
+                {
+                    VERIFY_EXPR(StackSize < MaxDepth);
+                    Stack[StackSize++] = Far;
+                }
+                NodeIdx = Near;
+                continue;
+            }
+        }
+
+        if (StackSize == 0)
+            break;
+        NodeIdx = Stack[--StackSize];
+    }
+}
+
+void MeshBVH::IntersectRays(const Ray* pRays, RayHit* pHits, size_t NumRays) const
+{
+    if (m_Nodes.empty())
+        return;
+
+    for (size_t i = 0; i < NumRays; i += PacketSize)
+    {
+        IntersectPacket(pRays + i, pHits + i, static_cast<Uint32>(std::min(NumRays - i, size_t{PacketSize})));
+    }
+}
+
+} // namespace GLTF
+
+} // namespace Diligent
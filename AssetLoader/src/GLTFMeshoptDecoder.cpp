@@ -0,0 +1,689 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "GLTFMeshoptDecoder.hpp"
+
+#include <cstring>
+#include <algorithm>
+#include <cmath>
+
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+// The implementation follows the reference decoder of the meshoptimizer library:
+// https://github.com/zeux/meshoptimizer/blob/master/src/vertexcodec.cpp
+// https://github.com/zeux/meshoptimizer/blob/master/src/indexcodec.cpp
+// https://github.com/zeux/meshoptimizer/blob/master/src/vertexfilter.cpp
+
+namespace
+{
+
+namespace VertexCodec
+{
+
+constexpr Uint8  Header            = 0xa0;
+constexpr size_t ByteGroupSize     = 16;
+constexpr size_t ByteGroupMaxBytes = 24; // The maximum number of bytes a single group may read
+constexpr size_t BlockMaxSize      = 256;
+constexpr size_t BlockSizeBytes    = 8192;
+constexpr size_t TailMinSize       = 32;
+
+size_t GetVertexBlockSize(size_t VertexSize)
+{
+    // Make sure the entire block fits into the scratch buffer
+    size_t BlockSize = BlockSizeBytes / VertexSize;
+    // Align to the byte group size
+    BlockSize &= ~(ByteGroupSize - 1);
+    return std::min(BlockSize, BlockMaxSize);
+}
+
+inline Uint8 UnZigZag8(Uint8 v)
+{
+    return static_cast<Uint8>(-(v & 1) ^ (v >> 1));
+}
+
+template <Uint32 Bits>
+const Uint8* DecodeBytesGroupBits(const Uint8* pData, Uint8* pDst)
+{
+    constexpr Uint32 ValuesPerByte = 8 / Bits;
+    constexpr Uint32 Sentinel      = (1u << Bits) - 1u;
+
+    // Packed values are followed by the values that did not fit into Bits
+    const Uint8* pExtra = pData + ByteGroupSize / ValuesPerByte;
+    for (size_t i = 0; i < ByteGroupSize / ValuesPerByte; ++i)
+    {
+        Uint32 Byte = pData[i];
+        for (Uint32 j = 0; j < ValuesPerByte; ++j)
+        {
+            const Uint32 Enc = (Byte >> (8 - Bits)) & Sentinel;
+            Byte <<= Bits;
+            if (Enc == Sentinel)
+                *pDst++ = *pExtra++;
+            else
+                *pDst++ = static_cast<Uint8>(Enc);
+        }
+    }
+    return pExtra;
+}
+
+const Uint8* DecodeBytesGroup(const Uint8* pData, Uint8* pDst, Uint32 BitsLog2)
+{
+    switch (BitsLog2)
+    {
+        case 0:
+            memset(pDst, 0, ByteGroupSize);
+            return pData;
+
+        case 1:
+            return DecodeBytesGroupBits<2>(pData, pDst);
+
+        case 2:
+            return DecodeBytesGroupBits<4>(pData, pDst);
+
+        case 3:
+            memcpy(pDst, pData, ByteGroupSize);
+            return pData + ByteGroupSize;
+
+        default:
+            UNEXPECTED("Bits log2 must be in 0..3 range");
+            return nullptr;
+    }
+}
+
+const Uint8* DecodeBytes(const Uint8* pData, const Uint8* pDataEnd, Uint8* pDst, size_t DstSize)
+{
+    VERIFY_EXPR(DstSize % ByteGroupSize == 0);
+
+    const Uint8* pHeader = pData;
+
+    // Each group uses 2 bits in the header
+    const size_t HeaderSize = (DstSize / ByteGroupSize + 3) / 4;
+    if (static_cast<size_t>(pDataEnd - pData) < HeaderSize)
+        return nullptr;
+
+    pData += HeaderSize;
+
+    for (size_t i = 0; i < DstSize; i += ByteGroupSize)
+    {
+        // The tail padding guarantees that a valid stream always has enough data for the group
+        if (static_cast<size_t>(pDataEnd - pData) < ByteGroupMaxBytes)
+            return nullptr;
+
+        const size_t GroupIdx = i / ByteGroupSize;
+        const Uint32 BitsLog2 = (pHeader[GroupIdx / 4] >> ((GroupIdx % 4) * 2)) & 3;
+
+        pData = DecodeBytesGroup(pData, pDst + i, BitsLog2);
+    }
+
+    return pData;
+}
+
+const Uint8* DecodeVertexBlock(const Uint8* pData,
+                               const Uint8* pDataEnd,
+                               Uint8*       pDst,
+                               size_t       VertexCount,
+                               size_t       VertexSize,
+                               Uint8        LastVertex[256])
+{
+    VERIFY_EXPR(VertexCount > 0 && VertexCount <= BlockMaxSize);
+
+    Uint8 Deltas[BlockMaxSize];
+    Uint8 Transposed[BlockSizeBytes];
+
+    const size_t AlignedVertexCount = (VertexCount + ByteGroupSize - 1) & ~(ByteGroupSize - 1);
+
+    // Each byte of the vertex is stored as a separate stream of deltas
+    for (size_t k = 0; k < VertexSize; ++k)
+    {
+        pData = DecodeBytes(pData, pDataEnd, Deltas, AlignedVertexCount);
+        if (pData == nullptr)
+            return nullptr;
+
+        Uint8  Prev   = LastVertex[k];
+        size_t Offset = k;
+        for (size_t i = 0; i < VertexCount; ++i)
+        {
+            const Uint8 v = static_cast<Uint8>(UnZigZag8(Deltas[i]) + Prev);
+
+            Transposed[Offset] = v;
+            Prev               = v;
+            Offset += VertexSize;
+        }
+    }
+
+    memcpy(pDst, Transposed, VertexCount * VertexSize);
+    memcpy(LastVertex, &Transposed[VertexSize * (VertexCount - 1)], VertexSize);
+
+    return pData;
+}
+
+bool DecodeVertexBuffer(Uint8* pDst, size_t VertexCount, size_t VertexSize, const Uint8* pSrc, size_t SrcSize)
+{
+    if (VertexSize == 0 || VertexSize > 256 || VertexSize % 4 != 0)
+        return false;
+
+    const Uint8* pData    = pSrc;
+    const Uint8* pDataEnd = pSrc + SrcSize;
+
+    if (SrcSize < 1 + VertexSize)
+        return false;
+
+    const Uint8 DataHeader = *pData++;
+    if ((DataHeader & 0xf0) != Header)
+        return false;
+
+    const Uint32 Version = DataHeader & 0x0f;
+    if (Version > 0)
+        return false;
+
+    // The tail stores the initial values of the first vertex
+    Uint8 LastVertex[256];
+    memcpy(LastVertex, pDataEnd - VertexSize, VertexSize);
+
+    const size_t BlockSize = GetVertexBlockSize(VertexSize);
+    for (size_t VertexOffset = 0; VertexOffset < VertexCount;)
+    {
+        const size_t NumVerts = std::min(BlockSize, VertexCount - VertexOffset);
+
+        pData = DecodeVertexBlock(pData, pDataEnd, pDst + VertexOffset * VertexSize, NumVerts, VertexSize, LastVertex);
+        if (pData == nullptr)
+            return false;
+
+        VertexOffset += NumVerts;
+    }
+
+    const size_t TailSize = std::max(VertexSize, TailMinSize);
+    return static_cast<size_t>(pDataEnd - pData) == TailSize;
+}
+
+} // namespace VertexCodec
+
+
+namespace IndexCodec
+{
+
+constexpr Uint8 TrianglesHeader = 0xe0;
+constexpr Uint8 SequenceHeader  = 0xd0;
+
+inline Uint32 DecodeVByte(const Uint8*& pData)
+{
+    const Uint8 Lead = *pData++;
+
+    // Fast path: single byte
+    if (Lead < 128)
+        return Lead;
+
+    // Slow path: up to 4 extra bytes.
+    // The loop always terminates, which is important for malformed data.
+    Uint32 Result = Lead & 127;
+    Uint32 Shift  = 7;
+    for (int i = 0; i < 4; ++i)
+    {
+        const Uint8 Group = *pData++;
+        Result |= Uint32{Group & 127u} << Shift;
+        Shift += 7;
+
+        if (Group < 128)
+            break;
+    }
+
+    return Result;
+}
+
+inline Uint32 DecodeIndex(const Uint8*& pData, Uint32 Last)
+{
+    const Uint32 v = DecodeVByte(pData);
+    const Uint32 d = (v >> 1) ^ (0u - (v & 1u));
+    return Last + d;
+}
+
+class TriangleDecoder
+{
+public:
+    TriangleDecoder(void* pDst, size_t IndexSize) :
+        m_pDst{pDst},
+        m_IndexSize{IndexSize}
+    {
+        memset(m_EdgeFifo, 0xFF, sizeof(m_EdgeFifo));
+        memset(m_VertexFifo, 0xFF, sizeof(m_VertexFifo));
+    }
+
+    void WriteTriangle(size_t Offset, Uint32 a, Uint32 b, Uint32 c)
+    {
+        if (m_IndexSize == 2)
+        {
+            auto* pDst = static_cast<Uint16*>(m_pDst) + Offset;
+
+            pDst[0] = static_cast<Uint16>(a);
+            pDst[1] = static_cast<Uint16>(b);
+            pDst[2] = static_cast<Uint16>(c);
+        }
+        else
+        {
+            auto* pDst = static_cast<Uint32*>(m_pDst) + Offset;
+
+            pDst[0] = a;
+            pDst[1] = b;
+            pDst[2] = c;
+        }
+    }
+
+    // Fifo pushes must exactly match the encoder, otherwise the data will not be decoded correctly
+    void PushEdge(Uint32 a, Uint32 b)
+    {
+        m_EdgeFifo[m_EdgeFifoOffset][0] = a;
+        m_EdgeFifo[m_EdgeFifoOffset][1] = b;
+        m_EdgeFifoOffset                = (m_EdgeFifoOffset + 1) & 15;
+    }
+
+    void PushVertex(Uint32 v, bool Cond = true)
+    {
+        m_VertexFifo[m_VertexFifoOffset] = v;
+        m_VertexFifoOffset               = (m_VertexFifoOffset + (Cond ? 1 : 0)) & 15;
+    }
+
+    // Fifo reads are wrapped around 16 entry buffer
+    const Uint32* GetEdge(size_t Idx) const { return m_EdgeFifo[(m_EdgeFifoOffset - 1 - Idx) & 15]; }
+    Uint32        GetVertex(size_t Idx) const { return m_VertexFifo[(m_VertexFifoOffset - Idx) & 15]; }
+
+private:
+    void* const  m_pDst;
+    const size_t m_IndexSize;
+
+    Uint32 m_EdgeFifo[16][2];
+    Uint32 m_VertexFifo[16];
+    size_t m_EdgeFifoOffset   = 0;
+    size_t m_VertexFifoOffset = 0;
+};
+
+bool DecodeTriangles(void* pDst, size_t IndexCount, size_t IndexSize, const Uint8* pSrc, size_t SrcSize)
+{
+    if (IndexCount % 3 != 0 || (IndexSize != 2 && IndexSize != 4))
+        return false;
+
+    // The minimum valid encoding is the header, 1 byte per triangle and a 16-byte codeaux table
+    if (SrcSize < 1 + IndexCount / 3 + 16)
+        return false;
+
+    if ((pSrc[0] & 0xf0) != TrianglesHeader)
+        return false;
+
+    const Uint32 Version = pSrc[0] & 0x0f;
+    if (Version > 1)
+        return false;
+
+    TriangleDecoder Decoder{pDst, IndexSize};
+
+    Uint32 Next = 0;
+    Uint32 Last = 0;
+
+    const Uint32 FecMax = Version >= 1 ? 13 : 15;
+
+    // The 16-byte codeaux table is stored at the end, so triangle data must end before it
+    const Uint8* pCode         = pSrc + 1;
+    const Uint8* pData         = pCode + IndexCount / 3;
+    const Uint8* pDataSafeEnd  = pSrc + SrcSize - 16;
+    const Uint8* pCodeAuxTable = pDataSafeEnd;
+
+    for (size_t i = 0; i < IndexCount; i += 3)
+    {
+        // Each triangle reads at most 16 bytes of data: 1 byte for codeaux and 5 bytes for
+        // each free index. The codeaux table guarantees that we can read that much without
+        // extra bounds checks.
+        if (pData > pDataSafeEnd)
+            return false;
+
+        const Uint8 CodeTri = *pCode++;
+        if (CodeTri < 0xf0)
+        {
+            const Uint32  fe   = CodeTri >> 4;
+            const Uint32* Edge = Decoder.GetEdge(fe);
+            const Uint32  a    = Edge[0];
+            const Uint32  b    = Edge[1];
+
+            const Uint32 fec = CodeTri & 15;
+            if (fec < FecMax)
+            {
+                const bool   fec0 = (fec == 0);
+                const Uint32 c    = fec0 ? Next : Decoder.GetVertex(1 + fec);
+                Next += fec0 ? 1 : 0;
+
+                Decoder.WriteTriangle(i, a, b, c);
+
+                Decoder.PushVertex(c, fec0);
+                Decoder.PushEdge(c, b);
+                Decoder.PushEdge(a, c);
+            }
+            else
+            {
+                // fec - (fec ^ 3) decodes 13, 14 into -1, 1.
+                // Free indices are delta-encoded, so the last index needs to be updated.
+                const Uint32 c = (fec != 15) ?
+                    Last + static_cast<Uint32>(static_cast<int>(fec) - static_cast<int>(fec ^ 3)) :
+                    DecodeIndex(pData, Last);
+                Last = c;
+
+                Decoder.WriteTriangle(i, a, b, c);
+
+                Decoder.PushVertex(c);
+                Decoder.PushEdge(c, b);
+                Decoder.PushEdge(a, c);
+            }
+        }
+        else if (CodeTri < 0xfe)
+        {
+            // Fast path: read codeaux from the table.
+            // Note that the table can't contain feb/fec=15.
+            const Uint8  CodeAux = pCodeAuxTable[CodeTri & 15];
+            const Uint32 feb     = CodeAux >> 4;
+            const Uint32 fec     = CodeAux & 15;
+
+            // Next is incremented for all three vertices before decoding indices to match the encoder
+            const Uint32 a = Next++;
+
+            const bool   feb0 = (feb == 0);
+            const Uint32 b    = feb0 ? Next : Decoder.GetVertex(feb);
+            Next += feb0 ? 1 : 0;
+
+            const bool   fec0 = (fec == 0);
+            const Uint32 c    = fec0 ? Next : Decoder.GetVertex(fec);
+            Next += fec0 ? 1 : 0;
+
+            Decoder.WriteTriangle(i, a, b, c);
+
+            Decoder.PushVertex(a);
+            Decoder.PushVertex(b, feb0);
+            Decoder.PushVertex(c, fec0);
+
+            Decoder.PushEdge(b, a);
+            Decoder.PushEdge(c, b);
+            Decoder.PushEdge(a, c);
+        }
+        else
+        {
+            // Slow path: read a full byte for codeaux instead of using the table
+            const Uint8 CodeAux = *pData++;
+
+            const Uint32 fea = CodeTri == 0xfe ? 0 : 15;
+            const Uint32 feb = CodeAux >> 4;
+            const Uint32 fec = CodeAux & 15;
+
+            // Reset: codeaux is 0 but encoded as not-a-table
+            if (CodeAux == 0)
+                Next = 0;
+
+            Uint32 a = (fea == 0) ? Next++ : 0;
+            Uint32 b = (feb == 0) ? Next++ : Decoder.GetVertex(feb);
+            Uint32 c = (fec == 0) ? Next++ : Decoder.GetVertex(fec);
+
+            if (fea == 15)
+                Last = a = DecodeIndex(pData, Last);
+
+            if (feb == 15)
+                Last = b = DecodeIndex(pData, Last);
+
+            if (fec == 15)
+                Last = c = DecodeIndex(pData, Last);
+
+            Decoder.WriteTriangle(i, a, b, c);
+
+            Decoder.PushVertex(a);
+            Decoder.PushVertex(b, feb == 0 || feb == 15);
+            Decoder.PushVertex(c, fec == 0 || fec == 15);
+
+            Decoder.PushEdge(b, a);
+            Decoder.PushEdge(c, b);
+            Decoder.PushEdge(a, c);
+        }
+    }
+
+    // All data bytes must have been read up to the codeaux table
+    return pData == pDataSafeEnd;
+}
+
+bool DecodeSequence(void* pDst, size_t IndexCount, size_t IndexSize, const Uint8* pSrc, size_t SrcSize)
+{
+    if (IndexSize != 2 && IndexSize != 4)
+        return false;
+
+    // The minimum valid encoding is the header, 1 byte per index and a 4-byte tail
+    if (SrcSize < 1 + IndexCount + 4)
+        return false;
+
+    if ((pSrc[0] & 0xf0) != SequenceHeader)
+        return false;
+
+    const Uint32 Version = pSrc[0] & 0x0f;
+    if (Version > 1)
+        return false;
+
+    const Uint8* pData        = pSrc + 1;
+    const Uint8* pDataSafeEnd = pSrc + SrcSize - 4;
+
+    Uint32 Last[2] = {};
+    for (size_t i = 0; i < IndexCount; ++i)
+    {
+        // Each index reads at most 5 bytes; the 4-byte tail makes the read safe
+        if (pData >= pDataSafeEnd)
+            return false;
+
+        Uint32 v = DecodeVByte(pData);
+
+        // The lowest bit selects one of the two baselines
+        const Uint32 Baseline = v & 1;
+        v >>= 1;
+
+        const Uint32 d     = (v >> 1) ^ (0u - (v & 1u));
+        const Uint32 Index = Last[Baseline] + d;
+        Last[Baseline]     = Index;
+
+        if (IndexSize == 2)
+            static_cast<Uint16*>(pDst)[i] = static_cast<Uint16>(Index);
+        else
+            static_cast<Uint32*>(pDst)[i] = Index;
+    }
+
+    // All data bytes must have been read up to the tail
+    return pData == pDataSafeEnd;
+}
+
+} // namespace IndexCodec
+
+
+namespace Filters
+{
+
+inline int RoundToInt(float f)
+{
+    return static_cast<int>(f + (f >= 0.f ? 0.5f : -0.5f));
+}
+
+template <typename T>
+void DecodeOctahedral(T* pData, size_t Count)
+{
+    const float MaxVal = static_cast<float>((1 << (sizeof(T) * 8 - 1)) - 1);
+
+    for (size_t i = 0; i < Count; ++i)
+    {
+        T* v = pData + i * 4;
+
+        // Convert x and y to floats and reconstruct z; this assumes z encodes 1.f at the same bit count
+        float x = static_cast<float>(v[0]);
+        float y = static_cast<float>(v[1]);
+        float z = static_cast<float>(v[2]) - std::abs(x) - std::abs(y);
+
+        // Fixup octahedral coordinates for z < 0
+        const float t = (z >= 0.f) ? 0.f : z;
+
+        x += (x >= 0.f) ? t : -t;
+        y += (y >= 0.f) ? t : -t;
+
+        const float l = std::sqrt(x * x + y * y + z * z);
+        const float s = MaxVal / l;
+
+        // The fourth component is left unchanged
+        v[0] = static_cast<T>(RoundToInt(x * s));
+        v[1] = static_cast<T>(RoundToInt(y * s));
+        v[2] = static_cast<T>(RoundToInt(z * s));
+    }
+}
+
+void DecodeQuaternion(Int16* pData, size_t Count)
+{
+    const float Scale = 1.f / std::sqrt(2.f);
+
+    for (size_t i = 0; i < Count; ++i)
+    {
+        Int16* q = pData + i * 4;
+
+        // Recover the scale from the high bits of the fourth component
+        const int   sf = q[3] | 3;
+        const float ss = Scale / static_cast<float>(sf);
+
+        // Convert x/y/z to [-1..1] range
+        const float x = static_cast<float>(q[0]) * ss;
+        const float y = static_cast<float>(q[1]) * ss;
+        const float z = static_cast<float>(q[2]) * ss;
+
+        // Reconstruct w; clamp to 0 to avoid NaN due to precision errors
+        const float ww = 1.f - x * x - y * y - z * z;
+        const float w  = std::sqrt(ww >= 0.f ? ww : 0.f);
+
+        const int xf = RoundToInt(x * 32767.f);
+        const int yf = RoundToInt(y * 32767.f);
+        const int zf = RoundToInt(z * 32767.f);
+        const int wf = static_cast<int>(w * 32767.f + 0.5f);
+
+        // The two lowest bits store the index of the largest component
+        const int qc = q[3] & 3;
+
+        q[(qc + 1) & 3] = static_cast<Int16>(xf);
+        q[(qc + 2) & 3] = static_cast<Int16>(yf);
+        q[(qc + 3) & 3] = static_cast<Int16>(zf);
+        q[(qc + 0) & 3] = static_cast<Int16>(wf);
+    }
+}
+
+void DecodeExponential(Uint32* pData, size_t Count)
+{
+    for (size_t i = 0; i < Count; ++i)
+    {
+        const Uint32 v = pData[i];
+
+        // 24-bit signed mantissa and 8-bit signed exponent
+        const int m = static_cast<Int32>(v << 8) >> 8;
+        const int e = static_cast<Int32>(v) >> 24;
+
+        // Equivalent to ldexp(float(m), e)
+        const Uint32 ScaleBits = static_cast<Uint32>(e + 127) << 23;
+
+        float Scale;
+        memcpy(&Scale, &ScaleBits, sizeof(Scale));
+        const float f = Scale * static_cast<float>(m);
+        memcpy(&pData[i], &f, sizeof(f));
+    }
+}
+
+bool Apply(MESHOPT_COMPRESSION_FILTER Filter, void* pData, size_t Count, size_t ByteStride)
+{
+    switch (Filter)
+    {
+        case MESHOPT_COMPRESSION_FILTER_NONE:
+            return true;
+
+        case MESHOPT_COMPRESSION_FILTER_OCTAHEDRAL:
+            if (ByteStride == 4)
+                DecodeOctahedral(static_cast<Int8*>(pData), Count);
+            else if (ByteStride == 8)
+                DecodeOctahedral(static_cast<Int16*>(pData), Count);
+            else
+                return false;
+            return true;
+
+        case MESHOPT_COMPRESSION_FILTER_QUATERNION:
+            if (ByteStride != 8)
+                return false;
+            DecodeQuaternion(static_cast<Int16*>(pData), Count);
+            return true;
+
+        case MESHOPT_COMPRESSION_FILTER_EXPONENTIAL:
+            if (ByteStride % 4 != 0)
+                return false;
+            DecodeExponential(static_cast<Uint32*>(pData), Count * ByteStride / 4);
+            return true;
+
+        default:
+            UNEXPECTED("Unexpected meshopt filter");
+            return false;
+    }
+}
+
+} // namespace Filters
+
+} // namespace
+
+
+bool DecodeMeshoptBufferView(const MeshoptBufferViewDesc& Desc,
+                             const void*                  pSrc,
+                             size_t                       SrcSize,
+                             void*                        pDst)
+{
+    DEV_CHECK_ERR(pSrc != nullptr || SrcSize == 0, "Source data must not be null");
+    DEV_CHECK_ERR(pDst != nullptr || Desc.Count == 0, "Destination must not be null");
+
+    const auto* pSrcBytes = static_cast<const Uint8*>(pSrc);
+    switch (Desc.Mode)
+    {
+        case MESHOPT_COMPRESSION_MODE_ATTRIBUTES:
+            if (!VertexCodec::DecodeVertexBuffer(static_cast<Uint8*>(pDst), Desc.Count, Desc.ByteStride, pSrcBytes, SrcSize))
+                return false;
+            return Filters::Apply(Desc.Filter, pDst, Desc.Count, Desc.ByteStride);
+
+        case MESHOPT_COMPRESSION_MODE_TRIANGLES:
+            if (Desc.Filter != MESHOPT_COMPRESSION_FILTER_NONE)
+                return false;
+            return IndexCodec::DecodeTriangles(pDst, Desc.Count, Desc.ByteStride, pSrcBytes, SrcSize);
+
+        case MESHOPT_COMPRESSION_MODE_INDICES:
+            if (Desc.Filter != MESHOPT_COMPRESSION_FILTER_NONE)
+                return false;
+            return IndexCodec::DecodeSequence(pDst, Desc.Count, Desc.ByteStride, pSrcBytes, SrcSize);
+
+        default:
+            UNEXPECTED("Unexpected meshopt compression mode");
+            return false;
+    }
+}
+
+} // namespace GLTF
+
+} // namespace Diligent
@@ -651,6 +651,36 @@ VertexPoolUsageStats ResourceManager::GetVertexPoolUsageStats(const VertexLayout
     return Stats;
 }
 
+ResourceManagerMemoryUsage ResourceManager::GetMemoryUsage()
+{
+    ResourceManagerMemoryUsage Usage;
+
+    {
+        const auto IndexStats          = GetIndexBufferUsageStats();
+        Usage.IndexBuffers.GPUReserved = IndexStats.CommittedSize;
+        Usage.IndexBuffers.GPUUsed     = IndexStats.UsedSize;
+    }
+
+    {
+        const auto PoolStats          = GetVertexPoolUsageStats();
+        Usage.VertexPools.GPUReserved = PoolStats.CommittedMemorySize;
+        Usage.VertexPools.GPUUsed     = PoolStats.UsedMemorySize;
+    }
+
+    {
+        const auto AtlasStats            = GetAtlasUsageStats();
+        Usage.TextureAtlases.GPUReserved = AtlasStats.CommittedSize;
+        if (AtlasStats.TotalArea > 0)
+        {
+            // Atlas memory is distributed uniformly over the atlas area
+            Usage.TextureAtlases.GPUUsed = static_cast<Uint64>(static_cast<double>(AtlasStats.CommittedSize) * static_cast<double>(AtlasStats.UsedArea) / static_cast<double>(AtlasStats.TotalArea));
+            Usage.TextureAtlases.GPUUsed = std::min(Usage.TextureAtlases.GPUUsed, Usage.TextureAtlases.GPUReserved);
+        }
+    }
+
+    return Usage;
+}
+
 void ResourceManager::TransitionResourceStates(IRenderDevice* pDevice, IDeviceContext* pContext, const TransitionResourceStatesInfo& Info)
 {
     m_Barriers.clear();
@@ -0,0 +1,162 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "GLTFUploadScheduler.hpp"
+
+#include <algorithm>
+
+#include "DebugUtilities.hpp"
+#include "Timer.hpp"
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+UploadScheduler::GroupId UploadScheduler::AddGroup(std::vector<WorkItem> Items, float Priority)
+{
+    if (Items.empty())
+        return InvalidGroupId;
+
+    Group NewGroup;
+    NewGroup.Id       = m_NextGroupId++;
+    NewGroup.Priority = Priority;
+    NewGroup.Items    = std::move(Items);
+    for (const auto& Item : NewGroup.Items)
+    {
+        DEV_CHECK_ERR(Item.Func, "Work item function must not be null");
+        NewGroup.PendingBytes += Item.Size;
+    }
+
+    m_Groups.emplace_back(std::move(NewGroup));
+    return m_Groups.back().Id;
+}
+
+const UploadScheduler::Group* UploadScheduler::FindGroup(GroupId Id) const
+{
+    auto it = std::find_if(m_Groups.begin(), m_Groups.end(), [Id](const Group& G) { return G.Id == Id; });
+    return it != m_Groups.end() ? &*it : nullptr;
+}
+
+void UploadScheduler::SetPriority(GroupId Id, float Priority)
+{
+    if (auto* pGroup = FindGroup(Id))
+        pGroup->Priority = Priority;
+}
+
+void UploadScheduler::RemoveGroup(GroupId Id)
+{
+    m_Groups.erase(std::remove_if(m_Groups.begin(), m_Groups.end(), [Id](const Group& G) { return G.Id == Id; }), m_Groups.end());
+}
+
+bool UploadScheduler::IsGroupPending(GroupId Id) const
+{
+    return FindGroup(Id) != nullptr;
+}
+
+Uint64 UploadScheduler::GetPendingBytes(GroupId Id) const
+{
+    const auto* pGroup = FindGroup(Id);
+    return pGroup != nullptr ? pGroup->PendingBytes : 0;
+}
+
+UploadProgress UploadScheduler::Execute(IRenderDevice* pDevice, IDeviceContext* pCtx, const UploadBudget& Budget)
+{
+    Timer ExecTimer;
+
+    // Groups are ordered by priority, and then by the order they were added (ids increase monotonically).
+    // Priorities can't change while the items are executed, so the order is computed once.
+    std::vector<Group*> Order;
+    Order.reserve(m_Groups.size());
+    for (auto& G : m_Groups)
+        Order.push_back(&G);
+    std::sort(Order.begin(), Order.end(), [](const Group* pLHS, const Group* pRHS) {
+        return pLHS->Priority != pRHS->Priority ?
+            pLHS->Priority > pRHS->Priority :
+            pLHS->Id < pRHS->Id;
+    });
+
+    UploadProgress Progress;
+
+    bool BudgetExhausted = false;
+    for (auto* pGroup : Order)
+    {
+        while (pGroup->NextItem < pGroup->Items.size())
+        {
+            auto& Item = pGroup->Items[pGroup->NextItem];
+            if (Budget.MaxBytes != 0 && Item.Size > 0 && Progress.ExecutedItems > 0 && Progress.ExecutedBytes + Item.Size > Budget.MaxBytes)
+            {
+                BudgetExhausted = true;
+                break;
+            }
+
+            Item.Func(pDevice, pCtx);
+            // Release the resources held by the function, e.g. the initialization data
+            Item.Func = nullptr;
+
+            ++pGroup->NextItem;
+            pGroup->PendingBytes -= Item.Size;
+            ++Progress.ExecutedItems;
+            Progress.ExecutedBytes += Item.Size;
+
+            if (Budget.MaxTime != 0 && ExecTimer.GetElapsedTime() >= Budget.MaxTime)
+            {
+                BudgetExhausted = true;
+                break;
+            }
+        }
+
+        if (pGroup->NextItem == pGroup->Items.size())
+            ++Progress.CompletedGroups;
+
+        if (BudgetExhausted)
+            break;
+    }
+
+    m_Groups.erase(std::remove_if(m_Groups.begin(), m_Groups.end(), [](const Group& G) { return G.NextItem == G.Items.size(); }), m_Groups.end());
+
+    const auto Pending    = GetProgress();
+    Progress.PendingItems = Pending.PendingItems;
+    Progress.PendingBytes = Pending.PendingBytes;
+    return Progress;
+}
+
+UploadProgress UploadScheduler::GetProgress() const
+{
+    UploadProgress Progress;
+    for (const auto& G : m_Groups)
+    {
+        Progress.PendingItems += static_cast<Uint32>(G.Items.size() - G.NextItem);
+        Progress.PendingBytes += G.PendingBytes;
+    }
+    return Progress;
+}
+
+} // namespace GLTF
+
+} // namespace Diligent
@@ -0,0 +1,1427 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "GLTFWriter.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <cctype>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <algorithm>
+
+#include "GraphicsAccessories.hpp"
+#include "Align.hpp"
+
+// Must match the definitions in GLTFLoader.cpp where tinygltf is implemented:
+// the image writer is not compiled in and images are written by the model writer.
+#define TINYGLTF_NO_STB_IMAGE
+#define TINYGLTF_NO_STB_IMAGE_WRITE
+#include "../../ThirdParty/tinygltf/tiny_gltf.h"
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+namespace
+{
+
+bool IsStandardAttributeName(const std::string& Name)
+{
+    if (Name == "POSITION" || Name == "NORMAL" || Name == "TANGENT")
+        return true;
+
+    for (const char* Prefix : {"TEXCOORD_", "COLOR_", "JOINTS_", "WEIGHTS_"})
+    {
+        if (Name.compare(0, strlen(Prefix), Prefix) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+template <typename T>
+T ReadUnaligned(const Uint8* pSrc)
+{
+    T Val;
+    memcpy(&Val, pSrc, sizeof(T));
+    return Val;
+}
+
+// Reads the vertex attribute component as float. 8-bit components are normalized,
+// see VertexAttributesToInputLayout().
+float ReadComponent(const Uint8* pSrc, VALUE_TYPE ValueType)
+{
+    switch (ValueType)
+    {
+        // clang-format off
+        case VT_FLOAT32: return ReadUnaligned<Float32>(pSrc);
+        case VT_UINT8:   return static_cast<float>(ReadUnaligned<Uint8>(pSrc)) / 255.f;
+        case VT_INT8:    return std::max(static_cast<float>(ReadUnaligned<Int8>(pSrc)) / 127.f, -1.f);
+        case VT_UINT16:  return static_cast<float>(ReadUnaligned<Uint16>(pSrc));
+        case VT_INT16:   return static_cast<float>(ReadUnaligned<Int16>(pSrc));
+        case VT_UINT32:  return static_cast<float>(ReadUnaligned<Uint32>(pSrc));
+        case VT_INT32:   return static_cast<float>(ReadUnaligned<Int32>(pSrc));
+        // clang-format on
+        default:
+            UNEXPECTED("Unexpected vertex attribute value type");
+            return 0;
+    }
+}
+
+float HalfToFloat(Uint16 Half)
+{
+    const Uint32 Sign     = Uint32{Half & 0x8000u} << 16u;
+    Uint32       Exponent = (Half >> 10u) & 0x1Fu;
+    Uint32       Mantissa = Half & 0x3FFu;
+
+    Uint32 Bits = 0;
+    if (Exponent == 0x1F)
+    {
+        // Infinity or NaN
+        Bits = Sign | 0x7F800000u | (Mantissa << 13u);
+    }
+    else if (Exponent != 0)
+    {
+        Bits = Sign | ((Exponent + 112u) << 23u) | (Mantissa << 13u);
+    }
+    else if (Mantissa != 0)
+    {
+        // Denormalized half - renormalize it
+        Exponent = 113;
+        while ((Mantissa & 0x400u) == 0)
+        {
+            Mantissa <<= 1u;
+            --Exponent;
+        }
+        Bits = Sign | (Exponent << 23u) | ((Mantissa & 0x3FFu) << 13u);
+    }
+    else
+    {
+        Bits = Sign;
+    }
+
+    float Val;
+    memcpy(&Val, &Bits, sizeof(Val));
+    return Val;
+}
+
+// Returns true if the texture data in this format can be converted to RGBA8 with ConvertToRGBA8().
+bool IsConvertibleToRGBA8(const TextureFormatAttribs& FmtAttribs)
+{
+    if (FmtAttribs.NumComponents < 1 || FmtAttribs.NumComponents > 4)
+        return false;
+
+    switch (FmtAttribs.ComponentType)
+    {
+        case COMPONENT_TYPE_UNORM:
+        case COMPONENT_TYPE_UNORM_SRGB:
+            return FmtAttribs.ComponentSize == 1 || FmtAttribs.ComponentSize == 2;
+
+        case COMPONENT_TYPE_FLOAT:
+            return FmtAttribs.ComponentSize == 2 || FmtAttribs.ComponentSize == 4;
+
+        default:
+            return false;
+    }
+}
+
+// Converts 8- and 16-bit unorm as well as 16- and 32-bit float texture data to RGBA8.
+// Float values are clamped to [0, 1]. Missing color components are set to zero,
+// and missing alpha is set to one, so that every component keeps its glTF meaning.
+std::vector<Uint8> ConvertToRGBA8(const Uint8* pData, size_t Stride, Uint32 Width, Uint32 Height, const TextureFormatAttribs& FmtAttribs)
+{
+    VERIFY_EXPR(IsConvertibleToRGBA8(FmtAttribs));
+
+    const Uint32 NumComponents = FmtAttribs.NumComponents;
+    const Uint32 ComponentSize = FmtAttribs.ComponentSize;
+    const bool   IsFloat       = FmtAttribs.ComponentType == COMPONENT_TYPE_FLOAT;
+
+    std::vector<Uint8> RGBAData(size_t{Width} * Height * 4);
+    for (Uint32 y = 0; y < Height; ++y)
+    {
+        const Uint8* pSrcRow = pData + y * Stride;
+        Uint8*       pDstRow = &RGBAData[size_t{y} * Width * 4];
+        for (Uint32 x = 0; x < Width; ++x)
+        {
+            Uint8* pDst = pDstRow + x * 4;
+            pDst[0] = pDst[1] = pDst[2] = 0;
+            pDst[3]                     = 255;
+            for (Uint32 c = 0; c < NumComponents; ++c)
+            {
+                const Uint8* pSrc = pSrcRow + (x * NumComponents + c) * ComponentSize;
+
+                float Val = 0;
+                if (IsFloat)
+                    Val = ComponentSize == 2 ? HalfToFloat(ReadUnaligned<Uint16>(pSrc)) : ReadUnaligned<float>(pSrc);
+                else
+                    Val = ComponentSize == 1 ? static_cast<float>(*pSrc) / 255.f : static_cast<float>(ReadUnaligned<Uint16>(pSrc)) / 65535.f;
+
+                // NaNs are converted to zero
+                Val     = Val > 0.f ? std::min(Val, 1.f) : 0.f;
+                pDst[c] = static_cast<Uint8>(Val * 255.f + 0.5f);
+            }
+        }
+    }
+
+    return RGBAData;
+}
+
+int GetGltfType(Uint32 NumComponents)
+{
+    switch (NumComponents)
+    {
+        // clang-format off
+        case 1: return TINYGLTF_TYPE_SCALAR;
+        case 2: return TINYGLTF_TYPE_VEC2;
+        case 3: return TINYGLTF_TYPE_VEC3;
+        case 4: return TINYGLTF_TYPE_VEC4;
+        // clang-format on
+        default:
+            UNEXPECTED("Unexpected number of components");
+            return TINYGLTF_TYPE_SCALAR;
+    }
+}
+
+// Inverse of ModelBuilder::GetFilterType()
+int GetGltfMinFilter(FILTER_TYPE MinFilter, FILTER_TYPE MipFilter)
+{
+    const bool PointMin = MinFilter == FILTER_TYPE_POINT;
+    const bool PointMip = MipFilter == FILTER_TYPE_POINT;
+    if (PointMin)
+        return PointMip ? TINYGLTF_TEXTURE_FILTER_NEAREST_MIPMAP_NEAREST : TINYGLTF_TEXTURE_FILTER_NEAREST_MIPMAP_LINEAR;
+    else
+        return PointMip ? TINYGLTF_TEXTURE_FILTER_LINEAR_MIPMAP_NEAREST : TINYGLTF_TEXTURE_FILTER_LINEAR_MIPMAP_LINEAR;
+}
+
+// Inverse of ModelBuilder::GetAddressMode()
+int GetGltfWrapMode(TEXTURE_ADDRESS_MODE AddressMode)
+{
+    switch (AddressMode)
+    {
+        // clang-format off
+        case TEXTURE_ADDRESS_WRAP:   return TINYGLTF_TEXTURE_WRAP_REPEAT;
+        case TEXTURE_ADDRESS_CLAMP:  return TINYGLTF_TEXTURE_WRAP_CLAMP_TO_EDGE;
+        case TEXTURE_ADDRESS_MIRROR: return TINYGLTF_TEXTURE_WRAP_MIRRORED_REPEAT;
+        // clang-format on
+        default:
+            LOG_WARNING_MESSAGE("Address mode ", GetTextureAddressModeLiteralName(AddressMode, false), " is not supported by glTF. Using REPEAT.");
+            return TINYGLTF_TEXTURE_WRAP_REPEAT;
+    }
+}
+
+// Decomposes the matrix computed by ComputeNodeLocalMatrix() into translation, rotation and scale.
+// The matrix must not contain shear.
+void DecomposeTransform(const float4x4& Matrix, float3& Translation, QuaternionF& Rotation, float3& Scale)
+{
+    Translation = float3{Matrix[3][0], Matrix[3][1], Matrix[3][2]};
+
+    float3 Rows[3];
+    for (int r = 0; r < 3; ++r)
+    {
+        Rows[r]  = float3{Matrix[r][0], Matrix[r][1], Matrix[r][2]};
+        Scale[r] = length(Rows[r]);
+        if (Scale[r] > 0)
+            Rows[r] /= Scale[r];
+    }
+    if (dot(cross(Rows[0], Rows[1]), Rows[2]) < 0)
+    {
+        Scale.x = -Scale.x;
+        Rows[0] = -Rows[0];
+    }
+
+    // Rows contain the transposed column-vector rotation matrix, see Quaternion::ToMatrix().
+    const auto R = [&Rows](int i, int j) {
+        return Rows[j][i];
+    };
+
+    float4&     q     = Rotation.q;
+    const float Trace = R(0, 0) + R(1, 1) + R(2, 2);
+    if (Trace > 0)
+    {
+        const float s = std::sqrt(Trace + 1.f) * 2.f;
+
+        q.w = 0.25f * s;
+        q.x = (R(2, 1) - R(1, 2)) / s;
+        q.y = (R(0, 2) - R(2, 0)) / s;
+        q.z = (R(1, 0) - R(0, 1)) / s;
+    }
+    else if (R(0, 0) > R(1, 1) && R(0, 0) > R(2, 2))
+    {
+        const float s = std::sqrt(1.f + R(0, 0) - R(1, 1) - R(2, 2)) * 2.f;
+
+        q.w = (R(2, 1) - R(1, 2)) / s;
+        q.x = 0.25f * s;
+        q.y = (R(0, 1) + R(1, 0)) / s;
+        q.z = (R(0, 2) + R(2, 0)) / s;
+    }
+    else if (R(1, 1) > R(2, 2))
+    {
+        const float s = std::sqrt(1.f + R(1, 1) - R(0, 0) - R(2, 2)) * 2.f;
+
+        q.w = (R(0, 2) - R(2, 0)) / s;
+        q.x = (R(0, 1) + R(1, 0)) / s;
+        q.y = 0.25f * s;
+        q.z = (R(1, 2) + R(2, 1)) / s;
+    }
+    else
+    {
+        const float s = std::sqrt(1.f + R(2, 2) - R(0, 0) - R(1, 1)) * 2.f;
+
+        q.w = (R(1, 0) - R(0, 1)) / s;
+        q.x = (R(0, 2) + R(2, 0)) / s;
+        q.y = (R(1, 2) + R(2, 1)) / s;
+        q.z = 0.25f * s;
+    }
+}
+
+template <typename VectorType>
+tinygltf::Value MakeNumberArray(const VectorType& Vec, size_t NumComponents)
+{
+    tinygltf::Value::Array Arr(NumComponents);
+    for (size_t i = 0; i < NumComponents; ++i)
+        Arr[i] = tinygltf::Value{static_cast<double>(Vec[i])};
+    return tinygltf::Value{std::move(Arr)};
+}
+
+template <typename VectorType>
+std::vector<double> MakeDoubleVector(const VectorType& Vec, size_t NumComponents)
+{
+    std::vector<double> Res(NumComponents);
+    for (size_t i = 0; i < NumComponents; ++i)
+        Res[i] = static_cast<double>(Vec[i]);
+    return Res;
+}
+
+} // namespace
+
+class ModelWriter
+{
+public:
+    ModelWriter(IRenderDevice*        pDevice,
+                IDeviceContext*       pContext,
+                const Model&          Model,
+                const ModelWriteInfo& WriteInfo) :
+        m_pDevice{pDevice},
+        m_pContext{pContext},
+        m_Model{Model},
+        m_WriteInfo{WriteInfo}
+    {}
+
+    bool Write();
+
+private:
+    std::vector<Uint8> ReadBufferData(IBuffer* pBuffer, Uint64 Offset, Uint64 Size) const;
+    void               ReadModelData();
+
+    RefCntAutoPtr<IDataBlob> EncodeTexture(Uint32 TextureId) const;
+
+    int AddBufferView(const void* pData, size_t Size, int Target);
+    int AddAccessor(const void* pData, size_t Count, int ComponentType, int Type, int Target = 0, bool Normalized = false);
+
+    int  GetSamplerId(ITexture* pTexture);
+    bool WriteTextures();
+
+    tinygltf::Value GetTextureTransform(const Material::TextureShaderAttribs& TexAttribs);
+
+    template <typename TextureInfoType>
+    bool InitTextureInfo(const Material& Mat, const char* Name, TextureInfoType& TexInfo);
+    void AddTextureInfo(const Material& Mat, const char* Name, tinygltf::Value::Object& Ext);
+    void AddMaterialExtension(tinygltf::Material& GltfMat, const char* ExtName, tinygltf::Value::Object&& Ext);
+    void WriteMaterials();
+
+    void WriteVertexAttributes(const Primitive& Prim, std::map<std::string, int>& Attributes);
+    int  WriteIndices(const Primitive& Prim);
+    void WriteMorphTargets(const Primitive& Prim, std::vector<std::map<std::string, int>>& Targets);
+    void WriteMeshes();
+
+    void WriteNodes();
+    void WriteScenes();
+    void WriteCameras();
+    void WriteLights();
+    void WriteSkins();
+    void WriteAnimations();
+
+private:
+    IRenderDevice* const  m_pDevice;
+    IDeviceContext* const m_pContext;
+    const Model&          m_Model;
+    const ModelWriteInfo& m_WriteInfo;
+
+    tinygltf::Model m_Gltf;
+
+    std::vector<Uint8>    m_BufferData;
+    std::set<std::string> m_ExtensionsUsed;
+
+    // Model data read back from the GPU. Vertex, index and morph target data
+    // start at the model's base vertex, first index and base delta, respectively.
+    std::vector<std::vector<Uint8>> m_VertexData;
+    std::vector<Uint8>              m_IndexData;
+    std::vector<Uint8>              m_IndexData16; // See ModelCreateInfo::AdaptiveIndexType
+    std::vector<Uint8>              m_MorphTargetData;
+
+    std::unordered_map<const ISampler*, int> m_SamplerIds;
+};
+
+std::vector<Uint8> ModelWriter::ReadBufferData(IBuffer* pBuffer, Uint64 Offset, Uint64 Size) const
+{
+    std::vector<Uint8> Data;
+    if (pBuffer == nullptr || Size == 0)
+        return Data;
+
+    BufferDesc StagingDesc;
+    StagingDesc.Name           = "GLTF writer staging buffer";
+    StagingDesc.Size           = Size;
+    StagingDesc.Usage          = USAGE_STAGING;
+    StagingDesc.CPUAccessFlags = CPU_ACCESS_READ;
+
+    RefCntAutoPtr<IBuffer> pStagingBuffer;
+    m_pDevice->CreateBuffer(StagingDesc, nullptr, &pStagingBuffer);
+    if (!pStagingBuffer)
+    {
+        LOG_ERROR_MESSAGE("Failed to create staging buffer to read back buffer '", pBuffer->GetDesc().Name, "'");
+        return Data;
+    }
+
+    m_pContext->CopyBuffer(pBuffer, Offset, RESOURCE_STATE_TRANSITION_MODE_TRANSITION,
+                           pStagingBuffer, 0, Size, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+    m_pContext->WaitForIdle();
+
+    void* pMappedData = nullptr;
+    m_pContext->MapBuffer(pStagingBuffer, MAP_READ, MAP_FLAG_DO_NOT_WAIT, pMappedData);
+    if (pMappedData != nullptr)
+    {
+        Data.resize(StaticCast<size_t>(Size));
+        memcpy(Data.data(), pMappedData, Data.size());
+        m_pContext->UnmapBuffer(pStagingBuffer, MAP_READ);
+    }
+    else
+    {
+        LOG_ERROR_MESSAGE("Failed to map staging buffer");
+    }
+
+    return Data;
+}
+
+void ModelWriter::ReadModelData()
+{
+    const bool HasIndices16 = m_Model.IndexData16.IndexSize != 0;
+
+    Uint32 NumVertices    = 0;
+    Uint32 NumIndices     = 0;
+    Uint32 NumIndices16   = 0;
+    Uint32 NumMorphDeltas = 0;
+    for (const auto& Mesh : m_Model.Meshes)
+    {
+        for (const auto& Prim : Mesh.Primitives)
+        {
+            auto& NumPrimIndices = HasIndices16 && Prim.IndexType == VT_UINT16 ? NumIndices16 : NumIndices;
+
+            NumVertices    = std::max(NumVertices, Prim.FirstVertex + Prim.VertexCount);
+            NumPrimIndices = std::max(NumPrimIndices, Prim.FirstIndex + Prim.IndexCount);
+            if (Prim.HasMorphTargets())
+                NumMorphDeltas = std::max(NumMorphDeltas, Prim.MorphTargets.FirstDelta + Prim.MorphTargets.GetDeltaCount(Prim.VertexCount));
+        }
+    }
+
+    const auto& VertexData = m_Model.VertexData;
+    m_VertexData.resize(VertexData.Strides.size());
+    for (Uint32 i = 0; i < VertexData.Strides.size(); ++i)
+    {
+        const Uint64 Stride = VertexData.Strides[i];
+        if (Stride == 0)
+            continue;
+
+        m_VertexData[i] = ReadBufferData(m_Model.GetVertexBuffer(i), Uint64{m_Model.GetBaseVertex()} * Stride, Uint64{NumVertices} * Stride);
+    }
+
+    if (NumIndices > 0)
+    {
+        const Uint64     IndexSize = m_Model.IndexData.IndexSize;
+        const VALUE_TYPE IndexType = IndexSize == 4 ? VT_UINT32 : VT_UINT16;
+        m_IndexData                = ReadBufferData(m_Model.GetIndexBuffer(IndexType), Uint64{m_Model.GetFirstIndexLocation(IndexType)} * IndexSize, Uint64{NumIndices} * IndexSize);
+    }
+
+    if (NumIndices16 > 0)
+    {
+        const Uint64 IndexSize = m_Model.IndexData16.IndexSize;
+        m_IndexData16          = ReadBufferData(m_Model.GetIndexBuffer(VT_UINT16), Uint64{m_Model.GetFirstIndexLocation(VT_UINT16)} * IndexSize, Uint64{NumIndices16} * IndexSize);
+    }
+
+    if (NumMorphDeltas > 0)
+    {
+        const Uint64 Stride = Model::MorphTargetDeltaStride;
+        m_MorphTargetData   = ReadBufferData(m_Model.GetMorphTargetBuffer(), Uint64{m_Model.GetBaseMorphTargetDelta()} * Stride, Uint64{NumMorphDeltas} * Stride);
+    }
+}
+
+RefCntAutoPtr<IDataBlob> ModelWriter::EncodeTexture(Uint32 TextureId) const
+{
+    ITexture* pTexture = m_Model.GetTexture(TextureId);
+    if (pTexture == nullptr)
+        return {};
+
+    const auto& TexDesc    = pTexture->GetDesc();
+    const auto& FmtAttribs = GetTextureFormatAttribs(TexDesc.Format);
+    if (!IsConvertibleToRGBA8(FmtAttribs))
+    {
+        LOG_ERROR_MESSAGE("Texture ", TextureId, " can't be encoded: format ", FmtAttribs.Name,
+                          " is not supported. Only uncompressed 8- and 16-bit unorm and 16- and 32-bit float formats are supported.");
+        return {};
+    }
+
+    Uint32 X      = 0;
+    Uint32 Y      = 0;
+    Uint32 Slice  = 0;
+    Uint32 Width  = TexDesc.Width;
+    Uint32 Height = TexDesc.Height;
+
+    const auto& TexInfo = m_Model.Textures[TextureId];
+    if (TexInfo.pAtlasSuballocation)
+    {
+        const auto& Origin = TexInfo.pAtlasSuballocation->GetOrigin();
+        const auto& Size   = TexInfo.pAtlasSuballocation->GetSize();
+
+        X      = Origin.x;
+        Y      = Origin.y;
+        Width  = Size.x;
+        Height = Size.y;
+        Slice  = TexInfo.pAtlasSuballocation->GetSlice();
+    }
+
+    TextureDesc StagingDesc;
+    StagingDesc.Name           = "GLTF writer staging texture";
+    StagingDesc.Type           = RESOURCE_DIM_TEX_2D;
+    StagingDesc.Width          = Width;
+    StagingDesc.Height         = Height;
+    StagingDesc.Format         = TexDesc.Format;
+    StagingDesc.Usage          = USAGE_STAGING;
+    StagingDesc.CPUAccessFlags = CPU_ACCESS_READ;
+
+    RefCntAutoPtr<ITexture> pStagingTex;
+    m_pDevice->CreateTexture(StagingDesc, nullptr, &pStagingTex);
+    if (!pStagingTex)
+    {
+        LOG_ERROR_MESSAGE("Failed to create staging texture to read back texture ", TextureId);
+        return {};
+    }
+
+    Box SrcBox{X, X + Width, Y, Y + Height};
+
+    CopyTextureAttribs CopyAttribs{pTexture, RESOURCE_STATE_TRANSITION_MODE_TRANSITION, pStagingTex, RESOURCE_STATE_TRANSITION_MODE_TRANSITION};
+    CopyAttribs.SrcSlice = Slice;
+    CopyAttribs.pSrcBox  = &SrcBox;
+    m_pContext->CopyTexture(CopyAttribs);
+    m_pContext->WaitForIdle();
+
+    MappedTextureSubresource MappedData;
+    m_pContext->MapTextureSubresource(pStagingTex, 0, 0, MAP_READ, MAP_FLAG_DO_NOT_WAIT, nullptr, MappedData);
+    if (MappedData.pData == nullptr)
+    {
+        LOG_ERROR_MESSAGE("Failed to map staging texture");
+        return {};
+    }
+
+    // Four-component 8-bit formats are encoded directly, all other formats are converted to RGBA8 first
+    const bool IsRGBA8 = FmtAttribs.ComponentSize == 1 && FmtAttribs.NumComponents == 4;
+
+    std::vector<Uint8> RGBAData;
+    if (!IsRGBA8)
+        RGBAData = ConvertToRGBA8(static_cast<const Uint8*>(MappedData.pData), StaticCast<size_t>(MappedData.Stride), Width, Height, FmtAttribs);
+
+    Image::EncodeInfo EncodeInfo;
+    EncodeInfo.Width       = Width;
+    EncodeInfo.Height      = Height;
+    EncodeInfo.TexFormat   = IsRGBA8 ? TexDesc.Format : TEX_FORMAT_RGBA8_UNORM;
+    EncodeInfo.KeepAlpha   = FmtAttribs.NumComponents == 4;
+    EncodeInfo.pData       = IsRGBA8 ? MappedData.pData : RGBAData.data();
+    EncodeInfo.Stride      = IsRGBA8 ? StaticCast<Uint32>(MappedData.Stride) : Width * 4;
+    EncodeInfo.FileFormat  = m_WriteInfo.ImageFileFormat;
+    EncodeInfo.JpegQuality = m_WriteInfo.JpegQuality;
+
+    RefCntAutoPtr<IDataBlob> pEncodedData;
+    Image::Encode(EncodeInfo, &pEncodedData);
+    if (!pEncodedData || pEncodedData->GetSize() == 0)
+        LOG_ERROR_MESSAGE("Failed to encode texture ", TextureId);
+
+    m_pContext->UnmapTextureSubresource(pStagingTex, 0, 0);
+
+    return pEncodedData;
+}
+
+int ModelWriter::AddBufferView(const void* pData, size_t Size, int Target)
+{
+    const size_t Offset = AlignUp(m_BufferData.size(), size_t{4});
+    m_BufferData.resize(Offset + Size);
+    if (Size > 0)
+        memcpy(&m_BufferData[Offset], pData, Size);
+
+    tinygltf::BufferView View;
+    View.buffer     = 0;
+    View.byteOffset = Offset;
+    View.byteLength = Size;
+    View.target     = Target;
+    m_Gltf.bufferViews.push_back(std::move(View));
+
+    return static_cast<int>(m_Gltf.bufferViews.size() - 1);
+}
+
+int ModelWriter::AddAccessor(const void* pData, size_t Count, int ComponentType, int Type, int Target, bool Normalized)
+{
+    const size_t ElementSize = static_cast<size_t>(tinygltf::GetComponentSizeInBytes(ComponentType)) * static_cast<size_t>(tinygltf::GetNumComponentsInType(Type));
+
+    tinygltf::Accessor Accessor;
+    Accessor.bufferView    = AddBufferView(pData, ElementSize * Count, Target);
+    Accessor.byteOffset    = 0;
+    Accessor.componentType = ComponentType;
+    Accessor.type          = Type;
+    Accessor.count         = Count;
+    Accessor.normalized    = Normalized;
+    m_Gltf.accessors.push_back(std::move(Accessor));
+
+    return static_cast<int>(m_Gltf.accessors.size() - 1);
+}
+
+int ModelWriter::GetSamplerId(ITexture* pTexture)
+{
+    ITextureView* pSRV = pTexture->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
+    if (pSRV == nullptr)
+        return -1;
+
+    const ISampler* pSampler = pSRV->GetSampler();
+    if (pSampler == nullptr)
+        return -1;
+
+    auto it = m_SamplerIds.find(pSampler);
+    if (it != m_SamplerIds.end())
+        return it->second;
+
+    const auto& SamDesc = pSampler->GetDesc();
+
+    tinygltf::Sampler GltfSampler;
+    GltfSampler.magFilter = SamDesc.MagFilter == FILTER_TYPE_POINT ? TINYGLTF_TEXTURE_FILTER_NEAREST : TINYGLTF_TEXTURE_FILTER_LINEAR;
+    GltfSampler.minFilter = GetGltfMinFilter(SamDesc.MinFilter, SamDesc.MipFilter);
+    GltfSampler.wrapS     = GetGltfWrapMode(SamDesc.AddressU);
+    GltfSampler.wrapT     = GetGltfWrapMode(SamDesc.AddressV);
+    m_Gltf.samplers.push_back(std::move(GltfSampler));
+
+    const int SamplerId = static_cast<int>(m_Gltf.samplers.size() - 1);
+    m_SamplerIds.emplace(pSampler, SamplerId);
+    return SamplerId;
+}
+
+bool ModelWriter::WriteTextures()
+{
+    const char* MimeType = m_WriteInfo.ImageFileFormat == IMAGE_FILE_FORMAT_JPEG ? "image/jpeg" : "image/png";
+
+    RefCntAutoPtr<IDataBlob> pPlaceholderImage;
+    for (Uint32 TexId = 0; TexId < m_Model.GetTextureCount(); ++TexId)
+    {
+        RefCntAutoPtr<IDataBlob> pEncodedData;
+        if (m_Model.GetTexture(TexId) != nullptr)
+        {
+            pEncodedData = EncodeTexture(TexId);
+            if (!pEncodedData || pEncodedData->GetSize() == 0)
+                return false;
+        }
+        else
+        {
+            // The texture was not loaded (e.g. the image file is missing), so there is no data to write
+            LOG_WARNING_MESSAGE("Texture ", TexId, " has no GPU data and is replaced with a 1x1 white image");
+            if (!pPlaceholderImage)
+            {
+                static constexpr Uint8 WhitePixel[] = {255, 255, 255, 255};
+
+                Image::EncodeInfo EncodeInfo;
+                EncodeInfo.Width       = 1;
+                EncodeInfo.Height      = 1;
+                EncodeInfo.TexFormat   = TEX_FORMAT_RGBA8_UNORM;
+                EncodeInfo.KeepAlpha   = true;
+                EncodeInfo.pData       = WhitePixel;
+                EncodeInfo.Stride      = sizeof(WhitePixel);
+                EncodeInfo.FileFormat  = m_WriteInfo.ImageFileFormat;
+                EncodeInfo.JpegQuality = m_WriteInfo.JpegQuality;
+                Image::Encode(EncodeInfo, &pPlaceholderImage);
+            }
+            pEncodedData = pPlaceholderImage;
+        }
+
+        tinygltf::Image GltfImage;
+        GltfImage.mimeType   = MimeType;
+        GltfImage.bufferView = AddBufferView(pEncodedData->GetConstDataPtr(), StaticCast<size_t>(pEncodedData->GetSize()), 0);
+        m_Gltf.images.push_back(std::move(GltfImage));
+
+        tinygltf::Texture GltfTexture;
+        GltfTexture.source = static_cast<int>(m_Gltf.images.size() - 1);
+        if (!m_Model.Textures[TexId].pAtlasSuballocation)
+        {
+            if (ITexture* pTexture = m_Model.GetTexture(TexId))
+                GltfTexture.sampler = GetSamplerId(pTexture);
+        }
+        m_Gltf.textures.push_back(std::move(GltfTexture));
+    }
+
+    return true;
+}
+
+tinygltf::Value ModelWriter::GetTextureTransform(const Material::TextureShaderAttribs& TexAttribs)
+{
+    // ReadKhrTextureTransform() computes UVScaleAndRotation as Scale(UScale, VScale) * Rotation(-rotation):
+    //
+    //   | UScale * cos(rotation)  -UScale * sin(rotation) |
+    //   | VScale * sin(rotation)   VScale * cos(rotation) |
+    //
+    const auto& M = TexAttribs.UVScaleAndRotation;
+
+    const float UScale   = std::sqrt(M[0][0] * M[0][0] + M[0][1] * M[0][1]);
+    const float VScale   = std::sqrt(M[1][0] * M[1][0] + M[1][1] * M[1][1]);
+    const float Rotation = UScale > 0 ? std::atan2(-M[0][1], M[0][0]) : 0.f;
+
+    tinygltf::Value::Object Transform;
+    if (TexAttribs.UBias != 0 || TexAttribs.VBias != 0)
+        Transform["offset"] = MakeNumberArray(float2{TexAttribs.UBias, TexAttribs.VBias}, 2);
+    if (std::abs(Rotation) > 1e-6f)
+        Transform["rotation"] = tinygltf::Value{static_cast<double>(Rotation)};
+    if (std::abs(UScale - 1.f) > 1e-6f || std::abs(VScale - 1.f) > 1e-6f)
+        Transform["scale"] = MakeNumberArray(float2{UScale, VScale}, 2);
+
+    if (Transform.empty())
+        return {};
+
+    m_ExtensionsUsed.insert("KHR_texture_transform");
+    return tinygltf::Value{std::move(Transform)};
+}
+
+template <typename TextureInfoType>
+bool ModelWriter::InitTextureInfo(const Material& Mat, const char* Name, TextureInfoType& TexInfo)
+{
+    const int TexAttribIdx = m_Model.GetTextureAttributeIndex(Name);
+    if (TexAttribIdx < 0)
+        return false;
+
+    const int TexId = Mat.GetTextureId(TexAttribIdx);
+    if (TexId < 0)
+        return false;
+
+    const auto& TexAttribs = Mat.GetTextureAttrib(TexAttribIdx);
+
+    TexInfo.index    = TexId;
+    TexInfo.texCoord = std::max(static_cast<int>(TexAttribs.UVSelector), 0);
+
+    tinygltf::Value Transform = GetTextureTransform(TexAttribs);
+    if (Transform.IsObject())
+        TexInfo.extensions["KHR_texture_transform"] = std::move(Transform);
+
+    return true;
+}
+
+void ModelWriter::AddTextureInfo(const Material& Mat, const char* Name, tinygltf::Value::Object& Ext)
+{
+    tinygltf::TextureInfo TexInfo;
+    if (!InitTextureInfo(Mat, Name, TexInfo))
+        return;
+
+    tinygltf::Value::Object TexInfoObj;
+    TexInfoObj["index"] = tinygltf::Value{TexInfo.index};
+    if (TexInfo.texCoord != 0)
+        TexInfoObj["texCoord"] = tinygltf::Value{TexInfo.texCoord};
+    if (!TexInfo.extensions.empty())
+        TexInfoObj["extensions"] = tinygltf::Value{tinygltf::Value::Object{TexInfo.extensions.begin(), TexInfo.extensions.end()}};
+
+    Ext[Name] = tinygltf::Value{std::move(TexInfoObj)};
+}
+
+void ModelWriter::AddMaterialExtension(tinygltf::Material& GltfMat, const char* ExtName, tinygltf::Value::Object&& Ext)
+{
+    GltfMat.extensions[ExtName] = tinygltf::Value{std::move(Ext)};
+    m_ExtensionsUsed.insert(ExtName);
+}
+
+void ModelWriter::WriteMaterials()
+{
+    m_Gltf.materials.reserve(m_Model.Materials.size());
+    for (const auto& Mat : m_Model.Materials)
+    {
+        tinygltf::Material GltfMat;
+
+        const auto& Attribs = Mat.Attribs;
+
+        auto& PbrMR           = GltfMat.pbrMetallicRoughness;
+        PbrMR.baseColorFactor = MakeDoubleVector(Attribs.BaseColorFactor, 4);
+        PbrMR.metallicFactor  = Attribs.MetallicFactor;
+        PbrMR.roughnessFactor = Attribs.RoughnessFactor;
+        InitTextureInfo(Mat, BaseColorTextureName, PbrMR.baseColorTexture);
+        InitTextureInfo(Mat, MetallicRoughnessTextureName, PbrMR.metallicRoughnessTexture);
+
+        InitTextureInfo(Mat, NormalTextureName, GltfMat.normalTexture);
+        if (InitTextureInfo(Mat, OcclusionTextureName, GltfMat.occlusionTexture))
+            GltfMat.occlusionTexture.strength = Attribs.OcclusionFactor;
+        InitTextureInfo(Mat, EmissiveTextureName, GltfMat.emissiveTexture);
+
+        // Emissive strength is premultiplied by LoadMaterials()
+        const float MaxEmissive      = std::max(std::max(Attribs.EmissiveFactor.r, Attribs.EmissiveFactor.g), Attribs.EmissiveFactor.b);
+        const float EmissiveStrength = (MaxEmissive > 1.f && Attribs.Workflow != Material::PBR_WORKFLOW_UNLIT) ? MaxEmissive : 1.f;
+        GltfMat.emissiveFactor = MakeDoubleVector(Attribs.EmissiveFactor / EmissiveStrength, 3);
+        if (EmissiveStrength != 1.f)
+        {
+            AddMaterialExtension(GltfMat, "KHR_materials_emissive_strength",
+                                 tinygltf::Value::Object{{"emissiveStrength", tinygltf::Value{static_cast<double>(EmissiveStrength)}}});
+        }
+
+        switch (Attribs.AlphaMode)
+        {
+            case Material::ALPHA_MODE_MASK:
+                GltfMat.alphaMode   = "MASK";
+                GltfMat.alphaCutoff = Attribs.AlphaCutoff;
+                break;
+
+            case Material::ALPHA_MODE_BLEND:
+                GltfMat.alphaMode = "BLEND";
+                break;
+
+            default:
+                GltfMat.alphaMode = "OPAQUE";
+        }
+        GltfMat.doubleSided = Mat.DoubleSided;
+
+        if (Attribs.Workflow == Material::PBR_WORKFLOW_UNLIT)
+        {
+            AddMaterialExtension(GltfMat, "KHR_materials_unlit", {});
+        }
+        else if (Attribs.Workflow == Material::PBR_WORKFLOW_SPEC_GLOSS)
+        {
+            tinygltf::Value::Object SpecGlossExt;
+            SpecGlossExt["diffuseFactor"]  = MakeNumberArray(Attribs.BaseColorFactor, 4);
+            SpecGlossExt["specularFactor"] = MakeNumberArray(Attribs.SpecularFactor, 3);
+            AddTextureInfo(Mat, DiffuseTextureName, SpecGlossExt);
+            AddTextureInfo(Mat, SpecularGlossinessTextureName, SpecGlossExt);
+            AddMaterialExtension(GltfMat, "KHR_materials_pbrSpecularGlossiness", std::move(SpecGlossExt));
+        }
+        else
+        {
+            if (Mat.HasClearcoat)
+            {
+                tinygltf::Value::Object ClearcoatExt;
+                ClearcoatExt["clearcoatFactor"]          = tinygltf::Value{static_cast<double>(Attribs.ClearcoatFactor)};
+                ClearcoatExt["clearcoatRoughnessFactor"] = tinygltf::Value{static_cast<double>(Attribs.ClearcoatRoughnessFactor)};
+                AddTextureInfo(Mat, ClearcoatTextureName, ClearcoatExt);
+                AddTextureInfo(Mat, ClearcoatRoughnessTextureName, ClearcoatExt);
+                AddTextureInfo(Mat, ClearcoatNormalTextureName, ClearcoatExt);
+                AddMaterialExtension(GltfMat, "KHR_materials_clearcoat", std::move(ClearcoatExt));
+            }
+
+            if (Mat.Sheen)
+            {
+                tinygltf::Value::Object SheenExt;
+                SheenExt["sheenColorFactor"]     = MakeNumberArray(Mat.Sheen->ColorFactor, 3);
+                SheenExt["sheenRoughnessFactor"] = tinygltf::Value{static_cast<double>(Mat.Sheen->RoughnessFactor)};
+                AddTextureInfo(Mat, SheenColorTextureName, SheenExt);
+                AddTextureInfo(Mat, SheenRoughnessTextureName, SheenExt);
+                AddMaterialExtension(GltfMat, "KHR_materials_sheen", std::move(SheenExt));
+            }
+
+            if (Mat.Anisotropy)
+            {
+                tinygltf::Value::Object AnisoExt;
+                AnisoExt["anisotropyStrength"] = tinygltf::Value{static_cast<double>(Mat.Anisotropy->Strength)};
+                AnisoExt["anisotropyRotation"] = tinygltf::Value{static_cast<double>(Mat.Anisotropy->Rotation)};
+                AddTextureInfo(Mat, AnisotropyTextureName, AnisoExt);
+                AddMaterialExtension(GltfMat, "KHR_materials_anisotropy", std::move(AnisoExt));
+            }
+
+            if (Mat.Iridescence)
+            {
+                tinygltf::Value::Object IridExt;
+                IridExt["iridescenceFactor"]           = tinygltf::Value{static_cast<double>(Mat.Iridescence->Factor)};
+                IridExt["iridescenceIor"]              = tinygltf::Value{static_cast<double>(Mat.Iridescence->IOR)};
+                IridExt["iridescenceThicknessMinimum"] = tinygltf::Value{static_cast<double>(Mat.Iridescence->ThicknessMinimum)};
+                IridExt["iridescenceThicknessMaximum"] = tinygltf::Value{static_cast<double>(Mat.Iridescence->ThicknessMaximum)};
+                AddTextureInfo(Mat, IridescenceTextureName, IridExt);
+                AddTextureInfo(Mat, IridescenceThicknessTextureName, IridExt);
+                AddMaterialExtension(GltfMat, "KHR_materials_iridescence", std::move(IridExt));
+            }
+
+            if (Mat.Transmission)
+            {
+                tinygltf::Value::Object TransExt;
+                TransExt["transmissionFactor"] = tinygltf::Value{static_cast<double>(Mat.Transmission->Factor)};
+                AddTextureInfo(Mat, TransmissionTextureName, TransExt);
+                AddMaterialExtension(GltfMat, "KHR_materials_transmission", std::move(TransExt));
+            }
+
+            if (Mat.Volume)
+            {
+                tinygltf::Value::Object VolExt;
+                VolExt["thicknessFactor"]  = tinygltf::Value{static_cast<double>(Mat.Volume->ThicknessFactor)};
+                VolExt["attenuationColor"] = MakeNumberArray(Mat.Volume->AttenuationColor, 3);
+                if (Mat.Volume->AttenuationDistance < FLT_MAX)
+                    VolExt["attenuationDistance"] = tinygltf::Value{static_cast<double>(Mat.Volume->AttenuationDistance)};
+                AddTextureInfo(Mat, ThicknessTextureName, VolExt);
+                AddMaterialExtension(GltfMat, "KHR_materials_volume", std::move(VolExt));
+            }
+        }
+
+        m_Gltf.materials.push_back(std::move(GltfMat));
+    }
+}
+
+void ModelWriter::WriteVertexAttributes(const Primitive& Prim, std::map<std::string, int>& Attributes)
+{
+    for (Uint32 i = 0; i < m_Model.GetNumVertexAttributes(); ++i)
+    {
+        if (!m_Model.IsVertexAttributeEnabled(i))
+            continue;
+
+        const auto& Attrib = m_Model.GetVertexAttribute(i);
+        const auto& Data   = m_VertexData[Attrib.BufferId];
+        if (Data.empty())
+            continue;
+
+        const size_t Stride        = m_Model.VertexData.Strides[Attrib.BufferId];
+        const size_t ComponentSize = GetValueSize(Attrib.ValueType);
+        VERIFY_EXPR((size_t{Prim.FirstVertex} + Prim.VertexCount) * Stride <= Data.size());
+
+        std::string Name = Attrib.Name;
+
+        Uint32 NumComponents = std::min(Uint32{Attrib.NumComponents}, 4u);
+        float4 DefaultValue{0, 0, 0, 0};
+        if (Name == "POSITION" || Name == "NORMAL")
+        {
+            NumComponents = 3;
+        }
+        else if (Name == "TANGENT")
+        {
+            NumComponents  = 4;
+            DefaultValue.w = 1;
+        }
+        else if (Name.compare(0, 9, "TEXCOORD_") == 0)
+        {
+            NumComponents = 2;
+        }
+        else if (Name.compare(0, 6, "COLOR_") == 0)
+        {
+            NumComponents  = NumComponents == 4 ? 4 : 3;
+            DefaultValue.w = 1;
+        }
+        else if (Name.compare(0, 7, "JOINTS_") == 0 || Name.compare(0, 8, "WEIGHTS_") == 0)
+        {
+            NumComponents = 4;
+        }
+        else if (!IsStandardAttributeName(Name))
+        {
+            // Application-specific attributes must start with an underscore
+            Name = "_" + Name;
+        }
+
+        const auto ReadVertex = [&](Uint32 v, float4& Value) {
+            const Uint8* pSrc = &Data[(size_t{Prim.FirstVertex} + v) * Stride + Attrib.RelativeOffset];
+
+            Value = DefaultValue;
+            for (Uint32 c = 0; c < std::min(Uint32{Attrib.NumComponents}, NumComponents); ++c)
+                Value[c] = ReadComponent(pSrc + c * ComponentSize, Attrib.ValueType);
+        };
+
+        int AccessorId = -1;
+        if (Name.compare(0, 7, "JOINTS_") == 0)
+        {
+            std::vector<Uint16> Joints(size_t{Prim.VertexCount} * 4);
+            for (Uint32 v = 0; v < Prim.VertexCount; ++v)
+            {
+                float4 Value;
+                ReadVertex(v, Value);
+                for (Uint32 c = 0; c < 4; ++c)
+                    Joints[v * 4 + c] = static_cast<Uint16>(std::max(Value[c], 0.f));
+            }
+            AccessorId = AddAccessor(Joints.data(), Prim.VertexCount, TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT, TINYGLTF_TYPE_VEC4, TINYGLTF_TARGET_ARRAY_BUFFER);
+        }
+        else
+        {
+            std::vector<float> Values(size_t{Prim.VertexCount} * NumComponents);
+
+            float4 MinValue{+FLT_MAX, +FLT_MAX, +FLT_MAX, +FLT_MAX};
+            float4 MaxValue{-FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX};
+            for (Uint32 v = 0; v < Prim.VertexCount; ++v)
+            {
+                float4 Value;
+                ReadVertex(v, Value);
+                for (Uint32 c = 0; c < NumComponents; ++c)
+                    Values[v * NumComponents + c] = Value[c];
+                for (Uint32 c = 0; c < NumComponents; ++c)
+                {
+                    MinValue[c] = std::min(MinValue[c], Value[c]);
+                    MaxValue[c] = std::max(MaxValue[c], Value[c]);
+                }
+            }
+            AccessorId = AddAccessor(Values.data(), Prim.VertexCount, TINYGLTF_COMPONENT_TYPE_FLOAT, GetGltfType(NumComponents), TINYGLTF_TARGET_ARRAY_BUFFER);
+
+            if (Name == "POSITION" && Prim.VertexCount > 0)
+            {
+                // Required by the spec
+                auto& Accessor     = m_Gltf.accessors[AccessorId];
+                Accessor.minValues = MakeDoubleVector(MinValue, 3);
+                Accessor.maxValues = MakeDoubleVector(MaxValue, 3);
+            }
+        }
+
+        Attributes[Name] = AccessorId;
+    }
+}
+
+int ModelWriter::WriteIndices(const Primitive& Prim)
+{
+    const bool   Use16     = m_Model.IndexData16.IndexSize != 0 && Prim.IndexType == VT_UINT16;
+    const auto&  IndexData = Use16 ? m_IndexData16 : m_IndexData;
+    const size_t IndexSize = Use16 ? m_Model.IndexData16.IndexSize : m_Model.IndexData.IndexSize;
+    VERIFY_EXPR(IndexSize == 2 || IndexSize == 4);
+    VERIFY_EXPR((size_t{Prim.FirstIndex} + Prim.IndexCount) * IndexSize <= IndexData.size());
+
+    // Model indices plus the primitive's base vertex include the primitive's first vertex
+    std::vector<Uint32> Indices(Prim.IndexCount);
+    Uint32              MaxIndex = 0;
+    for (Uint32 i = 0; i < Prim.IndexCount; ++i)
+    {
+        const Uint8* pSrc  = &IndexData[(size_t{Prim.FirstIndex} + i) * IndexSize];
+        const Uint32 Index = (IndexSize == 2 ? ReadUnaligned<Uint16>(pSrc) : ReadUnaligned<Uint32>(pSrc)) + Prim.BaseVertex;
+        VERIFY_EXPR(Index >= Prim.FirstVertex);
+
+        Indices[i] = Index - Prim.FirstVertex;
+        MaxIndex   = std::max(MaxIndex, Indices[i]);
+    }
+
+    if (MaxIndex <= 0xFFFFu)
+    {
+        std::vector<Uint16> Indices16{Indices.begin(), Indices.end()};
+        return AddAccessor(Indices16.data(), Indices16.size(), TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT, TINYGLTF_TYPE_SCALAR, TINYGLTF_TARGET_ELEMENT_ARRAY_BUFFER);
+    }
+    else
+    {
+        return AddAccessor(Indices.data(), Indices.size(), TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT, TINYGLTF_TYPE_SCALAR, TINYGLTF_TARGET_ELEMENT_ARRAY_BUFFER);
+    }
+}
+
+void ModelWriter::WriteMorphTargets(const Primitive& Prim, std::vector<std::map<std::string, int>>& Targets)
+{
+    static constexpr std::array<const char*, MORPH_TARGET_ATTRIB_COUNT> AttribNames = {"POSITION", "NORMAL", "TANGENT"};
+
+    const auto& MorphTargets = Prim.MorphTargets;
+    Targets.resize(MorphTargets.Count);
+
+    std::vector<float3> Deltas(Prim.VertexCount);
+    for (Uint32 target = 0; target < MorphTargets.Count; ++target)
+    {
+        for (Uint32 attrib = 0; attrib < MORPH_TARGET_ATTRIB_COUNT; ++attrib)
+        {
+            const auto Offset = MorphTargets.GetDeltaOffset(target, static_cast<MORPH_TARGET_ATTRIB>(attrib), Prim.VertexCount);
+            if (Offset == ~0u)
+                continue;
+
+            VERIFY_EXPR((size_t{Offset} + Prim.VertexCount) * Model::MorphTargetDeltaStride <= m_MorphTargetData.size());
+            for (Uint32 v = 0; v < Prim.VertexCount; ++v)
+            {
+                const auto Delta = ReadUnaligned<float4>(&m_MorphTargetData[(size_t{Offset} + v) * Model::MorphTargetDeltaStride]);
+                Deltas[v]        = float3{Delta.x, Delta.y, Delta.z};
+            }
+
+            Targets[target][AttribNames[attrib]] = AddAccessor(Deltas.data(), Deltas.size(), TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC3, TINYGLTF_TARGET_ARRAY_BUFFER);
+        }
+    }
+}
+
+void ModelWriter::WriteMeshes()
+{
+    // Primitives that share vertex data also share vertex attribute accessors
+    std::map<std::pair<Uint32, Uint32>, std::map<std::string, int>> VertexAttributes;
+
+    m_Gltf.meshes.reserve(m_Model.Meshes.size());
+    for (const auto& Mesh : m_Model.Meshes)
+    {
+        tinygltf::Mesh GltfMesh;
+        GltfMesh.name    = Mesh.Name;
+        GltfMesh.weights = MakeDoubleVector(Mesh.Weights, Mesh.Weights.size());
+
+        for (const auto& Prim : Mesh.Primitives)
+        {
+            tinygltf::Primitive GltfPrim;
+            GltfPrim.mode     = TINYGLTF_MODE_TRIANGLES;
+            GltfPrim.material = static_cast<int>(Prim.MaterialId);
+
+            auto& Attributes = VertexAttributes[std::make_pair(Prim.FirstVertex, Prim.VertexCount)];
+            if (Attributes.empty())
+                WriteVertexAttributes(Prim, Attributes);
+            GltfPrim.attributes = Attributes;
+
+            if (Prim.HasIndices())
+                GltfPrim.indices = WriteIndices(Prim);
+
+            if (Prim.HasMorphTargets())
+                WriteMorphTargets(Prim, GltfPrim.targets);
+
+            GltfMesh.primitives.push_back(std::move(GltfPrim));
+        }
+
+        m_Gltf.meshes.push_back(std::move(GltfMesh));
+    }
+}
+
+void ModelWriter::WriteNodes()
+{
+    const auto GetIndex = [](const auto* pItem, const auto& Items) {
+        return pItem != nullptr ? static_cast<int>(pItem - Items.data()) : -1;
+    };
+
+    m_Gltf.nodes.reserve(m_Model.Nodes.size());
+    for (const auto& Node : m_Model.Nodes)
+    {
+        VERIFY(Node.Index == static_cast<int>(m_Gltf.nodes.size()), "Node index does not match its position in the Nodes array");
+
+        tinygltf::Node GltfNode;
+        GltfNode.name   = Node.Name;
+        GltfNode.mesh   = GetIndex(Node.pMesh, m_Model.Meshes);
+        GltfNode.camera = GetIndex(Node.pCamera, m_Model.Cameras);
+        GltfNode.skin   = GetIndex(Node.pSkin, m_Model.Skins);
+        GltfNode.light  = GetIndex(Node.pLight, m_Model.Lights);
+
+        for (const auto* pChild : Node.Children)
+            GltfNode.children.push_back(pChild->Index);
+
+        const bool HasTRS = (Node.Translation != float3{} || Node.Rotation != QuaternionF{} || Node.Scale != float3{1, 1, 1});
+        if (Node.Matrix != float4x4::Identity())
+        {
+            // Translation, rotation, scale and matrix are mutually exclusive as per glTF spec
+            const float4x4 Matrix = HasTRS ? Node.ComputeLocalTransform() : Node.Matrix;
+            for (int r = 0; r < 4; ++r)
+            {
+                for (int c = 0; c < 4; ++c)
+                    GltfNode.matrix.push_back(Matrix[r][c]);
+            }
+        }
+        else
+        {
+            if (Node.Translation != float3{})
+                GltfNode.translation = MakeDoubleVector(Node.Translation, 3);
+            if (Node.Rotation != QuaternionF{})
+                GltfNode.rotation = MakeDoubleVector(Node.Rotation.q, 4);
+            if (Node.Scale != float3{1, 1, 1})
+                GltfNode.scale = MakeDoubleVector(Node.Scale, 3);
+        }
+
+        if (Node.IsInstanced())
+        {
+            const size_t InstanceCount = Node.InstanceMatrices.size();
+
+            std::vector<float3> Translations(InstanceCount);
+            std::vector<float4> Rotations(InstanceCount);
+            std::vector<float3> Scales(InstanceCount);
+            for (size_t inst = 0; inst < InstanceCount; ++inst)
+            {
+                QuaternionF Rotation;
+                DecomposeTransform(Node.InstanceMatrices[inst], Translations[inst], Rotation, Scales[inst]);
+                Rotations[inst] = Rotation.q;
+            }
+
+            tinygltf::Value::Object Attributes;
+            Attributes["TRANSLATION"] = tinygltf::Value{AddAccessor(Translations.data(), InstanceCount, TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC3)};
+            Attributes["ROTATION"]    = tinygltf::Value{AddAccessor(Rotations.data(), InstanceCount, TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC4)};
+            Attributes["SCALE"]       = tinygltf::Value{AddAccessor(Scales.data(), InstanceCount, TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC3)};
+
+            GltfNode.extensions["EXT_mesh_gpu_instancing"] = tinygltf::Value{tinygltf::Value::Object{{"attributes", tinygltf::Value{std::move(Attributes)}}}};
+            m_ExtensionsUsed.insert("EXT_mesh_gpu_instancing");
+        }
+
+        m_Gltf.nodes.push_back(std::move(GltfNode));
+    }
+}
+
+void ModelWriter::WriteScenes()
+{
+    m_Gltf.scenes.reserve(m_Model.Scenes.size());
+    for (const auto& Scene : m_Model.Scenes)
+    {
+        tinygltf::Scene GltfScene;
+        GltfScene.name = Scene.Name;
+        for (const auto* pRootNode : Scene.RootNodes)
+            GltfScene.nodes.push_back(pRootNode->Index);
+        m_Gltf.scenes.push_back(std::move(GltfScene));
+    }
+
+    if (!m_Model.Scenes.empty())
+        m_Gltf.defaultScene = m_Model.DefaultSceneId;
+}
+
+void ModelWriter::WriteCameras()
+{
+    m_Gltf.cameras.reserve(m_Model.Cameras.size());
+    for (const auto& Cam : m_Model.Cameras)
+    {
+        tinygltf::Camera GltfCam;
+        GltfCam.name = Cam.Name;
+        if (Cam.Type == Camera::Projection::Orthographic)
+        {
+            GltfCam.type               = "orthographic";
+            GltfCam.orthographic.xmag  = Cam.Orthographic.XMag;
+            GltfCam.orthographic.ymag  = Cam.Orthographic.YMag;
+            GltfCam.orthographic.znear = Cam.Orthographic.ZNear;
+            GltfCam.orthographic.zfar  = Cam.Orthographic.ZFar;
+        }
+        else
+        {
+            GltfCam.type                    = "perspective";
+            GltfCam.perspective.aspectRatio = Cam.Perspective.AspectRatio;
+            GltfCam.perspective.yfov        = Cam.Perspective.YFov;
+            GltfCam.perspective.znear       = Cam.Perspective.ZNear;
+            GltfCam.perspective.zfar        = Cam.Perspective.ZFar;
+        }
+        m_Gltf.cameras.push_back(std::move(GltfCam));
+    }
+}
+
+void ModelWriter::WriteLights()
+{
+    m_Gltf.lights.reserve(m_Model.Lights.size());
+    for (const auto& Light : m_Model.Lights)
+    {
+        tinygltf::Light GltfLight;
+        GltfLight.name      = Light.Name;
+        GltfLight.color     = MakeDoubleVector(Light.Color, 3);
+        GltfLight.intensity = Light.Intensity;
+        GltfLight.range     = Light.Range;
+        switch (Light.Type)
+        {
+            case Light::TYPE::DIRECTIONAL:
+                GltfLight.type = "directional";
+                break;
+
+            case Light::TYPE::SPOT:
+                GltfLight.type                = "spot";
+                GltfLight.spot.innerConeAngle = Light.InnerConeAngle;
+                GltfLight.spot.outerConeAngle = Light.OuterConeAngle;
+                break;
+
+            default:
+                GltfLight.type = "point";
+        }
+        m_Gltf.lights.push_back(std::move(GltfLight));
+    }
+}
+
+void ModelWriter::WriteSkins()
+{
+    m_Gltf.skins.reserve(m_Model.Skins.size());
+    for (const auto& Skin : m_Model.Skins)
+    {
+        tinygltf::Skin GltfSkin;
+        GltfSkin.name = Skin.Name;
+        if (Skin.pSkeletonRoot != nullptr)
+            GltfSkin.skeleton = Skin.pSkeletonRoot->Index;
+        for (const auto* pJoint : Skin.Joints)
+            GltfSkin.joints.push_back(pJoint->Index);
+        if (!Skin.InverseBindMatrices.empty())
+        {
+            GltfSkin.inverseBindMatrices = AddAccessor(Skin.InverseBindMatrices.data(), Skin.InverseBindMatrices.size(),
+                                                       TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_MAT4);
+        }
+        m_Gltf.skins.push_back(std::move(GltfSkin));
+    }
+}
+
+void ModelWriter::WriteAnimations()
+{
+    m_Gltf.animations.reserve(m_Model.Animations.size());
+    for (const auto& Anim : m_Model.Animations)
+    {
+        tinygltf::Animation GltfAnim;
+        GltfAnim.name = Anim.Name;
+
+        // Samplers that are not referenced by any channel are not written.
+        std::vector<int> SamplerIds(Anim.Samplers.size(), -1);
+        for (const auto& Channel : Anim.Channels)
+        {
+            if (Channel.SamplerIndex >= Anim.Samplers.size())
+                continue;
+
+            int& SamplerId = SamplerIds[Channel.SamplerIndex];
+            if (SamplerId < 0)
+            {
+                const auto& Sampler = Anim.Samplers[Channel.SamplerIndex];
+
+                // Compressed samplers are written as the reduced set of dequantized keys
+                std::vector<float>  CompressedInputs;
+                std::vector<float4> CompressedOutputs;
+                if (!Sampler.Compressed.IsEmpty())
+                {
+                    const Uint32 NumKeys = Sampler.Compressed.GetKeyCount();
+                    CompressedInputs.resize(NumKeys);
+                    CompressedOutputs.resize(NumKeys);
+                    for (Uint32 Key = 0; Key < NumKeys; ++Key)
+                    {
+                        CompressedInputs[Key]  = Sampler.Compressed.GetKeyTime(Key);
+                        CompressedOutputs[Key] = Sampler.Compressed.GetKeyValue(Key);
+                    }
+                }
+                const auto& Inputs      = Sampler.Compressed.IsEmpty() ? Sampler.Inputs : CompressedInputs;
+                const auto& OutputsVec4 = Sampler.Compressed.IsEmpty() ? Sampler.OutputsVec4 : CompressedOutputs;
+
+                tinygltf::AnimationSampler GltfSampler;
+                switch (Sampler.Interpolation)
+                {
+                    case AnimationSampler::INTERPOLATION_TYPE::STEP:
+                        GltfSampler.interpolation = "STEP";
+                        break;
+
+                    case AnimationSampler::INTERPOLATION_TYPE::CUBICSPLINE:
+                        GltfSampler.interpolation = "CUBICSPLINE";
+                        break;
+
+                    default:
+                        GltfSampler.interpolation = "LINEAR";
+                }
+
+                GltfSampler.input = AddAccessor(Inputs.data(), Inputs.size(), TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_SCALAR);
+                {
+                    auto& Accessor     = m_Gltf.accessors[GltfSampler.input];
+                    Accessor.minValues = {Inputs.empty() ? 0.0 : Inputs.front()};
+                    Accessor.maxValues = {Inputs.empty() ? 0.0 : Inputs.back()};
+                }
+
+                if (Channel.PathType == AnimationChannel::PATH_TYPE::ROTATION)
+                {
+                    GltfSampler.output = AddAccessor(OutputsVec4.data(), OutputsVec4.size(), TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC4);
+                }
+                else
+                {
+                    std::vector<float3> Outputs(OutputsVec4.size());
+                    for (size_t i = 0; i < Outputs.size(); ++i)
+                        Outputs[i] = float3{OutputsVec4[i].x, OutputsVec4[i].y, OutputsVec4[i].z};
+                    GltfSampler.output = AddAccessor(Outputs.data(), Outputs.size(), TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC3);
+                }
+
+                GltfAnim.samplers.push_back(std::move(GltfSampler));
+                SamplerId = static_cast<int>(GltfAnim.samplers.size() - 1);
+            }
+
+            tinygltf::AnimationChannel GltfChannel;
+            GltfChannel.sampler     = SamplerId;
+            GltfChannel.target_node = Channel.pNode->Index;
+            switch (Channel.PathType)
+            {
+                // clang-format off
+                case AnimationChannel::PATH_TYPE::TRANSLATION: GltfChannel.target_path = "translation"; break;
+                case AnimationChannel::PATH_TYPE::ROTATION:    GltfChannel.target_path = "rotation";    break;
+                case AnimationChannel::PATH_TYPE::SCALE:       GltfChannel.target_path = "scale";       break;
+                case AnimationChannel::PATH_TYPE::WEIGHTS:     GltfChannel.target_path = "weights";     break;
+                // clang-format on
+                default:
+                    UNEXPECTED("Unexpected animation channel path type");
+            }
+            GltfAnim.channels.push_back(std::move(GltfChannel));
+        }
+
+        m_Gltf.animations.push_back(std::move(GltfAnim));
+    }
+}
+
+bool ModelWriter::Write()
+{
+    m_Gltf.asset.version   = "2.0";
+    m_Gltf.asset.generator = "Diligent glTF writer";
+
+    ReadModelData();
+
+    if (!WriteTextures())
+        return false;
+    WriteMaterials();
+    WriteMeshes();
+    WriteCameras();
+    WriteLights();
+    WriteNodes();
+    WriteScenes();
+    WriteSkins();
+    WriteAnimations();
+
+    if (!m_BufferData.empty())
+    {
+        tinygltf::Buffer Buffer;
+        Buffer.data = std::move(m_BufferData);
+        m_Gltf.buffers.push_back(std::move(Buffer));
+    }
+    m_Gltf.extensionsUsed.assign(m_ExtensionsUsed.begin(), m_ExtensionsUsed.end());
+
+    std::string FileName{m_WriteInfo.FileName};
+
+    const auto  ExtPos = FileName.find_last_of('.');
+    std::string Ext    = ExtPos != std::string::npos ? FileName.substr(ExtPos + 1) : "";
+    std::transform(Ext.begin(), Ext.end(), Ext.begin(), [](char c) { return static_cast<char>(std::tolower(c)); });
+    const bool IsBinary = Ext == "glb";
+
+    tinygltf::TinyGLTF GltfWriter;
+    if (!GltfWriter.WriteGltfSceneToFile(&m_Gltf, FileName, /*embedImages = */ false, /*embedBuffers = */ false, m_WriteInfo.PrettyPrint, IsBinary))
+    {
+        LOG_ERROR_MESSAGE("Failed to write glTF file '", FileName, "'");
+        return false;
+    }
+
+    return true;
+}
+
+bool WriteModel(IRenderDevice*        pDevice,
+                IDeviceContext*       pContext,
+                const Model&          Model,
+                const ModelWriteInfo& WriteInfo)
+{
+    if (pDevice == nullptr || pContext == nullptr)
+    {
+        LOG_ERROR_MESSAGE("Render device and device context must not be null");
+        return false;
+    }
+
+    if (WriteInfo.FileName == nullptr || WriteInfo.FileName[0] == '\0')
+    {
+        LOG_ERROR_MESSAGE("File name must not be empty");
+        return false;
+    }
+
+    if (WriteInfo.ImageFileFormat != IMAGE_FILE_FORMAT_PNG && WriteInfo.ImageFileFormat != IMAGE_FILE_FORMAT_JPEG)
+    {
+        LOG_ERROR_MESSAGE("Only PNG and JPEG image file formats are supported");
+        return false;
+    }
+
+    if (!Model.IsGPUDataInitialized())
+    {
+        LOG_ERROR_MESSAGE("Model GPU resources are not initialized. Call Model::PrepareGPUResources() first.");
+        return false;
+    }
+
+    return ModelWriter{pDevice, pContext, Model, WriteInfo}.Write();
+}
+
+} // namespace GLTF
+
+} // namespace Diligent
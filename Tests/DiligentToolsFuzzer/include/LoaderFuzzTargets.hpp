@@ -0,0 +1,76 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// CPU-only entry points that feed untrusted data to the texture and asset loaders.
+///
+/// The functions are shared by the libFuzzer targets and the throughput runner.
+/// None of them require a render device.
+
+#include <cstddef>
+
+#include "BasicTypes.h"
+
+namespace Diligent
+{
+
+namespace Testing
+{
+
+/// Suppresses the log output of the loaders.
+///
+/// \remarks    Malformed inputs make the loaders report errors, which would
+///             otherwise dominate the fuzzer output and the run time.
+void SuppressLoaderLogOutput();
+
+/// Creates a texture loader from memory using CreateTextureLoaderFromMemory().
+///
+/// \remarks    This covers all formats supported by the texture loader,
+///             including DDS and KTX that are not handled by Image.
+bool FuzzTextureLoader(const Uint8* pData, size_t Size);
+
+/// Decodes the data with Image::CreateFromDataBlob().
+bool FuzzImageDecoder(const Uint8* pData, size_t Size);
+
+/// Parses a .gltf or .glb document from memory with tinygltf and indexes
+/// the JSON text with GLTF::JsonIndex. External resources are not loaded.
+bool FuzzGLTFParser(const Uint8* pData, size_t Size);
+
+/// Loads an SDK mesh from memory and converts it to the glTF model layout.
+bool FuzzDXSDKMesh(const Uint8* pData, size_t Size);
+
+/// Decodes an EXT_meshopt_compression buffer view.
+///
+/// \remarks    The first four bytes select the compression mode, filter,
+///             element count and stride; the rest is the compressed stream.
+bool FuzzMeshoptDecoder(const Uint8* pData, size_t Size);
+
+} // namespace Testing
+
+} // namespace Diligent
@@ -0,0 +1,116 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "CorpusFiles.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "Errors.hpp"
+
+namespace Diligent
+{
+
+namespace Testing
+{
+
+namespace
+{
+
+void CollectFiles(const std::string& Path, std::vector<std::string>& Files)
+{
+    struct stat Stat;
+    if (stat(Path.c_str(), &Stat) != 0)
+    {
+        LOG_WARNING_MESSAGE("Corpus path '", Path, "' does not exist");
+        return;
+    }
+
+    if (S_ISREG(Stat.st_mode))
+    {
+        Files.push_back(Path);
+        return;
+    }
+
+    if (!S_ISDIR(Stat.st_mode))
+        return;
+
+    DIR* pDir = opendir(Path.c_str());
+    if (pDir == nullptr)
+    {
+        LOG_WARNING_MESSAGE("Failed to open corpus directory '", Path, "'");
+        return;
+    }
+
+    while (const dirent* pEntry = readdir(pDir))
+    {
+        const std::string Name{pEntry->d_name};
+        if (Name == "." || Name == "..")
+            continue;
+
+        CollectFiles(Path + '/' + Name, Files);
+    }
+    closedir(pDir);
+}
+
+} // namespace
+
+std::vector<CorpusFile> ReadCorpus(const std::vector<std::string>& Paths)
+{
+    std::vector<std::string> FilePaths;
+    for (const auto& Path : Paths)
+        CollectFiles(Path, FilePaths);
+    std::sort(FilePaths.begin(), FilePaths.end());
+
+    std::vector<CorpusFile> Corpus;
+    Corpus.reserve(FilePaths.size());
+    for (auto& Path : FilePaths)
+    {
+        std::ifstream File{Path, std::ios::binary};
+        if (!File)
+        {
+            LOG_WARNING_MESSAGE("Failed to open corpus file '", Path, "'");
+            continue;
+        }
+
+        CorpusFile CorpFile;
+        CorpFile.Path = std::move(Path);
+        CorpFile.Data.assign(std::istreambuf_iterator<char>{File}, std::istreambuf_iterator<char>{});
+        if (!CorpFile.Data.empty())
+            Corpus.emplace_back(std::move(CorpFile));
+    }
+
+    return Corpus;
+}
+
+} // namespace Testing
+
+} // namespace Diligent
@@ -0,0 +1,331 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "LoaderFuzzTargets.hpp"
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <algorithm>
+
+#include "DebugOutput.h"
+#include "DataBlobImpl.hpp"
+#include "RefCntAutoPtr.hpp"
+#include "TextureLoader.h"
+#include "Image.h"
+#include "GLTFJsonIndex.hpp"
+#include "GLTFMeshoptDecoder.hpp"
+#include "DXSDKMeshLoader.hpp"
+#include "DXSDKMeshConverter.hpp"
+
+// Must match the definitions in GLTFLoader.cpp where tinygltf is implemented
+#define TINYGLTF_NO_STB_IMAGE
+#define TINYGLTF_NO_STB_IMAGE_WRITE
+#include "../../../ThirdParty/tinygltf/tiny_gltf.h"
+
+namespace Diligent
+{
+
+namespace Testing
+{
+
+namespace
+{
+
+void DILIGENT_CALL_TYPE SilentMessageCallback(DEBUG_MESSAGE_SEVERITY /*Severity*/,
+                                              const Char* /*Message*/,
+                                              const Char* /*Function*/,
+                                              const Char* /*File*/,
+                                              int /*Line*/)
+{
+}
+
+// Fuzzers are expected to bound the input size themselves (-max_len), but the
+// loaders use 32-bit sizes in a few places, so reject anything that does not fit.
+constexpr size_t MaxInputSize = size_t{1} << 30;
+
+RefCntAutoPtr<IDataBlob> CreateDataBlob(const Uint8* pData, size_t Size)
+{
+    return RefCntAutoPtr<IDataBlob>{DataBlobImpl::Create(Size, pData)};
+}
+
+bool DecodeImage(const Uint8* pData, size_t Size)
+{
+    ImageLoadInfo LoadInfo;
+    LoadInfo.Format = Image::GetFileFormat(pData, Size);
+    if (LoadInfo.Format == IMAGE_FILE_FORMAT_UNKNOWN ||
+        LoadInfo.Format == IMAGE_FILE_FORMAT_DDS ||
+        LoadInfo.Format == IMAGE_FILE_FORMAT_KTX)
+    {
+        // DDS and KTX are only handled by the texture loader
+        return false;
+    }
+
+    auto pDataBlob = CreateDataBlob(pData, Size);
+
+    RefCntAutoPtr<Image> pImage;
+    Image::CreateFromDataBlob(pDataBlob, LoadInfo, &pImage);
+    return pImage != nullptr;
+}
+
+
+// External files are never loaded: the document may reference arbitrary paths.
+bool NoFileExists(const std::string&, void*)
+{
+    return false;
+}
+
+std::string KeepFilePath(const std::string& Path, void*)
+{
+    return Path;
+}
+
+bool NoReadWholeFile(std::vector<unsigned char>*, std::string* pError, const std::string& Path, void*)
+{
+    if (pError != nullptr)
+        *pError += "External file '" + Path + "' is not available";
+    return false;
+}
+
+bool NoWriteWholeFile(std::string*, const std::string&, const std::vector<unsigned char>&, void*)
+{
+    return false;
+}
+
+bool LoadEmbeddedImage(tinygltf::Image* /*gltf_image*/,
+                       const int /*gltf_image_idx*/,
+                       std::string* /*error*/,
+                       std::string* /*warning*/,
+                       int /*req_width*/,
+                       int /*req_height*/,
+                       const unsigned char* image_data,
+                       int                  size,
+                       void* /*user_data*/)
+{
+    // Decode the embedded image the same way the model loader does, but keep nothing
+    if (image_data != nullptr && size > 0)
+        DecodeImage(image_data, static_cast<size_t>(size));
+    return true;
+}
+
+constexpr Uint32 MaxJsonDepth = 64;
+
+// Visits every value in the index to exercise the accessors on malformed documents.
+void VisitJsonValue(const GLTF::JsonValue& Value, Uint32 Depth)
+{
+    if (Depth > MaxJsonDepth)
+        return;
+
+    switch (Value.GetType())
+    {
+        case GLTF::JSON_TYPE_NUMBER:
+            Value.GetNumber();
+            Value.GetInt();
+            break;
+
+        case GLTF::JSON_TYPE_STRING:
+            Value.GetString();
+            break;
+
+        case GLTF::JSON_TYPE_ARRAY:
+            Value.ProcessElements([Depth](Uint32, const GLTF::JsonValue& Elem) {
+                VisitJsonValue(Elem, Depth + 1);
+            });
+            break;
+
+        case GLTF::JSON_TYPE_OBJECT:
+            Value.ProcessMembers([Depth](const GLTF::JsonValue& Key, const GLTF::JsonValue& Member) {
+                Key.GetString();
+                VisitJsonValue(Member, Depth + 1);
+            });
+            break;
+
+        default:
+            Value.GetBool();
+            break;
+    }
+}
+
+bool IndexJson(const char* pText, size_t Size)
+{
+    GLTF::JsonIndex Index;
+    if (!Index.Parse(pText, Size))
+        return false;
+
+    VisitJsonValue(Index.GetRoot(), 0);
+    return true;
+}
+
+// Returns the JSON chunk of a GLB container, or an empty range if the container is malformed.
+std::pair<const char*, size_t> GetGlbJsonChunk(const Uint8* pData, size_t Size)
+{
+    constexpr size_t HeaderSize      = 12;
+    constexpr size_t ChunkHeaderSize = 8;
+    if (Size < HeaderSize + ChunkHeaderSize)
+        return {};
+
+    Uint32 ChunkLength = 0;
+    memcpy(&ChunkLength, pData + HeaderSize, sizeof(ChunkLength));
+    if (memcmp(pData + HeaderSize + 4, "JSON", 4) != 0 || ChunkLength > Size - HeaderSize - ChunkHeaderSize)
+        return {};
+
+    return {reinterpret_cast<const char*>(pData + HeaderSize + ChunkHeaderSize), ChunkLength};
+}
+
+} // namespace
+
+
+void SuppressLoaderLogOutput()
+{
+    SetDebugMessageCallback(SilentMessageCallback);
+}
+
+bool FuzzTextureLoader(const Uint8* pData, size_t Size)
+{
+    if (pData == nullptr || Size == 0 || Size > MaxInputSize)
+        return false;
+
+    TextureLoadInfo LoadInfo;
+    LoadInfo.Name = "Fuzz texture";
+
+    RefCntAutoPtr<ITextureLoader> pLoader;
+    CreateTextureLoaderFromMemory(pData, Size, /*MakeDataCopy = */ false, LoadInfo, &pLoader);
+    if (!pLoader)
+        return false;
+
+    const auto& Desc = pLoader->GetTextureDesc();
+
+    // Touch every subresource to make sure the loader did not produce dangling pointers
+    const auto TexData = pLoader->GetTextureData();
+    for (Uint32 i = 0; i < TexData.NumSubresources; ++i)
+    {
+        const auto& Subres = TexData.pSubResources[i];
+        if (Subres.pData != nullptr)
+        {
+            volatile Uint8 b = static_cast<const Uint8*>(Subres.pData)[0];
+            (void)b;
+        }
+    }
+
+    return Desc.Width > 0 && Desc.Height > 0;
+}
+
+bool FuzzImageDecoder(const Uint8* pData, size_t Size)
+{
+    if (pData == nullptr || Size == 0 || Size > MaxInputSize)
+        return false;
+
+    return DecodeImage(pData, Size);
+}
+
+bool FuzzGLTFParser(const Uint8* pData, size_t Size)
+{
+    if (pData == nullptr || Size == 0 || Size > MaxInputSize)
+        return false;
+
+    const bool IsGlb = Size >= 4 && memcmp(pData, "glTF", 4) == 0;
+
+    if (IsGlb)
+    {
+        const auto JsonChunk = GetGlbJsonChunk(pData, Size);
+        if (JsonChunk.first != nullptr)
+            IndexJson(JsonChunk.first, JsonChunk.second);
+    }
+    else
+    {
+        IndexJson(reinterpret_cast<const char*>(pData), Size);
+    }
+
+    tinygltf::TinyGLTF gltf_context;
+    gltf_context.SetImageLoader(LoadEmbeddedImage, nullptr);
+
+    tinygltf::FsCallbacks fsCallbacks = {};
+    fsCallbacks.FileExists            = NoFileExists;
+    fsCallbacks.ExpandFilePath        = KeepFilePath;
+    fsCallbacks.ReadWholeFile         = NoReadWholeFile;
+    fsCallbacks.WriteWholeFile        = NoWriteWholeFile;
+    gltf_context.SetFsCallbacks(fsCallbacks);
+
+    std::string     Error;
+    std::string     Warning;
+    tinygltf::Model gltf_model;
+
+    const auto Length = static_cast<unsigned int>(Size);
+    if (IsGlb)
+        return gltf_context.LoadBinaryFromMemory(&gltf_model, &Error, &Warning, pData, Length, "");
+    else
+        return gltf_context.LoadASCIIFromString(&gltf_model, &Error, &Warning, reinterpret_cast<const char*>(pData), Length, "");
+}
+
+bool FuzzDXSDKMesh(const Uint8* pData, size_t Size)
+{
+    if (pData == nullptr || Size == 0 || Size > MaxInputSize)
+        return false;
+
+    // The mesh is loaded in place, so the data must outlive it
+    std::vector<Uint8> Data{pData, pData + Size};
+
+    DXSDKMesh Mesh;
+    if (!Mesh.Create(Data.data(), static_cast<Uint32>(Data.size()), /*InPlace = */ true))
+        return false;
+
+    tinygltf::Model           gltf_model;
+    std::vector<const Uint8*> BufferData;
+    GLTF::ConvertDXSDKMeshToGltf(Mesh, gltf_model, BufferData);
+    return true;
+}
+
+bool FuzzMeshoptDecoder(const Uint8* pData, size_t Size)
+{
+    constexpr size_t HeaderSize = 4;
+    if (pData == nullptr || Size < HeaderSize || Size > MaxInputSize)
+        return false;
+
+    GLTF::MeshoptBufferViewDesc Desc;
+    Desc.Mode   = static_cast<GLTF::MESHOPT_COMPRESSION_MODE>(pData[0] % GLTF::MESHOPT_COMPRESSION_MODE_COUNT);
+    Desc.Filter = static_cast<GLTF::MESHOPT_COMPRESSION_FILTER>(pData[1] % GLTF::MESHOPT_COMPRESSION_FILTER_COUNT);
+    Desc.Count  = (size_t{pData[2]} << 8u) | size_t{pData[3] & 0xF0u};
+    if (Desc.Mode == GLTF::MESHOPT_COMPRESSION_MODE_ATTRIBUTES)
+    {
+        // Stride is a multiple of 4 in the [4, 64] range
+        Desc.ByteStride = (size_t{pData[3] & 0x0Fu} + 1) * 4;
+    }
+    else
+    {
+        Desc.ByteStride = (pData[3] & 0x01u) ? 4 : 2;
+        // Triangle lists must have a multiple of 3 indices
+        if (Desc.Mode == GLTF::MESHOPT_COMPRESSION_MODE_TRIANGLES)
+            Desc.Count -= Desc.Count % 3;
+    }
+
+    std::vector<Uint8> Decoded(std::max(GLTF::GetMeshoptDecodedSize(Desc), size_t{1}));
+    return GLTF::DecodeMeshoptBufferView(Desc, pData + HeaderSize, Size - HeaderSize, Decoded.data());
+}
+
+} // namespace Testing
+
+} // namespace Diligent
@@ -0,0 +1,63 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+// Replays corpus files through a fuzz target when libFuzzer is not available
+// (e.g. when building with GCC), which allows using the fuzzers as regression tests.
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "CorpusFiles.hpp"
+
+extern "C" int LLVMFuzzerInitialize(int* argc, char*** argv);
+extern "C" int LLVMFuzzerTestOneInput(const Diligent::Uint8* pData, size_t Size);
+
+int main(int argc, char** argv)
+{
+    LLVMFuzzerInitialize(&argc, &argv);
+
+    std::vector<std::string> Paths;
+    for (int i = 1; i < argc; ++i)
+    {
+        // Ignore libFuzzer options so that the same command line works for both builds
+        if (argv[i][0] != '-')
+            Paths.emplace_back(argv[i]);
+    }
+    if (Paths.empty())
+    {
+        printf("Usage: %s <corpus file or directory>...\n", argv[0]);
+        return 1;
+    }
+
+    const auto Corpus = Diligent::Testing::ReadCorpus(Paths);
+    for (const auto& File : Corpus)
+        LLVMFuzzerTestOneInput(File.Data.data(), File.Data.size());
+
+    printf("Executed %d inputs\n", static_cast<int>(Corpus.size()));
+    return 0;
+}
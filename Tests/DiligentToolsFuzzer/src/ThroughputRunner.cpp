@@ -0,0 +1,225 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+// Measures the throughput of the texture and asset loaders on a corpus of files.
+// The throughput is reported in megabytes of the source data per second, per format.
+//
+// Usage: DiligentToolsLoaderThroughput [--min-time <seconds>] [--min-iterations <N>] <file or directory>...
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <strings.h>
+
+#include "CorpusFiles.hpp"
+#include "LoaderFuzzTargets.hpp"
+#include "Image.h"
+
+using namespace Diligent;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+using LoaderFuncType = bool (*)(const Uint8* pData, size_t Size);
+
+struct LoaderStage
+{
+    const char*    Format;
+    const char*    Stage;
+    LoaderFuncType Func;
+};
+
+struct StageStats
+{
+    size_t Files      = 0;
+    size_t Failed     = 0;
+    Uint64 Bytes      = 0;
+    Uint64 Iterations = 0;
+    double Seconds    = 0;
+};
+
+const char* GetImageFileFormatName(IMAGE_FILE_FORMAT Format)
+{
+    switch (Format)
+    {
+        // clang-format off
+        case IMAGE_FILE_FORMAT_JPEG: return "JPEG";
+        case IMAGE_FILE_FORMAT_PNG:  return "PNG";
+        case IMAGE_FILE_FORMAT_TIFF: return "TIFF";
+        case IMAGE_FILE_FORMAT_DDS:  return "DDS";
+        case IMAGE_FILE_FORMAT_KTX:  return "KTX";
+        case IMAGE_FILE_FORMAT_SGI:  return "SGI";
+        case IMAGE_FILE_FORMAT_HDR:  return "HDR";
+        case IMAGE_FILE_FORMAT_TGA:  return "TGA";
+        case IMAGE_FILE_FORMAT_EXR:  return "EXR";
+        // clang-format on
+        default: return nullptr;
+    }
+}
+
+bool HasExtension(const std::string& Path, const char* Ext)
+{
+    const auto ExtLen = strlen(Ext);
+    return Path.length() > ExtLen && strcasecmp(Path.c_str() + Path.length() - ExtLen, Ext) == 0;
+}
+
+// Returns the loader stages that process the file.
+std::vector<LoaderStage> GetLoaderStages(const CorpusFile& File)
+{
+    const auto* pData = File.Data.data();
+    const auto  Size  = File.Data.size();
+
+    if (HasExtension(File.Path, ".sdkmesh"))
+        return {{"SDKMESH", "Load+Convert", FuzzDXSDKMesh}};
+
+    if (Size >= 4 && memcmp(pData, "glTF", 4) == 0)
+        return {{"GLB", "Parse", FuzzGLTFParser}};
+
+    if (HasExtension(File.Path, ".gltf"))
+        return {{"glTF", "Parse", FuzzGLTFParser}};
+
+    const auto ImgFormat = Image::GetFileFormat(pData, Size, File.Path.c_str());
+    if (const auto* FormatName = GetImageFileFormatName(ImgFormat))
+    {
+        if (ImgFormat == IMAGE_FILE_FORMAT_DDS || ImgFormat == IMAGE_FILE_FORMAT_KTX)
+            return {{FormatName, "TextureLoader", FuzzTextureLoader}};
+
+        // The texture loader additionally converts the pixels and generates the mip levels
+        return {
+            {FormatName, "Decode", FuzzImageDecoder},
+            {FormatName, "TextureLoader", FuzzTextureLoader},
+        };
+    }
+
+    return {};
+}
+
+void PrintUsage(const char* ExeName)
+{
+    printf("Usage: %s [--min-time <seconds>] [--min-iterations <N>] <file or directory>...\n", ExeName);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    double                   MinTime       = 0.25;
+    Uint64                   MinIterations = 1;
+    std::vector<std::string> Paths;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc)
+            MinTime = atof(argv[++i]);
+        else if (strcmp(argv[i], "--min-iterations") == 0 && i + 1 < argc)
+            MinIterations = std::max<Uint64>(strtoull(argv[++i], nullptr, 10), 1);
+        else if (argv[i][0] == '-')
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        else
+            Paths.emplace_back(argv[i]);
+    }
+    if (Paths.empty())
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    SuppressLoaderLogOutput();
+
+    const auto Corpus = ReadCorpus(Paths);
+
+    // Sorted by format and stage
+    std::map<std::pair<std::string, std::string>, StageStats> Stats;
+
+    size_t NumSkipped = 0;
+    for (const auto& File : Corpus)
+    {
+        const auto Stages = GetLoaderStages(File);
+        if (Stages.empty())
+        {
+            ++NumSkipped;
+            continue;
+        }
+
+        for (const auto& Stage : Stages)
+        {
+            auto& StageStat = Stats[{Stage.Format, Stage.Stage}];
+            ++StageStat.Files;
+
+            Uint64 Iterations = 0;
+            double Seconds    = 0;
+            bool   Succeeded  = true;
+
+            const auto StartTime = std::chrono::high_resolution_clock::now();
+            while (Iterations < MinIterations || Seconds < MinTime)
+            {
+                Succeeded = Stage.Func(File.Data.data(), File.Data.size());
+                ++Iterations;
+                Seconds = std::chrono::duration<double>{std::chrono::high_resolution_clock::now() - StartTime}.count();
+
+                // Do not spend time on files that the loader rejects
+                if (!Succeeded)
+                    break;
+            }
+
+            if (!Succeeded)
+            {
+                printf("%s: %s %s failed\n", File.Path.c_str(), Stage.Format, Stage.Stage);
+                ++StageStat.Failed;
+                continue;
+            }
+
+            StageStat.Bytes += File.Data.size() * Iterations;
+            StageStat.Iterations += Iterations;
+            StageStat.Seconds += Seconds;
+        }
+    }
+
+    printf("\n%-8s %-14s %6s %6s %12s %10s %10s\n", "Format", "Stage", "Files", "Failed", "MB", "Seconds", "MB/s");
+    for (const auto& it : Stats)
+    {
+        const auto& Stat = it.second;
+        const auto  MB   = static_cast<double>(Stat.Bytes) / (1024.0 * 1024.0);
+        printf("%-8s %-14s %6d %6d %12.2f %10.3f %10.2f\n",
+               it.first.first.c_str(), it.first.second.c_str(),
+               static_cast<int>(Stat.Files), static_cast<int>(Stat.Failed),
+               MB, Stat.Seconds, Stat.Seconds > 0 ? MB / Stat.Seconds : 0.0);
+    }
+    if (NumSkipped > 0)
+        printf("\nSkipped %d files of unknown format\n", static_cast<int>(NumSkipped));
+
+    return 0;
+}
@@ -0,0 +1,542 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "GLTFLoader.hpp"
+#include "GLTFWriter.hpp"
+#include "GPUTestingEnvironment.hpp"
+
+using namespace Diligent;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+TEST(Tools_AssetLoader, GLTFInstancing)
+{
+    auto* pEnv    = GPUTestingEnvironment::GetInstance();
+    auto* pDevice = pEnv->GetDevice();
+    auto* pCtx    = pEnv->GetDeviceContext();
+
+    GLTF::ModelCreateInfo ModelCI;
+    ModelCI.FileName = "GLTF/Instancing.gltf";
+    GLTF::Model Model{pDevice, pCtx, ModelCI};
+
+    ModelCI.FileName = "GLTF/InstancingReference.gltf";
+    GLTF::Model RefModel{pDevice, pCtx, ModelCI};
+
+    // The reference model contains a separate child node for every instance
+    ASSERT_EQ(Model.Scenes.size(), 1u);
+    ASSERT_EQ(Model.Nodes.size(), 1u);
+    ASSERT_EQ(RefModel.Nodes.size(), 4u);
+    EXPECT_EQ(Model.InstanceCount, 3u);
+    EXPECT_EQ(RefModel.InstanceCount, 0u);
+
+    const auto& InstancedNode = Model.Nodes[0];
+    ASSERT_TRUE(InstancedNode.IsInstanced());
+    EXPECT_EQ(InstancedNode.InstanceMatrices.size(), 3u);
+    EXPECT_EQ(InstancedNode.FirstInstance, 0u);
+
+    const float4x4 RootTransform = float4x4::RotationY(0.5f) * float4x4::Translation(1, 2, 3);
+
+    GLTF::ModelTransforms Transforms;
+    Model.ComputeTransforms(0, Transforms, RootTransform);
+    ASSERT_EQ(Transforms.InstanceMatrices.size(), 3u);
+
+    GLTF::ModelTransforms RefTransforms;
+    RefModel.ComputeTransforms(0, RefTransforms, RootTransform);
+    EXPECT_TRUE(RefTransforms.InstanceMatrices.empty());
+
+    for (const auto* pRefNode : RefModel.Scenes[0].LinearNodes)
+    {
+        if (pRefNode->pMesh == nullptr)
+            continue;
+
+        const auto  InstanceId = static_cast<size_t>(pRefNode->Index) - 1;
+        const auto& Mat        = Transforms.InstanceMatrices[InstancedNode.FirstInstance + InstanceId];
+        const auto& RefMat     = RefTransforms.NodeGlobalMatrices[pRefNode->Index];
+        for (int r = 0; r < 4; ++r)
+        {
+            for (int c = 0; c < 4; ++c)
+                EXPECT_NEAR(Mat[r][c], RefMat[r][c], 1e-5f) << "Instance " << InstanceId << ", element [" << r << "][" << c << "]";
+        }
+    }
+
+    const auto BB    = Model.ComputeBoundingBox(0, Transforms);
+    const auto RefBB = RefModel.ComputeBoundingBox(0, RefTransforms);
+    for (int i = 0; i < 3; ++i)
+    {
+        EXPECT_NEAR(BB.Min[i], RefBB.Min[i], 1e-4f);
+        EXPECT_NEAR(BB.Max[i], RefBB.Max[i], 1e-4f);
+    }
+}
+
+TEST(Tools_AssetLoader, GLTFFastJsonParser)
+{
+    auto* pEnv    = GPUTestingEnvironment::GetInstance();
+    auto* pDevice = pEnv->GetDevice();
+    auto* pCtx    = pEnv->GetDeviceContext();
+
+    // SkinnedAnimation.gltf reads the animation keys through accessors with byte offsets
+    for (const char* FileName : {"GLTF/Instancing.gltf", "GLTF/InstancingReference.gltf", "GLTF/SkinnedAnimation.gltf"})
+    {
+        GLTF::ModelCreateInfo ModelCI;
+        ModelCI.FileName = FileName;
+        GLTF::Model RefModel{pDevice, pCtx, ModelCI};
+
+        ModelCI.UseFastJsonParser = true;
+        GLTF::Model Model{pDevice, pCtx, ModelCI};
+
+        ASSERT_EQ(Model.Scenes.size(), RefModel.Scenes.size()) << FileName;
+        ASSERT_EQ(Model.Nodes.size(), RefModel.Nodes.size()) << FileName;
+        ASSERT_EQ(Model.Meshes.size(), RefModel.Meshes.size()) << FileName;
+        EXPECT_EQ(Model.Materials.size(), RefModel.Materials.size()) << FileName;
+        EXPECT_EQ(Model.InstanceCount, RefModel.InstanceCount) << FileName;
+        EXPECT_EQ(Model.Extensions, RefModel.Extensions) << FileName;
+
+        for (size_t i = 0; i < Model.Nodes.size(); ++i)
+        {
+            const auto& Node    = Model.Nodes[i];
+            const auto& RefNode = RefModel.Nodes[i];
+            EXPECT_EQ(Node.Name, RefNode.Name);
+            EXPECT_EQ(Node.Translation, RefNode.Translation);
+            EXPECT_EQ(Node.Rotation, RefNode.Rotation);
+            EXPECT_EQ(Node.Scale, RefNode.Scale);
+            EXPECT_EQ(Node.Matrix, RefNode.Matrix);
+            EXPECT_EQ(Node.Children.size(), RefNode.Children.size());
+            EXPECT_EQ(Node.pMesh != nullptr, RefNode.pMesh != nullptr);
+            EXPECT_EQ(Node.pSkin != nullptr, RefNode.pSkin != nullptr);
+            EXPECT_EQ(Node.SkinTransformsIndex, RefNode.SkinTransformsIndex);
+            EXPECT_EQ(Node.InstanceMatrices, RefNode.InstanceMatrices);
+        }
+
+        ASSERT_EQ(Model.Skins.size(), RefModel.Skins.size()) << FileName;
+        for (size_t i = 0; i < Model.Skins.size(); ++i)
+        {
+            const auto& Skin    = Model.Skins[i];
+            const auto& RefSkin = RefModel.Skins[i];
+            EXPECT_EQ(Skin.Name, RefSkin.Name);
+            EXPECT_EQ(Skin.InverseBindMatrices, RefSkin.InverseBindMatrices);
+            ASSERT_EQ(Skin.Joints.size(), RefSkin.Joints.size());
+            for (size_t j = 0; j < Skin.Joints.size(); ++j)
+                EXPECT_EQ(Skin.Joints[j]->Index, RefSkin.Joints[j]->Index);
+        }
+
+        ASSERT_EQ(Model.Animations.size(), RefModel.Animations.size()) << FileName;
+        for (size_t i = 0; i < Model.Animations.size(); ++i)
+        {
+            const auto& Anim    = Model.Animations[i];
+            const auto& RefAnim = RefModel.Animations[i];
+            EXPECT_EQ(Anim.Name, RefAnim.Name);
+            EXPECT_EQ(Anim.Start, RefAnim.Start);
+            EXPECT_EQ(Anim.End, RefAnim.End);
+
+            ASSERT_EQ(Anim.Samplers.size(), RefAnim.Samplers.size());
+            for (size_t s = 0; s < Anim.Samplers.size(); ++s)
+            {
+                EXPECT_EQ(Anim.Samplers[s].Interpolation, RefAnim.Samplers[s].Interpolation);
+                EXPECT_EQ(Anim.Samplers[s].Inputs, RefAnim.Samplers[s].Inputs);
+                EXPECT_EQ(Anim.Samplers[s].OutputsVec4, RefAnim.Samplers[s].OutputsVec4);
+            }
+
+            ASSERT_EQ(Anim.Channels.size(), RefAnim.Channels.size());
+            for (size_t c = 0; c < Anim.Channels.size(); ++c)
+            {
+                EXPECT_EQ(Anim.Channels[c].PathType, RefAnim.Channels[c].PathType);
+                EXPECT_EQ(Anim.Channels[c].pNode->Index, RefAnim.Channels[c].pNode->Index);
+                EXPECT_EQ(Anim.Channels[c].SamplerIndex, RefAnim.Channels[c].SamplerIndex);
+            }
+
+            for (float Time = RefAnim.Start; Time <= RefAnim.End; Time += 0.25f)
+            {
+                GLTF::ModelTransforms Transforms;
+                Model.ComputeTransforms(0, Transforms, float4x4::Identity(), static_cast<int>(i), Time);
+
+                GLTF::ModelTransforms RefTransforms;
+                RefModel.ComputeTransforms(0, RefTransforms, float4x4::Identity(), static_cast<int>(i), Time);
+
+                EXPECT_EQ(Transforms.NodeGlobalMatrices, RefTransforms.NodeGlobalMatrices) << "Time " << Time;
+                ASSERT_EQ(Transforms.Skins.size(), RefTransforms.Skins.size());
+                for (size_t j = 0; j < Transforms.Skins.size(); ++j)
+                    EXPECT_EQ(Transforms.Skins[j].JointMatrices, RefTransforms.Skins[j].JointMatrices) << "Time " << Time;
+            }
+        }
+
+        for (size_t i = 0; i < Model.Meshes.size(); ++i)
+        {
+            const auto& Mesh    = Model.Meshes[i];
+            const auto& RefMesh = RefModel.Meshes[i];
+            EXPECT_EQ(Mesh.Name, RefMesh.Name);
+            ASSERT_EQ(Mesh.Primitives.size(), RefMesh.Primitives.size());
+            for (size_t p = 0; p < Mesh.Primitives.size(); ++p)
+            {
+                const auto& Prim    = Mesh.Primitives[p];
+                const auto& RefPrim = RefMesh.Primitives[p];
+                EXPECT_EQ(Prim.FirstIndex, RefPrim.FirstIndex);
+                EXPECT_EQ(Prim.IndexCount, RefPrim.IndexCount);
+                EXPECT_EQ(Prim.VertexCount, RefPrim.VertexCount);
+                EXPECT_EQ(Prim.MaterialId, RefPrim.MaterialId);
+                EXPECT_EQ(Prim.BB.Min, RefPrim.BB.Min);
+                EXPECT_EQ(Prim.BB.Max, RefPrim.BB.Max);
+            }
+        }
+    }
+}
+
+TEST(Tools_AssetLoader, GLTFMeshoptCompression)
+{
+    auto* pEnv    = GPUTestingEnvironment::GetInstance();
+    auto* pDevice = pEnv->GetDevice();
+    auto* pCtx    = pEnv->GetDeviceContext();
+
+    GLTF::ModelCreateInfo ModelCI;
+    ModelCI.FileName = "GLTF/IndexedPrimitives.gltf";
+    GLTF::Model RefModel{pDevice, pCtx, ModelCI};
+
+    auto WriteModel = [&](const GLTF::Model& Src, const char* FileName) {
+        GLTF::ModelWriteInfo WriteInfo;
+        WriteInfo.FileName = FileName;
+        EXPECT_TRUE(GLTF::WriteModel(pDevice, pCtx, Src, WriteInfo)) << FileName;
+
+        std::ifstream     File{FileName, std::ios::binary};
+        std::vector<char> Data{std::istreambuf_iterator<char>{File}, std::istreambuf_iterator<char>{}};
+        File.close();
+        std::remove(FileName);
+        return Data;
+    };
+    const auto RefData = WriteModel(RefModel, "GLTFMeshoptCompressionRef.glb");
+    ASSERT_FALSE(RefData.empty());
+
+    // The compressed files are laid out the same way as gltfpack -cc output: the buffer views reference
+    // the fallback buffer that has no uri, and the compressed data is stored in the first buffer.
+    for (const char* FileName : {"GLTF/IndexedPrimitivesMeshopt.gltf", "GLTF/IndexedPrimitivesMeshopt.glb"})
+    {
+        for (bool UseFastJsonParser : {false, true})
+        {
+            ModelCI.FileName          = FileName;
+            ModelCI.UseFastJsonParser = UseFastJsonParser;
+            GLTF::Model Model{pDevice, pCtx, ModelCI};
+
+            ASSERT_EQ(Model.Meshes.size(), RefModel.Meshes.size()) << FileName;
+            const auto& Prims    = Model.Meshes[0].Primitives;
+            const auto& RefPrims = RefModel.Meshes[0].Primitives;
+            ASSERT_EQ(Prims.size(), RefPrims.size()) << FileName;
+            for (size_t p = 0; p < Prims.size(); ++p)
+            {
+                EXPECT_EQ(Prims[p].FirstIndex, RefPrims[p].FirstIndex) << FileName << ", primitive " << p;
+                EXPECT_EQ(Prims[p].IndexCount, RefPrims[p].IndexCount) << FileName << ", primitive " << p;
+                EXPECT_EQ(Prims[p].VertexCount, RefPrims[p].VertexCount) << FileName << ", primitive " << p;
+                EXPECT_EQ(Prims[p].BB.Min, RefPrims[p].BB.Min) << FileName << ", primitive " << p;
+                EXPECT_EQ(Prims[p].BB.Max, RefPrims[p].BB.Max) << FileName << ", primitive " << p;
+            }
+
+            // The decoded vertices and indices must match the uncompressed model
+            const auto Data = WriteModel(Model, "GLTFMeshoptCompression.glb");
+            EXPECT_EQ(Data, RefData) << FileName << (UseFastJsonParser ? " (fast JSON parser)" : "");
+        }
+    }
+}
+
+TEST(Tools_AssetLoader, GLTFMeshoptInvalidExtension)
+{
+    auto* pEnv    = GPUTestingEnvironment::GetInstance();
+    auto* pDevice = pEnv->GetDevice();
+    auto* pCtx    = pEnv->GetDeviceContext();
+
+    std::string Json;
+    {
+        std::ifstream File{"GLTF/IndexedPrimitivesMeshopt.gltf", std::ios::binary};
+        Json.assign(std::istreambuf_iterator<char>{File}, std::istreambuf_iterator<char>{});
+    }
+    ASSERT_FALSE(Json.empty());
+
+    // The file embeds its buffers as data URIs, so a modified copy can be written anywhere
+    using Replacements = std::vector<std::pair<const char*, const char*>>;
+    auto TestInvalidFile = [&](const Replacements& Changes, const char* ExpectedError) {
+        auto Modified = Json;
+        for (const auto& Change : Changes)
+        {
+            const auto Pos = Modified.find(Change.first);
+            ASSERT_NE(Pos, std::string::npos) << Change.first;
+            Modified.replace(Pos, strlen(Change.first), Change.second);
+        }
+
+        const char* FileName = "GLTFMeshoptInvalidExtension.gltf";
+        {
+            std::ofstream File{FileName, std::ios::binary};
+            File << Modified;
+        }
+
+        GLTF::ModelCreateInfo ModelCI;
+        ModelCI.FileName = FileName;
+        {
+            TestingEnvironment::ErrorScope ExpectedErrors{ExpectedError};
+            EXPECT_THROW(GLTF::Model(pDevice, pCtx, ModelCI), std::runtime_error) << ExpectedError;
+        }
+        std::remove(FileName);
+    };
+
+    const char* AttribsExt = R"("byteStride": 12,
+                    "count": 7,)";
+    const char* IndicesExt = R"("byteStride": 4,
+                    "count": 9,)";
+
+    TestInvalidFile({{AttribsExt, R"("byteStride": 12, "count": -7,)"}}, "is negative");
+    TestInvalidFile({{AttribsExt, R"("byteStride": 12, "count": 7.5,)"}}, "is not a valid non-negative integer");
+    TestInvalidFile({{AttribsExt, R"("byteStride": 12, "count": 1e300,)"}}, "is not a valid non-negative integer");
+    TestInvalidFile({{AttribsExt, R"("byteStride": 10, "count": 7,)"}}, "is not a multiple of 4");
+    TestInvalidFile({{AttribsExt, R"("byteStride": 260, "count": 7,)"}}, "is not a multiple of 4");
+    TestInvalidFile({{IndicesExt, R"("byteStride": 1, "count": 9,)"}}, "must be 2 or 4");
+    TestInvalidFile({{AttribsExt, R"("byteStride": 12, "count": 8,)"}}, "does not match its byte length");
+    // 700 vertices of 12 bytes can't be decoded from 74 bytes of compressed data
+    TestInvalidFile({{R"("byteLength": 84,)", R"("byteLength": 8400,)"}, {AttribsExt, R"("byteStride": 12, "count": 700,)"}}, "is too small to hold");
+}
+
+TEST(Tools_AssetLoader, GLTFWriterRoundTrip)
+{
+    auto* pEnv    = GPUTestingEnvironment::GetInstance();
+    auto* pDevice = pEnv->GetDevice();
+    auto* pCtx    = pEnv->GetDeviceContext();
+
+    GLTF::ModelCreateInfo ModelCI;
+    ModelCI.FileName = "GLTF/Instancing.gltf";
+    GLTF::Model RefModel{pDevice, pCtx, ModelCI};
+
+    for (const char* FileName : {"GLTFWriterRoundTrip.glb", "GLTFWriterRoundTrip.gltf"})
+    {
+        GLTF::ModelWriteInfo WriteInfo;
+        WriteInfo.FileName = FileName;
+        ASSERT_TRUE(GLTF::WriteModel(pDevice, pCtx, RefModel, WriteInfo)) << FileName;
+
+        ModelCI.FileName = FileName;
+        GLTF::Model Model{pDevice, pCtx, ModelCI};
+
+        ASSERT_EQ(Model.Scenes.size(), RefModel.Scenes.size()) << FileName;
+        ASSERT_EQ(Model.Nodes.size(), RefModel.Nodes.size()) << FileName;
+        ASSERT_EQ(Model.Meshes.size(), RefModel.Meshes.size()) << FileName;
+        ASSERT_EQ(Model.Materials.size(), RefModel.Materials.size()) << FileName;
+        EXPECT_EQ(Model.GetTextureCount(), RefModel.GetTextureCount()) << FileName;
+        EXPECT_EQ(Model.InstanceCount, RefModel.InstanceCount) << FileName;
+        EXPECT_EQ(Model.DefaultSceneId, RefModel.DefaultSceneId) << FileName;
+
+        for (size_t i = 0; i < Model.Nodes.size(); ++i)
+        {
+            const auto& Node    = Model.Nodes[i];
+            const auto& RefNode = RefModel.Nodes[i];
+            EXPECT_EQ(Node.Name, RefNode.Name);
+            EXPECT_EQ(Node.Children.size(), RefNode.Children.size());
+            EXPECT_EQ(Node.pMesh != nullptr, RefNode.pMesh != nullptr);
+            EXPECT_EQ(Node.ComputeLocalTransform(), RefNode.ComputeLocalTransform());
+
+            ASSERT_EQ(Node.InstanceMatrices.size(), RefNode.InstanceMatrices.size());
+            for (size_t inst = 0; inst < Node.InstanceMatrices.size(); ++inst)
+            {
+                const auto& Mat    = Node.InstanceMatrices[inst];
+                const auto& RefMat = RefNode.InstanceMatrices[inst];
+                for (int r = 0; r < 4; ++r)
+                {
+                    for (int c = 0; c < 4; ++c)
+                        EXPECT_NEAR(Mat[r][c], RefMat[r][c], 1e-5f) << "Instance " << inst << ", element [" << r << "][" << c << "]";
+                }
+            }
+        }
+
+        for (size_t i = 0; i < Model.Meshes.size(); ++i)
+        {
+            const auto& Mesh    = Model.Meshes[i];
+            const auto& RefMesh = RefModel.Meshes[i];
+            EXPECT_EQ(Mesh.Name, RefMesh.Name);
+            ASSERT_EQ(Mesh.Primitives.size(), RefMesh.Primitives.size());
+            for (size_t p = 0; p < Mesh.Primitives.size(); ++p)
+            {
+                const auto& Prim    = Mesh.Primitives[p];
+                const auto& RefPrim = RefMesh.Primitives[p];
+                EXPECT_EQ(Prim.IndexCount, RefPrim.IndexCount);
+                EXPECT_EQ(Prim.VertexCount, RefPrim.VertexCount);
+                EXPECT_EQ(Prim.MaterialId, RefPrim.MaterialId);
+                EXPECT_EQ(Prim.BB.Min, RefPrim.BB.Min);
+                EXPECT_EQ(Prim.BB.Max, RefPrim.BB.Max);
+            }
+        }
+
+        for (size_t i = 0; i < Model.Materials.size(); ++i)
+        {
+            const auto& Mat    = Model.Materials[i];
+            const auto& RefMat = RefModel.Materials[i];
+            EXPECT_EQ(Mat.Attribs.BaseColorFactor, RefMat.Attribs.BaseColorFactor);
+            EXPECT_EQ(Mat.Attribs.EmissiveFactor, RefMat.Attribs.EmissiveFactor);
+            EXPECT_EQ(Mat.Attribs.MetallicFactor, RefMat.Attribs.MetallicFactor);
+            EXPECT_EQ(Mat.Attribs.RoughnessFactor, RefMat.Attribs.RoughnessFactor);
+            EXPECT_EQ(Mat.Attribs.AlphaMode, RefMat.Attribs.AlphaMode);
+            EXPECT_EQ(Mat.Attribs.Workflow, RefMat.Attribs.Workflow);
+            EXPECT_EQ(Mat.DoubleSided, RefMat.DoubleSided);
+        }
+
+        std::remove(FileName);
+    }
+    std::remove("GLTFWriterRoundTrip.bin");
+}
+
+TEST(Tools_AssetLoader, GLTFAdaptiveIndexType)
+{
+    auto* pEnv    = GPUTestingEnvironment::GetInstance();
+    auto* pDevice = pEnv->GetDevice();
+    auto* pCtx    = pEnv->GetDeviceContext();
+
+    // The model contains a quad and a triangle with 32-bit indices
+    GLTF::ModelCreateInfo ModelCI;
+    ModelCI.FileName = "GLTF/IndexedPrimitives.gltf";
+    GLTF::Model RefModel{pDevice, pCtx, ModelCI};
+
+    ModelCI.AdaptiveIndexType = true;
+    GLTF::Model Model{pDevice, pCtx, ModelCI};
+
+    ASSERT_EQ(Model.Meshes.size(), 1u);
+    ASSERT_EQ(RefModel.Meshes.size(), 1u);
+    const auto& Prims    = Model.Meshes[0].Primitives;
+    const auto& RefPrims = RefModel.Meshes[0].Primitives;
+    ASSERT_EQ(Prims.size(), 2u);
+    ASSERT_EQ(RefPrims.size(), 2u);
+    for (size_t p = 0; p < Prims.size(); ++p)
+    {
+        const auto& Prim    = Prims[p];
+        const auto& RefPrim = RefPrims[p];
+        EXPECT_EQ(RefPrim.IndexType, VT_UINT32) << "Primitive " << p;
+        EXPECT_EQ(RefPrim.BaseVertex, 0u) << "Primitive " << p;
+
+        // Indices relative to the first vertex fit into 16 bits
+        EXPECT_EQ(Prim.IndexType, VT_UINT16) << "Primitive " << p;
+        EXPECT_EQ(Prim.BaseVertex, Prim.FirstVertex) << "Primitive " << p;
+        EXPECT_EQ(Prim.FirstVertex, RefPrim.FirstVertex) << "Primitive " << p;
+        EXPECT_EQ(Prim.FirstIndex, RefPrim.FirstIndex) << "Primitive " << p;
+        EXPECT_EQ(Prim.IndexCount, RefPrim.IndexCount) << "Primitive " << p;
+    }
+    EXPECT_EQ(Prims[1].BaseVertex, 4u);
+
+    EXPECT_NE(Model.GetIndexBuffer(VT_UINT16), nullptr);
+    EXPECT_EQ(Model.GetIndexBuffer(VT_UINT32), nullptr);
+    EXPECT_EQ(Model.GetMemoryUsage().Indices.GPUReserved * 2, RefModel.GetMemoryUsage().Indices.GPUReserved);
+
+    // Both models must produce identical files, which verifies the index values
+    auto WriteModel = [&](const GLTF::Model& Src, const char* FileName) {
+        GLTF::ModelWriteInfo WriteInfo;
+        WriteInfo.FileName = FileName;
+        EXPECT_TRUE(GLTF::WriteModel(pDevice, pCtx, Src, WriteInfo)) << FileName;
+
+        std::ifstream     File{FileName, std::ios::binary};
+        std::vector<char> Data{std::istreambuf_iterator<char>{File}, std::istreambuf_iterator<char>{}};
+        File.close();
+        std::remove(FileName);
+        return Data;
+    };
+    const auto Data    = WriteModel(Model, "GLTFAdaptiveIndexType.glb");
+    const auto RefData = WriteModel(RefModel, "GLTFAdaptiveIndexTypeRef.glb");
+    EXPECT_FALSE(Data.empty());
+    EXPECT_EQ(Data, RefData);
+}
+
+TEST(Tools_AssetLoader, GLTFAnimationCompressionRoundTrip)
+{
+    auto* pEnv    = GPUTestingEnvironment::GetInstance();
+    auto* pDevice = pEnv->GetDevice();
+    auto* pCtx    = pEnv->GetDeviceContext();
+
+    // The node moves during the first second and then stays still for another second
+    GLTF::ModelCreateInfo ModelCI;
+    ModelCI.FileName = "GLTF/Animation.gltf";
+    GLTF::Model RefModel{pDevice, pCtx, ModelCI};
+
+    GLTF::AnimationCompressionInfo CompressionInfo;
+    ModelCI.pAnimationCompression = &CompressionInfo;
+    GLTF::Model Model{pDevice, pCtx, ModelCI};
+
+    ASSERT_EQ(RefModel.Animations.size(), 1u);
+    ASSERT_EQ(Model.Animations.size(), 1u);
+    const auto& RefAnim = RefModel.Animations[0];
+    EXPECT_EQ(RefAnim.Start, 0.f);
+    EXPECT_EQ(RefAnim.End, 2.f);
+    EXPECT_EQ(Model.Animations[0].Start, RefAnim.Start);
+    EXPECT_EQ(Model.Animations[0].End, RefAnim.End);
+
+    const auto& RefSampler = RefAnim.Samplers[0];
+    const auto& Sampler    = Model.Animations[0].Samplers[0];
+    ASSERT_FALSE(Sampler.Compressed.IsEmpty());
+    // The source keys of compressed samplers are released
+    EXPECT_TRUE(Sampler.Inputs.empty());
+    EXPECT_TRUE(Sampler.OutputsVec4.empty());
+
+    // The constant part of the track is reduced to its first and last keys
+    const Uint32 NumKeys = Sampler.Compressed.GetKeyCount();
+    EXPECT_EQ(NumKeys, 3u);
+    EXPECT_EQ(Sampler.Compressed.GetKeyTime(0), RefSampler.Inputs.front());
+    EXPECT_EQ(Sampler.Compressed.GetKeyTime(NumKeys - 1), RefSampler.Inputs.back());
+
+    const char* FileName = "GLTFAnimationCompressionRoundTrip.glb";
+
+    GLTF::ModelWriteInfo WriteInfo;
+    WriteInfo.FileName = FileName;
+    ASSERT_TRUE(GLTF::WriteModel(pDevice, pCtx, Model, WriteInfo));
+
+    ModelCI.FileName              = FileName;
+    ModelCI.pAnimationCompression = nullptr;
+    GLTF::Model ReloadedModel{pDevice, pCtx, ModelCI};
+    std::remove(FileName);
+
+    // The animation duration is preserved
+    ASSERT_EQ(ReloadedModel.Animations.size(), 1u);
+    const auto& ReloadedAnim = ReloadedModel.Animations[0];
+    EXPECT_EQ(ReloadedAnim.Start, RefAnim.Start);
+    EXPECT_EQ(ReloadedAnim.End, RefAnim.End);
+    ASSERT_EQ(ReloadedAnim.Samplers.size(), 1u);
+    EXPECT_EQ(ReloadedAnim.Samplers[0].Inputs.size(), size_t{NumKeys});
+
+    for (float Time = 0; Time <= 2.5f; Time += 0.125f)
+    {
+        GLTF::ModelTransforms RefTransforms;
+        RefModel.ComputeTransforms(0, RefTransforms, float4x4::Identity(), 0, Time);
+
+        GLTF::ModelTransforms Transforms;
+        ReloadedModel.ComputeTransforms(0, Transforms, float4x4::Identity(), 0, Time);
+
+        const auto& Mat    = Transforms.NodeGlobalMatrices[0];
+        const auto& RefMat = RefTransforms.NodeGlobalMatrices[0];
+        EXPECT_NEAR(Mat._41, RefMat._41, CompressionInfo.TranslationTolerance) << "Time " << Time;
+        EXPECT_NEAR(Mat._42, RefMat._42, CompressionInfo.TranslationTolerance) << "Time " << Time;
+        EXPECT_NEAR(Mat._43, RefMat._43, CompressionInfo.TranslationTolerance) << "Time " << Time;
+    }
+}
+
+} // namespace
@@ -0,0 +1,368 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "GLTFLoader.hpp"
+#include "GraphicsAccessories.hpp"
+
+namespace Diligent
+{
+
+namespace Testing
+{
+
+// Minimal GLTF model wrapper (see TinyGltfModelWrapper in GLTFLoader.cpp) that exposes
+// the scenes, nodes, meshes, accessors, buffer views and buffers defined by the test
+// to GLTF::ModelBuilder.
+
+struct TestGltfBufferView
+{
+    int    Buffer     = 0;
+    size_t ByteOffset = 0;
+    size_t ByteLength = 0;
+    size_t ByteStride = 0;
+
+    auto GetBufferId() const { return Buffer; }
+    auto GetByteOffset() const { return ByteOffset; }
+    auto GetByteLength() const { return ByteLength; }
+};
+
+struct TestGltfBuffer
+{
+    const std::vector<Uint8>& Data;
+
+    const auto* GetData(size_t Offset) const { return &Data[Offset]; }
+    auto        GetSize() const { return Data.size(); }
+};
+
+struct TestGltfAccessor
+{
+    size_t     Count         = 0;
+    int        BufferView    = -1;
+    size_t     ByteOffset    = 0;
+    VALUE_TYPE ComponentType = VT_FLOAT;
+    int        NumComponents = 3;
+    bool       Normalized    = false;
+    float3     MinValues;
+    float3     MaxValues;
+
+    bool       Sparse                     = false;
+    int        SparseCount                = 0;
+    int        SparseIndicesBufferView    = -1;
+    size_t     SparseIndicesByteOffset    = 0;
+    VALUE_TYPE SparseIndicesComponentType = VT_UINT16;
+    int        SparseValuesBufferView     = -1;
+    size_t     SparseValuesByteOffset     = 0;
+
+    // clang-format off
+    auto GetCount()         const { return Count; }
+    auto GetBufferViewId()  const { return BufferView; }
+    auto GetByteOffset()    const { return ByteOffset; }
+    auto GetComponentType() const { return ComponentType; }
+    auto GetNumComponents() const { return NumComponents; }
+    bool IsNormalized()     const { return Normalized; }
+    auto GetMinValues()     const { return MinValues; }
+    auto GetMaxValues()     const { return MaxValues; }
+
+    bool IsSparse()                      const { return Sparse; }
+    auto GetSparseCount()                const { return SparseCount; }
+    auto GetSparseIndicesBufferViewId()  const { return SparseIndicesBufferView; }
+    auto GetSparseIndicesByteOffset()    const { return SparseIndicesByteOffset; }
+    auto GetSparseIndicesComponentType() const { return SparseIndicesComponentType; }
+    auto GetSparseValuesBufferViewId()   const { return SparseValuesBufferView; }
+    auto GetSparseValuesByteOffset()     const { return SparseValuesByteOffset; }
+    // clang-format on
+
+    int GetByteStride(const TestGltfBufferView& View) const
+    {
+        return static_cast<int>(View.ByteStride != 0 ? View.ByteStride : GetValueSize(ComponentType) * NumComponents);
+    }
+};
+
+struct TestGltfPrimitive
+{
+    std::vector<std::pair<std::string, int>> Attributes;
+
+    int Indices  = -1;
+    int Material = -1;
+
+    const int* GetAttribute(const char* Name) const
+    {
+        for (const auto& Attrib : Attributes)
+        {
+            if (Attrib.first == Name)
+                return &Attrib.second;
+        }
+        return nullptr;
+    }
+
+    const auto& Get() const { return *this; }
+
+    auto GetIndicesId() const { return Indices; }
+    auto GetMaterialId() const { return Material; }
+
+    // Morph targets are not supported
+    size_t     GetTargetCount() const { return 0; }
+    const int* GetTargetAttribute(size_t, const char*) const { return nullptr; }
+};
+
+struct TestGltfMesh
+{
+    std::string                    Name;
+    std::vector<double>            Weights;
+    std::vector<TestGltfPrimitive> Primitives;
+
+    const auto& Get() const { return *this; }
+    const auto& GetName() const { return Name; }
+    const auto& GetWeights() const { return Weights; }
+
+    auto        GetPrimitiveCount() const { return Primitives.size(); }
+    const auto& GetPrimitive(size_t Idx) const { return Primitives[Idx]; }
+};
+
+struct TestGltfNode
+{
+    std::string         Name;
+    std::vector<double> Translation;
+    std::vector<double> Rotation;
+    std::vector<double> Scale;
+    std::vector<double> Matrix;
+    std::vector<int>    Children;
+
+    int Mesh = -1;
+
+    // EXT_mesh_gpu_instancing attributes
+    std::vector<std::pair<std::string, int>> InstanceAttributes;
+
+    const auto& Get() const { return *this; }
+
+    // clang-format off
+    const auto& GetName()        const { return Name; }
+    const auto& GetTranslation() const { return Translation; }
+    const auto& GetRotation()    const { return Rotation; }
+    const auto& GetScale()       const { return Scale; }
+    const auto& GetMatrix()      const { return Matrix; }
+    const auto& GetChildrenIds() const { return Children; }
+    auto        GetMeshId()      const { return Mesh; }
+    auto        GetCameraId()    const { return -1; }
+    auto        GetLightId()     const { return -1; }
+    auto        GetSkinId()      const { return -1; }
+    // clang-format on
+
+    int GetInstanceAttribute(const char* Name) const
+    {
+        for (const auto& Attrib : InstanceAttributes)
+        {
+            if (Attrib.first == Name)
+                return Attrib.second;
+        }
+        return -1;
+    }
+};
+
+struct TestGltfScene
+{
+    std::string      Name;
+    std::vector<int> Nodes;
+
+    const auto& GetName() const { return Name; }
+    auto        GetNodeCount() const { return Nodes.size(); }
+    auto        GetNodeId(size_t Idx) const { return Nodes[Idx]; }
+};
+
+// Cameras, lights, skins and animations are not supported. The wrappers below
+// only provide the interface required by the model builder.
+struct TestGltfCamera
+{
+    struct Projection
+    {
+        // clang-format off
+        double GetAspectRatio() const { return 1; }
+        double GetYFov()        const { return 1; }
+        double GetXMag()        const { return 1; }
+        double GetYMag()        const { return 1; }
+        double GetZNear()       const { return 0.1; }
+        double GetZFar()        const { return 100; }
+        // clang-format on
+    };
+
+    std::string Name;
+    std::string Type = "perspective";
+
+    const auto& GetName() const { return Name; }
+    const auto& GetType() const { return Type; }
+    auto        GetPerspective() const { return Projection{}; }
+    auto        GetOrthographic() const { return Projection{}; }
+};
+
+struct TestGltfLight
+{
+    std::string         Name;
+    std::string         Type = "point";
+    std::vector<double> Color;
+
+    // clang-format off
+    const auto& GetName()           const { return Name; }
+    const auto& GetType()           const { return Type; }
+    const auto& GetColor()          const { return Color; }
+    double      GetIntensity()      const { return 1; }
+    double      GetRange()          const { return 0; }
+    double      GetInnerConeAngle() const { return 0; }
+    double      GetOuterConeAngle() const { return 0; }
+    // clang-format on
+};
+
+struct TestGltfSkin
+{
+    std::string      Name;
+    std::vector<int> Joints;
+
+    const auto& GetName() const { return Name; }
+    auto        GetSkeletonId() const { return -1; }
+    auto        GetInverseBindMatricesId() const { return -1; }
+    const auto& GetJointIds() const { return Joints; }
+};
+
+struct TestGltfAnimation
+{
+    struct Sampler
+    {
+        auto GetInterpolation() const { return GLTF::AnimationSampler::INTERPOLATION_TYPE::LINEAR; }
+        auto GetInputId() const { return -1; }
+        auto GetOutputId() const { return -1; }
+    };
+
+    struct Channel
+    {
+        auto GetPathType() const { return GLTF::AnimationChannel::PATH_TYPE::TRANSLATION; }
+        auto GetSamplerId() const { return -1; }
+        auto GetTargetNodeId() const { return -1; }
+    };
+
+    std::string Name;
+
+    const auto& GetName() const { return Name; }
+    size_t      GetSamplerCount() const { return 0; }
+    size_t      GetChannelCount() const { return 0; }
+    auto        GetSampler(size_t) const { return Sampler{}; }
+    auto        GetChannel(size_t) const { return Channel{}; }
+};
+
+struct TestGltfModel
+{
+    std::vector<std::vector<Uint8>> Buffers;
+    std::vector<TestGltfBufferView> BufferViews;
+    std::vector<TestGltfAccessor>   Accessors;
+    std::vector<TestGltfMesh>       Meshes;
+    std::vector<TestGltfNode>       Nodes;
+    std::vector<TestGltfScene>      Scenes;
+
+    int DefaultScene = -1;
+
+    const auto& Get() const { return *this; }
+
+    // clang-format off
+    const auto& GetAccessor  (int idx) const { return Accessors  [idx]; }
+    const auto& GetBufferView(int idx) const { return BufferViews[idx]; }
+    auto        GetBuffer    (int idx) const { return TestGltfBuffer{Buffers[idx]}; }
+    const auto& GetMesh      (int idx) const { return Meshes     [idx]; }
+    const auto& GetNode      (int idx) const { return Nodes      [idx]; }
+    const auto& GetScene     (int idx) const { return Scenes     [idx]; }
+    auto        GetCamera    (int)     const { return TestGltfCamera{};    }
+    auto        GetLight     (int)     const { return TestGltfLight{};     }
+    auto        GetSkin      (size_t)  const { return TestGltfSkin{};      }
+    auto        GetAnimation (size_t)  const { return TestGltfAnimation{}; }
+
+    auto GetBufferViewCount() const { return BufferViews.size(); }
+    auto GetBufferCount()     const { return Buffers.size();     }
+    auto GetNodeCount()       const { return Nodes.size();       }
+    auto GetSceneCount()      const { return Scenes.size();      }
+    auto GetMeshCount()       const { return Meshes.size();      }
+    auto GetSkinCount()       const { return size_t{0};          }
+    auto GetAnimationCount()  const { return size_t{0};          }
+
+    auto GetDefaultSceneId() const { return DefaultScene; }
+    // clang-format on
+
+    // Appends the data to the buffer and returns the index of the new buffer view.
+    template <typename T>
+    int AddBufferView(const std::vector<T>& Data, size_t ByteStride = 0)
+    {
+        if (Buffers.empty())
+            Buffers.resize(1);
+        auto& Buffer = Buffers[0];
+
+        TestGltfBufferView View;
+        View.ByteOffset = Buffer.size();
+        View.ByteLength = Data.size() * sizeof(T);
+        View.ByteStride = ByteStride;
+        Buffer.resize(Buffer.size() + View.ByteLength);
+        if (View.ByteLength > 0)
+            memcpy(&Buffer[View.ByteOffset], Data.data(), View.ByteLength);
+
+        BufferViews.push_back(View);
+        return static_cast<int>(BufferViews.size() - 1);
+    }
+
+    // Adds the accessor that references a new buffer view with tightly packed data
+    // and returns its index. The bounds are computed for three-component float data.
+    template <typename T>
+    int AddAccessor(const std::vector<T>& Data, VALUE_TYPE ComponentType, int NumComponents)
+    {
+        TestGltfAccessor Accessor;
+        Accessor.BufferView    = AddBufferView(Data);
+        Accessor.ComponentType = ComponentType;
+        Accessor.NumComponents = NumComponents;
+        Accessor.Count         = Data.size() * sizeof(T) / (GetValueSize(ComponentType) * NumComponents);
+        if (ComponentType == VT_FLOAT32 && NumComponents == 3)
+        {
+            Accessor.MinValues = float3{+FLT_MAX, +FLT_MAX, +FLT_MAX};
+            Accessor.MaxValues = float3{-FLT_MAX, -FLT_MAX, -FLT_MAX};
+            for (size_t i = 0; i < Accessor.Count; ++i)
+            {
+                float3 Pos;
+                memcpy(&Pos, reinterpret_cast<const Uint8*>(Data.data()) + i * sizeof(float3), sizeof(Pos));
+                Accessor.MinValues = std::min(Accessor.MinValues, Pos);
+                Accessor.MaxValues = std::max(Accessor.MaxValues, Pos);
+            }
+        }
+        Accessors.push_back(Accessor);
+        return static_cast<int>(Accessors.size() - 1);
+    }
+};
+
+} // namespace Testing
+
+} // namespace Diligent
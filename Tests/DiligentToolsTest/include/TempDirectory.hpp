@@ -0,0 +1,100 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+#include "FileSystem.hpp"
+
+namespace Diligent
+{
+
+namespace Testing
+{
+
+/// Creates a uniquely named directory in the system temporary directory and
+/// deletes it with all its contents when the object goes out of scope.
+class TempDirectory
+{
+public:
+    explicit TempDirectory(const char* Prefix)
+    {
+        std::string Root;
+        for (const char* EnvVar : {"TMPDIR", "TEMP", "TMP"})
+        {
+            if (const char* Value = std::getenv(EnvVar))
+            {
+                if (*Value != '\0')
+                {
+                    Root = Value;
+                    break;
+                }
+            }
+        }
+        if (Root.empty())
+            Root = "/tmp";
+        if (!FileSystem::IsSlash(Root.back()))
+            Root.push_back(FileSystem::SlashSymbol);
+
+        static std::atomic<unsigned int> Counter{0};
+
+        const auto Seed = std::random_device{}();
+        for (unsigned int Attempt = 0; Attempt < 16 && m_Path.empty(); ++Attempt)
+        {
+            auto Path = Root + Prefix + '_' + std::to_string(Seed) + '_' + std::to_string(Counter.fetch_add(1)) + FileSystem::SlashSymbol;
+            if (!FileSystem::PathExists(Path.c_str()) && FileSystem::CreateDirectory(Path.c_str()))
+                m_Path = std::move(Path);
+        }
+    }
+
+    ~TempDirectory()
+    {
+        if (!m_Path.empty())
+            FileSystem::DeleteDirectory(m_Path.c_str());
+    }
+
+    // clang-format off
+    TempDirectory           (const TempDirectory&) = delete;
+    TempDirectory& operator=(const TempDirectory&) = delete;
+    // clang-format on
+
+    /// Returns the directory path with the trailing slash, or an empty string if the directory could not be created.
+    const std::string& GetPath() const { return m_Path; }
+
+    explicit operator bool() const { return !m_Path.empty(); }
+
+private:
+    std::string m_Path;
+};
+
+} // namespace Testing
+
+} // namespace Diligent
@@ -0,0 +1,367 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "DXSDKMeshLoader.hpp"
+#include "DXSDKMeshConverter.hpp"
+
+#include <vector>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "TestingEnvironment.hpp"
+
+#include "../../../ThirdParty/tinygltf/tiny_gltf.h"
+
+using namespace Diligent;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+struct TestVertex
+{
+    float3 Pos;
+    float3 Normal;
+    float2 UV;
+};
+
+// Builds a small SDK mesh in memory: one mesh with two triangle-list subsets
+// that use separate vertex ranges of a shared vertex buffer.
+class TestSDKMesh
+{
+public:
+    // clang-format off
+    static constexpr Uint64 HeaderOffset   = 0;
+    static constexpr Uint64 VBHeaderOffset = HeaderOffset   + sizeof(DXSDKMESH_HEADER);
+    static constexpr Uint64 IBHeaderOffset = VBHeaderOffset + sizeof(DXSDKMESH_VERTEX_BUFFER_HEADER);
+    static constexpr Uint64 MeshOffset     = IBHeaderOffset + sizeof(DXSDKMESH_INDEX_BUFFER_HEADER);
+    static constexpr Uint64 SubsetOffset   = MeshOffset     + sizeof(DXSDKMESH_MESH);
+    static constexpr Uint64 SubsetIdOffset = SubsetOffset   + 2 * sizeof(DXSDKMESH_SUBSET);
+    static constexpr Uint64 MaterialOffset = SubsetIdOffset + 2 * sizeof(Uint32);
+    static constexpr Uint64 BufferOffset   = MaterialOffset + sizeof(DXSDKMESH_MATERIAL);
+    static constexpr Uint64 VBDataOffset   = BufferOffset;
+    static constexpr Uint64 IBDataOffset   = VBDataOffset + 6 * sizeof(TestVertex);
+    static constexpr Uint64 DataSize       = IBDataOffset + 6 * sizeof(Uint16);
+    // clang-format on
+
+    TestSDKMesh() :
+        Data(static_cast<size_t>(DataSize))
+    {
+        DXSDKMESH_HEADER Header{};
+        Header.Version                   = DXSDKMESH_FILE_VERSION;
+        Header.HeaderSize                = sizeof(DXSDKMESH_HEADER);
+        Header.NonBufferDataSize         = BufferOffset - sizeof(DXSDKMESH_HEADER);
+        Header.BufferDataSize            = DataSize - BufferOffset;
+        Header.NumVertexBuffers          = 1;
+        Header.NumIndexBuffers           = 1;
+        Header.NumMeshes                 = 1;
+        Header.NumTotalSubsets           = 2;
+        Header.NumFrames                 = 0;
+        Header.NumMaterials              = 1;
+        Header.VertexStreamHeadersOffset = VBHeaderOffset;
+        Header.IndexStreamHeadersOffset  = IBHeaderOffset;
+        Header.MeshDataOffset            = MeshOffset;
+        Header.SubsetDataOffset          = SubsetOffset;
+        Header.FrameDataOffset           = MaterialOffset;
+        Header.MaterialDataOffset        = MaterialOffset;
+        Write(HeaderOffset, Header);
+
+        DXSDKMESH_VERTEX_BUFFER_HEADER VBHeader{};
+        VBHeader.NumVertices  = 6;
+        VBHeader.SizeUint8s   = 6 * sizeof(TestVertex);
+        VBHeader.StrideUint8s = sizeof(TestVertex);
+        for (auto& Elem : VBHeader.Decl)
+            Elem = {0xFF, 0, DXSDKMESH_VERTEX_DATA_TYPE_UNUSED, 0, 0, 0};
+        VBHeader.Decl[0]    = {0, offsetof(TestVertex, Pos), DXSDKMESH_VERTEX_DATA_TYPE_FLOAT3, 0, DXSDKMESH_VERTEX_SEMANTIC_POSITION, 0};
+        VBHeader.Decl[1]    = {0, offsetof(TestVertex, Normal), DXSDKMESH_VERTEX_DATA_TYPE_FLOAT3, 0, DXSDKMESH_VERTEX_SEMANTIC_NORMAL, 0};
+        VBHeader.Decl[2]    = {0, offsetof(TestVertex, UV), DXSDKMESH_VERTEX_DATA_TYPE_FLOAT2, 0, DXSDKMESH_VERTEX_SEMANTIC_TEXCOORD, 0};
+        VBHeader.DataOffset = VBDataOffset;
+        Write(VBHeaderOffset, VBHeader);
+
+        DXSDKMESH_INDEX_BUFFER_HEADER IBHeader{};
+        IBHeader.NumIndices = 6;
+        IBHeader.SizeUint8s = 6 * sizeof(Uint16);
+        IBHeader.IndexType  = IT_16BIT;
+        IBHeader.DataOffset = IBDataOffset;
+        Write(IBHeaderOffset, IBHeader);
+
+        DXSDKMESH_MESH Mesh{};
+        strcpy(Mesh.Name, "TestMesh");
+        Mesh.NumVertexBuffers = 1;
+        Mesh.VertexBuffers[0] = 0;
+        Mesh.IndexBuffer      = 0;
+        Mesh.NumSubsets       = 2;
+        Mesh.SubsetOffset     = SubsetIdOffset;
+        Write(MeshOffset, Mesh);
+
+        // Indices of the second subset are relative to its first vertex
+        for (Uint32 i = 0; i < 2; ++i)
+        {
+            DXSDKMESH_SUBSET Subset{};
+            Subset.MaterialID    = 0;
+            Subset.PrimitiveType = PT_TRIANGLE_LIST;
+            Subset.IndexStart    = i * 3;
+            Subset.IndexCount    = 3;
+            Subset.VertexStart   = i * 3;
+            Subset.VertexCount   = 3;
+            Write(SubsetOffset + i * sizeof(DXSDKMESH_SUBSET), Subset);
+            Write(SubsetIdOffset + i * sizeof(Uint32), i);
+        }
+
+        DXSDKMESH_MATERIAL Material{};
+        strcpy(Material.Name, "TestMaterial");
+        Material.Diffuse = float4{0.5f, 0.25f, 1.0f, 1.0f};
+        Material.Power   = 6;
+        Write(MaterialOffset, Material);
+
+        // clang-format off
+        const TestVertex Vertices[6] =
+        {
+            {{-1,  0,  0}, {0, 0, 1}, {0, 0}},
+            {{ 1,  0,  0}, {0, 0, 1}, {1, 0}},
+            {{ 0,  2,  0}, {0, 0, 1}, {0, 1}},
+            {{ 5,  5,  5}, {0, 1, 0}, {0, 0}},
+            {{ 6,  5,  7}, {0, 1, 0}, {1, 0}},
+            {{ 5,  8,  5}, {0, 1, 0}, {0, 1}},
+        };
+        // clang-format on
+        memcpy(&Data[static_cast<size_t>(VBDataOffset)], Vertices, sizeof(Vertices));
+
+        const Uint16 Indices[6] = {0, 1, 2, 2, 1, 0};
+        memcpy(&Data[static_cast<size_t>(IBDataOffset)], Indices, sizeof(Indices));
+    }
+
+    template <typename T>
+    void Write(Uint64 Offset, const T& Value)
+    {
+        memcpy(&Data[static_cast<size_t>(Offset)], &Value, sizeof(Value));
+    }
+
+    Uint8* GetData() { return Data.data(); }
+    Uint32 GetSize() const { return static_cast<Uint32>(Data.size()); }
+
+    std::vector<Uint8> Data;
+};
+
+TEST(Tools_AssetLoader, DXSDKMeshBoundingBoxes)
+{
+    TestSDKMesh TestData;
+
+    DXSDKMesh Mesh;
+    ASSERT_TRUE(Mesh.Create(TestData.GetData(), TestData.GetSize()));
+    ASSERT_EQ(Mesh.GetNumMeshes(), 1u);
+    ASSERT_EQ(Mesh.GetNumSubsets(0), 2u);
+
+    // The bounding box covers the vertices of both subsets, including the vertex offset of the second one
+    const auto& SrcMesh = Mesh.GetMesh(0);
+    EXPECT_EQ(SrcMesh.BoundingBoxCenter, float3(2.5f, 4.f, 3.5f));
+    EXPECT_EQ(SrcMesh.BoundingBoxExtents, float3(7.f, 8.f, 7.f));
+
+    // The data is copied
+    EXPECT_NE(Mesh.GetRawVerticesAt(0), TestData.GetData() + TestSDKMesh::VBDataOffset);
+}
+
+TEST(Tools_AssetLoader, DXSDKMeshInPlace)
+{
+    TestSDKMesh TestData;
+
+    DXSDKMesh Mesh;
+    ASSERT_TRUE(Mesh.Create(TestData.GetData(), TestData.GetSize(), /*InPlace = */ true));
+    EXPECT_EQ(Mesh.GetRawVerticesAt(0), TestData.GetData() + TestSDKMesh::VBDataOffset);
+    EXPECT_EQ(Mesh.GetRawIndicesAt(0), TestData.GetData() + TestSDKMesh::IBDataOffset);
+    EXPECT_EQ(Mesh.GetSubset(0, 1).VertexStart, 3u);
+}
+
+TEST(Tools_AssetLoader, DXSDKMeshUnaligned)
+{
+    TestSDKMesh TestData;
+
+    // The data starts at an odd address
+    std::vector<Uint8> Buffer(TestData.GetSize() + 1);
+    memcpy(&Buffer[1], TestData.GetData(), TestData.GetSize());
+
+    {
+        // Unaligned data is validated and then copied
+        DXSDKMesh Mesh;
+        ASSERT_TRUE(Mesh.Create(&Buffer[1], TestData.GetSize()));
+        EXPECT_EQ(Mesh.GetMesh(0).BoundingBoxCenter, float3(2.5f, 4.f, 3.5f));
+    }
+
+    {
+        TestingEnvironment::ErrorScope ExpectedErrors{"must be aligned"};
+
+        DXSDKMesh Mesh;
+        EXPECT_FALSE(Mesh.Create(&Buffer[1], TestData.GetSize(), /*InPlace = */ true));
+    }
+}
+
+TEST(Tools_AssetLoader, DXSDKMeshValidation)
+{
+    {
+        TestingEnvironment::ErrorScope ExpectedErrors{"is smaller than the header size"};
+
+        TestSDKMesh TestData;
+        DXSDKMesh   Mesh;
+        EXPECT_FALSE(Mesh.Create(TestData.GetData(), 16));
+    }
+
+    {
+        TestingEnvironment::ErrorScope ExpectedErrors{"exceed the data size"};
+
+        TestSDKMesh TestData;
+        DXSDKMesh   Mesh;
+        EXPECT_FALSE(Mesh.Create(TestData.GetData(), TestData.GetSize() - 1));
+    }
+
+    {
+        TestingEnvironment::ErrorScope ExpectedErrors{"Unexpected SDK mesh file version"};
+
+        TestSDKMesh TestData;
+        TestData.Write(offsetof(DXSDKMESH_HEADER, Version), Uint32{100});
+        DXSDKMesh Mesh;
+        EXPECT_FALSE(Mesh.Create(TestData.GetData(), TestData.GetSize()));
+    }
+
+    {
+        TestingEnvironment::ErrorScope ExpectedErrors{"SDK mesh subsets"};
+
+        TestSDKMesh TestData;
+        TestData.Write(offsetof(DXSDKMESH_HEADER, NumTotalSubsets), Uint32{1000});
+        DXSDKMesh Mesh;
+        EXPECT_FALSE(Mesh.Create(TestData.GetData(), TestData.GetSize()));
+    }
+
+    {
+        TestingEnvironment::ErrorScope ExpectedErrors{"SDK mesh meshes offset"};
+
+        TestSDKMesh TestData;
+        TestData.Write(offsetof(DXSDKMESH_HEADER, MeshDataOffset), Uint64{TestSDKMesh::MeshOffset + 2});
+        DXSDKMesh Mesh;
+        EXPECT_FALSE(Mesh.Create(TestData.GetData(), TestData.GetSize()));
+    }
+
+    {
+        TestingEnvironment::ErrorScope ExpectedErrors{"vertex buffer 0 is out of the data bounds"};
+
+        TestSDKMesh TestData;
+        TestData.Write(TestSDKMesh::VBHeaderOffset + offsetof(DXSDKMESH_VERTEX_BUFFER_HEADER, NumVertices), Uint64{7});
+        DXSDKMesh Mesh;
+        EXPECT_FALSE(Mesh.Create(TestData.GetData(), TestData.GetSize()));
+    }
+
+    {
+        TestingEnvironment::ErrorScope ExpectedErrors{"is out of the range of its index or vertex buffer"};
+
+        TestSDKMesh TestData;
+        TestData.Write(TestSDKMesh::SubsetOffset + sizeof(DXSDKMESH_SUBSET) + offsetof(DXSDKMESH_SUBSET, IndexCount), Uint64{4});
+        DXSDKMesh Mesh;
+        EXPECT_FALSE(Mesh.Create(TestData.GetData(), TestData.GetSize()));
+    }
+
+    {
+        // Vertex 3 of the second subset is the vertex 6 of the buffer
+        TestingEnvironment::ErrorScope ExpectedErrors{"references vertex 6"};
+
+        TestSDKMesh TestData;
+        TestData.Write(TestSDKMesh::IBDataOffset + 3 * sizeof(Uint16), Uint16{3});
+        DXSDKMesh Mesh;
+        EXPECT_FALSE(Mesh.Create(TestData.GetData(), TestData.GetSize()));
+    }
+}
+
+TEST(Tools_AssetLoader, DXSDKMeshConvertToGltf)
+{
+    TestSDKMesh TestData;
+
+    DXSDKMesh Mesh;
+    ASSERT_TRUE(Mesh.Create(TestData.GetData(), TestData.GetSize(), /*InPlace = */ true));
+
+    tinygltf::Model           GltfModel;
+    std::vector<const Uint8*> BufferData;
+    GLTF::ConvertDXSDKMeshToGltf(Mesh, GltfModel, BufferData);
+
+    // The vertex and index buffers are referenced, not copied
+    ASSERT_EQ(GltfModel.buffers.size(), 2u);
+    ASSERT_EQ(BufferData.size(), 2u);
+    EXPECT_EQ(BufferData[0], TestData.GetData() + TestSDKMesh::VBDataOffset);
+    EXPECT_EQ(BufferData[1], TestData.GetData() + TestSDKMesh::IBDataOffset);
+    EXPECT_TRUE(GltfModel.buffers[0].data.empty());
+    ASSERT_EQ(GltfModel.bufferViews.size(), 2u);
+    EXPECT_EQ(GltfModel.bufferViews[0].byteStride, sizeof(TestVertex));
+
+    ASSERT_EQ(GltfModel.meshes.size(), 1u);
+    const auto& GltfMesh = GltfModel.meshes[0];
+    EXPECT_EQ(GltfMesh.name, "TestMesh");
+    ASSERT_EQ(GltfMesh.primitives.size(), 2u);
+
+    for (size_t i = 0; i < 2; ++i)
+    {
+        const auto& Prim = GltfMesh.primitives[i];
+        EXPECT_EQ(Prim.material, 0);
+        EXPECT_EQ(Prim.attributes.size(), 3u);
+        ASSERT_EQ(Prim.attributes.count("POSITION"), 1u);
+        EXPECT_EQ(Prim.attributes.count("NORMAL"), 1u);
+        EXPECT_EQ(Prim.attributes.count("TEXCOORD_0"), 1u);
+
+        // Index range of the subset
+        const auto& Indices = GltfModel.accessors[Prim.indices];
+        EXPECT_EQ(Indices.bufferView, 1);
+        EXPECT_EQ(Indices.byteOffset, i * 3 * sizeof(Uint16));
+        EXPECT_EQ(Indices.count, 3u);
+        EXPECT_EQ(Indices.componentType, TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT);
+
+        // Vertex range starts at the subset's first vertex
+        const auto& Positions = GltfModel.accessors[Prim.attributes.at("POSITION")];
+        EXPECT_EQ(Positions.bufferView, 0);
+        EXPECT_EQ(Positions.byteOffset, i * 3 * sizeof(TestVertex) + offsetof(TestVertex, Pos));
+        EXPECT_EQ(Positions.count, i == 0 ? 6u : 3u);
+        EXPECT_EQ(Positions.type, TINYGLTF_TYPE_VEC3);
+    }
+
+    // Bounds of the vertex ranges
+    const auto& Pos0 = GltfModel.accessors[GltfMesh.primitives[0].attributes.at("POSITION")];
+    EXPECT_EQ(Pos0.minValues, (std::vector<double>{-1, 0, 0}));
+    EXPECT_EQ(Pos0.maxValues, (std::vector<double>{6, 8, 7}));
+    const auto& Pos1 = GltfModel.accessors[GltfMesh.primitives[1].attributes.at("POSITION")];
+    EXPECT_EQ(Pos1.minValues, (std::vector<double>{5, 5, 5}));
+    EXPECT_EQ(Pos1.maxValues, (std::vector<double>{6, 8, 7}));
+
+    // Without frames, every mesh gets a root node
+    ASSERT_EQ(GltfModel.nodes.size(), 1u);
+    EXPECT_EQ(GltfModel.nodes[0].mesh, 0);
+    ASSERT_EQ(GltfModel.scenes.size(), 1u);
+    EXPECT_EQ(GltfModel.scenes[0].nodes, std::vector<int>{0});
+
+    ASSERT_EQ(GltfModel.materials.size(), 1u);
+    const auto& Mat = GltfModel.materials[0];
+    EXPECT_EQ(Mat.name, "TestMaterial");
+    EXPECT_EQ(Mat.values.at("baseColorFactor").number_array, (std::vector<double>{0.5, 0.25, 1.0, 1.0}));
+    EXPECT_DOUBLE_EQ(Mat.values.at("roughnessFactor").number_value, 0.5);
+    EXPECT_TRUE(GltfModel.textures.empty());
+}
+
+} // namespace
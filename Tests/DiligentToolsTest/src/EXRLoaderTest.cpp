@@ -0,0 +1,1020 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "../interface/EXRLoader.h"
+#include "../interface/TextureLoader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "TestingEnvironment.hpp"
+#include "zlib.h"
+
+#include "DataBlobImpl.hpp"
+#include "GraphicsAccessories.hpp"
+#include "RefCntAutoPtr.hpp"
+#include "ThreadPool.hpp"
+
+using namespace Diligent;
+
+namespace
+{
+
+// Converts a float that is exactly representable as a normalized half or zero
+Uint16 FloatToHalf(float Value)
+{
+    Uint32 Bits;
+    memcpy(&Bits, &Value, sizeof(Bits));
+    const Uint32 Sign     = (Bits >> 16u) & 0x8000u;
+    const Int32  Exponent = static_cast<Int32>((Bits >> 23u) & 0xFFu) - 127 + 15;
+    if ((Bits & 0x7FFFFFFFu) == 0)
+        return static_cast<Uint16>(Sign);
+    return static_cast<Uint16>(Sign | (static_cast<Uint32>(Exponent) << 10u) | ((Bits >> 13u) & 0x3FFu));
+}
+
+enum EXR_TEST_COMPRESSION : Uint8
+{
+    EXR_TEST_COMPRESSION_NONE = 0,
+    EXR_TEST_COMPRESSION_RLE  = 1,
+    EXR_TEST_COMPRESSION_ZIPS = 2,
+    EXR_TEST_COMPRESSION_ZIP  = 3,
+    EXR_TEST_COMPRESSION_PIZ  = 4,
+};
+
+struct EXRTestChannel
+{
+    const char* Name      = nullptr;
+    Uint32      PixelType = 1; // 0 - UINT, 1 - HALF, 2 - FLOAT
+
+    Uint32 GetSize() const { return PixelType == 1 ? 2 : 4; }
+};
+
+struct EXRTestImageInfo
+{
+    Uint32               Width       = 0;
+    Uint32               Height      = 0;
+    EXR_TEST_COMPRESSION Compression = EXR_TEST_COMPRESSION_NONE;
+    Uint32               TileSize    = 0; // 0 for scanline images
+
+    // Channels must be sorted by name
+    std::vector<EXRTestChannel> Channels;
+};
+
+// Test value of channel c at pixel (x, y). Large areas of the image are constant
+// so that RLE and ZIP compression actually reduce the data size.
+float GetTestValue(Uint32 x, Uint32 y, size_t c)
+{
+    if (y % 8 < 4)
+        return static_cast<float>(c + 1) * 0.5f;
+    return static_cast<float>((x * 3 + y * 5 + c * 7) % 64) / 16.f - 2.f;
+}
+
+// Reverse of the byte reordering and delta predictor applied by the loader
+std::vector<Uint8> ApplyPredictor(const std::vector<Uint8>& Data)
+{
+    std::vector<Uint8> Tmp(Data.size());
+    size_t             i1 = 0;
+    size_t             i2 = (Data.size() + 1) / 2;
+    for (size_t i = 0; i < Data.size(); ++i)
+        Tmp[(i & 1) ? i2++ : i1++] = Data[i];
+
+    std::vector<Uint8> Res(Tmp.size());
+    for (size_t i = 0; i < Tmp.size(); ++i)
+        Res[i] = static_cast<Uint8>(i > 0 ? Tmp[i] - Tmp[i - 1] + 128 : Tmp[i]);
+    return Res;
+}
+
+std::vector<Uint8> EncodeRLE(const std::vector<Uint8>& Data)
+{
+    std::vector<Uint8> Res;
+    for (size_t i = 0; i < Data.size();)
+    {
+        size_t Run = 1;
+        while (i + Run < Data.size() && Run < 128 && Data[i + Run] == Data[i])
+            ++Run;
+        if (Run >= 3)
+        {
+            Res.push_back(static_cast<Uint8>(Run - 1));
+            Res.push_back(Data[i]);
+            i += Run;
+        }
+        else
+        {
+            size_t Len = 0;
+            while (i + Len < Data.size() && Len < 127 &&
+                   !(i + Len + 2 < Data.size() && Data[i + Len] == Data[i + Len + 1] && Data[i + Len] == Data[i + Len + 2]))
+                ++Len;
+            Len = std::max<size_t>(Len, 1);
+            Res.push_back(static_cast<Uint8>(-static_cast<int>(Len)));
+            Res.insert(Res.end(), Data.begin() + i, Data.begin() + i + Len);
+            i += Len;
+        }
+    }
+    return Res;
+}
+
+class EXRWriter
+{
+public:
+    template <typename T>
+    void Write(const T& Value)
+    {
+        const auto* pBytes = reinterpret_cast<const Uint8*>(&Value);
+        m_Data.insert(m_Data.end(), pBytes, pBytes + sizeof(T));
+    }
+
+    void WriteString(const char* Str)
+    {
+        m_Data.insert(m_Data.end(), Str, Str + strlen(Str) + 1);
+    }
+
+    void WriteBytes(const std::vector<Uint8>& Bytes)
+    {
+        m_Data.insert(m_Data.end(), Bytes.begin(), Bytes.end());
+    }
+
+    void BeginAttribute(const char* Name, const char* Type)
+    {
+        WriteString(Name);
+        WriteString(Type);
+        m_AttribSizeOffset = m_Data.size();
+        Write(Int32{0});
+    }
+
+    void EndAttribute()
+    {
+        const auto Size = static_cast<Int32>(m_Data.size() - m_AttribSizeOffset - sizeof(Int32));
+        memcpy(&m_Data[m_AttribSizeOffset], &Size, sizeof(Size));
+    }
+
+    std::vector<Uint8>& GetData() { return m_Data; }
+
+private:
+    std::vector<Uint8> m_Data;
+    size_t             m_AttribSizeOffset = 0;
+};
+
+// Test-side PIZ encoder that follows the OpenEXR implementation: the range of 16-bit values is
+// compacted with a lookup table, every channel plane is transformed with the Haar wavelet, and
+// the result is Huffman-coded with run-length encoding of repeated values.
+namespace PIZ
+{
+
+constexpr Uint32 USHORT_RANGE = 1 << 16;
+constexpr Uint32 BITMAP_SIZE  = USHORT_RANGE >> 3;
+
+constexpr Uint32 SHORT_ZEROCODE_RUN = 59;
+constexpr Uint32 LONG_ZEROCODE_RUN  = 63;
+constexpr Uint32 SHORTEST_LONG_RUN  = 2 + LONG_ZEROCODE_RUN - SHORT_ZEROCODE_RUN;
+constexpr Uint32 LONGEST_LONG_RUN   = 255 + SHORTEST_LONG_RUN;
+
+void Wenc14(Uint16 a, Uint16 b, Uint16& l, Uint16& h)
+{
+    const int as = static_cast<Int16>(a);
+    const int bs = static_cast<Int16>(b);
+
+    l = static_cast<Uint16>(static_cast<Int16>((as + bs) >> 1));
+    h = static_cast<Uint16>(static_cast<Int16>(as - bs));
+}
+
+void Wenc16(Uint16 a, Uint16 b, Uint16& l, Uint16& h)
+{
+    constexpr int A_OFFSET = 1 << 15;
+    constexpr int M_OFFSET = 1 << 15;
+    constexpr int MOD_MASK = (1 << 16) - 1;
+
+    const int ao = (a + A_OFFSET) & MOD_MASK;
+    int       m  = (ao + b) >> 1;
+    int       d  = ao - b;
+    if (d < 0)
+        m = (m + M_OFFSET) & MOD_MASK;
+    d &= MOD_MASK;
+
+    l = static_cast<Uint16>(m);
+    h = static_cast<Uint16>(d);
+}
+
+// 2D Haar wavelet transform
+void Wav2Encode(Uint16* pIn, int nx, int ox, int ny, int oy, Uint16 mx)
+{
+    const auto Wenc = mx < (1 << 14) ? Wenc14 : Wenc16;
+
+    const int n  = std::min(nx, ny);
+    int       p  = 1;
+    int       p2 = 2;
+    while (p2 <= n)
+    {
+        Uint16*       py  = pIn;
+        Uint16* const ey  = pIn + oy * (ny - p2);
+        const int     oy1 = oy * p;
+        const int     oy2 = oy * p2;
+        const int     ox1 = ox * p;
+        const int     ox2 = ox * p2;
+        Uint16        i00, i01, i10, i11;
+
+        for (; py <= ey; py += oy2)
+        {
+            Uint16*       px = py;
+            Uint16* const ex = py + ox * (nx - p2);
+
+            for (; px <= ex; px += ox2)
+            {
+                Uint16* p01 = px + ox1;
+                Uint16* p10 = px + oy1;
+                Uint16* p11 = p10 + ox1;
+
+                Wenc(*px, *p01, i00, i01);
+                Wenc(*p10, *p11, i10, i11);
+                Wenc(i00, i10, *px, *p10);
+                Wenc(i01, i11, *p01, *p11);
+            }
+
+            // Encode odd column
+            if (nx & p)
+            {
+                Uint16* p10 = px + oy1;
+                Wenc(*px, *p10, i00, *p10);
+                *px = i00;
+            }
+        }
+
+        // Encode odd line
+        if (ny & p)
+        {
+            Uint16*       px = py;
+            Uint16* const ex = py + ox * (nx - p2);
+            for (; px <= ex; px += ox2)
+            {
+                Uint16* p01 = px + ox1;
+                Wenc(*px, *p01, i00, *p01);
+                *px = i00;
+            }
+        }
+
+        p = p2;
+        p2 <<= 1;
+    }
+}
+
+// Writes bits starting from the most significant one
+class BitWriter
+{
+public:
+    void Put(Uint32 NumBits, Uint64 Value)
+    {
+        for (Uint32 i = NumBits; i > 0; --i)
+        {
+            m_Byte = static_cast<Uint8>((m_Byte << 1u) | ((Value >> (i - 1)) & 1u));
+            if (++m_NumBits == 8)
+            {
+                m_Data.push_back(m_Byte);
+                m_NumBits = 0;
+            }
+        }
+        m_TotalBits += NumBits;
+    }
+
+    std::vector<Uint8> Flush()
+    {
+        if (m_NumBits > 0)
+            m_Data.push_back(static_cast<Uint8>(m_Byte << (8 - m_NumBits)));
+        m_NumBits = 0;
+        return std::move(m_Data);
+    }
+
+    Uint32 GetTotalBits() const { return m_TotalBits; }
+
+private:
+    std::vector<Uint8> m_Data;
+    Uint8              m_Byte      = 0;
+    Uint32             m_NumBits   = 0;
+    Uint32             m_TotalBits = 0;
+};
+
+// Computes the Huffman code lengths of the symbols with non-zero frequencies
+std::vector<Uint32> BuildCodeLengths(const std::vector<Uint64>& Freq)
+{
+    struct Node
+    {
+        Uint64 Freq;
+        int    Left;
+        int    Right;
+    };
+    std::vector<Node> Nodes;
+
+    using QueueItem = std::pair<Uint64, int>;
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> Queue;
+    for (size_t s = 0; s < Freq.size(); ++s)
+    {
+        if (Freq[s] != 0)
+        {
+            Queue.emplace(Freq[s], static_cast<int>(Nodes.size()));
+            Nodes.push_back({Freq[s], -1, static_cast<int>(s)});
+        }
+    }
+    while (Queue.size() > 1)
+    {
+        const auto a = Queue.top();
+        Queue.pop();
+        const auto b = Queue.top();
+        Queue.pop();
+        Queue.emplace(a.first + b.first, static_cast<int>(Nodes.size()));
+        Nodes.push_back({a.first + b.first, a.second, b.second});
+    }
+
+    std::vector<Uint32> Lengths(Freq.size());
+
+    std::vector<std::pair<int, Uint32>> Stack{{Queue.top().second, 0}};
+    while (!Stack.empty())
+    {
+        const auto Item = Stack.back();
+        Stack.pop_back();
+        const auto& Nd = Nodes[Item.first];
+        if (Nd.Left < 0)
+        {
+            Lengths[Nd.Right] = Item.second;
+        }
+        else
+        {
+            Stack.emplace_back(Nd.Left, Item.second + 1);
+            Stack.emplace_back(Nd.Right, Item.second + 1);
+        }
+    }
+    return Lengths;
+}
+
+// Assigns canonical codes to the symbols in the same way as OpenEXR
+std::vector<Uint64> BuildCanonicalCodes(const std::vector<Uint32>& Lengths)
+{
+    Uint64 n[59] = {};
+    for (auto l : Lengths)
+        n[l] += 1;
+
+    Uint64 c = 0;
+    for (int i = 58; i > 0; --i)
+    {
+        const Uint64 nc = (c + n[i]) >> 1u;
+        n[i]            = c;
+        c               = nc;
+    }
+
+    std::vector<Uint64> Codes(Lengths.size());
+    for (size_t s = 0; s < Lengths.size(); ++s)
+    {
+        if (Lengths[s] > 0)
+            Codes[s] = n[Lengths[s]]++;
+    }
+    return Codes;
+}
+
+std::vector<Uint8> HufCompress(const std::vector<Uint16>& Data)
+{
+    if (Data.empty())
+        return {};
+
+    // The run-length code follows the largest symbol
+    std::vector<Uint64> Freq(USHORT_RANGE + 1);
+    for (auto Value : Data)
+        ++Freq[Value];
+    Uint32 im = 0;
+    while (Freq[im] == 0)
+        ++im;
+    Uint32 iM = USHORT_RANGE - 1;
+    while (Freq[iM] == 0)
+        --iM;
+    ++iM;
+    Freq[iM] = 1;
+    const Uint32 RunLengthCode = iM;
+
+    const auto Lengths = BuildCodeLengths(Freq);
+    const auto Codes   = BuildCanonicalCodes(Lengths);
+
+    BitWriter Table;
+    for (Uint32 s = im; s <= iM; ++s)
+    {
+        if (Lengths[s] == 0)
+        {
+            Uint32 ZeroRun = 1;
+            while (s + ZeroRun <= iM && Lengths[s + ZeroRun] == 0 && ZeroRun < LONGEST_LONG_RUN)
+                ++ZeroRun;
+            if (ZeroRun >= SHORTEST_LONG_RUN)
+            {
+                Table.Put(6, LONG_ZEROCODE_RUN);
+                Table.Put(8, ZeroRun - SHORTEST_LONG_RUN);
+                s += ZeroRun - 1;
+                continue;
+            }
+            else if (ZeroRun >= 2)
+            {
+                Table.Put(6, SHORT_ZEROCODE_RUN + ZeroRun - 2);
+                s += ZeroRun - 1;
+                continue;
+            }
+        }
+        Table.Put(6, Lengths[s]);
+    }
+    const auto TableData = Table.Flush();
+
+    BitWriter  Bits;
+    const auto PutSymbol = [&](Uint32 Symbol) {
+        Bits.Put(Lengths[Symbol], Codes[Symbol]);
+    };
+    const auto SendCode = [&](Uint32 Symbol, Uint32 RunCount) {
+        if (Lengths[Symbol] + Lengths[RunLengthCode] + 8 < Lengths[Symbol] * RunCount)
+        {
+            PutSymbol(Symbol);
+            PutSymbol(RunLengthCode);
+            Bits.Put(8, RunCount);
+        }
+        else
+        {
+            for (Uint32 i = 0; i <= RunCount; ++i)
+                PutSymbol(Symbol);
+        }
+    };
+    Uint32 Run  = 0;
+    Uint16 Prev = Data[0];
+    for (size_t i = 1; i < Data.size(); ++i)
+    {
+        if (Data[i] == Prev && Run < 255)
+        {
+            ++Run;
+        }
+        else
+        {
+            SendCode(Prev, Run);
+            Run = 0;
+        }
+        Prev = Data[i];
+    }
+    SendCode(Prev, Run);
+    const Uint32 NumBits  = Bits.GetTotalBits();
+    const auto   CodeData = Bits.Flush();
+
+    EXRWriter Writer;
+    Writer.Write(im);
+    Writer.Write(iM);
+    Writer.Write(static_cast<Uint32>(TableData.size()));
+    Writer.Write(NumBits);
+    Writer.Write(Uint32{0});
+    Writer.WriteBytes(TableData);
+    Writer.WriteBytes(CodeData);
+    return std::move(Writer.GetData());
+}
+
+// Encodes the block of scanlines, where every line contains the data of all channels one after another
+std::vector<Uint8> Compress(const std::vector<Uint8>& Raw, const std::vector<EXRTestChannel>& Channels, Uint32 Width, Uint32 Height)
+{
+    // Every channel is stored as a separate plane
+    std::vector<Uint16> Data(Raw.size() / 2);
+    std::vector<size_t> PlaneOffsets;
+    {
+        size_t Offset = 0;
+        for (const auto& Channel : Channels)
+        {
+            PlaneOffsets.push_back(Offset);
+            Offset += size_t{Width} * Height * (Channel.GetSize() / 2);
+        }
+    }
+    size_t RawOffset = 0;
+    for (Uint32 y = 0; y < Height; ++y)
+    {
+        for (size_t c = 0; c < Channels.size(); ++c)
+        {
+            const size_t RowSize = size_t{Width} * Channels[c].GetSize();
+            memcpy(&Data[PlaneOffsets[c] + y * RowSize / 2], &Raw[RawOffset], RowSize);
+            RawOffset += RowSize;
+        }
+    }
+
+    // Range compression
+    std::vector<Uint8> Bitmap(BITMAP_SIZE);
+    for (auto Value : Data)
+        Bitmap[Value >> 3] |= static_cast<Uint8>(1u << (Value & 7u));
+    Bitmap[0] &= ~1u; // Zero is not stored in the bitmap
+
+    Uint16 MinNonZero = BITMAP_SIZE - 1;
+    Uint16 MaxNonZero = 0;
+    for (Uint32 i = 0; i < BITMAP_SIZE; ++i)
+    {
+        if (Bitmap[i] != 0)
+        {
+            MinNonZero = std::min(MinNonZero, static_cast<Uint16>(i));
+            MaxNonZero = std::max(MaxNonZero, static_cast<Uint16>(i));
+        }
+    }
+
+    std::vector<Uint16> LUT(USHORT_RANGE);
+    Uint32              k = 0;
+    for (Uint32 i = 0; i < USHORT_RANGE; ++i)
+        LUT[i] = (i == 0 || (Bitmap[i >> 3] & (1 << (i & 7)))) ? static_cast<Uint16>(k++) : 0;
+    const auto MaxValue = static_cast<Uint16>(k - 1);
+
+    for (auto& Value : Data)
+        Value = LUT[Value];
+
+    for (size_t c = 0; c < Channels.size(); ++c)
+    {
+        const int Size = static_cast<int>(Channels[c].GetSize() / 2);
+        for (int j = 0; j < Size; ++j)
+            Wav2Encode(&Data[PlaneOffsets[c]] + j, static_cast<int>(Width), Size, static_cast<int>(Height), static_cast<int>(Width) * Size, MaxValue);
+    }
+
+    const auto HufData = HufCompress(Data);
+
+    EXRWriter Writer;
+    Writer.Write(MinNonZero);
+    Writer.Write(MaxNonZero);
+    if (MinNonZero <= MaxNonZero)
+        Writer.WriteBytes({Bitmap.begin() + MinNonZero, Bitmap.begin() + MaxNonZero + 1});
+    Writer.Write(static_cast<Int32>(HufData.size()));
+    Writer.WriteBytes(HufData);
+    return std::move(Writer.GetData());
+}
+
+} // namespace PIZ
+
+// Encodes the test image as an EXR file
+RefCntAutoPtr<DataBlobImpl> CreateTestEXR(const EXRTestImageInfo& Info)
+{
+    EXRWriter Writer;
+    Writer.Write(Uint32{20000630});
+    Writer.Write(Uint32{2u | (Info.TileSize != 0 ? 0x200u : 0u)});
+
+    Writer.BeginAttribute("channels", "chlist");
+    for (const auto& Channel : Info.Channels)
+    {
+        Writer.WriteString(Channel.Name);
+        Writer.Write(Channel.PixelType);
+        Writer.Write(Uint32{0}); // pLinear and reserved
+        Writer.Write(Int32{1});  // xSampling
+        Writer.Write(Int32{1});  // ySampling
+    }
+    Writer.Write(Uint8{0});
+    Writer.EndAttribute();
+
+    Writer.BeginAttribute("compression", "compression");
+    Writer.Write(Uint8{Info.Compression});
+    Writer.EndAttribute();
+
+    // Use non-zero origin of the data window
+    for (const char* Window : {"dataWindow", "displayWindow"})
+    {
+        Writer.BeginAttribute(Window, "box2i");
+        Writer.Write(Int32{-3});
+        Writer.Write(Int32{5});
+        Writer.Write(static_cast<Int32>(Info.Width) - 4);
+        Writer.Write(static_cast<Int32>(Info.Height) + 4);
+        Writer.EndAttribute();
+    }
+
+    Writer.BeginAttribute("lineOrder", "lineOrder");
+    Writer.Write(Uint8{0});
+    Writer.EndAttribute();
+
+    Writer.BeginAttribute("pixelAspectRatio", "float");
+    Writer.Write(1.f);
+    Writer.EndAttribute();
+
+    if (Info.TileSize != 0)
+    {
+        Writer.BeginAttribute("tiles", "tiledesc");
+        Writer.Write(Info.TileSize);
+        Writer.Write(Info.TileSize);
+        Writer.Write(Uint8{0}); // ONE_LEVEL
+        Writer.EndAttribute();
+    }
+    Writer.Write(Uint8{0});
+
+    struct Block
+    {
+        Uint32 X;
+        Uint32 Y;
+        Uint32 Width;
+        Uint32 Height;
+    };
+    std::vector<Block> Blocks;
+    if (Info.TileSize != 0)
+    {
+        for (Uint32 y = 0; y < Info.Height; y += Info.TileSize)
+        {
+            for (Uint32 x = 0; x < Info.Width; x += Info.TileSize)
+                Blocks.push_back({x, y, std::min(Info.TileSize, Info.Width - x), std::min(Info.TileSize, Info.Height - y)});
+        }
+    }
+    else
+    {
+        Uint32 LinesPerBlock = 1;
+        if (Info.Compression == EXR_TEST_COMPRESSION_ZIP)
+            LinesPerBlock = 16;
+        else if (Info.Compression == EXR_TEST_COMPRESSION_PIZ)
+            LinesPerBlock = 32;
+        for (Uint32 y = 0; y < Info.Height; y += LinesPerBlock)
+            Blocks.push_back({0, y, Info.Width, std::min(LinesPerBlock, Info.Height - y)});
+    }
+
+    const size_t OffsetTableStart = Writer.GetData().size();
+    Writer.GetData().resize(OffsetTableStart + Blocks.size() * sizeof(Uint64));
+
+    for (size_t b = 0; b < Blocks.size(); ++b)
+    {
+        const auto& Blk = Blocks[b];
+
+        const Uint64 Offset = Writer.GetData().size();
+        memcpy(&Writer.GetData()[OffsetTableStart + b * sizeof(Uint64)], &Offset, sizeof(Offset));
+
+        std::vector<Uint8> Raw;
+        for (Uint32 y = Blk.Y; y < Blk.Y + Blk.Height; ++y)
+        {
+            for (size_t c = 0; c < Info.Channels.size(); ++c)
+            {
+                for (Uint32 x = Blk.X; x < Blk.X + Blk.Width; ++x)
+                {
+                    const float Value = GetTestValue(x, y, c);
+                    Uint8       Bytes[4];
+                    switch (Info.Channels[c].PixelType)
+                    {
+                        case 0:
+                        {
+                            const Uint32 UInt = static_cast<Uint32>(Value * 16.f + 32.f);
+                            memcpy(Bytes, &UInt, 4);
+                            break;
+                        }
+                        case 1:
+                        {
+                            const Uint16 Half = FloatToHalf(Value);
+                            memcpy(Bytes, &Half, 2);
+                            break;
+                        }
+                        default:
+                            memcpy(Bytes, &Value, 4);
+                    }
+                    Raw.insert(Raw.end(), Bytes, Bytes + Info.Channels[c].GetSize());
+                }
+            }
+        }
+
+        std::vector<Uint8> Compressed;
+        if (Info.Compression == EXR_TEST_COMPRESSION_RLE)
+        {
+            Compressed = EncodeRLE(ApplyPredictor(Raw));
+        }
+        else if (Info.Compression == EXR_TEST_COMPRESSION_ZIPS || Info.Compression == EXR_TEST_COMPRESSION_ZIP)
+        {
+            const auto Predicted = ApplyPredictor(Raw);
+
+            uLongf CompressedSize = compressBound(static_cast<uLong>(Predicted.size()));
+            Compressed.resize(CompressedSize);
+            compress(Compressed.data(), &CompressedSize, Predicted.data(), static_cast<uLong>(Predicted.size()));
+            Compressed.resize(CompressedSize);
+        }
+        else if (Info.Compression == EXR_TEST_COMPRESSION_PIZ)
+        {
+            Compressed = PIZ::Compress(Raw, Info.Channels, Blk.Width, Blk.Height);
+        }
+
+        // Like OpenEXR, store the data uncompressed if compression does not reduce the size
+        const auto& ChunkData = (Info.Compression != EXR_TEST_COMPRESSION_NONE && Compressed.size() < Raw.size()) ? Compressed : Raw;
+        if (Info.TileSize != 0)
+        {
+            Writer.Write(static_cast<Int32>(Blk.X / Info.TileSize));
+            Writer.Write(static_cast<Int32>(Blk.Y / Info.TileSize));
+            Writer.Write(Int32{0});
+            Writer.Write(Int32{0});
+        }
+        else
+        {
+            Writer.Write(static_cast<Int32>(Blk.Y) + 5);
+        }
+        Writer.Write(static_cast<Int32>(ChunkData.size()));
+        Writer.WriteBytes(ChunkData);
+    }
+
+    const auto& Data = Writer.GetData();
+    return DataBlobImpl::Create(Data.size(), Data.data());
+}
+
+float HalfToFloat(Uint16 Half)
+{
+    // Test values are normalized halfs or zeros
+    const Uint32 Sign     = Uint32{Half & 0x8000u} << 16u;
+    const Uint32 Exponent = (Half >> 10u) & 0x1Fu;
+    const Uint32 Bits     = Sign | ((Half & 0x7FFFu) == 0 ? 0 : ((Exponent + 127 - 15) << 23u) | ((Half & 0x3FFu) << 13u));
+
+    float Value;
+    memcpy(&Value, &Bits, sizeof(Value));
+    return Value;
+}
+
+// Decodes the image with and without the thread pool and compares the pixels with the reference values.
+// ExpectedChannels maps every image component to the test channel index, or -1 if the component must be zero.
+void TestEXRDecoding(const EXRTestImageInfo& Info, VALUE_TYPE ExpectedType, const std::vector<int>& ExpectedChannels)
+{
+    auto pEXRData = CreateTestEXR(Info);
+    ASSERT_TRUE(pEXRData);
+
+    RefCntAutoPtr<IThreadPool> pThreadPool = CreateThreadPool(ThreadPoolCreateInfo{4});
+    ASSERT_TRUE(pThreadPool);
+
+    for (int UseThreadPool = 0; UseThreadPool <= 1; ++UseThreadPool)
+    {
+        ImageLoadInfo LoadInfo;
+        LoadInfo.Format      = IMAGE_FILE_FORMAT_EXR;
+        LoadInfo.pThreadPool = UseThreadPool ? pThreadPool.RawPtr() : nullptr;
+
+        RefCntAutoPtr<Image> pImage;
+        Image::CreateFromDataBlob(pEXRData, LoadInfo, &pImage);
+        ASSERT_TRUE(pImage);
+
+        const auto& Desc = pImage->GetDesc();
+        ASSERT_EQ(Desc.Width, Info.Width);
+        ASSERT_EQ(Desc.Height, Info.Height);
+        ASSERT_EQ(Desc.ComponentType, ExpectedType);
+        ASSERT_EQ(Desc.NumComponents, ExpectedChannels.size());
+
+        const Uint32 CompSize = GetValueSize(ExpectedType);
+        ASSERT_GE(Desc.RowStride, Info.Width * Desc.NumComponents * CompSize);
+
+        const auto* pPixels = static_cast<const Uint8*>(pImage->GetData()->GetConstDataPtr());
+        for (Uint32 y = 0; y < Info.Height; ++y)
+        {
+            for (Uint32 x = 0; x < Info.Width; ++x)
+            {
+                for (Uint32 c = 0; c < Desc.NumComponents; ++c)
+                {
+                    const auto* pComp = pPixels + y * Desc.RowStride + (x * Desc.NumComponents + c) * CompSize;
+
+                    const int   Channel  = ExpectedChannels[c];
+                    const float RefValue = Channel >= 0 ? GetTestValue(x, y, Channel) : 0.f;
+
+                    float Value = 0;
+                    if (ExpectedType == VT_FLOAT16)
+                    {
+                        Uint16 Half;
+                        memcpy(&Half, pComp, sizeof(Half));
+                        if (Channel >= 0)
+                            EXPECT_EQ(Half, FloatToHalf(RefValue));
+                        Value = HalfToFloat(Half);
+                    }
+                    else if (ExpectedType == VT_UINT32)
+                    {
+                        Uint32 UInt;
+                        memcpy(&UInt, pComp, sizeof(UInt));
+                        Value = (static_cast<float>(UInt) - 32.f) / 16.f;
+                    }
+                    else
+                    {
+                        memcpy(&Value, pComp, sizeof(Value));
+                        if (Channel >= 0 && Info.Channels[Channel].PixelType == 0)
+                            Value = (Value - 32.f) / 16.f;
+                    }
+                    ASSERT_EQ(Value, RefValue)
+                        << "x=" << x << ", y=" << y << ", c=" << c << (UseThreadPool ? " (thread pool)" : "");
+                }
+            }
+        }
+    }
+}
+
+const std::vector<EXRTestChannel> HalfRGBA = {{"A", 1}, {"B", 1}, {"G", 1}, {"R", 1}};
+
+TEST(Tools_TextureLoader, EXRScanline)
+{
+    // Channels are stored in alphabetical order, so RGBA components come from channels 3, 2, 1, 0
+    for (auto Compression : {EXR_TEST_COMPRESSION_NONE, EXR_TEST_COMPRESSION_RLE, EXR_TEST_COMPRESSION_ZIPS, EXR_TEST_COMPRESSION_ZIP})
+    {
+        TestEXRDecoding({37, 41, Compression, 0, HalfRGBA}, VT_FLOAT16, {3, 2, 1, 0});
+    }
+
+    // PIZ blocks contain 32 scanlines; the last block is too small to be compressed and is stored as is
+    TestEXRDecoding({128, 70, EXR_TEST_COMPRESSION_PIZ, 0, HalfRGBA}, VT_FLOAT16, {3, 2, 1, 0});
+    EXPECT_LT(CreateTestEXR({128, 70, EXR_TEST_COMPRESSION_PIZ, 0, HalfRGBA})->GetSize(),
+              CreateTestEXR({128, 70, EXR_TEST_COMPRESSION_NONE, 0, HalfRGBA})->GetSize());
+}
+
+TEST(Tools_TextureLoader, EXRTiled)
+{
+    // Partial tiles at the right and bottom edges
+    TestEXRDecoding({70, 50, EXR_TEST_COMPRESSION_ZIP, 16, HalfRGBA}, VT_FLOAT16, {3, 2, 1, 0});
+    TestEXRDecoding({33, 17, EXR_TEST_COMPRESSION_NONE, 32, {{"B", 2}, {"G", 2}, {"R", 2}}}, VT_FLOAT32, {2, 1, 0});
+    TestEXRDecoding({64, 64, EXR_TEST_COMPRESSION_RLE, 8, {{"Y", 1}}}, VT_FLOAT16, {0});
+    TestEXRDecoding({100, 70, EXR_TEST_COMPRESSION_PIZ, 64, HalfRGBA}, VT_FLOAT16, {3, 2, 1, 0});
+}
+
+TEST(Tools_TextureLoader, EXRChannelSelection)
+{
+    // Mixed half and float channels are converted to float. The missing green channel is filled with zeros.
+    TestEXRDecoding({29, 19, EXR_TEST_COMPRESSION_ZIP, 0, {{"B", 2}, {"R", 1}}}, VT_FLOAT32, {1, -1, 0});
+    TestEXRDecoding({96, 38, EXR_TEST_COMPRESSION_PIZ, 0, {{"B", 2}, {"R", 1}}}, VT_FLOAT32, {1, -1, 0});
+
+    // Luminance with alpha; other channels are ignored
+    TestEXRDecoding({24, 20, EXR_TEST_COMPRESSION_ZIPS, 0, {{"A", 1}, {"Y", 1}, {"Z", 2}}}, VT_FLOAT16, {1, 0});
+
+    // Unknown channel names: the first four channels are used
+    TestEXRDecoding({16, 16, EXR_TEST_COMPRESSION_RLE, 0, {{"a", 0}, {"b", 0}, {"c", 0}, {"d", 0}, {"e", 0}}}, VT_UINT32, {0, 1, 2, 3});
+    TestEXRDecoding({64, 32, EXR_TEST_COMPRESSION_PIZ, 0, {{"a", 0}, {"b", 0}, {"c", 0}, {"d", 0}, {"e", 0}}}, VT_UINT32, {0, 1, 2, 3});
+    TestEXRDecoding({16, 16, EXR_TEST_COMPRESSION_NONE, 0, {{"id", 0}, {"z", 2}}}, VT_FLOAT32, {0, 1});
+}
+
+TEST(Tools_TextureLoader, EXRFileFormat)
+{
+    auto pEXRData = CreateTestEXR({8, 8, EXR_TEST_COMPRESSION_NONE, 0, HalfRGBA});
+    EXPECT_EQ(Image::GetFileFormat(static_cast<const Uint8*>(pEXRData->GetConstDataPtr()), pEXRData->GetSize()), IMAGE_FILE_FORMAT_EXR);
+    EXPECT_EQ(Image::GetFileFormat(nullptr, 0, "image.EXR"), IMAGE_FILE_FORMAT_EXR);
+}
+
+TEST(Tools_TextureLoader, EXRTexture)
+{
+    auto pEXRData = CreateTestEXR({32, 16, EXR_TEST_COMPRESSION_ZIP, 0, HalfRGBA});
+
+    ImageLoadInfo ImgLoadInfo;
+    ImgLoadInfo.Format = IMAGE_FILE_FORMAT_EXR;
+
+    RefCntAutoPtr<Image> pImage;
+    Image::CreateFromDataBlob(pEXRData, ImgLoadInfo, &pImage);
+    ASSERT_TRUE(pImage);
+
+    TextureLoadInfo LoadInfo;
+    LoadInfo.MipLevels = 1;
+
+    RefCntAutoPtr<ITextureLoader> pLoader;
+    CreateTextureLoaderFromImage(pImage, LoadInfo, &pLoader);
+    ASSERT_TRUE(pLoader);
+
+    // Half-float pixels are passed through without conversion
+    const auto& Desc = pLoader->GetTextureDesc();
+    EXPECT_EQ(Desc.Format, TEX_FORMAT_RGBA16_FLOAT);
+    EXPECT_EQ(Desc.Width, 32u);
+    EXPECT_EQ(Desc.Height, 16u);
+
+    const auto& SubRes = pLoader->GetSubresourceData(0, 0);
+    ASSERT_NE(SubRes.pData, nullptr);
+    EXPECT_EQ(memcmp(SubRes.pData, pImage->GetData()->GetConstDataPtr(), 32 * 4 * sizeof(Uint16)), 0);
+}
+
+// Loads the image with the full mip chain and checks that every level is the box average of the previous one
+void TestEXRTextureMips(const std::vector<EXRTestChannel>& Channels, TEXTURE_FORMAT ExpectedFormat)
+{
+    auto pEXRData = CreateTestEXR({32, 16, EXR_TEST_COMPRESSION_ZIP, 0, Channels});
+
+    ImageLoadInfo ImgLoadInfo;
+    ImgLoadInfo.Format = IMAGE_FILE_FORMAT_EXR;
+
+    RefCntAutoPtr<Image> pImage;
+    Image::CreateFromDataBlob(pEXRData, ImgLoadInfo, &pImage);
+    ASSERT_TRUE(pImage);
+
+    RefCntAutoPtr<ITextureLoader> pLoader;
+    CreateTextureLoaderFromImage(pImage, TextureLoadInfo{}, &pLoader);
+    ASSERT_TRUE(pLoader);
+
+    const auto& Desc = pLoader->GetTextureDesc();
+    ASSERT_EQ(Desc.Format, ExpectedFormat);
+    ASSERT_EQ(Desc.MipLevels, 6u);
+
+    const bool IsHalf = GetTextureFormatAttribs(Desc.Format).ComponentSize == 2;
+
+    auto ReadTexel = [&](Uint32 Mip, Uint32 x, Uint32 y, Uint32 c) {
+        const auto& SubRes = pLoader->GetSubresourceData(Mip, 0);
+
+        const auto* pComp = static_cast<const Uint8*>(SubRes.pData) + y * SubRes.Stride + (x * 4 + c) * (IsHalf ? 2 : 4);
+        if (IsHalf)
+        {
+            Uint16 Half;
+            memcpy(&Half, pComp, sizeof(Half));
+            return HalfToFloat(Half);
+        }
+        else
+        {
+            float Value;
+            memcpy(&Value, pComp, sizeof(Value));
+            return Value;
+        }
+    };
+
+    for (Uint32 Mip = 1; Mip < Desc.MipLevels; ++Mip)
+    {
+        ASSERT_NE(pLoader->GetSubresourceData(Mip, 0).pData, nullptr);
+
+        const auto MipProps = GetMipLevelProperties(Desc, Mip);
+        for (Uint32 y = 0; y < MipProps.LogicalHeight; ++y)
+        {
+            for (Uint32 x = 0; x < MipProps.LogicalWidth; ++x)
+            {
+                for (Uint32 c = 0; c < 4; ++c)
+                {
+                    const float RefValue = (ReadTexel(Mip - 1, x * 2, y * 2, c) + ReadTexel(Mip - 1, x * 2 + 1, y * 2, c) +
+                                            ReadTexel(Mip - 1, x * 2, y * 2 + 1, c) + ReadTexel(Mip - 1, x * 2 + 1, y * 2 + 1, c)) *
+                        0.25f;
+                    // Half-float levels are rounded to the nearest half
+                    const float Tolerance = IsHalf ? std::abs(RefValue) / 1024.f + 1e-6f : 1e-6f;
+                    ASSERT_NEAR(ReadTexel(Mip, x, y, c), RefValue, Tolerance) << "mip=" << Mip << ", x=" << x << ", y=" << y << ", c=" << c;
+                }
+            }
+        }
+    }
+}
+
+TEST(Tools_TextureLoader, EXRTextureMips)
+{
+    TestEXRTextureMips(HalfRGBA, TEX_FORMAT_RGBA16_FLOAT);
+    TestEXRTextureMips({{"A", 2}, {"B", 2}, {"G", 2}, {"R", 2}}, TEX_FORMAT_RGBA32_FLOAT);
+}
+
+// python.exr and python.png are the same 16x16 image stored in the EXR and PNG formats, see Textures/README.md
+TEST(Tools_TextureLoader, EXRReferenceImage)
+{
+    TextureLoadInfo LoadInfo;
+    LoadInfo.MipLevels = 1;
+
+    RefCntAutoPtr<ITextureLoader> pEXRLoader;
+    CreateTextureLoaderFromFile("Textures/python.exr", IMAGE_FILE_FORMAT_UNKNOWN, LoadInfo, &pEXRLoader);
+    ASSERT_TRUE(pEXRLoader);
+
+    RefCntAutoPtr<ITextureLoader> pPNGLoader;
+    CreateTextureLoaderFromFile("Textures/python.png", IMAGE_FILE_FORMAT_UNKNOWN, LoadInfo, &pPNGLoader);
+    ASSERT_TRUE(pPNGLoader);
+
+    const auto& EXRDesc = pEXRLoader->GetTextureDesc();
+    const auto& PNGDesc = pPNGLoader->GetTextureDesc();
+    ASSERT_EQ(EXRDesc.Format, TEX_FORMAT_RGBA16_FLOAT);
+    ASSERT_EQ(PNGDesc.Format, TEX_FORMAT_RGBA8_UNORM);
+    ASSERT_EQ(EXRDesc.Width, 16u);
+    ASSERT_EQ(EXRDesc.Height, 16u);
+    ASSERT_EQ(PNGDesc.Width, EXRDesc.Width);
+    ASSERT_EQ(PNGDesc.Height, EXRDesc.Height);
+
+    const auto& EXRData = pEXRLoader->GetSubresourceData(0, 0);
+    const auto& PNGData = pPNGLoader->GetSubresourceData(0, 0);
+    for (Uint32 y = 0; y < EXRDesc.Height; ++y)
+    {
+        for (Uint32 x = 0; x < EXRDesc.Width; ++x)
+        {
+            for (Uint32 c = 0; c < 4; ++c)
+            {
+                Uint16 Half;
+                memcpy(&Half, static_cast<const Uint8*>(EXRData.pData) + y * EXRData.Stride + (x * 4 + c) * sizeof(Half), sizeof(Half));
+                const Uint8 PNGValue = static_cast<const Uint8*>(PNGData.pData)[y * PNGData.Stride + x * 4 + c];
+                EXPECT_EQ(static_cast<Uint32>(HalfToFloat(Half) * 255.f + 0.5f), PNGValue) << "x=" << x << ", y=" << y << ", c=" << c;
+            }
+        }
+    }
+}
+
+TEST(Tools_TextureLoader, EXRInvalidData)
+{
+    auto pEXRData = CreateTestEXR({16, 16, EXR_TEST_COMPRESSION_ZIP, 0, HalfRGBA});
+
+    {
+        TestingEnvironment::ErrorScope ExpectedErrors{"Unexpected end of EXR data"};
+
+        auto pTruncated = DataBlobImpl::Create(pEXRData->GetSize() - 10, pEXRData->GetConstDataPtr());
+        auto pPixels    = DataBlobImpl::Create();
+
+        ImageDesc Desc;
+        EXPECT_FALSE(LoadEXR(pTruncated, pPixels, &Desc, nullptr));
+    }
+
+    {
+        TestingEnvironment::ErrorScope ExpectedErrors{"Invalid EXR file signature"};
+
+        auto pCorrupted = DataBlobImpl::Create(pEXRData->GetSize(), pEXRData->GetConstDataPtr());
+        static_cast<Uint8*>(pCorrupted->GetDataPtr())[0] = 0;
+        auto pPixels                                      = DataBlobImpl::Create();
+
+        ImageDesc Desc;
+        EXPECT_FALSE(LoadEXR(pCorrupted, pPixels, &Desc, nullptr));
+    }
+}
+
+} // namespace
@@ -0,0 +1,254 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "GLTFLoader.hpp"
+#include "GLTFBuilder.hpp"
+
+#include <vector>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "GLTFTestModel.hpp"
+
+using namespace Diligent;
+using namespace Diligent::GLTF;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+struct TestPrimitiveData
+{
+    Uint32              NumVertices = 0;
+    std::vector<Uint32> Indices;
+    VALUE_TYPE          SrcIndexType = VT_UINT32;
+};
+
+// Creates a model with a single node whose mesh contains one primitive per element of Prims.
+// Each primitive references its own position accessor, so that primitives are placed one after
+// another in the vertex buffer.
+TestGltfModel CreateTestModel(const std::vector<TestPrimitiveData>& Prims)
+{
+    TestGltfModel GltfModel;
+
+    GltfModel.Meshes.resize(1);
+    for (const auto& Prim : Prims)
+    {
+        std::vector<float3> Positions(Prim.NumVertices);
+        for (Uint32 v = 0; v < Prim.NumVertices; ++v)
+            Positions[v] = float3{static_cast<float>(v % 256), static_cast<float>(v / 256), 0};
+
+        TestGltfPrimitive GltfPrim;
+        GltfPrim.Attributes.emplace_back("POSITION", GltfModel.AddAccessor(Positions, VT_FLOAT32, 3));
+        switch (Prim.SrcIndexType)
+        {
+            case VT_UINT8:
+                GltfPrim.Indices = GltfModel.AddAccessor(std::vector<Uint8>(Prim.Indices.begin(), Prim.Indices.end()), VT_UINT8, 1);
+                break;
+
+            case VT_UINT16:
+                GltfPrim.Indices = GltfModel.AddAccessor(std::vector<Uint16>(Prim.Indices.begin(), Prim.Indices.end()), VT_UINT16, 1);
+                break;
+
+            default:
+                GltfPrim.Indices = GltfModel.AddAccessor(Prim.Indices, VT_UINT32, 1);
+        }
+        GltfModel.Meshes[0].Primitives.push_back(GltfPrim);
+    }
+
+    GltfModel.Nodes.resize(1);
+    GltfModel.Nodes[0].Mesh = 0;
+
+    GltfModel.Scenes.resize(1);
+    GltfModel.Scenes[0].Nodes = {0};
+
+    return GltfModel;
+}
+
+Uint32 ReadIndex(const std::vector<Uint8>& IndexData, VALUE_TYPE IndexType, size_t Idx)
+{
+    if (IndexType == VT_UINT16)
+    {
+        Uint16 Index = 0;
+        memcpy(&Index, &IndexData[Idx * sizeof(Uint16)], sizeof(Index));
+        return Index;
+    }
+    else
+    {
+        Uint32 Index = 0;
+        memcpy(&Index, &IndexData[Idx * sizeof(Uint32)], sizeof(Index));
+        return Index;
+    }
+}
+
+// Verifies that the indices of every primitive reference the same vertices as the source indices.
+void CheckIndices(const Model& TestModel, const ModelBuilder& Builder, const std::vector<TestPrimitiveData>& Prims)
+{
+    ASSERT_EQ(TestModel.Meshes.size(), size_t{1});
+    const auto& Primitives = TestModel.Meshes[0].Primitives;
+    ASSERT_EQ(Primitives.size(), Prims.size());
+
+    for (size_t p = 0; p < Prims.size(); ++p)
+    {
+        const auto& Prim      = Primitives[p];
+        const auto& SrcPrim   = Prims[p];
+        const auto& IndexData = Builder.GetIndexData(Prim.IndexType);
+        ASSERT_EQ(Prim.IndexCount, SrcPrim.Indices.size());
+        ASSERT_LE((size_t{Prim.FirstIndex} + Prim.IndexCount) * GetValueSize(Prim.IndexType), IndexData.size());
+        for (Uint32 i = 0; i < Prim.IndexCount; ++i)
+        {
+            const Uint32 Index = ReadIndex(IndexData, Prim.IndexType, size_t{Prim.FirstIndex} + i);
+            EXPECT_EQ(Index + Prim.BaseVertex, SrcPrim.Indices[i] + Prim.FirstVertex) << "Primitive " << p << ", index " << i;
+            EXPECT_LT(Index + Prim.BaseVertex, Prim.FirstVertex + Prim.VertexCount);
+        }
+    }
+}
+
+const std::vector<TestPrimitiveData> MixedPrimitives = {
+    // 16-bit indices
+    {4, {0, 1, 2, 2, 1, 3}, VT_UINT16},
+    // More than 65535 vertices: falls back to 32-bit indices
+    {70000, {0, 69999, 35000, 65535, 65536, 1}, VT_UINT32},
+    // Starts after vertex 65535, but still uses 16-bit indices relative to the base vertex
+    {3, {2, 1, 0}, VT_UINT8},
+};
+
+TEST(Tools_AssetLoader, GLTFAdaptiveIndexTypeMixed)
+{
+    const auto GltfModel = CreateTestModel(MixedPrimitives);
+
+    ModelCreateInfo CI;
+    CI.AdaptiveIndexType = true;
+
+    Model        TestModel{CI};
+    ModelBuilder Builder{CI, TestModel};
+    Builder.Execute(GltfModel, -1, nullptr);
+
+    EXPECT_EQ(TestModel.IndexData.IndexSize, Uint32{4});
+    EXPECT_EQ(TestModel.IndexData16.IndexSize, Uint32{2});
+
+    const auto& Primitives = TestModel.Meshes[0].Primitives;
+    ASSERT_EQ(Primitives.size(), size_t{3});
+
+    const Uint32     ExpectedFirstVertex[] = {0, 4, 70004};
+    const Uint32     ExpectedFirstIndex[]  = {0, 0, 6};
+    const VALUE_TYPE ExpectedIndexType[]   = {VT_UINT16, VT_UINT32, VT_UINT16};
+    for (size_t p = 0; p < Primitives.size(); ++p)
+    {
+        const auto& Prim = Primitives[p];
+        EXPECT_EQ(Prim.IndexType, ExpectedIndexType[p]) << "Primitive " << p;
+        EXPECT_EQ(Prim.FirstVertex, ExpectedFirstVertex[p]) << "Primitive " << p;
+        EXPECT_EQ(Prim.BaseVertex, Prim.FirstVertex) << "Primitive " << p;
+        EXPECT_EQ(Prim.FirstIndex, ExpectedFirstIndex[p]) << "Primitive " << p;
+    }
+
+    // 16-bit indices of the first and the last primitives are packed together
+    EXPECT_EQ(Builder.GetIndexData(VT_UINT16).size(), size_t{9} * sizeof(Uint16));
+    EXPECT_EQ(Builder.GetIndexData(VT_UINT32).size(), size_t{6} * sizeof(Uint32));
+
+    CheckIndices(TestModel, Builder, MixedPrimitives);
+}
+
+TEST(Tools_AssetLoader, GLTFAdaptiveIndexTypeLargePrimitive)
+{
+    // The only primitive exceeds the 16-bit range
+    const std::vector<TestPrimitiveData> Prims = {
+        {65536, {0, 65535, 32768, 65534, 65535, 0}, VT_UINT32},
+    };
+    const auto GltfModel = CreateTestModel(Prims);
+
+    ModelCreateInfo CI;
+    CI.AdaptiveIndexType = true;
+
+    Model        TestModel{CI};
+    ModelBuilder Builder{CI, TestModel};
+    Builder.Execute(GltfModel, -1, nullptr);
+
+    const auto& Prim = TestModel.Meshes[0].Primitives[0];
+    EXPECT_EQ(Prim.IndexType, VT_UINT32);
+    EXPECT_EQ(Prim.BaseVertex, Uint32{0});
+    EXPECT_TRUE(Builder.GetIndexData(VT_UINT16).empty());
+    EXPECT_EQ(Builder.GetIndexData(VT_UINT32).size(), Prims[0].Indices.size() * sizeof(Uint32));
+
+    CheckIndices(TestModel, Builder, Prims);
+}
+
+TEST(Tools_AssetLoader, GLTFAdaptiveIndexTypeMaxVertices)
+{
+    // 65535 vertices is the largest primitive that uses 16-bit indices, regardless
+    // of where the primitive starts in the vertex buffer.
+    const std::vector<TestPrimitiveData> Prims = {
+        {65535, {0, 65534, 1}, VT_UINT32},
+        {65536, {0, 65535, 1}, VT_UINT32},
+        {65535, {65534, 0, 1}, VT_UINT16},
+    };
+    const auto GltfModel = CreateTestModel(Prims);
+
+    ModelCreateInfo CI;
+    CI.AdaptiveIndexType = true;
+
+    Model        TestModel{CI};
+    ModelBuilder Builder{CI, TestModel};
+    Builder.Execute(GltfModel, -1, nullptr);
+
+    const auto& Primitives = TestModel.Meshes[0].Primitives;
+    ASSERT_EQ(Primitives.size(), size_t{3});
+    EXPECT_EQ(Primitives[0].IndexType, VT_UINT16);
+    EXPECT_EQ(Primitives[1].IndexType, VT_UINT32);
+    EXPECT_EQ(Primitives[2].IndexType, VT_UINT16);
+    EXPECT_EQ(Primitives[2].BaseVertex, Uint32{65535 + 65536});
+
+    CheckIndices(TestModel, Builder, Prims);
+}
+
+TEST(Tools_AssetLoader, GLTFAdaptiveIndexTypeDisabled)
+{
+    const auto GltfModel = CreateTestModel(MixedPrimitives);
+
+    ModelCreateInfo CI;
+    CI.IndexType = VT_UINT32;
+
+    Model        TestModel{CI};
+    ModelBuilder Builder{CI, TestModel};
+    Builder.Execute(GltfModel, -1, nullptr);
+
+    EXPECT_EQ(TestModel.IndexData.IndexSize, Uint32{4});
+    EXPECT_EQ(TestModel.IndexData16.IndexSize, Uint32{0});
+
+    // All primitives use absolute 32-bit indices
+    for (const auto& Prim : TestModel.Meshes[0].Primitives)
+    {
+        EXPECT_EQ(Prim.IndexType, VT_UINT32);
+        EXPECT_EQ(Prim.BaseVertex, Uint32{0});
+    }
+    EXPECT_EQ(TestModel.Meshes[0].Primitives[2].FirstVertex, Uint32{70004});
+    EXPECT_EQ(Builder.GetIndexData(VT_UINT32).size(), size_t{15} * sizeof(Uint32));
+
+    CheckIndices(TestModel, Builder, MixedPrimitives);
+}
+
+} // namespace
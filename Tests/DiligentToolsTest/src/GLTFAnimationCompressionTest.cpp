@@ -0,0 +1,370 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "GLTFAnimationCompression.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace Diligent::GLTF;
+
+namespace
+{
+
+using TRACK_TYPE = CompressedAnimationTrack::TRACK_TYPE;
+
+struct SourceTrack
+{
+    TRACK_TYPE          Type;
+    bool                Step = false;
+    std::vector<float>  Times;
+    std::vector<float4> Values;
+
+    // Reference evaluation of the uncompressed track
+    float4 Sample(float Time) const
+    {
+        Time          = clamp(Time, Times.front(), Times.back());
+        const auto It = std::upper_bound(Times.begin(), Times.end(), Time);
+        const size_t Key = It != Times.begin() ? static_cast<size_t>(It - Times.begin()) - 1 : 0;
+        if (Step || Key + 1 >= Times.size())
+            return Values[Key];
+
+        const float u = (Time - Times[Key]) / (Times[Key + 1] - Times[Key]);
+        if (Type == TRACK_TYPE::ROTATION)
+        {
+            QuaternionF q0, q1;
+            q0.q = Values[Key];
+            q1.q = Values[Key + 1];
+            return normalize(slerp(q0, q1, u)).q;
+        }
+        return lerp(Values[Key], Values[Key + 1], u);
+    }
+
+    CompressedAnimationTrack Compress(const AnimationCompressionInfo& Info) const
+    {
+        return CompressedAnimationTrack{Type, Times.data(), Values.data(), static_cast<Uint32>(Times.size()), Step, Info};
+    }
+};
+
+// Generates a smooth motion-capture-like track sampled at 120 Hz
+SourceTrack GenerateTrack(TRACK_TYPE Type, Uint32 NumKeys, std::mt19937& Gen)
+{
+    std::uniform_real_distribution<float> Rnd{0, 1};
+
+    float Freq[3], Phase[3], Amplitude[3];
+    for (int c = 0; c < 3; ++c)
+    {
+        Freq[c]      = 0.05f + Rnd(Gen) * 0.5f;
+        Phase[c]     = Rnd(Gen) * 6.28f;
+        Amplitude[c] = Type == TRACK_TYPE::ROTATION ? 0.5f + Rnd(Gen) * 0.5f : (Type == TRACK_TYPE::SCALE ? 0.02f : 0.05f);
+    }
+
+    SourceTrack Track;
+    Track.Type = Type;
+    Track.Times.resize(NumKeys);
+    Track.Values.resize(NumKeys);
+    for (Uint32 k = 0; k < NumKeys; ++k)
+    {
+        const float t  = static_cast<float>(k) / 120.f;
+        Track.Times[k] = t;
+
+        float3 v;
+        for (int c = 0; c < 3; ++c)
+            v[c] = Amplitude[c] * (std::sin(t * Freq[c] * 6.28f + Phase[c]) + 0.1f * std::sin(t * Freq[c] * 19.f));
+
+        if (Type == TRACK_TYPE::ROTATION)
+        {
+            // Euler angles
+            const auto q = QuaternionF::RotationFromAxisAngle(float3{1, 0, 0}, v.x) *
+                QuaternionF::RotationFromAxisAngle(float3{0, 1, 0}, v.y) *
+                QuaternionF::RotationFromAxisAngle(float3{0, 0, 1}, v.z);
+            Track.Values[k] = q.q;
+        }
+        else
+        {
+            if (Type == TRACK_TYPE::SCALE)
+                v = v + float3{1, 1, 1};
+            Track.Values[k] = float4{v, 0};
+        }
+    }
+    return Track;
+}
+
+float GetTolerance(TRACK_TYPE Type, const AnimationCompressionInfo& Info)
+{
+    return Type == TRACK_TYPE::TRANSLATION ? Info.TranslationTolerance : (Type == TRACK_TYPE::ROTATION ? Info.RotationTolerance : Info.ScaleTolerance);
+}
+
+// Returns the maximum error at the source keys and in between
+float MeasureMaxError(const SourceTrack& Src, const CompressedAnimationTrack& Track, float ShellDistance, Uint32 SamplesPerKey)
+{
+    float MaxError = 0;
+    for (size_t k = 0; k < Src.Times.size(); ++k)
+    {
+        for (Uint32 s = 0; s < (k + 1 < Src.Times.size() ? SamplesPerKey : 1); ++s)
+        {
+            const float Time = k + 1 < Src.Times.size() ?
+                Src.Times[k] + (Src.Times[k + 1] - Src.Times[k]) * static_cast<float>(s) / static_cast<float>(SamplesPerKey) :
+                Src.Times[k];
+            MaxError = std::max(MaxError, CompressedAnimationTrack::ComputeError(Src.Type, Track.Sample(Time), Src.Sample(Time), ShellDistance));
+        }
+    }
+    return MaxError;
+}
+
+TEST(Tools_AssetLoader, AnimationCompressionErrorBound)
+{
+    std::mt19937 Gen{0};
+
+    AnimationCompressionInfo Info;
+    for (auto Type : {TRACK_TYPE::TRANSLATION, TRACK_TYPE::ROTATION, TRACK_TYPE::SCALE})
+    {
+        for (int i = 0; i < 10; ++i)
+        {
+            const auto Src   = GenerateTrack(Type, 1200, Gen);
+            const auto Track = Src.Compress(Info);
+            ASSERT_FALSE(Track.IsEmpty());
+            EXPECT_EQ(Track.GetType(), Type);
+
+            const float Tolerance = GetTolerance(Type, Info);
+            // The error is checked at the source keys and in the middle between them
+            EXPECT_LE(MeasureMaxError(Src, Track, Info.ShellDistance, 2), Tolerance);
+            // The validation margin keeps the error between the check points within the tolerance
+            EXPECT_LE(MeasureMaxError(Src, Track, Info.ShellDistance, 8), Tolerance);
+
+            // Smooth tracks are reduced considerably
+            EXPECT_LT(Track.GetKeyCount(), Src.Times.size() / 3);
+            // The first and the last keys are always kept, so the track duration is preserved
+            EXPECT_EQ(Track.GetKeyTime(0), Src.Times.front());
+            EXPECT_EQ(Track.GetKeyTime(Track.GetKeyCount() - 1), Src.Times.back());
+        }
+    }
+
+    // Looser tolerance removes more keys
+    auto Src   = GenerateTrack(TRACK_TYPE::TRANSLATION, 1200, Gen);
+    auto Track = Src.Compress(Info);
+
+    AnimationCompressionInfo LooseInfo;
+    LooseInfo.TranslationTolerance = 1e-2f;
+    auto LooseTrack                = Src.Compress(LooseInfo);
+    EXPECT_LT(LooseTrack.GetKeyCount(), Track.GetKeyCount());
+    EXPECT_LE(MeasureMaxError(Src, LooseTrack, LooseInfo.ShellDistance, 2), LooseInfo.TranslationTolerance);
+}
+
+TEST(Tools_AssetLoader, AnimationCompressionConstantTracks)
+{
+    AnimationCompressionInfo Info;
+
+    std::mt19937                          Gen{1};
+    std::uniform_real_distribution<float> Jitter{-1e-5f, 1e-5f};
+
+    SourceTrack Src;
+    Src.Type = TRACK_TYPE::SCALE;
+    for (int k = 0; k < 500; ++k)
+    {
+        Src.Times.push_back(static_cast<float>(k) / 30.f);
+        Src.Values.push_back(float4{1 + Jitter(Gen), 2 + Jitter(Gen), 3 + Jitter(Gen), 0});
+    }
+
+    // Only the first and the last keys remain
+    const auto Track = Src.Compress(Info);
+    ASSERT_EQ(Track.GetKeyCount(), 2u);
+    EXPECT_EQ(Track.GetKeyTime(0), Src.Times.front());
+    EXPECT_EQ(Track.GetKeyTime(1), Src.Times.back());
+    EXPECT_LE(MeasureMaxError(Src, Track, Info.ShellDistance, 2), Info.ScaleTolerance);
+    // Time outside of the track range is clamped
+    EXPECT_LE(CompressedAnimationTrack::ComputeError(Src.Type, Track.Sample(-10), Src.Values.front(), Info.ShellDistance), Info.ScaleTolerance);
+    EXPECT_LE(CompressedAnimationTrack::ComputeError(Src.Type, Track.Sample(100), Src.Values.back(), Info.ShellDistance), Info.ScaleTolerance);
+
+    // Single key
+    const float  Time  = 5;
+    const float4 Value = QuaternionF::RotationFromAxisAngle(normalize(float3{1, 2, 3}), 1).q;
+
+    const CompressedAnimationTrack SingleKey{TRACK_TYPE::ROTATION, &Time, &Value, 1, false, Info};
+    ASSERT_EQ(SingleKey.GetKeyCount(), 1u);
+    EXPECT_FLOAT_EQ(SingleKey.GetKeyTime(0), Time);
+    EXPECT_LE(CompressedAnimationTrack::ComputeError(TRACK_TYPE::ROTATION, SingleKey.Sample(0), Value, Info.ShellDistance), Info.RotationTolerance);
+
+    // Empty track
+    const CompressedAnimationTrack Empty{TRACK_TYPE::TRANSLATION, nullptr, nullptr, 0, false, Info};
+    EXPECT_TRUE(Empty.IsEmpty());
+}
+
+TEST(Tools_AssetLoader, AnimationCompressionQuaternions)
+{
+    std::mt19937                          Gen{2};
+    std::uniform_real_distribution<float> Rnd{-1, 1};
+
+    AnimationCompressionInfo Info;
+    Info.ShellDistance     = 1;
+    Info.RotationTolerance = 1e-3f;
+
+    float MaxError = 0;
+    for (int i = 0; i < 1000; ++i)
+    {
+        const float  Time = 0;
+        const float4 q    = normalize(float4{Rnd(Gen), Rnd(Gen), Rnd(Gen), Rnd(Gen)});
+
+        const CompressedAnimationTrack Track{TRACK_TYPE::ROTATION, &Time, &q, 1, false, Info};
+        ASSERT_EQ(Track.GetKeyCount(), 1u);
+
+        // The quantized quaternion may have the opposite sign
+        const float4 Decoded = Track.GetKeyValue(0);
+        EXPECT_NEAR(length(Decoded), 1.f, 1e-5f);
+        EXPECT_NEAR(std::abs(dot(Decoded, q)), 1.f, 1e-6f);
+        MaxError = std::max(MaxError, CompressedAnimationTrack::ComputeError(TRACK_TYPE::ROTATION, Decoded, q, 1));
+    }
+    // 15 bits per component give the angular precision of about 1e-4 radians
+    EXPECT_LE(MaxError, 2e-4f);
+
+    // Rotation error is the displacement of the virtual vertex
+    const float4 q0 = QuaternionF::RotationFromAxisAngle(float3{0, 0, 1}, 0).q;
+    const float4 q1 = QuaternionF::RotationFromAxisAngle(float3{0, 0, 1}, 0.01f).q;
+    EXPECT_NEAR(CompressedAnimationTrack::ComputeError(TRACK_TYPE::ROTATION, q0, q1, 2), 2 * 2 * std::sin(0.005f), 1e-6f);
+    EXPECT_NEAR(CompressedAnimationTrack::ComputeError(TRACK_TYPE::ROTATION, q0, -q1, 2), 2 * 2 * std::sin(0.005f), 1e-6f);
+}
+
+TEST(Tools_AssetLoader, AnimationCompressionStepTracks)
+{
+    std::mt19937                          Gen{3};
+    std::uniform_real_distribution<float> Rnd{-1, 1};
+
+    SourceTrack Src;
+    Src.Type = TRACK_TYPE::TRANSLATION;
+    Src.Step = true;
+    for (int k = 0; k < 300; ++k)
+    {
+        Src.Times.push_back(static_cast<float>(k) * 0.1f + 0.25f);
+        // Every value is repeated three times
+        if (k % 3 == 0)
+            Src.Values.push_back(float4{Rnd(Gen), Rnd(Gen), Rnd(Gen), 0});
+        else
+            Src.Values.push_back(Src.Values.back());
+    }
+
+    AnimationCompressionInfo Info;
+
+    // One key for every distinct value, and the last key that preserves the track duration
+    const auto Track = Src.Compress(Info);
+    EXPECT_EQ(Track.GetKeyCount(), 101u);
+    EXPECT_EQ(Track.GetKeyTime(Track.GetKeyCount() - 1), Src.Times.back());
+    EXPECT_LE(MeasureMaxError(Src, Track, Info.ShellDistance, 4), Info.TranslationTolerance);
+    for (float Time : Src.Times)
+    {
+        EXPECT_LE(CompressedAnimationTrack::ComputeError(Src.Type, Track.Sample(Time), Src.Sample(Time), Info.ShellDistance), Info.TranslationTolerance);
+    }
+}
+
+TEST(Tools_AssetLoader, AnimationCompressionLargeRange)
+{
+    // 16-bit quantization of a 1 km range can't meet the default tolerance
+    SourceTrack Src;
+    Src.Type = TRACK_TYPE::TRANSLATION;
+    for (int k = 0; k < 100; ++k)
+    {
+        Src.Times.push_back(static_cast<float>(k));
+        Src.Values.push_back(float4{static_cast<float>(k) * 10.f + 0.123f * static_cast<float>(k % 7), 0, 0, 0});
+    }
+
+    AnimationCompressionInfo Info;
+    EXPECT_TRUE(Src.Compress(Info).IsEmpty());
+
+    Info.TranslationTolerance = 0.1f;
+    const auto Track          = Src.Compress(Info);
+    EXPECT_FALSE(Track.IsEmpty());
+    EXPECT_LE(MeasureMaxError(Src, Track, Info.ShellDistance, 2), Info.TranslationTolerance);
+}
+
+// Reports the memory usage and the sampling speed. Run with --gtest_also_run_disabled_tests.
+TEST(Tools_AssetLoader, DISABLED_AnimationCompressionBenchmark)
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    std::mt19937 Gen{4};
+
+    // 60 joints, 30 seconds of motion capture at 120 Hz
+    constexpr Uint32 NumJoints = 60;
+    constexpr Uint32 NumKeys   = 3600;
+
+    std::vector<SourceTrack>              SrcTracks;
+    std::vector<CompressedAnimationTrack> Tracks;
+
+    AnimationCompressionInfo Info;
+
+    size_t SrcSize        = 0;
+    size_t CompressedSize = 0;
+    auto   Start          = Clock::now();
+    for (Uint32 j = 0; j < NumJoints; ++j)
+    {
+        for (auto Type : {TRACK_TYPE::TRANSLATION, TRACK_TYPE::ROTATION, TRACK_TYPE::SCALE})
+        {
+            SrcTracks.push_back(GenerateTrack(Type, NumKeys, Gen));
+            SrcSize += NumKeys * (sizeof(float) + sizeof(float4));
+        }
+    }
+    for (const auto& Src : SrcTracks)
+    {
+        Tracks.push_back(Src.Compress(Info));
+        CompressedSize += sizeof(CompressedAnimationTrack) + Tracks.back().GetMemorySize();
+    }
+    std::cout << "Compression time: " << std::chrono::duration<double>{Clock::now() - Start}.count() * 1000 << " ms" << std::endl;
+    std::cout << "Memory: " << SrcSize / 1024 << " KB -> " << CompressedSize / 1024 << " KB" << std::endl;
+
+    constexpr int NumFrames = 2000;
+
+    float4 Sum;
+    Start = Clock::now();
+    for (int f = 0; f < NumFrames; ++f)
+    {
+        const float Time = static_cast<float>(f) * 0.0137f;
+        for (const auto& Src : SrcTracks)
+            Sum = Sum + Src.Sample(Time);
+    }
+    const double SrcTime = std::chrono::duration<double>{Clock::now() - Start}.count();
+
+    Start = Clock::now();
+    for (int f = 0; f < NumFrames; ++f)
+    {
+        const float Time = static_cast<float>(f) * 0.0137f;
+        for (const auto& Track : Tracks)
+            Sum = Sum + Track.Sample(Time);
+    }
+    const double CompressedTime = std::chrono::duration<double>{Clock::now() - Start}.count();
+
+    const double NumSamples = static_cast<double>(NumFrames) * SrcTracks.size();
+    std::cout << "Source sampling:     " << NumSamples / SrcTime * 1e-6 << " Msamples/s" << std::endl;
+    std::cout << "Compressed sampling: " << NumSamples / CompressedTime * 1e-6 << " Msamples/s (" << Sum.x << ")" << std::endl;
+}
+
+} // namespace
@@ -0,0 +1,308 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "GLTFJointBounds.hpp"
+
+#include <cfloat>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace Diligent::GLTF;
+
+namespace
+{
+
+struct SkinnedVertex
+{
+    float3 Pos;
+    float4 Joints;
+    float4 Weights;
+};
+
+struct RandomSkin
+{
+    std::vector<SkinnedVertex> Vertices;
+    std::vector<float4x4>      InverseBindMatrices;
+
+    RandomSkin(Uint32 NumJoints, Uint32 NumVertices, std::mt19937& Gen)
+    {
+        std::uniform_real_distribution<float> Coord{-1, 1};
+        std::uniform_real_distribution<float> Angle{-PI_F, PI_F};
+        std::uniform_int_distribution<Uint32> Joint{0, NumJoints - 1};
+        std::uniform_int_distribution<Uint32> NumInfluences{1, 4};
+
+        InverseBindMatrices.resize(NumJoints);
+        for (auto& IBM : InverseBindMatrices)
+        {
+            IBM = float4x4::RotationX(Angle(Gen)) * float4x4::RotationY(Angle(Gen)) *
+                float4x4::Translation(Coord(Gen), Coord(Gen), Coord(Gen));
+        }
+
+        Vertices.resize(NumVertices);
+        for (auto& Vert : Vertices)
+        {
+            Vert.Pos = float3{Coord(Gen), Coord(Gen), Coord(Gen)} * 2;
+
+            // Unused influences have zero weights, but may reference any joint
+            const Uint32 NumVertInfluences = NumInfluences(Gen);
+
+            float TotalWeight = 0;
+            for (Uint32 i = 0; i < 4; ++i)
+            {
+                Vert.Joints[i]  = static_cast<float>(Joint(Gen));
+                Vert.Weights[i] = i < NumVertInfluences ? std::abs(Coord(Gen)) + 0.01f : 0.f;
+                TotalWeight += Vert.Weights[i];
+            }
+            Vert.Weights = Vert.Weights / TotalWeight;
+        }
+    }
+
+    SkinnedVertexData GetVertexData() const
+    {
+        SkinnedVertexData Data;
+        Data.pPositions     = &Vertices[0].Pos;
+        Data.PositionStride = sizeof(SkinnedVertex);
+        Data.pJoints        = &Vertices[0].Joints;
+        Data.JointType      = VT_FLOAT32;
+        Data.JointStride    = sizeof(SkinnedVertex);
+        Data.pWeights       = &Vertices[0].Weights;
+        Data.WeightType     = VT_FLOAT32;
+        Data.WeightStride   = sizeof(SkinnedVertex);
+        Data.NumVertices    = static_cast<Uint32>(Vertices.size());
+        return Data;
+    }
+
+    std::vector<BoundBox> ComputeJointBounds(const SkinnedVertexData& Data, float WeightThreshold = 0) const
+    {
+        std::vector<BoundBox> JointBounds(InverseBindMatrices.size());
+        for (auto& BB : JointBounds)
+        {
+            BB.Min = float3{+FLT_MAX, +FLT_MAX, +FLT_MAX};
+            BB.Max = float3{-FLT_MAX, -FLT_MAX, -FLT_MAX};
+        }
+        ComputeJointBoundingBoxes(Data, InverseBindMatrices.data(), static_cast<Uint32>(JointBounds.size()), WeightThreshold, JointBounds.data());
+        return JointBounds;
+    }
+
+    // Computes the bounds of linear-blend skinned vertices, where the vertex is transformed
+    // by InverseBindMatrix * JointMatrix for every joint.
+    BoundBox ComputeBruteForceBounds(const std::vector<float4x4>& JointMatrices) const
+    {
+        BoundBox BB;
+        BB.Min = float3{+FLT_MAX, +FLT_MAX, +FLT_MAX};
+        BB.Max = float3{-FLT_MAX, -FLT_MAX, -FLT_MAX};
+        for (const auto& Vert : Vertices)
+        {
+            float3 Pos;
+            for (Uint32 i = 0; i < 4; ++i)
+            {
+                const auto Joint    = static_cast<size_t>(Vert.Joints[i]);
+                const auto JointPos = float4{Vert.Pos, 1} * InverseBindMatrices[Joint] * JointMatrices[Joint];
+                Pos += float3{JointPos.x, JointPos.y, JointPos.z} * Vert.Weights[i];
+            }
+            BB.Min = std::min(BB.Min, Pos);
+            BB.Max = std::max(BB.Max, Pos);
+        }
+        return BB;
+    }
+};
+
+std::vector<float4x4> GenerateRandomPose(size_t NumJoints, std::mt19937& Gen, bool RotateJoints)
+{
+    std::uniform_real_distribution<float> Coord{-10, 10};
+    std::uniform_real_distribution<float> Angle{-PI_F, PI_F};
+    std::uniform_real_distribution<float> Scale{0.5f, 2.f};
+
+    std::vector<float4x4> JointMatrices(NumJoints);
+    for (auto& Mat : JointMatrices)
+    {
+        Mat = float4x4::Scale(Scale(Gen));
+        if (RotateJoints)
+            Mat = Mat * float4x4::RotationZ(Angle(Gen)) * float4x4::RotationX(Angle(Gen));
+        Mat = Mat * float4x4::Translation(Coord(Gen), Coord(Gen), Coord(Gen));
+    }
+    return JointMatrices;
+}
+
+void CheckContains(const BoundBox& Outer, const BoundBox& Inner, float Tolerance)
+{
+    for (int c = 0; c < 3; ++c)
+    {
+        EXPECT_LE(Outer.Min[c], Inner.Min[c] + Tolerance);
+        EXPECT_GE(Outer.Max[c], Inner.Max[c] - Tolerance);
+    }
+}
+
+TEST(Tools_AssetLoader, JointBoundsRandomPoses)
+{
+    std::mt19937 Gen{0};
+
+    RandomSkin Skin{16, 1000, Gen};
+
+    const auto JointBounds = Skin.ComputeJointBounds(Skin.GetVertexData());
+    for (int Pose = 0; Pose < 100; ++Pose)
+    {
+        const auto JointMatrices = GenerateRandomPose(JointBounds.size(), Gen, true);
+        const auto SkinBB        = ComputeSkinBoundingBox(JointBounds.data(), JointMatrices.data(), static_cast<Uint32>(JointBounds.size()));
+        const auto RefBB         = Skin.ComputeBruteForceBounds(JointMatrices);
+        CheckContains(SkinBB, RefBB, 1e-3f);
+    }
+}
+
+TEST(Tools_AssetLoader, JointBoundsRigidSkin)
+{
+    std::mt19937 Gen{1};
+
+    RandomSkin Skin{8, 1000, Gen};
+    // Every vertex is influenced by a single joint
+    for (auto& Vert : Skin.Vertices)
+        Vert.Weights = float4{1, 0, 0, 0};
+    // Joint boxes are not rotated, so the bounds are exact
+    for (auto& IBM : Skin.InverseBindMatrices)
+        IBM = float4x4::Translation(IBM._41, IBM._42, IBM._43);
+
+    const auto JointBounds = Skin.ComputeJointBounds(Skin.GetVertexData());
+    for (int Pose = 0; Pose < 20; ++Pose)
+    {
+        const auto JointMatrices = GenerateRandomPose(JointBounds.size(), Gen, false);
+        const auto SkinBB        = ComputeSkinBoundingBox(JointBounds.data(), JointMatrices.data(), static_cast<Uint32>(JointBounds.size()));
+        const auto RefBB         = Skin.ComputeBruteForceBounds(JointMatrices);
+        for (int c = 0; c < 3; ++c)
+        {
+            EXPECT_NEAR(SkinBB.Min[c], RefBB.Min[c], 1e-3f);
+            EXPECT_NEAR(SkinBB.Max[c], RefBB.Max[c], 1e-3f);
+        }
+    }
+}
+
+TEST(Tools_AssetLoader, JointBoundsVertexFormats)
+{
+    std::mt19937 Gen{2};
+
+    RandomSkin Skin{200, 500, Gen};
+
+    struct PackedVertex
+    {
+        float3 Pos;
+        Uint16 Joints[4];
+        Uint8  Weights[4];
+    };
+    std::vector<PackedVertex> PackedVertices(Skin.Vertices.size());
+    for (size_t v = 0; v < Skin.Vertices.size(); ++v)
+    {
+        auto& Vert = Skin.Vertices[v];
+
+        PackedVertices[v].Pos = Vert.Pos;
+        for (Uint32 i = 0; i < 4; ++i)
+        {
+            PackedVertices[v].Joints[i]  = static_cast<Uint16>(Vert.Joints[i]);
+            PackedVertices[v].Weights[i] = static_cast<Uint8>(Vert.Weights[i] * 255.f + 0.5f);
+            // Make the float weights match the quantized ones
+            Vert.Weights[i] = PackedVertices[v].Weights[i] / 255.f;
+        }
+    }
+
+    SkinnedVertexData Data;
+    Data.pPositions     = &PackedVertices[0].Pos;
+    Data.PositionStride = sizeof(PackedVertex);
+    Data.pJoints        = &PackedVertices[0].Joints;
+    Data.JointType      = VT_UINT16;
+    Data.JointStride    = sizeof(PackedVertex);
+    Data.pWeights       = &PackedVertices[0].Weights;
+    Data.WeightType     = VT_UINT8;
+    Data.WeightStride   = sizeof(PackedVertex);
+    Data.NumVertices    = static_cast<Uint32>(PackedVertices.size());
+
+    const auto PackedBounds = Skin.ComputeJointBounds(Data);
+    const auto RefBounds    = Skin.ComputeJointBounds(Skin.GetVertexData());
+    ASSERT_EQ(PackedBounds.size(), RefBounds.size());
+    for (size_t j = 0; j < RefBounds.size(); ++j)
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            EXPECT_EQ(PackedBounds[j].Min[c], RefBounds[j].Min[c]);
+            EXPECT_EQ(PackedBounds[j].Max[c], RefBounds[j].Max[c]);
+        }
+    }
+}
+
+TEST(Tools_AssetLoader, JointBoundsEdgeCases)
+{
+    const float3 Positions[] = {{1, 2, 3}, {-1, 0, 5}, {4, 4, 4}};
+    const Uint8  Joints[]    = {0, 1, 0, 0, /**/ 5, 1, 0, 0, /**/ 0, 1, 0, 0};
+    const float  Weights[]   = {0.75f, 0.25f, 0, 0, /**/ 0.5f, 0.5f, 0, 0, /**/ 0, 0, 0, 0};
+
+    SkinnedVertexData Data;
+    Data.pPositions   = Positions;
+    Data.pJoints      = Joints;
+    Data.JointType    = VT_UINT8;
+    Data.JointStride  = 4;
+    Data.pWeights     = Weights;
+    Data.WeightStride = 4 * sizeof(float);
+    Data.NumVertices  = _countof(Positions);
+
+    BoundBox JointBounds[3];
+    for (auto& BB : JointBounds)
+    {
+        BB.Min = float3{+FLT_MAX, +FLT_MAX, +FLT_MAX};
+        BB.Max = float3{-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    }
+
+    // Out-of-range joint 5 and the vertex without weights are ignored
+    ComputeJointBoundingBoxes(Data, nullptr, _countof(JointBounds), 0, JointBounds);
+    EXPECT_EQ(JointBounds[0].Min, float3(1, 2, 3));
+    EXPECT_EQ(JointBounds[0].Max, float3(1, 2, 3));
+    EXPECT_EQ(JointBounds[1].Min, float3(-1, 0, 3));
+    EXPECT_EQ(JointBounds[1].Max, float3(1, 2, 5));
+    // Joint 2 does not influence any vertex
+    EXPECT_GT(JointBounds[2].Min.x, JointBounds[2].Max.x);
+
+    const float4x4 JointMatrices[] = {float4x4::Translation(10, 0, 0), float4x4::Identity(), float4x4::Translation(100, 100, 100)};
+
+    auto SkinBB = ComputeSkinBoundingBox(JointBounds, JointMatrices, _countof(JointBounds));
+    EXPECT_EQ(SkinBB.Min, float3(-1, 0, 3));
+    EXPECT_EQ(SkinBB.Max, float3(11, 2, 5));
+
+    // Influences with weights not greater than the threshold are ignored
+    for (auto& BB : JointBounds)
+    {
+        BB.Min = float3{+FLT_MAX, +FLT_MAX, +FLT_MAX};
+        BB.Max = float3{-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    }
+    ComputeJointBoundingBoxes(Data, nullptr, _countof(JointBounds), 0.5f, JointBounds);
+    EXPECT_EQ(JointBounds[0].Min, float3(1, 2, 3));
+    EXPECT_GT(JointBounds[1].Min.x, JointBounds[1].Max.x);
+
+    // No joints influence any vertex
+    SkinBB = ComputeSkinBoundingBox(&JointBounds[1], &JointMatrices[1], 2);
+    EXPECT_GT(SkinBB.Min.x, SkinBB.Max.x);
+}
+
+} // namespace
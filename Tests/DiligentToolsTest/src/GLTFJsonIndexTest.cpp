@@ -0,0 +1,248 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "GLTFJsonIndex.hpp"
+
+#include <cmath>
+#include <cstdlib>
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace Diligent::GLTF;
+
+namespace
+{
+
+// The index references the source text, so the string must outlive it
+bool ParseJson(JsonIndex& Index, const std::string& Json)
+{
+    return Index.Parse(Json.c_str(), Json.size());
+}
+
+TEST(Tools_AssetLoader, GLTFJsonIndexStructure)
+{
+    const std::string Json = R"({
+        "asset": {"version": "2.0"},
+        "nodes": [
+            {"name": "Root", "children": [1, 2]},
+            {"name": "Child1", "translation": [1.5, -2, 3e2]},
+            {"name": "Child2", "extras": {}, "weights": []}
+        ],
+        "flag": true,
+        "off": false,
+        "nothing": null
+    })";
+
+    JsonIndex Index;
+    ASSERT_TRUE(ParseJson(Index, Json));
+
+    const auto Root = Index.GetRoot();
+    ASSERT_TRUE(Root.IsObject());
+    EXPECT_EQ(Root.GetSize(), 5u);
+
+    EXPECT_TRUE(Root.Find("asset").Find("version").StringEquals("2.0"));
+    EXPECT_FALSE(Root.Find("asset").Find("version").StringEquals("2"));
+    EXPECT_FALSE(Root.Find("missing"));
+    EXPECT_TRUE(Root.Find("flag").GetBool());
+    EXPECT_TRUE(Root.Find("off").IsBool());
+    EXPECT_FALSE(Root.Find("off").GetBool(true));
+    EXPECT_TRUE(Root.Find("nothing").IsNull());
+    EXPECT_TRUE(Root.Find("nothing").IsValid());
+
+    const auto Nodes = Root.Find("nodes");
+    ASSERT_TRUE(Nodes.IsArray());
+    ASSERT_EQ(Nodes.GetSize(), 3u);
+    EXPECT_FALSE(Nodes[3]);
+
+    EXPECT_EQ(Nodes[0].Find("name").GetString(), "Root");
+    EXPECT_EQ(Nodes[0].Find("children").GetNumberArray<int>(), (std::vector<int>{1, 2}));
+    EXPECT_EQ(Nodes[1].Find("translation").GetNumberArray<double>(), (std::vector<double>{1.5, -2, 300}));
+    EXPECT_EQ(Nodes[2].Find("name").GetString(), "Child2");
+    EXPECT_TRUE(Nodes[2].Find("extras").IsObject());
+    EXPECT_EQ(Nodes[2].Find("extras").GetSize(), 0u);
+    EXPECT_EQ(Nodes[2].Find("weights").GetSize(), 0u);
+
+    std::vector<std::string> Names;
+    Nodes.ProcessElements([&](Uint32 Idx, const JsonValue& Node) {
+        EXPECT_EQ(Node.GetType(), JSON_TYPE_OBJECT);
+        EXPECT_EQ(Nodes[Idx].GetRawData(), Node.GetRawData());
+        Names.push_back(Node.Find("name").GetString());
+    });
+    EXPECT_EQ(Names, (std::vector<std::string>{"Root", "Child1", "Child2"}));
+
+    std::vector<std::string> Keys;
+    Root.ProcessMembers([&](const JsonValue& Key, const JsonValue& Value) {
+        Keys.push_back(Key.GetString());
+        EXPECT_TRUE(Value.IsValid());
+    });
+    EXPECT_EQ(Keys, (std::vector<std::string>{"asset", "nodes", "flag", "off", "nothing"}));
+
+    EXPECT_EQ(std::string(Root.Find("asset").GetRawData(), Root.Find("asset").GetRawSize()), R"({"version": "2.0"})");
+    EXPECT_EQ(std::string(Nodes[0].Find("name").GetRawData(), Nodes[0].Find("name").GetRawSize()), R"("Root")");
+}
+
+TEST(Tools_AssetLoader, GLTFJsonIndexStrings)
+{
+    const std::string Json = R"(["plain", "a\"b\\c\/d", "\b\f\n\r\t", "Aé€", "😀", ""])";
+
+    JsonIndex Index;
+    ASSERT_TRUE(ParseJson(Index, Json));
+
+    const auto Root = Index.GetRoot();
+    ASSERT_EQ(Root.GetSize(), 6u);
+    EXPECT_EQ(Root[0].GetString(), "plain");
+    EXPECT_EQ(Root[1].GetString(), "a\"b\\c/d");
+    EXPECT_TRUE(Root[1].StringEquals("a\"b\\c/d"));
+    EXPECT_EQ(Root[2].GetString(), "\b\f\n\r\t");
+    EXPECT_EQ(Root[3].GetString(), "A\xC3\xA9\xE2\x82\xAC");
+    EXPECT_EQ(Root[4].GetString(), "\xF0\x9F\x98\x80");
+    EXPECT_EQ(Root[5].GetString(), "");
+    EXPECT_TRUE(Root[5].StringEquals(""));
+
+    EXPECT_EQ(Root[0].GetNumber(7), 7);
+    EXPECT_EQ(Root.Find("key").IsValid(), false);
+}
+
+TEST(Tools_AssetLoader, GLTFJsonIndexNumbers)
+{
+    const char* Numbers[] = {
+        "0",
+        "-0",
+        "1",
+        "-17",
+        "0.1",
+        "3.14159265358979",
+        "1e10",
+        "1E-5",
+        "2.5e+3",
+        "-0.000001234",
+        "9007199254740993",
+        "12345678901234567890123",
+        "0.30000000000000004",
+        "1.7976931348623157e308",
+        "4.9e-324",
+        "123456789012345678901234567890e-20",
+        "0.00000000000000000000000000000000001",
+    };
+
+    for (const char* Num : Numbers)
+    {
+        JsonIndex Index;
+        ASSERT_TRUE(Index.Parse(Num, strlen(Num))) << Num;
+        EXPECT_EQ(Index.GetRoot().GetNumber(), std::strtod(Num, nullptr)) << Num;
+    }
+
+    const std::string Array = "[5, 4.0, -3.9]";
+
+    JsonIndex Index;
+    ASSERT_TRUE(ParseJson(Index, Array));
+    EXPECT_EQ(Index.GetRoot().GetNumberArray<int>(), (std::vector<int>{5, 4, -3}));
+    EXPECT_EQ(Index.GetRoot()[0].GetInt(), 5);
+    EXPECT_EQ(Index.GetRoot().GetInt(-1), -1);
+
+    const std::string Sizes = "[0, 42, 4.0, 2147483647, 9007199254740992, -1, 0.5, 1e300, -1e300, \"1\"]";
+    JsonIndex         SizesIndex;
+    ASSERT_TRUE(ParseJson(SizesIndex, Sizes));
+    const auto Root = SizesIndex.GetRoot();
+
+    EXPECT_EQ(Root[3].GetInt(), 2147483647);
+    EXPECT_EQ(Root[4].GetInt(-1), -1);
+    EXPECT_EQ(Root[7].GetInt(-1), -1);
+    EXPECT_EQ(Root[8].GetInt(-1), -1);
+
+    const std::vector<Uint64> ValidSizes = {0, 42, 4, 2147483647, 9007199254740992};
+    for (Uint32 i = 0; i < ValidSizes.size(); ++i)
+    {
+        Uint64 Size = ~Uint64{0};
+        EXPECT_TRUE(Root[i].GetUint(Size)) << i;
+        EXPECT_EQ(Size, ValidSizes[i]) << i;
+    }
+    for (Uint32 i = static_cast<Uint32>(ValidSizes.size()); i < Root.GetSize(); ++i)
+    {
+        Uint64 Size = 123;
+        EXPECT_FALSE(Root[i].GetUint(Size)) << i;
+        EXPECT_EQ(Size, 123u) << i;
+    }
+
+    Uint64 Size = 0;
+    EXPECT_TRUE(Root[3].GetUint(Size, 2147483647));
+    EXPECT_FALSE(Root[4].GetUint(Size, 2147483647));
+}
+
+TEST(Tools_AssetLoader, GLTFJsonIndexErrors)
+{
+    const char* InvalidDocs[] = {
+        "",
+        "   ",
+        "{",
+        "[1, 2",
+        "[1, 2,]",
+        "{\"a\" 1}",
+        "{\"a\": 1,}",
+        "{1: 2}",
+        "[01]",
+        "[1.]",
+        "[.5]",
+        "[1e]",
+        "[-]",
+        "[tru]",
+        "[nul]",
+        "\"unterminated",
+        "\"bad \\x escape\"",
+        "\"bad \\u12 escape\"",
+        "\"raw \n newline\"",
+        "[1] [2]",
+        "{\"a\": 1}}",
+        "[1 2]",
+    };
+
+    for (const char* Doc : InvalidDocs)
+    {
+        JsonIndex   Index;
+        std::string Error;
+        EXPECT_FALSE(Index.Parse(Doc, strlen(Doc), &Error)) << Doc;
+        EXPECT_FALSE(Error.empty()) << Doc;
+        EXPECT_FALSE(Index.GetRoot());
+    }
+
+    // Deeply nested document
+    {
+        std::string Doc = std::string(10000, '[') + std::string(10000, ']');
+        JsonIndex   Index;
+        EXPECT_FALSE(ParseJson(Index, Doc));
+    }
+
+    {
+        std::string Doc = std::string(100, '[') + std::string(100, ']');
+        JsonIndex   Index;
+        EXPECT_TRUE(ParseJson(Index, Doc));
+        EXPECT_EQ(Index.GetTokenCount(), 100u);
+    }
+}
+
+} // namespace
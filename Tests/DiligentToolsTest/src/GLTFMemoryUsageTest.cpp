@@ -0,0 +1,170 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "GLTFMemoryUsage.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace Diligent::GLTF;
+
+namespace
+{
+
+TEST(Tools_AssetLoader, GLTFMemoryUsageArithmetic)
+{
+    ModelMemoryUsage Usage;
+    Usage.Vertices     = {100, 10, 4096, 1000};
+    Usage.Indices      = {200, 20, 2048, 500};
+    Usage.MorphTargets = {0, 0, 512, 512};
+    Usage.Textures     = {300, 30, 65536, 65536};
+    Usage.Scene        = {0, 1234, 0, 0};
+
+    Usage.PeakSourceDataSize = 1 << 20;
+
+    const auto Total = Usage.GetTotal();
+    EXPECT_EQ(Total.CPUTransient, 600u);
+    EXPECT_EQ(Total.CPUResident, 1294u);
+    EXPECT_EQ(Total.GPUReserved, 72192u);
+    EXPECT_EQ(Total.GPUUsed, 67548u);
+    EXPECT_EQ(Total.GetCPUTotal(), 1894u);
+
+    ResourceManagerMemoryUsage RMUsage;
+    RMUsage.IndexBuffers   = {0, 0, 1 << 16, 1 << 10};
+    RMUsage.VertexPools    = {0, 0, 1 << 20, 1 << 12};
+    RMUsage.TextureAtlases = {0, 0, 1 << 24, 1 << 22};
+    EXPECT_EQ(RMUsage.GetTotal(), (MemoryUsage{0, 0, (1 << 16) + (1 << 20) + (1 << 24), (1 << 10) + (1 << 12) + (1 << 22)}));
+
+    auto Sum = Total;
+    Sum += RMUsage.GetTotal();
+    EXPECT_EQ(Sum, Total + RMUsage.GetTotal());
+    EXPECT_NE(Sum, Total);
+}
+
+TEST(Tools_AssetLoader, GLTFMemoryBudget)
+{
+    {
+        MemoryBudget Unlimited;
+        EXPECT_TRUE(Unlimited.Fits({~Uint64{0} / 4, ~Uint64{0} / 4, ~Uint64{0} / 4, 0}));
+    }
+
+    MemoryBudget Budget;
+    Budget.MaxCPUMemory = 1000;
+    Budget.MaxGPUMemory = 5000;
+
+    EXPECT_EQ(Budget.GetCPUOverflow({600, 400, 0, 0}), 0u);
+    EXPECT_EQ(Budget.GetCPUOverflow({600, 500, 0, 0}), 100u);
+    EXPECT_EQ(Budget.GetGPUOverflow({0, 0, 5000, 6000}), 0u);
+    EXPECT_EQ(Budget.GetGPUOverflow({0, 0, 5500, 10}), 500u);
+
+    EXPECT_TRUE(Budget.Fits({500, 500, 5000, 5000}));
+    EXPECT_FALSE(Budget.Fits({500, 501, 0, 0}));
+    EXPECT_FALSE(Budget.Fits({0, 0, 5001, 0}));
+
+    // Memory used by other resources
+    MemoryUsage Used{0, 800, 3000, 2000};
+    Budget.QueryUsage = [&Used]() {
+        return Used;
+    };
+    EXPECT_TRUE(Budget.Fits({200, 0, 2000, 2000}));
+    EXPECT_FALSE(Budget.Fits({201, 0, 0, 0}));
+    EXPECT_FALSE(Budget.Fits({0, 0, 2001, 0}));
+
+    // Evict 100 bytes of CPU and GPU memory at a time
+    Uint32 NumEvictions = 0;
+    Budget.Evict       = [&](Uint64, Uint64) {
+        ++NumEvictions;
+        if (Used.CPUResident < 100 || Used.GPUReserved < 100)
+            return false;
+        Used.CPUResident -= 100;
+        Used.GPUReserved -= 100;
+        return true;
+    };
+    EXPECT_TRUE(Budget.Fits({450, 0, 2150, 0}));
+    EXPECT_EQ(NumEvictions, 3u);
+    EXPECT_EQ(Used.CPUResident, 500u);
+    EXPECT_EQ(Used.GPUReserved, 2700u);
+
+    // Required memory alone exceeds the budget
+    NumEvictions = 0;
+    EXPECT_FALSE(Budget.Fits({0, 2000, 0, 0}));
+    EXPECT_EQ(NumEvictions, 6u);
+    EXPECT_EQ(Used.CPUResident, 0u);
+
+    // Eviction that does not release memory must not loop forever
+    NumEvictions = 0;
+    Budget.Evict = [&](Uint64, Uint64) {
+        ++NumEvictions;
+        return true;
+    };
+    EXPECT_FALSE(Budget.Fits({0, 0, 10000, 0}));
+    EXPECT_EQ(NumEvictions, 1u);
+}
+
+TEST(Tools_AssetLoader, GLTFTextureMemorySize)
+{
+    {
+        TextureDesc Desc;
+        Desc.Type   = RESOURCE_DIM_TEX_2D;
+        Desc.Format = TEX_FORMAT_RGBA8_UNORM;
+        Desc.Width  = 256;
+        Desc.Height = 256;
+
+        Desc.MipLevels = 1;
+        EXPECT_EQ(GetTextureMemorySize(Desc), 256u * 256u * 4u);
+
+        // Full mip chain: 4 * (256^2 + 128^2 + ... + 1)
+        Desc.MipLevels = 0;
+        EXPECT_EQ(GetTextureMemorySize(Desc), 349524u);
+        Desc.MipLevels = 9;
+        EXPECT_EQ(GetTextureMemorySize(Desc), 349524u);
+    }
+
+    {
+        TextureDesc Desc;
+        Desc.Type      = RESOURCE_DIM_TEX_2D_ARRAY;
+        Desc.Format    = TEX_FORMAT_RGBA8_UNORM;
+        Desc.Width     = 64;
+        Desc.Height    = 64;
+        Desc.ArraySize = 6;
+        Desc.MipLevels = 3;
+        EXPECT_EQ(GetTextureMemorySize(Desc), (64u * 64u + 32u * 32u + 16u * 16u) * 4u * 6u);
+    }
+
+    {
+        // BC1: 8 bytes per 4x4 block, mips smaller than a block occupy a whole block
+        TextureDesc Desc;
+        Desc.Type      = RESOURCE_DIM_TEX_2D;
+        Desc.Format    = TEX_FORMAT_BC1_UNORM;
+        Desc.Width     = 16;
+        Desc.Height    = 16;
+        Desc.MipLevels = 0;
+        EXPECT_EQ(GetTextureMemorySize(Desc), 128u + 32u + 8u + 8u + 8u);
+    }
+}
+
+} // namespace
@@ -0,0 +1,404 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "GLTFMeshBVH.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "ThreadPool.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace Diligent::GLTF;
+
+namespace
+{
+
+// Random triangle soup split into three primitives:
+//  0 - 32-bit indices that include the base vertex,
+//  1 - 16-bit indices relative to the base vertex,
+//  2 - non-indexed triangles.
+struct RandomMesh
+{
+    std::vector<float3> Positions;
+    std::vector<Uint32> Indices32;
+    std::vector<Uint16> Indices16;
+
+    std::vector<MeshBVH::PrimitiveData> Primitives;
+
+    RandomMesh(Uint32 NumTriangles, std::mt19937& Gen)
+    {
+        std::uniform_real_distribution<float> Center{-10, 10};
+        std::uniform_real_distribution<float> Offset{-0.5f, 0.5f};
+
+        Positions.resize(size_t{NumTriangles} * 3);
+        for (Uint32 t = 0; t < NumTriangles; ++t)
+        {
+            const float3 C{Center(Gen), Center(Gen), Center(Gen)};
+            for (Uint32 v = 0; v < 3; ++v)
+                Positions[t * 3 + v] = C + float3{Offset(Gen), Offset(Gen), Offset(Gen)};
+        }
+
+        // Reverse the vertex order in the indexed primitives
+        const Uint32 NumTris0 = NumTriangles / 3;
+        const Uint32 NumTris1 = std::min(NumTriangles / 3, 0xFFFFu / 3);
+        const Uint32 NumTris2 = NumTriangles - NumTris0 - NumTris1;
+        for (Uint32 i = 0; i < NumTris0 * 3; ++i)
+            Indices32.push_back(NumTris0 * 3 - 1 - i);
+        for (Uint32 i = 0; i < NumTris1 * 3; ++i)
+            Indices16.push_back(static_cast<Uint16>(NumTris1 * 3 - 1 - i));
+
+        Primitives.resize(3);
+        for (auto& Prim : Primitives)
+        {
+            Prim.pPositions  = Positions.data();
+            Prim.NumVertices = static_cast<Uint32>(Positions.size());
+        }
+        Primitives[0].pIndices   = Indices32.data();
+        Primitives[0].IndexType  = VT_UINT32;
+        Primitives[0].IndexCount = NumTris0 * 3;
+
+        Primitives[1].pIndices   = Indices16.data();
+        Primitives[1].IndexType  = VT_UINT16;
+        Primitives[1].IndexCount = NumTris1 * 3;
+        Primitives[1].BaseVertex = NumTris0 * 3;
+
+        Primitives[2].IndexCount = NumTris2 * 3;
+        Primitives[2].BaseVertex = (NumTris0 + NumTris1) * 3;
+    }
+
+    void GetTriangle(Uint32 PrimId, Uint32 TriId, float3& V0, float3& V1, float3& V2) const
+    {
+        const auto& Prim = Primitives[PrimId];
+
+        Uint32 Idx[3];
+        for (Uint32 v = 0; v < 3; ++v)
+        {
+            const Uint32 i = TriId * 3 + v;
+            Idx[v]         = Prim.BaseVertex + (PrimId == 0 ? Indices32[i] : (PrimId == 1 ? Uint32{Indices16[i]} : i));
+        }
+        V0 = Positions[Idx[0]];
+        V1 = Positions[Idx[1]];
+        V2 = Positions[Idx[2]];
+    }
+
+    bool IntersectTriangle(const Ray& R, Uint32 PrimId, Uint32 TriId, float& T, float& U, float& V) const
+    {
+        float3 V0, V1, V2;
+        GetTriangle(PrimId, TriId, V0, V1, V2);
+
+        const float3 E1  = V1 - V0;
+        const float3 E2  = V2 - V0;
+        const float3 P   = cross(R.Direction, E2);
+        const float  Det = dot(E1, P);
+        if (Det == 0)
+            return false;
+
+        const float3 S = R.Origin - V0;
+        U              = dot(S, P) / Det;
+        const float3 Q = cross(S, E1);
+        V              = dot(R.Direction, Q) / Det;
+        T              = dot(E2, Q) / Det;
+        return U >= 0 && V >= 0 && U + V <= 1 && T >= R.TMin && T < R.TMax;
+    }
+
+    RayHit IntersectBruteForce(const Ray& R) const
+    {
+        RayHit Hit;
+        for (Uint32 PrimId = 0; PrimId < Primitives.size(); ++PrimId)
+        {
+            for (Uint32 TriId = 0; TriId < Primitives[PrimId].IndexCount / 3; ++TriId)
+            {
+                float T, U, V;
+                if (IntersectTriangle(R, PrimId, TriId, T, U, V) && T < Hit.T)
+                {
+                    Hit.T            = T;
+                    Hit.Barycentrics = float2{U, V};
+                    Hit.PrimitiveId  = PrimId;
+                    Hit.TriangleId   = TriId;
+                }
+            }
+        }
+        return Hit;
+    }
+};
+
+std::vector<Ray> GenerateRandomRays(size_t NumRays, std::mt19937& Gen)
+{
+    std::uniform_real_distribution<float> Coord{-15, 15};
+    std::uniform_real_distribution<float> Target{-5, 5};
+
+    std::vector<Ray> Rays(NumRays);
+    for (size_t i = 0; i < NumRays; ++i)
+    {
+        auto& R     = Rays[i];
+        R.Origin    = float3{Coord(Gen), Coord(Gen), Coord(Gen)};
+        R.Direction = float3{Target(Gen), Target(Gen), Target(Gen)} - R.Origin;
+        // Some rays are axis-aligned
+        if (i % 16 == 0)
+            R.Direction = float3{0, 0, R.Direction.z};
+    }
+    return Rays;
+}
+
+void CheckHit(const RandomMesh& Mesh, const Ray& R, const RayHit& Hit, const RayHit& RefHit, size_t RayIdx)
+{
+    ASSERT_EQ(Hit.IsValid(), RefHit.IsValid()) << "Ray " << RayIdx;
+    if (!RefHit.IsValid())
+        return;
+
+    EXPECT_NEAR(Hit.T, RefHit.T, 1e-4f * std::max(1.f, RefHit.T)) << "Ray " << RayIdx;
+
+    // Triangles may be hit at the same distance, so check that the reported triangle is actually hit
+    float T, U, V;
+    Ray   TestRay = R;
+    TestRay.TMax  = FLT_MAX;
+    ASSERT_TRUE(Mesh.IntersectTriangle(TestRay, Hit.PrimitiveId, Hit.TriangleId, T, U, V)) << "Ray " << RayIdx;
+    EXPECT_NEAR(T, Hit.T, 1e-4f * std::max(1.f, T)) << "Ray " << RayIdx;
+    EXPECT_NEAR(U, Hit.Barycentrics.x, 1e-3f) << "Ray " << RayIdx;
+    EXPECT_NEAR(V, Hit.Barycentrics.y, 1e-3f) << "Ray " << RayIdx;
+}
+
+TEST(Tools_AssetLoader, MeshBVHRandomRays)
+{
+    std::mt19937 Gen{0};
+
+    RandomMesh Mesh{3000, Gen};
+    MeshBVH    BVH{Mesh.Primitives.data(), static_cast<Uint32>(Mesh.Primitives.size())};
+    EXPECT_EQ(BVH.GetTriangleCount(), 3000u);
+    EXPECT_GT(BVH.GetNodeCount(), 1u);
+    EXPECT_LE(BVH.GetNodeCount(), 2u * BVH.GetTriangleCount());
+
+    float3 Min, Max;
+    BVH.GetBounds(Min, Max);
+    EXPECT_LT(Max.x - Min.x, 21.f);
+    EXPECT_GT(Max.x - Min.x, 19.f);
+
+    const auto Rays = GenerateRandomRays(2000, Gen);
+
+    size_t NumHits = 0;
+    for (size_t i = 0; i < Rays.size(); ++i)
+    {
+        const auto RefHit = Mesh.IntersectBruteForce(Rays[i]);
+
+        RayHit Hit;
+        EXPECT_EQ(BVH.IntersectRay(Rays[i], Hit), RefHit.IsValid()) << "Ray " << i;
+        CheckHit(Mesh, Rays[i], Hit, RefHit, i);
+        NumHits += RefHit.IsValid() ? 1 : 0;
+    }
+    // Make sure that the test is meaningful
+    EXPECT_GT(NumHits, Rays.size() / 4);
+    EXPECT_LT(NumHits, Rays.size());
+}
+
+TEST(Tools_AssetLoader, MeshBVHRayPackets)
+{
+    std::mt19937 Gen{1};
+
+    RandomMesh Mesh{2000, Gen};
+    MeshBVH    BVH{Mesh.Primitives.data(), static_cast<Uint32>(Mesh.Primitives.size())};
+
+    // The number of rays is not a multiple of the packet size
+    auto Rays = GenerateRandomRays(1003, Gen);
+    for (size_t i = 0; i < Rays.size(); i += 7)
+        Rays[i].TMax = 10;
+
+    std::vector<RayHit> Hits(Rays.size());
+    for (size_t i = 0; i < Hits.size(); i += 5)
+        Hits[i].T = 15;
+    std::vector<RayHit> RefHits = Hits;
+
+    BVH.IntersectRays(Rays.data(), Hits.data(), Rays.size());
+    for (size_t i = 0; i < Rays.size(); ++i)
+    {
+        BVH.IntersectRay(Rays[i], RefHits[i]);
+        ASSERT_EQ(Hits[i].IsValid(), RefHits[i].IsValid()) << "Ray " << i;
+        EXPECT_EQ(Hits[i].T, RefHits[i].T) << "Ray " << i;
+        if (Hits[i].IsValid())
+        {
+            EXPECT_LT(Hits[i].T, std::min(Rays[i].TMax, (i % 5) == 0 ? 15.f : FLT_MAX));
+
+            auto Ref = Rays[i];
+            Ref.TMax = std::min(Ref.TMax, (i % 5) == 0 ? 15.f : FLT_MAX);
+            CheckHit(Mesh, Rays[i], Hits[i], Mesh.IntersectBruteForce(Ref), i);
+        }
+    }
+}
+
+TEST(Tools_AssetLoader, MeshBVHParallelBuild)
+{
+    std::mt19937 Gen{2};
+
+    RandomMesh Mesh{50000, Gen};
+    MeshBVH    RefBVH{Mesh.Primitives.data(), static_cast<Uint32>(Mesh.Primitives.size())};
+
+    auto    pThreadPool = CreateThreadPool(ThreadPoolCreateInfo{4});
+    MeshBVH BVH{Mesh.Primitives.data(), static_cast<Uint32>(Mesh.Primitives.size()), pThreadPool};
+
+    // The parallel build only changes the order of the nodes
+    EXPECT_EQ(BVH.GetTriangleCount(), RefBVH.GetTriangleCount());
+    EXPECT_EQ(BVH.GetNodeCount(), RefBVH.GetNodeCount());
+    EXPECT_EQ(BVH.GetDepth(), RefBVH.GetDepth());
+
+    const auto Rays = GenerateRandomRays(500, Gen);
+    for (size_t i = 0; i < Rays.size(); ++i)
+    {
+        RayHit Hit, RefHit;
+        BVH.IntersectRay(Rays[i], Hit);
+        RefBVH.IntersectRay(Rays[i], RefHit);
+        ASSERT_EQ(Hit.IsValid(), RefHit.IsValid()) << "Ray " << i;
+        EXPECT_EQ(Hit.T, RefHit.T) << "Ray " << i;
+    }
+}
+
+TEST(Tools_AssetLoader, MeshBVHEdgeCases)
+{
+    // Empty hierarchy
+    {
+        MeshBVH BVH{nullptr, 0};
+        EXPECT_EQ(BVH.GetTriangleCount(), 0u);
+
+        Ray R;
+        R.Direction = float3{0, 0, 1};
+        RayHit Hit;
+        EXPECT_FALSE(BVH.IntersectRay(R, Hit));
+        EXPECT_FALSE(Hit.IsValid());
+        BVH.IntersectRays(&R, &Hit, 1);
+        EXPECT_FALSE(Hit.IsValid());
+    }
+
+    // Quad in the z = 1 plane. The second triangle references an out-of-range vertex and is skipped.
+    const float3 Positions[] = {{0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}};
+    const Uint32 Indices[]   = {0, 1, 2, 0, 2, 4};
+
+    MeshBVH::PrimitiveData Prim;
+    Prim.pPositions  = Positions;
+    Prim.NumVertices = _countof(Positions);
+    Prim.pIndices    = Indices;
+    Prim.IndexCount  = _countof(Indices);
+
+    MeshBVH BVH{&Prim, 1};
+    EXPECT_EQ(BVH.GetTriangleCount(), 1u);
+
+    Ray R;
+    R.Origin    = float3{0.75f, 0.25f, -1};
+    R.Direction = float3{0, 0, 2};
+
+    RayHit Hit;
+    ASSERT_TRUE(BVH.IntersectRay(R, Hit));
+    EXPECT_FLOAT_EQ(Hit.T, 1.f);
+    EXPECT_EQ(Hit.PrimitiveId, 0u);
+    EXPECT_EQ(Hit.TriangleId, 0u);
+    EXPECT_FLOAT_EQ(Hit.Barycentrics.x, 0.5f);
+    EXPECT_FLOAT_EQ(Hit.Barycentrics.y, 0.25f);
+
+    // Hits that are not closer than the current one are not reported
+    EXPECT_FALSE(BVH.IntersectRay(R, Hit));
+    RayHit CloseHit;
+    CloseHit.T = 0.5f;
+    EXPECT_FALSE(BVH.IntersectRay(R, CloseHit));
+
+    // The ray range is respected
+    R.TMax = 0.9f;
+    RayHit ShortHit;
+    EXPECT_FALSE(BVH.IntersectRay(R, ShortHit));
+
+    // Missing the skipped triangle
+    R.Origin = float3{0.25f, 0.75f, -1};
+    R.TMax   = FLT_MAX;
+    RayHit MissHit;
+    EXPECT_FALSE(BVH.IntersectRay(R, MissHit));
+}
+
+// Reports the build and query performance. Run with --gtest_also_run_disabled_tests.
+TEST(Tools_AssetLoader, DISABLED_MeshBVHBenchmark)
+{
+    using Clock = std::chrono::high_resolution_clock;
+    auto Seconds = [](Clock::time_point Start) {
+        return std::chrono::duration<double>{Clock::now() - Start}.count();
+    };
+
+    std::mt19937 Gen{3};
+
+    RandomMesh Mesh{500000, Gen};
+    const auto NumPrims = static_cast<Uint32>(Mesh.Primitives.size());
+
+    auto Start = Clock::now();
+    MeshBVH BVH{Mesh.Primitives.data(), NumPrims};
+    std::cout << "Single-threaded build: " << Seconds(Start) * 1000 << " ms, "
+              << BVH.GetNodeCount() << " nodes, depth " << BVH.GetDepth() << std::endl;
+
+    auto pThreadPool = CreateThreadPool(ThreadPoolCreateInfo{8});
+    Start            = Clock::now();
+    MeshBVH ParallelBVH{Mesh.Primitives.data(), NumPrims, pThreadPool};
+    std::cout << "Multi-threaded build:  " << Seconds(Start) * 1000 << " ms" << std::endl;
+
+    const auto Rays = GenerateRandomRays(1000000, Gen);
+
+    std::vector<RayHit> Hits(Rays.size());
+    Start = Clock::now();
+    for (size_t i = 0; i < Rays.size(); ++i)
+        BVH.IntersectRay(Rays[i], Hits[i]);
+    std::cout << "Single rays:  " << Rays.size() / Seconds(Start) * 1e-6 << " Mrays/s" << std::endl;
+
+    Hits.assign(Rays.size(), RayHit{});
+    Start = Clock::now();
+    BVH.IntersectRays(Rays.data(), Hits.data(), Rays.size());
+    std::cout << "Ray packets:  " << Rays.size() / Seconds(Start) * 1e-6 << " Mrays/s" << std::endl;
+
+    // Coherent rays, e.g. a picking region
+    std::vector<Ray> CoherentRays(Rays.size());
+    for (size_t i = 0; i < CoherentRays.size(); ++i)
+    {
+        CoherentRays[i].Origin    = float3{0, 0, -20};
+        CoherentRays[i].Direction = float3{static_cast<float>(i % 1000) * 1e-3f - 0.5f, static_cast<float>(i / 1000) * 1e-3f - 0.5f, 1};
+    }
+    Hits.assign(Rays.size(), RayHit{});
+    Start = Clock::now();
+    for (size_t i = 0; i < CoherentRays.size(); ++i)
+        BVH.IntersectRay(CoherentRays[i], Hits[i]);
+    std::cout << "Coherent single rays:  " << CoherentRays.size() / Seconds(Start) * 1e-6 << " Mrays/s" << std::endl;
+
+    Hits.assign(Rays.size(), RayHit{});
+    Start = Clock::now();
+    BVH.IntersectRays(CoherentRays.data(), Hits.data(), CoherentRays.size());
+    std::cout << "Coherent ray packets:  " << CoherentRays.size() / Seconds(Start) * 1e-6 << " Mrays/s" << std::endl;
+
+    const size_t NumBruteForceRays = 20;
+    size_t       NumBruteForceHits = 0;
+    Start                          = Clock::now();
+    for (size_t i = 0; i < NumBruteForceRays; ++i)
+        NumBruteForceHits += Mesh.IntersectBruteForce(Rays[i]).IsValid() ? 1 : 0;
+    std::cout << "Brute force:  " << NumBruteForceRays / Seconds(Start) * 1e-6 << " Mrays/s (" << NumBruteForceHits << " hits)" << std::endl;
+}
+
+} // namespace
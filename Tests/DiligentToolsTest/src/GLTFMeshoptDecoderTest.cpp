@@ -0,0 +1,347 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "GLTFMeshoptDecoder.hpp"
+
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+#include "DebugUtilities.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace Diligent::GLTF;
+
+namespace
+{
+
+// Minimal meshopt vertex codec encoder that produces streams compatible with the reference implementation
+class VertexEncoder
+{
+public:
+    static std::vector<Uint8> Encode(const std::vector<Uint8>& Vertices, size_t VertexSize)
+    {
+        VERIFY_EXPR(Vertices.size() % VertexSize == 0);
+        const size_t VertexCount = Vertices.size() / VertexSize;
+
+        std::vector<Uint8> Data;
+        Data.push_back(0xa0);
+
+        std::vector<Uint8> LastVertex{Vertices.begin(), Vertices.begin() + VertexSize};
+
+        const size_t BlockSize = std::min<size_t>((8192 / VertexSize) & ~size_t{15}, 256);
+        for (size_t Offset = 0; Offset < VertexCount; Offset += BlockSize)
+        {
+            const size_t NumVerts = std::min(BlockSize, VertexCount - Offset);
+            const size_t Aligned  = (NumVerts + 15) & ~size_t{15};
+            for (size_t k = 0; k < VertexSize; ++k)
+            {
+                std::vector<Uint8> Deltas(Aligned);
+
+                Uint8 Prev = LastVertex[k];
+                for (size_t i = 0; i < NumVerts; ++i)
+                {
+                    const Uint8 v = Vertices[(Offset + i) * VertexSize + k];
+                    const Uint8 d = static_cast<Uint8>(v - Prev);
+
+                    Deltas[i] = static_cast<Uint8>((d << 1) ^ ((d & 0x80) ? 0xFF : 0));
+                    Prev      = v;
+                }
+                EncodeBytes(Deltas, Data);
+            }
+            memcpy(LastVertex.data(), &Vertices[(Offset + NumVerts - 1) * VertexSize], VertexSize);
+        }
+
+        // Tail: padding followed by the first vertex
+        Data.resize(Data.size() + std::max<size_t>(32, VertexSize) - VertexSize);
+        Data.insert(Data.end(), Vertices.begin(), Vertices.begin() + VertexSize);
+        return Data;
+    }
+
+private:
+    static void EncodeBytes(const std::vector<Uint8>& Values, std::vector<Uint8>& Data)
+    {
+        const size_t NumGroups  = Values.size() / 16;
+        const size_t HeaderPos  = Data.size();
+        const size_t HeaderSize = (NumGroups + 3) / 4;
+        Data.resize(Data.size() + HeaderSize);
+
+        for (size_t g = 0; g < NumGroups; ++g)
+        {
+            const Uint8* pGroup = &Values[g * 16];
+
+            Uint32 BestBits = 3;
+            size_t BestSize = 16;
+            if (std::all_of(pGroup, pGroup + 16, [](Uint8 v) { return v == 0; }))
+            {
+                BestBits = 0;
+                BestSize = 0;
+            }
+            for (Uint32 BitsLog2 = 1; BitsLog2 <= 2; ++BitsLog2)
+            {
+                const Uint32 Sentinel = (1u << (1u << BitsLog2)) - 1u;
+
+                size_t Size = 16 >> (3 - BitsLog2);
+                for (size_t i = 0; i < 16; ++i)
+                    Size += pGroup[i] >= Sentinel ? 1 : 0;
+                if (Size < BestSize)
+                {
+                    BestSize = Size;
+                    BestBits = BitsLog2;
+                }
+            }
+
+            Data[HeaderPos + g / 4] |= static_cast<Uint8>(BestBits << ((g % 4) * 2));
+            if (BestBits == 3)
+            {
+                Data.insert(Data.end(), pGroup, pGroup + 16);
+            }
+            else if (BestBits != 0)
+            {
+                const Uint32 Bits     = 1u << BestBits;
+                const Uint32 Sentinel = (1u << Bits) - 1u;
+
+                std::vector<Uint8> Extra;
+                for (size_t i = 0; i < 16; i += 8 / Bits)
+                {
+                    Uint32 Byte = 0;
+                    for (size_t j = 0; j < 8 / Bits; ++j)
+                    {
+                        const Uint32 Enc = pGroup[i + j] >= Sentinel ? Sentinel : pGroup[i + j];
+                        if (Enc == Sentinel)
+                            Extra.push_back(pGroup[i + j]);
+                        Byte = (Byte << Bits) | Enc;
+                    }
+                    Data.push_back(static_cast<Uint8>(Byte));
+                }
+                Data.insert(Data.end(), Extra.begin(), Extra.end());
+            }
+        }
+    }
+};
+
+void WriteVByte(std::vector<Uint8>& Data, Uint32 v)
+{
+    do
+    {
+        Data.push_back(static_cast<Uint8>((v & 127) | (v > 127 ? 128 : 0)));
+        v >>= 7;
+    } while (v != 0);
+}
+
+Uint32 ZigZag(Int32 d)
+{
+    return (static_cast<Uint32>(d) << 1) ^ static_cast<Uint32>(d >> 31);
+}
+
+TEST(Tools_AssetLoader, MeshoptDecodeAttributes)
+{
+    for (size_t VertexSize : {4u, 12u, 16u, 40u})
+    {
+        constexpr size_t VertexCount = 300;
+
+        std::vector<Uint8> RefVertices(VertexCount * VertexSize);
+        for (size_t i = 0; i < RefVertices.size(); ++i)
+        {
+            // Mix slowly varying and noisy bytes to exercise all group encodings
+            const size_t v = i / VertexSize;
+            const size_t k = i % VertexSize;
+            switch (k % 4)
+            {
+                case 0: RefVertices[i] = static_cast<Uint8>(v); break;
+                case 1: RefVertices[i] = static_cast<Uint8>(v / 16); break;
+                case 2: RefVertices[i] = static_cast<Uint8>((v * 7919u) >> 3); break;
+                case 3: RefVertices[i] = 0x5A; break;
+            }
+        }
+
+        const auto Encoded = VertexEncoder::Encode(RefVertices, VertexSize);
+
+        MeshoptBufferViewDesc Desc;
+        Desc.Mode       = MESHOPT_COMPRESSION_MODE_ATTRIBUTES;
+        Desc.Count      = VertexCount;
+        Desc.ByteStride = VertexSize;
+
+        std::vector<Uint8> Decoded(GetMeshoptDecodedSize(Desc));
+        ASSERT_TRUE(DecodeMeshoptBufferView(Desc, Encoded.data(), Encoded.size(), Decoded.data())) << "Vertex size: " << VertexSize;
+        EXPECT_EQ(Decoded, RefVertices) << "Vertex size: " << VertexSize;
+
+        // Truncated streams must be rejected
+        EXPECT_FALSE(DecodeMeshoptBufferView(Desc, Encoded.data(), Encoded.size() - 1, Decoded.data()));
+        EXPECT_FALSE(DecodeMeshoptBufferView(Desc, Encoded.data(), Encoded.size() / 2, Decoded.data()));
+    }
+}
+
+TEST(Tools_AssetLoader, MeshoptDecodeIndexSequence)
+{
+    const std::vector<Uint32> RefIndices = {5, 6, 7, 1000, 2, 1001, 70000, 3, 0};
+
+    std::vector<Uint8> Encoded;
+    Encoded.push_back(0xd1);
+
+    Uint32 Last[2] = {};
+    for (size_t i = 0; i < RefIndices.size(); ++i)
+    {
+        // Alternate baselines to test both of them
+        const Uint32 Baseline = i % 2;
+        WriteVByte(Encoded, (ZigZag(static_cast<Int32>(RefIndices[i] - Last[Baseline])) << 1) | Baseline);
+        Last[Baseline] = RefIndices[i];
+    }
+    Encoded.resize(Encoded.size() + 4);
+
+    MeshoptBufferViewDesc Desc;
+    Desc.Mode       = MESHOPT_COMPRESSION_MODE_INDICES;
+    Desc.Count      = RefIndices.size();
+    Desc.ByteStride = 4;
+
+    std::vector<Uint32> Decoded(RefIndices.size());
+    ASSERT_TRUE(DecodeMeshoptBufferView(Desc, Encoded.data(), Encoded.size(), Decoded.data()));
+    EXPECT_EQ(Decoded, RefIndices);
+
+    EXPECT_FALSE(DecodeMeshoptBufferView(Desc, Encoded.data(), Encoded.size() - 1, Decoded.data()));
+}
+
+TEST(Tools_AssetLoader, MeshoptDecodeTriangles)
+{
+    // clang-format off
+    const std::vector<Uint8> Encoded =
+    {
+        0xe1,                   // Header, version 1
+        0xff, 0x0f, 0x1e,       // Triangle codes
+        0xff, 20, 2, 2,         // Triangle 0: three free indices 10, 11, 12
+        6,                      // Triangle 1: edge 0, free index 12 + 3
+                                // Triangle 2: edge 1, index Last + 1
+        0, 0, 0, 0, 0, 0, 0, 0, // Codeaux table
+        0, 0, 0, 0, 0, 0, 0, 0,
+    };
+    // clang-format on
+
+    const std::vector<Uint16> RefIndices = {
+        10, 11, 12,
+        10, 12, 15,
+        15, 12, 16 //
+    };
+
+    MeshoptBufferViewDesc Desc;
+    Desc.Mode       = MESHOPT_COMPRESSION_MODE_TRIANGLES;
+    Desc.Count      = RefIndices.size();
+    Desc.ByteStride = 2;
+
+    std::vector<Uint16> Decoded(RefIndices.size());
+    ASSERT_TRUE(DecodeMeshoptBufferView(Desc, Encoded.data(), Encoded.size(), Decoded.data()));
+    EXPECT_EQ(Decoded, RefIndices);
+
+    // Index count must be a multiple of 3
+    Desc.Count = 4;
+    EXPECT_FALSE(DecodeMeshoptBufferView(Desc, Encoded.data(), Encoded.size(), Decoded.data()));
+}
+
+TEST(Tools_AssetLoader, MeshoptFilters)
+{
+    {
+        // Exponential: 3 * 2^-1, -5 * 2^2
+        const Uint32 Encoded[] = {
+            (static_cast<Uint32>(-1) << 24) | 3u,
+            (2u << 24) | (static_cast<Uint32>(-5) & 0xFFFFFFu),
+        };
+        MeshoptBufferViewDesc Desc;
+        Desc.Mode       = MESHOPT_COMPRESSION_MODE_ATTRIBUTES;
+        Desc.Filter     = MESHOPT_COMPRESSION_FILTER_EXPONENTIAL;
+        Desc.Count      = 1;
+        Desc.ByteStride = 8;
+
+        std::vector<Uint8> Vertices(8);
+        memcpy(Vertices.data(), Encoded, sizeof(Encoded));
+        const auto Stream = VertexEncoder::Encode(Vertices, Desc.ByteStride);
+
+        float Decoded[2] = {};
+        ASSERT_TRUE(DecodeMeshoptBufferView(Desc, Stream.data(), Stream.size(), Decoded));
+        EXPECT_EQ(Decoded[0], 1.5f);
+        EXPECT_EQ(Decoded[1], -20.f);
+    }
+
+    {
+        // Octahedral: (1, 0, 1) / sqrt(2) and (0, 0, -1)
+        const Int16 Encoded[] = {
+            16384, 0, 32767, 7,
+            32767, 32767, 32767, 0, // Folded octant
+        };
+
+        MeshoptBufferViewDesc Desc;
+        Desc.Mode       = MESHOPT_COMPRESSION_MODE_ATTRIBUTES;
+        Desc.Filter     = MESHOPT_COMPRESSION_FILTER_OCTAHEDRAL;
+        Desc.Count      = 2;
+        Desc.ByteStride = 8;
+
+        std::vector<Uint8> Vertices(sizeof(Encoded));
+        memcpy(Vertices.data(), Encoded, sizeof(Encoded));
+        const auto Stream = VertexEncoder::Encode(Vertices, Desc.ByteStride);
+
+        Int16 Decoded[8] = {};
+        ASSERT_TRUE(DecodeMeshoptBufferView(Desc, Stream.data(), Stream.size(), Decoded));
+        EXPECT_NEAR(Decoded[0], 23170, 2);
+        EXPECT_EQ(Decoded[1], 0);
+        EXPECT_NEAR(Decoded[2], 23170, 2);
+        EXPECT_EQ(Decoded[3], 7);
+        EXPECT_EQ(Decoded[4], 0);
+        EXPECT_EQ(Decoded[5], 0);
+        EXPECT_EQ(Decoded[6], -32767);
+    }
+
+    {
+        // Quaternion: identity with w as the largest component and
+        //             (1, 0, 0, 0) with x as the largest component
+        const Int16 Encoded[] = {
+            0, 0, 0, 0x7FFF,
+            0, 0, 0, 0x7FFC,
+        };
+
+        MeshoptBufferViewDesc Desc;
+        Desc.Mode       = MESHOPT_COMPRESSION_MODE_ATTRIBUTES;
+        Desc.Filter     = MESHOPT_COMPRESSION_FILTER_QUATERNION;
+        Desc.Count      = 2;
+        Desc.ByteStride = 8;
+
+        std::vector<Uint8> Vertices(sizeof(Encoded));
+        memcpy(Vertices.data(), Encoded, sizeof(Encoded));
+        const auto Stream = VertexEncoder::Encode(Vertices, Desc.ByteStride);
+
+        Int16 Decoded[8] = {};
+        ASSERT_TRUE(DecodeMeshoptBufferView(Desc, Stream.data(), Stream.size(), Decoded));
+
+        const Int16 RefDecoded[] = {
+            0, 0, 0, 32767,
+            32767, 0, 0, 0,
+        };
+        for (size_t i = 0; i < _countof(RefDecoded); ++i)
+            EXPECT_EQ(Decoded[i], RefDecoded[i]) << i;
+    }
+}
+
+} // namespace
@@ -0,0 +1,459 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "GLTFLoader.hpp"
+#include "GLTFBuilder.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "GLTFTestModel.hpp"
+
+using namespace Diligent;
+using namespace Diligent::GLTF;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+// Source data of a primitive: a random triangle soup.
+struct SourcePrimitive
+{
+    std::vector<float3> Positions;
+    std::vector<Uint32> Indices; // Empty for non-indexed primitives
+    VALUE_TYPE          IndexType = VT_UNDEFINED;
+    int                 Material  = -1;
+
+    SourcePrimitive(Uint32 NumTriangles, VALUE_TYPE _IndexType, int _Material, std::mt19937& Gen) :
+        IndexType{_IndexType},
+        Material{_Material}
+    {
+        std::uniform_real_distribution<float> Center{-2, 2};
+        std::uniform_real_distribution<float> Offset{-0.5f, 0.5f};
+
+        Positions.resize(size_t{NumTriangles} * 3);
+        for (Uint32 t = 0; t < NumTriangles; ++t)
+        {
+            const float3 C{Center(Gen), Center(Gen), Center(Gen)};
+            for (Uint32 v = 0; v < 3; ++v)
+                Positions[t * 3 + v] = C + float3{Offset(Gen), Offset(Gen), Offset(Gen)};
+        }
+
+        // Reverse the vertex order in indexed primitives
+        if (IndexType != VT_UNDEFINED)
+        {
+            for (Uint32 i = 0; i < NumTriangles * 3; ++i)
+                Indices.push_back(NumTriangles * 3 - 1 - i);
+        }
+    }
+
+    Uint32 GetTriangleCount() const
+    {
+        return static_cast<Uint32>((IndexType != VT_UNDEFINED ? Indices.size() : Positions.size()) / 3);
+    }
+
+    void GetTriangle(Uint32 TriId, const float4x4& Matrix, float3 (&V)[3]) const
+    {
+        for (Uint32 v = 0; v < 3; ++v)
+        {
+            const Uint32 i   = TriId * 3 + v;
+            const float4 Pos = float4{Positions[IndexType != VT_UNDEFINED ? Indices[i] : i], 1} * Matrix;
+            V[v]             = float3{Pos.x, Pos.y, Pos.z};
+        }
+    }
+};
+
+struct SourceMesh
+{
+    std::string                  Name;
+    std::vector<SourcePrimitive> Primitives;
+};
+
+bool IntersectTriangle(const Ray& R, const float3 (&Tri)[3], float& T, float& U, float& V)
+{
+    const float3 E1  = Tri[1] - Tri[0];
+    const float3 E2  = Tri[2] - Tri[0];
+    const float3 P   = cross(R.Direction, E2);
+    const float  Det = dot(E1, P);
+    if (Det == 0)
+        return false;
+
+    const float3 S = R.Origin - Tri[0];
+    U              = dot(S, P) / Det;
+    const float3 Q = cross(S, E1);
+    V              = dot(R.Direction, Q) / Det;
+    T              = dot(E2, Q) / Det;
+    return U >= 0 && V >= 0 && U + V <= 1 && T >= R.TMin && T < R.TMax;
+}
+
+template <typename T>
+std::vector<double> ToDoubles(const T* pData, size_t Count)
+{
+    return std::vector<double>(pData, pData + Count);
+}
+
+int AddMesh(TestGltfModel& GltfModel, const SourceMesh& Mesh)
+{
+    TestGltfMesh GltfMesh;
+    GltfMesh.Name = Mesh.Name;
+    for (const auto& Prim : Mesh.Primitives)
+    {
+        TestGltfPrimitive GltfPrim;
+        GltfPrim.Attributes.emplace_back("POSITION", GltfModel.AddAccessor(Prim.Positions, VT_FLOAT32, 3));
+        switch (Prim.IndexType)
+        {
+            case VT_UINT8:
+                GltfPrim.Indices = GltfModel.AddAccessor(std::vector<Uint8>(Prim.Indices.begin(), Prim.Indices.end()), VT_UINT8, 1);
+                break;
+
+            case VT_UINT16:
+                GltfPrim.Indices = GltfModel.AddAccessor(std::vector<Uint16>(Prim.Indices.begin(), Prim.Indices.end()), VT_UINT16, 1);
+                break;
+
+            case VT_UINT32:
+                GltfPrim.Indices = GltfModel.AddAccessor(Prim.Indices, VT_UINT32, 1);
+                break;
+
+            default:
+                break;
+        }
+        GltfPrim.Material = Prim.Material;
+        GltfMesh.Primitives.push_back(GltfPrim);
+    }
+    GltfModel.Meshes.push_back(GltfMesh);
+    return static_cast<int>(GltfModel.Meshes.size() - 1);
+}
+
+// Transformed instance of a source mesh in the model scene
+struct MeshInstance
+{
+    const SourceMesh* pMesh      = nullptr;
+    int               NodeIndex  = -1;
+    int               InstanceId = -1;
+    float4x4          Matrix;
+};
+
+class ModelRayQueryTest
+{
+public:
+    explicit ModelRayQueryTest(bool AdaptiveIndexType)
+    {
+        std::mt19937 Gen{4};
+
+        m_Meshes.resize(2);
+        m_Meshes[0].Name = "Mixed";
+        m_Meshes[0].Primitives.emplace_back(60, VT_UINT16, 2, Gen);
+        m_Meshes[0].Primitives.emplace_back(50, VT_UINT32, 0, Gen);
+        m_Meshes[0].Primitives.emplace_back(40, VT_UNDEFINED, 1, Gen);
+        m_Meshes[1].Name = "Small";
+        m_Meshes[1].Primitives.emplace_back(80, VT_UINT8, 3, Gen);
+
+        TestGltfModel GltfModel;
+        for (const auto& Mesh : m_Meshes)
+            AddMesh(GltfModel, Mesh);
+
+        GltfModel.Nodes.resize(4);
+
+        // TRS node with non-uniform scale
+        const auto ParentRot = QuaternionF::RotationFromAxisAngle(float3{0, 1, 0}, 0.5f);
+
+        auto& Parent       = GltfModel.Nodes[0];
+        Parent.Name        = "Parent";
+        Parent.Mesh        = 0;
+        Parent.Translation = {6, 0, 0};
+        Parent.Rotation    = ToDoubles(&ParentRot.q.x, 4);
+        Parent.Scale       = {1.5, 1, 0.5};
+        Parent.Children    = {1};
+
+        // Child node with a matrix
+        const float4x4 ChildMatrix = float4x4::RotationZ(0.7f) * float4x4::Translation(0, 0, 5);
+
+        auto& Child  = GltfModel.Nodes[1];
+        Child.Name   = "Child";
+        Child.Mesh   = 1;
+        Child.Matrix = ToDoubles(&ChildMatrix._11, 16);
+
+        // Instanced node (EXT_mesh_gpu_instancing)
+        auto& Instanced       = GltfModel.Nodes[2];
+        Instanced.Name        = "Instanced";
+        Instanced.Mesh        = 0;
+        Instanced.Translation = {-6, 0, 0};
+
+        const std::vector<float3> InstanceTranslations = {{0, -5, 0}, {0, 0, 0}, {0, 5, 0}};
+        const std::vector<float4> InstanceRotations    = {
+            QuaternionF::RotationFromAxisAngle(float3{1, 0, 0}, 0.3f).q,
+            QuaternionF::RotationFromAxisAngle(float3{0, 0, 1}, 1.2f).q,
+            QuaternionF::RotationFromAxisAngle(normalize(float3{1, 2, 3}), -0.8f).q,
+        };
+        Instanced.InstanceAttributes.emplace_back("TRANSLATION", GltfModel.AddAccessor(InstanceTranslations, VT_FLOAT32, 3));
+        Instanced.InstanceAttributes.emplace_back("ROTATION", GltfModel.AddAccessor(InstanceRotations, VT_FLOAT32, 4));
+
+        // Node without a mesh
+        GltfModel.Nodes[3].Name = "Empty";
+
+        GltfModel.Scenes.resize(1);
+        GltfModel.Scenes[0].Nodes = {0, 2, 3};
+
+        ModelCreateInfo CI;
+        CI.AdaptiveIndexType = AdaptiveIndexType;
+        CI.CreateMeshBVHs    = true;
+
+        m_Model = std::make_unique<Model>(CI);
+        ModelBuilder Builder{CI, *m_Model};
+        Builder.Execute(GltfModel, -1, nullptr);
+
+        m_Model->ComputeTransforms(0, m_Transforms, float4x4::RotationX(0.3f) * float4x4::Translation(0, 1, 0));
+
+        for (const auto* pNode : m_Model->Scenes[0].LinearNodes)
+        {
+            if (pNode->pMesh == nullptr)
+                continue;
+
+            MeshInstance Inst;
+            Inst.NodeIndex = pNode->Index;
+            for (const auto& Mesh : m_Meshes)
+            {
+                if (Mesh.Name == pNode->pMesh->Name)
+                    Inst.pMesh = &Mesh;
+            }
+            VERIFY_EXPR(Inst.pMesh != nullptr);
+
+            if (pNode->IsInstanced())
+            {
+                for (size_t i = 0; i < pNode->InstanceMatrices.size(); ++i)
+                {
+                    Inst.InstanceId = static_cast<int>(i);
+                    Inst.Matrix     = m_Transforms.InstanceMatrices[pNode->FirstInstance + i];
+                    m_Instances.push_back(Inst);
+                }
+            }
+            else
+            {
+                Inst.Matrix = m_Transforms.NodeGlobalMatrices[pNode->Index];
+                m_Instances.push_back(Inst);
+            }
+        }
+    }
+
+    const Model&           GetModel() const { return *m_Model; }
+    const ModelTransforms& GetTransforms() const { return m_Transforms; }
+
+    const std::vector<MeshInstance>& GetInstances() const { return m_Instances; }
+
+    const MeshInstance* FindInstance(int NodeIndex, int InstanceId) const
+    {
+        for (const auto& Inst : m_Instances)
+        {
+            if (Inst.NodeIndex == NodeIndex && Inst.InstanceId == InstanceId)
+                return &Inst;
+        }
+        return nullptr;
+    }
+
+    // Tests every triangle of every mesh instance transformed into the world space.
+    RayHit IntersectBruteForce(const Ray& R) const
+    {
+        RayHit Hit;
+        for (const auto& Inst : m_Instances)
+        {
+            for (Uint32 PrimId = 0; PrimId < Inst.pMesh->Primitives.size(); ++PrimId)
+            {
+                const auto& Prim = Inst.pMesh->Primitives[PrimId];
+                for (Uint32 TriId = 0; TriId < Prim.GetTriangleCount(); ++TriId)
+                {
+                    float3 Tri[3];
+                    Prim.GetTriangle(TriId, Inst.Matrix, Tri);
+
+                    float T, U, V;
+                    if (IntersectTriangle(R, Tri, T, U, V) && T < Hit.T)
+                    {
+                        Hit.T            = T;
+                        Hit.Barycentrics = float2{U, V};
+                        Hit.PrimitiveId  = PrimId;
+                        Hit.TriangleId   = TriId;
+                        Hit.NodeIndex    = Inst.NodeIndex;
+                        Hit.InstanceId   = Inst.InstanceId;
+                        Hit.MaterialId   = static_cast<Uint32>(Prim.Material);
+                    }
+                }
+            }
+        }
+        return Hit;
+    }
+
+    void CheckHit(const Ray& R, const RayHit& Hit, const RayHit& RefHit, size_t RayIdx) const
+    {
+        ASSERT_EQ(Hit.IsValid(), RefHit.IsValid()) << "Ray " << RayIdx;
+        if (!RefHit.IsValid())
+            return;
+
+        EXPECT_NEAR(Hit.T, RefHit.T, 1e-3f * std::max(1.f, RefHit.T)) << "Ray " << RayIdx;
+
+        // Triangles may be hit at the same distance, so check that the reported triangle is actually hit
+        const auto* pInst = FindInstance(Hit.NodeIndex, Hit.InstanceId);
+        ASSERT_NE(pInst, nullptr) << "Ray " << RayIdx;
+        ASSERT_LT(Hit.PrimitiveId, pInst->pMesh->Primitives.size()) << "Ray " << RayIdx;
+        const auto& Prim = pInst->pMesh->Primitives[Hit.PrimitiveId];
+        ASSERT_LT(Hit.TriangleId, Prim.GetTriangleCount()) << "Ray " << RayIdx;
+        EXPECT_EQ(Hit.MaterialId, static_cast<Uint32>(Prim.Material)) << "Ray " << RayIdx;
+
+        float3 Tri[3];
+        Prim.GetTriangle(Hit.TriangleId, pInst->Matrix, Tri);
+
+        float T, U, V;
+        Ray   TestRay = R;
+        TestRay.TMax  = FLT_MAX;
+        ASSERT_TRUE(IntersectTriangle(TestRay, Tri, T, U, V)) << "Ray " << RayIdx;
+        EXPECT_NEAR(T, Hit.T, 1e-3f * std::max(1.f, T)) << "Ray " << RayIdx;
+        EXPECT_NEAR(U, Hit.Barycentrics.x, 1e-3f) << "Ray " << RayIdx;
+        EXPECT_NEAR(V, Hit.Barycentrics.y, 1e-3f) << "Ray " << RayIdx;
+    }
+
+    // Generates random rays aimed at the mesh instances in turn
+    std::vector<Ray> GenerateRays(size_t NumRays, std::mt19937& Gen) const
+    {
+        std::uniform_real_distribution<float> Coord{-20, 20};
+        std::uniform_real_distribution<float> Offset{-2, 2};
+
+        std::vector<Ray> Rays(NumRays);
+        for (size_t i = 0; i < NumRays; ++i)
+        {
+            const auto&  Matrix = m_Instances[i % m_Instances.size()].Matrix;
+            const float3 Target = float3{Matrix._41, Matrix._42, Matrix._43} + float3{Offset(Gen), Offset(Gen), Offset(Gen)};
+
+            auto& R     = Rays[i];
+            R.Origin    = float3{Coord(Gen), Coord(Gen), Coord(Gen)};
+            R.Direction = Target - R.Origin;
+        }
+        return Rays;
+    }
+
+private:
+    std::vector<SourceMesh>   m_Meshes;
+    std::unique_ptr<Model>    m_Model;
+    ModelTransforms           m_Transforms;
+    std::vector<MeshInstance> m_Instances;
+};
+
+void TestModelIntersectRay(bool AdaptiveIndexType)
+{
+    ModelRayQueryTest Test{AdaptiveIndexType};
+
+    const auto& TestModel = Test.GetModel();
+    for (const auto& Mesh : TestModel.Meshes)
+    {
+        ASSERT_TRUE(Mesh.pBVH);
+        EXPECT_EQ(Mesh.pBVH->GetTriangleCount(), Mesh.Name == "Mixed" ? 150u : 80u);
+        if (AdaptiveIndexType && Mesh.Name == "Mixed")
+        {
+            // Make sure that the test covers relative indices
+            EXPECT_EQ(Mesh.Primitives[1].IndexType, VT_UINT16);
+            EXPECT_EQ(Mesh.Primitives[1].BaseVertex, Mesh.Primitives[1].FirstVertex);
+            EXPECT_GT(Mesh.Primitives[1].BaseVertex, 0u);
+        }
+    }
+    // Parent, child and three instances
+    ASSERT_EQ(Test.GetInstances().size(), size_t{5});
+
+    std::mt19937 Gen{5};
+
+    const auto Rays = Test.GenerateRays(2000, Gen);
+
+    size_t              NumHits = 0;
+    std::vector<size_t> InstanceHits(Test.GetInstances().size());
+    for (size_t i = 0; i < Rays.size(); ++i)
+    {
+        const auto RefHit = Test.IntersectBruteForce(Rays[i]);
+
+        RayHit Hit;
+        EXPECT_EQ(TestModel.IntersectRay(0, Test.GetTransforms(), Rays[i], Hit), RefHit.IsValid()) << "Ray " << i;
+        Test.CheckHit(Rays[i], Hit, RefHit, i);
+        if (RefHit.IsValid())
+        {
+            ++NumHits;
+            const auto* pInst = Test.FindInstance(RefHit.NodeIndex, RefHit.InstanceId);
+            ++InstanceHits[pInst - Test.GetInstances().data()];
+        }
+    }
+    // Make sure that the test is meaningful
+    EXPECT_GT(NumHits, Rays.size() / 4);
+    EXPECT_LT(NumHits, Rays.size());
+    for (size_t i = 0; i < InstanceHits.size(); ++i)
+        EXPECT_GT(InstanceHits[i], size_t{0}) << "Instance " << i;
+}
+
+TEST(Tools_AssetLoader, GLTFModelIntersectRay)
+{
+    TestModelIntersectRay(false);
+}
+
+TEST(Tools_AssetLoader, GLTFModelIntersectRayAdaptiveIndexType)
+{
+    TestModelIntersectRay(true);
+}
+
+TEST(Tools_AssetLoader, GLTFModelIntersectRays)
+{
+    ModelRayQueryTest Test{true};
+
+    const auto& TestModel = Test.GetModel();
+
+    std::mt19937 Gen{6};
+
+    // The number of rays is not a multiple of the packet size
+    auto Rays = Test.GenerateRays(1003, Gen);
+    for (size_t i = 0; i < Rays.size(); i += 7)
+        Rays[i].TMax = 15;
+
+    std::vector<RayHit> Hits(Rays.size());
+    for (size_t i = 0; i < Hits.size(); i += 5)
+        Hits[i].T = 20;
+    std::vector<RayHit> RefHits = Hits;
+
+    TestModel.IntersectRays(0, Test.GetTransforms(), Rays.data(), Hits.data(), Rays.size());
+    for (size_t i = 0; i < Rays.size(); ++i)
+    {
+        TestModel.IntersectRay(0, Test.GetTransforms(), Rays[i], RefHits[i]);
+        ASSERT_EQ(Hits[i].IsValid(), RefHits[i].IsValid()) << "Ray " << i;
+        EXPECT_EQ(Hits[i].T, RefHits[i].T) << "Ray " << i;
+        EXPECT_EQ(Hits[i].NodeIndex, RefHits[i].NodeIndex) << "Ray " << i;
+        EXPECT_EQ(Hits[i].InstanceId, RefHits[i].InstanceId) << "Ray " << i;
+        EXPECT_EQ(Hits[i].PrimitiveId, RefHits[i].PrimitiveId) << "Ray " << i;
+        EXPECT_EQ(Hits[i].TriangleId, RefHits[i].TriangleId) << "Ray " << i;
+        EXPECT_EQ(Hits[i].MaterialId, RefHits[i].MaterialId) << "Ray " << i;
+
+        auto Ref = Rays[i];
+        Ref.TMax = std::min(Ref.TMax, (i % 5) == 0 ? 20.f : FLT_MAX);
+        Test.CheckHit(Rays[i], Hits[i], Test.IntersectBruteForce(Ref), i);
+    }
+}
+
+} // namespace
@@ -0,0 +1,219 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "GLTFLoader.hpp"
+#include "GLTFBuilder.hpp"
+
+#include <vector>
+#include <memory>
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace Diligent::GLTF;
+
+namespace
+{
+
+Material& AddMaterial(Model& TestModel, const float4& BaseColor, Material::ALPHA_MODE AlphaMode = Material::ALPHA_MODE_OPAQUE, int BaseColorTexture = -1)
+{
+    TestModel.Materials.emplace_back();
+    auto& Mat = TestModel.Materials.back();
+
+    Mat.Attribs.BaseColorFactor = BaseColor;
+    Mat.Attribs.AlphaMode       = AlphaMode;
+    if (BaseColorTexture >= 0)
+    {
+        MaterialBuilder Builder{Mat};
+        Builder.SetTextureId(DefaultBaseColorTextureAttribId, BaseColorTexture);
+        Builder.Finalize();
+    }
+    return Mat;
+}
+
+// Creates a scene with a single node whose mesh has one primitive per material.
+void InitScene(Model& TestModel)
+{
+    TestModel.Meshes.resize(1);
+    auto& Mesh = TestModel.Meshes[0];
+    for (Uint32 i = 0; i < TestModel.Materials.size(); ++i)
+        Mesh.Primitives.emplace_back(i * 3, 3, 3, i, float3{}, float3{1, 1, 1});
+
+    TestModel.Nodes.emplace_back(0);
+    TestModel.Nodes[0].pMesh = &Mesh;
+
+    TestModel.Scenes.resize(1);
+    TestModel.Scenes[0].RootNodes.push_back(&TestModel.Nodes[0]);
+    TestModel.Scenes[0].LinearNodes.push_back(&TestModel.Nodes[0]);
+}
+
+TEST(Tools_AssetLoader, GLTFDeduplicateMaterials)
+{
+    Model TestModel;
+
+    const float4 Red{1, 0, 0, 1};
+    const float4 Green{0, 1, 0, 1};
+
+    AddMaterial(TestModel, Red);                                       // 0 -> 0
+    AddMaterial(TestModel, Green);                                     // 1 -> 1
+    AddMaterial(TestModel, Red);                                       // 2 -> 0
+    AddMaterial(TestModel, Red).Attribs.AlphaCutoff = 0.25f;           // 3 -> 0: cutoff is irrelevant for opaque materials
+    AddMaterial(TestModel, Red, Material::ALPHA_MODE_MASK);            // 4 -> 2
+    AddMaterial(TestModel, Red, Material::ALPHA_MODE_MASK, 7);         // 5 -> 3
+    AddMaterial(TestModel, Red, Material::ALPHA_MODE_MASK, 7);         // 6 -> 3
+    AddMaterial(TestModel, Red, Material::ALPHA_MODE_MASK, 8);         // 7 -> 4
+    AddMaterial(TestModel, Green).DoubleSided = true;                  // 8 -> 5
+    AddMaterial(TestModel, Green).Sheen = std::make_unique<Material::SheenShaderAttribs>(); //  9 -> 6
+    AddMaterial(TestModel, Green).Sheen = std::make_unique<Material::SheenShaderAttribs>(); // 10 -> 6
+    InitScene(TestModel);
+
+    EXPECT_EQ(TestModel.DeduplicateMaterials(), 4u);
+    ASSERT_EQ(TestModel.Materials.size(), 7u);
+
+    const Uint32 RefMaterialIds[] = {0, 1, 0, 0, 2, 3, 3, 4, 5, 6, 6};
+    const auto&  Primitives       = TestModel.Meshes[0].Primitives;
+    ASSERT_EQ(Primitives.size(), _countof(RefMaterialIds));
+    for (size_t i = 0; i < Primitives.size(); ++i)
+        EXPECT_EQ(Primitives[i].MaterialId, RefMaterialIds[i]) << "Primitive " << i;
+
+    EXPECT_EQ(TestModel.Materials[0].Attribs.BaseColorFactor, Red);
+    EXPECT_EQ(TestModel.Materials[1].Attribs.BaseColorFactor, Green);
+    EXPECT_EQ(TestModel.Materials[3].GetTextureId(DefaultBaseColorTextureAttribId), 7);
+    EXPECT_EQ(TestModel.Materials[4].GetTextureId(DefaultBaseColorTextureAttribId), 8);
+    EXPECT_TRUE(TestModel.Materials[5].DoubleSided);
+    EXPECT_TRUE(TestModel.Materials[6].Sheen);
+
+    // All materials are now unique
+    EXPECT_EQ(TestModel.DeduplicateMaterials(), 0u);
+    EXPECT_EQ(TestModel.Materials.size(), 7u);
+}
+
+TEST(Tools_AssetLoader, GLTFDrawOrder)
+{
+    Model TestModel;
+
+    const float4 Color{1, 1, 1, 1};
+
+    AddMaterial(TestModel, Color, Material::ALPHA_MODE_BLEND);     // 0
+    AddMaterial(TestModel, Color, Material::ALPHA_MODE_OPAQUE, 1); // 1
+    AddMaterial(TestModel, Color, Material::ALPHA_MODE_MASK);      // 2
+    AddMaterial(TestModel, Color, Material::ALPHA_MODE_OPAQUE, 0); // 3
+    AddMaterial(TestModel, Color, Material::ALPHA_MODE_OPAQUE, 1); // 4
+    AddMaterial(TestModel, Color).DoubleSided = true;              // 5
+    AddMaterial(TestModel, Color, Material::ALPHA_MODE_BLEND);     // 6
+    InitScene(TestModel);
+
+    TestModel.UpdateDrawOrder();
+
+    const auto& DrawOrder = TestModel.Scenes[0].DrawOrder;
+    ASSERT_EQ(DrawOrder.size(), TestModel.Materials.size());
+
+    const auto& Primitives = TestModel.Meshes[0].Primitives;
+    for (size_t i = 0; i < DrawOrder.size(); ++i)
+    {
+        EXPECT_EQ(DrawOrder[i].pNode, &TestModel.Nodes[0]);
+        if (i > 0)
+        {
+            EXPECT_LE(Primitives[DrawOrder[i - 1].PrimitiveId].SortKey, Primitives[DrawOrder[i].PrimitiveId].SortKey);
+        }
+    }
+
+    // Opaque single-sided primitives go first, grouped by the texture set (materials 1 and 4 use the same texture),
+    // then opaque double-sided, then masked, then blended. Blended primitives keep their relative order.
+    const Uint32 RefOrder[] = {1, 4, 3, 5, 2, 0, 6};
+    ASSERT_EQ(DrawOrder.size(), _countof(RefOrder));
+    for (size_t i = 0; i < DrawOrder.size(); ++i)
+        EXPECT_EQ(Primitives[DrawOrder[i].PrimitiveId].MaterialId, RefOrder[i]) << "Draw item " << i;
+}
+
+TEST(Tools_AssetLoader, GLTFBlendedDrawOrder)
+{
+    Model TestModel;
+
+    const float4 Color{1, 1, 1, 0.5f};
+
+    AddMaterial(TestModel, Color, Material::ALPHA_MODE_BLEND, 1);                 // 0
+    AddMaterial(TestModel, Color, Material::ALPHA_MODE_BLEND).DoubleSided = true; // 1
+    AddMaterial(TestModel, Color, Material::ALPHA_MODE_BLEND, 0);                 // 2
+    AddMaterial(TestModel, Color, Material::ALPHA_MODE_OPAQUE);                   // 3
+    InitScene(TestModel);
+
+    // Author the blended primitives in the reverse order of their materials
+    auto& Primitives = TestModel.Meshes[0].Primitives;
+    Primitives[0].MaterialId = 2;
+    Primitives[2].MaterialId = 0;
+
+    TestModel.UpdateDrawOrder();
+
+    const auto& DrawOrder = TestModel.Scenes[0].DrawOrder;
+
+    // The opaque primitive goes first, blended primitives keep the authored order
+    const Uint32 RefOrder[] = {3, 0, 1, 2};
+    ASSERT_EQ(DrawOrder.size(), _countof(RefOrder));
+    for (size_t i = 0; i < DrawOrder.size(); ++i)
+        EXPECT_EQ(DrawOrder[i].PrimitiveId, RefOrder[i]) << "Draw item " << i;
+}
+
+TEST(Tools_AssetLoader, GLTFModelMemoryUsage)
+{
+    Model TestModel;
+
+    TestModel.Animations.resize(1);
+    auto& Anim = TestModel.Animations[0];
+    Anim.Samplers.resize(1);
+    Anim.Samplers[0].Inputs.resize(10);
+    Anim.Samplers[0].OutputsVec4.resize(10);
+
+    TestModel.Skins.resize(1);
+    TestModel.Skins[0].InverseBindMatrices.resize(4);
+
+    AddMaterial(TestModel, float4{1, 1, 1, 1}).Sheen = std::make_unique<Material::SheenShaderAttribs>();
+
+    const auto Usage = TestModel.GetMemoryUsage();
+
+    // No GPU resources
+    EXPECT_EQ(Usage.Vertices.GPUReserved, 0u);
+    EXPECT_EQ(Usage.Indices.GPUReserved, 0u);
+    EXPECT_EQ(Usage.MorphTargets.GPUReserved, 0u);
+    EXPECT_EQ(Usage.Textures.GPUReserved, 0u);
+    EXPECT_EQ(Usage.GetTotal().CPUTransient, 0u);
+    EXPECT_EQ(Usage.PeakSourceDataSize, 0u);
+
+    const auto ExpectedSceneSize =
+        TestModel.Animations.capacity() * sizeof(Animation) +
+        Anim.Samplers.capacity() * sizeof(AnimationSampler) +
+        Anim.Samplers[0].Inputs.capacity() * sizeof(float) +
+        Anim.Samplers[0].OutputsVec4.capacity() * sizeof(float4) +
+        TestModel.Skins.capacity() * sizeof(Skin) +
+        TestModel.Skins[0].InverseBindMatrices.capacity() * sizeof(float4x4) +
+        TestModel.Materials.capacity() * sizeof(Material) +
+        sizeof(Material::SheenShaderAttribs);
+    EXPECT_EQ(Usage.Scene.CPUResident, ExpectedSceneSize);
+    EXPECT_EQ(Usage.GetTotal().CPUResident, Usage.Scene.CPUResident);
+}
+
+} // namespace
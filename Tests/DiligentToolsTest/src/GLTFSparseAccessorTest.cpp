@@ -0,0 +1,187 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "GLTFLoader.hpp"
+#include "GLTFBuilder.hpp"
+
+#include <vector>
+#include <cstring>
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+#include "TestingEnvironment.hpp"
+#include "GLTFTestModel.hpp"
+
+using namespace Diligent;
+using namespace Diligent::GLTF;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+// Adds the sparse indices and values to the accessor.
+// The indices are placed at an odd offset, so that both the indices and the values
+// that follow them are read from unaligned addresses.
+template <typename IndexType>
+void AddSparseData(TestGltfModel& Model, TestGltfAccessor& Accessor, const std::vector<IndexType>& Indices, const std::vector<float>& Values)
+{
+    std::vector<Uint8> IndexData(1 + Indices.size() * sizeof(IndexType));
+    memcpy(&IndexData[1], Indices.data(), Indices.size() * sizeof(IndexType));
+
+    Accessor.Sparse                     = true;
+    Accessor.SparseCount                = static_cast<int>(Indices.size());
+    Accessor.SparseIndicesBufferView    = Model.AddBufferView(IndexData);
+    Accessor.SparseIndicesByteOffset    = 1;
+    Accessor.SparseIndicesComponentType = sizeof(IndexType) == 1 ? VT_UINT8 : (sizeof(IndexType) == 2 ? VT_UINT16 : VT_UINT32);
+    Accessor.SparseValuesBufferView     = Model.AddBufferView(Values);
+}
+
+std::vector<float> ReadFloats(const TestGltfModel& Model, int AccessorId = 0)
+{
+    const auto         Data = ModelBuilder::ReadDenseAccessorData(Model, AccessorId);
+    std::vector<float> Values(Data.size() / sizeof(float));
+    memcpy(Values.data(), Data.data(), Values.size() * sizeof(float));
+    return Values;
+}
+
+template <typename IndexType>
+void TestSparseAccessor(bool HasBaseView)
+{
+    TestGltfModel Model;
+
+    TestGltfAccessor Accessor;
+    Accessor.Count = 4;
+
+    std::vector<float> Expected(Accessor.Count * 3, 0.f);
+    if (HasBaseView)
+    {
+        // Interleave the positions with one extra float to use non-default stride
+        std::vector<float> BaseData;
+        for (Uint32 i = 0; i < Accessor.Count; ++i)
+        {
+            for (Uint32 c = 0; c < 3; ++c)
+            {
+                BaseData.push_back(static_cast<float>(i * 10 + c));
+                Expected[i * 3 + c] = BaseData.back();
+            }
+            BaseData.push_back(-1.f);
+        }
+        Accessor.BufferView = Model.AddBufferView(BaseData, 4 * sizeof(float));
+    }
+
+    const std::vector<IndexType> SparseIndices = {3, 1};
+    const std::vector<float>     SparseValues  = {100, 101, 102, 200, 201, 202};
+    AddSparseData(Model, Accessor, SparseIndices, SparseValues);
+    Model.Accessors.push_back(Accessor);
+
+    for (size_t i = 0; i < SparseIndices.size(); ++i)
+    {
+        for (Uint32 c = 0; c < 3; ++c)
+            Expected[SparseIndices[i] * 3 + c] = SparseValues[i * 3 + c];
+    }
+
+    EXPECT_EQ(ReadFloats(Model), Expected);
+}
+
+TEST(Tools_AssetLoader, GLTFSparseAccessor)
+{
+    for (bool HasBaseView : {true, false})
+    {
+        TestSparseAccessor<Uint8>(HasBaseView);
+        TestSparseAccessor<Uint16>(HasBaseView);
+        TestSparseAccessor<Uint32>(HasBaseView);
+    }
+}
+
+TEST(Tools_AssetLoader, GLTFSparseAccessorValidation)
+{
+    auto CreateModel = []() {
+        TestGltfModel Model;
+        TestGltfAccessor Accessor;
+        Accessor.Count      = 4;
+        Accessor.BufferView = Model.AddBufferView(std::vector<float>(Accessor.Count * 3, 1.f));
+        AddSparseData(Model, Accessor, std::vector<Uint16>{0, 2}, std::vector<float>(6, 2.f));
+        Model.Accessors.push_back(Accessor);
+        return Model;
+    };
+    EXPECT_EQ(ReadFloats(CreateModel()).size(), size_t{12});
+
+    auto ExpectError = [](const TestGltfModel& Model, const char* Error) {
+        TestingEnvironment::ErrorScope ExpectedErrors{Error};
+        EXPECT_THROW(ModelBuilder::ReadDenseAccessorData(Model, 0), std::runtime_error);
+    };
+
+    {
+        auto Model = CreateModel();
+        Model.Accessors[0].Count = 5;
+        ExpectError(Model, "element range [0, 60) exceeds the length of buffer view 0");
+    }
+    {
+        auto Model = CreateModel();
+        Model.Accessors[0].SparseCount = 5;
+        ExpectError(Model, "exceeds the accessor element count");
+    }
+    {
+        auto Model = CreateModel();
+        Model.Accessors[0].SparseCount = -1;
+        ExpectError(Model, "exceeds the accessor element count");
+    }
+    {
+        auto Model = CreateModel();
+        Model.Accessors[0].SparseIndicesByteOffset = 2;
+        ExpectError(Model, "sparse indices range [2, 6) exceeds the length of buffer view 1");
+    }
+    {
+        auto Model = CreateModel();
+        Model.Accessors[0].SparseValuesByteOffset = 4;
+        ExpectError(Model, "sparse values range [4, 28) exceeds the length of buffer view 2");
+    }
+    {
+        auto Model = CreateModel();
+        Model.Accessors[0].SparseValuesBufferView = 3;
+        ExpectError(Model, "references invalid sparse values buffer view 3");
+    }
+    {
+        auto Model = CreateModel();
+        Model.BufferViews[2].ByteLength += 4;
+        ExpectError(Model, "exceeds the size of buffer 0");
+    }
+    {
+        auto Model = CreateModel();
+        Model.Accessors[0].SparseIndicesComponentType = VT_FLOAT32;
+        ExpectError(Model, "Sparse index component type");
+    }
+    {
+        auto Model = CreateModel();
+        // Overwrite the second sparse index that is stored at offset 1 + 2
+        const Uint16 InvalidIndex = 4;
+        memcpy(&Model.Buffers[0][Model.BufferViews[1].ByteOffset + 3], &InvalidIndex, sizeof(InvalidIndex));
+        ExpectError(Model, "Sparse index 4 of accessor 0 is out of range [0, 4)");
+    }
+}
+
+} // namespace
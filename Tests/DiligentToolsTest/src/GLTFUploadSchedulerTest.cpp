@@ -0,0 +1,215 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "GLTFUploadScheduler.hpp"
+
+#include <chrono>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace Diligent::GLTF;
+
+namespace
+{
+
+// Records the order in which work items are executed
+class UploadRecorder
+{
+public:
+    std::vector<UploadScheduler::WorkItem> CreateItems(Uint32 Group, const std::vector<Uint64>& Sizes)
+    {
+        std::vector<UploadScheduler::WorkItem> Items;
+        for (size_t i = 0; i < Sizes.size(); ++i)
+        {
+            UploadScheduler::WorkItem Item;
+            Item.Size = Sizes[i];
+            Item.Func = [this, Group, i](IRenderDevice* pDevice, IDeviceContext* pCtx) {
+                Log.emplace_back(Group, static_cast<Uint32>(i));
+            };
+            Items.emplace_back(std::move(Item));
+        }
+        return Items;
+    }
+
+    std::vector<std::pair<Uint32, Uint32>> Log;
+};
+
+TEST(Tools_AssetLoader, GLTFUploadSchedulerPriority)
+{
+    UploadRecorder  Recorder;
+    UploadScheduler Scheduler;
+
+    const auto Group0 = Scheduler.AddGroup(Recorder.CreateItems(0, {10, 20}), 1.f);
+    const auto Group1 = Scheduler.AddGroup(Recorder.CreateItems(1, {30, 40, 50}), 5.f);
+    const auto Group2 = Scheduler.AddGroup(Recorder.CreateItems(2, {60}), 5.f);
+    EXPECT_NE(Group0, UploadScheduler::InvalidGroupId);
+    EXPECT_NE(Group1, Group0);
+    EXPECT_NE(Group2, Group1);
+    EXPECT_EQ(Scheduler.AddGroup({}, 10.f), UploadScheduler::InvalidGroupId);
+
+    EXPECT_EQ(Scheduler.GetPendingBytes(Group1), 120u);
+    EXPECT_TRUE(Scheduler.IsGroupPending(Group2));
+
+    const auto Progress = Scheduler.Execute(nullptr, nullptr, UploadBudget{});
+    EXPECT_EQ(Progress.ExecutedItems, 6u);
+    EXPECT_EQ(Progress.ExecutedBytes, 210u);
+    EXPECT_EQ(Progress.CompletedGroups, 3u);
+    EXPECT_EQ(Progress.PendingItems, 0u);
+    EXPECT_EQ(Progress.PendingBytes, 0u);
+    EXPECT_TRUE(Progress.IsComplete());
+    EXPECT_FALSE(Scheduler.IsGroupPending(Group2));
+
+    // Groups with equal priority are executed in the order they were added
+    const std::vector<std::pair<Uint32, Uint32>> RefLog = {{1, 0}, {1, 1}, {1, 2}, {2, 0}, {0, 0}, {0, 1}};
+    EXPECT_EQ(Recorder.Log, RefLog);
+}
+
+TEST(Tools_AssetLoader, GLTFUploadSchedulerByteBudget)
+{
+    UploadRecorder  Recorder;
+    UploadScheduler Scheduler;
+
+    const auto Group0 = Scheduler.AddGroup(Recorder.CreateItems(0, {100, 100, 0, 100, 500, 0}), 0.f);
+
+    UploadBudget Budget;
+    Budget.MaxBytes = 250;
+
+    auto Progress = Scheduler.Execute(nullptr, nullptr, Budget);
+    EXPECT_EQ(Progress.ExecutedItems, 3u);
+    EXPECT_EQ(Progress.ExecutedBytes, 200u);
+    EXPECT_EQ(Progress.CompletedGroups, 0u);
+    EXPECT_EQ(Progress.PendingItems, 3u);
+    EXPECT_EQ(Progress.PendingBytes, 600u);
+    EXPECT_EQ(Scheduler.GetPendingBytes(Group0), 600u);
+
+    Progress = Scheduler.Execute(nullptr, nullptr, Budget);
+    EXPECT_EQ(Progress.ExecutedItems, 1u);
+    EXPECT_EQ(Progress.ExecutedBytes, 100u);
+
+    // An item that exceeds the budget is executed alone, and the following zero-size item fits
+    Progress = Scheduler.Execute(nullptr, nullptr, Budget);
+    EXPECT_EQ(Progress.ExecutedItems, 2u);
+    EXPECT_EQ(Progress.ExecutedBytes, 500u);
+    EXPECT_EQ(Progress.CompletedGroups, 1u);
+    EXPECT_TRUE(Progress.IsComplete());
+    EXPECT_EQ(Recorder.Log.size(), 6u);
+
+    Progress = Scheduler.Execute(nullptr, nullptr, Budget);
+    EXPECT_EQ(Progress.ExecutedItems, 0u);
+    EXPECT_TRUE(Progress.IsComplete());
+}
+
+TEST(Tools_AssetLoader, GLTFUploadSchedulerTimeBudget)
+{
+    UploadScheduler Scheduler;
+
+    int NumExecuted = 0;
+
+    std::vector<UploadScheduler::WorkItem> Items(4);
+    for (auto& Item : Items)
+    {
+        Item.Func = [&NumExecuted](IRenderDevice* pDevice, IDeviceContext* pCtx) {
+            const auto Start = std::chrono::high_resolution_clock::now();
+            while (std::chrono::high_resolution_clock::now() - Start < std::chrono::milliseconds{2})
+            {
+            }
+            ++NumExecuted;
+        };
+    }
+    Scheduler.AddGroup(std::move(Items), 0.f);
+
+    UploadBudget Budget;
+    Budget.MaxTime = 0.001;
+    for (int i = 1; i <= 4; ++i)
+    {
+        const auto Progress = Scheduler.Execute(nullptr, nullptr, Budget);
+        EXPECT_EQ(Progress.ExecutedItems, 1u);
+        EXPECT_EQ(NumExecuted, i);
+    }
+    EXPECT_TRUE(Scheduler.GetProgress().IsComplete());
+}
+
+TEST(Tools_AssetLoader, GLTFUploadSchedulerUpdateGroups)
+{
+    UploadRecorder  Recorder;
+    UploadScheduler Scheduler;
+
+    const auto Group0 = Scheduler.AddGroup(Recorder.CreateItems(0, {10, 10}), 2.f);
+    const auto Group1 = Scheduler.AddGroup(Recorder.CreateItems(1, {10, 10}), 1.f);
+    const auto Group2 = Scheduler.AddGroup(Recorder.CreateItems(2, {10, 10}), 0.f);
+
+    UploadBudget Budget;
+    Budget.MaxBytes = 10;
+    Scheduler.Execute(nullptr, nullptr, Budget);
+
+    // The remaining item of the partially executed group is executed after the group with higher priority
+    Scheduler.SetPriority(Group2, 3.f);
+    Scheduler.RemoveGroup(Group1);
+    EXPECT_FALSE(Scheduler.IsGroupPending(Group1));
+    EXPECT_EQ(Scheduler.GetPendingBytes(Group1), 0u);
+
+    const auto Progress = Scheduler.Execute(nullptr, nullptr, UploadBudget{});
+    EXPECT_EQ(Progress.ExecutedItems, 3u);
+    EXPECT_EQ(Progress.CompletedGroups, 2u);
+    EXPECT_FALSE(Scheduler.IsGroupPending(Group0));
+
+    const std::vector<std::pair<Uint32, Uint32>> RefLog = {{0, 0}, {2, 0}, {2, 1}, {0, 1}};
+    EXPECT_EQ(Recorder.Log, RefLog);
+}
+
+TEST(Tools_AssetLoader, GLTFUploadSchedulerReleaseData)
+{
+    UploadScheduler Scheduler;
+
+    // Work items release the captured data as soon as they are executed
+    auto pData = std::make_shared<std::vector<Uint8>>(256);
+
+    std::vector<UploadScheduler::WorkItem> Items;
+    for (Uint32 i = 0; i < 2; ++i)
+    {
+        UploadScheduler::WorkItem Item;
+        Item.Size = 128;
+        Item.Func = [pData](IRenderDevice* pDevice, IDeviceContext* pCtx) {};
+        Items.emplace_back(std::move(Item));
+    }
+    Scheduler.AddGroup(std::move(Items), 0.f);
+    EXPECT_EQ(pData.use_count(), 3);
+
+    UploadBudget Budget;
+    Budget.MaxBytes = 128;
+    Scheduler.Execute(nullptr, nullptr, Budget);
+    EXPECT_EQ(pData.use_count(), 2);
+
+    Scheduler.Execute(nullptr, nullptr, Budget);
+    EXPECT_EQ(pData.use_count(), 1);
+}
+
+} // namespace
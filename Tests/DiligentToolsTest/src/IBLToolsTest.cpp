@@ -0,0 +1,356 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "../interface/IBLTools.h"
+#include "../interface/Image.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "DataBlobImpl.hpp"
+#include "BasicMath.hpp"
+
+using namespace Diligent;
+
+namespace
+{
+
+float3 GetTexelDirection(Uint32 Face, Uint32 x, Uint32 y, Uint32 Size)
+{
+    const float u = (static_cast<float>(x) + 0.5f) / static_cast<float>(Size) * 2.f - 1.f;
+    const float v = (static_cast<float>(y) + 0.5f) / static_cast<float>(Size) * 2.f - 1.f;
+
+    const float3 Dirs[] = {
+        float3{+1, -v, -u},
+        float3{-1, -v, +u},
+        float3{+u, +1, +v},
+        float3{+u, -1, -v},
+        float3{+u, -v, +1},
+        float3{-u, -v, -1},
+    };
+    return normalize(Dirs[Face]);
+}
+
+const float4& GetTexel(ITextureLoader* pLoader, Uint32 Mip, Uint32 Face, Uint32 x, Uint32 y)
+{
+    const auto& SubRes = pLoader->GetSubresourceData(Mip, Face);
+    return reinterpret_cast<const float4*>(static_cast<const Uint8*>(SubRes.pData) + SubRes.Stride * y)[x];
+}
+
+// Creates a 32-bit float RGB equirectangular image, where the color of every pixel is computed by Func(Direction).
+template <typename FuncType>
+RefCntAutoPtr<Image> CreateEquirectImage(Uint32 Width, Uint32 Height, FuncType&& Func)
+{
+    ImageDesc Desc;
+    Desc.Width         = Width;
+    Desc.Height        = Height;
+    Desc.ComponentType = VT_FLOAT32;
+    Desc.NumComponents = 3;
+    Desc.RowStride     = Width * 3 * sizeof(float);
+
+    auto   pPixels = DataBlobImpl::Create(size_t{Desc.RowStride} * Height);
+    float* pData   = static_cast<float*>(pPixels->GetDataPtr());
+    for (Uint32 y = 0; y < Height; ++y)
+    {
+        const auto Theta = (static_cast<float>(y) + 0.5f) / static_cast<float>(Height) * PI_F;
+        for (Uint32 x = 0; x < Width; ++x)
+        {
+            const auto Phi   = ((static_cast<float>(x) + 0.5f) / static_cast<float>(Width) - 0.5f) * 2.f * PI_F;
+            const auto Color = Func(float3{std::sin(Theta) * std::cos(Phi), std::cos(Theta), std::sin(Theta) * std::sin(Phi)});
+            for (Uint32 c = 0; c < 3; ++c)
+                pData[(size_t{y} * Width + x) * 3 + c] = Color[c];
+        }
+    }
+
+    RefCntAutoPtr<Image> pImage;
+    Image::CreateFromMemory(Desc, pPixels, &pImage);
+    return pImage;
+}
+
+// Environment whose radiance linearly depends on the direction: L(w) = A + B * dot(w, D)
+struct LinearEnvironment
+{
+    const float3 A = float3{1.0f, 0.5f, 2.0f};
+    const float3 B = float3{0.5f, 0.25f, 1.0f};
+    const float3 D = normalize(float3{1, 2, 3});
+
+    float3 operator()(const float3& Dir) const
+    {
+        return A + B * dot(Dir, D);
+    }
+};
+
+RefCntAutoPtr<ITextureLoader> CreateLinearEnvironmentCubemap(Uint32 FaceSize)
+{
+    auto pImage = CreateEquirectImage(FaceSize * 8, FaceSize * 4, LinearEnvironment{});
+
+    EquirectToCubemapAttribs Attribs;
+    Attribs.pImage   = pImage;
+    Attribs.FaceSize = FaceSize;
+
+    RefCntAutoPtr<ITextureLoader> pCubemap;
+    CreateCubemapFromEquirectangular(Attribs, &pCubemap);
+    return pCubemap;
+}
+
+TEST(Tools_IBLTools, EquirectToCubemap)
+{
+    constexpr Uint32 FaceSize = 32;
+
+    // Every pixel of the image contains its direction
+    auto pImage = CreateEquirectImage(FaceSize * 4, FaceSize * 2, [](const float3& Dir) { return Dir; });
+
+    EquirectToCubemapAttribs Attribs;
+    Attribs.pImage   = pImage;
+    Attribs.FaceSize = FaceSize;
+    Attribs.Name     = "Equirect to cubemap test";
+
+    RefCntAutoPtr<ITextureLoader> pCubemap;
+    CreateCubemapFromEquirectangular(Attribs, &pCubemap);
+    ASSERT_TRUE(pCubemap);
+
+    const auto& Desc = pCubemap->GetTextureDesc();
+    EXPECT_EQ(Desc.Type, RESOURCE_DIM_TEX_CUBE);
+    EXPECT_EQ(Desc.Format, TEX_FORMAT_RGBA32_FLOAT);
+    EXPECT_EQ(Desc.Width, FaceSize);
+    EXPECT_EQ(Desc.Height, FaceSize);
+    EXPECT_EQ(Desc.ArraySize, 6u);
+    EXPECT_EQ(Desc.MipLevels, 6u);
+    EXPECT_STREQ(Desc.Name, Attribs.Name);
+
+    for (Uint32 Face = 0; Face < 6; ++Face)
+    {
+        for (Uint32 y = 0; y < FaceSize; ++y)
+        {
+            for (Uint32 x = 0; x < FaceSize; ++x)
+            {
+                const auto  Dir   = GetTexelDirection(Face, x, y, FaceSize);
+                const auto& Texel = GetTexel(pCubemap, 0, Face, x, y);
+                EXPECT_GT(dot(normalize(float3{Texel.x, Texel.y, Texel.z}), Dir), 0.995f) << "Face " << Face << ", x=" << x << ", y=" << y;
+                EXPECT_EQ(Texel.w, 1.f);
+            }
+        }
+    }
+}
+
+TEST(Tools_IBLTools, EquirectToCubemapConstant)
+{
+    constexpr Uint32 Width  = 64;
+    constexpr Uint32 Height = 32;
+    constexpr Uint8  Value  = 128;
+
+    ImageDesc ImgDesc;
+    ImgDesc.Width         = Width;
+    ImgDesc.Height        = Height;
+    ImgDesc.ComponentType = VT_UINT8;
+    ImgDesc.NumComponents = 1;
+    ImgDesc.RowStride     = Width;
+
+    auto pPixels = DataBlobImpl::Create(size_t{Width} * Height);
+    std::fill_n(static_cast<Uint8*>(pPixels->GetDataPtr()), pPixels->GetSize(), Value);
+
+    RefCntAutoPtr<Image> pImage;
+    Image::CreateFromMemory(ImgDesc, pPixels, &pImage);
+
+    EquirectToCubemapAttribs Attribs;
+    Attribs.pImage    = pImage;
+    Attribs.MipLevels = 3;
+
+    RefCntAutoPtr<ITextureLoader> pCubemap;
+    CreateCubemapFromEquirectangular(Attribs, &pCubemap);
+    ASSERT_TRUE(pCubemap);
+
+    const auto& Desc = pCubemap->GetTextureDesc();
+    EXPECT_EQ(Desc.Width, Width / 4);
+    ASSERT_EQ(Desc.MipLevels, 3u);
+
+    const auto RefValue = static_cast<float>(Value) / 255.f;
+    for (Uint32 Mip = 0; Mip < Desc.MipLevels; ++Mip)
+    {
+        const auto MipSize = Desc.Width >> Mip;
+        for (Uint32 Face = 0; Face < 6; ++Face)
+        {
+            for (Uint32 y = 0; y < MipSize; ++y)
+            {
+                for (Uint32 x = 0; x < MipSize; ++x)
+                {
+                    const auto& Texel = GetTexel(pCubemap, Mip, Face, x, y);
+                    EXPECT_NEAR(Texel.x, RefValue, 1e-5f);
+                    EXPECT_NEAR(Texel.y, RefValue, 1e-5f);
+                    EXPECT_NEAR(Texel.z, RefValue, 1e-5f);
+                }
+            }
+        }
+    }
+}
+
+TEST(Tools_IBLTools, SHIrradiance)
+{
+    auto pCubemap = CreateLinearEnvironmentCubemap(32);
+    ASSERT_TRUE(pCubemap);
+
+    const LinearEnvironment Env;
+    for (Uint32 Order = 2; Order <= 3; ++Order)
+    {
+        SHIrradianceAttribs Attribs;
+        Attribs.pCubemap = pCubemap;
+        Attribs.Order    = Order;
+
+        std::vector<float> SHCoeffs(Order * Order * 3);
+        ComputeSHIrradiance(Attribs, SHCoeffs.data());
+
+        const float3 Normals[] = {
+            float3{1, 0, 0},
+            float3{0, -1, 0},
+            float3{0, 0, 1},
+            Env.D,
+            -Env.D,
+            normalize(float3{-3, 1, 2}),
+        };
+        for (const auto& N : Normals)
+        {
+            float3 Irradiance;
+            EvaluateSHIrradiance(SHCoeffs.data(), Order, &N.x, &Irradiance.x);
+
+            // Convolution of the linear function with the normalized clamped cosine lobe
+            const auto RefIrradiance = Env.A + Env.B * (2.f / 3.f * dot(N, Env.D));
+            for (Uint32 c = 0; c < 3; ++c)
+                EXPECT_NEAR(Irradiance[c], RefIrradiance[c], 0.01f) << "Order " << Order << ", channel " << c;
+        }
+    }
+}
+
+TEST(Tools_IBLTools, PrefilterEnvironmentMap)
+{
+    auto pCubemap = CreateLinearEnvironmentCubemap(32);
+    ASSERT_TRUE(pCubemap);
+
+    PrefilterEnvMapAttribs Attribs;
+    Attribs.pCubemap   = pCubemap;
+    Attribs.FaceSize   = 16;
+    Attribs.NumSamples = 128;
+
+    RefCntAutoPtr<ITextureLoader> pPrefiltered;
+    PrefilterEnvironmentMap(Attribs, &pPrefiltered);
+    ASSERT_TRUE(pPrefiltered);
+
+    const auto& Desc = pPrefiltered->GetTextureDesc();
+    EXPECT_EQ(Desc.Type, RESOURCE_DIM_TEX_CUBE);
+    EXPECT_EQ(Desc.Width, 16u);
+    ASSERT_EQ(Desc.MipLevels, 5u);
+
+    // Prefiltering is symmetric around the reflection direction R, so the linear environment
+    // remains linear: P(R) = A + B * dot(R, D) * Scale(roughness), where Scale decreases
+    // from 1 at zero roughness.
+    const LinearEnvironment Env;
+
+    float PrevScale = 1.f;
+    for (Uint32 Mip = 0; Mip < Desc.MipLevels; ++Mip)
+    {
+        const auto MipSize = Desc.Width >> Mip;
+
+        float3 BestDir;
+        float4 BestTexel;
+        float  BestDot = -1;
+        for (Uint32 Face = 0; Face < 6; ++Face)
+        {
+            for (Uint32 y = 0; y < MipSize; ++y)
+            {
+                for (Uint32 x = 0; x < MipSize; ++x)
+                {
+                    const auto  R     = GetTexelDirection(Face, x, y, MipSize);
+                    const auto& Texel = GetTexel(pPrefiltered, Mip, Face, x, y);
+                    if (std::abs(dot(R, Env.D)) < 0.05f)
+                    {
+                        // The radiance is not changed in the directions orthogonal to D
+                        EXPECT_NEAR(Texel.x, Env.A.x, 0.05f) << "Mip " << Mip;
+                    }
+                    if (Mip == 0)
+                    {
+                        EXPECT_NEAR(Texel.x, Env(R).x, 0.02f);
+                    }
+
+                    if (dot(R, Env.D) > BestDot)
+                    {
+                        BestDot   = dot(R, Env.D);
+                        BestDir   = R;
+                        BestTexel = Texel;
+                    }
+                }
+            }
+        }
+
+        const auto Scale = (BestTexel.x - Env.A.x) / (Env.B.x * BestDot);
+        if (Mip == 0)
+            EXPECT_NEAR(Scale, 1.f, 0.02f);
+        else
+            EXPECT_LT(Scale, PrevScale + 0.02f) << "Mip " << Mip;
+        EXPECT_GT(Scale, 0.f) << "Mip " << Mip;
+        PrevScale = Scale;
+    }
+    EXPECT_LT(PrevScale, 0.9f);
+}
+
+TEST(Tools_IBLTools, BRDFIntegrationLUT)
+{
+    BRDFIntegrationLUTAttribs Attribs;
+    Attribs.Size       = 32;
+    Attribs.NumSamples = 256;
+
+    RefCntAutoPtr<ITextureLoader> pLUT;
+    ComputeBRDFIntegrationLUT(Attribs, &pLUT);
+    ASSERT_TRUE(pLUT);
+
+    const auto& Desc = pLUT->GetTextureDesc();
+    EXPECT_EQ(Desc.Type, RESOURCE_DIM_TEX_2D);
+    EXPECT_EQ(Desc.Format, TEX_FORMAT_RG32_FLOAT);
+    EXPECT_EQ(Desc.Width, Attribs.Size);
+    EXPECT_EQ(Desc.Height, Attribs.Size);
+
+    const auto& SubRes = pLUT->GetSubresourceData(0, 0);
+    for (Uint32 y = 0; y < Attribs.Size; ++y)
+    {
+        const auto* pRow = reinterpret_cast<const float2*>(static_cast<const Uint8*>(SubRes.pData) + SubRes.Stride * y);
+        for (Uint32 x = 0; x < Attribs.Size; ++x)
+        {
+            // The BRDF does not reflect more energy than it receives
+            EXPECT_GE(pRow[x].x, 0.f);
+            EXPECT_GE(pRow[x].y, 0.f);
+            EXPECT_LE(pRow[x].x + pRow[x].y, 1.01f);
+        }
+    }
+
+    // Smooth surface viewed head-on reflects everything with F0
+    const auto& Smooth = reinterpret_cast<const float2*>(SubRes.pData)[Attribs.Size - 1];
+    EXPECT_NEAR(Smooth.x, 1.f, 0.05f);
+    EXPECT_NEAR(Smooth.y, 0.f, 0.05f);
+}
+
+} // namespace
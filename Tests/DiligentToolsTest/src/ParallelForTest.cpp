@@ -0,0 +1,128 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "ParallelFor.hpp"
+
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+#include "ThreadPool.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+void TestParallelFor(IThreadPool* pThreadPool, Uint32 Count)
+{
+    std::vector<std::atomic<Uint32>> Counters(Count);
+    for (auto& Counter : Counters)
+        Counter.store(0);
+
+    ParallelFor(pThreadPool, Count, [&](Uint32 i) {
+        Counters[i].fetch_add(1);
+    });
+
+    for (Uint32 i = 0; i < Count; ++i)
+        EXPECT_EQ(Counters[i].load(), 1u) << "Item " << i;
+}
+
+TEST(Tools_TextureLoader, ParallelFor)
+{
+    auto pThreadPool = CreateThreadPool(ThreadPoolCreateInfo{4});
+    ASSERT_TRUE(pThreadPool);
+
+    for (auto* pPool : {static_cast<IThreadPool*>(nullptr), pThreadPool.RawPtr()})
+    {
+        for (Uint32 Count : {0u, 1u, 2u, 3u, 1000u})
+            TestParallelFor(pPool, Count);
+    }
+}
+
+TEST(Tools_TextureLoader, ParallelFor_FromPoolThread)
+{
+    // The only pool thread runs the outer task, so the inner loop can only be
+    // completed by the calling thread.
+    auto pThreadPool = CreateThreadPool(ThreadPoolCreateInfo{1});
+    ASSERT_TRUE(pThreadPool);
+
+    std::atomic<Uint32> NumProcessed{0};
+    EnqueueAsyncWork(pThreadPool, [&](Uint32 ThreadId) {
+        ParallelFor(pThreadPool, 100, [&](Uint32 i) {
+            NumProcessed.fetch_add(1);
+        });
+    });
+    pThreadPool->WaitForAllTasks();
+    EXPECT_EQ(NumProcessed.load(), 100u);
+}
+
+TEST(Tools_TextureLoader, ParallelFor_UnrelatedTasks)
+{
+    auto pThreadPool = CreateThreadPool(ThreadPoolCreateInfo{2});
+    ASSERT_TRUE(pThreadPool);
+
+    // The task blocks until ParallelFor returns, so ParallelFor must not wait for it
+    std::promise<void> Unblock;
+    auto               UnblockFuture = Unblock.get_future();
+    EnqueueAsyncWork(pThreadPool, [&UnblockFuture](Uint32 ThreadId) {
+        UnblockFuture.wait();
+    });
+
+    TestParallelFor(pThreadPool, 100);
+
+    Unblock.set_value();
+    pThreadPool->WaitForAllTasks();
+}
+
+TEST(Tools_TextureLoader, ParallelFor_Exception)
+{
+    auto pThreadPool = CreateThreadPool(ThreadPoolCreateInfo{4});
+    ASSERT_TRUE(pThreadPool);
+
+    for (auto* pPool : {static_cast<IThreadPool*>(nullptr), pThreadPool.RawPtr()})
+    {
+        std::atomic<Uint32> NumProcessed{0};
+        EXPECT_THROW(ParallelFor(pPool, 100,
+                                 [&](Uint32 i) {
+                                     NumProcessed.fetch_add(1);
+                                     if (i == 10)
+                                         throw std::runtime_error{"Test exception"};
+                                 }),
+                     std::runtime_error);
+        if (pPool != nullptr)
+        {
+            // All remaining items are processed before the exception is rethrown
+            EXPECT_EQ(NumProcessed.load(), 100u);
+        }
+    }
+}
+
+} // namespace
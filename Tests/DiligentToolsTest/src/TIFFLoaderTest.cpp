@@ -0,0 +1,263 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "../interface/Image.h"
+#include "tiffio.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "DataBlobImpl.hpp"
+#include "RefCntAutoPtr.hpp"
+#include "ThreadPool.hpp"
+
+using namespace Diligent;
+
+namespace
+{
+
+// Minimal in-memory TIFF writer
+class TIFFMemoryStream
+{
+public:
+    TIFF* Open()
+    {
+        return TIFFClientOpen("", "wm", this, ReadProc, WriteProc, SeekProc, CloseProc, SizeProc, MapFileProc, UnmapFileProc);
+    }
+
+    const std::vector<Uint8>& GetData() const { return m_Data; }
+
+private:
+    static tmsize_t ReadProc(thandle_t pClientData, void* pBuffer, tmsize_t Size)
+    {
+        auto* pThis = reinterpret_cast<TIFFMemoryStream*>(pClientData);
+        if (pThis->m_Offset >= pThis->m_Data.size())
+            return 0;
+        Size = std::min(Size, static_cast<tmsize_t>(pThis->m_Data.size() - pThis->m_Offset));
+        memcpy(pBuffer, pThis->m_Data.data() + pThis->m_Offset, Size);
+        pThis->m_Offset += Size;
+        return Size;
+    }
+
+    static tmsize_t WriteProc(thandle_t pClientData, void* pBuffer, tmsize_t Size)
+    {
+        auto* pThis = reinterpret_cast<TIFFMemoryStream*>(pClientData);
+        if (pThis->m_Offset + Size > pThis->m_Data.size())
+            pThis->m_Data.resize(pThis->m_Offset + Size);
+        memcpy(pThis->m_Data.data() + pThis->m_Offset, pBuffer, Size);
+        pThis->m_Offset += Size;
+        return Size;
+    }
+
+    static toff_t SeekProc(thandle_t pClientData, toff_t Offset, int Whence)
+    {
+        auto* pThis = reinterpret_cast<TIFFMemoryStream*>(pClientData);
+        switch (Whence)
+        {
+            case SEEK_SET: pThis->m_Offset = static_cast<size_t>(Offset); break;
+            case SEEK_CUR: pThis->m_Offset += static_cast<size_t>(Offset); break;
+            case SEEK_END: pThis->m_Offset = pThis->m_Data.size() + static_cast<size_t>(Offset); break;
+        }
+        return pThis->m_Offset;
+    }
+
+    static int CloseProc(thandle_t) { return 0; }
+
+    static toff_t SizeProc(thandle_t pClientData)
+    {
+        return reinterpret_cast<TIFFMemoryStream*>(pClientData)->m_Data.size();
+    }
+
+    static int  MapFileProc(thandle_t, void**, toff_t*) { return 0; }
+    static void UnmapFileProc(thandle_t, void*, toff_t) {}
+
+private:
+    std::vector<Uint8> m_Data;
+    size_t             m_Offset = 0;
+};
+
+struct TIFFTestImageInfo
+{
+    Uint32 Width         = 0;
+    Uint32 Height        = 0;
+    Uint32 NumComponents = 0;
+    Uint32 BitsPerSample = 0;
+    bool   IsPlanar      = false;
+    Uint32 TileSize      = 0; // 0 for striped images
+    Uint32 RowsPerStrip  = 0;
+    Uint16 Compression   = COMPRESSION_NONE;
+};
+
+// Generates reference pixels and encodes them as TIFF using the requested layout.
+RefCntAutoPtr<DataBlobImpl> CreateTestTIFF(const TIFFTestImageInfo& Info, std::vector<Uint8>& RefPixels)
+{
+    const size_t BytesPerSample = Info.BitsPerSample / 8;
+    const size_t PixelSize      = BytesPerSample * Info.NumComponents;
+
+    RefPixels.resize(Info.Width * Info.Height * PixelSize);
+    for (size_t i = 0; i < RefPixels.size(); ++i)
+        RefPixels[i] = static_cast<Uint8>((i * 7 + i / 13) & 0xFF);
+
+    TIFFMemoryStream Stream;
+
+    TIFF* pTiff = Stream.Open();
+    TIFFSetField(pTiff, TIFFTAG_IMAGEWIDTH, Info.Width);
+    TIFFSetField(pTiff, TIFFTAG_IMAGELENGTH, Info.Height);
+    TIFFSetField(pTiff, TIFFTAG_SAMPLESPERPIXEL, Info.NumComponents);
+    TIFFSetField(pTiff, TIFFTAG_BITSPERSAMPLE, Info.BitsPerSample);
+    TIFFSetField(pTiff, TIFFTAG_PLANARCONFIG, Info.IsPlanar ? PLANARCONFIG_SEPARATE : PLANARCONFIG_CONTIG);
+    TIFFSetField(pTiff, TIFFTAG_PHOTOMETRIC, Info.NumComponents >= 3 ? PHOTOMETRIC_RGB : PHOTOMETRIC_MINISBLACK);
+    TIFFSetField(pTiff, TIFFTAG_COMPRESSION, Info.Compression);
+    if (Info.NumComponents == 2 || Info.NumComponents == 4)
+    {
+        const uint16_t ExtraSample = EXTRASAMPLE_UNASSALPHA;
+        TIFFSetField(pTiff, TIFFTAG_EXTRASAMPLES, 1, &ExtraSample);
+    }
+
+    const Uint32 NumPlanes = Info.IsPlanar ? Info.NumComponents : 1;
+    // Copies a w x h region of one plane of the reference image into the block
+    auto CopyRegion = [&](Uint8* pBlock, size_t BlockRowPixels, Uint32 X0, Uint32 Y0, Uint32 w, Uint32 h, Uint32 Plane) {
+        const size_t BlockPixelSize = Info.IsPlanar ? BytesPerSample : PixelSize;
+        for (Uint32 y = 0; y < h; ++y)
+        {
+            for (Uint32 x = 0; x < w; ++x)
+            {
+                const auto* pSrc = &RefPixels[((Y0 + y) * Info.Width + X0 + x) * PixelSize + Plane * BytesPerSample];
+                memcpy(pBlock + (y * BlockRowPixels + x) * BlockPixelSize, pSrc, BlockPixelSize);
+            }
+        }
+    };
+
+    if (Info.TileSize != 0)
+    {
+        TIFFSetField(pTiff, TIFFTAG_TILEWIDTH, Info.TileSize);
+        TIFFSetField(pTiff, TIFFTAG_TILELENGTH, Info.TileSize);
+
+        std::vector<Uint8> Tile(static_cast<size_t>(TIFFTileSize(pTiff)));
+        for (Uint32 Plane = 0; Plane < NumPlanes; ++Plane)
+        {
+            for (Uint32 y = 0; y < Info.Height; y += Info.TileSize)
+            {
+                for (Uint32 x = 0; x < Info.Width; x += Info.TileSize)
+                {
+                    std::fill(Tile.begin(), Tile.end(), Uint8{0});
+                    CopyRegion(Tile.data(), Info.TileSize, x, y,
+                               std::min(Info.TileSize, Info.Width - x),
+                               std::min(Info.TileSize, Info.Height - y),
+                               Plane);
+                    TIFFWriteTile(pTiff, Tile.data(), x, y, 0, static_cast<uint16_t>(Plane));
+                }
+            }
+        }
+    }
+    else
+    {
+        TIFFSetField(pTiff, TIFFTAG_ROWSPERSTRIP, Info.RowsPerStrip);
+
+        std::vector<Uint8> Scanline(static_cast<size_t>(TIFFScanlineSize(pTiff)));
+        for (Uint32 Plane = 0; Plane < NumPlanes; ++Plane)
+        {
+            for (Uint32 y = 0; y < Info.Height; ++y)
+            {
+                CopyRegion(Scanline.data(), Info.Width, 0, y, Info.Width, 1, Plane);
+                TIFFWriteScanline(pTiff, Scanline.data(), y, static_cast<uint16_t>(Plane));
+            }
+        }
+    }
+    TIFFClose(pTiff);
+
+    const auto& Data = Stream.GetData();
+    return DataBlobImpl::Create(Data.size(), Data.data());
+}
+
+void TestTIFFDecoding(const TIFFTestImageInfo& Info)
+{
+    std::vector<Uint8> RefPixels;
+
+    auto pTiffData = CreateTestTIFF(Info, RefPixels);
+    ASSERT_TRUE(pTiffData);
+
+    RefCntAutoPtr<IThreadPool> pThreadPool = CreateThreadPool(ThreadPoolCreateInfo{4});
+    ASSERT_TRUE(pThreadPool);
+
+    for (int UseThreadPool = 0; UseThreadPool <= 1; ++UseThreadPool)
+    {
+        ImageLoadInfo LoadInfo;
+        LoadInfo.Format      = IMAGE_FILE_FORMAT_TIFF;
+        LoadInfo.pThreadPool = UseThreadPool ? pThreadPool.RawPtr() : nullptr;
+
+        RefCntAutoPtr<Image> pImage;
+        Image::CreateFromDataBlob(pTiffData, LoadInfo, &pImage);
+        ASSERT_TRUE(pImage);
+
+        const auto& Desc = pImage->GetDesc();
+        ASSERT_EQ(Desc.Width, Info.Width);
+        ASSERT_EQ(Desc.Height, Info.Height);
+        ASSERT_EQ(Desc.NumComponents, Info.NumComponents);
+
+        const size_t RowSize = Info.Width * Info.NumComponents * (Info.BitsPerSample / 8);
+        ASSERT_GE(Desc.RowStride, RowSize);
+
+        const auto* pPixels = static_cast<const Uint8*>(pImage->GetData()->GetConstDataPtr());
+        for (Uint32 y = 0; y < Info.Height; ++y)
+        {
+            EXPECT_EQ(memcmp(pPixels + y * Desc.RowStride, &RefPixels[y * RowSize], RowSize), 0)
+                << "Row " << y << (UseThreadPool ? " (thread pool)" : "");
+        }
+    }
+}
+
+TEST(Tools_TextureLoader, TIFFStriped)
+{
+    // Row size is not a multiple of 4, so strips are decoded through the intermediate buffer
+    TestTIFFDecoding({37, 29, 3, 8, false, 0, 4, COMPRESSION_NONE});
+    // Strips are decoded directly into the image rows
+    TestTIFFDecoding({64, 48, 4, 8, false, 0, 5, COMPRESSION_LZW});
+    TestTIFFDecoding({40, 33, 1, 16, false, 0, 1, COMPRESSION_PACKBITS});
+    // Single strip
+    TestTIFFDecoding({31, 17, 2, 32, false, 0, 17, COMPRESSION_NONE});
+}
+
+TEST(Tools_TextureLoader, TIFFTiled)
+{
+    // Partial tiles at the right and bottom edges
+    TestTIFFDecoding({70, 50, 4, 16, false, 16, 0, COMPRESSION_LZW});
+    TestTIFFDecoding({33, 17, 1, 32, false, 16, 0, COMPRESSION_NONE});
+    TestTIFFDecoding({64, 64, 3, 8, false, 32, 0, COMPRESSION_NONE});
+}
+
+TEST(Tools_TextureLoader, TIFFPlanar)
+{
+    TestTIFFDecoding({37, 29, 3, 16, true, 0, 5, COMPRESSION_LZW});
+    TestTIFFDecoding({48, 20, 4, 8, true, 0, 20, COMPRESSION_NONE});
+    TestTIFFDecoding({70, 50, 3, 8, true, 32, 0, COMPRESSION_NONE});
+}
+
+} // namespace
@@ -0,0 +1,277 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "TextureBaker.hpp"
+#include "Image.h"
+#include "FileSystem.hpp"
+#include "FileWrapper.hpp"
+#include "GraphicsAccessories.hpp"
+#include "TestingEnvironment.hpp"
+
+using namespace Diligent;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+constexpr char TempFolder[] = "./TextureBakerTest/";
+
+void WriteTestPng(const std::string& Path, Uint32 Width, Uint32 Height, Uint32 Seed)
+{
+    std::vector<Uint8> Pixels(size_t{Width} * Height * 4);
+    for (size_t i = 0; i < Pixels.size(); ++i)
+        Pixels[i] = static_cast<Uint8>((i * 7 + Seed * 31 + (i >> 8) * 13) & 0xFF);
+
+    Image::EncodeInfo Info;
+    Info.Width      = Width;
+    Info.Height     = Height;
+    Info.TexFormat  = TEX_FORMAT_RGBA8_UNORM;
+    Info.KeepAlpha  = true;
+    Info.pData      = Pixels.data();
+    Info.Stride     = Width * 4;
+    Info.FileFormat = IMAGE_FILE_FORMAT_PNG;
+
+    RefCntAutoPtr<IDataBlob> pPng;
+    Image::Encode(Info, &pPng);
+    ASSERT_TRUE(pPng);
+
+    FileWrapper File{Path.c_str(), EFileAccessMode::Overwrite};
+    ASSERT_TRUE(File);
+    File->Write(pPng->GetConstDataPtr(), pPng->GetSize());
+}
+
+void VerifyBakedTexture(const TextureBakeJob& Job)
+{
+    RefCntAutoPtr<ITextureLoader> pRefLoader;
+    CreateTextureLoaderFromFile(Job.InputPath.c_str(), IMAGE_FILE_FORMAT_UNKNOWN, Job.LoadInfo, &pRefLoader);
+    ASSERT_TRUE(pRefLoader);
+
+    RefCntAutoPtr<ITextureLoader> pLoader;
+    CreateTextureLoaderFromFile(Job.OutputPath.c_str(), IMAGE_FILE_FORMAT_DDS, TextureLoadInfo{}, &pLoader);
+    ASSERT_TRUE(pLoader);
+
+    const auto& Desc    = pLoader->GetTextureDesc();
+    const auto& RefDesc = pRefLoader->GetTextureDesc();
+    ASSERT_EQ(Desc.Type, RefDesc.Type);
+    ASSERT_EQ(Desc.Width, RefDesc.Width);
+    ASSERT_EQ(Desc.Height, RefDesc.Height);
+    ASSERT_EQ(Desc.MipLevels, RefDesc.MipLevels);
+    ASSERT_EQ(Desc.Format, RefDesc.Format);
+
+    for (Uint32 Mip = 0; Mip < Desc.MipLevels; ++Mip)
+    {
+        const auto  MipProps  = GetMipLevelProperties(Desc, Mip);
+        const auto& SubRes    = pLoader->GetSubresourceData(Mip, 0);
+        const auto& RefSubRes = pRefLoader->GetSubresourceData(Mip, 0);
+        for (Uint32 y = 0; y < MipProps.LogicalHeight; ++y)
+        {
+            const auto* pRow    = static_cast<const Uint8*>(SubRes.pData) + SubRes.Stride * y;
+            const auto* pRefRow = static_cast<const Uint8*>(RefSubRes.pData) + RefSubRes.Stride * y;
+            ASSERT_EQ(memcmp(pRow, pRefRow, static_cast<size_t>(MipProps.RowSize)), 0) << Job.OutputPath << ": mip " << Mip << ", row " << y;
+        }
+    }
+}
+
+TEST(Tools_TextureBaker, ParseManifest)
+{
+    constexpr char Manifest[] = R"({
+        "Defaults": {
+            "GenerateMips": false,
+            "IsSRGB": true
+        },
+        "Textures": [
+            {
+                "Input": "Albedo.png"
+            },
+            {
+                "Input": "Mask.png",
+                "Output": "Out/Mask.dds",
+                "Name": "Mask",
+                "IsSRGB": false,
+                "GenerateMips": true,
+                "MipLevels": 3,
+                "FlipVertically": true,
+                "PremultiplyAlpha": true,
+                "Format": "R8_UNORM",
+                "AlphaCutoff": 0.5,
+                "MipFilter": "MOST_FREQUENT",
+                "Swizzle": "bgr1",
+                "CompactFormat": false,
+                "DistanceField": "ALPHA",
+                "DistanceFieldSpread": 8,
+                "DistanceFieldDownscale": 4
+            }
+        ]
+    })";
+
+    std::vector<TextureBakeJob> Jobs;
+    ASSERT_TRUE(ParseTextureBakeManifest(Manifest, "Input", "Output", Jobs));
+    ASSERT_EQ(Jobs.size(), 2u);
+
+    const auto Slash = std::string{FileSystem::SlashSymbol};
+    EXPECT_EQ(Jobs[0].InputPath, "Input" + Slash + "Albedo.png");
+    EXPECT_EQ(Jobs[0].OutputPath, "Output" + Slash + "Albedo.dds");
+    EXPECT_TRUE(Jobs[0].Name.empty());
+    EXPECT_TRUE(Jobs[0].LoadInfo.IsSRGB);
+    EXPECT_FALSE(Jobs[0].LoadInfo.GenerateMips);
+
+    const auto& LoadInfo = Jobs[1].LoadInfo;
+    EXPECT_EQ(Jobs[1].InputPath, "Input" + Slash + "Mask.png");
+    EXPECT_EQ(Jobs[1].OutputPath, "Output" + Slash + "Out/Mask.dds");
+    EXPECT_EQ(Jobs[1].Name, "Mask");
+    EXPECT_FALSE(LoadInfo.IsSRGB);
+    EXPECT_TRUE(LoadInfo.GenerateMips);
+    EXPECT_EQ(LoadInfo.MipLevels, 3u);
+    EXPECT_TRUE(LoadInfo.FlipVertically);
+    EXPECT_TRUE(LoadInfo.PermultiplyAlpha);
+    EXPECT_EQ(LoadInfo.Format, TEX_FORMAT_R8_UNORM);
+    EXPECT_EQ(LoadInfo.AlphaCutoff, 0.5f);
+    EXPECT_EQ(LoadInfo.MipFilter, TEXTURE_LOAD_MIP_FILTER_MOST_FREQUENT);
+    EXPECT_EQ(LoadInfo.Swizzle, (TextureComponentMapping{TEXTURE_COMPONENT_SWIZZLE_B, TEXTURE_COMPONENT_SWIZZLE_G, TEXTURE_COMPONENT_SWIZZLE_R, TEXTURE_COMPONENT_SWIZZLE_ONE}));
+    EXPECT_FALSE(LoadInfo.CompactFormat);
+    EXPECT_EQ(LoadInfo.DistanceField, TEXTURE_LOAD_DISTANCE_FIELD_ALPHA);
+    EXPECT_EQ(LoadInfo.DistanceFieldSpread, 8.f);
+    EXPECT_EQ(LoadInfo.DistanceFieldDownscale, 4u);
+}
+
+TEST(Tools_TextureBaker, InvalidManifest)
+{
+    auto TestInvalidManifest = [](const char* Manifest) {
+        std::vector<TextureBakeJob> Jobs;
+        EXPECT_FALSE(ParseTextureBakeManifest(Manifest, "", "", Jobs)) << Manifest;
+    };
+
+    {
+        TestingEnvironment::ErrorScope ExpectedErrors{"must define 'Input'", "must define 'Input'"};
+        TestInvalidManifest(R"({ "Textures": [ { "Output": "Albedo.dds" } ] })");
+    }
+    {
+        TestingEnvironment::ErrorScope ExpectedErrors{"Unknown texture option 'IsSrgb'", "Unknown texture option 'IsSrgb'"};
+        TestInvalidManifest(R"({ "Textures": [ { "Input": "Albedo.png", "IsSrgb": true } ] })");
+    }
+    {
+        TestingEnvironment::ErrorScope ExpectedErrors{"Unknown texture format 'RGBA8'", "Unknown texture format 'RGBA8'"};
+        TestInvalidManifest(R"({ "Textures": [ { "Input": "Albedo.png", "Format": "RGBA8" } ] })");
+    }
+    {
+        TestingEnvironment::ErrorScope ExpectedErrors{"Invalid swizzle 'rgbx'", "Invalid swizzle 'rgbx'"};
+        TestInvalidManifest(R"({ "Textures": [ { "Input": "Albedo.png", "Swizzle": "rgbx" } ] })");
+    }
+    {
+        TestingEnvironment::ErrorScope ExpectedErrors{"Unknown mip filter 'LINEAR'", "Unknown mip filter 'LINEAR'"};
+        TestInvalidManifest(R"({ "Textures": [ { "Input": "Albedo.png", "MipFilter": "LINEAR" } ] })");
+    }
+    {
+        TestingEnvironment::ErrorScope ExpectedErrors{"Unknown distance field mode 'RGB'", "Unknown distance field mode 'RGB'"};
+        TestInvalidManifest(R"({ "Textures": [ { "Input": "Albedo.png", "DistanceField": "RGB" } ] })");
+    }
+    {
+        TestingEnvironment::ErrorScope ExpectedErrors{"CompactFormat is not supported", "CompactFormat is not supported"};
+        TestInvalidManifest(R"({ "Textures": [ { "Input": "Albedo.png", "CompactFormat": true } ] })");
+    }
+    {
+        TestingEnvironment::ErrorScope ExpectedErrors{"Unknown manifest section 'Texture'", "Unknown manifest section 'Texture'"};
+        TestInvalidManifest(R"({ "Texture": [] })");
+    }
+    {
+        TestingEnvironment::ErrorScope ExpectedErrors{"Failed to parse texture bake manifest"};
+        TestInvalidManifest(R"({ "Textures": [ { "Input": "Albedo.png", "IsSRGB": "yes" } ] })");
+    }
+    {
+        TestingEnvironment::ErrorScope ExpectedErrors{"Failed to parse texture bake manifest"};
+        TestInvalidManifest(R"({ "Textures": [ )");
+    }
+}
+
+TEST(Tools_TextureBaker, BakeTextures)
+{
+    FileSystem::DeleteDirectory(TempFolder);
+    FileSystem::CreateDirectory(TempFolder);
+
+    WriteTestPng(std::string{TempFolder} + "Albedo.png", 64, 32, 0);
+    WriteTestPng(std::string{TempFolder} + "Foliage.png", 32, 32, 1);
+    WriteTestPng(std::string{TempFolder} + "Mask.png", 48, 40, 2);
+
+    const std::string Manifest = R"({
+        "Textures": [
+            {
+                "Input": "Albedo.png",
+                "IsSRGB": true,
+                "PremultiplyAlpha": true
+            },
+            {
+                "Input": "Foliage.png",
+                "Output": "Cutout/Foliage.dds",
+                "AlphaCutoff": 0.5,
+                "Swizzle": "bgra"
+            },
+            {
+                "Input": "Mask.png",
+                "Format": "R8_UNORM",
+                "MipFilter": "MOST_FREQUENT"
+            }
+        ]
+    })";
+    {
+        FileWrapper File{(std::string{TempFolder} + "Textures.json").c_str(), EFileAccessMode::Overwrite};
+        ASSERT_TRUE(File);
+        File->Write(Manifest.data(), Manifest.size());
+    }
+
+    std::vector<TextureBakeJob> Jobs;
+    ASSERT_TRUE(LoadTextureBakeManifest((std::string{TempFolder} + "Textures.json").c_str(), "", Jobs));
+    ASSERT_EQ(Jobs.size(), 3u);
+
+    auto pThreadPool = CreateThreadPool(ThreadPoolCreateInfo{4});
+
+    const auto Results = BakeTextures(Jobs, pThreadPool);
+    ASSERT_EQ(Results.size(), Jobs.size());
+    for (size_t i = 0; i < Jobs.size(); ++i)
+    {
+        EXPECT_TRUE(Results[i].Succeeded) << Jobs[i].InputPath;
+        EXPECT_GT(Results[i].OutputSize, Uint64{0}) << Jobs[i].OutputPath;
+        EXPECT_TRUE(FileSystem::FileExists(Jobs[i].OutputPath.c_str())) << Jobs[i].OutputPath;
+        VerifyBakedTexture(Jobs[i]);
+    }
+
+    {
+        TestingEnvironment::ErrorScope ExpectedErrors{"Unsupported output file format"};
+
+        TextureBakeJob Job = Jobs[0];
+        Job.OutputPath += ".png";
+        EXPECT_FALSE(BakeTexture(Job).Succeeded);
+    }
+
+    FileSystem::DeleteDirectory(TempFolder);
+}
+
+} // namespace
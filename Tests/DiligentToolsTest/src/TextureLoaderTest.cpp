@@ -0,0 +1,900 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "../interface/TextureLoader.h"
+#include "../interface/Image.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "TestingEnvironment.hpp"
+#include "TempDirectory.hpp"
+
+#include "DataBlobImpl.hpp"
+#include "FileSystem.hpp"
+#include "FileWrapper.hpp"
+#include "GraphicsAccessories.hpp"
+#include "ThreadPool.hpp"
+
+using namespace Diligent;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+RefCntAutoPtr<Image> CreateSolidColorImage(Uint32 Width, Uint32 Height, Uint32 NumComponents, const std::array<Uint8, 4>& Color)
+{
+    ImageDesc Desc;
+    Desc.Width         = Width;
+    Desc.Height        = Height;
+    Desc.ComponentType = VT_UINT8;
+    Desc.NumComponents = NumComponents;
+    Desc.RowStride     = Width * NumComponents;
+
+    auto  pPixels = DataBlobImpl::Create(size_t{Desc.RowStride} * Height);
+    auto* pData   = static_cast<Uint8*>(pPixels->GetDataPtr());
+    for (size_t i = 0; i < size_t{Width} * Height; ++i)
+    {
+        for (Uint32 c = 0; c < NumComponents; ++c)
+            pData[i * NumComponents + c] = Color[c];
+    }
+
+    RefCntAutoPtr<Image> pImage;
+    Image::CreateFromMemory(Desc, pPixels, &pImage);
+    return pImage;
+}
+
+void VerifySolidColorSlice(ITextureLoader* pLoader, Uint32 Slice, const std::array<Uint8, 4>& Color)
+{
+    const auto& Desc = pLoader->GetTextureDesc();
+    for (Uint32 Mip = 0; Mip < Desc.MipLevels; ++Mip)
+    {
+        const auto  MipWidth  = std::max(Desc.Width >> Mip, 1u);
+        const auto  MipHeight = std::max(Desc.Height >> Mip, 1u);
+        const auto& SubRes    = pLoader->GetSubresourceData(Mip, Slice);
+        ASSERT_NE(SubRes.pData, nullptr);
+        for (Uint32 y = 0; y < MipHeight; ++y)
+        {
+            const auto* pRow = static_cast<const Uint8*>(SubRes.pData) + SubRes.Stride * y;
+            for (Uint32 x = 0; x < MipWidth; ++x)
+            {
+                for (Uint32 c = 0; c < 4; ++c)
+                    ASSERT_EQ(pRow[x * 4 + c], Color[c]) << "Slice " << Slice << ", mip " << Mip << ", x=" << x << ", y=" << y << ", c=" << c;
+            }
+        }
+    }
+}
+
+TEST(Tools_TextureLoader, TextureArrayFromImages)
+{
+    const std::array<Uint8, 4> Colors[] = {
+        {255, 0, 0, 255},
+        {0, 255, 0, 128},
+        {0, 0, 255, 0},
+    };
+
+    std::vector<RefCntAutoPtr<Image>> Images;
+    std::vector<Image*>               pImages;
+    for (const auto& Color : Colors)
+    {
+        Images.emplace_back(CreateSolidColorImage(16, 8, 4, Color));
+        pImages.push_back(Images.back());
+    }
+
+    TextureLoadInfo LoadInfo{"Texture array"};
+
+    RefCntAutoPtr<ITextureLoader> pLoader;
+    CreateTextureLoaderFromImages(pImages.data(), static_cast<Uint32>(pImages.size()), RESOURCE_DIM_TEX_2D_ARRAY, LoadInfo, nullptr, &pLoader);
+    ASSERT_TRUE(pLoader);
+
+    const auto& Desc = pLoader->GetTextureDesc();
+    EXPECT_EQ(Desc.Type, RESOURCE_DIM_TEX_2D_ARRAY);
+    EXPECT_EQ(Desc.Width, 16u);
+    EXPECT_EQ(Desc.Height, 8u);
+    EXPECT_EQ(Desc.ArraySize, 3u);
+    EXPECT_EQ(Desc.MipLevels, 5u);
+    EXPECT_EQ(Desc.Format, TEX_FORMAT_RGBA8_UNORM);
+    EXPECT_STREQ(Desc.Name, "Texture array");
+
+    const auto TexData = pLoader->GetTextureData();
+    EXPECT_EQ(TexData.NumSubresources, Desc.ArraySize * Desc.MipLevels);
+
+    for (Uint32 Slice = 0; Slice < Desc.ArraySize; ++Slice)
+        VerifySolidColorSlice(pLoader, Slice, Colors[Slice]);
+}
+
+TEST(Tools_TextureLoader, TextureArrayFormatUnification)
+{
+    // Single-channel image is expanded to RGBA
+    auto pRGBA = CreateSolidColorImage(8, 8, 4, {10, 20, 30, 40});
+    auto pGray = CreateSolidColorImage(8, 8, 1, {50});
+
+    Image* pImages[] = {pRGBA, pGray};
+
+    RefCntAutoPtr<ITextureLoader> pLoader;
+    CreateTextureLoaderFromImages(pImages, 2, RESOURCE_DIM_TEX_2D_ARRAY, TextureLoadInfo{}, nullptr, &pLoader);
+    ASSERT_TRUE(pLoader);
+
+    const auto& Desc = pLoader->GetTextureDesc();
+    EXPECT_EQ(Desc.Format, TEX_FORMAT_RGBA8_UNORM);
+    VerifySolidColorSlice(pLoader, 0, {10, 20, 30, 40});
+    VerifySolidColorSlice(pLoader, 1, {50, 50, 50, 255});
+}
+
+TEST(Tools_TextureLoader, TextureArrayDifferentSizes)
+{
+    auto pLarge = CreateSolidColorImage(32, 32, 4, {1, 2, 3, 4});
+    auto pSmall = CreateSolidColorImage(16, 16, 4, {5, 6, 7, 8});
+
+    Image* pImages[] = {pLarge, pSmall};
+    for (Uint32 MipLevels : {0u, 1u, 3u})
+    {
+        TextureLoadInfo LoadInfo;
+        LoadInfo.MipLevels = MipLevels;
+
+        RefCntAutoPtr<ITextureLoader> pLoader;
+        CreateTextureLoaderFromImages(pImages, 2, RESOURCE_DIM_TEX_2D_ARRAY, LoadInfo, nullptr, &pLoader);
+        ASSERT_TRUE(pLoader);
+
+        // Large slice is downscaled by dropping its most detailed mip level
+        const auto& Desc = pLoader->GetTextureDesc();
+        EXPECT_EQ(Desc.Width, 16u);
+        EXPECT_EQ(Desc.Height, 16u);
+        EXPECT_EQ(Desc.MipLevels, MipLevels != 0 ? MipLevels : 5u);
+        VerifySolidColorSlice(pLoader, 0, {1, 2, 3, 4});
+        VerifySolidColorSlice(pLoader, 1, {5, 6, 7, 8});
+    }
+
+    // 16x16 and 12x12 slices can't be combined
+    auto   pIncompatible = CreateSolidColorImage(12, 12, 4, {5, 6, 7, 8});
+    Image* pIncompatibleImages[] = {pLarge, pIncompatible};
+
+    TestingEnvironment::ErrorScope ExpectedErrors{"does not match the texture size", "Failed to create texture array loader"};
+
+    RefCntAutoPtr<ITextureLoader> pLoader;
+    CreateTextureLoaderFromImages(pIncompatibleImages, 2, RESOURCE_DIM_TEX_2D_ARRAY, TextureLoadInfo{}, nullptr, &pLoader);
+    EXPECT_FALSE(pLoader);
+}
+
+TEST(Tools_TextureLoader, CubemapFromImages)
+{
+    std::vector<RefCntAutoPtr<Image>> Images;
+    std::vector<Image*>               pImages;
+    for (Uint8 Face = 0; Face < 6; ++Face)
+    {
+        Images.emplace_back(CreateSolidColorImage(8, 8, 4, {Face, 0, 0, 255}));
+        pImages.push_back(Images.back());
+    }
+
+    {
+        RefCntAutoPtr<ITextureLoader> pLoader;
+        CreateTextureLoaderFromImages(pImages.data(), 6, RESOURCE_DIM_TEX_CUBE, TextureLoadInfo{}, nullptr, &pLoader);
+        ASSERT_TRUE(pLoader);
+
+        const auto& Desc = pLoader->GetTextureDesc();
+        EXPECT_EQ(Desc.Type, RESOURCE_DIM_TEX_CUBE);
+        EXPECT_EQ(Desc.ArraySize, 6u);
+        EXPECT_EQ(Desc.MipLevels, 4u);
+        for (Uint8 Face = 0; Face < 6; ++Face)
+            VerifySolidColorSlice(pLoader, Face, {Face, 0, 0, 255});
+    }
+
+    {
+        // Cubemap requires 6 faces
+        TestingEnvironment::ErrorScope ExpectedErrors{"requires 6 slices", "Failed to create texture array loader"};
+
+        RefCntAutoPtr<ITextureLoader> pLoader;
+        CreateTextureLoaderFromImages(pImages.data(), 5, RESOURCE_DIM_TEX_CUBE, TextureLoadInfo{}, nullptr, &pLoader);
+        EXPECT_FALSE(pLoader);
+    }
+
+    {
+        // Cubemap faces must be square
+        auto   pRect    = CreateSolidColorImage(16, 8, 4, {0, 0, 0, 255});
+        Image* pRects[] = {pRect, pRect, pRect, pRect, pRect, pRect};
+
+        TestingEnvironment::ErrorScope ExpectedErrors{"must be square", "Failed to create texture array loader"};
+
+        RefCntAutoPtr<ITextureLoader> pLoader;
+        CreateTextureLoaderFromImages(pRects, 6, RESOURCE_DIM_TEX_CUBE, TextureLoadInfo{}, nullptr, &pLoader);
+        EXPECT_FALSE(pLoader);
+    }
+}
+
+void TestDDSCubemapRoundTrip(Uint32 NumCubes)
+{
+    TempDirectory TmpDir{"DDSCubemapTest"};
+    ASSERT_TRUE(TmpDir);
+    const std::string FilePath = TmpDir.GetPath() + "Cubemap.dds";
+
+    TextureDesc Desc;
+    Desc.Type      = NumCubes > 1 ? RESOURCE_DIM_TEX_CUBE_ARRAY : RESOURCE_DIM_TEX_CUBE;
+    Desc.Width     = 8;
+    Desc.Height    = 8;
+    Desc.ArraySize = 6 * NumCubes;
+    Desc.MipLevels = 4;
+    Desc.Format    = TEX_FORMAT_RGBA8_UNORM;
+
+    // Every texel encodes its face, mip level and position
+    auto GetTexel = [](Uint32 Face, Uint32 Mip, Uint32 x, Uint32 y) {
+        return std::array<Uint8, 4>{static_cast<Uint8>(Face), static_cast<Uint8>(Mip), static_cast<Uint8>(x), static_cast<Uint8>(y)};
+    };
+
+    std::vector<std::vector<Uint8>> Mips;
+    std::vector<TextureSubResData>  SubResources;
+    for (Uint32 Face = 0; Face < Desc.ArraySize; ++Face)
+    {
+        for (Uint32 Mip = 0; Mip < Desc.MipLevels; ++Mip)
+        {
+            const auto MipProps = GetMipLevelProperties(Desc, Mip);
+            Mips.emplace_back(static_cast<size_t>(MipProps.MipSize));
+            for (Uint32 y = 0; y < MipProps.LogicalHeight; ++y)
+            {
+                for (Uint32 x = 0; x < MipProps.LogicalWidth; ++x)
+                {
+                    const auto Texel = GetTexel(Face, Mip, x, y);
+                    memcpy(&Mips.back()[static_cast<size_t>(MipProps.RowSize * y + x * 4)], Texel.data(), 4);
+                }
+            }
+            SubResources.emplace_back(Mips.back().data(), MipProps.RowSize);
+        }
+    }
+
+    TextureData TexData{SubResources.data(), static_cast<Uint32>(SubResources.size())};
+    ASSERT_TRUE(SaveTextureAsDDS(FilePath.c_str(), Desc, TexData));
+
+    std::vector<Uint8> FileData;
+    {
+        FileWrapper File{FilePath.c_str(), EFileAccessMode::Read};
+        ASSERT_TRUE(File);
+        FileData.resize(File->GetSize());
+        ASSERT_TRUE(File->Read(FileData.data(), FileData.size()));
+    }
+
+    // 'DDS ' magic, 124-byte DDS_HEADER and 20-byte DDS_HEADER_DXT10
+    ASSERT_GE(FileData.size(), size_t{148});
+    auto ReadUint32 = [&FileData](size_t Offset) {
+        Uint32 Value = 0;
+        memcpy(&Value, &FileData[Offset], sizeof(Value));
+        return Value;
+    };
+    EXPECT_EQ(ReadUint32(112), 0xFE00u) << "DDS_HEADER::caps2 must be DDSCAPS2_CUBEMAP with all faces";
+    EXPECT_EQ(ReadUint32(136), 0x4u) << "DDS_HEADER_DXT10::miscFlag must be D3D11_RESOURCE_MISC_TEXTURECUBE";
+    EXPECT_EQ(ReadUint32(140), NumCubes) << "DDS_HEADER_DXT10::arraySize must be the number of cubes";
+
+    RefCntAutoPtr<ITextureLoader> pLoader;
+    CreateTextureLoaderFromMemory(FileData.data(), FileData.size(), false, TextureLoadInfo{}, &pLoader);
+    ASSERT_TRUE(pLoader);
+
+    const auto& LoadedDesc = pLoader->GetTextureDesc();
+    EXPECT_EQ(LoadedDesc.Type, Desc.Type);
+    EXPECT_EQ(LoadedDesc.Width, Desc.Width);
+    EXPECT_EQ(LoadedDesc.Height, Desc.Height);
+    EXPECT_EQ(LoadedDesc.ArraySize, Desc.ArraySize);
+    EXPECT_EQ(LoadedDesc.Format, Desc.Format);
+    ASSERT_EQ(LoadedDesc.MipLevels, Desc.MipLevels);
+
+    for (Uint32 Face = 0; Face < Desc.ArraySize; ++Face)
+    {
+        for (Uint32 Mip = 0; Mip < Desc.MipLevels; ++Mip)
+        {
+            const auto  MipProps = GetMipLevelProperties(Desc, Mip);
+            const auto& SubRes   = pLoader->GetSubresourceData(Mip, Face);
+            ASSERT_NE(SubRes.pData, nullptr);
+            for (Uint32 y = 0; y < MipProps.LogicalHeight; ++y)
+            {
+                const auto* pRow = static_cast<const Uint8*>(SubRes.pData) + SubRes.Stride * y;
+                for (Uint32 x = 0; x < MipProps.LogicalWidth; ++x)
+                {
+                    const auto Texel = GetTexel(Face, Mip, x, y);
+                    ASSERT_EQ(memcmp(&pRow[x * 4], Texel.data(), 4), 0) << "Face " << Face << ", mip " << Mip << ", x=" << x << ", y=" << y;
+                }
+            }
+        }
+    }
+}
+
+TEST(Tools_TextureLoader, DDSCubemapRoundTrip)
+{
+    TestDDSCubemapRoundTrip(1);
+}
+
+TEST(Tools_TextureLoader, DDSCubemapArrayRoundTrip)
+{
+    TestDDSCubemapRoundTrip(2);
+}
+
+TEST(Tools_TextureLoader, CompactFormat)
+{
+    struct TestCase
+    {
+        std::array<Uint8, 4>    Color;
+        Uint32                  NumComponents;
+        TEXTURE_FORMAT          ExpectedFormat;
+        TextureComponentMapping ExpectedMapping;
+    };
+
+    constexpr auto R    = TEXTURE_COMPONENT_SWIZZLE_R;
+    constexpr auto G    = TEXTURE_COMPONENT_SWIZZLE_G;
+    constexpr auto ONE  = TEXTURE_COMPONENT_SWIZZLE_ONE;
+    const auto     Iden = TextureComponentMapping::Identity();
+
+    TextureComponentMapping GrayOpaque{R, R, R, ONE};
+    TextureComponentMapping GrayAlpha{R, R, R, G};
+
+    const TestCase TestCases[] = {
+        {{80, 80, 80, 255}, 4, TEX_FORMAT_R8_UNORM, GrayOpaque},
+        {{80, 80, 80, 0}, 3, TEX_FORMAT_R8_UNORM, GrayOpaque},
+        {{80, 80, 80, 128}, 4, TEX_FORMAT_RG8_UNORM, GrayAlpha},
+        {{80, 90, 0, 255}, 4, TEX_FORMAT_RG8_UNORM, Iden},
+        {{80, 0, 0, 0}, 3, TEX_FORMAT_R8_UNORM, Iden},
+        {{80, 0, 0, 0}, 2, TEX_FORMAT_R8_UNORM, Iden},
+        {{80, 90, 100, 255}, 4, TEX_FORMAT_RGBA8_UNORM, Iden},
+        {{80, 90, 0, 128}, 4, TEX_FORMAT_RGBA8_UNORM, Iden},
+    };
+
+    for (const auto& Test : TestCases)
+    {
+        auto pImage = CreateSolidColorImage(16, 8, Test.NumComponents, Test.Color);
+        ASSERT_TRUE(pImage);
+
+        TextureLoadInfo LoadInfo{"Compact texture"};
+        LoadInfo.CompactFormat = True;
+
+        RefCntAutoPtr<ITextureLoader> pLoader;
+        CreateTextureLoaderFromImage(pImage, LoadInfo, &pLoader);
+        ASSERT_TRUE(pLoader);
+
+        const auto* pContentInfo = pLoader->GetContentInfo();
+        ASSERT_NE(pContentInfo, nullptr);
+        EXPECT_EQ(pContentInfo->NumComponents, Test.NumComponents);
+        EXPECT_EQ(pContentInfo->ConstantComponents, (1u << Test.NumComponents) - 1u);
+
+        const auto& Desc = pLoader->GetTextureDesc();
+        EXPECT_EQ(Desc.Format, Test.ExpectedFormat);
+        EXPECT_EQ(Desc.MipLevels, 5u);
+
+        const auto Mapping = pLoader->GetComponentMapping();
+        EXPECT_TRUE(Mapping == Test.ExpectedMapping);
+
+        // Sample every mip level through the component mapping and compare with the source color
+        const auto& FmtAttribs = GetTextureFormatAttribs(Desc.Format);
+        for (Uint32 Mip = 0; Mip < Desc.MipLevels; ++Mip)
+        {
+            const auto& SubRes = pLoader->GetSubresourceData(Mip);
+            const auto* pTexel = static_cast<const Uint8*>(SubRes.pData);
+
+            Uint8 Sampled[4] = {0, 0, 0, 255};
+            for (Uint32 c = 0; c < FmtAttribs.NumComponents; ++c)
+                Sampled[c] = pTexel[c];
+
+            const TEXTURE_COMPONENT_SWIZZLE Swizzles[] = {Mapping.R, Mapping.G, Mapping.B, Mapping.A};
+            for (Uint32 c = 0; c < 4; ++c)
+            {
+                Uint8 Expected = 0;
+                if (c < Test.NumComponents)
+                    Expected = Test.Color[c];
+                else if (c == 3)
+                    Expected = 255;
+
+                Uint8 Value = 0;
+                switch (Swizzles[c])
+                {
+                    case TEXTURE_COMPONENT_SWIZZLE_IDENTITY: Value = Sampled[c]; break;
+                    case TEXTURE_COMPONENT_SWIZZLE_ZERO: Value = 0; break;
+                    case TEXTURE_COMPONENT_SWIZZLE_ONE: Value = 255; break;
+                    default: Value = Sampled[Swizzles[c] - TEXTURE_COMPONENT_SWIZZLE_R]; break;
+                }
+                EXPECT_EQ(Value, Expected) << "Mip " << Mip << ", component " << c;
+            }
+        }
+    }
+}
+
+TEST(Tools_TextureLoader, CompactFormatDisabled)
+{
+    auto pImage = CreateSolidColorImage(16, 8, 4, {80, 80, 80, 255});
+    ASSERT_TRUE(pImage);
+
+    {
+        TextureLoadInfo LoadInfo{"Default texture"};
+
+        RefCntAutoPtr<ITextureLoader> pLoader;
+        CreateTextureLoaderFromImage(pImage, LoadInfo, &pLoader);
+        ASSERT_TRUE(pLoader);
+        EXPECT_EQ(pLoader->GetContentInfo(), nullptr);
+        EXPECT_EQ(pLoader->GetTextureDesc().Format, TEX_FORMAT_RGBA8_UNORM);
+        EXPECT_TRUE(pLoader->GetComponentMapping() == TextureComponentMapping::Identity());
+    }
+
+    {
+        // There are no single-component sRGB formats
+        TextureLoadInfo LoadInfo{"sRGB texture"};
+        LoadInfo.CompactFormat = True;
+        LoadInfo.IsSRGB        = True;
+
+        RefCntAutoPtr<ITextureLoader> pLoader;
+        CreateTextureLoaderFromImage(pImage, LoadInfo, &pLoader);
+        ASSERT_TRUE(pLoader);
+        ASSERT_NE(pLoader->GetContentInfo(), nullptr);
+        EXPECT_TRUE(pLoader->GetContentInfo()->IsGrayscale);
+        EXPECT_EQ(pLoader->GetTextureDesc().Format, TEX_FORMAT_RGBA8_UNORM_SRGB);
+    }
+}
+
+TEST(Tools_TextureLoader, DistanceField)
+{
+    constexpr Uint32 Width  = 64;
+    constexpr Uint32 Height = 32;
+    constexpr Uint32 EdgeX  = 32;
+
+    // The color is opaque in the left half of the image
+    ImageDesc ImgDesc;
+    ImgDesc.Width         = Width;
+    ImgDesc.Height        = Height;
+    ImgDesc.ComponentType = VT_UINT8;
+    ImgDesc.NumComponents = 2;
+    ImgDesc.RowStride     = Width * 2;
+
+    auto  pPixels = DataBlobImpl::Create(size_t{ImgDesc.RowStride} * Height);
+    auto* pData   = static_cast<Uint8*>(pPixels->GetDataPtr());
+    for (Uint32 y = 0; y < Height; ++y)
+    {
+        for (Uint32 x = 0; x < Width; ++x)
+        {
+            pData[(y * Width + x) * 2 + 0] = 255;
+            pData[(y * Width + x) * 2 + 1] = x < EdgeX ? 255 : 0;
+        }
+    }
+
+    RefCntAutoPtr<Image> pImage;
+    Image::CreateFromMemory(ImgDesc, pPixels, &pImage);
+    ASSERT_TRUE(pImage);
+
+    {
+        TextureLoadInfo LoadInfo{"Distance field"};
+        LoadInfo.DistanceField          = TEXTURE_LOAD_DISTANCE_FIELD_ALPHA;
+        LoadInfo.DistanceFieldSpread    = 4;
+        LoadInfo.DistanceFieldDownscale = 2;
+
+        RefCntAutoPtr<ITextureLoader> pLoader;
+        CreateTextureLoaderFromImage(pImage, LoadInfo, &pLoader);
+        ASSERT_TRUE(pLoader);
+
+        const auto& Desc = pLoader->GetTextureDesc();
+        EXPECT_EQ(Desc.Format, TEX_FORMAT_R8_UNORM);
+        EXPECT_EQ(Desc.Width, Width / 2);
+        EXPECT_EQ(Desc.Height, Height / 2);
+
+        // The edge is at x = 16 in the distance field
+        const auto& SubRes = pLoader->GetSubresourceData(0);
+        for (Uint32 y = 0; y < Desc.Height; ++y)
+        {
+            const auto* pRow = static_cast<const Uint8*>(SubRes.pData) + SubRes.Stride * y;
+            for (Uint32 x = 0; x < Desc.Width; ++x)
+            {
+                const float Expected = std::min(std::max(0.5f + (16.f - (static_cast<float>(x) + 0.5f)) / 8.f, 0.f), 1.f);
+                EXPECT_NEAR(static_cast<float>(pRow[x]) / 255.f, Expected, 1.f / 255.f) << "x=" << x << ", y=" << y;
+            }
+        }
+    }
+
+    {
+        TextureLoadInfo LoadInfo{"Distance field"};
+        LoadInfo.DistanceField = TEXTURE_LOAD_DISTANCE_FIELD_ALL_COMPONENTS;
+
+        RefCntAutoPtr<ITextureLoader> pLoader;
+        CreateTextureLoaderFromImage(pImage, LoadInfo, &pLoader);
+        ASSERT_TRUE(pLoader);
+
+        const auto& Desc = pLoader->GetTextureDesc();
+        EXPECT_EQ(Desc.Format, TEX_FORMAT_RG8_UNORM);
+        EXPECT_EQ(Desc.Width, Width);
+        EXPECT_EQ(Desc.Height, Height);
+
+        // The first component is opaque everywhere
+        const auto* pTexel = static_cast<const Uint8*>(pLoader->GetSubresourceData(0).pData);
+        EXPECT_EQ(pTexel[0], 255);
+        EXPECT_EQ(pTexel[1], 255);
+    }
+}
+
+RefCntAutoPtr<IDataBlob> EncodeTestPng(Uint32 Width, Uint32 Height, Uint32 Seed)
+{
+    std::vector<Uint8> Pixels(size_t{Width} * Height * 4);
+    for (size_t i = 0; i < Pixels.size(); ++i)
+        Pixels[i] = static_cast<Uint8>((i * 7 + Seed * 31 + (i >> 8) * 13) & 0xFF);
+
+    Image::EncodeInfo Info;
+    Info.Width      = Width;
+    Info.Height     = Height;
+    Info.TexFormat  = TEX_FORMAT_RGBA8_UNORM;
+    Info.KeepAlpha  = true;
+    Info.pData      = Pixels.data();
+    Info.Stride     = Width * 4;
+    Info.FileFormat = IMAGE_FILE_FORMAT_PNG;
+
+    RefCntAutoPtr<IDataBlob> pPng;
+    Image::Encode(Info, &pPng);
+    return pPng;
+}
+
+std::vector<std::string> GetTextureCacheFiles(const std::string& CacheDir)
+{
+    std::vector<std::string> Files;
+    for (const auto& pFile : FileSystem::Search((CacheDir + "*.dds").c_str()))
+        Files.emplace_back(CacheDir + pFile->Name());
+    return Files;
+}
+
+RefCntAutoPtr<ITextureLoader> LoadTestPng(IDataBlob* pPng, const TextureLoadInfo& LoadInfo)
+{
+    RefCntAutoPtr<ITextureLoader> pLoader;
+    CreateTextureLoaderFromMemory(pPng->GetConstDataPtr(), pPng->GetSize(), false, LoadInfo, &pLoader);
+    return pLoader;
+}
+
+void VerifyIdenticalTextures(ITextureLoader* pLoader, ITextureLoader* pRefLoader)
+{
+    ASSERT_TRUE(pLoader);
+    ASSERT_TRUE(pRefLoader);
+
+    const auto& Desc    = pLoader->GetTextureDesc();
+    const auto& RefDesc = pRefLoader->GetTextureDesc();
+    ASSERT_EQ(Desc.Type, RefDesc.Type);
+    ASSERT_EQ(Desc.Width, RefDesc.Width);
+    ASSERT_EQ(Desc.Height, RefDesc.Height);
+    ASSERT_EQ(Desc.MipLevels, RefDesc.MipLevels);
+    ASSERT_EQ(Desc.Format, RefDesc.Format);
+    EXPECT_EQ(Desc.Usage, RefDesc.Usage);
+    EXPECT_EQ(Desc.BindFlags, RefDesc.BindFlags);
+    EXPECT_STREQ(Desc.Name, RefDesc.Name);
+
+    for (Uint32 Mip = 0; Mip < Desc.MipLevels; ++Mip)
+    {
+        const auto  MipProps  = GetMipLevelProperties(Desc, Mip);
+        const auto& SubRes    = pLoader->GetSubresourceData(Mip, 0);
+        const auto& RefSubRes = pRefLoader->GetSubresourceData(Mip, 0);
+        for (Uint32 y = 0; y < MipProps.LogicalHeight; ++y)
+        {
+            const auto* pRow    = static_cast<const Uint8*>(SubRes.pData) + SubRes.Stride * y;
+            const auto* pRefRow = static_cast<const Uint8*>(RefSubRes.pData) + RefSubRes.Stride * y;
+            ASSERT_EQ(memcmp(pRow, pRefRow, static_cast<size_t>(MipProps.RowSize)), 0) << "Mip " << Mip << ", row " << y;
+        }
+    }
+}
+
+TEST(Tools_TextureLoader, TextureCache)
+{
+    TempDirectory TmpDir{"TextureCacheTest"};
+    ASSERT_TRUE(TmpDir);
+    // The cache creates the directory when the first entry is written
+    const std::string CacheDir = TmpDir.GetPath() + "Cache/";
+
+    auto pPng = EncodeTestPng(64, 32, 0);
+    ASSERT_TRUE(pPng);
+
+    TextureLoadInfo LoadInfo{"Cached texture"};
+    LoadInfo.CacheDirectory = CacheDir.c_str();
+
+    TextureLoadInfo RefLoadInfo = LoadInfo;
+    RefLoadInfo.CacheDirectory  = nullptr;
+    auto pRefLoader             = LoadTestPng(pPng, RefLoadInfo);
+
+    // Miss: the entry is created
+    VerifyIdenticalTextures(LoadTestPng(pPng, LoadInfo), pRefLoader);
+    auto CacheFiles = GetTextureCacheFiles(CacheDir);
+    ASSERT_EQ(CacheFiles.size(), 1u);
+
+    // Hit: the data is read from the entry
+    VerifyIdenticalTextures(LoadTestPng(pPng, LoadInfo), pRefLoader);
+    EXPECT_EQ(GetTextureCacheFiles(CacheDir).size(), 1u);
+
+    // Members that do not affect the contents are not part of the key
+    {
+        auto OtherLoadInfo      = LoadInfo;
+        OtherLoadInfo.Name      = "Other name";
+        OtherLoadInfo.BindFlags = BIND_SHADER_RESOURCE | BIND_RENDER_TARGET;
+        auto pLoader            = LoadTestPng(pPng, OtherLoadInfo);
+        ASSERT_TRUE(pLoader);
+        EXPECT_STREQ(pLoader->GetTextureDesc().Name, "Other name");
+        EXPECT_EQ(pLoader->GetTextureDesc().BindFlags, OtherLoadInfo.BindFlags);
+        EXPECT_EQ(GetTextureCacheFiles(CacheDir).size(), 1u);
+    }
+
+    // Members that affect the contents invalidate the entry
+    {
+        auto FlippedLoadInfo           = LoadInfo;
+        FlippedLoadInfo.FlipVertically = true;
+        auto FlippedRefLoadInfo        = RefLoadInfo;
+        FlippedRefLoadInfo.FlipVertically = true;
+        VerifyIdenticalTextures(LoadTestPng(pPng, FlippedLoadInfo), LoadTestPng(pPng, FlippedRefLoadInfo));
+        EXPECT_EQ(GetTextureCacheFiles(CacheDir).size(), 2u);
+
+        auto SRGBLoadInfo   = LoadInfo;
+        SRGBLoadInfo.IsSRGB = true;
+        auto pSRGBLoader    = LoadTestPng(pPng, SRGBLoadInfo);
+        ASSERT_TRUE(pSRGBLoader);
+        EXPECT_EQ(pSRGBLoader->GetTextureDesc().Format, TEX_FORMAT_RGBA8_UNORM_SRGB);
+        EXPECT_EQ(GetTextureCacheFiles(CacheDir).size(), 3u);
+    }
+
+    // Different source data is a different entry
+    VerifyIdenticalTextures(LoadTestPng(EncodeTestPng(64, 32, 1), LoadInfo), LoadTestPng(EncodeTestPng(64, 32, 1), RefLoadInfo));
+    EXPECT_EQ(GetTextureCacheFiles(CacheDir).size(), 4u);
+
+    // Replace the contents of the first entry to make sure that the source data is not decoded on a hit
+    {
+        const auto& Desc    = pRefLoader->GetTextureDesc();
+        auto        TexData = pRefLoader->GetTextureData();
+
+        const auto&        Mip0Props = GetMipLevelProperties(Desc, 0);
+        std::vector<Uint8> Mip0(static_cast<size_t>(Mip0Props.MipSize), 42);
+
+        std::vector<TextureSubResData> SubResources{TexData.pSubResources, TexData.pSubResources + TexData.NumSubresources};
+        SubResources[0] = TextureSubResData{Mip0.data(), Mip0Props.RowSize};
+        TexData.pSubResources = SubResources.data();
+        ASSERT_TRUE(SaveTextureAsDDS(CacheFiles[0].c_str(), Desc, TexData));
+
+        auto pLoader = LoadTestPng(pPng, LoadInfo);
+        ASSERT_TRUE(pLoader);
+        const auto& SubRes = pLoader->GetSubresourceData(0, 0);
+        EXPECT_EQ(static_cast<const Uint8*>(SubRes.pData)[0], 42);
+    }
+}
+
+TEST(Tools_TextureLoader, TextureCacheEviction)
+{
+    TempDirectory TmpDir{"TextureCacheEvictionTest"};
+    ASSERT_TRUE(TmpDir);
+    // The cache creates the directory when the first entry is written
+    const std::string CacheDir = TmpDir.GetPath() + "Cache/";
+
+    // Every entry is 64x64 RGBA8 texture with the full mip chain (~22 KB), so only two entries fit
+    TextureLoadInfo LoadInfo;
+    LoadInfo.CacheDirectory = CacheDir.c_str();
+    LoadInfo.CacheSizeLimit = 50000;
+
+    for (Uint32 i = 0; i < 5; ++i)
+    {
+        auto pLoader = LoadTestPng(EncodeTestPng(64, 64, i), LoadInfo);
+        ASSERT_TRUE(pLoader);
+
+        const auto CacheFiles = GetTextureCacheFiles(CacheDir);
+        EXPECT_EQ(CacheFiles.size(), std::min(i + 1, 2u));
+
+        Uint64 TotalSize = 0;
+        for (const auto& File : CacheFiles)
+        {
+            FileWrapper FileData{File.c_str(), EFileAccessMode::Read};
+            ASSERT_TRUE(FileData);
+            TotalSize += FileData->GetSize();
+        }
+        EXPECT_LE(TotalSize, LoadInfo.CacheSizeLimit);
+    }
+}
+
+
+TEST(Tools_TextureLoader, TextureCacheLRU)
+{
+    TempDirectory TmpDir{"TextureCacheLRUTest"};
+    ASSERT_TRUE(TmpDir);
+    const std::string& CacheDir = TmpDir.GetPath();
+
+    // Only two 64x64 RGBA8 entries with the full mip chain (~22 KB each) fit
+    TextureLoadInfo LoadInfo;
+    LoadInfo.CacheDirectory = CacheDir.c_str();
+    LoadInfo.CacheSizeLimit = 50000;
+
+    RefCntAutoPtr<IDataBlob> pPngs[] = {EncodeTestPng(64, 64, 0), EncodeTestPng(64, 64, 1), EncodeTestPng(64, 64, 2)};
+
+    // Loads the texture and returns the cache file that was created, or an empty string if there was a hit
+    auto Load = [&](Uint32 Idx) {
+        const auto FilesBefore = GetTextureCacheFiles(CacheDir);
+        EXPECT_TRUE(LoadTestPng(pPngs[Idx], LoadInfo));
+        for (const auto& File : GetTextureCacheFiles(CacheDir))
+        {
+            if (std::find(FilesBefore.begin(), FilesBefore.end(), File) == FilesBefore.end())
+                return File;
+        }
+        return std::string{};
+    };
+    auto IsCached = [&](const std::string& File) {
+        return FileSystem::FileExists(File.c_str());
+    };
+
+    // All accesses happen within the same second, so the order must not depend
+    // on the whole-second file modification time.
+    const auto File0 = Load(0);
+    const auto File1 = Load(1);
+    ASSERT_FALSE(File0.empty());
+    ASSERT_FALSE(File1.empty());
+
+    // Hit: entry 0 becomes the most recently used one
+    EXPECT_TRUE(Load(0).empty());
+
+    // Entry 1 is the least recently used one and is evicted
+    const auto File2 = Load(2);
+    ASSERT_FALSE(File2.empty());
+    EXPECT_TRUE(IsCached(File0));
+    EXPECT_FALSE(IsCached(File1));
+    EXPECT_TRUE(IsCached(File2));
+
+    // Miss: entry 1 is written again and evicts entry 0
+    EXPECT_EQ(Load(1), File1);
+    EXPECT_FALSE(IsCached(File0));
+    EXPECT_TRUE(IsCached(File1));
+    EXPECT_TRUE(IsCached(File2));
+
+    // Hits on entries 2 and 1 make entry 2 the least recently used one
+    EXPECT_TRUE(Load(2).empty());
+    EXPECT_TRUE(Load(1).empty());
+    EXPECT_EQ(Load(0), File0);
+    EXPECT_TRUE(IsCached(File0));
+    EXPECT_TRUE(IsCached(File1));
+    EXPECT_FALSE(IsCached(File2));
+}
+
+TEST(Tools_TextureLoader, TextureCacheOverwrite)
+{
+    TempDirectory TmpDir{"TextureCacheOverwriteTest"};
+    ASSERT_TRUE(TmpDir);
+    const std::string& CacheDir = TmpDir.GetPath();
+
+    auto pPng = EncodeTestPng(32, 32, 0);
+    ASSERT_TRUE(pPng);
+
+    TextureLoadInfo LoadInfo;
+    LoadInfo.CacheDirectory = CacheDir.c_str();
+    auto pRefLoader         = LoadTestPng(pPng, LoadInfo);
+    ASSERT_TRUE(pRefLoader);
+
+    const auto CacheFiles = GetTextureCacheFiles(CacheDir);
+    ASSERT_EQ(CacheFiles.size(), 1u);
+
+    // Replace the entry with a file that can't be loaded. The texture is decoded from the
+    // source data again and the new entry must replace the existing file.
+    {
+        FileWrapper File{CacheFiles[0].c_str(), EFileAccessMode::Overwrite};
+        ASSERT_TRUE(File);
+        const char Garbage[] = "Not a DDS file";
+        ASSERT_TRUE(File->Write(Garbage, sizeof(Garbage)));
+    }
+    {
+        TestingEnvironment::ErrorScope ExpectedErrors{"DDS data size"};
+        VerifyIdenticalTextures(LoadTestPng(pPng, LoadInfo), pRefLoader);
+    }
+
+    EXPECT_EQ(GetTextureCacheFiles(CacheDir), CacheFiles);
+    VerifyIdenticalTextures(LoadTestPng(pPng, LoadInfo), pRefLoader);
+}
+
+TEST(Tools_TextureLoader, TextureArrayFromFiles)
+{
+    TempDirectory TmpDir{"TextureArrayFromFilesTest"};
+    ASSERT_TRUE(TmpDir);
+
+    // Use more files than there are threads in the pool. Every other file is twice as
+    // large, so with the limited mip count these slices are loaded again in the second pass.
+    constexpr Uint32         NumFiles = 12;
+    std::vector<std::string> FilePaths;
+    for (Uint32 i = 0; i < NumFiles; ++i)
+    {
+        const Uint32 Size = (i % 2) == 0 ? 32 : 64;
+        auto         pPng = EncodeTestPng(Size, Size, i);
+        ASSERT_TRUE(pPng);
+
+        FilePaths.emplace_back(TmpDir.GetPath() + "Slice" + std::to_string(i) + ".png");
+        FileWrapper File{FilePaths.back().c_str(), EFileAccessMode::Overwrite};
+        ASSERT_TRUE(File);
+        ASSERT_TRUE(File->Write(pPng->GetConstDataPtr(), pPng->GetSize()));
+    }
+
+    std::vector<const char*> pFilePaths;
+    for (const auto& Path : FilePaths)
+        pFilePaths.push_back(Path.c_str());
+
+    RefCntAutoPtr<IThreadPool> pThreadPool = CreateThreadPool(ThreadPoolCreateInfo{4});
+    ASSERT_TRUE(pThreadPool);
+
+    for (Uint32 MipLevels : {0u, 3u})
+    {
+        TextureLoadInfo LoadInfo{"Texture array from files"};
+        LoadInfo.MipLevels = MipLevels;
+
+        RefCntAutoPtr<ITextureLoader> pRefLoader;
+        CreateTextureLoaderFromFiles(pFilePaths.data(), NumFiles, RESOURCE_DIM_TEX_2D_ARRAY, LoadInfo, nullptr, &pRefLoader);
+        ASSERT_TRUE(pRefLoader);
+
+        const auto& RefDesc = pRefLoader->GetTextureDesc();
+        EXPECT_EQ(RefDesc.Type, RESOURCE_DIM_TEX_2D_ARRAY);
+        EXPECT_EQ(RefDesc.Width, 32u);
+        EXPECT_EQ(RefDesc.Height, 32u);
+        EXPECT_EQ(RefDesc.ArraySize, NumFiles);
+        EXPECT_EQ(RefDesc.MipLevels, MipLevels != 0 ? MipLevels : 6u);
+        EXPECT_EQ(RefDesc.Format, TEX_FORMAT_RGBA8_UNORM);
+
+        // Small slices must match the files loaded individually
+        for (Uint32 Slice = 0; Slice < NumFiles; Slice += 2)
+        {
+            RefCntAutoPtr<ITextureLoader> pSliceLoader;
+            CreateTextureLoaderFromFile(pFilePaths[Slice], IMAGE_FILE_FORMAT_UNKNOWN, LoadInfo, &pSliceLoader);
+            ASSERT_TRUE(pSliceLoader);
+            ASSERT_EQ(pSliceLoader->GetTextureDesc().MipLevels, RefDesc.MipLevels);
+            for (Uint32 Mip = 0; Mip < RefDesc.MipLevels; ++Mip)
+            {
+                const auto  MipProps  = GetMipLevelProperties(RefDesc, Mip);
+                const auto& SubRes    = pSliceLoader->GetSubresourceData(Mip, 0);
+                const auto& RefSubRes = pRefLoader->GetSubresourceData(Mip, Slice);
+                for (Uint32 y = 0; y < MipProps.LogicalHeight; ++y)
+                {
+                    const auto* pRow    = static_cast<const Uint8*>(SubRes.pData) + SubRes.Stride * y;
+                    const auto* pRefRow = static_cast<const Uint8*>(RefSubRes.pData) + RefSubRes.Stride * y;
+                    ASSERT_EQ(memcmp(pRow, pRefRow, static_cast<size_t>(MipProps.RowSize)), 0) << "Slice " << Slice << ", mip " << Mip << ", row " << y;
+                }
+            }
+        }
+
+        // Loading the slices in the thread pool must produce the same texture
+        for (Uint32 Iteration = 0; Iteration < 4; ++Iteration)
+        {
+            RefCntAutoPtr<ITextureLoader> pLoader;
+            CreateTextureLoaderFromFiles(pFilePaths.data(), NumFiles, RESOURCE_DIM_TEX_2D_ARRAY, LoadInfo, pThreadPool, &pLoader);
+            ASSERT_TRUE(pLoader);
+
+            const auto& Desc = pLoader->GetTextureDesc();
+            ASSERT_EQ(Desc.Width, RefDesc.Width);
+            ASSERT_EQ(Desc.Height, RefDesc.Height);
+            ASSERT_EQ(Desc.ArraySize, RefDesc.ArraySize);
+            ASSERT_EQ(Desc.MipLevels, RefDesc.MipLevels);
+            ASSERT_EQ(Desc.Format, RefDesc.Format);
+            EXPECT_STREQ(Desc.Name, RefDesc.Name);
+
+            for (Uint32 Slice = 0; Slice < NumFiles; ++Slice)
+            {
+                for (Uint32 Mip = 0; Mip < Desc.MipLevels; ++Mip)
+                {
+                    const auto  MipProps  = GetMipLevelProperties(Desc, Mip);
+                    const auto& SubRes    = pLoader->GetSubresourceData(Mip, Slice);
+                    const auto& RefSubRes = pRefLoader->GetSubresourceData(Mip, Slice);
+                    for (Uint32 y = 0; y < MipProps.LogicalHeight; ++y)
+                    {
+                        const auto* pRow    = static_cast<const Uint8*>(SubRes.pData) + SubRes.Stride * y;
+                        const auto* pRefRow = static_cast<const Uint8*>(RefSubRes.pData) + RefSubRes.Stride * y;
+                        ASSERT_EQ(memcmp(pRow, pRefRow, static_cast<size_t>(MipProps.RowSize)), 0) << "Slice " << Slice << ", mip " << Mip << ", row " << y;
+                    }
+                }
+            }
+        }
+    }
+}
+
+} // namespace
@@ -26,11 +26,17 @@
 
 #include "../interface/TextureUtilities.h"
 
+#include <algorithm>
+#include <array>
 #include <limits>
+#include <cmath>
+#include <utility>
+#include <vector>
 
 #include "gtest/gtest.h"
 
 #include "GraphicsAccessories.hpp"
+#include "ThreadPool.hpp"
 
 using namespace Diligent;
 
@@ -675,4 +681,587 @@ TEST(Tools_TextureUtilities, PremultiplyAlphaFloat)
     TestPremultiplyAlpha<float>(VT_FLOAT32);
 }
 
+TEST(Tools_TextureUtilities, ComputeAlphaCoverage)
+{
+    // clang-format off
+    std::vector<Uint8> Pixels =
+    {
+        1, 2,   0,    3, 4, 127,    5, 6, 128,    0,
+        7, 8, 255,    9, 1, 200,    2, 3,  64,    0
+    };
+    // clang-format on
+
+    AlphaCoverageAttribs Attribs;
+    Attribs.Width          = 3;
+    Attribs.Height         = 2;
+    Attribs.pPixels        = Pixels.data();
+    Attribs.Stride         = 10;
+    Attribs.ComponentCount = 3;
+    Attribs.AlphaCutoff    = 0.5f;
+    EXPECT_FLOAT_EQ(ComputeAlphaCoverage(Attribs), 3.f / 6.f);
+
+    Attribs.AlphaCutoff = 1.f;
+    EXPECT_FLOAT_EQ(ComputeAlphaCoverage(Attribs), 1.f / 6.f);
+
+    Attribs.AlphaCutoff = 0.1f;
+    EXPECT_FLOAT_EQ(ComputeAlphaCoverage(Attribs), 5.f / 6.f);
+
+    // Scaling alpha by 2 makes 127 pass the 0.5 threshold
+    Attribs.AlphaCutoff = 0.5f;
+    EXPECT_GT(ScaleAlphaToCoverage(Attribs, 4.f / 6.f), 1.f);
+    EXPECT_FLOAT_EQ(ComputeAlphaCoverage(Attribs), 4.f / 6.f);
+    EXPECT_EQ(Pixels[2], 0);
+    EXPECT_EQ(Pixels[12], 255);
+    // Color components must not be affected
+    EXPECT_EQ(Pixels[3], 3);
+    EXPECT_EQ(Pixels[4], 4);
+    // Padding must not be affected
+    EXPECT_EQ(Pixels[9], 0);
+    EXPECT_EQ(Pixels[19], 0);
+}
+
+TEST(Tools_TextureUtilities, AlphaCoveragePreservingMips)
+{
+    // Foliage-like mask: sparse soft-edged blobs produced by thresholding bilinearly interpolated value noise.
+    constexpr Uint32 Size        = 256;
+    constexpr Uint32 CellSize    = 4;
+    constexpr Uint32 NumCells    = Size / CellSize + 1;
+    constexpr float  AlphaCutoff = 0.5f;
+
+    std::vector<float> Noise(NumCells * NumCells);
+    Uint32             Seed = 0x12345u;
+    for (auto& Val : Noise)
+    {
+        Seed = Seed * 1664525u + 1013904223u;
+        Val  = static_cast<float>(Seed >> 8u) / static_cast<float>(1u << 24u);
+    }
+
+    std::vector<std::vector<Uint8>> Mips(1, std::vector<Uint8>(Size * Size * 4));
+    for (Uint32 y = 0; y < Size; ++y)
+    {
+        for (Uint32 x = 0; x < Size; ++x)
+        {
+            const auto cx = x / CellSize;
+            const auto cy = y / CellSize;
+            const auto fx = static_cast<float>(x % CellSize) / CellSize;
+            const auto fy = static_cast<float>(y % CellSize) / CellSize;
+
+            const auto Val =
+                (Noise[cy * NumCells + cx] * (1 - fx) + Noise[cy * NumCells + cx + 1] * fx) * (1 - fy) +
+                (Noise[(cy + 1) * NumCells + cx] * (1 - fx) + Noise[(cy + 1) * NumCells + cx + 1] * fx) * fy;
+            const auto Alpha = std::min(std::max((Val - 0.7f) * 4.f + 0.5f, 0.f), 1.f);
+
+            auto* pPixel = &Mips[0][(y * Size + x) * 4];
+            pPixel[0]    = static_cast<Uint8>(x);
+            pPixel[1]    = static_cast<Uint8>(y);
+            pPixel[2]    = 0;
+            pPixel[3]    = static_cast<Uint8>(Alpha * 255.f + 0.5f);
+        }
+    }
+
+    AlphaCoverageAttribs Attribs;
+    Attribs.Width          = Size;
+    Attribs.Height         = Size;
+    Attribs.pPixels        = Mips[0].data();
+    Attribs.Stride         = Size * 4;
+    Attribs.ComponentCount = 4;
+    Attribs.AlphaCutoff    = AlphaCutoff;
+
+    const auto TargetCoverage = ComputeAlphaCoverage(Attribs);
+    EXPECT_GT(TargetCoverage, 0.1f);
+    EXPECT_LT(TargetCoverage, 0.5f);
+
+    for (Uint32 MipSize = Size / 2; MipSize >= 16; MipSize /= 2)
+    {
+        // Box-filter the previous unscaled level
+        const auto& FineMip = Mips.back();
+        const auto  FineSize = MipSize * 2;
+
+        std::vector<Uint8> Mip(MipSize * MipSize * 4);
+        for (Uint32 y = 0; y < MipSize; ++y)
+        {
+            for (Uint32 x = 0; x < MipSize; ++x)
+            {
+                for (Uint32 c = 0; c < 4; ++c)
+                {
+                    const Uint32 Sum =
+                        FineMip[((y * 2 + 0) * FineSize + x * 2 + 0) * 4 + c] +
+                        FineMip[((y * 2 + 0) * FineSize + x * 2 + 1) * 4 + c] +
+                        FineMip[((y * 2 + 1) * FineSize + x * 2 + 0) * 4 + c] +
+                        FineMip[((y * 2 + 1) * FineSize + x * 2 + 1) * 4 + c];
+                    Mip[(y * MipSize + x) * 4 + c] = static_cast<Uint8>((Sum + 2) / 4);
+                }
+            }
+        }
+        Mips.push_back(Mip);
+
+        Attribs.Width   = MipSize;
+        Attribs.Height  = MipSize;
+        Attribs.pPixels = Mip.data();
+        Attribs.Stride  = MipSize * 4;
+
+        const auto FilteredCoverage = ComputeAlphaCoverage(Attribs);
+        ScaleAlphaToCoverage(Attribs, TargetCoverage);
+        const auto ScaledCoverage = ComputeAlphaCoverage(Attribs);
+        EXPECT_NEAR(ScaledCoverage, TargetCoverage, 0.02f) << "Mip size: " << MipSize << ", filtered coverage: " << FilteredCoverage;
+        if (MipSize <= Size / 4)
+        {
+            // Make sure that the test is meaningful: plain box filter does not preserve the coverage
+            EXPECT_GT(std::abs(FilteredCoverage - TargetCoverage), 0.02f) << "Mip size: " << MipSize;
+        }
+    }
+}
+
+// Bumpy tangent-space normal field: random normals tilted by up to ~40 degrees.
+std::vector<Uint8> GenerateBumpyNormalMap(Uint32 Size, Uint32 NumComponents)
+{
+    std::vector<Uint8> Normals(Size * Size * NumComponents);
+    Uint32             Seed = 0x9876u;
+
+    const auto Random = [&Seed]() {
+        Seed = Seed * 1664525u + 1013904223u;
+        return static_cast<float>(Seed >> 8u) / static_cast<float>(1u << 24u) * 2.f - 1.f;
+    };
+    for (Uint32 i = 0; i < Size * Size; ++i)
+    {
+        float N[] = {Random() * 0.8f, Random() * 0.8f, 1.f};
+
+        const auto Len = std::sqrt(N[0] * N[0] + N[1] * N[1] + N[2] * N[2]);
+        for (Uint32 c = 0; c < NumComponents; ++c)
+            Normals[i * NumComponents + c] = c < 3 ? static_cast<Uint8>((N[c] / Len * 0.5f + 0.5f) * 255.f + 0.5f) : static_cast<Uint8>(i);
+    }
+    return Normals;
+}
+
+float DecodeNormalLength(const Uint8* pPixel, Uint32 NumComponents)
+{
+    const auto X = pPixel[0] / 255.f * 2.f - 1.f;
+    const auto Y = pPixel[1] / 255.f * 2.f - 1.f;
+    const auto Z = NumComponents >= 3 ? pPixel[2] / 255.f * 2.f - 1.f : std::sqrt(std::max(1.f - X * X - Y * Y, 0.f));
+    return std::sqrt(X * X + Y * Y + Z * Z);
+}
+
+void TestNormalMapMips(Uint32 NumComponents)
+{
+    constexpr Uint32 Size = 64;
+
+    std::vector<Uint8> FineMip = GenerateBumpyNormalMap(Size, NumComponents);
+    for (Uint32 MipSize = Size / 2; MipSize >= 1; MipSize /= 2)
+    {
+        const auto FineSize = MipSize * 2;
+
+        std::vector<Uint8> Mip(MipSize * MipSize * NumComponents);
+
+        NormalMapMipLevelAttribs Attribs;
+        Attribs.FineMipWidth    = FineSize;
+        Attribs.FineMipHeight   = FineSize;
+        Attribs.pFineMipData    = FineMip.data();
+        Attribs.FineMipStride   = FineSize * NumComponents;
+        Attribs.pCoarseMipData  = Mip.data();
+        Attribs.CoarseMipStride = MipSize * NumComponents;
+        Attribs.ComponentCount  = NumComponents;
+        ComputeNormalMapMipLevel(Attribs);
+
+        float MinBoxLen = 1;
+        for (Uint32 y = 0; y < MipSize; ++y)
+        {
+            for (Uint32 x = 0; x < MipSize; ++x)
+            {
+                const auto* pPixel = &Mip[(y * MipSize + x) * NumComponents];
+                if (NumComponents >= 3)
+                {
+                    EXPECT_NEAR(DecodeNormalLength(pPixel, NumComponents), 1.f, 0.015f) << "Mip size: " << MipSize << ", x: " << x << ", y: " << y;
+                }
+                else
+                {
+                    // Z is reconstructed, so X and Y must remain inside the unit circle
+                    const auto X = pPixel[0] / 255.f * 2.f - 1.f;
+                    const auto Y = pPixel[1] / 255.f * 2.f - 1.f;
+                    EXPECT_LE(X * X + Y * Y, 1.f + 0.015f) << "Mip size: " << MipSize << ", x: " << x << ", y: " << y;
+                }
+
+                if (NumComponents >= 3)
+                {
+                    // Plain box average of the same footprint
+                    float Box[3] = {};
+                    for (Uint32 i = 0; i < 4; ++i)
+                    {
+                        const auto* pFine = &FineMip[((y * 2 + i / 2) * FineSize + x * 2 + i % 2) * NumComponents];
+                        for (Uint32 c = 0; c < 3; ++c)
+                            Box[c] += (pFine[c] / 255.f * 2.f - 1.f) / 4.f;
+                    }
+                    MinBoxLen = std::min(MinBoxLen, std::sqrt(Box[0] * Box[0] + Box[1] * Box[1] + Box[2] * Box[2]));
+                }
+            }
+        }
+
+        if (NumComponents >= 3 && MipSize == Size / 2)
+        {
+            // Make sure that the test is meaningful: box-filtered normals are considerably shorter
+            EXPECT_LT(MinBoxLen, 0.95f);
+        }
+
+        FineMip.swap(Mip);
+    }
+}
+
+TEST(Tools_TextureUtilities, NormalMapMips)
+{
+    TestNormalMapMips(2);
+    TestNormalMapMips(3);
+    TestNormalMapMips(4);
+}
+
+TEST(Tools_TextureUtilities, NormalVarianceToRoughness)
+{
+    constexpr Uint32 Size      = 64;
+    constexpr Uint8  Roughness = 77; // ~0.3
+
+    const std::vector<Uint8> BumpyNormals = GenerateBumpyNormalMap(Size, 4);
+    const std::vector<Uint8> FlatNormals  = [&]() {
+        std::vector<Uint8> Normals(Size * Size * 4, 128);
+        for (Uint32 i = 0; i < Size * Size; ++i)
+            Normals[i * 4 + 2] = 255;
+        return Normals;
+    }();
+
+    const auto ApplyNormalVariance = [&](const std::vector<Uint8>& Normals, Uint32 MipSize) {
+        // Metallic-roughness layout: R - occlusion, G - roughness, B - metallic
+        std::vector<Uint8> Mip(MipSize * MipSize * 4);
+        for (Uint32 i = 0; i < MipSize * MipSize; ++i)
+        {
+            Mip[i * 4 + 0] = 10;
+            Mip[i * 4 + 1] = Roughness;
+            Mip[i * 4 + 2] = 20;
+            Mip[i * 4 + 3] = 30;
+        }
+
+        NormalVarianceToRoughnessAttribs Attribs;
+        Attribs.NormalMapWidth          = Size;
+        Attribs.NormalMapHeight         = Size;
+        Attribs.pNormalMapPixels        = Normals.data();
+        Attribs.NormalMapStride         = Size * 4;
+        Attribs.NormalMapComponentCount = 4;
+        Attribs.Width                   = MipSize;
+        Attribs.Height                  = MipSize;
+        Attribs.pPixels                 = Mip.data();
+        Attribs.Stride                  = MipSize * 4;
+        Attribs.ComponentCount          = 4;
+        Attribs.RoughnessComponent      = 1;
+        AddNormalVarianceToRoughness(Attribs);
+
+        Uint32 MinRoughness = 255;
+        Uint32 MaxRoughness = 0;
+        for (Uint32 i = 0; i < MipSize * MipSize; ++i)
+        {
+            EXPECT_EQ(Mip[i * 4 + 0], 10);
+            EXPECT_EQ(Mip[i * 4 + 2], 20);
+            EXPECT_EQ(Mip[i * 4 + 3], 30);
+            MinRoughness = std::min(MinRoughness, Uint32{Mip[i * 4 + 1]});
+            MaxRoughness = std::max(MaxRoughness, Uint32{Mip[i * 4 + 1]});
+        }
+        return std::make_pair(MinRoughness, MaxRoughness);
+    };
+
+    // Each texel of the most detailed level covers a single normal
+    const auto Level0 = ApplyNormalVariance(BumpyNormals, Size);
+    EXPECT_EQ(Level0.first, Roughness);
+    EXPECT_EQ(Level0.second, Roughness);
+
+    Uint32 PrevRoughness = Roughness;
+    for (Uint32 MipSize = Size / 2; MipSize >= 1; MipSize /= 4)
+    {
+        const auto Bumpy = ApplyNormalVariance(BumpyNormals, MipSize);
+        EXPECT_GT(Bumpy.first, PrevRoughness) << "Mip size: " << MipSize;
+        PrevRoughness = Bumpy.first;
+
+        const auto Flat = ApplyNormalVariance(FlatNormals, MipSize);
+        EXPECT_EQ(Flat.first, Roughness) << "Mip size: " << MipSize;
+        EXPECT_EQ(Flat.second, Roughness) << "Mip size: " << MipSize;
+    }
+}
+
+
+template <typename CompType>
+ImageContentInfo AnalyzeTestImage(const std::vector<CompType>& Pixels, Uint32 Width, Uint32 Height, Uint32 NumComponents, VALUE_TYPE ComponentType, IThreadPool* pThreadPool = nullptr)
+{
+    ImageContentAnalysisAttribs Attribs;
+    Attribs.Width          = Width;
+    Attribs.Height         = Height;
+    Attribs.pPixels        = Pixels.data();
+    Attribs.Stride         = Width * NumComponents * sizeof(CompType);
+    Attribs.ComponentCount = NumComponents;
+    Attribs.ComponentType  = ComponentType;
+    Attribs.pThreadPool    = pThreadPool;
+    return AnalyzeImageContent(Attribs);
+}
+
+TEST(Tools_TextureUtilities, AnalyzeImageContent)
+{
+    constexpr Uint32 Width  = 37;
+    constexpr Uint32 Height = 150;
+
+    // Generates an RGBA8 image whose pixels are produced by the callback
+    const auto MakeImage = [&](Uint32 NumComponents, const auto& GetPixel) {
+        std::vector<Uint8> Pixels(Width * Height * NumComponents);
+        for (Uint32 i = 0; i < Width * Height; ++i)
+        {
+            const auto Pixel = GetPixel(i);
+            for (Uint32 c = 0; c < NumComponents; ++c)
+                Pixels[i * NumComponents + c] = Pixel[c];
+        }
+        return Pixels;
+    };
+
+    // Grayscale, opaque
+    {
+        const auto Pixels = MakeImage(4, [](Uint32 i) { return std::array<Uint8, 4>{Uint8(i), Uint8(i), Uint8(i), 255}; });
+        const auto Info   = AnalyzeTestImage(Pixels, Width, Height, 4, VT_UINT8);
+        EXPECT_EQ(Info.NumComponents, 4u);
+        EXPECT_TRUE(Info.IsGrayscale);
+        EXPECT_TRUE(Info.IsOpaque);
+        EXPECT_TRUE(Info.HasBinaryAlpha);
+        EXPECT_EQ(Info.ConstantComponents, 8u);
+        EXPECT_EQ(Info.MinValues[0], 0.f);
+        EXPECT_EQ(Info.MaxValues[0], 1.f);
+        EXPECT_EQ(Info.MinValues[3], 1.f);
+    }
+
+    // Grayscale, binary alpha; a single pixel with different G breaks the grayscale
+    {
+        auto Pixels = MakeImage(4, [](Uint32 i) { return std::array<Uint8, 4>{Uint8(i / 2), Uint8(i / 2), Uint8(i / 2), Uint8((i % 3) == 0 ? 0 : 255)}; });
+        auto Info   = AnalyzeTestImage(Pixels, Width, Height, 4, VT_UINT8);
+        EXPECT_TRUE(Info.IsGrayscale);
+        EXPECT_FALSE(Info.IsOpaque);
+        EXPECT_TRUE(Info.HasBinaryAlpha);
+        EXPECT_EQ(Info.ConstantComponents, 0u);
+
+        Pixels[(Width * (Height - 1) + 5) * 4 + 1] ^= 1;
+        Info = AnalyzeTestImage(Pixels, Width, Height, 4, VT_UINT8);
+        EXPECT_FALSE(Info.IsGrayscale);
+    }
+
+    // Color, non-binary alpha, constant B
+    {
+        const auto Pixels = MakeImage(4, [](Uint32 i) { return std::array<Uint8, 4>{Uint8(16 + i % 64), Uint8(i * 3), 77, Uint8(i % 128)}; });
+        const auto Info   = AnalyzeTestImage(Pixels, Width, Height, 4, VT_UINT8);
+        EXPECT_FALSE(Info.IsGrayscale);
+        EXPECT_FALSE(Info.IsOpaque);
+        EXPECT_FALSE(Info.HasBinaryAlpha);
+        EXPECT_EQ(Info.ConstantComponents, 4u);
+        EXPECT_EQ(Info.MinValues[0], 16.f / 255.f);
+        EXPECT_EQ(Info.MaxValues[0], 79.f / 255.f);
+        EXPECT_EQ(Info.MinValues[2], 77.f / 255.f);
+        EXPECT_EQ(Info.MaxValues[2], 77.f / 255.f);
+        EXPECT_EQ(Info.MaxValues[3], 127.f / 255.f);
+    }
+
+    // Images without alpha are opaque; grayscale requires three components
+    {
+        const auto Pixels = MakeImage(2, [](Uint32 i) { return std::array<Uint8, 4>{Uint8(i), Uint8(i), 0, 0}; });
+        const auto Info   = AnalyzeTestImage(Pixels, Width, Height, 2, VT_UINT8);
+        EXPECT_EQ(Info.NumComponents, 2u);
+        EXPECT_FALSE(Info.IsGrayscale);
+        EXPECT_TRUE(Info.IsOpaque);
+        EXPECT_TRUE(Info.HasBinaryAlpha);
+    }
+}
+
+TEST(Tools_TextureUtilities, AnalyzeImageContentTypes)
+{
+    constexpr Uint32 Width  = 19;
+    constexpr Uint32 Height = 200;
+
+    std::vector<Uint16> Pixels16(Width * Height * 4);
+    std::vector<float>  PixelsF(Width * Height * 4);
+    for (Uint32 i = 0; i < Width * Height; ++i)
+    {
+        const Uint16 Gray = static_cast<Uint16>(i * 10);
+        const Uint16 A    = (i % 2) ? 65535 : 0;
+        for (Uint32 c = 0; c < 3; ++c)
+            Pixels16[i * 4 + c] = Gray;
+        Pixels16[i * 4 + 3] = A;
+
+        PixelsF[i * 4 + 0] = static_cast<float>(i) * 0.5f;
+        PixelsF[i * 4 + 1] = -1.f;
+        PixelsF[i * 4 + 2] = static_cast<float>(i) * 0.5f;
+        PixelsF[i * 4 + 3] = 1.f;
+    }
+
+    auto pThreadPool = CreateThreadPool(ThreadPoolCreateInfo{4});
+    ASSERT_TRUE(pThreadPool);
+
+    for (auto* pPool : {static_cast<IThreadPool*>(nullptr), pThreadPool.RawPtr()})
+    {
+        const auto Info16 = AnalyzeTestImage(Pixels16, Width, Height, 4, VT_UINT16, pPool);
+        EXPECT_TRUE(Info16.IsGrayscale);
+        EXPECT_FALSE(Info16.IsOpaque);
+        EXPECT_TRUE(Info16.HasBinaryAlpha);
+        EXPECT_EQ(Info16.MinValues[0], 0.f);
+        EXPECT_EQ(Info16.MaxValues[0], static_cast<float>((Width * Height - 1) * 10) / 65535.f);
+
+        const auto InfoF = AnalyzeTestImage(PixelsF, Width, Height, 4, VT_FLOAT32, pPool);
+        EXPECT_FALSE(InfoF.IsGrayscale);
+        EXPECT_TRUE(InfoF.IsOpaque);
+        EXPECT_EQ(InfoF.ConstantComponents, 2u | 8u);
+        EXPECT_EQ(InfoF.MinValues[1], -1.f);
+        EXPECT_EQ(InfoF.MaxValues[2], static_cast<float>(Width * Height - 1) * 0.5f);
+    }
+}
+
+TEST(Tools_TextureUtilities, DistanceFieldCircle)
+{
+    constexpr Uint32 Width   = 67;
+    constexpr Uint32 Height  = 45;
+    constexpr float  CenterX = 30.f;
+    constexpr float  CenterY = 21.f;
+    constexpr float  Radius  = 13.f;
+
+    // The circle is stored in the second component of the RG image
+    std::vector<Uint8> Pixels(Width * Height * 2);
+    for (Uint32 y = 0; y < Height; ++y)
+    {
+        for (Uint32 x = 0; x < Width; ++x)
+        {
+            const float Dist = std::hypot(static_cast<float>(x) + 0.5f - CenterX, static_cast<float>(y) + 0.5f - CenterY);
+
+            Pixels[(y * Width + x) * 2 + 0] = 255;
+            Pixels[(y * Width + x) * 2 + 1] = Dist < Radius ? 255 : 0;
+        }
+    }
+
+    auto pThreadPool = CreateThreadPool(ThreadPoolCreateInfo{4});
+    ASSERT_TRUE(pThreadPool);
+
+    std::vector<float> RefDistances;
+    for (auto* pPool : {static_cast<IThreadPool*>(nullptr), pThreadPool.RawPtr()})
+    {
+        std::vector<float> Distances(Width * Height);
+
+        DistanceFieldAttribs Attribs;
+        Attribs.SrcWidth          = Width;
+        Attribs.SrcHeight         = Height;
+        Attribs.pSrcPixels        = Pixels.data();
+        Attribs.SrcStride         = Width * 2;
+        Attribs.SrcComponentCount = 2;
+        Attribs.SrcComponentType  = VT_UINT8;
+        Attribs.FirstComponent    = 1;
+        Attribs.DstWidth          = Width;
+        Attribs.DstHeight         = Height;
+        Attribs.pDstPixels        = Distances.data();
+        Attribs.DstStride         = Width * sizeof(float);
+        Attribs.DstComponentType  = VT_FLOAT32;
+        Attribs.pThreadPool       = pPool;
+        ComputeDistanceField(Attribs);
+
+        for (Uint32 y = 0; y < Height; ++y)
+        {
+            for (Uint32 x = 0; x < Width; ++x)
+            {
+                const float RefDist = Radius - std::hypot(static_cast<float>(x) + 0.5f - CenterX, static_cast<float>(y) + 0.5f - CenterY);
+                const float Dist    = Distances[y * Width + x];
+                EXPECT_NEAR(Dist, RefDist, 0.75f) << "x=" << x << " y=" << y;
+                EXPECT_EQ(Dist > 0, RefDist > 0) << "x=" << x << " y=" << y;
+            }
+        }
+
+        if (RefDistances.empty())
+            RefDistances = std::move(Distances);
+        else
+            EXPECT_EQ(Distances, RefDistances);
+    }
+}
+
+TEST(Tools_TextureUtilities, DistanceFieldDownscale)
+{
+    constexpr Uint32 SrcSize   = 128;
+    constexpr Uint32 DstSize   = 32;
+    constexpr Uint32 EdgeX     = 50;
+    constexpr float  Spread    = 4;
+    constexpr Uint32 DstStride = DstSize + 4;
+
+    // Half-plane x < EdgeX
+    std::vector<Uint16> Pixels(SrcSize * SrcSize);
+    for (Uint32 y = 0; y < SrcSize; ++y)
+    {
+        for (Uint32 x = 0; x < SrcSize; ++x)
+            Pixels[y * SrcSize + x] = x < EdgeX ? 65535 : 0;
+    }
+
+    std::vector<Uint8> Values(DstStride * DstSize);
+
+    DistanceFieldAttribs Attribs;
+    Attribs.SrcWidth          = SrcSize;
+    Attribs.SrcHeight         = SrcSize;
+    Attribs.pSrcPixels        = Pixels.data();
+    Attribs.SrcStride         = SrcSize * sizeof(Uint16);
+    Attribs.SrcComponentCount = 1;
+    Attribs.SrcComponentType  = VT_UINT16;
+    Attribs.Spread            = Spread;
+    Attribs.DstWidth          = DstSize;
+    Attribs.DstHeight         = DstSize;
+    Attribs.pDstPixels        = Values.data();
+    Attribs.DstStride         = DstStride;
+    Attribs.DstComponentType  = VT_UINT8;
+    ComputeDistanceField(Attribs);
+
+    constexpr float DstEdgeX = static_cast<float>(EdgeX * DstSize) / static_cast<float>(SrcSize);
+    for (Uint32 y = 0; y < DstSize; ++y)
+    {
+        for (Uint32 x = 0; x < DstSize; ++x)
+        {
+            const float RefDist  = DstEdgeX - (static_cast<float>(x) + 0.5f);
+            const float RefValue = std::min(std::max(0.5f + RefDist / (2.f * Spread), 0.f), 1.f);
+            EXPECT_NEAR(static_cast<float>(Values[y * DstStride + x]) / 255.f, RefValue, 1.f / 255.f) << "x=" << x << " y=" << y;
+        }
+    }
+}
+
+TEST(Tools_TextureUtilities, DistanceFieldChannels)
+{
+    constexpr Uint32 Width  = 40;
+    constexpr Uint32 Height = 30;
+    constexpr Uint32 EdgeX  = 12;
+    constexpr Uint32 EdgeY  = 17;
+
+    // Component 1 is the half-plane x >= EdgeX, component 2 is the half-plane y < EdgeY
+    std::vector<float> Pixels(Width * Height * 3);
+    for (Uint32 y = 0; y < Height; ++y)
+    {
+        for (Uint32 x = 0; x < Width; ++x)
+        {
+            Pixels[(y * Width + x) * 3 + 0] = 0;
+            Pixels[(y * Width + x) * 3 + 1] = x >= EdgeX ? 1.f : 0.25f;
+            Pixels[(y * Width + x) * 3 + 2] = y < EdgeY ? 0.75f : 0.f;
+        }
+    }
+
+    std::vector<float> Distances(Width * Height * 2);
+
+    DistanceFieldAttribs Attribs;
+    Attribs.SrcWidth          = Width;
+    Attribs.SrcHeight         = Height;
+    Attribs.pSrcPixels        = Pixels.data();
+    Attribs.SrcStride         = Width * 3 * sizeof(float);
+    Attribs.SrcComponentCount = 3;
+    Attribs.SrcComponentType  = VT_FLOAT32;
+    Attribs.FirstComponent    = 1;
+    Attribs.NumChannels       = 2;
+    Attribs.DstWidth          = Width;
+    Attribs.DstHeight         = Height;
+    Attribs.pDstPixels        = Distances.data();
+    Attribs.DstStride         = Width * 2 * sizeof(float);
+    Attribs.DstComponentType  = VT_FLOAT32;
+    ComputeDistanceField(Attribs);
+
+    for (Uint32 y = 0; y < Height; ++y)
+    {
+        for (Uint32 x = 0; x < Width; ++x)
+        {
+            EXPECT_EQ(Distances[(y * Width + x) * 2 + 0], static_cast<float>(x) + 0.5f - static_cast<float>(EdgeX)) << "x=" << x << " y=" << y;
+            EXPECT_EQ(Distances[(y * Width + x) * 2 + 1], static_cast<float>(EdgeY) - static_cast<float>(y) - 0.5f) << "x=" << x << " y=" << y;
+        }
+    }
+}
+
 } // namespace
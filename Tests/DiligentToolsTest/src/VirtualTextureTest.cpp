@@ -0,0 +1,394 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "../interface/VirtualTexture.h"
+#include "../interface/Image.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "DataBlobImpl.hpp"
+#include "ThreadPool.hpp"
+
+using namespace Diligent;
+
+namespace
+{
+
+// Creates an 8-bit image, where the value of every component is computed by Func(x, y, c).
+template <typename FuncType>
+RefCntAutoPtr<Image> CreateTestImage(Uint32 Width, Uint32 Height, Uint32 NumComponents, FuncType&& Func)
+{
+    ImageDesc Desc;
+    Desc.Width         = Width;
+    Desc.Height        = Height;
+    Desc.ComponentType = VT_UINT8;
+    Desc.NumComponents = NumComponents;
+    Desc.RowStride     = Width * NumComponents;
+
+    auto   pPixels = DataBlobImpl::Create(size_t{Desc.RowStride} * Height);
+    Uint8* pData   = static_cast<Uint8*>(pPixels->GetDataPtr());
+    for (Uint32 y = 0; y < Height; ++y)
+    {
+        for (Uint32 x = 0; x < Width; ++x)
+        {
+            for (Uint32 c = 0; c < NumComponents; ++c)
+                pData[(size_t{y} * Width + x) * NumComponents + c] = static_cast<Uint8>(Func(x, y, c));
+        }
+    }
+
+    RefCntAutoPtr<Image> pImage;
+    Image::CreateFromMemory(Desc, pPixels, &pImage);
+    return pImage;
+}
+
+VirtualTextureHeader GetHeader(IDataBlob* pPageFile)
+{
+    VirtualTextureHeader Header;
+    memcpy(&Header, pPageFile->GetConstDataPtr(), sizeof(Header));
+    return Header;
+}
+
+// Decodes the page of the tile and returns the texels of the full page, including borders.
+std::vector<Uint8> DecodeTile(IDataBlob* pPageFile, Uint32 Mip, Uint32 TileX, Uint32 TileY, VirtualTexturePageEntry* pEntry = nullptr)
+{
+    const auto  Header   = GetHeader(pPageFile);
+    const auto* pData    = static_cast<const Uint8*>(pPageFile->GetConstDataPtr());
+    const auto  FullSize = Header.PageSize + Header.BorderSize * 2;
+
+    VirtualTexturePageEntry Entry;
+    EXPECT_TRUE(GetVirtualTexturePage(pData, pPageFile->GetSize(), pPageFile->GetSize(), Mip, TileX, TileY, Entry));
+    EXPECT_LE(Entry.Offset + Entry.Size, pPageFile->GetSize());
+    if (pEntry != nullptr)
+        *pEntry = Entry;
+
+    std::vector<Uint8> Texels(size_t{FullSize} * FullSize * 4);
+    EXPECT_TRUE(DecodeVirtualTexturePage(Header, Entry, pData + Entry.Offset, Texels.data()));
+    return Texels;
+}
+
+Uint8 TestPattern(Uint32 x, Uint32 y, Uint32 c)
+{
+    return static_cast<Uint8>((x * 7 + y * 13 + c * 61) & 0xFF);
+}
+
+TEST(Tools_VirtualTexture, Layout)
+{
+    auto pImage = CreateTestImage(100, 60, 2, TestPattern);
+
+    VirtualTextureBuildAttribs Attribs;
+    Attribs.pImage     = pImage;
+    Attribs.PageSize   = 32;
+    Attribs.BorderSize = 2;
+
+    RefCntAutoPtr<IDataBlob> pPageFile;
+    BuildVirtualTexture(Attribs, &pPageFile);
+    ASSERT_TRUE(pPageFile);
+
+    const auto Header = GetHeader(pPageFile);
+    EXPECT_EQ(Header.Magic, DILIGENT_VIRTUAL_TEXTURE_MAGIC);
+    EXPECT_EQ(Header.Version, DILIGENT_VIRTUAL_TEXTURE_VERSION);
+    EXPECT_EQ(Header.Format, Uint32{TEX_FORMAT_RG8_UNORM});
+    EXPECT_EQ(Header.Width, 100u);
+    EXPECT_EQ(Header.Height, 60u);
+    // 100x60 -> 50x30 -> 25x15
+    EXPECT_EQ(Header.MipLevels, 3u);
+    // 4x2 + 2x1 + 1x1
+    EXPECT_EQ(Header.NumTiles, 11u);
+
+    const auto* pData    = pPageFile->GetConstDataPtr();
+    const auto  FileSize = pPageFile->GetSize();
+
+    VirtualTexturePageEntry Entry;
+    EXPECT_TRUE(GetVirtualTexturePage(pData, FileSize, FileSize, 0, 3, 1, Entry));
+    EXPECT_FALSE(GetVirtualTexturePage(pData, FileSize, FileSize, 0, 4, 0, Entry));
+    EXPECT_FALSE(GetVirtualTexturePage(pData, FileSize, FileSize, 0, 0, 2, Entry));
+    EXPECT_FALSE(GetVirtualTexturePage(pData, FileSize, FileSize, 2, 1, 0, Entry));
+    EXPECT_FALSE(GetVirtualTexturePage(pData, FileSize, FileSize, 3, 0, 0, Entry));
+    // The tables are incomplete
+    EXPECT_FALSE(GetVirtualTexturePage(pData, sizeof(VirtualTextureHeader), FileSize, 0, 0, 0, Entry));
+
+    Attribs.MipLevels = 1;
+    RefCntAutoPtr<IDataBlob> pSingleMip;
+    BuildVirtualTexture(Attribs, &pSingleMip);
+    ASSERT_TRUE(pSingleMip);
+    EXPECT_EQ(GetHeader(pSingleMip).MipLevels, 1u);
+    EXPECT_EQ(GetHeader(pSingleMip).NumTiles, 8u);
+}
+
+TEST(Tools_VirtualTexture, PageBounds)
+{
+    auto pImage = CreateTestImage(64, 64, 4, TestPattern);
+
+    VirtualTextureBuildAttribs Attribs;
+    Attribs.pImage     = pImage;
+    Attribs.PageSize   = 32;
+    Attribs.BorderSize = 2;
+    Attribs.MipLevels  = 1;
+
+    RefCntAutoPtr<IDataBlob> pPageFile;
+    BuildVirtualTexture(Attribs, &pPageFile);
+    ASSERT_TRUE(pPageFile);
+
+    const auto Header   = GetHeader(pPageFile);
+    const auto FileSize = pPageFile->GetSize();
+    ASSERT_EQ(Header.NumTiles, 4u);
+
+    const size_t PageTableOffset = sizeof(VirtualTextureHeader) + sizeof(VirtualTextureMipLevel) * Header.MipLevels;
+    const size_t PagesOffset     = (PageTableOffset + sizeof(Uint32) * Header.NumTiles + 7) & ~size_t{7};
+    const size_t DataOffset      = PagesOffset + sizeof(VirtualTexturePageEntry) * Header.NumPages;
+
+    // The page data must be within the file size
+    VirtualTexturePageEntry Entry;
+    ASSERT_TRUE(GetVirtualTexturePage(pPageFile->GetConstDataPtr(), FileSize, FileSize, 0, 1, 1, Entry));
+    const auto PageEnd = Entry.Offset + Entry.Size;
+    EXPECT_TRUE(GetVirtualTexturePage(pPageFile->GetConstDataPtr(), FileSize, PageEnd, 0, 1, 1, Entry));
+    EXPECT_FALSE(GetVirtualTexturePage(pPageFile->GetConstDataPtr(), FileSize, PageEnd - 1, 0, 1, 1, Entry));
+
+    // A streamed file only provides the tables, and the page data is addressed within the whole file
+    {
+        std::vector<Uint8> Tables(static_cast<const Uint8*>(pPageFile->GetConstDataPtr()), static_cast<const Uint8*>(pPageFile->GetConstDataPtr()) + DataOffset);
+
+        VirtualTexturePageEntry StreamedEntry;
+        EXPECT_TRUE(GetVirtualTexturePage(Tables.data(), Tables.size(), FileSize, 0, 1, 1, StreamedEntry));
+        EXPECT_EQ(StreamedEntry.Offset, Entry.Offset);
+        EXPECT_EQ(StreamedEntry.Size, Entry.Size);
+        EXPECT_FALSE(GetVirtualTexturePage(Tables.data(), Tables.size() - 1, FileSize, 0, 1, 1, StreamedEntry));
+        EXPECT_FALSE(GetVirtualTexturePage(Tables.data(), Tables.size(), Tables.size(), 0, 1, 1, StreamedEntry));
+    }
+
+    // Corrupt the page entries
+
+    std::vector<Uint8> Data(static_cast<const Uint8*>(pPageFile->GetConstDataPtr()), static_cast<const Uint8*>(pPageFile->GetConstDataPtr()) + FileSize);
+
+    Uint32 Page = 0;
+    memcpy(&Page, &Data[PageTableOffset], sizeof(Page));
+    ASSERT_LT(Page, Header.NumPages);
+    auto* pEntry = &Data[PagesOffset + sizeof(VirtualTexturePageEntry) * Page];
+
+    const auto TestEntry = [&](Uint64 Offset, Uint32 Size) {
+        VirtualTexturePageEntry Corrupted;
+        memcpy(&Corrupted, pEntry, sizeof(Corrupted));
+        Corrupted.Offset = Offset;
+        Corrupted.Size   = Size;
+        memcpy(pEntry, &Corrupted, sizeof(Corrupted));
+        return GetVirtualTexturePage(Data.data(), Data.size(), Data.size(), 0, 0, 0, Entry);
+    };
+    EXPECT_TRUE(TestEntry(DataOffset, 0));
+    EXPECT_TRUE(TestEntry(FileSize - 16, 16));
+    EXPECT_FALSE(TestEntry(FileSize - 16, 17));
+    EXPECT_FALSE(TestEntry(FileSize + 1, 0));
+    EXPECT_FALSE(TestEntry(DataOffset - 1, 1));
+    EXPECT_FALSE(TestEntry(0, 16));
+    // Offset + Size must not wrap around
+    EXPECT_FALSE(TestEntry(~Uint64{0} - 4, 16));
+    EXPECT_FALSE(TestEntry(~Uint64{0}, 0xFFFFFFFFu));
+}
+
+TEST(Tools_VirtualTexture, Borders)
+{
+    constexpr Uint32 Width  = 100;
+    constexpr Uint32 Height = 70;
+    constexpr Uint32 Page   = 32;
+    constexpr Uint32 Border = 3;
+    constexpr Uint32 Full   = Page + Border * 2;
+
+    auto pImage = CreateTestImage(Width, Height, 4, TestPattern);
+
+    VirtualTextureBuildAttribs Attribs;
+    Attribs.pImage     = pImage;
+    Attribs.PageSize   = Page;
+    Attribs.BorderSize = Border;
+    Attribs.MipLevels  = 1;
+
+    RefCntAutoPtr<IDataBlob> pPageFile;
+    BuildVirtualTexture(Attribs, &pPageFile);
+    ASSERT_TRUE(pPageFile);
+
+    // Every texel of every page, including the borders, must match the source
+    // texel with coordinates clamped to the image edges.
+    for (Uint32 ty = 0; ty < 3; ++ty)
+    {
+        for (Uint32 tx = 0; tx < 4; ++tx)
+        {
+            const auto Texels = DecodeTile(pPageFile, 0, tx, ty);
+            for (Uint32 y = 0; y < Full; ++y)
+            {
+                for (Uint32 x = 0; x < Full; ++x)
+                {
+                    const auto sx = static_cast<Uint32>(std::min(std::max(int(tx * Page + x) - int(Border), 0), int(Width) - 1));
+                    const auto sy = static_cast<Uint32>(std::min(std::max(int(ty * Page + y) - int(Border), 0), int(Height) - 1));
+                    for (Uint32 c = 0; c < 4; ++c)
+                    {
+                        ASSERT_EQ(Texels[(y * Full + x) * 4 + c], TestPattern(sx, sy, c))
+                            << "tile (" << tx << ", " << ty << "), texel (" << x << ", " << y << "), component " << c;
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(Tools_VirtualTexture, ExpandRGB)
+{
+    auto pImage = CreateTestImage(16, 16, 3, TestPattern);
+
+    VirtualTextureBuildAttribs Attribs;
+    Attribs.pImage     = pImage;
+    Attribs.PageSize   = 16;
+    Attribs.BorderSize = 0;
+    Attribs.IsSRGB     = True;
+
+    RefCntAutoPtr<IDataBlob> pPageFile;
+    BuildVirtualTexture(Attribs, &pPageFile);
+    ASSERT_TRUE(pPageFile);
+
+    const auto Header = GetHeader(pPageFile);
+    EXPECT_EQ(Header.Format, Uint32{TEX_FORMAT_RGBA8_UNORM_SRGB});
+    EXPECT_EQ(Header.MipLevels, 1u);
+
+    const auto Texels = DecodeTile(pPageFile, 0, 0, 0);
+    for (Uint32 y = 0; y < 16; ++y)
+    {
+        for (Uint32 x = 0; x < 16; ++x)
+        {
+            for (Uint32 c = 0; c < 3; ++c)
+                EXPECT_EQ(Texels[(y * 16 + x) * 4 + c], TestPattern(x, y, c));
+            EXPECT_EQ(Texels[(y * 16 + x) * 4 + 3], 255);
+        }
+    }
+}
+
+TEST(Tools_VirtualTexture, ConstantPages)
+{
+    // The left half is red, the right half is a pattern, the bottom-left quarter is green
+    auto pImage = CreateTestImage(128, 128, 4, [](Uint32 x, Uint32 y, Uint32 c) -> Uint8 {
+        if (x >= 64)
+            return TestPattern(x, y, c);
+        if (y >= 64)
+            return c == 1 || c == 3 ? 255 : 0;
+        return c == 0 || c == 3 ? 255 : 0;
+    });
+
+    VirtualTextureBuildAttribs Attribs;
+    Attribs.pImage     = pImage;
+    Attribs.PageSize   = 16;
+    Attribs.BorderSize = 2;
+    Attribs.MipLevels  = 1;
+
+    RefCntAutoPtr<IDataBlob> pPageFile;
+    BuildVirtualTexture(Attribs, &pPageFile);
+    ASSERT_TRUE(pPageFile);
+
+    const auto Header = GetHeader(pPageFile);
+    EXPECT_EQ(Header.NumTiles, 64u);
+
+    // Tiles in columns 0-2 are constant. Column 3 borders with the pattern and
+    // rows 3 and 4 border with the other color.
+    // Constant pages: red + green; unique pages: 32 pattern tiles + 8 tiles in column 3 + 3 * 2 tiles in rows 3 and 4.
+    EXPECT_EQ(Header.NumPages, 2u + 32u + 8u + 6u);
+
+    VirtualTexturePageEntry RedEntry0, RedEntry1, GreenEntry, PatternEntry;
+    DecodeTile(pPageFile, 0, 0, 0, &RedEntry0);
+    DecodeTile(pPageFile, 0, 2, 2, &RedEntry1);
+    const auto GreenTexels = DecodeTile(pPageFile, 0, 1, 6, &GreenEntry);
+    DecodeTile(pPageFile, 0, 5, 5, &PatternEntry);
+
+    EXPECT_EQ(RedEntry0.Flags, VIRTUAL_TEXTURE_PAGE_FLAG_CONSTANT);
+    EXPECT_EQ(RedEntry0.Size, 4u);
+    EXPECT_EQ(RedEntry0.Offset, RedEntry1.Offset);
+    EXPECT_EQ(GreenEntry.Flags, VIRTUAL_TEXTURE_PAGE_FLAG_CONSTANT);
+    EXPECT_NE(GreenEntry.Offset, RedEntry0.Offset);
+    EXPECT_EQ(PatternEntry.Flags, VIRTUAL_TEXTURE_PAGE_FLAG_NONE);
+
+    for (size_t i = 0; i < GreenTexels.size(); i += 4)
+    {
+        EXPECT_EQ(GreenTexels[i + 0], 0);
+        EXPECT_EQ(GreenTexels[i + 1], 255);
+        EXPECT_EQ(GreenTexels[i + 2], 0);
+        EXPECT_EQ(GreenTexels[i + 3], 255);
+    }
+}
+
+TEST(Tools_VirtualTexture, CompressionAndThreading)
+{
+    // Smooth gradient compresses well
+    auto pImage = CreateTestImage(200, 150, 1, [](Uint32 x, Uint32 y, Uint32 c) {
+        return (x / 4 + y / 8) & 0xFF;
+    });
+
+    VirtualTextureBuildAttribs Attribs;
+    Attribs.pImage     = pImage;
+    Attribs.PageSize   = 32;
+    Attribs.BorderSize = 4;
+
+    RefCntAutoPtr<IDataBlob> pRaw;
+    BuildVirtualTexture(Attribs, &pRaw);
+    ASSERT_TRUE(pRaw);
+
+    Attribs.CompressPages = True;
+    RefCntAutoPtr<IDataBlob> pCompressed;
+    BuildVirtualTexture(Attribs, &pCompressed);
+    ASSERT_TRUE(pCompressed);
+    EXPECT_LT(pCompressed->GetSize(), pRaw->GetSize());
+
+    auto pThreadPool = CreateThreadPool(ThreadPoolCreateInfo{4});
+
+    Attribs.pThreadPool = pThreadPool;
+    RefCntAutoPtr<IDataBlob> pCompressedMT;
+    BuildVirtualTexture(Attribs, &pCompressedMT);
+    ASSERT_TRUE(pCompressedMT);
+    ASSERT_EQ(pCompressedMT->GetSize(), pCompressed->GetSize());
+    EXPECT_EQ(memcmp(pCompressedMT->GetConstDataPtr(), pCompressed->GetConstDataPtr(), pCompressed->GetSize()), 0);
+
+    const auto Header = GetHeader(pRaw);
+    EXPECT_EQ(Header.MipLevels, 4u);
+
+    bool AnyCompressed = false;
+    for (Uint32 Mip = 0; Mip < Header.MipLevels; ++Mip)
+    {
+        const Uint32 TilesX = ((Header.Width >> Mip) + Header.PageSize - 1) / Header.PageSize;
+        const Uint32 TilesY = ((Header.Height >> Mip) + Header.PageSize - 1) / Header.PageSize;
+        for (Uint32 ty = 0; ty < TilesY; ++ty)
+        {
+            for (Uint32 tx = 0; tx < TilesX; ++tx)
+            {
+                VirtualTexturePageEntry Entry;
+                const auto              RawTexels        = DecodeTile(pRaw, Mip, tx, ty);
+                const auto              CompressedTexels = DecodeTile(pCompressed, Mip, tx, ty, &Entry);
+                EXPECT_EQ(RawTexels, CompressedTexels);
+                AnyCompressed = AnyCompressed || (Entry.Flags & VIRTUAL_TEXTURE_PAGE_FLAG_COMPRESSED) != 0;
+            }
+        }
+    }
+    EXPECT_TRUE(AnyCompressed);
+}
+
+} // namespace
@@ -0,0 +1,122 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "TextureLoader.h"
+#include "ThreadPool.hpp"
+
+namespace Diligent
+{
+
+/// Describes a single texture to bake.
+struct TextureBakeJob
+{
+    /// Input image file path
+    std::string InputPath;
+
+    /// Output file path. Only DDS output is currently supported.
+    std::string OutputPath;
+
+    /// Texture name. LoadInfo.Name is set to this value when the texture is baked.
+    std::string Name;
+
+    /// Texture loading options that are applied to the input image.
+    /// Name and CacheDirectory members are ignored.
+    TextureLoadInfo LoadInfo;
+};
+
+/// Texture baking statistics.
+struct TextureBakeResult
+{
+    bool Succeeded = false;
+
+    /// Time spent loading and processing the texture, in seconds
+    double ProcessTime = 0;
+
+    /// Time spent writing the output file, in seconds
+    double WriteTime = 0;
+
+    /// Output file size, in bytes
+    Uint64 OutputSize = 0;
+};
+
+/// Parses the texture bake manifest.
+
+/// \param [in]  Json      - Manifest JSON source.
+/// \param [in]  InputDir  - Directory that relative input paths are resolved against.
+/// \param [in]  OutputDir - Directory that relative output paths are resolved against.
+/// \param [out] Jobs      - Parsed jobs are appended to this array.
+/// \return     true if the manifest has been parsed successfully, and false otherwise.
+///
+/// \remarks    The manifest has the following format:
+///
+///                 {
+///                     "Defaults": { <options> },
+///                     "Textures": [
+///                         { "Input": "Albedo.png", "Output": "Albedo.dds", <options> },
+///                         ...
+///                     ]
+///                 }
+///
+///             Options mirror the members of TextureLoadInfo: "Name", "MipLevels", "IsSRGB", "GenerateMips",
+///             "FlipVertically", "PremultiplyAlpha", "Format" (e.g. "RGBA8_UNORM"), "AlphaCutoff",
+///             "MipFilter" ("DEFAULT", "BOX_AVERAGE", "MOST_FREQUENT" or "NORMAL_MAP"),
+///             "Swizzle" (four characters from "rgba01", e.g. "rrr1"), "CompactFormat",
+///             "DistanceField" ("NONE", "ALPHA" or "ALL_COMPONENTS"), "DistanceFieldSpread" and
+///             "DistanceFieldDownscale".
+///             "CompactFormat" may only be false since the DDS output can't store the component
+///             mapping of a compact format.
+///             Options of a texture override the defaults. If "Output" is not specified, the input file
+///             name with the .dds extension is used. Unknown options are treated as errors.
+bool ParseTextureBakeManifest(const char*                  Json,
+                              const std::string&           InputDir,
+                              const std::string&           OutputDir,
+                              std::vector<TextureBakeJob>& Jobs);
+
+/// Loads the texture bake manifest from the file.
+
+/// \remarks    Relative input paths are resolved against the manifest directory.
+///             Relative output paths are resolved against OutputDir or, if it is empty,
+///             against the manifest directory.
+bool LoadTextureBakeManifest(const char*                  FilePath,
+                             const std::string&           OutputDir,
+                             std::vector<TextureBakeJob>& Jobs);
+
+/// Loads the input image of the job, processes it as CreateTextureLoaderFromFile does
+/// and writes the resulting texture with the full mip chain to the output file.
+/// Jobs with LoadInfo.CompactFormat set are rejected.
+TextureBakeResult BakeTexture(const TextureBakeJob& Job);
+
+/// Bakes all textures. If the thread pool is provided, textures are baked in parallel.
+/// The results are returned in the order of the jobs.
+std::vector<TextureBakeResult> BakeTextures(const std::vector<TextureBakeJob>& Jobs, IThreadPool* pThreadPool);
+
+} // namespace Diligent
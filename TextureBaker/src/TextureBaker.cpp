@@ -0,0 +1,351 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "TextureBaker.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+
+#include "json.hpp"
+
+#include "GraphicsAccessories.hpp"
+#include "FileSystem.hpp"
+#include "FileWrapper.hpp"
+#include "DataBlobImpl.hpp"
+#include "ParallelFor.hpp"
+
+// Windows.h defines CreateDirectory as CreateDirectoryA/W, which breaks FileSystem::CreateDirectory
+#ifdef CreateDirectory
+#    undef CreateDirectory
+#endif
+
+namespace Diligent
+{
+
+namespace
+{
+
+std::string ResolvePath(const std::string& Dir, const std::string& Path)
+{
+    if (Dir.empty() || Path.empty() || FileSystem::IsPathAbsolute(Path.c_str()))
+        return Path;
+
+    std::string ResolvedPath = Dir;
+    if (!FileSystem::IsSlash(ResolvedPath.back()))
+        ResolvedPath.push_back(FileSystem::SlashSymbol);
+    ResolvedPath += Path;
+    return ResolvedPath;
+}
+
+std::string ReplaceExtension(const std::string& Path, const char* Extension)
+{
+    const auto LastSlash = Path.find_last_of("/\\");
+    const auto LastDot   = Path.find_last_of('.');
+    if (LastDot == std::string::npos || (LastSlash != std::string::npos && LastDot < LastSlash))
+        return Path + Extension;
+    return Path.substr(0, LastDot) + Extension;
+}
+
+bool HasExtension(const std::string& Path, const char* Extension)
+{
+    const auto ExtLen = strlen(Extension);
+    if (Path.length() < ExtLen)
+        return false;
+    return std::equal(Path.end() - ExtLen, Path.end(), Extension, [](char c1, char c2) {
+        return std::tolower(static_cast<unsigned char>(c1)) == std::tolower(static_cast<unsigned char>(c2));
+    });
+}
+
+TEXTURE_FORMAT ParseTextureFormat(const std::string& Str)
+{
+    for (int Fmt = TEX_FORMAT_UNKNOWN + 1; Fmt < TEX_FORMAT_NUM_FORMATS; ++Fmt)
+    {
+        const auto* Name = GetTextureFormatAttribs(static_cast<TEXTURE_FORMAT>(Fmt)).Name;
+        if (Str == Name || ("TEX_FORMAT_" + Str) == Name)
+            return static_cast<TEXTURE_FORMAT>(Fmt);
+    }
+    LOG_ERROR_AND_THROW("Unknown texture format '", Str, "'.");
+    return TEX_FORMAT_UNKNOWN;
+}
+
+TEXTURE_LOAD_MIP_FILTER ParseMipFilter(const std::string& Str)
+{
+    if (Str == "DEFAULT")
+        return TEXTURE_LOAD_MIP_FILTER_DEFAULT;
+    else if (Str == "BOX_AVERAGE")
+        return TEXTURE_LOAD_MIP_FILTER_BOX_AVERAGE;
+    else if (Str == "MOST_FREQUENT")
+        return TEXTURE_LOAD_MIP_FILTER_MOST_FREQUENT;
+    else if (Str == "NORMAL_MAP")
+        return TEXTURE_LOAD_MIP_FILTER_NORMAL_MAP;
+
+    LOG_ERROR_AND_THROW("Unknown mip filter '", Str, "'. Allowed values are DEFAULT, BOX_AVERAGE, MOST_FREQUENT and NORMAL_MAP.");
+    return TEXTURE_LOAD_MIP_FILTER_DEFAULT;
+}
+
+TEXTURE_LOAD_DISTANCE_FIELD ParseDistanceField(const std::string& Str)
+{
+    if (Str == "NONE")
+        return TEXTURE_LOAD_DISTANCE_FIELD_NONE;
+    else if (Str == "ALPHA")
+        return TEXTURE_LOAD_DISTANCE_FIELD_ALPHA;
+    else if (Str == "ALL_COMPONENTS")
+        return TEXTURE_LOAD_DISTANCE_FIELD_ALL_COMPONENTS;
+
+    LOG_ERROR_AND_THROW("Unknown distance field mode '", Str, "'. Allowed values are NONE, ALPHA and ALL_COMPONENTS.");
+    return TEXTURE_LOAD_DISTANCE_FIELD_NONE;
+}
+
+TextureComponentMapping ParseSwizzle(const std::string& Str)
+{
+    if (Str.length() != 4)
+        LOG_ERROR_AND_THROW("Swizzle '", Str, "' must contain exactly four characters.");
+
+    TEXTURE_COMPONENT_SWIZZLE Swizzle[4] = {};
+    for (size_t i = 0; i < 4; ++i)
+    {
+        switch (std::tolower(static_cast<unsigned char>(Str[i])))
+        {
+            case 'r': Swizzle[i] = TEXTURE_COMPONENT_SWIZZLE_R; break;
+            case 'g': Swizzle[i] = TEXTURE_COMPONENT_SWIZZLE_G; break;
+            case 'b': Swizzle[i] = TEXTURE_COMPONENT_SWIZZLE_B; break;
+            case 'a': Swizzle[i] = TEXTURE_COMPONENT_SWIZZLE_A; break;
+            case '0': Swizzle[i] = TEXTURE_COMPONENT_SWIZZLE_ZERO; break;
+            case '1': Swizzle[i] = TEXTURE_COMPONENT_SWIZZLE_ONE; break;
+            default:
+                LOG_ERROR_AND_THROW("Invalid swizzle '", Str, "'. Allowed characters are r, g, b, a, 0 and 1.");
+        }
+    }
+    return TextureComponentMapping{Swizzle[0], Swizzle[1], Swizzle[2], Swizzle[3]};
+}
+
+// Applies the options from the JSON object to the job. Keys listed in IgnoredKeys are skipped.
+void ParseBakeOptions(const nlohmann::json& Options, const std::vector<const char*>& IgnoredKeys, TextureBakeJob& Job)
+{
+    if (!Options.is_object())
+        LOG_ERROR_AND_THROW("Texture options must be a JSON object.");
+
+    auto& LoadInfo = Job.LoadInfo;
+    for (const auto& Option : Options.items())
+    {
+        const auto& Key   = Option.key();
+        const auto& Value = Option.value();
+
+        if (std::find(IgnoredKeys.begin(), IgnoredKeys.end(), Key) != IgnoredKeys.end())
+            continue;
+
+        if (Key == "Name")
+            Job.Name = Value.get<std::string>();
+        else if (Key == "MipLevels")
+            LoadInfo.MipLevels = Value.get<Uint32>();
+        else if (Key == "IsSRGB")
+            LoadInfo.IsSRGB = Value.get<bool>();
+        else if (Key == "GenerateMips")
+            LoadInfo.GenerateMips = Value.get<bool>();
+        else if (Key == "FlipVertically")
+            LoadInfo.FlipVertically = Value.get<bool>();
+        else if (Key == "PremultiplyAlpha")
+            LoadInfo.PermultiplyAlpha = Value.get<bool>();
+        else if (Key == "Format")
+            LoadInfo.Format = ParseTextureFormat(Value.get<std::string>());
+        else if (Key == "AlphaCutoff")
+            LoadInfo.AlphaCutoff = Value.get<float>();
+        else if (Key == "MipFilter")
+            LoadInfo.MipFilter = ParseMipFilter(Value.get<std::string>());
+        else if (Key == "Swizzle")
+            LoadInfo.Swizzle = ParseSwizzle(Value.get<std::string>());
+        else if (Key == "CompactFormat")
+        {
+            // DDS files can't store the component mapping that a compact format relies on,
+            // so e.g. a grayscale texture baked to R8 would be read back as red only.
+            if (Value.get<bool>())
+                LOG_ERROR_AND_THROW("CompactFormat is not supported: the component mapping can't be stored in the DDS output.");
+        }
+        else if (Key == "DistanceField")
+            LoadInfo.DistanceField = ParseDistanceField(Value.get<std::string>());
+        else if (Key == "DistanceFieldSpread")
+            LoadInfo.DistanceFieldSpread = Value.get<float>();
+        else if (Key == "DistanceFieldDownscale")
+            LoadInfo.DistanceFieldDownscale = Value.get<Uint32>();
+        else
+            LOG_ERROR_AND_THROW("Unknown texture option '", Key, "'.");
+    }
+}
+
+double GetElapsedTime(std::chrono::high_resolution_clock::time_point Start, std::chrono::high_resolution_clock::time_point End)
+{
+    return std::chrono::duration_cast<std::chrono::duration<double>>(End - Start).count();
+}
+
+} // namespace
+
+bool ParseTextureBakeManifest(const char*                  Json,
+                              const std::string&           InputDir,
+                              const std::string&           OutputDir,
+                              std::vector<TextureBakeJob>& Jobs)
+{
+    DEV_CHECK_ERR(Json != nullptr, "Json must not be null");
+
+    try
+    {
+        const auto Manifest = nlohmann::json::parse(Json);
+        if (!Manifest.is_object())
+            LOG_ERROR_AND_THROW("Manifest must be a JSON object.");
+
+        for (const auto& Section : Manifest.items())
+        {
+            if (Section.key() != "Defaults" && Section.key() != "Textures")
+                LOG_ERROR_AND_THROW("Unknown manifest section '", Section.key(), "'.");
+        }
+
+        TextureBakeJob Defaults;
+        if (Manifest.contains("Defaults"))
+            ParseBakeOptions(Manifest["Defaults"], {}, Defaults);
+
+        if (!Manifest.contains("Textures") || !Manifest["Textures"].is_array())
+            LOG_ERROR_AND_THROW("Manifest must contain 'Textures' array.");
+
+        for (const auto& Texture : Manifest["Textures"])
+        {
+            if (!Texture.contains("Input"))
+                LOG_ERROR_AND_THROW("Texture must define 'Input' file path.");
+
+            TextureBakeJob Job = Defaults;
+            ParseBakeOptions(Texture, {"Input", "Output"}, Job);
+
+            const auto Input  = Texture["Input"].get<std::string>();
+            const auto Output = Texture.contains("Output") ? Texture["Output"].get<std::string>() : ReplaceExtension(Input, ".dds");
+
+            Job.InputPath  = ResolvePath(InputDir, Input);
+            Job.OutputPath = ResolvePath(OutputDir, Output);
+            Jobs.emplace_back(std::move(Job));
+        }
+    }
+    catch (std::exception& e)
+    {
+        LOG_ERROR_MESSAGE("Failed to parse texture bake manifest: ", e.what());
+        return false;
+    }
+
+    return true;
+}
+
+bool LoadTextureBakeManifest(const char*                  FilePath,
+                             const std::string&           OutputDir,
+                             std::vector<TextureBakeJob>& Jobs)
+{
+    DEV_CHECK_ERR(FilePath != nullptr, "FilePath must not be null");
+
+    FileWrapper File{FilePath, EFileAccessMode::Read};
+    if (!File)
+    {
+        LOG_ERROR_MESSAGE("Failed to open manifest file '", FilePath, "'.");
+        return false;
+    }
+
+    auto pFileData = DataBlobImpl::Create();
+    File->Read(pFileData);
+    const std::string Json{static_cast<const char*>(pFileData->GetConstDataPtr()), pFileData->GetSize()};
+
+    std::string ManifestDir;
+    FileSystem::GetPathComponents(FilePath, &ManifestDir, nullptr);
+
+    if (!ParseTextureBakeManifest(Json.c_str(), ManifestDir, !OutputDir.empty() ? OutputDir : ManifestDir, Jobs))
+    {
+        LOG_ERROR_MESSAGE("Failed to parse manifest file '", FilePath, "'.");
+        return false;
+    }
+
+    return true;
+}
+
+TextureBakeResult BakeTexture(const TextureBakeJob& Job)
+{
+    TextureBakeResult Result;
+
+    if (!HasExtension(Job.OutputPath, ".dds"))
+    {
+        LOG_ERROR_MESSAGE("Unsupported output file format of '", Job.OutputPath, "'. Only DDS output is supported.");
+        return Result;
+    }
+
+    if (Job.LoadInfo.CompactFormat)
+    {
+        LOG_ERROR_MESSAGE("Failed to bake texture '", Job.InputPath, "': CompactFormat is not supported since the component mapping can't be stored in the DDS output.");
+        return Result;
+    }
+
+    const auto StartTime = std::chrono::high_resolution_clock::now();
+
+    auto LoadInfo           = Job.LoadInfo;
+    LoadInfo.Name           = !Job.Name.empty() ? Job.Name.c_str() : Job.InputPath.c_str();
+    LoadInfo.CacheDirectory = nullptr;
+
+    RefCntAutoPtr<ITextureLoader> pLoader;
+    CreateTextureLoaderFromFile(Job.InputPath.c_str(), IMAGE_FILE_FORMAT_UNKNOWN, LoadInfo, &pLoader);
+    if (!pLoader)
+    {
+        LOG_ERROR_MESSAGE("Failed to load texture '", Job.InputPath, "'.");
+        return Result;
+    }
+
+    const auto ProcessEndTime = std::chrono::high_resolution_clock::now();
+    Result.ProcessTime        = GetElapsedTime(StartTime, ProcessEndTime);
+
+    std::string OutputDir;
+    FileSystem::GetPathComponents(Job.OutputPath, &OutputDir, nullptr);
+    if (!OutputDir.empty() && !FileSystem::PathExists(OutputDir.c_str()))
+        FileSystem::CreateDirectory(OutputDir.c_str());
+
+    if (!SaveTextureAsDDS(Job.OutputPath.c_str(), pLoader->GetTextureDesc(), pLoader->GetTextureData()))
+    {
+        LOG_ERROR_MESSAGE("Failed to write texture '", Job.OutputPath, "'.");
+        return Result;
+    }
+
+    Result.WriteTime = GetElapsedTime(ProcessEndTime, std::chrono::high_resolution_clock::now());
+
+    FileWrapper OutputFile{Job.OutputPath.c_str(), EFileAccessMode::Read};
+    if (OutputFile)
+        Result.OutputSize = OutputFile->GetSize();
+
+    Result.Succeeded = true;
+    return Result;
+}
+
+std::vector<TextureBakeResult> BakeTextures(const std::vector<TextureBakeJob>& Jobs, IThreadPool* pThreadPool)
+{
+    std::vector<TextureBakeResult> Results(Jobs.size());
+    ParallelFor(pThreadPool, static_cast<Uint32>(Jobs.size()), [&](Uint32 i) {
+        Results[i] = BakeTexture(Jobs[i]);
+    });
+    return Results;
+}
+
+} // namespace Diligent
@@ -0,0 +1,152 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#include "TextureBaker.hpp"
+#include "args.hxx"
+
+using namespace Diligent;
+
+namespace
+{
+
+enum class ParseStatus
+{
+    Success,
+    SuccessHelp,
+    Failed,
+};
+
+struct TextureBakerArguments
+{
+    std::vector<std::string> ManifestPaths;
+    std::string              OutputDir;
+    Uint32                   ThreadCount = 0;
+};
+
+ParseStatus ParseCommandLine(int argc, char* argv[], TextureBakerArguments& Arguments)
+{
+    args::ArgumentParser Parser{"Texture baker"};
+    args::HelpFlag       Help{Parser, "help", "Show command line help", {'h', "help"}};
+
+    args::ValueFlagList<std::string> ArgumentInputs{Parser, "path", "Input texture manifest files", {'i', "input"}, {}, args::Options::Required};
+    args::ValueFlag<std::string>     ArgumentOutput{Parser, "dir", "Output directory", {'o', "output_dir"}, ""};
+    args::ValueFlag<Uint32>          ArgumentThreadCount{Parser, "count", "Count of threads", {'t', "thread"}, 0};
+
+    try
+    {
+        Parser.ParseCLI(argc, argv);
+    }
+    catch (const args::Help&)
+    {
+        LOG_INFO_MESSAGE(Parser.Help());
+        return ParseStatus::SuccessHelp;
+    }
+    catch (const args::Error& e)
+    {
+        LOG_ERROR_MESSAGE(e.what());
+        LOG_INFO_MESSAGE(Parser.Help());
+        return ParseStatus::Failed;
+    }
+
+    Arguments.ManifestPaths = args::get(ArgumentInputs);
+    Arguments.OutputDir     = args::get(ArgumentOutput);
+    Arguments.ThreadCount   = args::get(ArgumentThreadCount);
+
+    return ParseStatus::Success;
+}
+
+std::string FormatTime(double Seconds)
+{
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1) << Seconds * 1000.0 << " ms";
+    return ss.str();
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    TextureBakerArguments Arguments;
+
+    switch (ParseCommandLine(argc, argv, Arguments))
+    {
+        case ParseStatus::Success:
+            break;
+        case ParseStatus::SuccessHelp:
+            return EXIT_SUCCESS;
+        case ParseStatus::Failed:
+            LOG_FATAL_ERROR("Failed to parse command line");
+            return EXIT_FAILURE;
+        default:
+            UNEXPECTED("Unexpected parse status");
+            break;
+    }
+
+    std::vector<TextureBakeJob> Jobs;
+    for (const auto& ManifestPath : Arguments.ManifestPaths)
+    {
+        if (!LoadTextureBakeManifest(ManifestPath.c_str(), Arguments.OutputDir, Jobs))
+        {
+            LOG_FATAL_ERROR("Failed to load manifest '", ManifestPath, "'");
+            return EXIT_FAILURE;
+        }
+    }
+
+    const Uint32 ThreadCount = Arguments.ThreadCount > 0 ? Arguments.ThreadCount : std::thread::hardware_concurrency();
+
+    RefCntAutoPtr<IThreadPool> pThreadPool;
+    if (ThreadCount > 1)
+        pThreadPool = CreateThreadPool(ThreadPoolCreateInfo{ThreadCount});
+
+    const auto Results = BakeTextures(Jobs, pThreadPool);
+
+    size_t NumFailed = 0;
+    for (size_t i = 0; i < Jobs.size(); ++i)
+    {
+        const auto& Job    = Jobs[i];
+        const auto& Result = Results[i];
+        if (Result.Succeeded)
+        {
+            LOG_INFO_MESSAGE(Job.InputPath, " -> ", Job.OutputPath, ": processed in ", FormatTime(Result.ProcessTime),
+                             ", written in ", FormatTime(Result.WriteTime), ", ", Result.OutputSize, " bytes");
+        }
+        else
+        {
+            LOG_ERROR_MESSAGE(Job.InputPath, " -> ", Job.OutputPath, ": failed");
+            ++NumFailed;
+        }
+    }
+
+    LOG_INFO_MESSAGE("Baked ", Jobs.size() - NumFailed, " of ", Jobs.size(), " textures");
+
+    return NumFailed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,111 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <cstring>
+
+#include "BasicTypes.h"
+
+namespace Diligent
+{
+
+/// Converts a 16-bit half-precision float to a 32-bit float. Denormals, infinities and NaNs are preserved.
+inline float HalfToFloat(Uint16 Half)
+{
+    const Uint32 Sign     = Uint32{Half & 0x8000u} << 16u;
+    Uint32       Exponent = (Half >> 10u) & 0x1Fu;
+    Uint32       Mantissa = Half & 0x3FFu;
+
+    Uint32 Bits = Sign;
+    if (Exponent == 0)
+    {
+        if (Mantissa != 0)
+        {
+            // Denormalized half - renormalize it
+            Exponent = 127 - 15 + 1;
+            while ((Mantissa & 0x400u) == 0)
+            {
+                Mantissa <<= 1u;
+                --Exponent;
+            }
+            Bits |= (Exponent << 23u) | ((Mantissa & 0x3FFu) << 13u);
+        }
+    }
+    else if (Exponent == 31)
+    {
+        // Inf or NaN
+        Bits |= 0x7F800000u | (Mantissa << 13u);
+    }
+    else
+    {
+        Bits |= ((Exponent + 127 - 15) << 23u) | (Mantissa << 13u);
+    }
+
+    float Value;
+    memcpy(&Value, &Bits, sizeof(Value));
+    return Value;
+}
+
+/// Converts a 32-bit float to a 16-bit half-precision float with rounding to the nearest even value.
+/// Values that are too large are converted to infinity, NaNs are converted to quiet NaN.
+inline Uint16 FloatToHalf(float Value)
+{
+    Uint32 Bits;
+    memcpy(&Bits, &Value, sizeof(Bits));
+
+    const Uint32 Sign = (Bits >> 16u) & 0x8000u;
+    Bits &= 0x7FFFFFFFu;
+
+    Uint32 Half = 0;
+    if (Bits >= 0x47800000u)
+    {
+        // Inf, NaN, or a value that is too large
+        Half = Bits > 0x7F800000u ? 0x7E00u : 0x7C00u;
+    }
+    else if (Bits < 0x38800000u)
+    {
+        // Denormalized half or zero. Adding 0.5 shifts the mantissa into the position
+        // of the half denormal mantissa and rounds it using the FPU rounding mode.
+        float Denorm;
+        memcpy(&Denorm, &Bits, sizeof(Denorm));
+        Denorm += 0.5f;
+        memcpy(&Half, &Denorm, sizeof(Half));
+        Half -= 0x3F000000u;
+    }
+    else
+    {
+        const Uint32 MantissaOdd = (Bits >> 13u) & 1u;
+        // Rebias the exponent and round to nearest even. The mantissa overflow correctly
+        // increments the exponent, and values above the largest half become infinity.
+        Bits += ((15u - 127u) << 23u) + 0xFFFu + MantissaOdd;
+        Half = Bits >> 13u;
+    }
+    return static_cast<Uint16>(Half | Sign);
+}
+
+} // namespace Diligent
@@ -0,0 +1,100 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "TextureLoader.h"
+#include "DataBlob.h"
+#include "RefCntAutoPtr.hpp"
+
+namespace Diligent
+{
+
+/// Persistent on-disk cache of processed textures, see TextureLoadInfo::CacheDirectory.
+///
+/// Every entry is a DDS file whose name is derived from the hash of the source data and
+/// all TextureLoadInfo members that affect the texture contents. Entries are written to
+/// a temporary file that is then renamed, so that concurrent processes never observe
+/// partially written files.
+class TextureCache
+{
+public:
+    /// Contents of a cache entry. The file is memory-mapped when the platform supports it.
+    class Entry
+    {
+    public:
+        ~Entry();
+
+        // clang-format off
+        Entry           (const Entry&) = delete;
+        Entry& operator=(const Entry&) = delete;
+        // clang-format on
+
+        const Uint8* GetData() const { return m_pData; }
+        size_t       GetSize() const { return m_Size; }
+
+    private:
+        friend class TextureCache;
+        Entry() = default;
+
+        const Uint8* m_pData = nullptr;
+        size_t       m_Size  = 0;
+
+        // Used when the file can't be mapped
+        RefCntAutoPtr<IDataBlob> m_pDataBlob;
+
+#if PLATFORM_WIN32 || PLATFORM_UNIVERSAL_WINDOWS
+        void* m_hFile    = nullptr;
+        void* m_hMapping = nullptr;
+#endif
+    };
+
+    TextureCache(const Char* Directory, Uint64 SizeLimit);
+
+    /// Returns the key of the texture loaded from the given source data, or an empty
+    /// string if the texture can't be cached.
+    static std::string ComputeKey(const void* pSrcData, size_t SrcDataSize, const TextureLoadInfo& TexLoadInfo);
+
+    /// Opens the cache entry. Returns null if there is no entry with this key.
+    std::unique_ptr<Entry> Load(const std::string& Key) const;
+
+    /// Writes the texture to the cache and evicts the least recently used entries
+    /// if the cache size exceeds the limit.
+    bool Store(const std::string& Key, const TextureDesc& Desc, const TextureData& Data) const;
+
+private:
+    std::string GetEntryPath(const std::string& Key) const;
+    void        EvictEntries(const std::string& KeepPath) const;
+
+    std::string  m_Directory;
+    const Uint64 m_SizeLimit;
+};
+
+} // namespace Diligent
@@ -24,9 +24,11 @@
  *  of the possibility of such damages.
  */
 
+#include <memory>
 #include <vector>
 
 #include "TextureLoader.h"
+#include "TextureCache.hpp"
 #include "RefCntAutoPtr.hpp"
 #include "ObjectBase.hpp"
 
@@ -49,6 +51,19 @@ public:
                       const TextureLoadInfo& TexLoadInfo,
                       Image*                 pImage);
 
+    /// Creates the loader from the subresource data that is already in the texture format.
+    /// Subresources are indexed as ArraySlice * MipLevels + MipLevel, and rows are tightly packed.
+    TextureLoaderImpl(IReferenceCounters*               pRefCounters,
+                      const TextureDesc&                TexDesc,
+                      std::vector<std::vector<Uint8>>&& Subresources);
+
+    /// Combines single-slice loaders into a texture array or a cubemap.
+    /// All slices must be in TexDesc.Format, and every slice must contain TexDesc.MipLevels
+    /// levels starting with the level whose size is TexDesc.Width x TexDesc.Height.
+    TextureLoaderImpl(IReferenceCounters*                          pRefCounters,
+                      const TextureDesc&                           TexDesc,
+                      std::vector<RefCntAutoPtr<ITextureLoader>>&& Slices);
+
     IMPLEMENT_QUERY_INTERFACE_IN_PLACE(IID_TextureLoader, TBase)
 
     virtual void DILIGENT_CALL_TYPE CreateTexture(IRenderDevice* pDevice,
@@ -72,10 +87,24 @@ public:
         return TextureData{m_SubResources.data(), static_cast<Uint32>(m_SubResources.size())};
     }
 
+    virtual const ImageContentInfo* DILIGENT_CALL_TYPE GetContentInfo() const override final
+    {
+        return m_pContentInfo.get();
+    }
+
+    virtual TextureComponentMapping DILIGENT_CALL_TYPE GetComponentMapping() const override final
+    {
+        return m_ComponentMapping;
+    }
+
 private:
     void LoadFromImage(const TextureLoadInfo& TexLoadInfo);
+    void ConvertToDistanceField(const TextureLoadInfo& TexLoadInfo);
+    Uint32 SelectCompactFormat(const TextureLoadInfo& TexLoadInfo, TextureComponentMapping& PackSwizzle);
+    void BakeNormalVarianceToRoughness(ITextureLoader& NormalMap, Uint32 RoughnessComponent);
     void LoadFromKTX(const TextureLoadInfo& TexLoadInfo, const Uint8* pData, size_t DataSize);
     void LoadFromDDS(const TextureLoadInfo& TexLoadInfo, const Uint8* pData, size_t DataSize);
+    bool LoadFromCache(const TextureLoadInfo& TexLoadInfo, const TextureCache& Cache, const std::string& Key);
 
 private:
     RefCntAutoPtr<IDataBlob> m_pDataBlob;
@@ -86,6 +115,18 @@ private:
 
     std::vector<TextureSubResData>  m_SubResources;
     std::vector<std::vector<Uint8>> m_Mips;
+
+    // Loaders that own the slice data of texture arrays assembled from multiple images
+    std::vector<RefCntAutoPtr<ITextureLoader>> m_SliceLoaders;
+
+    // Cache entry that holds the subresource data of a texture loaded from the cache
+    std::unique_ptr<TextureCache::Entry> m_pCacheEntry;
+
+    // Image content analysis results, see TextureLoadInfo::CompactFormat
+    std::unique_ptr<ImageContentInfo> m_pContentInfo;
+
+    // Maps texture components to the source image components
+    TextureComponentMapping m_ComponentMapping = TextureComponentMapping::Identity();
 };
 
 } // namespace Diligent
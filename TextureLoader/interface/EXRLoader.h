@@ -0,0 +1,60 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include "Image.h"
+
+DILIGENT_BEGIN_NAMESPACE(Diligent)
+
+struct IThreadPool;
+
+/// Loads an OpenEXR image.
+
+/// \param [in]  pEXRData    - OpenEXR file data.
+/// \param [out] pDstPixels  - Destination pixels data blob.
+/// \param [out] pDstImgDesc - Image description.
+/// \param [in]  pThreadPool - Optional thread pool that is used to decode the image chunks in parallel.
+/// \return                    true if the image has been loaded successfully, and false otherwise.
+///
+/// \remarks    Single-part scanline and tiled images with NONE, RLE, ZIPS, ZIP and PIZ compression are supported.
+///             Only the data window of the most detailed level is loaded.
+///
+///             R, G, B and A channels are loaded as an RGBA image (R, RG, RGB or RGBA depending on the present
+///             channels; missing color channels are filled with zeroes). If there are no color channels, but there
+///             is a Y channel, it is loaded as a grayscale image with optional alpha. Otherwise, up to four first
+///             channels are loaded.
+///
+///             If all loaded channels are half-float, the image component type is VT_FLOAT16, and the values are
+///             not converted. If all channels are 32-bit unsigned integer, the component type is VT_UINT32.
+///             Otherwise, all values are converted to VT_FLOAT32.
+bool DILIGENT_GLOBAL_FUNCTION(LoadEXR)(IDataBlob*          pEXRData,
+                                       IDataBlob*          pDstPixels,
+                                       ImageDesc*          pDstImgDesc,
+                                       struct IThreadPool* pThreadPool);
+
+DILIGENT_END_NAMESPACE // namespace Diligent
@@ -0,0 +1,191 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Defines CPU image-based lighting tools
+
+#include "TextureLoader.h"
+
+DILIGENT_BEGIN_NAMESPACE(Diligent)
+
+struct IThreadPool;
+
+#include "../../../DiligentCore/Primitives/interface/DefineGlobalFuncHelperMacros.h"
+
+// clang-format off
+
+/// Parameters of the CreateCubemapFromEquirectangular function.
+struct EquirectToCubemapAttribs
+{
+    /// Source equirectangular image.
+    ///
+    /// \remarks    32-bit float and 8-bit images with one to four components are supported.
+    ///             8-bit values are mapped to [0, 1] range without gamma conversion.
+    ///             The top row of the image corresponds to +Y direction, and the
+    ///             center of the image corresponds to +X direction.
+    struct Image* pImage DEFAULT_INITIALIZER(nullptr);
+
+    /// Cubemap face size. If zero, the face size is a quarter of the image width.
+    Uint32 FaceSize DEFAULT_INITIALIZER(0);
+
+    /// The number of mip levels. If zero, the full mip chain is generated.
+    Uint32 MipLevels DEFAULT_INITIALIZER(0);
+
+    /// Texture name.
+    const Char* Name DEFAULT_INITIALIZER(nullptr);
+
+    /// Optional thread pool to use for parallel processing.
+    struct IThreadPool* pThreadPool DEFAULT_INITIALIZER(nullptr);
+};
+typedef struct EquirectToCubemapAttribs EquirectToCubemapAttribs;
+
+/// Converts an equirectangular environment map into a TEX_FORMAT_RGBA32_FLOAT cubemap.
+
+/// \param [in]  Attribs  - Conversion attributes, see Diligent::EquirectToCubemapAttribs.
+/// \param [out] ppLoader - Memory location where pointer to the texture loader that
+///                         contains the cubemap will be written.
+///
+/// \remarks    Cubemap faces are stored in the +X, -X, +Y, -Y, +Z, -Z order.
+///             Coarser mip levels are box-filtered.
+///             The cubemap can be written to a file with SaveTextureAsDDS.
+void DILIGENT_GLOBAL_FUNCTION(CreateCubemapFromEquirectangular)(const EquirectToCubemapAttribs REF Attribs,
+                                                                ITextureLoader**                   ppLoader);
+
+
+/// Parameters of the ComputeSHIrradiance function.
+struct SHIrradianceAttribs
+{
+    /// Source cubemap in TEX_FORMAT_RGBA32_FLOAT format.
+    ITextureLoader* pCubemap DEFAULT_INITIALIZER(nullptr);
+
+    /// Spherical harmonics order, must be 2 (4 coefficients) or 3 (9 coefficients).
+    Uint32 Order DEFAULT_INITIALIZER(3);
+
+    /// Optional thread pool to use for parallel processing.
+    struct IThreadPool* pThreadPool DEFAULT_INITIALIZER(nullptr);
+};
+typedef struct SHIrradianceAttribs SHIrradianceAttribs;
+
+/// Projects the diffuse irradiance of the cubemap onto spherical harmonics.
+
+/// \param [in]  Attribs   - Attributes, see Diligent::SHIrradianceAttribs.
+/// \param [out] pSHCoeffs - Order * Order RGB coefficients (Order * Order * 3 floats).
+///
+/// \remarks    The coefficients are convolved with the clamped cosine lobe and divided by Pi,
+///             so that EvaluateSHIrradiance returns the radiance reflected by a white
+///             Lambertian surface. For a constant environment, this is the environment color.
+///             The radiance is integrated over the most detailed mip level whose face size
+///             does not exceed 64, which is sufficient for the low-frequency result.
+void DILIGENT_GLOBAL_FUNCTION(ComputeSHIrradiance)(const SHIrradianceAttribs REF Attribs,
+                                                   float*                        pSHCoeffs);
+
+/// Evaluates the irradiance spherical harmonics computed by ComputeSHIrradiance.
+
+/// \param [in]  pSHCoeffs - Order * Order RGB coefficients.
+/// \param [in]  Order     - Spherical harmonics order, must be 2 or 3.
+/// \param [in]  pNormal   - Unit normal (3 floats).
+/// \param [out] pRGB      - Reflected radiance (3 floats).
+void DILIGENT_GLOBAL_FUNCTION(EvaluateSHIrradiance)(const float* pSHCoeffs,
+                                                    Uint32       Order,
+                                                    const float* pNormal,
+                                                    float*       pRGB);
+
+
+/// Parameters of the PrefilterEnvironmentMap function.
+struct PrefilterEnvMapAttribs
+{
+    /// Source cubemap in TEX_FORMAT_RGBA32_FLOAT format.
+    ///
+    /// \remarks    The source should have the full mip chain, which is used
+    ///             to filter the samples (filtered importance sampling).
+    ITextureLoader* pCubemap DEFAULT_INITIALIZER(nullptr);
+
+    /// Face size of the prefiltered cubemap. If zero, the source face size is used.
+    Uint32 FaceSize DEFAULT_INITIALIZER(0);
+
+    /// The number of mip levels. If zero, the full mip chain is generated.
+    Uint32 MipLevels DEFAULT_INITIALIZER(0);
+
+    /// The number of GGX samples per texel.
+    Uint32 NumSamples DEFAULT_INITIALIZER(64);
+
+    /// Texture name.
+    const Char* Name DEFAULT_INITIALIZER(nullptr);
+
+    /// Optional thread pool to use for parallel processing.
+    struct IThreadPool* pThreadPool DEFAULT_INITIALIZER(nullptr);
+};
+typedef struct PrefilterEnvMapAttribs PrefilterEnvMapAttribs;
+
+/// Prefilters the cubemap with the GGX distribution for the split-sum image-based lighting approximation.
+
+/// \param [in]  Attribs  - Attributes, see Diligent::PrefilterEnvMapAttribs.
+/// \param [out] ppLoader - Memory location where pointer to the texture loader that
+///                         contains the prefiltered TEX_FORMAT_RGBA32_FLOAT cubemap will be written.
+///
+/// \remarks    Mip level m is filtered with perceptual roughness m / (MipLevels - 1),
+///             assuming that the view and normal directions match the reflection direction.
+void DILIGENT_GLOBAL_FUNCTION(PrefilterEnvironmentMap)(const PrefilterEnvMapAttribs REF Attribs,
+                                                       ITextureLoader**                 ppLoader);
+
+
+/// Parameters of the ComputeBRDFIntegrationLUT function.
+struct BRDFIntegrationLUTAttribs
+{
+    /// LUT width and height.
+    Uint32 Size DEFAULT_INITIALIZER(128);
+
+    /// The number of GGX samples per texel.
+    Uint32 NumSamples DEFAULT_INITIALIZER(512);
+
+    /// Texture name.
+    const Char* Name DEFAULT_INITIALIZER(nullptr);
+
+    /// Optional thread pool to use for parallel processing.
+    struct IThreadPool* pThreadPool DEFAULT_INITIALIZER(nullptr);
+};
+typedef struct BRDFIntegrationLUTAttribs BRDFIntegrationLUTAttribs;
+
+/// Computes the split-sum GGX BRDF integration LUT.
+
+/// \param [in]  Attribs  - Attributes, see Diligent::BRDFIntegrationLUTAttribs.
+/// \param [out] ppLoader - Memory location where pointer to the texture loader that
+///                         contains the TEX_FORMAT_RG32_FLOAT LUT will be written.
+///
+/// \remarks    The horizontal axis is N.V and the vertical axis is perceptual roughness,
+///             both sampled at texel centers. The red and green channels contain the scale
+///             and bias that are applied to F0: Specular = F0 * LUT.r + LUT.g.
+void DILIGENT_GLOBAL_FUNCTION(ComputeBRDFIntegrationLUT)(const BRDFIntegrationLUTAttribs REF Attribs,
+                                                         ITextureLoader**                    ppLoader);
+
+// clang-format on
+
+#include "../../../DiligentCore/Primitives/interface/UndefGlobalFuncHelperMacros.h"
+
+DILIGENT_END_NAMESPACE // namespace Diligent
@@ -40,6 +40,8 @@
 
 DILIGENT_BEGIN_NAMESPACE(Diligent)
 
+struct IThreadPool;
+
 /// Image file format
 DILIGENT_TYPED_ENUM(IMAGE_FILE_FORMAT, Uint8){
     /// Unknown format
@@ -69,6 +71,10 @@ DILIGENT_TYPED_ENUM(IMAGE_FILE_FORMAT, Uint8){
 
     // TGA file
     IMAGE_FILE_FORMAT_TGA,
+
+    /// OpenEXR file
+    /// https://openexr.com/en/latest/OpenEXRFileLayout.html
+    IMAGE_FILE_FORMAT_EXR,
 };
 
 /// Image loading information
@@ -84,6 +90,14 @@ struct ImageLoadInfo
     ///
     /// \note This flag is only used if PermultiplyAlpha is true.
     bool IsSRGB DEFAULT_INITIALIZER(false);
+
+    /// Optional thread pool that is used to decode independent strips or tiles
+    /// of a TIFF image, or scanline blocks or tiles of an OpenEXR image in parallel.
+    ///
+    /// \remarks   The loader only waits for its own work items and processes some of them
+    ///            in the calling thread, so the image may be loaded from a task running
+    ///            in the same pool.
+    struct IThreadPool* pThreadPool DEFAULT_INITIALIZER(nullptr);
 };
 typedef struct ImageLoadInfo ImageLoadInfo;
 
@@ -107,6 +121,37 @@ struct ImageDesc
 };
 typedef struct ImageDesc ImageDesc;
 
+/// Results of the image content analysis, see Diligent::AnalyzeImageContent.
+struct ImageContentInfo
+{
+    /// Number of color components in the image
+    Uint32 NumComponents DEFAULT_INITIALIZER(0);
+
+    /// Bit mask of the components that have the same value in all pixels.
+    /// Bit 0 corresponds to the first component, bit 1 to the second one, etc.
+    Uint32 ConstantComponents DEFAULT_INITIALIZER(0);
+
+    /// Minimum value of each component.
+    /// Values of integer components are normalized to [0, 1] range.
+    Float32 MinValues[4] DEFAULT_INITIALIZER({});
+
+    /// Maximum value of each component.
+    /// Values of integer components are normalized to [0, 1] range.
+    Float32 MaxValues[4] DEFAULT_INITIALIZER({});
+
+    /// Whether the first three components are equal in every pixel.
+    /// Always false for images with fewer than three components.
+    Bool IsGrayscale DEFAULT_INITIALIZER(False);
+
+    /// Whether the image has no alpha channel (the fourth component), or the alpha is 1 in all pixels.
+    Bool IsOpaque DEFAULT_INITIALIZER(False);
+
+    /// Whether the alpha is either 0 or 1 in every pixel, so that it can be represented
+    /// with a single bit (e.g. in BC1 format). True for opaque images.
+    Bool HasBinaryAlpha DEFAULT_INITIALIZER(False);
+};
+typedef struct ImageContentInfo ImageContentInfo;
+
 
 
 #if DILIGENT_CPP_INTERFACE
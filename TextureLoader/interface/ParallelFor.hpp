@@ -0,0 +1,56 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Defines the ParallelFor() helper
+
+#include <functional>
+
+#include "../../../DiligentCore/Primitives/interface/BasicTypes.h"
+
+namespace Diligent
+{
+
+struct IThreadPool;
+
+/// Calls Func(i) for every i in [0, Count), distributing the calls across the thread pool threads.
+
+/// \param [in] pThreadPool - Optional thread pool. If it is null, all calls are made on the calling thread.
+/// \param [in] Count       - The number of items to process.
+/// \param [in] Func        - Function that processes a single item.
+///
+/// \remarks    The calling thread processes items along with the pool threads, and the function only waits
+///             for the items that are already being processed, but not for the pool tasks that have not started.
+///             Thus, it does not wait for unrelated tasks in the pool and can be called from a pool thread.
+///
+///             If Func throws an exception, the exception is rethrown on the calling thread. When the thread
+///             pool is used, the remaining items are processed first, and only the first exception is rethrown.
+void ParallelFor(IThreadPool* pThreadPool, Uint32 Count, const std::function<void(Uint32)>& Func);
+
+} // namespace Diligent
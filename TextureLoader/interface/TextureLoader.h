@@ -35,6 +35,8 @@
 DILIGENT_BEGIN_NAMESPACE(Diligent)
 
 struct Image;
+struct ITextureLoader;
+struct IThreadPool;
 
 // clang-format off
 
@@ -51,7 +53,28 @@ DILIGENT_TYPED_ENUM(TEXTURE_LOAD_MIP_FILTER, Uint8)
     /// Use the most frequent element from the 2x2 box.
     /// This filter does not introduce new values and should be used
     /// for integer textures that contain non-filterable data (e.g. indices).
-    TEXTURE_LOAD_MIP_FILTER_MOST_FREQUENT
+    TEXTURE_LOAD_MIP_FILTER_MOST_FREQUENT,
+
+    /// Average the tangent-space normals in the 2x2 box and renormalize the result,
+    /// see Diligent::ComputeNormalMapMipLevel.
+    /// This filter is only supported for 8-bit UNORM textures with at least two
+    /// components. Other formats fall back to the default filter.
+    TEXTURE_LOAD_MIP_FILTER_NORMAL_MAP
+};
+
+/// Signed distance field conversion mode, see TextureLoadInfo::DistanceField.
+DILIGENT_TYPED_ENUM(TEXTURE_LOAD_DISTANCE_FIELD, Uint8)
+{
+    /// The image is loaded as is.
+    TEXTURE_LOAD_DISTANCE_FIELD_NONE = 0,
+
+    /// The alpha channel (the last component of one-, two- and four-component images,
+    /// or the first component of RGB images) is converted into a single-channel
+    /// distance field.
+    TEXTURE_LOAD_DISTANCE_FIELD_ALPHA,
+
+    /// Every image component is converted into its own distance field.
+    TEXTURE_LOAD_DISTANCE_FIELD_ALL_COMPONENTS
 };
 
 
@@ -110,6 +133,78 @@ struct TextureLoadInfo
     ///             - Two-channel source image is replicated to RG channels, B channel is set to 0.
     TextureComponentMapping Swizzle DEFAULT_INITIALIZER(TextureComponentMapping::Identity());
 
+    /// Optional normal map whose variance is added to the roughness stored in this texture
+    /// (Toksvig-style specular anti-aliasing), see Diligent::AddNormalVarianceToRoughness.
+    ///
+    /// \remarks    The variance is added to every mip level after the mip levels have been generated.
+    ///             The normal map must be a 2D texture in an 8-bit UNORM format with at least two components.
+    ///             The texture being loaded must be in an 8-bit UNORM format, too, and
+    ///             must not be a DDS or KTX file.
+    ///             The normal map loader is only accessed while this texture is being loaded.
+    struct ITextureLoader* pRoughnessNormalMap DEFAULT_VALUE(nullptr);
+
+    /// Index of the component that contains the roughness when pRoughnessNormalMap is not null.
+    /// The default value matches the glTF metallic-roughness texture layout.
+    Uint32 RoughnessComponent           DEFAULT_VALUE(1);
+
+    /// Optional directory of the persistent cache of processed textures.
+    ///
+    /// \remarks    When not null, textures that are decoded from image files (PNG, JPEG, TIFF, etc.)
+    ///             by CreateTextureLoaderFromFile and CreateTextureLoaderFromMemory are written
+    ///             to this directory as DDS files after all processing (mip generation, swizzle,
+    ///             alpha premultiplication, etc.) is done. The files are keyed by the hash of the
+    ///             source data and the members of this structure that affect the texture contents,
+    ///             so subsequent loads with the same parameters read the cached data instead
+    ///             of decoding the image. The directory may be shared by multiple processes.
+    ///             The cache is not used when pRoughnessNormalMap is not null or CompactFormat is true.
+    const Char* CacheDirectory          DEFAULT_VALUE(nullptr);
+
+    /// The maximum total size of the cache files, in bytes. When a new file is written
+    /// and the limit is exceeded, the least recently used files are deleted.
+    /// Zero means that the cache size is not limited.
+    Uint64 CacheSizeLimit               DEFAULT_VALUE(0);
+
+    /// Flag indicating that the loader should analyze the image contents and select the most
+    /// compact format that represents the image exactly, see Diligent::AnalyzeImageContent.
+    ///
+    /// \remarks    The following rules apply to 8- and 16-bit UNORM images:
+    ///             - Opaque grayscale RGB(A) images are loaded as R8/R16 textures.
+    ///             - Grayscale RGBA images are loaded as RG8/RG16 textures, with alpha stored in G.
+    ///             - Opaque RGB(A) images with zero B (and G) components are loaded as RG8/RG16 (R8/R16) textures.
+    ///             - RG images with zero G component are loaded as R8/R16 textures.
+    ///
+    ///             Since the texture may have fewer components than the source image, the application
+    ///             must apply the mapping returned by ITextureLoader::GetComponentMapping when the texture
+    ///             is sampled (e.g. through the texture view swizzle) to obtain the source image values.
+    ///             The analysis results are available through ITextureLoader::GetContentInfo.
+    ///
+    ///             The format is not changed if Format is specified explicitly, if the image is in sRGB
+    ///             space (there are no single- and two-component sRGB formats), or if Swizzle, AlphaCutoff,
+    ///             the normal map mip filter or pRoughnessNormalMap are used. Texture arrays assembled
+    ///             from multiple images and DDS/KTX files are never compacted.
+    ///             The texture cache is not used when this flag is set.
+    Bool CompactFormat                  DEFAULT_VALUE(False);
+
+    /// Signed distance field conversion mode, see Diligent::TEXTURE_LOAD_DISTANCE_FIELD.
+    ///
+    /// \remarks    When not TEXTURE_LOAD_DISTANCE_FIELD_NONE, the image is thresholded at 0.5 and
+    ///             converted into an 8-bit UNORM signed distance field (see Diligent::ComputeDistanceField)
+    ///             before any other processing. The texture is R8_UNORM in the alpha mode and has as many
+    ///             components as the source image in the all-components mode. The edge maps to 0.5, and
+    ///             values above 0.5 are inside the shape. IsSRGB should be false as distances are linear.
+    ///             DDS and KTX files are not converted.
+    TEXTURE_LOAD_DISTANCE_FIELD DistanceField DEFAULT_VALUE(TEXTURE_LOAD_DISTANCE_FIELD_NONE);
+
+    /// The distance, in texels of the distance field, that maps to the full 0 to 1 range
+    /// when DistanceField is not TEXTURE_LOAD_DISTANCE_FIELD_NONE.
+    float DistanceFieldSpread           DEFAULT_VALUE(4);
+
+    /// The factor by which the distance field is downscaled relative to the source image
+    /// when DistanceField is not TEXTURE_LOAD_DISTANCE_FIELD_NONE. Distance fields preserve
+    /// sharp edges under magnification, so high-resolution masks are typically stored
+    /// at a fraction of their size.
+    Uint32 DistanceFieldDownscale       DEFAULT_VALUE(1);
+
 #if DILIGENT_CPP_INTERFACE
     explicit TextureLoadInfo(const Char*         _Name,
                              USAGE               _Usage             = TextureLoadInfo{}.Usage,
@@ -167,6 +262,15 @@ DILIGENT_BEGIN_INTERFACE(ITextureLoader, IObject)
 
     /// Returns the texture initialization data.
     VIRTUAL TextureData METHOD(GetTextureData)(THIS) PURE;
+
+    /// Returns the results of the image content analysis, or null if the contents
+    /// were not analyzed (see TextureLoadInfo::CompactFormat).
+    VIRTUAL const ImageContentInfo* METHOD(GetContentInfo)(THIS) CONST PURE;
+
+    /// Returns the mapping that must be applied to the texture components to obtain
+    /// the components of the source image. The mapping is identity unless the loader
+    /// selected a compact format, see TextureLoadInfo::CompactFormat.
+    VIRTUAL TextureComponentMapping METHOD(GetComponentMapping)(THIS) CONST PURE;
 };
 DILIGENT_END_INTERFACE
 // clang-format on
@@ -180,6 +284,8 @@ DILIGENT_END_INTERFACE
 #    define ITextureLoader_GetTextureDesc(This)          CALL_IFACE_METHOD(TextureLoader_GetTextureDesc,      GetTextureDesc,      This)
 #    define ITextureLoader_GetSubresourceData(This, ...) CALL_IFACE_METHOD(TextureLoader_GetSubresourceData,  GetSubresourceData,  This, __VA_ARGS__)
 #    define ITextureLoader_GetTextureData(This)          CALL_IFACE_METHOD(TextureLoader_GetTextureData,      GetTextureData,      This)
+#    define ITextureLoader_GetContentInfo(This)          CALL_IFACE_METHOD(TextureLoader_GetContentInfo,      GetContentInfo,      This)
+#    define ITextureLoader_GetComponentMapping(This)     CALL_IFACE_METHOD(TextureLoader_GetComponentMapping, GetComponentMapping, This)
 // clang-format on
 
 #endif
@@ -224,6 +330,52 @@ void DILIGENT_GLOBAL_FUNCTION(CreateTextureLoaderFromMemory)(const void*
                                                              ITextureLoader**          ppLoader);
 
 
+/// Creates a texture array or a cubemap loader from multiple images.
+
+/// \param [in]  ppSrcImages - Array of NumImages pointers to the source images, one image per array slice.
+/// \param [in]  NumImages   - The number of images.
+/// \param [in]  Dimension   - Texture dimension: RESOURCE_DIM_TEX_2D_ARRAY, RESOURCE_DIM_TEX_CUBE
+///                            (NumImages must be 6), or RESOURCE_DIM_TEX_CUBE_ARRAY (NumImages
+///                            must be a multiple of 6). Cubemap faces are given in the
+///                            +X, -X, +Y, -Y, +Z, -Z order.
+/// \param [in]  TexLoadInfo - Texture loading information that is applied to every slice,
+///                            see Diligent::TextureLoadInfo.
+/// \param [in]  pThreadPool - Optional thread pool that is used to process the slices in parallel.
+/// \param [out] ppLoader    - Memory location where pointer to the created texture loader will be written.
+///
+/// \remarks    The slices are processed as if they were loaded by CreateTextureLoaderFromImage.
+///             If the slices have different formats that only differ in the number of components,
+///             the slices with fewer components are expanded to the widest format.
+///             The texture size is the size of the smallest slice. Larger slices are only
+///             accepted if one of their mip levels matches this size exactly (e.g. 1024x1024
+///             and 512x512 slices), in which case the finer mip levels are dropped.
+void DILIGENT_GLOBAL_FUNCTION(CreateTextureLoaderFromImages)(struct Image* const*      ppSrcImages,
+                                                             Uint32                    NumImages,
+                                                             RESOURCE_DIMENSION        Dimension,
+                                                             const TextureLoadInfo REF TexLoadInfo,
+                                                             struct IThreadPool*       pThreadPool,
+                                                             ITextureLoader**          ppLoader);
+
+/// Creates a texture array or a cubemap loader from multiple files.
+
+/// \param [in]  FilePaths   - Array of NumFiles file paths, one file per array slice.
+///                            Every file must contain a single 2D image.
+/// \param [in]  NumFiles    - The number of files.
+/// \param [in]  Dimension   - Texture dimension, see CreateTextureLoaderFromImages.
+/// \param [in]  TexLoadInfo - Texture loading information that is applied to every slice,
+///                            see Diligent::TextureLoadInfo.
+/// \param [in]  pThreadPool - Optional thread pool that is used to decode the files in parallel.
+/// \param [out] ppLoader    - Memory location where pointer to the created texture loader will be written.
+///
+/// \remarks    Format unification and size validation rules are the same as in CreateTextureLoaderFromImages.
+void DILIGENT_GLOBAL_FUNCTION(CreateTextureLoaderFromFiles)(const char* const*        FilePaths,
+                                                            Uint32                    NumFiles,
+                                                            RESOURCE_DIMENSION        Dimension,
+                                                            const TextureLoadInfo REF TexLoadInfo,
+                                                            struct IThreadPool*       pThreadPool,
+                                                            ITextureLoader**          ppLoader);
+
+
 /// Writes texture data as DDS file.
 
 /// \param [in]  FilePath - DDS file path.
@@ -155,6 +155,251 @@ typedef struct PremultiplyAlphaAttribs PremultiplyAlphaAttribs;
 void DILIGENT_GLOBAL_FUNCTION(PremultiplyAlpha)(const PremultiplyAlphaAttribs REF Attribs);
 
 
+/// Parameters of the ComputeAlphaCoverage and ScaleAlphaToCoverage functions.
+struct AlphaCoverageAttribs
+{
+    /// Texture width.
+    Uint32 Width DEFAULT_INITIALIZER(0);
+
+    /// Texture height.
+    Uint32 Height DEFAULT_INITIALIZER(0);
+
+    /// A pointer to pixels.
+    void* pPixels DEFAULT_INITIALIZER(nullptr);
+
+    /// Stride in bytes.
+    Uint32 Stride DEFAULT_INITIALIZER(0);
+
+    /// Component count.
+    Uint32 ComponentCount DEFAULT_INITIALIZER(0);
+
+    /// Component type.
+    VALUE_TYPE ComponentType DEFAULT_INITIALIZER(VT_UINT8);
+
+    /// Alpha test threshold. Pixels whose alpha is not less than
+    /// this value are considered covered.
+    float AlphaCutoff DEFAULT_INITIALIZER(0.5f);
+};
+typedef struct AlphaCoverageAttribs AlphaCoverageAttribs;
+
+/// Returns the fraction of pixels that pass the alpha test.
+/// \note Alpha is assumed to be the last component. Only 8-bit components are currently supported.
+float DILIGENT_GLOBAL_FUNCTION(ComputeAlphaCoverage)(const AlphaCoverageAttribs REF Attribs);
+
+/// Scales alpha in place so that the fraction of pixels that pass the alpha test
+/// matches the target coverage as closely as possible, and returns the scale that was applied.
+///
+/// \remarks    This function is used to prevent alpha-tested geometry from fading out in coarse
+///             mip levels: every mip level is scaled to match the coverage of the most detailed level.
+///             Alpha is assumed to be the last component. Only 8-bit components are currently supported.
+float DILIGENT_GLOBAL_FUNCTION(ScaleAlphaToCoverage)(const AlphaCoverageAttribs REF Attribs, float TargetCoverage);
+
+
+/// Parameters of the ComputeNormalMapMipLevel function.
+struct NormalMapMipLevelAttribs
+{
+    /// Fine mip level width.
+    Uint32 FineMipWidth DEFAULT_INITIALIZER(0);
+
+    /// Fine mip level height.
+    Uint32 FineMipHeight DEFAULT_INITIALIZER(0);
+
+    /// A pointer to the fine mip level pixels.
+    const void* pFineMipData DEFAULT_INITIALIZER(nullptr);
+
+    /// Fine mip level stride in bytes.
+    Uint32 FineMipStride DEFAULT_INITIALIZER(0);
+
+    /// A pointer to the coarse mip level pixels.
+    /// The coarse mip level size is max(FineMipWidth / 2, 1) x max(FineMipHeight / 2, 1).
+    void* pCoarseMipData DEFAULT_INITIALIZER(nullptr);
+
+    /// Coarse mip level stride in bytes.
+    Uint32 CoarseMipStride DEFAULT_INITIALIZER(0);
+
+    /// Component count, must be 2, 3 or 4.
+    Uint32 ComponentCount DEFAULT_INITIALIZER(0);
+};
+typedef struct NormalMapMipLevelAttribs NormalMapMipLevelAttribs;
+
+/// Computes the coarse mip level of a tangent-space normal map by averaging
+/// the normals in the 2x2 footprint and renormalizing the result.
+///
+/// \remarks    Normals are stored in 8-bit UNORM components as N * 0.5 + 0.5.
+///             For two-component normal maps, Z is reconstructed from X and Y.
+///             The fourth component, if present, is box-averaged.
+///             Unlike the box filter, this filter does not shorten the normals and
+///             does not bias them towards the geometric normal in coarse mip levels.
+void DILIGENT_GLOBAL_FUNCTION(ComputeNormalMapMipLevel)(const NormalMapMipLevelAttribs REF Attribs);
+
+
+/// Parameters of the AddNormalVarianceToRoughness function.
+struct NormalVarianceToRoughnessAttribs
+{
+    /// Normal map width.
+    Uint32 NormalMapWidth DEFAULT_INITIALIZER(0);
+
+    /// Normal map height.
+    Uint32 NormalMapHeight DEFAULT_INITIALIZER(0);
+
+    /// A pointer to the normal map pixels.
+    const void* pNormalMapPixels DEFAULT_INITIALIZER(nullptr);
+
+    /// Normal map stride in bytes.
+    Uint32 NormalMapStride DEFAULT_INITIALIZER(0);
+
+    /// Normal map component count, must be 2, 3 or 4.
+    Uint32 NormalMapComponentCount DEFAULT_INITIALIZER(0);
+
+    /// Roughness texture width.
+    Uint32 Width DEFAULT_INITIALIZER(0);
+
+    /// Roughness texture height.
+    Uint32 Height DEFAULT_INITIALIZER(0);
+
+    /// A pointer to the roughness texture pixels.
+    void* pPixels DEFAULT_INITIALIZER(nullptr);
+
+    /// Roughness texture stride in bytes.
+    Uint32 Stride DEFAULT_INITIALIZER(0);
+
+    /// Roughness texture component count.
+    Uint32 ComponentCount DEFAULT_INITIALIZER(0);
+
+    /// Index of the component that contains perceptual roughness.
+    /// The default value matches the glTF metallic-roughness texture layout.
+    Uint32 RoughnessComponent DEFAULT_INITIALIZER(1);
+};
+typedef struct NormalVarianceToRoughnessAttribs NormalVarianceToRoughnessAttribs;
+
+/// Adds the variance of the normals covered by each roughness texel to its roughness in place.
+///
+/// \remarks    This is a Toksvig-style specular anti-aliasing technique: the shorter the average of
+///             the unit normals in the texel footprint, the wider the normal distribution, which is
+///             accounted for by increasing the GGX alpha as follows:
+///
+///                 Variance = (1 - |Navg|) / |Navg|
+///                 Alpha'^2 = Alpha^2 + 2 * Variance
+///
+///             The footprint of each texel is determined by the ratio of the normal map and roughness
+///             texture sizes, so the function should be called for each mip level of the roughness
+///             texture with the most detailed level of the normal map. Texels whose footprint covers
+///             a single normal are not modified.
+///             Only 8-bit components are supported.
+void DILIGENT_GLOBAL_FUNCTION(AddNormalVarianceToRoughness)(const NormalVarianceToRoughnessAttribs REF Attribs);
+
+
+/// Parameters of the AnalyzeImageContent function.
+struct ImageContentAnalysisAttribs
+{
+    /// Image width
+    Uint32 Width DEFAULT_INITIALIZER(0);
+
+    /// Image height
+    Uint32 Height DEFAULT_INITIALIZER(0);
+
+    /// A pointer to the image pixels
+    const void* pPixels DEFAULT_INITIALIZER(nullptr);
+
+    /// Image row stride in bytes
+    Uint32 Stride DEFAULT_INITIALIZER(0);
+
+    /// Number of components per pixel, from 1 to 4
+    Uint32 ComponentCount DEFAULT_INITIALIZER(0);
+
+    /// Component type, must be VT_UINT8, VT_UINT16 or VT_FLOAT32
+    VALUE_TYPE ComponentType DEFAULT_INITIALIZER(VT_UINT8);
+
+    /// Optional thread pool that is used to analyze bands of rows in parallel.
+    /// The function only waits for its own work items.
+    struct IThreadPool* pThreadPool DEFAULT_INITIALIZER(nullptr);
+};
+typedef struct ImageContentAnalysisAttribs ImageContentAnalysisAttribs;
+
+/// Analyzes the image contents: finds the value range of each component and detects
+/// constant components, grayscale images and opaque or binary alpha.
+///
+/// \remarks   The results can be used to select a more compact texture format that represents
+///             the image exactly, see TextureLoadInfo::CompactFormat.
+ImageContentInfo DILIGENT_GLOBAL_FUNCTION(AnalyzeImageContent)(const ImageContentAnalysisAttribs REF Attribs);
+
+
+/// Parameters of the ComputeDistanceField function.
+struct DistanceFieldAttribs
+{
+    /// Source mask width.
+    Uint32 SrcWidth DEFAULT_INITIALIZER(0);
+
+    /// Source mask height.
+    Uint32 SrcHeight DEFAULT_INITIALIZER(0);
+
+    /// A pointer to the source mask pixels.
+    const void* pSrcPixels DEFAULT_INITIALIZER(nullptr);
+
+    /// Source stride in bytes.
+    Uint32 SrcStride DEFAULT_INITIALIZER(0);
+
+    /// Source component count, from 1 to 4.
+    Uint32 SrcComponentCount DEFAULT_INITIALIZER(0);
+
+    /// Source component type, must be VT_UINT8, VT_UINT16 or VT_FLOAT32.
+    VALUE_TYPE SrcComponentType DEFAULT_INITIALIZER(VT_UINT8);
+
+    /// Index of the first source component that is converted to a distance field.
+    Uint32 FirstComponent DEFAULT_INITIALIZER(0);
+
+    /// The number of source components that are converted, starting with FirstComponent.
+    /// Every component produces an independent distance field that is written to
+    /// the corresponding destination component.
+    Uint32 NumChannels DEFAULT_INITIALIZER(1);
+
+    /// Coverage threshold. Texels whose normalized value is not less than
+    /// this value are inside the shape.
+    float Threshold DEFAULT_INITIALIZER(0.5f);
+
+    /// The distance from the edge, in destination texels, at which
+    /// normalized distance values reach 0 (outside) or 1 (inside).
+    float Spread DEFAULT_INITIALIZER(4.f);
+
+    /// Destination width. The distance field may be smaller than the source mask.
+    Uint32 DstWidth DEFAULT_INITIALIZER(0);
+
+    /// Destination height.
+    Uint32 DstHeight DEFAULT_INITIALIZER(0);
+
+    /// A pointer to the destination pixels. Every pixel contains NumChannels components.
+    void* pDstPixels DEFAULT_INITIALIZER(nullptr);
+
+    /// Destination stride in bytes.
+    Uint32 DstStride DEFAULT_INITIALIZER(0);
+
+    /// Destination component type, must be VT_UINT8, VT_UINT16 or VT_FLOAT32.
+    VALUE_TYPE DstComponentType DEFAULT_INITIALIZER(VT_UINT8);
+
+    /// Optional thread pool that is used to process rows and columns in parallel.
+    /// The function only waits for its own work items.
+    struct IThreadPool* pThreadPool DEFAULT_INITIALIZER(nullptr);
+};
+typedef struct DistanceFieldAttribs DistanceFieldAttribs;
+
+/// Generates signed distance fields from the coverage or alpha mask.
+///
+/// \remarks   The distance from each source texel to the edge is computed with the exact Euclidean
+///             distance transform of Felzenszwalb and Huttenlocher, which runs in linear time.
+///             The mask is thresholded, and the edge is assumed to lie halfway between texel centers,
+///             so the mask should typically be several times larger than the distance field.
+///             The distance field is sampled from the source one with the bilinear filter, and the distances
+///             are scaled to destination texels (by the geometric mean of the horizontal and vertical scales).
+///
+///             Normalized (VT_UINT8 and VT_UINT16) destination values are computed as
+///
+///                 0.5 + Distance / (2 * Spread)
+///
+///             where Distance is positive inside the shape, so that the edge is at 0.5.
+///             VT_FLOAT32 destination values contain the signed distance in destination texels.
+void DILIGENT_GLOBAL_FUNCTION(ComputeDistanceField)(const DistanceFieldAttribs REF Attribs);
+
+
 /// Creates a texture from file.
 
 /// \param [in] FilePath    - Source file path.
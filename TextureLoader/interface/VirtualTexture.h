@@ -0,0 +1,235 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Defines virtual texture page builder
+
+#include "TextureLoader.h"
+
+DILIGENT_BEGIN_NAMESPACE(Diligent)
+
+struct IThreadPool;
+
+#include "../../../DiligentCore/Primitives/interface/DefineGlobalFuncHelperMacros.h"
+
+// clang-format off
+
+/// Virtual texture file signature ('DVTX')
+#define DILIGENT_VIRTUAL_TEXTURE_MAGIC 0x58545644u
+
+/// Virtual texture file version
+#define DILIGENT_VIRTUAL_TEXTURE_VERSION 1u
+
+/// Virtual texture page flags
+DILIGENT_TYPED_ENUM(VIRTUAL_TEXTURE_PAGE_FLAGS, Uint32)
+{
+    /// No flags
+    VIRTUAL_TEXTURE_PAGE_FLAG_NONE       = 0u,
+
+    /// All texels of the page have the same value. The page data contains a single texel.
+    VIRTUAL_TEXTURE_PAGE_FLAG_CONSTANT   = 1u << 0u,
+
+    /// The page data is compressed with zlib.
+    VIRTUAL_TEXTURE_PAGE_FLAG_COMPRESSED = 1u << 1u
+};
+DEFINE_FLAG_ENUM_OPERATORS(VIRTUAL_TEXTURE_PAGE_FLAGS)
+
+
+/// Virtual texture file header.
+
+/// The file is laid out as follows:
+///
+///     VirtualTextureHeader    Header;
+///     VirtualTextureMipLevel  MipLevels[Header.MipLevels];
+///     Uint32                  PageTable[Header.NumTiles];   // Index of the page of every tile
+///     <padding to 8 bytes>
+///     VirtualTexturePageEntry Pages[Header.NumPages];
+///     Page data
+///
+/// Tiles are stored level by level, and within a level row by row. Multiple tiles may refer to
+/// the same page (e.g. tiles with the same constant color). All tables are located at the beginning
+/// of the file, so that the file can be streamed by reading the tables first and then reading
+/// the page data at the offsets given by the page entries.
+struct VirtualTextureHeader
+{
+    /// File signature, must be DILIGENT_VIRTUAL_TEXTURE_MAGIC
+    Uint32 Magic         DEFAULT_INITIALIZER(DILIGENT_VIRTUAL_TEXTURE_MAGIC);
+
+    /// File version, must be DILIGENT_VIRTUAL_TEXTURE_VERSION
+    Uint32 Version       DEFAULT_INITIALIZER(DILIGENT_VIRTUAL_TEXTURE_VERSION);
+
+    /// Texture format: TEX_FORMAT_R8_UNORM, TEX_FORMAT_RG8_UNORM, TEX_FORMAT_RGBA8_UNORM or TEX_FORMAT_RGBA8_UNORM_SRGB
+    Uint32 Format        DEFAULT_INITIALIZER(0);
+
+    /// Width of the most detailed level, in texels
+    Uint32 Width         DEFAULT_INITIALIZER(0);
+
+    /// Height of the most detailed level, in texels
+    Uint32 Height        DEFAULT_INITIALIZER(0);
+
+    /// Size of the page interior, in texels
+    Uint32 PageSize      DEFAULT_INITIALIZER(0);
+
+    /// Size of the border on each side of the page, in texels.
+    /// The full page size is PageSize + 2 * BorderSize.
+    Uint32 BorderSize    DEFAULT_INITIALIZER(0);
+
+    /// The number of mip levels
+    Uint32 MipLevels     DEFAULT_INITIALIZER(0);
+
+    /// The total number of tiles in all mip levels (the page table size)
+    Uint32 NumTiles      DEFAULT_INITIALIZER(0);
+
+    /// The number of unique pages
+    Uint32 NumPages      DEFAULT_INITIALIZER(0);
+};
+typedef struct VirtualTextureHeader VirtualTextureHeader;
+
+/// Describes the tiles of a virtual texture mip level.
+struct VirtualTextureMipLevel
+{
+    /// Level width, in texels
+    Uint32 Width     DEFAULT_INITIALIZER(0);
+
+    /// Level height, in texels
+    Uint32 Height    DEFAULT_INITIALIZER(0);
+
+    /// The number of tiles in a row
+    Uint32 TilesX    DEFAULT_INITIALIZER(0);
+
+    /// The number of tile rows
+    Uint32 TilesY    DEFAULT_INITIALIZER(0);
+
+    /// Index of the first tile of this level in the page table
+    Uint32 FirstTile DEFAULT_INITIALIZER(0);
+};
+typedef struct VirtualTextureMipLevel VirtualTextureMipLevel;
+
+/// Virtual texture page entry.
+struct VirtualTexturePageEntry
+{
+    /// Offset of the page data from the beginning of the file
+    Uint64 Offset DEFAULT_INITIALIZER(0);
+
+    /// Size of the page data, in bytes
+    Uint32 Size   DEFAULT_INITIALIZER(0);
+
+    /// Page flags, see Diligent::VIRTUAL_TEXTURE_PAGE_FLAGS
+    VIRTUAL_TEXTURE_PAGE_FLAGS Flags DEFAULT_INITIALIZER(VIRTUAL_TEXTURE_PAGE_FLAG_NONE);
+};
+typedef struct VirtualTexturePageEntry VirtualTexturePageEntry;
+
+
+/// Parameters of the BuildVirtualTexture function.
+struct VirtualTextureBuildAttribs
+{
+    /// Source image.
+    ///
+    /// \remarks    Only 8-bit images are supported. Three-component images are expanded to four components.
+    struct Image* pImage DEFAULT_INITIALIZER(nullptr);
+
+    /// Size of the page interior, in texels.
+    Uint32 PageSize DEFAULT_INITIALIZER(128);
+
+    /// Size of the border on each side of the page, in texels.
+    Uint32 BorderSize DEFAULT_INITIALIZER(4);
+
+    /// The number of mip levels. If zero, levels are generated until the level fits into a single page.
+    Uint32 MipLevels DEFAULT_INITIALIZER(0);
+
+    /// Whether the image is in sRGB space. If true, the mip levels of four-component images
+    /// are filtered in linear space, and the texture format is TEX_FORMAT_RGBA8_UNORM_SRGB.
+    Bool IsSRGB DEFAULT_INITIALIZER(False);
+
+    /// Whether to compress the pages with zlib. A page is only stored compressed if this reduces its size.
+    Bool CompressPages DEFAULT_INITIALIZER(False);
+
+    /// Optional thread pool to use for parallel processing.
+    struct IThreadPool* pThreadPool DEFAULT_INITIALIZER(nullptr);
+};
+typedef struct VirtualTextureBuildAttribs VirtualTextureBuildAttribs;
+
+/// Builds the virtual texture page file from the image.
+
+/// \param [in]  Attribs      - Build attributes, see Diligent::VirtualTextureBuildAttribs.
+/// \param [out] ppPageFile   - Memory location where pointer to the data blob that contains
+///                             the page file will be written, see Diligent::VirtualTextureHeader.
+///
+/// \remarks    The mip pyramid is generated with the box filter from the source image.
+///             Every level is then cut into tiles of PageSize x PageSize texels, and each tile is
+///             padded with BorderSize texels taken from the neighboring tiles of the same level, so that
+///             filtering at page edges matches filtering of the full level. Texels outside of the level
+///             are clamped to the level edge. Tiles that have the same constant color share the same page.
+void DILIGENT_GLOBAL_FUNCTION(BuildVirtualTexture)(const VirtualTextureBuildAttribs REF Attribs,
+                                                   IDataBlob**                          ppPageFile);
+
+/// Returns the page entry of the virtual texture tile.
+
+/// \param [in]  pTableData    - Data at the beginning of the page file. Only the tables are accessed,
+///                              so when the file is streamed, it is enough to provide the tables.
+/// \param [in]  TableDataSize - Size of the data pointed to by pTableData, in bytes.
+///                              The data must include all tables.
+/// \param [in]  FileSize      - Size of the whole page file, in bytes.
+///                              The page data of the entry must be located within this size.
+/// \param [in]  MipLevel      - Mip level.
+/// \param [in]  TileX         - Tile column.
+/// \param [in]  TileY         - Tile row.
+/// \param [out] Entry         - Page entry of the tile.
+///
+/// \return     True if the entry was found, and False if the tables are invalid or incomplete,
+///             the page data is outside of the file, or the tile is out of range.
+///
+/// \remarks    When the whole file is in memory, pass its size as both TableDataSize and FileSize.
+Bool DILIGENT_GLOBAL_FUNCTION(GetVirtualTexturePage)(const void*                 pTableData,
+                                                     size_t                      TableDataSize,
+                                                     Uint64                      FileSize,
+                                                     Uint32                      MipLevel,
+                                                     Uint32                      TileX,
+                                                     Uint32                      TileY,
+                                                     VirtualTexturePageEntry REF Entry);
+
+/// Decodes the virtual texture page.
+
+/// \param [in]  Header     - Page file header.
+/// \param [in]  Entry      - Page entry.
+/// \param [in]  pPageData  - Page data (Entry.Size bytes at Entry.Offset in the page file).
+/// \param [out] pTexels    - Decoded texels. The buffer must hold (PageSize + 2 * BorderSize)^2 texels
+///                           with tightly packed rows.
+///
+/// \return     True if the page was decoded successfully, and False otherwise.
+Bool DILIGENT_GLOBAL_FUNCTION(DecodeVirtualTexturePage)(const VirtualTextureHeader REF    Header,
+                                                        const VirtualTexturePageEntry REF Entry,
+                                                        const void*                       pPageData,
+                                                        void*                             pTexels);
+
+// clang-format on
+
+#include "../../../DiligentCore/Primitives/interface/UndefGlobalFuncHelperMacros.h"
+
+DILIGENT_END_NAMESPACE // namespace Diligent
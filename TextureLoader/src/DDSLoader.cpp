@@ -1158,9 +1158,17 @@ bool SaveTextureAsDDS(const char*        FilePath,
 
         case RESOURCE_DIM_TEX_2D:
         case RESOURCE_DIM_TEX_2D_ARRAY:
+            Header10.resourceDimension = D3D11_RESOURCE_DIMENSION_TEXTURE2D;
+            break;
+
         case RESOURCE_DIM_TEX_CUBE:
         case RESOURCE_DIM_TEX_CUBE_ARRAY:
+            VERIFY((ArraySize % 6) == 0, "Cubemap array size must be a multiple of 6");
             Header10.resourceDimension = D3D11_RESOURCE_DIMENSION_TEXTURE2D;
+            // DX10 header stores the number of cubes rather than the number of faces
+            Header10.miscFlag  = D3D11_RESOURCE_MISC_TEXTURECUBE;
+            Header10.arraySize = ArraySize / 6;
+            Header.caps2       = DDS_CUBEMAP_ALLFACES;
             break;
 
         case RESOURCE_DIM_TEX_3D:
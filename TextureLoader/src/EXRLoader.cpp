@@ -0,0 +1,1131 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "EXRLoader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "zlib.h"
+
+#include "DataBlob.h"
+#include "Errors.hpp"
+#include "DebugUtilities.hpp"
+#include "Align.hpp"
+#include "ParallelFor.hpp"
+#include "HalfFloat.hpp"
+
+// OpenEXR file layout reference:
+// https://openexr.com/en/latest/OpenEXRFileLayout.html
+
+namespace Diligent
+{
+
+namespace
+{
+
+constexpr Uint32 EXRMagic = 20000630;
+
+constexpr Uint32 EXRVersionFlagTiled     = 0x200;
+constexpr Uint32 EXRVersionFlagNonImage  = 0x800;
+constexpr Uint32 EXRVersionFlagMultiPart = 0x1000;
+
+enum EXR_COMPRESSION : Uint8
+{
+    EXR_COMPRESSION_NONE = 0,
+    EXR_COMPRESSION_RLE,
+    EXR_COMPRESSION_ZIPS,
+    EXR_COMPRESSION_ZIP,
+    EXR_COMPRESSION_PIZ,
+    EXR_COMPRESSION_PXR24,
+    EXR_COMPRESSION_B44,
+    EXR_COMPRESSION_B44A,
+    EXR_COMPRESSION_DWAA,
+    EXR_COMPRESSION_DWAB,
+    EXR_COMPRESSION_COUNT
+};
+
+enum EXR_PIXEL_TYPE : Uint32
+{
+    EXR_PIXEL_TYPE_UINT = 0,
+    EXR_PIXEL_TYPE_HALF,
+    EXR_PIXEL_TYPE_FLOAT,
+};
+
+struct EXRChannel
+{
+    std::string    Name;
+    EXR_PIXEL_TYPE PixelType = EXR_PIXEL_TYPE_HALF;
+
+    Uint32 GetSize() const
+    {
+        return PixelType == EXR_PIXEL_TYPE_HALF ? 2 : 4;
+    }
+};
+
+struct EXRHeader
+{
+    std::vector<EXRChannel> Channels;
+
+    EXR_COMPRESSION Compression = EXR_COMPRESSION_COUNT;
+
+    Int32 XMin = 0;
+    Int32 YMin = 0;
+    Int32 XMax = -1;
+    Int32 YMax = -1;
+
+    bool   IsTiled    = false;
+    Uint32 TileWidth  = 0;
+    Uint32 TileHeight = 0;
+
+    Uint32 GetWidth() const { return static_cast<Uint32>(Int64{XMax} - Int64{XMin} + 1); }
+    Uint32 GetHeight() const { return static_cast<Uint32>(Int64{YMax} - Int64{YMin} + 1); }
+
+    // The total size of all channels of one pixel
+    Uint32 GetPixelSize() const
+    {
+        Uint32 Size = 0;
+        for (const auto& Channel : Channels)
+            Size += Channel.GetSize();
+        return Size;
+    }
+};
+
+// Bounds-checked little-endian reader
+class EXRReader
+{
+public:
+    EXRReader(const Uint8* pData, size_t Size) :
+        m_pData{pData},
+        m_Size{Size}
+    {}
+
+    template <typename T>
+    T Read()
+    {
+        T Value;
+        memcpy(&Value, ReadBytes(sizeof(T)), sizeof(T));
+        return Value;
+    }
+
+    const Uint8* ReadBytes(size_t Size)
+    {
+        if (Size > m_Size - m_Offset)
+            LOG_ERROR_AND_THROW("Unexpected end of EXR data");
+        const auto* pBytes = m_pData + m_Offset;
+        m_Offset += Size;
+        return pBytes;
+    }
+
+    std::string ReadString()
+    {
+        const auto* pStart = m_pData + m_Offset;
+        const auto* pEnd   = static_cast<const Uint8*>(memchr(pStart, 0, m_Size - m_Offset));
+        if (pEnd == nullptr)
+            LOG_ERROR_AND_THROW("Unexpected end of EXR data");
+        m_Offset += pEnd - pStart + 1;
+        return std::string{reinterpret_cast<const char*>(pStart), reinterpret_cast<const char*>(pEnd)};
+    }
+
+    size_t GetOffset() const { return m_Offset; }
+
+private:
+    const Uint8* const m_pData;
+    const size_t       m_Size;
+    size_t             m_Offset = 0;
+};
+
+void ReadChannelList(EXRReader& Reader, std::vector<EXRChannel>& Channels)
+{
+    for (auto Name = Reader.ReadString(); !Name.empty(); Name = Reader.ReadString())
+    {
+        EXRChannel Channel;
+        Channel.Name = std::move(Name);
+
+        const auto PixelType = Reader.Read<Uint32>();
+        if (PixelType > EXR_PIXEL_TYPE_FLOAT)
+            LOG_ERROR_AND_THROW("Unknown pixel type (", PixelType, ") of channel '", Channel.Name, "'");
+        Channel.PixelType = static_cast<EXR_PIXEL_TYPE>(PixelType);
+
+        Reader.ReadBytes(4); // pLinear and reserved bytes
+        const auto XSampling = Reader.Read<Int32>();
+        const auto YSampling = Reader.Read<Int32>();
+        if (XSampling != 1 || YSampling != 1)
+            LOG_ERROR_AND_THROW("Channel '", Channel.Name, "' is subsampled (", XSampling, " x ", YSampling, "). Subsampled channels are not supported");
+
+        Channels.emplace_back(std::move(Channel));
+    }
+}
+
+EXRHeader ReadHeader(EXRReader& Reader)
+{
+    if (Reader.Read<Uint32>() != EXRMagic)
+        LOG_ERROR_AND_THROW("Invalid EXR file signature");
+
+    const auto Version = Reader.Read<Uint32>();
+    if ((Version & 0xFFu) != 2)
+        LOG_ERROR_AND_THROW("Unsupported EXR version (", Version & 0xFFu, ")");
+    if (Version & (EXRVersionFlagNonImage | EXRVersionFlagMultiPart))
+        LOG_ERROR_AND_THROW("Deep and multi-part EXR files are not supported");
+
+    EXRHeader Header;
+    Header.IsTiled = (Version & EXRVersionFlagTiled) != 0;
+
+    bool HasDataWindow = false;
+    bool HasTiles      = false;
+    for (auto Name = Reader.ReadString(); !Name.empty(); Name = Reader.ReadString())
+    {
+        const auto Type = Reader.ReadString();
+        const auto Size = Reader.Read<Int32>();
+        if (Size < 0)
+            LOG_ERROR_AND_THROW("Invalid size (", Size, ") of EXR attribute '", Name, "'");
+
+        EXRReader AttribReader{Reader.ReadBytes(static_cast<size_t>(Size)), static_cast<size_t>(Size)};
+        if (Name == "channels" && Type == "chlist")
+        {
+            ReadChannelList(AttribReader, Header.Channels);
+        }
+        else if (Name == "compression" && Type == "compression")
+        {
+            const auto Compression = AttribReader.Read<Uint8>();
+            if (Compression >= EXR_COMPRESSION_COUNT)
+                LOG_ERROR_AND_THROW("Unknown EXR compression (", Uint32{Compression}, ")");
+            Header.Compression = static_cast<EXR_COMPRESSION>(Compression);
+        }
+        else if (Name == "dataWindow" && Type == "box2i")
+        {
+            Header.XMin   = AttribReader.Read<Int32>();
+            Header.YMin   = AttribReader.Read<Int32>();
+            Header.XMax   = AttribReader.Read<Int32>();
+            Header.YMax   = AttribReader.Read<Int32>();
+            HasDataWindow = true;
+        }
+        else if (Name == "tiles" && Type == "tiledesc")
+        {
+            Header.TileWidth  = AttribReader.Read<Uint32>();
+            Header.TileHeight = AttribReader.Read<Uint32>();
+            HasTiles          = true;
+        }
+    }
+
+    if (Header.Channels.empty())
+        LOG_ERROR_AND_THROW("EXR file does not define any channels");
+    if (Header.Compression == EXR_COMPRESSION_COUNT)
+        LOG_ERROR_AND_THROW("EXR file does not define compression");
+    if (!HasDataWindow || Header.XMax < Header.XMin || Header.YMax < Header.YMin)
+        LOG_ERROR_AND_THROW("EXR file does not define a valid data window");
+    if (Header.IsTiled && (!HasTiles || Header.TileWidth == 0 || Header.TileHeight == 0))
+        LOG_ERROR_AND_THROW("Tiled EXR file does not define a valid tile size");
+
+    return Header;
+}
+
+Uint32 GetLinesPerBlock(EXR_COMPRESSION Compression)
+{
+    switch (Compression)
+    {
+        case EXR_COMPRESSION_NONE:
+        case EXR_COMPRESSION_RLE:
+        case EXR_COMPRESSION_ZIPS:
+            return 1;
+
+        case EXR_COMPRESSION_ZIP:
+        case EXR_COMPRESSION_PXR24:
+            return 16;
+
+        case EXR_COMPRESSION_PIZ:
+        case EXR_COMPRESSION_B44:
+        case EXR_COMPRESSION_B44A:
+        case EXR_COMPRESSION_DWAA:
+            return 32;
+
+        case EXR_COMPRESSION_DWAB:
+            return 256;
+
+        default:
+            UNEXPECTED("Unexpected compression");
+            return 1;
+    }
+}
+
+const char* GetCompressionName(EXR_COMPRESSION Compression)
+{
+    static constexpr const char* Names[] = {"NONE", "RLE", "ZIPS", "ZIP", "PIZ", "PXR24", "B44", "B44A", "DWAA", "DWAB"};
+    static_assert(_countof(Names) == EXR_COMPRESSION_COUNT, "Please update the names array");
+    return Compression < EXR_COMPRESSION_COUNT ? Names[Compression] : "<unknown>";
+}
+
+// Reverts the byte reordering and delta predictor applied by RLE and ZIP compressors
+void UndoPredictorAndReorder(Uint8* pData, size_t Size, Uint8* pDst)
+{
+    for (size_t i = 1; i < Size; ++i)
+        pData[i] = static_cast<Uint8>(pData[i - 1] + pData[i] - 128);
+
+    const Uint8* pFirstHalf  = pData;
+    const Uint8* pSecondHalf = pData + (Size + 1) / 2;
+    for (size_t i = 0; i < Size; ++i)
+        pDst[i] = (i & 1) ? *(pSecondHalf++) : *(pFirstHalf++);
+}
+
+void DecodeRLE(const Uint8* pSrc, size_t SrcSize, Uint8* pDst, size_t DstSize)
+{
+    const auto* const pSrcEnd = pSrc + SrcSize;
+    const auto* const pDstEnd = pDst + DstSize;
+    while (pSrc < pSrcEnd)
+    {
+        const auto Count = static_cast<Int8>(*(pSrc++));
+        if (Count < 0)
+        {
+            const size_t Len = static_cast<size_t>(-Count);
+            if (Len > static_cast<size_t>(pSrcEnd - pSrc) || Len > static_cast<size_t>(pDstEnd - pDst))
+                LOG_ERROR_AND_THROW("Corrupted RLE data");
+            memcpy(pDst, pSrc, Len);
+            pSrc += Len;
+            pDst += Len;
+        }
+        else
+        {
+            const size_t Len = static_cast<size_t>(Count) + 1;
+            if (pSrc == pSrcEnd || Len > static_cast<size_t>(pDstEnd - pDst))
+                LOG_ERROR_AND_THROW("Corrupted RLE data");
+            memset(pDst, *(pSrc++), Len);
+            pDst += Len;
+        }
+    }
+    if (pDst != pDstEnd)
+        LOG_ERROR_AND_THROW("Corrupted RLE data");
+}
+
+// PIZ compression combines a lookup table that compacts the range of 16-bit values,
+// Haar wavelet transform and Huffman coding.
+namespace PIZ
+{
+
+constexpr Uint32 USHORT_RANGE = 1 << 16;
+constexpr Uint32 BITMAP_SIZE  = USHORT_RANGE >> 3;
+
+constexpr Uint32 HUF_ENCBITS = 16;
+constexpr Uint32 HUF_DECBITS = 14;
+constexpr Uint32 HUF_ENCSIZE = (1 << HUF_ENCBITS) + 1;
+constexpr Uint32 HUF_DECSIZE = 1 << HUF_DECBITS;
+constexpr Uint32 HUF_DECMASK = HUF_DECSIZE - 1;
+
+constexpr Uint32 SHORT_ZEROCODE_RUN = 59;
+constexpr Uint32 LONG_ZEROCODE_RUN  = 63;
+constexpr Uint32 SHORTEST_LONG_RUN  = 2 + LONG_ZEROCODE_RUN - SHORT_ZEROCODE_RUN;
+
+// Code length is stored in the lower 6 bits, the code itself in the upper bits
+inline Uint32 HufLength(Uint64 Code) { return static_cast<Uint32>(Code & 63u); }
+inline Uint64 HufCode(Uint64 Code) { return Code >> 6u; }
+
+struct HufDec
+{
+    Uint32              Len = 0; // Code length for short codes, zero for long codes
+    Uint32              Lit = 0; // Symbol for short codes
+    std::vector<Uint32> Long;    // Symbols of long codes that have this prefix
+};
+
+class BitReader
+{
+public:
+    BitReader(const Uint8* pData, const Uint8* pEnd) :
+        m_pData{pData},
+        m_pEnd{pEnd}
+    {}
+
+    Uint64 GetBits(Uint32 NumBits)
+    {
+        while (m_NumBits < NumBits)
+            GetByte();
+        m_NumBits -= NumBits;
+        return (m_Bits >> m_NumBits) & ((Uint64{1} << NumBits) - 1);
+    }
+
+    void GetByte()
+    {
+        if (m_pData >= m_pEnd)
+            LOG_ERROR_AND_THROW("Unexpected end of Huffman-encoded data");
+        m_Bits = (m_Bits << 8u) | *(m_pData++);
+        m_NumBits += 8;
+    }
+
+    bool AtEnd() const { return m_pData >= m_pEnd; }
+
+    const Uint8* GetPtr() const { return m_pData; }
+
+    Uint64 m_Bits    = 0;
+    Uint32 m_NumBits = 0;
+
+private:
+    const Uint8*       m_pData;
+    const Uint8* const m_pEnd;
+};
+
+// Assigns canonical codes to the symbols from the code lengths
+void BuildCanonicalCodeTable(std::vector<Uint64>& HCode)
+{
+    Uint64 n[59] = {};
+    for (auto l : HCode)
+        n[l] += 1;
+
+    Uint64 c = 0;
+    for (int i = 58; i > 0; --i)
+    {
+        const Uint64 nc = (c + n[i]) >> 1u;
+        n[i]            = c;
+        c               = nc;
+    }
+
+    for (auto& Code : HCode)
+    {
+        const auto l = static_cast<Uint32>(Code);
+        if (l > 0)
+            Code = l | (n[l]++ << 6u);
+    }
+}
+
+const Uint8* UnpackEncTable(const Uint8* pData, const Uint8* pEnd, Uint32 im, Uint32 iM, std::vector<Uint64>& HCode)
+{
+    HCode.assign(HUF_ENCSIZE, 0);
+
+    BitReader Reader{pData, pEnd};
+    for (; im <= iM; ++im)
+    {
+        const auto l = static_cast<Uint32>(Reader.GetBits(6));
+        if (l == LONG_ZEROCODE_RUN)
+        {
+            const auto ZeroRun = static_cast<Uint32>(Reader.GetBits(8)) + SHORTEST_LONG_RUN;
+            if (im + ZeroRun > iM + 1)
+                LOG_ERROR_AND_THROW("Huffman table is too long");
+            im += ZeroRun - 1;
+        }
+        else if (l >= SHORT_ZEROCODE_RUN)
+        {
+            const auto ZeroRun = l - SHORT_ZEROCODE_RUN + 2;
+            if (im + ZeroRun > iM + 1)
+                LOG_ERROR_AND_THROW("Huffman table is too long");
+            im += ZeroRun - 1;
+        }
+        else
+        {
+            HCode[im] = l;
+        }
+    }
+
+    BuildCanonicalCodeTable(HCode);
+    return Reader.GetPtr();
+}
+
+void BuildDecTable(const std::vector<Uint64>& HCode, Uint32 im, Uint32 iM, std::vector<HufDec>& HDec)
+{
+    HDec.clear();
+    HDec.resize(HUF_DECSIZE);
+    for (; im <= iM; ++im)
+    {
+        const auto c = HufCode(HCode[im]);
+        const auto l = HufLength(HCode[im]);
+        if (l == 0)
+            continue;
+        if (c >> l)
+            LOG_ERROR_AND_THROW("Invalid Huffman table entry");
+
+        if (l > HUF_DECBITS)
+        {
+            // Long code: add a secondary entry
+            auto& Entry = HDec[static_cast<size_t>(c >> (l - HUF_DECBITS))];
+            if (Entry.Len != 0)
+                LOG_ERROR_AND_THROW("Invalid Huffman table entry");
+            Entry.Long.push_back(im);
+        }
+        else
+        {
+            // Short code: init all primary entries
+            const auto First = static_cast<size_t>(c << (HUF_DECBITS - l));
+            for (size_t i = 0; i < (size_t{1} << (HUF_DECBITS - l)); ++i)
+            {
+                auto& Entry = HDec[First + i];
+                if (Entry.Len != 0 || !Entry.Long.empty())
+                    LOG_ERROR_AND_THROW("Invalid Huffman table entry");
+                Entry.Len = l;
+                Entry.Lit = im;
+            }
+        }
+    }
+}
+
+class HufOutput
+{
+public:
+    HufOutput(Uint16* pOut, size_t Size) :
+        m_pStart{pOut},
+        m_pOut{pOut},
+        m_pEnd{pOut + Size}
+    {}
+
+    void PutCode(Uint32 Symbol, Uint32 RunLengthCode, BitReader& Reader)
+    {
+        if (Symbol == RunLengthCode)
+        {
+            if (Reader.m_NumBits < 8)
+                Reader.GetByte();
+            Reader.m_NumBits -= 8;
+            const auto RunLength = static_cast<Uint8>(Reader.m_Bits >> Reader.m_NumBits);
+            if (RunLength > m_pEnd - m_pOut)
+                LOG_ERROR_AND_THROW("Too much Huffman-encoded data");
+            if (m_pOut == m_pStart)
+                LOG_ERROR_AND_THROW("Invalid Huffman run length code");
+            const auto Value = m_pOut[-1];
+            for (Uint32 i = 0; i < RunLength; ++i)
+                *(m_pOut++) = Value;
+        }
+        else
+        {
+            if (m_pOut >= m_pEnd)
+                LOG_ERROR_AND_THROW("Too much Huffman-encoded data");
+            *(m_pOut++) = static_cast<Uint16>(Symbol);
+        }
+    }
+
+    bool IsFull() const { return m_pOut == m_pEnd; }
+
+private:
+    Uint16* const       m_pStart;
+    Uint16*             m_pOut;
+    const Uint16* const m_pEnd;
+};
+
+void HufDecode(const std::vector<Uint64>& HCode, const std::vector<HufDec>& HDec, const Uint8* pData, Uint32 NumBits, Uint32 RunLengthCode, Uint16* pOut, size_t OutSize)
+{
+    BitReader Reader{pData, pData + (NumBits + 7) / 8};
+    HufOutput Output{pOut, OutSize};
+
+    while (!Reader.AtEnd())
+    {
+        Reader.GetByte();
+        while (Reader.m_NumBits >= HUF_DECBITS)
+        {
+            const auto& Entry = HDec[(Reader.m_Bits >> (Reader.m_NumBits - HUF_DECBITS)) & HUF_DECMASK];
+            if (Entry.Len != 0)
+            {
+                Reader.m_NumBits -= Entry.Len;
+                Output.PutCode(Entry.Lit, RunLengthCode, Reader);
+            }
+            else
+            {
+                if (Entry.Long.empty())
+                    LOG_ERROR_AND_THROW("Invalid Huffman code");
+
+                bool Found = false;
+                for (auto Symbol : Entry.Long)
+                {
+                    const auto l = HufLength(HCode[Symbol]);
+                    while (Reader.m_NumBits < l && !Reader.AtEnd())
+                        Reader.GetByte();
+                    if (Reader.m_NumBits >= l &&
+                        HufCode(HCode[Symbol]) == ((Reader.m_Bits >> (Reader.m_NumBits - l)) & ((Uint64{1} << l) - 1)))
+                    {
+                        Reader.m_NumBits -= l;
+                        Output.PutCode(Symbol, RunLengthCode, Reader);
+                        Found = true;
+                        break;
+                    }
+                }
+                if (!Found)
+                    LOG_ERROR_AND_THROW("Invalid Huffman code");
+            }
+        }
+    }
+
+    // Get remaining short codes
+    const Uint32 Padding = (8 - NumBits) & 7u;
+    if (Reader.m_NumBits < Padding)
+        LOG_ERROR_AND_THROW("Invalid Huffman data size");
+    Reader.m_Bits >>= Padding;
+    Reader.m_NumBits -= Padding;
+    while (Reader.m_NumBits > 0)
+    {
+        const auto& Entry = HDec[(Reader.m_Bits << (HUF_DECBITS - Reader.m_NumBits)) & HUF_DECMASK];
+        if (Entry.Len == 0 || Entry.Len > Reader.m_NumBits)
+            LOG_ERROR_AND_THROW("Invalid Huffman code");
+        Reader.m_NumBits -= Entry.Len;
+        Output.PutCode(Entry.Lit, RunLengthCode, Reader);
+    }
+
+    if (!Output.IsFull())
+        LOG_ERROR_AND_THROW("Not enough Huffman-encoded data");
+}
+
+void HufUncompress(const Uint8* pData, size_t Size, Uint16* pOut, size_t OutSize)
+{
+    if (Size == 0)
+    {
+        if (OutSize != 0)
+            LOG_ERROR_AND_THROW("Not enough Huffman-encoded data");
+        return;
+    }
+
+    EXRReader Reader{pData, Size};
+
+    const auto im = Reader.Read<Uint32>();
+    const auto iM = Reader.Read<Uint32>();
+    Reader.ReadBytes(4); // Table length
+    const auto NumBits = Reader.Read<Uint32>();
+    Reader.ReadBytes(4); // Reserved
+    if (im >= HUF_ENCSIZE || iM >= HUF_ENCSIZE || im > iM)
+        LOG_ERROR_AND_THROW("Invalid Huffman table size");
+
+    std::vector<Uint64> HCode;
+    const auto*         pCodes = UnpackEncTable(pData + Reader.GetOffset(), pData + Size, im, iM, HCode);
+    if ((Uint64{NumBits} + 7) / 8 > static_cast<Uint64>(pData + Size - pCodes))
+        LOG_ERROR_AND_THROW("Not enough Huffman-encoded data");
+
+    std::vector<HufDec> HDec;
+    BuildDecTable(HCode, im, iM, HDec);
+    HufDecode(HCode, HDec, pCodes, NumBits, iM, pOut, OutSize);
+}
+
+inline void Wdec14(Uint16 l, Uint16 h, Uint16& a, Uint16& b)
+{
+    const Int16 ls = static_cast<Int16>(l);
+    const Int16 hs = static_cast<Int16>(h);
+
+    const int hi = hs;
+    const int ai = ls + (hi & 1) + (hi >> 1);
+
+    a = static_cast<Uint16>(static_cast<Int16>(ai));
+    b = static_cast<Uint16>(static_cast<Int16>(ai - hi));
+}
+
+inline void Wdec16(Uint16 l, Uint16 h, Uint16& a, Uint16& b)
+{
+    constexpr int A_OFFSET = 1 << 15;
+    constexpr int MOD_MASK = (1 << 16) - 1;
+
+    const int m  = l;
+    const int d  = h;
+    const int bb = (m - (d >> 1)) & MOD_MASK;
+    const int aa = (d + bb - A_OFFSET) & MOD_MASK;
+
+    b = static_cast<Uint16>(bb);
+    a = static_cast<Uint16>(aa);
+}
+
+// 2D inverse Haar wavelet transform
+void Wav2Decode(Uint16* pIn, int nx, int ox, int ny, int oy, Uint16 mx)
+{
+    const bool w14 = mx < (1 << 14);
+    const auto Wdec = w14 ? Wdec14 : Wdec16;
+
+    const int n = std::min(nx, ny);
+    int       p = 1;
+    while (p <= n)
+        p <<= 1;
+    p >>= 1;
+    int p2 = p;
+    p >>= 1;
+
+    // Hierarchical loop on smaller dimension n
+    while (p >= 1)
+    {
+        Uint16*       py  = pIn;
+        Uint16* const ey  = pIn + oy * (ny - p2);
+        const int     oy1 = oy * p;
+        const int     oy2 = oy * p2;
+        const int     ox1 = ox * p;
+        const int     ox2 = ox * p2;
+        Uint16        i00, i01, i10, i11;
+
+        for (; py <= ey; py += oy2)
+        {
+            Uint16*       px = py;
+            Uint16* const ex = py + ox * (nx - p2);
+
+            for (; px <= ex; px += ox2)
+            {
+                Uint16* p01 = px + ox1;
+                Uint16* p10 = px + oy1;
+                Uint16* p11 = p10 + ox1;
+
+                Wdec(*px, *p10, i00, i10);
+                Wdec(*p01, *p11, i01, i11);
+                Wdec(i00, i01, *px, *p01);
+                Wdec(i10, i11, *p10, *p11);
+            }
+
+            // Decode odd column
+            if (nx & p)
+            {
+                Uint16* p10 = px + oy1;
+                Wdec(*px, *p10, i00, *p10);
+                *px = i00;
+            }
+        }
+
+        // Decode odd line
+        if (ny & p)
+        {
+            Uint16*       px = py;
+            Uint16* const ex = py + ox * (nx - p2);
+            for (; px <= ex; px += ox2)
+            {
+                Uint16* p01 = px + ox1;
+                Wdec(*px, *p01, i00, *p01);
+                *px = i00;
+            }
+        }
+
+        p2 = p;
+        p >>= 1;
+    }
+}
+
+void Uncompress(const Uint8* pSrc, size_t SrcSize, const std::vector<EXRChannel>& Channels, Uint32 Width, Uint32 Height, Uint8* pDst, size_t DstSize)
+{
+    EXRReader Reader{pSrc, SrcSize};
+
+    // Range compression bitmap
+    std::vector<Uint8> Bitmap(BITMAP_SIZE);
+    const auto         MinNonZero = Reader.Read<Uint16>();
+    const auto         MaxNonZero = Reader.Read<Uint16>();
+    if (MaxNonZero >= BITMAP_SIZE)
+        LOG_ERROR_AND_THROW("Invalid PIZ bitmap size");
+    if (MinNonZero <= MaxNonZero)
+        memcpy(&Bitmap[MinNonZero], Reader.ReadBytes(MaxNonZero - MinNonZero + 1), MaxNonZero - MinNonZero + 1);
+
+    // Reverse lookup table
+    std::vector<Uint16> LUT(USHORT_RANGE);
+    Uint32              k = 0;
+    for (Uint32 i = 0; i < USHORT_RANGE; ++i)
+    {
+        if (i == 0 || (Bitmap[i >> 3] & (1 << (i & 7))))
+            LUT[k++] = static_cast<Uint16>(i);
+    }
+    const auto MaxValue = static_cast<Uint16>(k - 1);
+
+    // Huffman decoding
+    const auto Length = Reader.Read<Int32>();
+    if (Length < 0 || static_cast<size_t>(Length) > SrcSize - Reader.GetOffset())
+        LOG_ERROR_AND_THROW("Invalid PIZ data length");
+
+    VERIFY_EXPR(DstSize % 2 == 0);
+    std::vector<Uint16> Data(DstSize / 2);
+    HufUncompress(Reader.ReadBytes(static_cast<size_t>(Length)), static_cast<size_t>(Length), Data.data(), Data.size());
+
+    // Wavelet decoding. Every channel is stored as a separate plane.
+    Uint16* pPlane = Data.data();
+    for (const auto& Channel : Channels)
+    {
+        const int Size = static_cast<int>(Channel.GetSize() / 2);
+        for (int j = 0; j < Size; ++j)
+            Wav2Decode(pPlane + j, static_cast<int>(Width), Size, static_cast<int>(Height), static_cast<int>(Width) * Size, MaxValue);
+        pPlane += size_t{Width} * Height * Size;
+    }
+
+    // Expand the pixel data to the original range
+    for (auto& Value : Data)
+        Value = LUT[Value];
+
+    // Interleave the channel planes into scanlines
+    std::vector<const Uint16*> ChannelData(Channels.size());
+    pPlane = Data.data();
+    for (size_t c = 0; c < Channels.size(); ++c)
+    {
+        ChannelData[c] = pPlane;
+        pPlane += size_t{Width} * Height * (Channels[c].GetSize() / 2);
+    }
+    for (Uint32 y = 0; y < Height; ++y)
+    {
+        for (size_t c = 0; c < Channels.size(); ++c)
+        {
+            const size_t RowSize = size_t{Width} * Channels[c].GetSize();
+            memcpy(pDst, ChannelData[c], RowSize);
+            ChannelData[c] += RowSize / 2;
+            pDst += RowSize;
+        }
+    }
+}
+
+} // namespace PIZ
+
+// Describes how the image components are produced from the EXR channels
+struct EXROutputLayout
+{
+    VALUE_TYPE ComponentType = VT_UNDEFINED;
+    Uint32     NumComponents = 0;
+    Int32      Channels[4]   = {-1, -1, -1, -1}; // Channel index, or -1 if the component is filled with zero
+};
+
+EXROutputLayout SelectOutputLayout(const std::vector<EXRChannel>& Channels)
+{
+    const auto FindChannel = [&Channels](const char* Name) {
+        for (size_t i = 0; i < Channels.size(); ++i)
+        {
+            if (Channels[i].Name == Name)
+                return static_cast<Int32>(i);
+        }
+        return -1;
+    };
+
+    const auto R = FindChannel("R");
+    const auto G = FindChannel("G");
+    const auto B = FindChannel("B");
+    const auto A = FindChannel("A");
+    const auto Y = FindChannel("Y");
+
+    EXROutputLayout Layout;
+    if (R >= 0 || G >= 0 || B >= 0)
+    {
+        Layout.NumComponents = A >= 0 ? 4 : (B >= 0 ? 3 : (G >= 0 ? 2 : 1));
+        Layout.Channels[0]   = R;
+        Layout.Channels[1]   = G;
+        Layout.Channels[2]   = B;
+        Layout.Channels[3]   = A;
+    }
+    else if (Y >= 0)
+    {
+        Layout.NumComponents = A >= 0 ? 2 : 1;
+        Layout.Channels[0]   = Y;
+        Layout.Channels[1]   = A;
+    }
+    else
+    {
+        Layout.NumComponents = std::min(static_cast<Uint32>(Channels.size()), 4u);
+        for (Uint32 c = 0; c < Layout.NumComponents; ++c)
+            Layout.Channels[c] = static_cast<Int32>(c);
+    }
+
+    bool AllHalf = true;
+    bool AllUint = true;
+    for (Uint32 c = 0; c < Layout.NumComponents; ++c)
+    {
+        if (Layout.Channels[c] < 0)
+            continue;
+        const auto PixelType = Channels[Layout.Channels[c]].PixelType;
+        AllHalf              = AllHalf && PixelType == EXR_PIXEL_TYPE_HALF;
+        AllUint              = AllUint && PixelType == EXR_PIXEL_TYPE_UINT;
+    }
+    Layout.ComponentType = AllHalf ? VT_FLOAT16 : (AllUint ? VT_UINT32 : VT_FLOAT32);
+
+    return Layout;
+}
+
+struct EXRBlock
+{
+    size_t ChunkOffset = 0;
+
+    // Block position and size relative to the data window
+    Uint32 X      = 0;
+    Uint32 Y      = 0;
+    Uint32 Width  = 0;
+    Uint32 Height = 0;
+};
+
+class EXRBlockDecoder
+{
+public:
+    EXRBlockDecoder(const EXRHeader& Header, const EXROutputLayout& Layout, const Uint8* pFileData, size_t FileSize) :
+        m_Header{Header},
+        m_Layout{Layout},
+        m_pFileData{pFileData},
+        m_FileSize{FileSize}
+    {}
+
+    void Decode(const EXRBlock& Block, Uint8* pDstPixels, size_t DstStride)
+    {
+        if (Block.ChunkOffset >= m_FileSize)
+            LOG_ERROR_AND_THROW("Invalid EXR chunk offset");
+
+        EXRReader Reader{m_pFileData + Block.ChunkOffset, m_FileSize - Block.ChunkOffset};
+        if (m_Header.IsTiled)
+        {
+            const auto TileX  = Reader.Read<Int32>();
+            const auto TileY  = Reader.Read<Int32>();
+            const auto LevelX = Reader.Read<Int32>();
+            const auto LevelY = Reader.Read<Int32>();
+            if (LevelX != 0 || LevelY != 0 ||
+                Int64{TileX} * m_Header.TileWidth != Block.X ||
+                Int64{TileY} * m_Header.TileHeight != Block.Y)
+                LOG_ERROR_AND_THROW("Unexpected EXR tile coordinates");
+        }
+        else
+        {
+            const auto Y = Reader.Read<Int32>();
+            if (Int64{Y} - m_Header.YMin != Block.Y)
+                LOG_ERROR_AND_THROW("Unexpected EXR scanline block coordinate");
+        }
+
+        const auto ChunkSize = Reader.Read<Int32>();
+        if (ChunkSize < 0)
+            LOG_ERROR_AND_THROW("Invalid EXR chunk size");
+        const auto* pChunkData = Reader.ReadBytes(static_cast<size_t>(ChunkSize));
+
+        const size_t RowSize = size_t{Block.Width} * m_Header.GetPixelSize();
+        const size_t RawSize = RowSize * Block.Height;
+
+        const Uint8* pRawData = pChunkData;
+        if (static_cast<size_t>(ChunkSize) != RawSize)
+        {
+            // Data is stored uncompressed if compression does not reduce its size
+            m_RawData.resize(RawSize);
+            switch (m_Header.Compression)
+            {
+                case EXR_COMPRESSION_NONE:
+                    LOG_ERROR_AND_THROW("Unexpected size of uncompressed EXR chunk");
+                    break;
+
+                case EXR_COMPRESSION_RLE:
+                    m_TmpData.resize(RawSize);
+                    DecodeRLE(pChunkData, static_cast<size_t>(ChunkSize), m_TmpData.data(), RawSize);
+                    UndoPredictorAndReorder(m_TmpData.data(), RawSize, m_RawData.data());
+                    break;
+
+                case EXR_COMPRESSION_ZIPS:
+                case EXR_COMPRESSION_ZIP:
+                {
+                    m_TmpData.resize(RawSize);
+                    uLongf UncompressedSize = static_cast<uLongf>(RawSize);
+                    if (uncompress(m_TmpData.data(), &UncompressedSize, pChunkData, static_cast<uLong>(ChunkSize)) != Z_OK || UncompressedSize != RawSize)
+                        LOG_ERROR_AND_THROW("Failed to decompress EXR chunk");
+                    UndoPredictorAndReorder(m_TmpData.data(), RawSize, m_RawData.data());
+                    break;
+                }
+
+                case EXR_COMPRESSION_PIZ:
+                    PIZ::Uncompress(pChunkData, static_cast<size_t>(ChunkSize), m_Header.Channels, Block.Width, Block.Height, m_RawData.data(), RawSize);
+                    break;
+
+                default:
+                    LOG_ERROR_AND_THROW("EXR compression ", GetCompressionName(m_Header.Compression), " is not supported");
+            }
+            pRawData = m_RawData.data();
+        }
+
+        // Offsets of the channels within a row
+        size_t ChannelOffsets[4] = {};
+        for (Uint32 c = 0; c < m_Layout.NumComponents; ++c)
+        {
+            if (m_Layout.Channels[c] < 0)
+                continue;
+            for (Int32 i = 0; i < m_Layout.Channels[c]; ++i)
+                ChannelOffsets[c] += size_t{Block.Width} * m_Header.Channels[i].GetSize();
+        }
+
+        const size_t DstCompSize = GetValueSize(m_Layout.ComponentType);
+        for (Uint32 y = 0; y < Block.Height; ++y)
+        {
+            const auto* pSrcRow = pRawData + RowSize * y;
+            auto*       pDstRow = pDstPixels + DstStride * (Block.Y + y) + (size_t{Block.X} * m_Layout.NumComponents) * DstCompSize;
+            for (Uint32 c = 0; c < m_Layout.NumComponents; ++c)
+            {
+                auto* pDst = pDstRow + c * DstCompSize;
+                if (m_Layout.Channels[c] < 0)
+                {
+                    for (Uint32 x = 0; x < Block.Width; ++x, pDst += DstCompSize * m_Layout.NumComponents)
+                        memset(pDst, 0, DstCompSize);
+                    continue;
+                }
+
+                const auto  PixelType = m_Header.Channels[m_Layout.Channels[c]].PixelType;
+                const auto* pSrc      = pSrcRow + ChannelOffsets[c];
+                for (Uint32 x = 0; x < Block.Width; ++x, pDst += DstCompSize * m_Layout.NumComponents)
+                {
+                    if (m_Layout.ComponentType == VT_FLOAT32 && PixelType == EXR_PIXEL_TYPE_HALF)
+                    {
+                        Uint16 Half;
+                        memcpy(&Half, pSrc + x * 2, 2);
+                        const float Value = HalfToFloat(Half);
+                        memcpy(pDst, &Value, 4);
+                    }
+                    else if (m_Layout.ComponentType == VT_FLOAT32 && PixelType == EXR_PIXEL_TYPE_UINT)
+                    {
+                        Uint32 UInt;
+                        memcpy(&UInt, pSrc + x * 4, 4);
+                        const float Value = static_cast<float>(UInt);
+                        memcpy(pDst, &Value, 4);
+                    }
+                    else
+                    {
+                        VERIFY_EXPR(DstCompSize == (PixelType == EXR_PIXEL_TYPE_HALF ? 2 : 4));
+                        memcpy(pDst, pSrc + x * DstCompSize, DstCompSize);
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    const EXRHeader&       m_Header;
+    const EXROutputLayout& m_Layout;
+    const Uint8* const     m_pFileData;
+    const size_t           m_FileSize;
+
+    std::vector<Uint8> m_RawData;
+    std::vector<Uint8> m_TmpData;
+};
+
+} // namespace
+
+bool LoadEXR(IDataBlob*   pEXRData,
+             IDataBlob*   pDstPixels,
+             ImageDesc*   pDstImgDesc,
+             IThreadPool* pThreadPool)
+{
+    VERIFY_EXPR(pEXRData != nullptr && pDstPixels != nullptr && pDstImgDesc != nullptr);
+
+    const auto* pFileData = static_cast<const Uint8*>(pEXRData->GetConstDataPtr());
+    const auto  FileSize  = pEXRData->GetSize();
+
+    try
+    {
+        EXRReader  Reader{pFileData, FileSize};
+        const auto Header = ReadHeader(Reader);
+        const auto Layout = SelectOutputLayout(Header.Channels);
+
+        if (Header.Compression != EXR_COMPRESSION_NONE &&
+            Header.Compression != EXR_COMPRESSION_RLE &&
+            Header.Compression != EXR_COMPRESSION_ZIPS &&
+            Header.Compression != EXR_COMPRESSION_ZIP &&
+            Header.Compression != EXR_COMPRESSION_PIZ)
+            LOG_ERROR_AND_THROW("EXR compression ", GetCompressionName(Header.Compression), " is not supported");
+
+        const Uint32 Width  = Header.GetWidth();
+        const Uint32 Height = Header.GetHeight();
+
+        const Uint64 RowSize = Uint64{Width} * Layout.NumComponents * GetValueSize(Layout.ComponentType);
+        if (RowSize > std::numeric_limits<Uint32>::max() - 3 || RowSize * Height > std::numeric_limits<size_t>::max())
+            LOG_ERROR_AND_THROW("EXR image is too large (", Width, " x ", Height, ")");
+
+        // Every block has an entry in the offset table, which must fit into the file
+        const Uint32 LinesPerBlock = Header.IsTiled ? Header.TileHeight : GetLinesPerBlock(Header.Compression);
+        const Uint64 NumBlocks     = (Header.IsTiled ? (Uint64{Width} + Header.TileWidth - 1) / Header.TileWidth : 1) *
+            ((Uint64{Height} + LinesPerBlock - 1) / LinesPerBlock);
+        if (NumBlocks > (FileSize - Reader.GetOffset()) / sizeof(Uint64))
+            LOG_ERROR_AND_THROW("EXR offset table exceeds the file size");
+
+        // Blocks of the most detailed level. For tiled images, the offset table starts with the tiles of
+        // level 0 in row-major order, for scanline images with the blocks in increasing y order.
+        std::vector<EXRBlock> Blocks;
+        if (Header.IsTiled)
+        {
+            const Uint32 TilesX = static_cast<Uint32>((Uint64{Width} + Header.TileWidth - 1) / Header.TileWidth);
+            const Uint32 TilesY = static_cast<Uint32>((Uint64{Height} + Header.TileHeight - 1) / Header.TileHeight);
+            Blocks.resize(size_t{TilesX} * TilesY);
+            for (Uint32 ty = 0; ty < TilesY; ++ty)
+            {
+                for (Uint32 tx = 0; tx < TilesX; ++tx)
+                {
+                    auto& Block  = Blocks[size_t{ty} * TilesX + tx];
+                    Block.X      = tx * Header.TileWidth;
+                    Block.Y      = ty * Header.TileHeight;
+                    Block.Width  = std::min(Header.TileWidth, Width - Block.X);
+                    Block.Height = std::min(Header.TileHeight, Height - Block.Y);
+                }
+            }
+        }
+        else
+        {
+            Blocks.resize((size_t{Height} + LinesPerBlock - 1) / LinesPerBlock);
+            for (size_t i = 0; i < Blocks.size(); ++i)
+            {
+                auto& Block  = Blocks[i];
+                Block.Y      = static_cast<Uint32>(i * LinesPerBlock);
+                Block.Width  = Width;
+                Block.Height = std::min(LinesPerBlock, Height - Block.Y);
+            }
+        }
+
+        VERIFY_EXPR(Blocks.size() == NumBlocks);
+        for (auto& Block : Blocks)
+            Block.ChunkOffset = static_cast<size_t>(Reader.Read<Uint64>());
+
+        pDstImgDesc->Width         = Width;
+        pDstImgDesc->Height        = Height;
+        pDstImgDesc->ComponentType = Layout.ComponentType;
+        pDstImgDesc->NumComponents = Layout.NumComponents;
+        pDstImgDesc->RowStride     = AlignUp(static_cast<Uint32>(RowSize), 4u);
+
+        pDstPixels->Resize(size_t{pDstImgDesc->RowStride} * Height);
+        auto* const pDstData = static_cast<Uint8*>(pDstPixels->GetDataPtr());
+
+        if (pThreadPool != nullptr && NumBlocks > 1)
+        {
+            // Every task decodes a contiguous range of blocks with its own decoder.
+            // Blocks are written to non-overlapping regions of the destination image.
+            const Uint32 NumTasks = static_cast<Uint32>(std::min<Uint64>(NumBlocks, std::max(std::thread::hardware_concurrency(), 1u) * 2));
+
+            const Uint32      RowStride = pDstImgDesc->RowStride;
+            std::atomic<bool> Succeeded{true};
+            ParallelFor(pThreadPool, NumTasks, [&](Uint32 Task) {
+                const size_t FirstBlock = static_cast<size_t>(NumBlocks * Task / NumTasks);
+                const size_t EndBlock   = static_cast<size_t>(NumBlocks * (Task + 1) / NumTasks);
+                try
+                {
+                    EXRBlockDecoder Decoder{Header, Layout, pFileData, FileSize};
+                    for (size_t i = FirstBlock; i < EndBlock && Succeeded; ++i)
+                        Decoder.Decode(Blocks[i], pDstData, RowStride);
+                }
+                catch (const std::runtime_error&)
+                {
+                    Succeeded.store(false);
+                }
+            });
+
+            if (!Succeeded)
+                LOG_ERROR_AND_THROW("Failed to decode EXR image data");
+        }
+        else
+        {
+            EXRBlockDecoder Decoder{Header, Layout, pFileData, FileSize};
+            for (const auto& Block : Blocks)
+                Decoder.Decode(Block, pDstData, pDstImgDesc->RowStride);
+        }
+    }
+    catch (const std::runtime_error&)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace Diligent
+
+extern "C"
+{
+    bool Diligent_LoadEXR(Diligent::IDataBlob*   pEXRData,
+                          Diligent::IDataBlob*   pDstPixels,
+                          Diligent::ImageDesc*   pDstImgDesc,
+                          Diligent::IThreadPool* pThreadPool)
+    {
+        return Diligent::LoadEXR(pEXRData, pDstPixels, pDstImgDesc, pThreadPool);
+    }
+}
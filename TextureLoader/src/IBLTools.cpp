@@ -0,0 +1,713 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "IBLTools.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include "TextureLoaderImpl.hpp"
+#include "Image.h"
+#include "BasicMath.hpp"
+#include "GraphicsAccessories.hpp"
+#include "ParallelFor.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+static constexpr Uint32 NumCubeFaces = 6;
+
+// Returns the direction that corresponds to the point on the cube face.
+// u and v are in [-1, 1] range, u goes right and v goes down.
+float3 GetCubeFaceDirection(Uint32 Face, float u, float v)
+{
+    switch (Face)
+    {
+        // clang-format off
+        case 0: return float3{ 1, -v, -u}; // +X
+        case 1: return float3{-1, -v,  u}; // -X
+        case 2: return float3{ u,  1,  v}; // +Y
+        case 3: return float3{ u, -1, -v}; // -Y
+        case 4: return float3{ u, -v,  1}; // +Z
+        case 5: return float3{-u, -v, -1}; // -Z
+        // clang-format on
+        default:
+            UNEXPECTED("Unexpected cube face");
+            return float3{0, 0, 1};
+    }
+}
+
+// Inverse of GetCubeFaceDirection.
+Uint32 GetCubeFaceCoordinates(const float3& Dir, float& u, float& v)
+{
+    const auto AbsX = std::abs(Dir.x);
+    const auto AbsY = std::abs(Dir.y);
+    const auto AbsZ = std::abs(Dir.z);
+    if (AbsX >= AbsY && AbsX >= AbsZ)
+    {
+        const auto InvMax = 1.f / std::max(AbsX, 1e-20f);
+        u                 = (Dir.x > 0 ? -Dir.z : Dir.z) * InvMax;
+        v                 = -Dir.y * InvMax;
+        return Dir.x > 0 ? 0 : 1;
+    }
+    else if (AbsY >= AbsZ)
+    {
+        const auto InvMax = 1.f / AbsY;
+        u                 = Dir.x * InvMax;
+        v                 = (Dir.y > 0 ? Dir.z : -Dir.z) * InvMax;
+        return Dir.y > 0 ? 2 : 3;
+    }
+    else
+    {
+        const auto InvMax = 1.f / AbsZ;
+        u                 = (Dir.z > 0 ? Dir.x : -Dir.x) * InvMax;
+        v                 = -Dir.y * InvMax;
+        return Dir.z > 0 ? 4 : 5;
+    }
+}
+
+// Returns the coordinate of the texel center in [-1, 1] range.
+inline float GetTexelCenterCoord(Uint32 i, Uint32 Size)
+{
+    return (static_cast<float>(i) + 0.5f) / static_cast<float>(Size) * 2.f - 1.f;
+}
+
+// Returns the integer coordinates and the weight of the second texel for linear filtering.
+inline void GetLinearFilterTexels(float x, Uint32 Size, Uint32& x0, Uint32& x1, float& w)
+{
+    const auto fx = std::floor(x);
+    const auto ix = static_cast<int>(fx);
+
+    x0 = static_cast<Uint32>(std::min(std::max(ix, 0), static_cast<int>(Size) - 1));
+    x1 = static_cast<Uint32>(std::min(std::max(ix + 1, 0), static_cast<int>(Size) - 1));
+    w  = x - fx;
+}
+
+// Read-only view of a TEX_FORMAT_RGBA32_FLOAT cubemap.
+class CubemapView
+{
+public:
+    explicit CubemapView(ITextureLoader& Loader)
+    {
+        const auto& Desc = Loader.GetTextureDesc();
+        m_Levels.resize(Desc.MipLevels);
+        for (Uint32 mip = 0; mip < Desc.MipLevels; ++mip)
+        {
+            auto& Level = m_Levels[mip];
+            Level.Size  = std::max(Desc.Width >> mip, 1u);
+            for (Uint32 Face = 0; Face < NumCubeFaces; ++Face)
+            {
+                const auto& SubRes = Loader.GetSubresourceData(mip, Face);
+                Level.pFaces[Face] = static_cast<const Uint8*>(SubRes.pData);
+                Level.Strides[Face] = static_cast<size_t>(SubRes.Stride);
+            }
+        }
+    }
+
+    Uint32 GetFaceSize(Uint32 Mip) const { return m_Levels[Mip].Size; }
+    Uint32 GetMipLevels() const { return static_cast<Uint32>(m_Levels.size()); }
+
+    const float4& GetTexel(Uint32 Mip, Uint32 Face, Uint32 x, Uint32 y) const
+    {
+        const auto& Level = m_Levels[Mip];
+        return reinterpret_cast<const float4*>(Level.pFaces[Face] + Level.Strides[Face] * y)[x];
+    }
+
+    // Samples the cubemap with trilinear filtering.
+    // Note that the texels are not filtered across the face edges.
+    float4 Sample(const float3& Dir, float Lod) const
+    {
+        float      u = 0, v = 0;
+        const auto Face = GetCubeFaceCoordinates(Dir, u, v);
+
+        Lod = std::min(std::max(Lod, 0.f), static_cast<float>(m_Levels.size() - 1));
+
+        const auto Mip0 = static_cast<Uint32>(Lod);
+        const auto Mip1 = std::min(Mip0 + 1, static_cast<Uint32>(m_Levels.size() - 1));
+        const auto w    = Lod - static_cast<float>(Mip0);
+
+        const auto Color0 = SampleLevel(Mip0, Face, u, v);
+        return w > 0 && Mip1 != Mip0 ? Color0 * (1 - w) + SampleLevel(Mip1, Face, u, v) * w : Color0;
+    }
+
+private:
+    float4 SampleLevel(Uint32 Mip, Uint32 Face, float u, float v) const
+    {
+        const auto Size = m_Levels[Mip].Size;
+
+        Uint32 x0, x1, y0, y1;
+        float  wx, wy;
+        GetLinearFilterTexels((u * 0.5f + 0.5f) * static_cast<float>(Size) - 0.5f, Size, x0, x1, wx);
+        GetLinearFilterTexels((v * 0.5f + 0.5f) * static_cast<float>(Size) - 0.5f, Size, y0, y1, wy);
+
+        return (GetTexel(Mip, Face, x0, y0) * (1 - wx) + GetTexel(Mip, Face, x1, y0) * wx) * (1 - wy) +
+            (GetTexel(Mip, Face, x0, y1) * (1 - wx) + GetTexel(Mip, Face, x1, y1) * wx) * wy;
+    }
+
+    struct LevelInfo
+    {
+        const Uint8* pFaces[NumCubeFaces]  = {};
+        size_t       Strides[NumCubeFaces] = {};
+        Uint32       Size                  = 0;
+    };
+    std::vector<LevelInfo> m_Levels;
+};
+
+bool VerifySourceCubemap(ITextureLoader* pCubemap, const char* FuncName)
+{
+    if (pCubemap == nullptr)
+    {
+        LOG_ERROR_MESSAGE(FuncName, ": source cubemap must not be null");
+        return false;
+    }
+
+    const auto& Desc = pCubemap->GetTextureDesc();
+    if (Desc.Type != RESOURCE_DIM_TEX_CUBE || Desc.ArraySize != NumCubeFaces || Desc.Width != Desc.Height || Desc.Format != TEX_FORMAT_RGBA32_FLOAT)
+    {
+        LOG_ERROR_MESSAGE(FuncName, ": source texture must be a square cubemap in TEX_FORMAT_RGBA32_FLOAT format");
+        return false;
+    }
+
+    return true;
+}
+
+// Cubemap data that is stored in the TextureLoaderImpl subresource order (face-major).
+struct CubemapData
+{
+    CubemapData(Uint32 _FaceSize, Uint32 _MipLevels) :
+        FaceSize{_FaceSize},
+        MipLevels{_MipLevels},
+        Subresources(NumCubeFaces * _MipLevels)
+    {
+        for (Uint32 Face = 0; Face < NumCubeFaces; ++Face)
+        {
+            for (Uint32 mip = 0; mip < MipLevels; ++mip)
+            {
+                const auto Size = GetFaceSize(mip);
+                Subresources[Face * MipLevels + mip].resize(size_t{Size} * Size * sizeof(float4));
+            }
+        }
+    }
+
+    Uint32 GetFaceSize(Uint32 Mip) const { return std::max(FaceSize >> Mip, 1u); }
+
+    float4* GetFaceData(Uint32 Mip, Uint32 Face)
+    {
+        return reinterpret_cast<float4*>(Subresources[Face * MipLevels + Mip].data());
+    }
+
+    // Box-filters the coarser mip levels starting with StartMip.
+    void GenerateMips(Uint32 StartMip, IThreadPool* pThreadPool)
+    {
+        for (Uint32 mip = StartMip; mip < MipLevels; ++mip)
+        {
+            const auto FineSize   = GetFaceSize(mip - 1);
+            const auto CoarseSize = GetFaceSize(mip);
+            ParallelFor(pThreadPool, NumCubeFaces, [&](Uint32 Face) {
+                const auto* pFine   = GetFaceData(mip - 1, Face);
+                auto*       pCoarse = GetFaceData(mip, Face);
+                for (Uint32 y = 0; y < CoarseSize; ++y)
+                {
+                    const auto y0 = std::min(y * 2, FineSize - 1);
+                    const auto y1 = std::min(y * 2 + 1, FineSize - 1);
+                    for (Uint32 x = 0; x < CoarseSize; ++x)
+                    {
+                        const auto x0 = std::min(x * 2, FineSize - 1);
+                        const auto x1 = std::min(x * 2 + 1, FineSize - 1);
+
+                        pCoarse[y * CoarseSize + x] =
+                            (pFine[y0 * FineSize + x0] + pFine[y0 * FineSize + x1] +
+                             pFine[y1 * FineSize + x0] + pFine[y1 * FineSize + x1]) *
+                            0.25f;
+                    }
+                }
+            });
+        }
+    }
+
+    void CreateLoader(const Char* Name, ITextureLoader** ppLoader)
+    {
+        TextureDesc Desc;
+        Desc.Name      = Name;
+        Desc.Type      = RESOURCE_DIM_TEX_CUBE;
+        Desc.Width     = FaceSize;
+        Desc.Height    = FaceSize;
+        Desc.ArraySize = NumCubeFaces;
+        Desc.MipLevels = MipLevels;
+        Desc.Format    = TEX_FORMAT_RGBA32_FLOAT;
+        Desc.Usage     = USAGE_IMMUTABLE;
+        Desc.BindFlags = BIND_SHADER_RESOURCE;
+
+        RefCntAutoPtr<ITextureLoader> pTexLoader{MakeNewRCObj<TextureLoaderImpl>()(Desc, std::move(Subresources))};
+        pTexLoader->QueryInterface(IID_TextureLoader, reinterpret_cast<IObject**>(ppLoader));
+    }
+
+    const Uint32 FaceSize;
+    const Uint32 MipLevels;
+
+    std::vector<std::vector<Uint8>> Subresources;
+};
+
+// Bilinear sampler of an equirectangular image.
+class EquirectImageSampler
+{
+public:
+    explicit EquirectImageSampler(const Image& Img) :
+        m_Desc{Img.GetDesc()},
+        m_pData{static_cast<const Uint8*>(Img.GetData()->GetConstDataPtr())}
+    {}
+
+    float4 Sample(const float3& Dir) const
+    {
+        // The center of the image corresponds to +X direction, the top row corresponds to +Y.
+        const auto u = std::atan2(Dir.z, Dir.x) * (0.5f / PI_F) + 0.5f;
+        const auto v = std::acos(std::min(std::max(Dir.y, -1.f), 1.f)) / PI_F;
+
+        auto       x  = u * static_cast<float>(m_Desc.Width) - 0.5f;
+        const auto fx = std::floor(x);
+        const auto wx = x - fx;
+
+        // Wrap horizontally
+        const auto W  = static_cast<int>(m_Desc.Width);
+        const auto x0 = static_cast<Uint32>(((static_cast<int>(fx) % W) + W) % W);
+        const auto x1 = (x0 + 1) % m_Desc.Width;
+
+        Uint32 y0, y1;
+        float  wy;
+        GetLinearFilterTexels(v * static_cast<float>(m_Desc.Height) - 0.5f, m_Desc.Height, y0, y1, wy);
+
+        return (ReadPixel(x0, y0) * (1 - wx) + ReadPixel(x1, y0) * wx) * (1 - wy) +
+            (ReadPixel(x0, y1) * (1 - wx) + ReadPixel(x1, y1) * wx) * wy;
+    }
+
+private:
+    float4 ReadPixel(Uint32 x, Uint32 y) const
+    {
+        const auto* pRow = m_pData + size_t{m_Desc.RowStride} * y;
+
+        float Comps[4] = {};
+        for (Uint32 c = 0; c < std::min(m_Desc.NumComponents, 3u); ++c)
+        {
+            Comps[c] = m_Desc.ComponentType == VT_FLOAT32 ?
+                reinterpret_cast<const float*>(pRow)[size_t{x} * m_Desc.NumComponents + c] :
+                static_cast<float>(pRow[size_t{x} * m_Desc.NumComponents + c]) / 255.f;
+        }
+        if (m_Desc.NumComponents == 1)
+            Comps[1] = Comps[2] = Comps[0];
+
+        return float4{Comps[0], Comps[1], Comps[2], 1};
+    }
+
+    const ImageDesc    m_Desc;
+    const Uint8* const m_pData;
+};
+
+// https://www.pbr-book.org/3ed-2018/Sampling_and_Reconstruction/The_Halton_Sampler
+inline float2 Hammersley(Uint32 i, Uint32 N)
+{
+    Uint32 Bits = i;
+    Bits        = (Bits << 16u) | (Bits >> 16u);
+    Bits        = ((Bits & 0x55555555u) << 1u) | ((Bits & 0xAAAAAAAAu) >> 1u);
+    Bits        = ((Bits & 0x33333333u) << 2u) | ((Bits & 0xCCCCCCCCu) >> 2u);
+    Bits        = ((Bits & 0x0F0F0F0Fu) << 4u) | ((Bits & 0xF0F0F0F0u) >> 4u);
+    Bits        = ((Bits & 0x00FF00FFu) << 8u) | ((Bits & 0xFF00FF00u) >> 8u);
+    return float2{(static_cast<float>(i) + 0.5f) / static_cast<float>(N), static_cast<float>(Bits) * 2.3283064365386963e-10f};
+}
+
+// Samples the GGX distribution of normals around +Z. Alpha is the squared perceptual roughness.
+inline float3 ImportanceSampleGGX(const float2& Xi, float Alpha)
+{
+    const auto Phi      = 2.f * PI_F * Xi.x;
+    const auto CosTheta = std::sqrt((1.f - Xi.y) / (1.f + (Alpha * Alpha - 1.f) * Xi.y));
+    const auto SinTheta = std::sqrt(std::max(1.f - CosTheta * CosTheta, 0.f));
+    return float3{SinTheta * std::cos(Phi), SinTheta * std::sin(Phi), CosTheta};
+}
+
+// Real spherical harmonics basis up to the third order.
+void EvaluateSHBasis(const float3& Dir, float Basis[9])
+{
+    // clang-format off
+    Basis[0] = 0.282095f;
+    Basis[1] = 0.488603f * Dir.y;
+    Basis[2] = 0.488603f * Dir.z;
+    Basis[3] = 0.488603f * Dir.x;
+    Basis[4] = 1.092548f * Dir.x * Dir.y;
+    Basis[5] = 1.092548f * Dir.y * Dir.z;
+    Basis[6] = 0.315392f * (3.f * Dir.z * Dir.z - 1.f);
+    Basis[7] = 1.092548f * Dir.x * Dir.z;
+    Basis[8] = 0.546274f * (Dir.x * Dir.x - Dir.y * Dir.y);
+    // clang-format on
+}
+
+} // namespace
+
+void CreateCubemapFromEquirectangular(const EquirectToCubemapAttribs& Attribs,
+                                      ITextureLoader**                ppLoader)
+{
+    DEV_CHECK_ERR(ppLoader != nullptr && *ppLoader == nullptr, "ppLoader must not be null and must point to null");
+
+    if (Attribs.pImage == nullptr)
+    {
+        LOG_ERROR_MESSAGE("Source equirectangular image must not be null");
+        return;
+    }
+
+    const auto& ImgDesc = Attribs.pImage->GetDesc();
+    if ((ImgDesc.ComponentType != VT_FLOAT32 && ImgDesc.ComponentType != VT_UINT8) ||
+        ImgDesc.NumComponents < 1 || ImgDesc.NumComponents > 4 ||
+        ImgDesc.Width == 0 || ImgDesc.Height == 0)
+    {
+        LOG_ERROR_MESSAGE("Equirectangular image must be a non-empty 32-bit float or 8-bit image with one to four components");
+        return;
+    }
+
+    const auto FaceSize  = Attribs.FaceSize != 0 ? Attribs.FaceSize : std::max(ImgDesc.Width / 4u, 1u);
+    const auto MipLevels = Attribs.MipLevels != 0 ?
+        std::min(Attribs.MipLevels, ComputeMipLevelsCount(FaceSize)) :
+        ComputeMipLevelsCount(FaceSize);
+
+    CubemapData Cubemap{FaceSize, MipLevels};
+
+    // Supersample the image when a face texel covers more than one image pixel
+    const auto NumSubsamples = std::min(std::max((ImgDesc.Width + FaceSize * 4 - 1) / (FaceSize * 4), 1u), 4u);
+
+    const EquirectImageSampler Sampler{*Attribs.pImage};
+    ParallelFor(Attribs.pThreadPool, NumCubeFaces * FaceSize, [&](Uint32 Idx) {
+        const auto Face = Idx / FaceSize;
+        const auto y    = Idx % FaceSize;
+
+        auto* pRow = Cubemap.GetFaceData(0, Face) + size_t{y} * FaceSize;
+        for (Uint32 x = 0; x < FaceSize; ++x)
+        {
+            float4 Color;
+            for (Uint32 sy = 0; sy < NumSubsamples; ++sy)
+            {
+                for (Uint32 sx = 0; sx < NumSubsamples; ++sx)
+                {
+                    const auto u = GetTexelCenterCoord(x * NumSubsamples + sx, FaceSize * NumSubsamples);
+                    const auto v = GetTexelCenterCoord(y * NumSubsamples + sy, FaceSize * NumSubsamples);
+                    Color += Sampler.Sample(normalize(GetCubeFaceDirection(Face, u, v)));
+                }
+            }
+            pRow[x] = Color / static_cast<float>(NumSubsamples * NumSubsamples);
+        }
+    });
+
+    Cubemap.GenerateMips(1, Attribs.pThreadPool);
+    Cubemap.CreateLoader(Attribs.Name, ppLoader);
+}
+
+void ComputeSHIrradiance(const SHIrradianceAttribs& Attribs,
+                         float*                     pSHCoeffs)
+{
+    DEV_CHECK_ERR(pSHCoeffs != nullptr, "pSHCoeffs must not be null");
+    DEV_CHECK_ERR(Attribs.Order == 2 || Attribs.Order == 3, "SH order (", Attribs.Order, ") must be 2 or 3");
+
+    const auto NumCoeffs = Attribs.Order * Attribs.Order;
+    std::fill_n(pSHCoeffs, NumCoeffs * 3, 0.f);
+    if (!VerifySourceCubemap(Attribs.pCubemap, "ComputeSHIrradiance"))
+        return;
+
+    const CubemapView Cubemap{*Attribs.pCubemap};
+
+    // Irradiance is a low-frequency signal, so there is no need to integrate over the most detailed level.
+    Uint32 Mip = 0;
+    while (Mip + 1 < Cubemap.GetMipLevels() && Cubemap.GetFaceSize(Mip) > 64)
+        ++Mip;
+    const auto FaceSize = Cubemap.GetFaceSize(Mip);
+
+    struct FaceSums
+    {
+        std::array<float3, 9> Coeffs;
+        double                Weight = 0;
+    };
+    std::array<FaceSums, NumCubeFaces> Sums{};
+    ParallelFor(Attribs.pThreadPool, NumCubeFaces, [&](Uint32 Face) {
+        auto& FaceSum = Sums[Face];
+        for (Uint32 y = 0; y < FaceSize; ++y)
+        {
+            const auto v = GetTexelCenterCoord(y, FaceSize);
+            for (Uint32 x = 0; x < FaceSize; ++x)
+            {
+                const auto u = GetTexelCenterCoord(x, FaceSize);
+
+                // Solid angle of the texel on the unit cube face is proportional to 1 / (1 + u^2 + v^2)^(3/2)
+                const auto   r2          = 1.f + u * u + v * v;
+                const auto   SolidAngle  = 4.f / (static_cast<float>(FaceSize * FaceSize) * r2 * std::sqrt(r2));
+                const auto&  Texel       = Cubemap.GetTexel(Mip, Face, x, y);
+                const float3 WeightedRGB = float3{Texel.x, Texel.y, Texel.z} * SolidAngle;
+
+                float Basis[9];
+                EvaluateSHBasis(normalize(GetCubeFaceDirection(Face, u, v)), Basis);
+                for (Uint32 i = 0; i < NumCoeffs; ++i)
+                    FaceSum.Coeffs[i] += WeightedRGB * Basis[i];
+                FaceSum.Weight += SolidAngle;
+            }
+        }
+    });
+
+    double TotalWeight = 0;
+    for (const auto& FaceSum : Sums)
+        TotalWeight += FaceSum.Weight;
+    // Compensate for the discretization error of the solid angles
+    const auto Normalization = static_cast<float>(4.0 * PI / TotalWeight);
+
+    // Convolution with the clamped cosine lobe divided by Pi (Ramamoorthi and Hanrahan 2001)
+    static constexpr float BandScales[] = {1.f, 2.f / 3.f, 1.f / 4.f};
+    for (Uint32 i = 0; i < NumCoeffs; ++i)
+    {
+        float3 Coeff;
+        for (const auto& FaceSum : Sums)
+            Coeff += FaceSum.Coeffs[i];
+
+        const auto Band  = i == 0 ? 0 : (i < 4 ? 1 : 2);
+        Coeff           *= Normalization * BandScales[Band];
+        pSHCoeffs[i * 3 + 0] = Coeff.x;
+        pSHCoeffs[i * 3 + 1] = Coeff.y;
+        pSHCoeffs[i * 3 + 2] = Coeff.z;
+    }
+}
+
+void EvaluateSHIrradiance(const float* pSHCoeffs,
+                          Uint32       Order,
+                          const float* pNormal,
+                          float*       pRGB)
+{
+    DEV_CHECK_ERR(Order == 2 || Order == 3, "SH order (", Order, ") must be 2 or 3");
+
+    float Basis[9];
+    EvaluateSHBasis(float3{pNormal[0], pNormal[1], pNormal[2]}, Basis);
+
+    pRGB[0] = pRGB[1] = pRGB[2] = 0;
+    for (Uint32 i = 0; i < Order * Order; ++i)
+    {
+        for (Uint32 c = 0; c < 3; ++c)
+            pRGB[c] += pSHCoeffs[i * 3 + c] * Basis[i];
+    }
+}
+
+void PrefilterEnvironmentMap(const PrefilterEnvMapAttribs& Attribs,
+                             ITextureLoader**              ppLoader)
+{
+    DEV_CHECK_ERR(ppLoader != nullptr && *ppLoader == nullptr, "ppLoader must not be null and must point to null");
+    if (!VerifySourceCubemap(Attribs.pCubemap, "PrefilterEnvironmentMap"))
+        return;
+
+    const CubemapView Source{*Attribs.pCubemap};
+
+    const auto SrcFaceSize = Source.GetFaceSize(0);
+    const auto FaceSize    = Attribs.FaceSize != 0 ? Attribs.FaceSize : SrcFaceSize;
+    const auto MipLevels   = Attribs.MipLevels != 0 ?
+        std::min(Attribs.MipLevels, ComputeMipLevelsCount(FaceSize)) :
+        ComputeMipLevelsCount(FaceSize);
+    const auto NumSamples = std::max(Attribs.NumSamples, 1u);
+
+    // Solid angle of a texel of the most detailed source level
+    const auto SrcTexelSolidAngle = 4.f * PI_F / (6.f * static_cast<float>(SrcFaceSize * SrcFaceSize));
+
+    struct SampleInfo
+    {
+        float3 Dir; // Tangent-space direction
+        float  Weight;
+        float  Lod;
+    };
+    std::vector<SampleInfo> Samples;
+    Samples.reserve(NumSamples);
+
+    CubemapData Cubemap{FaceSize, MipLevels};
+    for (Uint32 mip = 0; mip < MipLevels; ++mip)
+    {
+        const auto Roughness   = MipLevels > 1 ? static_cast<float>(mip) / static_cast<float>(MipLevels - 1) : 0.f;
+        const auto Alpha       = Roughness * Roughness;
+        const auto MipFaceSize = Cubemap.GetFaceSize(mip);
+
+        // The samples are the same for every texel in the tangent space, where N = V = R = +Z.
+        Samples.clear();
+        if (Alpha == 0)
+        {
+            // Mirror reflection: sample the source level that matches the destination resolution
+            const auto Lod = std::log2(static_cast<float>(SrcFaceSize) / static_cast<float>(MipFaceSize));
+            Samples.push_back({float3{0, 0, 1}, 1.f, Lod});
+        }
+        else
+        {
+            for (Uint32 i = 0; i < NumSamples; ++i)
+            {
+                const auto H     = ImportanceSampleGGX(Hammersley(i, NumSamples), Alpha);
+                const auto L     = float3{2 * H.z * H.x, 2 * H.z * H.y, 2 * H.z * H.z - 1};
+                const auto NdotL = L.z;
+                if (NdotL <= 0)
+                    continue;
+
+                // Filtered importance sampling: select the source mip level whose texel solid angle
+                // matches the solid angle covered by the sample (GPU Gems 3, chapter 20).
+                // With N = V, pdf(L) = D(H) * NdotH / (4 * VdotH) = D(H) / 4.
+                const auto a2     = Alpha * Alpha;
+                const auto Denom  = (a2 - 1.f) * H.z * H.z + 1.f;
+                const auto D      = a2 / (PI_F * Denom * Denom);
+                const auto Pdf    = D / 4.f;
+                const auto Lod    = 0.5f * std::log2(1.f / (static_cast<float>(NumSamples) * Pdf * SrcTexelSolidAngle)) + 1.f;
+                Samples.push_back({L, NdotL, Lod});
+            }
+        }
+
+        ParallelFor(Attribs.pThreadPool, NumCubeFaces * MipFaceSize, [&](Uint32 Idx) {
+            const auto Face = Idx / MipFaceSize;
+            const auto y    = Idx % MipFaceSize;
+            const auto v    = GetTexelCenterCoord(y, MipFaceSize);
+
+            auto* pRow = Cubemap.GetFaceData(mip, Face) + size_t{y} * MipFaceSize;
+            for (Uint32 x = 0; x < MipFaceSize; ++x)
+            {
+                const auto N = normalize(GetCubeFaceDirection(Face, GetTexelCenterCoord(x, MipFaceSize), v));
+
+                const auto Up = std::abs(N.z) < 0.999f ? float3{0, 0, 1} : float3{1, 0, 0};
+                const auto T  = normalize(cross(Up, N));
+                const auto B  = cross(N, T);
+
+                float4 Color;
+                float  TotalWeight = 0;
+                for (const auto& Sample : Samples)
+                {
+                    const auto L = T * Sample.Dir.x + B * Sample.Dir.y + N * Sample.Dir.z;
+                    Color += Source.Sample(L, Sample.Lod) * Sample.Weight;
+                    TotalWeight += Sample.Weight;
+                }
+                pRow[x] = Color / std::max(TotalWeight, 1e-6f);
+            }
+        });
+    }
+
+    Cubemap.CreateLoader(Attribs.Name, ppLoader);
+}
+
+void ComputeBRDFIntegrationLUT(const BRDFIntegrationLUTAttribs& Attribs,
+                               ITextureLoader**                 ppLoader)
+{
+    DEV_CHECK_ERR(ppLoader != nullptr && *ppLoader == nullptr, "ppLoader must not be null and must point to null");
+    if (Attribs.Size == 0)
+    {
+        LOG_ERROR_MESSAGE("BRDF integration LUT size must not be zero");
+        return;
+    }
+
+    const auto Size       = Attribs.Size;
+    const auto NumSamples = std::max(Attribs.NumSamples, 1u);
+
+    std::vector<std::vector<Uint8>> Subresources(1);
+    Subresources[0].resize(size_t{Size} * Size * sizeof(float2));
+    auto* pLUT = reinterpret_cast<float2*>(Subresources[0].data());
+
+    ParallelFor(Attribs.pThreadPool, Size, [&](Uint32 y) {
+        const auto Roughness = (static_cast<float>(y) + 0.5f) / static_cast<float>(Size);
+        const auto Alpha     = Roughness * Roughness;
+        // Schlick-GGX geometry term remapping for image-based lighting (Karis 2013)
+        const auto k = Alpha / 2.f;
+
+        for (Uint32 x = 0; x < Size; ++x)
+        {
+            const auto NdotV = (static_cast<float>(x) + 0.5f) / static_cast<float>(Size);
+            const auto V     = float3{std::sqrt(1.f - NdotV * NdotV), 0, NdotV};
+
+            float A = 0;
+            float B = 0;
+            for (Uint32 i = 0; i < NumSamples; ++i)
+            {
+                const auto H     = ImportanceSampleGGX(Hammersley(i, NumSamples), Alpha);
+                const auto VdotH = dot(V, H);
+                const auto L     = H * (2.f * VdotH) - V;
+                const auto NdotL = L.z;
+                if (NdotL <= 0)
+                    continue;
+
+                const auto NdotH = std::max(H.z, 1e-6f);
+                const auto G     = (NdotV / (NdotV * (1.f - k) + k)) * (NdotL / (NdotL * (1.f - k) + k));
+                const auto G_Vis = G * std::max(VdotH, 0.f) / (NdotH * NdotV);
+                const auto Fc    = std::pow(1.f - std::max(VdotH, 0.f), 5.f);
+
+                A += (1.f - Fc) * G_Vis;
+                B += Fc * G_Vis;
+            }
+            pLUT[size_t{y} * Size + x] = float2{A, B} / static_cast<float>(NumSamples);
+        }
+    });
+
+    TextureDesc Desc;
+    Desc.Name      = Attribs.Name;
+    Desc.Type      = RESOURCE_DIM_TEX_2D;
+    Desc.Width     = Size;
+    Desc.Height    = Size;
+    Desc.MipLevels = 1;
+    Desc.Format    = TEX_FORMAT_RG32_FLOAT;
+    Desc.Usage     = USAGE_IMMUTABLE;
+    Desc.BindFlags = BIND_SHADER_RESOURCE;
+
+    RefCntAutoPtr<ITextureLoader> pTexLoader{MakeNewRCObj<TextureLoaderImpl>()(Desc, std::move(Subresources))};
+    pTexLoader->QueryInterface(IID_TextureLoader, reinterpret_cast<IObject**>(ppLoader));
+}
+
+} // namespace Diligent
+
+extern "C"
+{
+    void Diligent_CreateCubemapFromEquirectangular(const Diligent::EquirectToCubemapAttribs& Attribs,
+                                                   Diligent::ITextureLoader**                ppLoader)
+    {
+        Diligent::CreateCubemapFromEquirectangular(Attribs, ppLoader);
+    }
+
+    void Diligent_ComputeSHIrradiance(const Diligent::SHIrradianceAttribs& Attribs,
+                                      float*                               pSHCoeffs)
+    {
+        Diligent::ComputeSHIrradiance(Attribs, pSHCoeffs);
+    }
+
+    void Diligent_EvaluateSHIrradiance(const float*     pSHCoeffs,
+                                       Diligent::Uint32 Order,
+                                       const float*     pNormal,
+                                       float*           pRGB)
+    {
+        Diligent::EvaluateSHIrradiance(pSHCoeffs, Order, pNormal, pRGB);
+    }
+
+    void Diligent_PrefilterEnvironmentMap(const Diligent::PrefilterEnvMapAttribs& Attribs,
+                                          Diligent::ITextureLoader**              ppLoader)
+    {
+        Diligent::PrefilterEnvironmentMap(Attribs, ppLoader);
+    }
+
+    void Diligent_ComputeBRDFIntegrationLUT(const Diligent::BRDFIntegrationLUTAttribs& Attribs,
+                                            Diligent::ITextureLoader**                 ppLoader)
+    {
+        Diligent::ComputeBRDFIntegrationLUT(Attribs, ppLoader);
+    }
+}
@@ -29,6 +29,9 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <memory>
+#include <thread>
 
 #include "Image.h"
 #include "Errors.hpp"
@@ -38,6 +41,7 @@
 #include "PNGCodec.h"
 #include "JPEGCodec.h"
 #include "SGILoader.h"
+#include "EXRLoader.h"
 
 #include "DataBlobImpl.hpp"
 #include "DebugUtilities.hpp"
@@ -47,6 +51,7 @@
 #include "BasicFileStream.hpp"
 #include "StringTools.hpp"
 #include "TextureUtilities.h"
+#include "ParallelFor.hpp"
 
 #ifdef __clang__
 #    pragma clang diagnostic push
@@ -74,10 +79,28 @@ public:
     {
     }
 
+    // Opens a new TIFF handle over the data blob. Every handle must use its own wrapper
+    // as the wrapper keeps the current read position.
+    TIFF* Open(const char* Mode)
+    {
+        return TIFFClientOpen("", Mode, this,
+                              TIFFReadProc,
+                              TIFFWriteProc,
+                              TIFFSeekProc,
+                              TIFFCloseProc,
+                              TIFFSizeProc,
+                              TIFFMapFileProc,
+                              TIFFUnmapFileProc);
+    }
+
     static tmsize_t TIFFReadProc(thandle_t pClientData, void* pBuffer, tmsize_t Size)
     {
-        auto* pThis   = reinterpret_cast<TIFFClientOpenWrapper*>(pClientData);
-        auto* pSrcPtr = reinterpret_cast<Uint8*>(pThis->m_pData->GetDataPtr()) + pThis->m_Offset;
+        auto* pThis = reinterpret_cast<TIFFClientOpenWrapper*>(pClientData);
+        if (pThis->m_Offset >= pThis->m_Size)
+            return 0;
+
+        Size          = std::min(Size, static_cast<tmsize_t>(pThis->m_Size - pThis->m_Offset));
+        auto* pSrcPtr = reinterpret_cast<const Uint8*>(pThis->m_pData->GetConstDataPtr()) + pThis->m_Offset;
         memcpy(pBuffer, pSrcPtr, Size);
         pThis->m_Offset += Size;
         return Size;
@@ -143,19 +166,134 @@ private:
     RefCntAutoPtr<IDataBlob> m_pData;
 };
 
+namespace
+{
+
+struct TIFFDeleter
+{
+    void operator()(TIFF* pTiff) const
+    {
+        TIFFClose(pTiff);
+    }
+};
+using TIFFPtr = std::unique_ptr<TIFF, TIFFDeleter>;
+
+// Describes the layout of independently encoded blocks (strips or tiles) of a TIFF image.
+// Strips are handled as tiles that span the entire image width.
+struct TIFFBlockLayout
+{
+    bool   IsTiled        = false;
+    bool   IsPlanar       = false;
+    Uint32 BlockWidth     = 0;
+    Uint32 BlockHeight    = 0;
+    Uint32 BlocksAcross   = 0;
+    Uint32 BlocksDown     = 0;
+    Uint32 NumPlanes      = 0;
+    size_t BlockRowSize   = 0; // Size of one decoded block row, in bytes
+    size_t BytesPerSample = 0;
+
+    Uint32 GetNumBlocks() const
+    {
+        return BlocksAcross * BlocksDown * NumPlanes;
+    }
+};
+
+template <typename CompType>
+void ScatterComponent(const void* pSrc, void* pDst, Uint32 Width, Uint32 NumComponents)
+{
+    const auto* pSrcComp = static_cast<const CompType*>(pSrc);
+    auto*       pDstComp = static_cast<CompType*>(pDst);
+    for (Uint32 x = 0; x < Width; ++x)
+    {
+        pDstComp[x * NumComponents] = pSrcComp[x];
+    }
+}
+
+// Decodes blocks [FirstBlock, EndBlock) of the image directly into the destination pixels.
+bool DecodeTIFFBlocks(TIFF*                  pTiff,
+                      const TIFFBlockLayout& Layout,
+                      const ImageDesc&       Desc,
+                      Uint8*                 pDstPixels,
+                      Uint32                 FirstBlock,
+                      Uint32                 EndBlock)
+{
+    const auto DstPixelSize = Layout.BytesPerSample * Desc.NumComponents;
+
+    std::vector<Uint8> BlockData;
+    for (Uint32 Block = FirstBlock; Block < EndBlock; ++Block)
+    {
+        const Uint32 Plane  = Block / (Layout.BlocksAcross * Layout.BlocksDown);
+        const Uint32 BlockY = (Block / Layout.BlocksAcross) % Layout.BlocksDown;
+        const Uint32 BlockX = Block % Layout.BlocksAcross;
+
+        const Uint32 X0      = BlockX * Layout.BlockWidth;
+        const Uint32 Y0      = BlockY * Layout.BlockHeight;
+        const Uint32 Width   = std::min(Layout.BlockWidth, Desc.Width - X0);
+        const Uint32 NumRows = std::min(Layout.BlockHeight, Desc.Height - Y0);
+
+        auto* const pDstBlock = pDstPixels + size_t{Y0} * Desc.RowStride + X0 * DstPixelSize + Plane * Layout.BytesPerSample;
+        if (!Layout.IsTiled && !Layout.IsPlanar && Layout.BlockRowSize == Desc.RowStride)
+        {
+            // Rows of the strip are laid out exactly as rows of the image, so decode in place
+            const auto StripSize = static_cast<tmsize_t>(NumRows * Layout.BlockRowSize);
+            if (TIFFReadEncodedStrip(pTiff, TIFFComputeStrip(pTiff, Y0, 0), pDstBlock, StripSize) < 0)
+                return false;
+            continue;
+        }
+
+        tmsize_t BlockSize = 0;
+        if (Layout.IsTiled)
+        {
+            // Tiles are always decoded in full, including the padding beyond the image boundary
+            BlockSize = TIFFTileSize(pTiff);
+            BlockData.resize(static_cast<size_t>(BlockSize));
+            if (TIFFReadEncodedTile(pTiff, TIFFComputeTile(pTiff, X0, Y0, 0, static_cast<uint16_t>(Plane)), BlockData.data(), BlockSize) < 0)
+                return false;
+        }
+        else
+        {
+            BlockSize = static_cast<tmsize_t>(NumRows * Layout.BlockRowSize);
+            BlockData.resize(static_cast<size_t>(BlockSize));
+            if (TIFFReadEncodedStrip(pTiff, TIFFComputeStrip(pTiff, Y0, static_cast<uint16_t>(Plane)), BlockData.data(), BlockSize) < 0)
+                return false;
+        }
+
+        for (Uint32 row = 0; row < NumRows; ++row)
+        {
+            const auto* pSrcRow = BlockData.data() + row * Layout.BlockRowSize;
+            auto*       pDstRow = pDstBlock + size_t{row} * Desc.RowStride;
+            if (!Layout.IsPlanar)
+            {
+                memcpy(pDstRow, pSrcRow, Width * DstPixelSize);
+                continue;
+            }
+
+            switch (Layout.BytesPerSample)
+            {
+                case 1: ScatterComponent<Uint8>(pSrcRow, pDstRow, Width, Desc.NumComponents); break;
+                case 2: ScatterComponent<Uint16>(pSrcRow, pDstRow, Width, Desc.NumComponents); break;
+                case 4: ScatterComponent<Uint32>(pSrcRow, pDstRow, Width, Desc.NumComponents); break;
+                default:
+                    UNEXPECTED("Unexpected component size (", Layout.BytesPerSample, ").");
+                    return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
 void Image::LoadTiffFile(IDataBlob* pFileData, const ImageLoadInfo& LoadInfo)
 {
     TIFFClientOpenWrapper TiffClientOpenWrpr(pFileData);
 
-    auto TiffFile = TIFFClientOpen("", "rm", &TiffClientOpenWrpr,
-                                   TIFFClientOpenWrapper::TIFFReadProc,
-                                   TIFFClientOpenWrapper::TIFFWriteProc,
-                                   TIFFClientOpenWrapper::TIFFSeekProc,
-                                   TIFFClientOpenWrapper::TIFFCloseProc,
-                                   TIFFClientOpenWrapper::TIFFSizeProc,
-                                   TIFFClientOpenWrapper::TIFFMapFileProc,
-                                   TIFFClientOpenWrapper::TIFFUnmapFileProc);
+    TIFFPtr pTiff{TiffClientOpenWrpr.Open("rm")};
+    if (!pTiff)
+        LOG_ERROR_AND_THROW("Failed to open tiff file");
 
+    TIFF* TiffFile = pTiff.get();
     TIFFGetField(TiffFile, TIFFTAG_IMAGEWIDTH, &m_Desc.Width);
     TIFFGetField(TiffFile, TIFFTAG_IMAGELENGTH, &m_Desc.Height);
 
@@ -221,64 +359,75 @@ void Image::LoadTiffFile(IDataBlob* pFileData, const ImageLoadInfo& LoadInfo)
             LOG_ERROR_AND_THROW("Unknown sample format: ", Uint32{SampleFormat});
     }
 
-    size_t ScanlineSize = TIFFScanlineSize(TiffFile);
-    m_Desc.RowStride    = AlignUp(m_Desc.Width * m_Desc.NumComponents * (BitsPerSample / 8), 4u);
+    m_Desc.RowStride = AlignUp(m_Desc.Width * m_Desc.NumComponents * (BitsPerSample / 8), 4u);
     m_pData->Resize(size_t{m_Desc.Height} * size_t{m_Desc.RowStride});
+    if (m_Desc.Width == 0 || m_Desc.Height == 0)
+        return;
 
     Uint16 PlanarConfig = 0;
-    TIFFGetField(TiffFile, TIFFTAG_PLANARCONFIG, &PlanarConfig);
-    if (PlanarConfig == PLANARCONFIG_CONTIG || m_Desc.NumComponents == 1)
+    TIFFGetFieldDefaulted(TiffFile, TIFFTAG_PLANARCONFIG, &PlanarConfig);
+    if (PlanarConfig != PLANARCONFIG_CONTIG && PlanarConfig != PLANARCONFIG_SEPARATE)
+        LOG_ERROR_AND_THROW("Unexpected planar configuration (", PlanarConfig, ").");
+
+    TIFFBlockLayout Layout;
+    Layout.IsTiled        = TIFFIsTiled(TiffFile) != 0;
+    Layout.IsPlanar       = PlanarConfig == PLANARCONFIG_SEPARATE && m_Desc.NumComponents > 1;
+    Layout.NumPlanes      = Layout.IsPlanar ? m_Desc.NumComponents : 1;
+    Layout.BytesPerSample = BitsPerSample / 8;
+    if (Layout.IsTiled)
+    {
+        TIFFGetField(TiffFile, TIFFTAG_TILEWIDTH, &Layout.BlockWidth);
+        TIFFGetField(TiffFile, TIFFTAG_TILELENGTH, &Layout.BlockHeight);
+        if (Layout.BlockWidth == 0 || Layout.BlockHeight == 0)
+            LOG_ERROR_AND_THROW("Invalid tile size (", Layout.BlockWidth, " x ", Layout.BlockHeight, ").");
+        Layout.BlockRowSize = static_cast<size_t>(TIFFTileRowSize(TiffFile));
+    }
+    else
     {
-        VERIFY_EXPR(m_Desc.RowStride >= ScanlineSize);
-        auto* pDataPtr = reinterpret_cast<Uint8*>(m_pData->GetDataPtr());
-        for (Uint32 row = 0; row < m_Desc.Height; row++, pDataPtr += m_Desc.RowStride)
-        {
-            TIFFReadScanline(TiffFile, pDataPtr, row);
-        }
+        Uint32 RowsPerStrip = 0;
+        TIFFGetFieldDefaulted(TiffFile, TIFFTAG_ROWSPERSTRIP, &RowsPerStrip);
+        Layout.BlockWidth   = m_Desc.Width;
+        Layout.BlockHeight  = std::max(std::min(RowsPerStrip, m_Desc.Height), 1u);
+        Layout.BlockRowSize = static_cast<size_t>(TIFFScanlineSize(TiffFile));
     }
-    else if (PlanarConfig == PLANARCONFIG_SEPARATE)
+    Layout.BlocksAcross = (m_Desc.Width + Layout.BlockWidth - 1) / Layout.BlockWidth;
+    Layout.BlocksDown   = (m_Desc.Height + Layout.BlockHeight - 1) / Layout.BlockHeight;
+
+    const auto ExpectedRowSize = size_t{Layout.BlockWidth} * Layout.BytesPerSample * (Layout.IsPlanar ? 1 : m_Desc.NumComponents);
+    if (Layout.BlockRowSize != ExpectedRowSize)
+        LOG_ERROR_AND_THROW("Unexpected tiff row size (", Layout.BlockRowSize, "). Subsampled tif images are not supported");
+
+    const Uint32 NumBlocks = Layout.GetNumBlocks();
+    VERIFY_EXPR(NumBlocks == (Layout.IsTiled ? TIFFNumberOfTiles(TiffFile) : TIFFNumberOfStrips(TiffFile)));
+
+    auto* const pDstPixels = reinterpret_cast<Uint8*>(m_pData->GetDataPtr());
+    if (LoadInfo.pThreadPool != nullptr && NumBlocks > 1)
     {
-        std::vector<Uint8> ScanlineData(ScanlineSize);
-        for (Uint32 row = 0; row < m_Desc.Height; ++row)
-        {
-            for (Uint16 comp = 0; comp < m_Desc.NumComponents; ++comp)
-            {
-                auto* const pDstRow = reinterpret_cast<Uint8*>(m_pData->GetDataPtr()) + m_Desc.RowStride * row + comp;
-
-                TIFFReadScanline(TiffFile, ScanlineData.data(), row, comp);
-
-                auto CopyComponet = [Width = m_Desc.Width, NumComp = m_Desc.NumComponents](const auto* pSrc, auto* pDst) {
-                    for (Uint32 x = 0; x < Width; ++x)
-                    {
-                        pDst[x * NumComp] = pSrc[x];
-                    }
-                };
-
-                switch (BitsPerSample)
-                {
-                    case 8:
-                        CopyComponet(reinterpret_cast<const Uint8*>(ScanlineData.data()), reinterpret_cast<Uint8*>(pDstRow));
-                        break;
-
-                    case 16:
-                        CopyComponet(reinterpret_cast<const Uint16*>(ScanlineData.data()), reinterpret_cast<Uint16*>(pDstRow));
-                        break;
-
-                    case 32:
-                        CopyComponet(reinterpret_cast<const Uint32*>(ScanlineData.data()), reinterpret_cast<Uint32*>(pDstRow));
-                        break;
-
-                    default:
-                        UNEXPECTED("Unexpected component bit depth (", BitsPerSample, ").");
-                }
-            }
-        }
+        // Every task decodes a contiguous range of blocks through its own tiff handle.
+        // Handles only share the read-only file data, and every block is written to a separate
+        // region of the destination image.
+        const Uint32 NumTasks = std::min(NumBlocks, std::max(std::thread::hardware_concurrency(), 1u) * 2);
+
+        std::atomic<bool> Succeeded{true};
+        ParallelFor(LoadInfo.pThreadPool, NumTasks, [&](Uint32 Task) {
+            const Uint32 FirstBlock = static_cast<Uint32>(Uint64{NumBlocks} * Task / NumTasks);
+            const Uint32 EndBlock   = static_cast<Uint32>(Uint64{NumBlocks} * (Task + 1) / NumTasks);
+
+            TIFFClientOpenWrapper TaskWrpr{pFileData};
+
+            TIFFPtr pTaskTiff{TaskWrpr.Open("rm")};
+            if (!pTaskTiff || !DecodeTIFFBlocks(pTaskTiff.get(), Layout, m_Desc, pDstPixels, FirstBlock, EndBlock))
+                Succeeded.store(false);
+        });
+
+        if (!Succeeded)
+            LOG_ERROR_AND_THROW("Failed to decode tiff image data");
     }
     else
     {
-        UNEXPECTED("Unexpected planar configuration (", PlanarConfig, ").");
+        if (!DecodeTIFFBlocks(TiffFile, Layout, m_Desc, pDstPixels, 0, NumBlocks))
+            LOG_ERROR_AND_THROW("Failed to decode tiff image data");
     }
-    TIFFClose(TiffFile);
 }
 
 
@@ -366,6 +515,12 @@ Image::Image(IReferenceCounters*  pRefCounters,
         if (!Res)
             LOG_ERROR_MESSAGE("Failed to load SGI image");
     }
+    else if (LoadInfo.Format == IMAGE_FILE_FORMAT_EXR)
+    {
+        auto Res = LoadEXR(pFileData, m_pData.RawPtr(), &m_Desc, LoadInfo.pThreadPool);
+        if (!Res)
+            LOG_ERROR_MESSAGE("Failed to load EXR image");
+    }
     else if (LoadInfo.Format == IMAGE_FILE_FORMAT_DDS)
     {
         LOG_ERROR_MESSAGE("An image can't be created from DDS file. Use CreateTextureFromFile() or CreateTextureFromDDS() functions.");
@@ -545,6 +700,9 @@ IMAGE_FILE_FORMAT Image::GetFileFormat(const Uint8* pData, size_t Size, const ch
 
         if (Size >= 2 && pData[0] == 0x01 && pData[1] == 0xDA)
             return IMAGE_FILE_FORMAT_SGI;
+
+        if (Size >= 4 && pData[0] == 0x76 && pData[1] == 0x2F && pData[2] == 0x31 && pData[3] == 0x01)
+            return IMAGE_FILE_FORMAT_EXR;
     }
 
     if (FilePath != nullptr)
@@ -581,6 +739,8 @@ IMAGE_FILE_FORMAT Image::GetFileFormat(const Uint8* pData, size_t Size, const ch
             return IMAGE_FILE_FORMAT_HDR;
         else if (Extension == "tga")
             return IMAGE_FILE_FORMAT_TGA;
+        else if (Extension == "exr")
+            return IMAGE_FILE_FORMAT_EXR;
         else
             LOG_ERROR_MESSAGE("Unrecognized image file extension", Extension);
     }
@@ -612,7 +772,8 @@ IMAGE_FILE_FORMAT CreateImageFromFile(const Char* FilePath,
         if (ImgFileFormat == IMAGE_FILE_FORMAT_PNG ||
             ImgFileFormat == IMAGE_FILE_FORMAT_JPEG ||
             ImgFileFormat == IMAGE_FILE_FORMAT_TIFF ||
-            ImgFileFormat == IMAGE_FILE_FORMAT_SGI)
+            ImgFileFormat == IMAGE_FILE_FORMAT_SGI ||
+            ImgFileFormat == IMAGE_FILE_FORMAT_EXR)
         {
             ImageLoadInfo ImgLoadInfo;
             ImgLoadInfo.Format = ImgFileFormat;
@@ -0,0 +1,130 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "ParallelFor.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "ThreadPool.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+// The state is shared with the pool tasks, so that the tasks that start after
+// ParallelFor() has returned find no items left and exit without touching the function.
+class ParallelForState
+{
+public:
+    ParallelForState(Uint32 Count, const std::function<void(Uint32)>& Func) :
+        m_Count{Count},
+        m_Func{Func}
+    {}
+
+    // Processes items until there are none left.
+    void Run()
+    {
+        Uint32 NumProcessed = 0;
+        for (Uint64 Item = m_NextItem.fetch_add(1); Item < m_Count; Item = m_NextItem.fetch_add(1))
+        {
+            try
+            {
+                m_Func(static_cast<Uint32>(Item));
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> Lock{m_Mtx};
+                if (!m_pException)
+                    m_pException = std::current_exception();
+            }
+            ++NumProcessed;
+        }
+
+        if (NumProcessed > 0)
+        {
+            std::lock_guard<std::mutex> Lock{m_Mtx};
+            m_NumCompleted += NumProcessed;
+            if (m_NumCompleted == m_Count)
+                m_CompletedCV.notify_all();
+        }
+    }
+
+    void Wait()
+    {
+        std::unique_lock<std::mutex> Lock{m_Mtx};
+        m_CompletedCV.wait(Lock, [this] { return m_NumCompleted == m_Count; });
+        if (m_pException)
+            std::rethrow_exception(m_pException);
+    }
+
+private:
+    const Uint32                       m_Count;
+    const std::function<void(Uint32)>& m_Func;
+    std::atomic<Uint64>                m_NextItem{0};
+
+    std::mutex              m_Mtx;
+    std::condition_variable m_CompletedCV;
+    Uint32                  m_NumCompleted = 0;
+    std::exception_ptr      m_pException;
+};
+
+} // namespace
+
+void ParallelFor(IThreadPool* pThreadPool, Uint32 Count, const std::function<void(Uint32)>& Func)
+{
+    if (pThreadPool == nullptr || Count <= 1)
+    {
+        for (Uint32 i = 0; i < Count; ++i)
+            Func(i);
+        return;
+    }
+
+    auto pState = std::make_shared<ParallelForState>(Count, Func);
+
+    // Every task processes items until there are none left, so there is no need
+    // to enqueue more tasks than there are threads that can run them.
+    const Uint32 NumTasks = std::min(Count - 1, std::max(std::thread::hardware_concurrency(), 1u));
+    for (Uint32 i = 0; i < NumTasks; ++i)
+    {
+        EnqueueAsyncWork(pThreadPool, [pState](Uint32 ThreadId) {
+            pState->Run();
+        });
+    }
+
+    pState->Run();
+    pState->Wait();
+}
+
+} // namespace Diligent
@@ -0,0 +1,422 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "TextureCache.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "FileSystem.hpp"
+#include "FileWrapper.hpp"
+#include "DataBlobImpl.hpp"
+#include "DebugUtilities.hpp"
+
+#if PLATFORM_WIN32 || PLATFORM_UNIVERSAL_WINDOWS
+#    include "WinHPreface.h"
+#    include <Windows.h>
+#    include "WinHPostface.h"
+// Windows.h defines CreateDirectory as CreateDirectoryA/W, which breaks FileSystem::CreateDirectory
+#    ifdef CreateDirectory
+#        undef CreateDirectory
+#    endif
+#    define TEXTURE_CACHE_USE_MEMORY_MAPPING PLATFORM_WIN32
+#elif PLATFORM_LINUX || PLATFORM_MACOS || PLATFORM_IOS || PLATFORM_ANDROID
+#    include <sys/mman.h>
+#    include <sys/time.h>
+#    include <fcntl.h>
+#    include <unistd.h>
+#    define TEXTURE_CACHE_USE_MEMORY_MAPPING 1
+#else
+#    include <utime.h>
+#    define TEXTURE_CACHE_USE_MEMORY_MAPPING 0
+#endif
+
+namespace Diligent
+{
+
+namespace
+{
+
+// Increment when the cached data layout or the texture processing changes
+static constexpr Uint32 TextureCacheVersion = 1;
+
+// FNV-1a hash, which is stable across runs and platforms, unlike std::hash.
+class StableHasher
+{
+public:
+    void Update(const void* pData, size_t Size)
+    {
+        const auto* pBytes = static_cast<const Uint8*>(pData);
+        for (size_t i = 0; i < Size; ++i)
+        {
+            m_Hash ^= pBytes[i];
+            m_Hash *= 1099511628211ull;
+        }
+    }
+
+    void Update(Uint32 Value)
+    {
+        Update(&Value, sizeof(Value));
+    }
+
+    Uint64 Get() const { return m_Hash; }
+
+private:
+    Uint64 m_Hash = 14695981039346656037ull;
+};
+
+std::string ToHexString(Uint64 Value)
+{
+    char Str[17] = {};
+    for (int i = 15; i >= 0; --i)
+    {
+        Str[i] = "0123456789abcdef"[Value & 0xF];
+        Value >>= 4;
+    }
+    return Str;
+}
+
+#if PLATFORM_WIN32 || PLATFORM_UNIVERSAL_WINDOWS
+// The number of microseconds between 1601-01-01 (FILETIME epoch) and 1970-01-01
+static constexpr Int64 FileTimeToUnixEpochUs = 11644473600000000ll;
+#endif
+
+// Returns the file size and the modification time in microseconds since 1970-01-01.
+// Whole-second st_mtime is not enough: all entries written or read within one second
+// would have the same time and the eviction order would be arbitrary.
+bool GetFileSizeAndTime(const std::string& Path, Uint64& Size, Int64& ModificationTime)
+{
+#if PLATFORM_WIN32 || PLATFORM_UNIVERSAL_WINDOWS
+    WIN32_FILE_ATTRIBUTE_DATA Attribs{};
+    if (!GetFileAttributesExA(Path.c_str(), GetFileExInfoStandard, &Attribs))
+        return false;
+    Size = (static_cast<Uint64>(Attribs.nFileSizeHigh) << 32u) | Attribs.nFileSizeLow;
+
+    const auto FileTime = (static_cast<Uint64>(Attribs.ftLastWriteTime.dwHighDateTime) << 32u) | Attribs.ftLastWriteTime.dwLowDateTime;
+    ModificationTime    = static_cast<Int64>(FileTime / 10u) - FileTimeToUnixEpochUs;
+#else
+    struct stat Stat = {};
+    if (stat(Path.c_str(), &Stat) != 0)
+        return false;
+    Size = static_cast<Uint64>(Stat.st_size);
+#    if PLATFORM_MACOS || PLATFORM_IOS || PLATFORM_TVOS
+    ModificationTime = static_cast<Int64>(Stat.st_mtimespec.tv_sec) * 1000000 + Stat.st_mtimespec.tv_nsec / 1000;
+#    elif PLATFORM_LINUX || PLATFORM_ANDROID || PLATFORM_EMSCRIPTEN
+    ModificationTime = static_cast<Int64>(Stat.st_mtim.tv_sec) * 1000000 + Stat.st_mtim.tv_nsec / 1000;
+#    else
+    ModificationTime = static_cast<Int64>(Stat.st_mtime) * 1000000;
+#    endif
+#endif
+    return true;
+}
+
+// Returns the current time in microseconds since 1970-01-01. The values returned in this process
+// strictly increase, so that the accesses that happen within the file system timestamp resolution
+// are still ordered.
+Int64 GetAccessTime()
+{
+    static std::atomic<Int64> LastTime{0};
+
+    const Int64 Now = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+    Int64 Last = LastTime.load();
+    Int64 Time = 0;
+    do
+    {
+        Time = std::max(Now, Last + 1);
+    } while (!LastTime.compare_exchange_weak(Last, Time));
+    return Time;
+}
+
+// Updates the modification time, which is used as the last access time for eviction.
+void TouchFile(const std::string& Path)
+{
+    const auto Time = GetAccessTime();
+#if PLATFORM_WIN32 || PLATFORM_UNIVERSAL_WINDOWS
+    // Attribute access is not restricted by the sharing mode of the handles that map the file
+    HANDLE hFile = CreateFileA(Path.c_str(), FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+        return;
+
+    const auto FileTime = static_cast<Uint64>(Time + FileTimeToUnixEpochUs) * 10u;
+    FILETIME   FT{static_cast<DWORD>(FileTime & 0xFFFFFFFFu), static_cast<DWORD>(FileTime >> 32u)};
+    SetFileTime(hFile, nullptr, &FT, &FT);
+    CloseHandle(hFile);
+#elif PLATFORM_LINUX || PLATFORM_MACOS || PLATFORM_IOS || PLATFORM_ANDROID
+    struct timeval Times[2] = {};
+    Times[0].tv_sec  = static_cast<time_t>(Time / 1000000);
+    Times[0].tv_usec = static_cast<suseconds_t>(Time % 1000000);
+    Times[1]         = Times[0];
+    utimes(Path.c_str(), Times);
+#else
+    utimbuf Times{static_cast<time_t>(Time / 1000000), static_cast<time_t>(Time / 1000000)};
+    utime(Path.c_str(), &Times);
+#endif
+}
+
+// Moves the file to the new location, replacing the existing file. Unlike std::rename,
+// this also works on Windows when the destination exists.
+bool ReplaceEntryFile(const std::string& SrcPath, const std::string& DstPath)
+{
+#if PLATFORM_WIN32 || PLATFORM_UNIVERSAL_WINDOWS
+    return MoveFileExA(SrcPath.c_str(), DstPath.c_str(), MOVEFILE_REPLACE_EXISTING) != FALSE;
+#else
+    return std::rename(SrcPath.c_str(), DstPath.c_str()) == 0;
+#endif
+}
+
+} // namespace
+
+TextureCache::Entry::~Entry()
+{
+#if PLATFORM_WIN32
+    if (m_pData != nullptr && !m_pDataBlob)
+        UnmapViewOfFile(m_pData);
+    if (m_hMapping != nullptr)
+        CloseHandle(m_hMapping);
+    if (m_hFile != nullptr)
+        CloseHandle(m_hFile);
+#elif TEXTURE_CACHE_USE_MEMORY_MAPPING
+    if (m_pData != nullptr && !m_pDataBlob)
+        munmap(const_cast<Uint8*>(m_pData), m_Size);
+#endif
+}
+
+TextureCache::TextureCache(const Char* Directory, Uint64 SizeLimit) :
+    m_Directory{Directory != nullptr ? Directory : ""},
+    m_SizeLimit{SizeLimit}
+{
+    if (!m_Directory.empty() && !FileSystem::IsSlash(m_Directory.back()))
+        m_Directory.push_back(FileSystem::SlashSymbol);
+}
+
+std::string TextureCache::ComputeKey(const void* pSrcData, size_t SrcDataSize, const TextureLoadInfo& TexLoadInfo)
+{
+    // The normal map contents can't be included into the key
+    if (TexLoadInfo.pRoughnessNormalMap != nullptr)
+        return "";
+
+    // The component mapping of the compact format is not stored in the cache entry
+    if (TexLoadInfo.CompactFormat)
+        return "";
+
+    StableHasher SrcHasher;
+    SrcHasher.Update(pSrcData, SrcDataSize);
+
+    // Only the members that affect the texture contents and format are included.
+    // Name, usage, bind and CPU access flags are taken from TexLoadInfo when the entry is loaded.
+    StableHasher ParamsHasher;
+    ParamsHasher.Update(TextureCacheVersion);
+    ParamsHasher.Update(static_cast<Uint32>(SrcDataSize));
+    ParamsHasher.Update(static_cast<Uint32>(static_cast<Uint64>(SrcDataSize) >> 32u));
+    ParamsHasher.Update(TexLoadInfo.MipLevels);
+    ParamsHasher.Update(TexLoadInfo.IsSRGB ? 1u : 0u);
+    ParamsHasher.Update(TexLoadInfo.GenerateMips ? 1u : 0u);
+    ParamsHasher.Update(TexLoadInfo.FlipVertically ? 1u : 0u);
+    ParamsHasher.Update(TexLoadInfo.PermultiplyAlpha ? 1u : 0u);
+    ParamsHasher.Update(static_cast<Uint32>(TexLoadInfo.Format));
+    ParamsHasher.Update(&TexLoadInfo.AlphaCutoff, sizeof(TexLoadInfo.AlphaCutoff));
+    ParamsHasher.Update(static_cast<Uint32>(TexLoadInfo.MipFilter));
+    ParamsHasher.Update(static_cast<Uint32>(TexLoadInfo.Swizzle.R));
+    ParamsHasher.Update(static_cast<Uint32>(TexLoadInfo.Swizzle.G));
+    ParamsHasher.Update(static_cast<Uint32>(TexLoadInfo.Swizzle.B));
+    ParamsHasher.Update(static_cast<Uint32>(TexLoadInfo.Swizzle.A));
+    // Keep the keys of the existing entries unchanged when no distance field is requested
+    if (TexLoadInfo.DistanceField != TEXTURE_LOAD_DISTANCE_FIELD_NONE)
+    {
+        ParamsHasher.Update(static_cast<Uint32>(TexLoadInfo.DistanceField));
+        ParamsHasher.Update(&TexLoadInfo.DistanceFieldSpread, sizeof(TexLoadInfo.DistanceFieldSpread));
+        ParamsHasher.Update(TexLoadInfo.DistanceFieldDownscale);
+    }
+
+    return ToHexString(SrcHasher.Get()) + ToHexString(ParamsHasher.Get());
+}
+
+std::string TextureCache::GetEntryPath(const std::string& Key) const
+{
+    return m_Directory + Key + ".dds";
+}
+
+std::unique_ptr<TextureCache::Entry> TextureCache::Load(const std::string& Key) const
+{
+    VERIFY_EXPR(!Key.empty());
+    const auto Path = GetEntryPath(Key);
+
+    std::unique_ptr<Entry> pEntry{new Entry{}};
+#if TEXTURE_CACHE_USE_MEMORY_MAPPING
+#    if PLATFORM_WIN32
+    // Allow other processes to evict the entry while it is mapped
+    HANDLE hFile = CreateFileA(Path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+        return nullptr;
+    pEntry->m_hFile = hFile;
+
+    LARGE_INTEGER FileSize{};
+    if (GetFileSizeEx(hFile, &FileSize) && FileSize.QuadPart > 0 && static_cast<Uint64>(FileSize.QuadPart) <= std::numeric_limits<size_t>::max())
+    {
+        pEntry->m_hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (pEntry->m_hMapping != nullptr)
+        {
+            pEntry->m_pData = static_cast<const Uint8*>(MapViewOfFile(pEntry->m_hMapping, FILE_MAP_READ, 0, 0, 0));
+            pEntry->m_Size  = static_cast<size_t>(FileSize.QuadPart);
+        }
+    }
+#    else
+    const int fd = open(Path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+
+    struct stat FileStat = {};
+    if (fstat(fd, &FileStat) == 0 && FileStat.st_size > 0 && static_cast<Uint64>(FileStat.st_size) <= std::numeric_limits<size_t>::max())
+    {
+        const auto Size  = static_cast<size_t>(FileStat.st_size);
+        void*      pData = mmap(nullptr, Size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (pData != MAP_FAILED)
+        {
+            pEntry->m_pData = static_cast<const Uint8*>(pData);
+            pEntry->m_Size  = Size;
+        }
+    }
+    // The mapping keeps its own reference to the file
+    close(fd);
+#    endif
+#endif
+
+    if (pEntry->m_pData == nullptr)
+    {
+        FileWrapper File{Path.c_str(), EFileAccessMode::Read};
+        if (!File)
+            return nullptr;
+
+        pEntry->m_pDataBlob = DataBlobImpl::Create();
+        File->Read(pEntry->m_pDataBlob);
+        pEntry->m_pData = static_cast<const Uint8*>(pEntry->m_pDataBlob->GetConstDataPtr());
+        pEntry->m_Size  = pEntry->m_pDataBlob->GetSize();
+        if (pEntry->m_Size == 0)
+            return nullptr;
+    }
+
+    TouchFile(Path);
+
+    return pEntry;
+}
+
+bool TextureCache::Store(const std::string& Key, const TextureDesc& Desc, const TextureData& Data) const
+{
+    VERIFY_EXPR(!Key.empty());
+    const auto Path = GetEntryPath(Key);
+
+    if (!m_Directory.empty())
+        FileSystem::CreateDirectory(m_Directory.c_str());
+
+    // Unique temporary file name, so that processes that write the same entry do not interfere
+    static std::atomic<Uint32> TempFileCounter{0};
+
+    const auto TempId =
+        static_cast<Uint64>(std::chrono::high_resolution_clock::now().time_since_epoch().count()) ^
+        (static_cast<Uint64>(std::hash<std::thread::id>{}(std::this_thread::get_id())) << 16u) ^
+        (static_cast<Uint64>(TempFileCounter.fetch_add(1)) << 48u);
+    const auto TempPath = Path + "." + ToHexString(TempId) + ".tmp";
+
+    if (!SaveTextureAsDDS(TempPath.c_str(), Desc, Data))
+    {
+        std::remove(TempPath.c_str());
+        LOG_WARNING_MESSAGE("Failed to write texture cache entry '", Path, "'");
+        return false;
+    }
+
+    if (!ReplaceEntryFile(TempPath, Path))
+    {
+        // Another process may have written the same entry and may be holding it open
+        std::remove(TempPath.c_str());
+        return false;
+    }
+    TouchFile(Path);
+
+    if (m_SizeLimit > 0)
+        EvictEntries(Path);
+
+    return true;
+}
+
+void TextureCache::EvictEntries(const std::string& KeepPath) const
+{
+    struct EntryInfo
+    {
+        std::string Path;
+        Uint64      Size             = 0;
+        Int64       ModificationTime = 0;
+    };
+    std::vector<EntryInfo> Entries;
+
+    Uint64     TotalSize  = 0;
+    const auto SearchRes  = FileSystem::Search((m_Directory + "*.dds").c_str());
+    for (const auto& pFile : SearchRes)
+    {
+        if (pFile->IsDirectory())
+            continue;
+
+        EntryInfo Info;
+        Info.Path = m_Directory + pFile->Name();
+        if (!GetFileSizeAndTime(Info.Path, Info.Size, Info.ModificationTime))
+            continue;
+
+        TotalSize += Info.Size;
+        if (Info.Path != KeepPath)
+            Entries.emplace_back(std::move(Info));
+    }
+    if (TotalSize <= m_SizeLimit)
+        return;
+
+    std::sort(Entries.begin(), Entries.end(), [](const EntryInfo& lhs, const EntryInfo& rhs) {
+        // Order the entries with the same time by path to make the eviction deterministic
+        return lhs.ModificationTime != rhs.ModificationTime ?
+            lhs.ModificationTime < rhs.ModificationTime :
+            lhs.Path < rhs.Path;
+    });
+    for (const auto& Info : Entries)
+    {
+        if (TotalSize <= m_SizeLimit)
+            break;
+
+        // The file may be open by another process, in which case it will be evicted later
+        if (std::remove(Info.Path.c_str()) == 0)
+            TotalSize -= Info.Size;
+    }
+}
+
+} // namespace Diligent
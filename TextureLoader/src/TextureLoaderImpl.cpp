@@ -27,6 +27,7 @@
 
 #include "pch.h"
 #include <algorithm>
+#include <functional>
 #include <limits>
 #include <math.h>
 #include <vector>
@@ -42,6 +43,8 @@
 #include "FileWrapper.hpp"
 #include "DataBlobImpl.hpp"
 #include "Align.hpp"
+#include "ParallelFor.hpp"
+#include "HalfFloat.hpp"
 
 extern "C"
 {
@@ -140,18 +143,34 @@ TextureLoaderImpl::TextureLoaderImpl(IReferenceCounters*        pRefCounters,
         ImgFileFormat == IMAGE_FILE_FORMAT_TIFF ||
         ImgFileFormat == IMAGE_FILE_FORMAT_SGI ||
         ImgFileFormat == IMAGE_FILE_FORMAT_HDR ||
-        ImgFileFormat == IMAGE_FILE_FORMAT_TGA)
+        ImgFileFormat == IMAGE_FILE_FORMAT_TGA ||
+        ImgFileFormat == IMAGE_FILE_FORMAT_EXR)
     {
-        ImageLoadInfo ImgLoadInfo;
-        ImgLoadInfo.Format = ImgFileFormat;
-        if (!m_pDataBlob)
+        std::unique_ptr<TextureCache> pCache;
+        std::string                   CacheKey;
+        if (TexLoadInfo.CacheDirectory != nullptr)
         {
-            m_pDataBlob = DataBlobImpl::Create(DataSize, pData);
+            CacheKey = TextureCache::ComputeKey(pData, DataSize, TexLoadInfo);
+            if (!CacheKey.empty())
+                pCache.reset(new TextureCache{TexLoadInfo.CacheDirectory, TexLoadInfo.CacheSizeLimit});
+        }
+
+        if (!pCache || !LoadFromCache(TexLoadInfo, *pCache, CacheKey))
+        {
+            ImageLoadInfo ImgLoadInfo;
+            ImgLoadInfo.Format = ImgFileFormat;
+            if (!m_pDataBlob)
+            {
+                m_pDataBlob = DataBlobImpl::Create(DataSize, pData);
+            }
+            ImgLoadInfo.IsSRGB           = TexLoadInfo.IsSRGB;
+            ImgLoadInfo.PermultiplyAlpha = TexLoadInfo.PermultiplyAlpha;
+            Image::CreateFromDataBlob(m_pDataBlob, ImgLoadInfo, &m_pImage);
+            LoadFromImage(TexLoadInfo);
+
+            if (pCache)
+                pCache->Store(CacheKey, m_TexDesc, GetTextureData());
         }
-        ImgLoadInfo.IsSRGB           = TexLoadInfo.IsSRGB;
-        ImgLoadInfo.PermultiplyAlpha = TexLoadInfo.PermultiplyAlpha;
-        Image::CreateFromDataBlob(m_pDataBlob, ImgLoadInfo, &m_pImage);
-        LoadFromImage(TexLoadInfo);
         m_pDataBlob.Release();
     }
     else
@@ -183,6 +202,93 @@ TextureLoaderImpl::TextureLoaderImpl(IReferenceCounters*    pRefCounters,
     LoadFromImage(TexLoadInfo);
 }
 
+TextureLoaderImpl::TextureLoaderImpl(IReferenceCounters*               pRefCounters,
+                                     const TextureDesc&                TexDesc,
+                                     std::vector<std::vector<Uint8>>&& Subresources) :
+    TBase{pRefCounters},
+    m_Name{TexDesc.Name != nullptr ? TexDesc.Name : ""},
+    m_TexDesc{TexDesc},
+    m_Mips{std::move(Subresources)}
+{
+    m_TexDesc.Name = m_Name.c_str();
+
+    const auto NumSlices = m_TexDesc.Type == RESOURCE_DIM_TEX_3D ? 1u : m_TexDesc.ArraySize;
+    VERIFY_EXPR(m_Mips.size() == size_t{NumSlices} * m_TexDesc.MipLevels);
+
+    m_SubResources.resize(m_Mips.size());
+    for (Uint32 Slice = 0; Slice < NumSlices; ++Slice)
+    {
+        for (Uint32 mip = 0; mip < m_TexDesc.MipLevels; ++mip)
+        {
+            const auto MipProps = GetMipLevelProperties(m_TexDesc, mip);
+            const auto Subres   = size_t{Slice} * m_TexDesc.MipLevels + mip;
+            VERIFY_EXPR(m_Mips[Subres].size() >= MipProps.MipSize);
+
+            m_SubResources[Subres].pData       = m_Mips[Subres].data();
+            m_SubResources[Subres].Stride      = MipProps.RowSize;
+            m_SubResources[Subres].DepthStride = MipProps.DepthSliceSize;
+        }
+    }
+}
+
+// Returns the mip level of the texture whose size is Width x Height, or ~0u if there is no such level.
+static Uint32 FindMipLevelWithSize(const TextureDesc& Desc, Uint32 Width, Uint32 Height)
+{
+    for (Uint32 mip = 0;; ++mip)
+    {
+        const auto MipWidth  = std::max(Desc.Width >> mip, 1u);
+        const auto MipHeight = std::max(Desc.Height >> mip, 1u);
+        if (MipWidth == Width && MipHeight == Height)
+            return mip;
+        if (MipWidth == 1 && MipHeight == 1)
+            return ~0u;
+    }
+}
+
+TextureLoaderImpl::TextureLoaderImpl(IReferenceCounters*                          pRefCounters,
+                                     const TextureDesc&                           TexDesc,
+                                     std::vector<RefCntAutoPtr<ITextureLoader>>&& Slices) :
+    TBase{pRefCounters},
+    m_Name{TexDesc.Name != nullptr ? TexDesc.Name : ""},
+    m_TexDesc{TexDesc},
+    m_SliceLoaders{std::move(Slices)}
+{
+    m_TexDesc.Name = m_Name.c_str();
+    VERIFY_EXPR(m_SliceLoaders.size() == m_TexDesc.ArraySize);
+
+    m_SubResources.resize(size_t{m_TexDesc.ArraySize} * m_TexDesc.MipLevels);
+    for (Uint32 Slice = 0; Slice < m_TexDesc.ArraySize; ++Slice)
+    {
+        const auto& SliceDesc = m_SliceLoaders[Slice]->GetTextureDesc();
+        const auto  FirstMip  = FindMipLevelWithSize(SliceDesc, m_TexDesc.Width, m_TexDesc.Height);
+        VERIFY_EXPR(SliceDesc.Format == m_TexDesc.Format && FirstMip + m_TexDesc.MipLevels <= SliceDesc.MipLevels);
+        for (Uint32 mip = 0; mip < m_TexDesc.MipLevels; ++mip)
+            m_SubResources[size_t{Slice} * m_TexDesc.MipLevels + mip] = m_SliceLoaders[Slice]->GetSubresourceData(FirstMip + mip, 0);
+    }
+}
+
+bool TextureLoaderImpl::LoadFromCache(const TextureLoadInfo& TexLoadInfo, const TextureCache& Cache, const std::string& Key)
+{
+    m_pCacheEntry = Cache.Load(Key);
+    if (!m_pCacheEntry)
+        return false;
+
+    try
+    {
+        // Subresources reference the cache entry data directly
+        LoadFromDDS(TexLoadInfo, m_pCacheEntry->GetData(), m_pCacheEntry->GetSize());
+        return true;
+    }
+    catch (std::runtime_error&)
+    {
+        LOG_WARNING_MESSAGE("Texture cache entry '", Key, "' is invalid. The texture will be loaded from the source data.");
+        m_pCacheEntry.reset();
+        m_SubResources.clear();
+        m_TexDesc = TexDescFromTexLoadInfo(TexLoadInfo, m_Name);
+        return false;
+    }
+}
+
 void TextureLoaderImpl::CreateTexture(IRenderDevice* pDevice,
                                       ITexture**     ppTexture)
 {
@@ -190,10 +296,174 @@ void TextureLoaderImpl::CreateTexture(IRenderDevice* pDevice,
     pDevice->CreateTexture(m_TexDesc, &InitData, ppTexture);
 }
 
+static bool IsIdentitySwizzle(const TextureComponentMapping& Swizzle)
+{
+    return ((Swizzle.R == TEXTURE_COMPONENT_SWIZZLE_IDENTITY || Swizzle.R == TEXTURE_COMPONENT_SWIZZLE_R) &&
+            (Swizzle.G == TEXTURE_COMPONENT_SWIZZLE_IDENTITY || Swizzle.G == TEXTURE_COMPONENT_SWIZZLE_G) &&
+            (Swizzle.B == TEXTURE_COMPONENT_SWIZZLE_IDENTITY || Swizzle.B == TEXTURE_COMPONENT_SWIZZLE_B) &&
+            (Swizzle.A == TEXTURE_COMPONENT_SWIZZLE_IDENTITY || Swizzle.A == TEXTURE_COMPONENT_SWIZZLE_A));
+}
+
+// Returns the number of components of the compact format that represents the image exactly,
+// or 0 if the default format should be used. Sets the swizzle that packs the image components
+// into the compact format, and the mapping that restores them when the texture is sampled.
+Uint32 TextureLoaderImpl::SelectCompactFormat(const TextureLoadInfo& TexLoadInfo, TextureComponentMapping& PackSwizzle)
+{
+    VERIFY_EXPR(m_pContentInfo);
+
+    const auto& ImgDesc = m_pImage->GetDesc();
+    if ((ImgDesc.ComponentType != VT_UINT8 && ImgDesc.ComponentType != VT_UINT16) ||
+        TexLoadInfo.IsSRGB ||
+        !IsIdentitySwizzle(TexLoadInfo.Swizzle) ||
+        TexLoadInfo.AlphaCutoff != 0 ||
+        TexLoadInfo.MipFilter == TEXTURE_LOAD_MIP_FILTER_NORMAL_MAP ||
+        TexLoadInfo.pRoughnessNormalMap != nullptr)
+    {
+        return 0;
+    }
+
+    const auto& Info = *m_pContentInfo;
+
+    const auto IsZero = [&Info](Uint32 Comp) {
+        return (Info.ConstantComponents & (1u << Comp)) != 0 && Info.MaxValues[Comp] == 0;
+    };
+
+    PackSwizzle = TextureComponentMapping::Identity();
+    if (Info.NumComponents >= 3)
+    {
+        if (Info.IsGrayscale)
+        {
+            m_ComponentMapping.R = TEXTURE_COMPONENT_SWIZZLE_R;
+            m_ComponentMapping.G = TEXTURE_COMPONENT_SWIZZLE_R;
+            m_ComponentMapping.B = TEXTURE_COMPONENT_SWIZZLE_R;
+            if (Info.IsOpaque)
+            {
+                // RGB(A) -> R
+                m_ComponentMapping.A = TEXTURE_COMPONENT_SWIZZLE_ONE;
+                return 1;
+            }
+            else
+            {
+                // RGBA -> RA
+                PackSwizzle.G        = TEXTURE_COMPONENT_SWIZZLE_A;
+                m_ComponentMapping.A = TEXTURE_COMPONENT_SWIZZLE_G;
+                return 2;
+            }
+        }
+
+        // R and RG formats are sampled as (R, 0, 0, 1) and (R, G, 0, 1),
+        // so the mapping is not needed.
+        if (Info.IsOpaque && IsZero(2))
+            return IsZero(1) ? 1 : 2;
+    }
+    else if (Info.NumComponents == 2)
+    {
+        if (IsZero(1))
+            return 1;
+    }
+
+    return 0;
+}
+
+void TextureLoaderImpl::ConvertToDistanceField(const TextureLoadInfo& TexLoadInfo)
+{
+    VERIFY_EXPR(m_pImage);
+    const auto& ImgDesc = m_pImage->GetDesc();
+    if (ImgDesc.ComponentType != VT_UINT8 && ImgDesc.ComponentType != VT_UINT16 && ImgDesc.ComponentType != VT_FLOAT32)
+        LOG_ERROR_AND_THROW("Distance fields can only be generated from 8-bit, 16-bit and 32-bit float images");
+    if (TexLoadInfo.DistanceFieldSpread <= 0)
+        LOG_ERROR_AND_THROW("Distance field spread (", TexLoadInfo.DistanceFieldSpread, ") must be positive");
+
+    const Uint32 Downscale = std::max(TexLoadInfo.DistanceFieldDownscale, 1u);
+
+    DistanceFieldAttribs Attribs;
+    Attribs.SrcWidth          = ImgDesc.Width;
+    Attribs.SrcHeight         = ImgDesc.Height;
+    Attribs.pSrcPixels        = m_pImage->GetData()->GetConstDataPtr();
+    Attribs.SrcStride         = ImgDesc.RowStride;
+    Attribs.SrcComponentCount = ImgDesc.NumComponents;
+    Attribs.SrcComponentType  = ImgDesc.ComponentType;
+    if (TexLoadInfo.DistanceField == TEXTURE_LOAD_DISTANCE_FIELD_ALL_COMPONENTS)
+    {
+        Attribs.FirstComponent = 0;
+        Attribs.NumChannels    = ImgDesc.NumComponents;
+    }
+    else
+    {
+        // RGB images have no alpha, so the red channel is used as the mask
+        Attribs.FirstComponent = ImgDesc.NumComponents != 3 ? ImgDesc.NumComponents - 1 : 0;
+        Attribs.NumChannels    = 1;
+    }
+    Attribs.Spread           = TexLoadInfo.DistanceFieldSpread;
+    Attribs.DstWidth         = std::max(ImgDesc.Width / Downscale, 1u);
+    Attribs.DstHeight        = std::max(ImgDesc.Height / Downscale, 1u);
+    Attribs.DstStride        = AlignUp(Attribs.DstWidth * Attribs.NumChannels, Uint32{4});
+    Attribs.DstComponentType = VT_UINT8;
+
+    auto pPixels       = DataBlobImpl::Create(size_t{Attribs.DstStride} * Attribs.DstHeight);
+    Attribs.pDstPixels = pPixels->GetDataPtr();
+    ComputeDistanceField(Attribs);
+
+    ImageDesc DstDesc;
+    DstDesc.Width         = Attribs.DstWidth;
+    DstDesc.Height        = Attribs.DstHeight;
+    DstDesc.ComponentType = VT_UINT8;
+    DstDesc.NumComponents = Attribs.NumChannels;
+    DstDesc.RowStride     = Attribs.DstStride;
+
+    m_pImage.Release();
+    Image::CreateFromMemory(DstDesc, pPixels, &m_pImage);
+}
+
+// ComputeMipLevel only supports 32-bit float formats, so half-float levels
+// are converted to 32-bit float, filtered, and converted back.
+static void ComputeHalfFloatMipLevel(const ComputeMipLevelAttribs& Attribs, Uint32 NumComponents)
+{
+    const Uint32 CoarseMipWidth  = std::max(Attribs.FineMipWidth / 2u, 1u);
+    const Uint32 CoarseMipHeight = std::max(Attribs.FineMipHeight / 2u, 1u);
+    const size_t FineRowSize     = size_t{Attribs.FineMipWidth} * NumComponents;
+    const size_t CoarseRowSize   = size_t{CoarseMipWidth} * NumComponents;
+
+    std::vector<float> FineMip(FineRowSize * Attribs.FineMipHeight);
+    for (Uint32 y = 0; y < Attribs.FineMipHeight; ++y)
+    {
+        const auto* pSrcRow = static_cast<const Uint8*>(Attribs.pFineMipData) + y * Attribs.FineMipStride;
+        for (size_t i = 0; i < FineRowSize; ++i)
+        {
+            Uint16 Half;
+            memcpy(&Half, pSrcRow + i * sizeof(Uint16), sizeof(Half));
+            FineMip[y * FineRowSize + i] = HalfToFloat(Half);
+        }
+    }
+
+    std::vector<float> CoarseMip(CoarseRowSize * CoarseMipHeight);
+
+    ComputeMipLevelAttribs FloatAttribs = Attribs;
+    FloatAttribs.Format                 = TextureComponentAttribsToTextureFormat(COMPONENT_TYPE_FLOAT, 4, NumComponents);
+    FloatAttribs.pFineMipData           = FineMip.data();
+    FloatAttribs.FineMipStride          = FineRowSize * sizeof(float);
+    FloatAttribs.pCoarseMipData         = CoarseMip.data();
+    FloatAttribs.CoarseMipStride        = CoarseRowSize * sizeof(float);
+    ComputeMipLevel(FloatAttribs);
+
+    for (Uint32 y = 0; y < CoarseMipHeight; ++y)
+    {
+        auto* pDstRow = static_cast<Uint8*>(Attribs.pCoarseMipData) + y * Attribs.CoarseMipStride;
+        for (size_t i = 0; i < CoarseRowSize; ++i)
+        {
+            const Uint16 Half = FloatToHalf(CoarseMip[y * CoarseRowSize + i]);
+            memcpy(pDstRow + i * sizeof(Uint16), &Half, sizeof(Half));
+        }
+    }
+}
+
 void TextureLoaderImpl::LoadFromImage(const TextureLoadInfo& TexLoadInfo)
 {
     VERIFY_EXPR(m_pImage);
 
+    if (TexLoadInfo.DistanceField != TEXTURE_LOAD_DISTANCE_FIELD_NONE)
+        ConvertToDistanceField(TexLoadInfo);
+
     const auto& ImgDesc  = m_pImage->GetDesc();
     const auto  CompSize = GetValueSize(ImgDesc.ComponentType);
 
@@ -204,10 +474,33 @@ void TextureLoaderImpl::LoadFromImage(const TextureLoadInfo& TexLoadInfo)
     if (TexLoadInfo.MipLevels > 0)
         m_TexDesc.MipLevels = std::min(m_TexDesc.MipLevels, TexLoadInfo.MipLevels);
 
+    if (TexLoadInfo.CompactFormat &&
+        (ImgDesc.ComponentType == VT_UINT8 || ImgDesc.ComponentType == VT_UINT16 || ImgDesc.ComponentType == VT_FLOAT32))
+    {
+        ImageContentAnalysisAttribs AnalysisAttribs;
+        AnalysisAttribs.Width          = ImgDesc.Width;
+        AnalysisAttribs.Height         = ImgDesc.Height;
+        AnalysisAttribs.pPixels        = m_pImage->GetData()->GetConstDataPtr();
+        AnalysisAttribs.Stride         = ImgDesc.RowStride;
+        AnalysisAttribs.ComponentCount = ImgDesc.NumComponents;
+        AnalysisAttribs.ComponentType  = ImgDesc.ComponentType;
+        m_pContentInfo                 = std::make_unique<ImageContentInfo>(AnalyzeImageContent(AnalysisAttribs));
+    }
+
+    // Swizzle that packs the image components into the compact format
+    TextureComponentMapping CompactSwizzle;
+    Uint32                  CompactNumComponents = 0;
     if (m_TexDesc.Format == TEX_FORMAT_UNKNOWN)
     {
         Uint32 NumComponents = ImgDesc.NumComponents;
-        if (NumComponents == 3)
+        if (m_pContentInfo)
+            CompactNumComponents = SelectCompactFormat(TexLoadInfo, CompactSwizzle);
+
+        if (CompactNumComponents != 0)
+        {
+            NumComponents = CompactNumComponents;
+        }
+        else if (NumComponents == 3)
         {
             // Note that there is RGB32_FLOAT format, but it can't be filtered, so always extend RGB to RGBA.
             NumComponents = 4;
@@ -287,6 +580,11 @@ void TextureLoaderImpl::LoadFromImage(const TextureLoadInfo& TexLoadInfo)
             CopyAttribs.Swizzle *= TexLoadInfo.Swizzle;
         }
 
+        if (CompactNumComponents != 0)
+        {
+            CopyAttribs.Swizzle = CompactSwizzle;
+        }
+
         CopyPixels(CopyAttribs);
     }
     else
@@ -295,6 +593,17 @@ void TextureLoaderImpl::LoadFromImage(const TextureLoadInfo& TexLoadInfo)
         m_SubResources[0].Stride = ImgDesc.RowStride;
     }
 
+    bool NormalMapMips = false;
+    if (TexLoadInfo.GenerateMips && TexLoadInfo.MipFilter == TEXTURE_LOAD_MIP_FILTER_NORMAL_MAP)
+    {
+        NormalMapMips = TexFmtDesc.ComponentType == COMPONENT_TYPE_UNORM && TexFmtDesc.ComponentSize == 1 && NumComponents >= 2;
+        if (!NormalMapMips)
+        {
+            LOG_WARNING_MESSAGE("Normal map mip filter is not supported for ", TexFmtDesc.Name, " format of texture '", m_Name,
+                                "'. Default filter will be used.");
+        }
+    }
+
     for (Uint32 m = 1; m < m_TexDesc.MipLevels; ++m)
     {
         const MipLevelProperties MipLevelProps = GetMipLevelProperties(m_TexDesc, m);
@@ -313,7 +622,19 @@ void TextureLoaderImpl::LoadFromImage(const TextureLoadInfo& TexLoadInfo)
         if (TexLoadInfo.GenerateMips)
         {
             auto FinerMipProps = GetMipLevelProperties(m_TexDesc, m - 1);
-            if (TexLoadInfo.GenerateMips)
+            if (NormalMapMips)
+            {
+                NormalMapMipLevelAttribs Attribs;
+                Attribs.FineMipWidth    = FinerMipProps.LogicalWidth;
+                Attribs.FineMipHeight   = FinerMipProps.LogicalHeight;
+                Attribs.pFineMipData    = m_SubResources[m - 1].pData;
+                Attribs.FineMipStride   = StaticCast<Uint32>(m_SubResources[m - 1].Stride);
+                Attribs.pCoarseMipData  = m_Mips[m].data();
+                Attribs.CoarseMipStride = StaticCast<Uint32>(m_SubResources[m].Stride);
+                Attribs.ComponentCount  = NumComponents;
+                ComputeNormalMapMipLevel(Attribs);
+            }
+            else
             {
                 ComputeMipLevelAttribs Attribs;
                 Attribs.Format          = m_TexDesc.Format;
@@ -327,11 +648,73 @@ void TextureLoaderImpl::LoadFromImage(const TextureLoadInfo& TexLoadInfo)
                 static_assert(MIP_FILTER_TYPE_DEFAULT == static_cast<MIP_FILTER_TYPE>(TEXTURE_LOAD_MIP_FILTER_DEFAULT), "Inconsistent enum values");
                 static_assert(MIP_FILTER_TYPE_BOX_AVERAGE == static_cast<MIP_FILTER_TYPE>(TEXTURE_LOAD_MIP_FILTER_BOX_AVERAGE), "Inconsistent enum values");
                 static_assert(MIP_FILTER_TYPE_MOST_FREQUENT == static_cast<MIP_FILTER_TYPE>(TEXTURE_LOAD_MIP_FILTER_MOST_FREQUENT), "Inconsistent enum values");
-                Attribs.FilterType = static_cast<MIP_FILTER_TYPE>(TexLoadInfo.MipFilter);
-                ComputeMipLevel(Attribs);
+                Attribs.FilterType = TexLoadInfo.MipFilter != TEXTURE_LOAD_MIP_FILTER_NORMAL_MAP ?
+                    static_cast<MIP_FILTER_TYPE>(TexLoadInfo.MipFilter) :
+                    MIP_FILTER_TYPE_DEFAULT;
+                if (TexFmtDesc.ComponentType == COMPONENT_TYPE_FLOAT && TexFmtDesc.ComponentSize == 2)
+                    ComputeHalfFloatMipLevel(Attribs, NumComponents);
+                else
+                    ComputeMipLevel(Attribs);
             }
         }
     }
+
+    if (TexLoadInfo.pRoughnessNormalMap != nullptr)
+    {
+        BakeNormalVarianceToRoughness(*TexLoadInfo.pRoughnessNormalMap, TexLoadInfo.RoughnessComponent);
+    }
+}
+
+void TextureLoaderImpl::BakeNormalVarianceToRoughness(ITextureLoader& NormalMap, Uint32 RoughnessComponent)
+{
+    const auto& TexFmtDesc = GetTextureFormatAttribs(m_TexDesc.Format);
+    if (TexFmtDesc.ComponentType != COMPONENT_TYPE_UNORM || TexFmtDesc.ComponentSize != 1 || RoughnessComponent >= TexFmtDesc.NumComponents)
+    {
+        LOG_WARNING_MESSAGE("Normal variance can't be added to the roughness of texture '", m_Name, "': format ", TexFmtDesc.Name,
+                            " is not an 8-bit UNORM format or does not have component ", RoughnessComponent, '.');
+        return;
+    }
+
+    const auto& NormalMapDesc    = NormalMap.GetTextureDesc();
+    const auto& NormalFmtDesc    = GetTextureFormatAttribs(NormalMapDesc.Format);
+    const auto& NormalMapSubres0 = NormalMap.GetSubresourceData(0, 0);
+    if (NormalMapDesc.Type != RESOURCE_DIM_TEX_2D || NormalFmtDesc.ComponentType != COMPONENT_TYPE_UNORM ||
+        NormalFmtDesc.ComponentSize != 1 || NormalFmtDesc.NumComponents < 2 || NormalMapSubres0.pData == nullptr)
+    {
+        LOG_WARNING_MESSAGE("Normal variance can't be added to the roughness of texture '", m_Name, "': normal map '",
+                            (NormalMapDesc.Name != nullptr ? NormalMapDesc.Name : ""), "' must be a 2D texture in an 8-bit UNORM format with at least two components.");
+        return;
+    }
+
+    // Texels of the most detailed level only cover multiple normals when the normal map is larger than the texture.
+    const Uint32 StartMip = (NormalMapDesc.Width > m_TexDesc.Width || NormalMapDesc.Height > m_TexDesc.Height) ? 0 : 1;
+    if (StartMip == 0 && m_Mips[0].empty())
+    {
+        // The most detailed level references the image data that must not be modified
+        VERIFY_EXPR(m_pImage && m_SubResources[0].pData == m_pImage->GetData()->GetConstDataPtr());
+        const auto* pImageData = static_cast<const Uint8*>(m_pImage->GetData()->GetConstDataPtr());
+        m_Mips[0].assign(pImageData, pImageData + m_pImage->GetData()->GetSize());
+        m_SubResources[0].pData = m_Mips[0].data();
+    }
+
+    NormalVarianceToRoughnessAttribs Attribs;
+    Attribs.NormalMapWidth          = NormalMapDesc.Width;
+    Attribs.NormalMapHeight         = NormalMapDesc.Height;
+    Attribs.pNormalMapPixels        = NormalMapSubres0.pData;
+    Attribs.NormalMapStride         = StaticCast<Uint32>(NormalMapSubres0.Stride);
+    Attribs.NormalMapComponentCount = NormalFmtDesc.NumComponents;
+    Attribs.ComponentCount          = TexFmtDesc.NumComponents;
+    Attribs.RoughnessComponent      = RoughnessComponent;
+    for (Uint32 m = StartMip; m < m_TexDesc.MipLevels; ++m)
+    {
+        const MipLevelProperties MipLevelProps = GetMipLevelProperties(m_TexDesc, m);
+
+        Attribs.Width   = MipLevelProps.LogicalWidth;
+        Attribs.Height  = MipLevelProps.LogicalHeight;
+        Attribs.pPixels = m_Mips[m].data();
+        Attribs.Stride  = StaticCast<Uint32>(m_SubResources[m].Stride);
+        AddNormalVarianceToRoughness(Attribs);
+    }
 }
 
 
@@ -403,6 +786,211 @@ void CreateTextureLoaderFromImage(Image*                 pSrcImage,
     }
 }
 
+using CreateSliceLoaderFuncType = std::function<void(Uint32 Slice, const TextureLoadInfo& SliceLoadInfo, ITextureLoader** ppSliceLoader)>;
+
+// Returns the format that all slices can be converted to, or TEX_FORMAT_UNKNOWN if there is no such format.
+static TEXTURE_FORMAT GetUnifiedSliceFormat(const std::vector<RefCntAutoPtr<ITextureLoader>>& Slices)
+{
+    const auto GetNonSRGBComponentType = [](const TextureFormatAttribs& FmtAttribs) {
+        return FmtAttribs.ComponentType == COMPONENT_TYPE_UNORM_SRGB ? COMPONENT_TYPE_UNORM : FmtAttribs.ComponentType;
+    };
+
+    TEXTURE_FORMAT UnifiedFormat = Slices[0]->GetTextureDesc().Format;
+    for (const auto& pSlice : Slices)
+    {
+        const auto& UnifiedFmtAttribs = GetTextureFormatAttribs(UnifiedFormat);
+        const auto& SliceFmtAttribs   = GetTextureFormatAttribs(pSlice->GetTextureDesc().Format);
+        if (SliceFmtAttribs.Format == UnifiedFormat)
+            continue;
+
+        if (SliceFmtAttribs.ComponentType == COMPONENT_TYPE_COMPRESSED ||
+            UnifiedFmtAttribs.ComponentType == COMPONENT_TYPE_COMPRESSED ||
+            SliceFmtAttribs.ComponentSize != UnifiedFmtAttribs.ComponentSize ||
+            GetNonSRGBComponentType(SliceFmtAttribs) != GetNonSRGBComponentType(UnifiedFmtAttribs))
+        {
+            return TEX_FORMAT_UNKNOWN;
+        }
+
+        if (SliceFmtAttribs.NumComponents > UnifiedFmtAttribs.NumComponents)
+            UnifiedFormat = SliceFmtAttribs.Format;
+    }
+    return UnifiedFormat;
+}
+
+static void CreateTextureArrayLoader(Uint32                           NumSlices,
+                                     RESOURCE_DIMENSION               Dimension,
+                                     const TextureLoadInfo&           TexLoadInfo,
+                                     IThreadPool*                     pThreadPool,
+                                     const CreateSliceLoaderFuncType& CreateSliceLoader,
+                                     ITextureLoader**                 ppLoader)
+{
+    if (Dimension != RESOURCE_DIM_TEX_2D_ARRAY && Dimension != RESOURCE_DIM_TEX_CUBE && Dimension != RESOURCE_DIM_TEX_CUBE_ARRAY)
+        LOG_ERROR_AND_THROW("Texture dimension must be RESOURCE_DIM_TEX_2D_ARRAY, RESOURCE_DIM_TEX_CUBE or RESOURCE_DIM_TEX_CUBE_ARRAY");
+    if (NumSlices == 0)
+        LOG_ERROR_AND_THROW("The number of slices must not be zero");
+    if (Dimension == RESOURCE_DIM_TEX_CUBE && NumSlices != 6)
+        LOG_ERROR_AND_THROW("A cubemap requires 6 slices, while ", NumSlices, " are provided");
+    if (Dimension == RESOURCE_DIM_TEX_CUBE_ARRAY && (NumSlices % 6) != 0)
+        LOG_ERROR_AND_THROW("The number of cubemap array slices (", NumSlices, ") must be a multiple of 6");
+
+    std::vector<RefCntAutoPtr<ITextureLoader>> Slices(NumSlices);
+    std::vector<TextureLoadInfo>               SliceLoadInfos(NumSlices, TexLoadInfo);
+    for (auto& SliceLoadInfo : SliceLoadInfos)
+    {
+        // Slices may be compacted to different formats with different component mappings
+        SliceLoadInfo.CompactFormat = False;
+    }
+
+    const auto LoadSlices = [&](const std::vector<Uint32>& SliceIds) {
+        const auto LoadSlice = [&](Uint32 Slice) {
+            Slices[Slice].Release();
+            CreateSliceLoader(Slice, SliceLoadInfos[Slice], &Slices[Slice]);
+        };
+
+        ParallelFor(pThreadPool, static_cast<Uint32>(SliceIds.size()), [&](Uint32 i) {
+            LoadSlice(SliceIds[i]);
+        });
+
+        for (auto Slice : SliceIds)
+        {
+            if (!Slices[Slice])
+                LOG_ERROR_AND_THROW("Failed to load slice ", Slice);
+
+            const auto& SliceDesc = Slices[Slice]->GetTextureDesc();
+            if (SliceDesc.Type != RESOURCE_DIM_TEX_2D || SliceDesc.ArraySize != 1)
+                LOG_ERROR_AND_THROW("Slice ", Slice, " is not a single 2D image");
+        }
+    };
+
+    std::vector<Uint32> SliceIds(NumSlices);
+    for (Uint32 Slice = 0; Slice < NumSlices; ++Slice)
+        SliceIds[Slice] = Slice;
+    LoadSlices(SliceIds);
+
+    // The texture size is the size of the smallest slice
+    Uint32 Width  = Slices[0]->GetTextureDesc().Width;
+    Uint32 Height = Slices[0]->GetTextureDesc().Height;
+    for (const auto& pSlice : Slices)
+    {
+        Width  = std::min(Width, pSlice->GetTextureDesc().Width);
+        Height = std::min(Height, pSlice->GetTextureDesc().Height);
+    }
+    if ((Dimension == RESOURCE_DIM_TEX_CUBE || Dimension == RESOURCE_DIM_TEX_CUBE_ARRAY) && Width != Height)
+        LOG_ERROR_AND_THROW("Cubemap faces must be square, while the face size is ", Width, "x", Height);
+
+    const auto Format = GetUnifiedSliceFormat(Slices);
+    if (Format == TEX_FORMAT_UNKNOWN)
+        LOG_ERROR_AND_THROW("Slice formats are not compatible");
+
+    Uint32 MipLevels = ComputeMipLevelsCount(Width, Height);
+    if (TexLoadInfo.MipLevels > 0)
+        MipLevels = std::min(MipLevels, TexLoadInfo.MipLevels);
+
+    // Reload the slices that need to be expanded to the unified format, and
+    // the larger slices whose mip chain was truncated by TexLoadInfo.MipLevels.
+    SliceIds.clear();
+    for (Uint32 Slice = 0; Slice < NumSlices; ++Slice)
+    {
+        const auto& SliceDesc = Slices[Slice]->GetTextureDesc();
+
+        const auto FirstMip = FindMipLevelWithSize(SliceDesc, Width, Height);
+        if (FirstMip == ~0u)
+        {
+            LOG_ERROR_AND_THROW("Size of slice ", Slice, " (", SliceDesc.Width, "x", SliceDesc.Height, ") does not match the texture size (",
+                                Width, "x", Height, ") at any mip level");
+        }
+
+        const bool ReloadFormat = SliceDesc.Format != Format;
+        const bool ReloadMips   = TexLoadInfo.MipLevels > 0 && FirstMip + MipLevels > SliceDesc.MipLevels;
+        if (ReloadFormat || ReloadMips)
+        {
+            if (ReloadFormat)
+                SliceLoadInfos[Slice].Format = Format;
+            if (ReloadMips)
+                SliceLoadInfos[Slice].MipLevels = FirstMip + MipLevels;
+            SliceIds.push_back(Slice);
+        }
+    }
+    LoadSlices(SliceIds);
+
+    for (Uint32 Slice = 0; Slice < NumSlices; ++Slice)
+    {
+        const auto& SliceDesc = Slices[Slice]->GetTextureDesc();
+        if (SliceDesc.Format != Format)
+        {
+            LOG_ERROR_AND_THROW("Failed to convert slice ", Slice, " from ", GetTextureFormatAttribs(SliceDesc.Format).Name,
+                                " to ", GetTextureFormatAttribs(Format).Name);
+        }
+
+        // Containers such as DDS may provide fewer mip levels than requested
+        const auto FirstMip = FindMipLevelWithSize(SliceDesc, Width, Height);
+        MipLevels           = std::min(MipLevels, SliceDesc.MipLevels > FirstMip ? SliceDesc.MipLevels - FirstMip : 0u);
+    }
+    if (MipLevels == 0)
+        LOG_ERROR_AND_THROW("Slices do not contain mip levels of size ", Width, "x", Height);
+
+    const std::string Name{TexLoadInfo.Name != nullptr ? TexLoadInfo.Name : ""};
+
+    auto TexDesc      = TexDescFromTexLoadInfo(TexLoadInfo, Name);
+    TexDesc.Type      = Dimension;
+    TexDesc.Width     = Width;
+    TexDesc.Height    = Height;
+    TexDesc.ArraySize = NumSlices;
+    TexDesc.MipLevels = MipLevels;
+    TexDesc.Format    = Format;
+
+    RefCntAutoPtr<ITextureLoader> pTexLoader{MakeNewRCObj<TextureLoaderImpl>()(TexDesc, std::move(Slices))};
+    if (pTexLoader)
+        pTexLoader->QueryInterface(IID_TextureLoader, reinterpret_cast<IObject**>(ppLoader));
+}
+
+void CreateTextureLoaderFromImages(Image* const*          ppSrcImages,
+                                   Uint32                 NumImages,
+                                   RESOURCE_DIMENSION     Dimension,
+                                   const TextureLoadInfo& TexLoadInfo,
+                                   IThreadPool*           pThreadPool,
+                                   ITextureLoader**       ppLoader)
+{
+    VERIFY_EXPR(ppSrcImages != nullptr || NumImages == 0);
+    try
+    {
+        CreateTextureArrayLoader(
+            NumImages, Dimension, TexLoadInfo, pThreadPool,
+            [ppSrcImages](Uint32 Slice, const TextureLoadInfo& SliceLoadInfo, ITextureLoader** ppSliceLoader) {
+                if (ppSrcImages[Slice] != nullptr)
+                    CreateTextureLoaderFromImage(ppSrcImages[Slice], SliceLoadInfo, ppSliceLoader);
+            },
+            ppLoader);
+    }
+    catch (std::runtime_error& err)
+    {
+        LOG_ERROR("Failed to create texture array loader from images: ", err.what());
+    }
+}
+
+void CreateTextureLoaderFromFiles(const char* const*     FilePaths,
+                                  Uint32                 NumFiles,
+                                  RESOURCE_DIMENSION     Dimension,
+                                  const TextureLoadInfo& TexLoadInfo,
+                                  IThreadPool*           pThreadPool,
+                                  ITextureLoader**       ppLoader)
+{
+    VERIFY_EXPR(FilePaths != nullptr || NumFiles == 0);
+    try
+    {
+        CreateTextureArrayLoader(
+            NumFiles, Dimension, TexLoadInfo, pThreadPool,
+            [FilePaths](Uint32 Slice, const TextureLoadInfo& SliceLoadInfo, ITextureLoader** ppSliceLoader) {
+                CreateTextureLoaderFromFile(FilePaths[Slice], IMAGE_FILE_FORMAT_UNKNOWN, SliceLoadInfo, ppSliceLoader);
+            },
+            ppLoader);
+    }
+    catch (std::runtime_error& err)
+    {
+        LOG_ERROR("Failed to create texture array loader from files: ", err.what());
+    }
+}
+
 } // namespace Diligent
 
 extern "C"
@@ -430,4 +1018,24 @@ extern "C"
     {
         Diligent::CreateTextureLoaderFromImage(pSrcImage, TexLoadInfo, ppLoader);
     }
+
+    void Diligent_CreateTextureLoaderFromImages(Diligent::Image* const*          ppSrcImages,
+                                                Diligent::Uint32                 NumImages,
+                                                Diligent::RESOURCE_DIMENSION     Dimension,
+                                                const Diligent::TextureLoadInfo& TexLoadInfo,
+                                                Diligent::IThreadPool*           pThreadPool,
+                                                Diligent::ITextureLoader**       ppLoader)
+    {
+        Diligent::CreateTextureLoaderFromImages(ppSrcImages, NumImages, Dimension, TexLoadInfo, pThreadPool, ppLoader);
+    }
+
+    void Diligent_CreateTextureLoaderFromFiles(const char* const*               FilePaths,
+                                               Diligent::Uint32                 NumFiles,
+                                               Diligent::RESOURCE_DIMENSION     Dimension,
+                                               const Diligent::TextureLoadInfo& TexLoadInfo,
+                                               Diligent::IThreadPool*           pThreadPool,
+                                               Diligent::ITextureLoader**       ppLoader)
+    {
+        Diligent::CreateTextureLoaderFromFiles(FilePaths, NumFiles, Dimension, TexLoadInfo, pThreadPool, ppLoader);
+    }
 }
@@ -28,13 +28,17 @@
 #include "TextureUtilities.h"
 
 #include <algorithm>
+#include <array>
 #include <vector>
 #include <limits>
+#include <cmath>
+#include <utility>
 
 #include "TextureLoader.h"
 #include "RefCntAutoPtr.hpp"
 #include "ColorConversion.h"
 #include "GraphicsAccessories.hpp"
+#include "ParallelFor.hpp"
 
 namespace Diligent
 {
@@ -408,6 +412,685 @@ void PremultiplyAlpha(const PremultiplyAlphaAttribs& Attribs)
     }
 }
 
+namespace
+{
+
+using AlphaHistogramType = std::array<Uint32, 256>;
+
+AlphaHistogramType ComputeAlphaHistogram(const AlphaCoverageAttribs& Attribs)
+{
+    AlphaHistogramType Histogram{};
+    for (Uint32 row = 0; row < Attribs.Height; ++row)
+    {
+        const auto* pAlpha = reinterpret_cast<const Uint8*>(Attribs.pPixels) + size_t{row} * Attribs.Stride + (Attribs.ComponentCount - 1);
+        for (Uint32 col = 0; col < Attribs.Width; ++col)
+            ++Histogram[pAlpha[size_t{col} * Attribs.ComponentCount]];
+    }
+    return Histogram;
+}
+
+inline Uint8 ScaleAlphaValue(Uint32 Alpha, float Scale)
+{
+    return static_cast<Uint8>(std::min(static_cast<float>(Alpha) * Scale + 0.5f, 255.f));
+}
+
+// Returns the number of pixels that pass the alpha test after alpha is scaled by AlphaScale.
+// Working with the histogram makes the cost of the scale search independent of the image size.
+Uint64 CountCoveredPixels(const AlphaHistogramType& Histogram, float AlphaCutoff, float AlphaScale)
+{
+    const auto Threshold = AlphaCutoff * 255.f;
+
+    Uint64 Count = 0;
+    for (Uint32 Alpha = 0; Alpha < Histogram.size(); ++Alpha)
+    {
+        if (static_cast<float>(ScaleAlphaValue(Alpha, AlphaScale)) >= Threshold)
+            Count += Histogram[Alpha];
+    }
+    return Count;
+}
+
+void VerifyAlphaCoverageAttribs(const AlphaCoverageAttribs& Attribs)
+{
+    DEV_CHECK_ERR(Attribs.Width > 0, "Width must not be zero");
+    DEV_CHECK_ERR(Attribs.Height > 0, "Height must not be zero");
+    DEV_CHECK_ERR(Attribs.ComponentCount > 0, "The number of components must not be zero");
+    DEV_CHECK_ERR(Attribs.ComponentType == VT_UINT8, "Only 8-bit components are currently supported");
+    DEV_CHECK_ERR(Attribs.pPixels != nullptr, "Pixels pointer must not be null");
+    DEV_CHECK_ERR(Attribs.Stride >= Attribs.Width * Attribs.ComponentCount || Attribs.Height == 1, "Stride is too small");
+    DEV_CHECK_ERR(Attribs.AlphaCutoff > 0 && Attribs.AlphaCutoff <= 1, "Alpha cutoff (", Attribs.AlphaCutoff, ") must be in (0, 1] range");
+}
+
+} // namespace
+
+float ComputeAlphaCoverage(const AlphaCoverageAttribs& Attribs)
+{
+    VerifyAlphaCoverageAttribs(Attribs);
+    if (Attribs.ComponentType != VT_UINT8)
+        return 0;
+
+    const auto Histogram = ComputeAlphaHistogram(Attribs);
+    const auto NumPixels = Uint64{Attribs.Width} * Uint64{Attribs.Height};
+    return static_cast<float>(CountCoveredPixels(Histogram, Attribs.AlphaCutoff, 1.f)) / static_cast<float>(NumPixels);
+}
+
+float ScaleAlphaToCoverage(const AlphaCoverageAttribs& Attribs, float TargetCoverage)
+{
+    VerifyAlphaCoverageAttribs(Attribs);
+    if (Attribs.ComponentType != VT_UINT8)
+        return 1;
+
+    const auto Histogram   = ComputeAlphaHistogram(Attribs);
+    const auto NumPixels   = Uint64{Attribs.Width} * Uint64{Attribs.Height};
+    const auto TargetCount = static_cast<Uint64>(std::max(std::min(TargetCoverage, 1.f), 0.f) * static_cast<float>(NumPixels) + 0.5f);
+
+    const auto GetCountDiff = [TargetCount](Uint64 Count) {
+        return Count > TargetCount ? Count - TargetCount : TargetCount - Count;
+    };
+
+    float  BestScale = 1;
+    Uint64 BestDiff  = GetCountDiff(CountCoveredPixels(Histogram, Attribs.AlphaCutoff, BestScale));
+
+    // Coverage is a non-decreasing function of the scale, so use bisection.
+    // Scale of 256 maps any non-zero alpha to 255, so the range covers all attainable coverage values.
+    float MinScale = 0;
+    float MaxScale = 256;
+    for (Uint32 i = 0; i < 24 && BestDiff != 0; ++i)
+    {
+        const auto Scale = (MinScale + MaxScale) * 0.5f;
+        const auto Count = CountCoveredPixels(Histogram, Attribs.AlphaCutoff, Scale);
+        const auto Diff  = GetCountDiff(Count);
+        if (Diff < BestDiff || (Diff == BestDiff && std::abs(Scale - 1.f) < std::abs(BestScale - 1.f)))
+        {
+            BestScale = Scale;
+            BestDiff  = Diff;
+        }
+
+        if (Count < TargetCount)
+            MinScale = Scale;
+        else
+            MaxScale = Scale;
+    }
+
+    if (BestScale == 1)
+        return BestScale;
+
+    std::array<Uint8, 256> ScaledAlpha;
+    for (Uint32 Alpha = 0; Alpha < ScaledAlpha.size(); ++Alpha)
+        ScaledAlpha[Alpha] = ScaleAlphaValue(Alpha, BestScale);
+
+    for (Uint32 row = 0; row < Attribs.Height; ++row)
+    {
+        auto* pAlpha = reinterpret_cast<Uint8*>(Attribs.pPixels) + size_t{row} * Attribs.Stride + (Attribs.ComponentCount - 1);
+        for (Uint32 col = 0; col < Attribs.Width; ++col)
+        {
+            auto& Alpha = pAlpha[size_t{col} * Attribs.ComponentCount];
+            Alpha       = ScaledAlpha[Alpha];
+        }
+    }
+
+    return BestScale;
+}
+
+namespace
+{
+
+inline float DecodeNormalComponent(Uint8 Value)
+{
+    return static_cast<float>(Value) * (2.f / 255.f) - 1.f;
+}
+
+inline Uint8 EncodeNormalComponent(float Value)
+{
+    return static_cast<Uint8>(std::min(std::max(Value * 0.5f + 0.5f, 0.f), 1.f) * 255.f + 0.5f);
+}
+
+// Normalizes the vector or sets it to (0, 0, 1) if the vector is degenerate.
+inline void NormalizeNormal(float N[3])
+{
+    const auto Len = std::sqrt(N[0] * N[0] + N[1] * N[1] + N[2] * N[2]);
+    if (Len > 1e-6f)
+    {
+        N[0] /= Len;
+        N[1] /= Len;
+        N[2] /= Len;
+    }
+    else
+    {
+        N[0] = 0;
+        N[1] = 0;
+        N[2] = 1;
+    }
+}
+
+// Decodes the 8-bit normal and normalizes it. 8-bit quantization does not
+// preserve the length, so the normal must be normalized before it is averaged.
+inline void ReadUnitNormal(const Uint8* pPixel, Uint32 ComponentCount, float N[3])
+{
+    N[0] = DecodeNormalComponent(pPixel[0]);
+    N[1] = DecodeNormalComponent(pPixel[1]);
+    N[2] = ComponentCount >= 3 ?
+        DecodeNormalComponent(pPixel[2]) :
+        std::sqrt(std::max(1.f - N[0] * N[0] - N[1] * N[1], 0.f));
+    NormalizeNormal(N);
+}
+
+} // namespace
+
+void ComputeNormalMapMipLevel(const NormalMapMipLevelAttribs& Attribs)
+{
+    DEV_CHECK_ERR(Attribs.FineMipWidth > 0, "Fine mip width must not be zero");
+    DEV_CHECK_ERR(Attribs.FineMipHeight > 0, "Fine mip height must not be zero");
+    DEV_CHECK_ERR(Attribs.ComponentCount >= 2 && Attribs.ComponentCount <= 4, "The number of components (", Attribs.ComponentCount, ") must be 2, 3 or 4");
+    DEV_CHECK_ERR(Attribs.pFineMipData != nullptr, "Fine mip data pointer must not be null");
+    DEV_CHECK_ERR(Attribs.pCoarseMipData != nullptr, "Coarse mip data pointer must not be null");
+    DEV_CHECK_ERR(Attribs.FineMipStride >= Attribs.FineMipWidth * Attribs.ComponentCount || Attribs.FineMipHeight == 1, "Fine mip stride is too small");
+
+    const auto NumComps     = Attribs.ComponentCount;
+    const auto CoarseWidth  = std::max(Attribs.FineMipWidth / 2u, 1u);
+    const auto CoarseHeight = std::max(Attribs.FineMipHeight / 2u, 1u);
+    DEV_CHECK_ERR(Attribs.CoarseMipStride >= CoarseWidth * NumComps || CoarseHeight == 1, "Coarse mip stride is too small");
+
+    const auto* pFineData = reinterpret_cast<const Uint8*>(Attribs.pFineMipData);
+    for (Uint32 row = 0; row < CoarseHeight; ++row)
+    {
+        const Uint8* pFineRows[] = {
+            pFineData + size_t{std::min(row * 2u + 0u, Attribs.FineMipHeight - 1u)} * Attribs.FineMipStride,
+            pFineData + size_t{std::min(row * 2u + 1u, Attribs.FineMipHeight - 1u)} * Attribs.FineMipStride,
+        };
+        auto* pDstRow = reinterpret_cast<Uint8*>(Attribs.pCoarseMipData) + size_t{row} * Attribs.CoarseMipStride;
+        for (Uint32 col = 0; col < CoarseWidth; ++col)
+        {
+            const size_t FineCols[] = {
+                size_t{std::min(col * 2u + 0u, Attribs.FineMipWidth - 1u)} * NumComps,
+                size_t{std::min(col * 2u + 1u, Attribs.FineMipWidth - 1u)} * NumComps,
+            };
+
+            float  Sum[3]   = {};
+            Uint32 AlphaSum = 0;
+            for (const auto* pFineRow : pFineRows)
+            {
+                for (const auto FineCol : FineCols)
+                {
+                    const auto* pSrc = pFineRow + FineCol;
+
+                    float N[3];
+                    ReadUnitNormal(pSrc, NumComps, N);
+                    Sum[0] += N[0];
+                    Sum[1] += N[1];
+                    Sum[2] += N[2];
+                    if (NumComps == 4)
+                        AlphaSum += pSrc[3];
+                }
+            }
+            NormalizeNormal(Sum);
+
+            auto* pDst = pDstRow + size_t{col} * NumComps;
+            pDst[0]    = EncodeNormalComponent(Sum[0]);
+            pDst[1]    = EncodeNormalComponent(Sum[1]);
+            if (NumComps >= 3)
+                pDst[2] = EncodeNormalComponent(Sum[2]);
+            if (NumComps == 4)
+                pDst[3] = static_cast<Uint8>((AlphaSum + 2u) / 4u);
+        }
+    }
+}
+
+void AddNormalVarianceToRoughness(const NormalVarianceToRoughnessAttribs& Attribs)
+{
+    DEV_CHECK_ERR(Attribs.NormalMapWidth > 0, "Normal map width must not be zero");
+    DEV_CHECK_ERR(Attribs.NormalMapHeight > 0, "Normal map height must not be zero");
+    DEV_CHECK_ERR(Attribs.NormalMapComponentCount >= 2 && Attribs.NormalMapComponentCount <= 4, "The number of normal map components (", Attribs.NormalMapComponentCount, ") must be 2, 3 or 4");
+    DEV_CHECK_ERR(Attribs.pNormalMapPixels != nullptr, "Normal map pixels pointer must not be null");
+    DEV_CHECK_ERR(Attribs.NormalMapStride >= Attribs.NormalMapWidth * Attribs.NormalMapComponentCount || Attribs.NormalMapHeight == 1, "Normal map stride is too small");
+    DEV_CHECK_ERR(Attribs.Width > 0, "Width must not be zero");
+    DEV_CHECK_ERR(Attribs.Height > 0, "Height must not be zero");
+    DEV_CHECK_ERR(Attribs.RoughnessComponent < Attribs.ComponentCount, "Roughness component (", Attribs.RoughnessComponent, ") must be less than the number of components (", Attribs.ComponentCount, ")");
+    DEV_CHECK_ERR(Attribs.pPixels != nullptr, "Pixels pointer must not be null");
+    DEV_CHECK_ERR(Attribs.Stride >= Attribs.Width * Attribs.ComponentCount || Attribs.Height == 1, "Stride is too small");
+
+    const auto NormalNumComps = Attribs.NormalMapComponentCount;
+    const auto NormalWidth    = Uint64{Attribs.NormalMapWidth};
+    const auto NormalHeight   = Uint64{Attribs.NormalMapHeight};
+
+    // Returns the [Start, End) range of normal map texels covered by the roughness texel.
+    const auto GetFootprint = [](Uint32 Idx, Uint64 Size, Uint64 NormalSize) {
+        const auto Start = std::min(Idx * NormalSize / Size, NormalSize - 1);
+        const auto End   = std::min(std::max((Idx + 1) * NormalSize / Size, Start + 1), NormalSize);
+        return std::make_pair(static_cast<Uint32>(Start), static_cast<Uint32>(End));
+    };
+
+    const auto* pNormals = reinterpret_cast<const Uint8*>(Attribs.pNormalMapPixels);
+    for (Uint32 row = 0; row < Attribs.Height; ++row)
+    {
+        const auto RowFootprint = GetFootprint(row, Attribs.Height, NormalHeight);
+
+        auto* pDstRow = reinterpret_cast<Uint8*>(Attribs.pPixels) + size_t{row} * Attribs.Stride;
+        for (Uint32 col = 0; col < Attribs.Width; ++col)
+        {
+            const auto ColFootprint = GetFootprint(col, Attribs.Width, NormalWidth);
+
+            const auto NumNormals = (RowFootprint.second - RowFootprint.first) * (ColFootprint.second - ColFootprint.first);
+            if (NumNormals <= 1)
+                continue;
+
+            float Sum[3] = {};
+            for (Uint32 y = RowFootprint.first; y < RowFootprint.second; ++y)
+            {
+                const auto* pNormalRow = pNormals + size_t{y} * Attribs.NormalMapStride;
+                for (Uint32 x = ColFootprint.first; x < ColFootprint.second; ++x)
+                {
+                    float N[3];
+                    ReadUnitNormal(pNormalRow + size_t{x} * NormalNumComps, NormalNumComps, N);
+                    Sum[0] += N[0];
+                    Sum[1] += N[1];
+                    Sum[2] += N[2];
+                }
+            }
+
+            const auto AvgLen   = std::sqrt(Sum[0] * Sum[0] + Sum[1] * Sum[1] + Sum[2] * Sum[2]) / static_cast<float>(NumNormals);
+            const auto Variance = std::max(1.f - AvgLen, 0.f) / std::max(AvgLen, 1e-4f);
+
+            auto&      Roughness = pDstRow[size_t{col} * Attribs.ComponentCount + Attribs.RoughnessComponent];
+            const auto Alpha     = static_cast<float>(Roughness) / 255.f * static_cast<float>(Roughness) / 255.f;
+            const auto Alpha2    = std::min(Alpha * Alpha + 2.f * Variance, 1.f);
+            // Roughness = sqrt(Alpha) = Alpha2^(1/4). Never decrease the roughness due to rounding.
+            const auto NewRoughness = static_cast<Uint32>(std::sqrt(std::sqrt(Alpha2)) * 255.f + 0.5f);
+            Roughness               = static_cast<Uint8>(std::max(Uint32{Roughness}, std::min(NewRoughness, 255u)));
+        }
+    }
+}
+
+namespace
+{
+
+template <typename CompType>
+struct ImageContentStats
+{
+    CompType Min[4];
+    CompType Max[4];
+    bool     NotGrayscale   = false;
+    bool     NonBinaryAlpha = false;
+
+    ImageContentStats()
+    {
+        for (Uint32 c = 0; c < 4; ++c)
+        {
+            Min[c] = std::numeric_limits<CompType>::max();
+            Max[c] = std::numeric_limits<CompType>::lowest();
+        }
+    }
+
+    void Merge(const ImageContentStats& Other)
+    {
+        for (Uint32 c = 0; c < 4; ++c)
+        {
+            Min[c] = std::min(Min[c], Other.Min[c]);
+            Max[c] = std::max(Max[c], Other.Max[c]);
+        }
+        NotGrayscale   = NotGrayscale || Other.NotGrayscale;
+        NonBinaryAlpha = NonBinaryAlpha || Other.NonBinaryAlpha;
+    }
+};
+
+template <typename CompType>
+constexpr CompType GetComponentOne()
+{
+    return std::numeric_limits<CompType>::max();
+}
+
+template <>
+constexpr float GetComponentOne<float>()
+{
+    return 1.f;
+}
+
+template <typename CompType>
+float NormalizeComponent(CompType Val)
+{
+    return static_cast<float>(Val) / static_cast<float>(GetComponentOne<CompType>());
+}
+
+// The number of components is a template parameter so that the inner loop is fully
+// unrolled and branch-free, which allows the compiler to vectorize it.
+template <typename CompType, Uint32 NumComps>
+void AnalyzeImageRows(const ImageContentAnalysisAttribs& Attribs, Uint32 StartRow, Uint32 EndRow, ImageContentStats<CompType>& Stats)
+{
+    constexpr CompType One = GetComponentOne<CompType>();
+
+    CompType Min[NumComps];
+    CompType Max[NumComps];
+    for (Uint32 c = 0; c < NumComps; ++c)
+    {
+        Min[c] = Stats.Min[c];
+        Max[c] = Stats.Max[c];
+    }
+
+    int NotGrayscale   = 0;
+    int NonBinaryAlpha = 0;
+    for (Uint32 row = StartRow; row < EndRow; ++row)
+    {
+        const auto* pRow = reinterpret_cast<const CompType*>(static_cast<const Uint8*>(Attribs.pPixels) + size_t{row} * Attribs.Stride);
+        for (size_t col = 0; col < Attribs.Width; ++col)
+        {
+            const auto* pPixel = pRow + col * NumComps;
+            for (Uint32 c = 0; c < NumComps; ++c)
+            {
+                Min[c] = std::min(Min[c], pPixel[c]);
+                Max[c] = std::max(Max[c], pPixel[c]);
+            }
+            if (NumComps >= 3)
+                NotGrayscale |= static_cast<int>(pPixel[0] != pPixel[1]) | static_cast<int>(pPixel[0] != pPixel[2]);
+            if (NumComps == 4)
+                NonBinaryAlpha |= static_cast<int>(pPixel[NumComps - 1] != CompType{0}) & static_cast<int>(pPixel[NumComps - 1] != One);
+        }
+    }
+
+    for (Uint32 c = 0; c < NumComps; ++c)
+    {
+        Stats.Min[c] = Min[c];
+        Stats.Max[c] = Max[c];
+    }
+    Stats.NotGrayscale   = Stats.NotGrayscale || NotGrayscale != 0;
+    Stats.NonBinaryAlpha = Stats.NonBinaryAlpha || NonBinaryAlpha != 0;
+}
+
+template <typename CompType, Uint32 NumComps>
+ImageContentInfo AnalyzeImageContentImpl(const ImageContentAnalysisAttribs& Attribs)
+{
+    // Every band is analyzed independently, and the results are merged
+    constexpr Uint32 RowsPerBand = 64;
+
+    const Uint32 NumBands = (Attribs.Height + RowsPerBand - 1) / RowsPerBand;
+
+    std::vector<ImageContentStats<CompType>> BandStats(NumBands);
+    const auto AnalyzeBand = [&](Uint32 Band) {
+        AnalyzeImageRows<CompType, NumComps>(Attribs, Band * RowsPerBand, std::min((Band + 1) * RowsPerBand, Attribs.Height), BandStats[Band]);
+    };
+
+    ParallelFor(Attribs.pThreadPool, NumBands, AnalyzeBand);
+
+    ImageContentStats<CompType> Stats;
+    for (const auto& Band : BandStats)
+        Stats.Merge(Band);
+
+    ImageContentInfo Info;
+    Info.NumComponents = NumComps;
+    for (Uint32 c = 0; c < NumComps; ++c)
+    {
+        if (Stats.Min[c] == Stats.Max[c])
+            Info.ConstantComponents |= 1u << c;
+        Info.MinValues[c] = NormalizeComponent(Stats.Min[c]);
+        Info.MaxValues[c] = NormalizeComponent(Stats.Max[c]);
+    }
+
+    constexpr CompType One = GetComponentOne<CompType>();
+
+    Info.IsGrayscale    = NumComps >= 3 && !Stats.NotGrayscale;
+    Info.IsOpaque       = NumComps < 4 || (Stats.Min[3] == One && Stats.Max[3] == One);
+    Info.HasBinaryAlpha = NumComps < 4 || !Stats.NonBinaryAlpha;
+    return Info;
+}
+
+template <typename CompType>
+ImageContentInfo AnalyzeImageContentImpl(const ImageContentAnalysisAttribs& Attribs)
+{
+    switch (Attribs.ComponentCount)
+    {
+        case 1: return AnalyzeImageContentImpl<CompType, 1>(Attribs);
+        case 2: return AnalyzeImageContentImpl<CompType, 2>(Attribs);
+        case 3: return AnalyzeImageContentImpl<CompType, 3>(Attribs);
+        case 4: return AnalyzeImageContentImpl<CompType, 4>(Attribs);
+        default:
+            UNEXPECTED("Unexpected component count (", Attribs.ComponentCount, ")");
+            return ImageContentInfo{};
+    }
+}
+
+} // namespace
+
+ImageContentInfo AnalyzeImageContent(const ImageContentAnalysisAttribs& Attribs)
+{
+    DEV_CHECK_ERR(Attribs.Width > 0, "Width must not be zero");
+    DEV_CHECK_ERR(Attribs.Height > 0, "Height must not be zero");
+    DEV_CHECK_ERR(Attribs.pPixels != nullptr, "Pixels pointer must not be null");
+    DEV_CHECK_ERR(Attribs.ComponentCount >= 1 && Attribs.ComponentCount <= 4, "The number of components (", Attribs.ComponentCount, ") must be between 1 and 4");
+    DEV_CHECK_ERR(Attribs.Stride >= Attribs.Width * Attribs.ComponentCount * GetValueSize(Attribs.ComponentType) || Attribs.Height == 1, "Stride is too small");
+
+    switch (Attribs.ComponentType)
+    {
+        case VT_UINT8: return AnalyzeImageContentImpl<Uint8>(Attribs);
+        case VT_UINT16: return AnalyzeImageContentImpl<Uint16>(Attribs);
+        case VT_FLOAT32: return AnalyzeImageContentImpl<float>(Attribs);
+        default:
+            UNEXPECTED("Unsupported component type ", GetValueTypeString(Attribs.ComponentType));
+            return ImageContentInfo{};
+    }
+}
+
+namespace
+{
+
+// Squared distance of the texels that are not the transform seeds
+constexpr float DistanceTransformInf = 1e20f;
+
+// Computes the one-dimensional squared Euclidean distance transform of the sampled function
+// as the lower envelope of parabolas rooted at (q, F(q)), see
+// P. Felzenszwalb, D. Huttenlocher - Distance Transforms of Sampled Functions (2012).
+class DistanceTransform1D
+{
+public:
+    explicit DistanceTransform1D(Uint32 MaxSize) :
+        m_F(MaxSize),
+        m_V(MaxSize),
+        m_Z(size_t{MaxSize} + 1)
+    {}
+
+    // Transforms N values located Stride floats apart in place
+    void Execute(float* pData, Uint32 N, size_t Stride)
+    {
+        for (Uint32 q = 0; q < N; ++q)
+            m_F[q] = pData[q * Stride];
+
+        // Compute the lower envelope
+        Uint32 k = 0;
+        m_V[0]   = 0;
+        m_Z[0]   = -std::numeric_limits<double>::infinity();
+        m_Z[1]   = +std::numeric_limits<double>::infinity();
+        for (Uint32 q = 1; q < N; ++q)
+        {
+            double s = Intersect(m_V[k], q);
+            while (s <= m_Z[k])
+            {
+                --k;
+                s = Intersect(m_V[k], q);
+            }
+            ++k;
+            m_V[k]     = q;
+            m_Z[k]     = s;
+            m_Z[k + 1] = +std::numeric_limits<double>::infinity();
+        }
+
+        // Fill in the values of the distance transform
+        k = 0;
+        for (Uint32 q = 0; q < N; ++q)
+        {
+            while (m_Z[k + 1] < q)
+                ++k;
+            const double d    = static_cast<double>(q) - m_V[k];
+            pData[q * Stride] = static_cast<float>(d * d + m_F[m_V[k]]);
+        }
+    }
+
+private:
+    // Horizontal coordinate of the intersection of the parabolas rooted at p and q
+    double Intersect(Uint32 p, Uint32 q) const
+    {
+        const double dp = p;
+        const double dq = q;
+        return ((m_F[q] + dq * dq) - (m_F[p] + dp * dp)) / (2.0 * (dq - dp));
+    }
+
+    std::vector<double> m_F;
+    std::vector<Uint32> m_V;
+    std::vector<double> m_Z;
+};
+
+template <typename CompType>
+void InitDistanceTransform(const DistanceFieldAttribs& Attribs, Uint32 Component, Uint32 Row, float* pToOutside, float* pToInside)
+{
+    const auto* pSrcRow = reinterpret_cast<const CompType*>(static_cast<const Uint8*>(Attribs.pSrcPixels) + size_t{Row} * Attribs.SrcStride);
+    for (Uint32 x = 0; x < Attribs.SrcWidth; ++x)
+    {
+        const bool IsInside = NormalizeComponent(pSrcRow[size_t{x} * Attribs.SrcComponentCount + Component]) >= Attribs.Threshold;
+        // Outside texels are the seeds of the transform that computes the distance to the nearest
+        // outside texel, and vice versa.
+        pToOutside[x] = IsInside ? DistanceTransformInf : 0;
+        pToInside[x]  = IsInside ? 0 : DistanceTransformInf;
+    }
+}
+
+template <typename CompType>
+void WriteDistance(float Distance, float Spread, void* pDst)
+{
+    const float Value = std::min(std::max(0.5f + Distance / (2.f * Spread), 0.f), 1.f);
+    *static_cast<CompType*>(pDst) = static_cast<CompType>(Value * static_cast<float>(GetComponentOne<CompType>()) + 0.5f);
+}
+
+template <>
+void WriteDistance<float>(float Distance, float Spread, void* pDst)
+{
+    *static_cast<float*>(pDst) = Distance;
+}
+
+} // namespace
+
+void ComputeDistanceField(const DistanceFieldAttribs& Attribs)
+{
+    DEV_CHECK_ERR(Attribs.SrcWidth > 0 && Attribs.SrcHeight > 0, "Source size must not be zero");
+    DEV_CHECK_ERR(Attribs.DstWidth > 0 && Attribs.DstHeight > 0, "Destination size must not be zero");
+    DEV_CHECK_ERR(Attribs.pSrcPixels != nullptr, "Source pixels pointer must not be null");
+    DEV_CHECK_ERR(Attribs.pDstPixels != nullptr, "Destination pixels pointer must not be null");
+    DEV_CHECK_ERR(Attribs.SrcComponentCount >= 1 && Attribs.SrcComponentCount <= 4, "The number of source components (", Attribs.SrcComponentCount, ") must be between 1 and 4");
+    DEV_CHECK_ERR(Attribs.NumChannels >= 1 && Attribs.FirstComponent + Attribs.NumChannels <= Attribs.SrcComponentCount,
+                  "Components ", Attribs.FirstComponent, " to ", Attribs.FirstComponent + Attribs.NumChannels, " are out of range");
+    DEV_CHECK_ERR(Attribs.SrcStride >= Attribs.SrcWidth * Attribs.SrcComponentCount * GetValueSize(Attribs.SrcComponentType) || Attribs.SrcHeight == 1, "Source stride is too small");
+    DEV_CHECK_ERR(Attribs.DstStride >= Attribs.DstWidth * Attribs.NumChannels * GetValueSize(Attribs.DstComponentType) || Attribs.DstHeight == 1, "Destination stride is too small");
+    DEV_CHECK_ERR(Attribs.Spread > 0, "Spread must be positive");
+
+    const Uint32 SrcWidth  = Attribs.SrcWidth;
+    const Uint32 SrcHeight = Attribs.SrcHeight;
+    const size_t NumTexels = size_t{SrcWidth} * SrcHeight;
+
+    // Rows and columns are processed in bands, and every band uses its own transform buffers
+    constexpr Uint32 LinesPerBand   = 64;
+    const Uint32     NumRowBands    = (SrcHeight + LinesPerBand - 1) / LinesPerBand;
+    const Uint32     NumColumnBands = (SrcWidth + LinesPerBand - 1) / LinesPerBand;
+    const Uint32     NumDstBands    = (Attribs.DstHeight + LinesPerBand - 1) / LinesPerBand;
+
+    // Squared distances to the nearest outside texel for inside texels, and vice versa
+    std::vector<float> ToOutside(NumTexels);
+    std::vector<float> ToInside(NumTexels);
+    // Signed distance to the edge in source texels, positive inside
+    std::vector<float> Distance(NumTexels);
+
+    // Source distances are clamped to avoid overflows in destination values
+    const float MaxDistance = static_cast<float>(SrcWidth) + static_cast<float>(SrcHeight);
+
+    const float ScaleX = static_cast<float>(SrcWidth) / static_cast<float>(Attribs.DstWidth);
+    const float ScaleY = static_cast<float>(SrcHeight) / static_cast<float>(Attribs.DstHeight);
+    // Source to destination distance scale
+    const float DistanceScale = 1.f / std::sqrt(ScaleX * ScaleY);
+
+    const Uint32 DstCompSize = GetValueSize(Attribs.DstComponentType);
+
+    for (Uint32 Channel = 0; Channel < Attribs.NumChannels; ++Channel)
+    {
+        const Uint32 Component = Attribs.FirstComponent + Channel;
+
+        // Initialize the transform seeds from the thresholded mask
+        ParallelFor(Attribs.pThreadPool, NumRowBands, [&](Uint32 Band) {
+            for (Uint32 y = Band * LinesPerBand; y < std::min((Band + 1) * LinesPerBand, SrcHeight); ++y)
+            {
+                auto* pToOutside = &ToOutside[size_t{y} * SrcWidth];
+                auto* pToInside  = &ToInside[size_t{y} * SrcWidth];
+                switch (Attribs.SrcComponentType)
+                {
+                    case VT_UINT8: InitDistanceTransform<Uint8>(Attribs, Component, y, pToOutside, pToInside); break;
+                    case VT_UINT16: InitDistanceTransform<Uint16>(Attribs, Component, y, pToOutside, pToInside); break;
+                    case VT_FLOAT32: InitDistanceTransform<float>(Attribs, Component, y, pToOutside, pToInside); break;
+                    default:
+                        UNEXPECTED("Unsupported source component type ", GetValueTypeString(Attribs.SrcComponentType));
+                }
+            }
+        });
+
+        // Transform the columns
+        ParallelFor(Attribs.pThreadPool, NumColumnBands, [&](Uint32 Band) {
+            DistanceTransform1D Transform{SrcHeight};
+            for (Uint32 x = Band * LinesPerBand; x < std::min((Band + 1) * LinesPerBand, SrcWidth); ++x)
+            {
+                Transform.Execute(&ToOutside[x], SrcHeight, SrcWidth);
+                Transform.Execute(&ToInside[x], SrcHeight, SrcWidth);
+            }
+        });
+
+        // Transform the rows and compute the signed distances. The edge lies halfway
+        // between the texel centers, so the distance to it is half a texel shorter.
+        ParallelFor(Attribs.pThreadPool, NumRowBands, [&](Uint32 Band) {
+            DistanceTransform1D Transform{SrcWidth};
+            for (Uint32 y = Band * LinesPerBand; y < std::min((Band + 1) * LinesPerBand, SrcHeight); ++y)
+            {
+                const size_t RowStart = size_t{y} * SrcWidth;
+                Transform.Execute(&ToOutside[RowStart], SrcWidth, 1);
+                Transform.Execute(&ToInside[RowStart], SrcWidth, 1);
+                for (size_t i = RowStart; i < RowStart + SrcWidth; ++i)
+                {
+                    Distance[i] = ToOutside[i] > 0 ?
+                        std::min(std::sqrt(ToOutside[i]), MaxDistance) - 0.5f :
+                        0.5f - std::min(std::sqrt(ToInside[i]), MaxDistance);
+                }
+            }
+        });
+
+        // Resample the distance field to the destination resolution
+        ParallelFor(Attribs.pThreadPool, NumDstBands, [&](Uint32 Band) {
+            for (Uint32 y = Band * LinesPerBand; y < std::min((Band + 1) * LinesPerBand, Attribs.DstHeight); ++y)
+            {
+                const float  SrcY = std::min(std::max((static_cast<float>(y) + 0.5f) * ScaleY - 0.5f, 0.f), static_cast<float>(SrcHeight - 1));
+                const Uint32 Y0   = static_cast<Uint32>(SrcY);
+                const Uint32 Y1   = std::min(Y0 + 1, SrcHeight - 1);
+                const float  FY   = SrcY - static_cast<float>(Y0);
+
+                auto* pDstRow = static_cast<Uint8*>(Attribs.pDstPixels) + size_t{y} * Attribs.DstStride;
+                for (Uint32 x = 0; x < Attribs.DstWidth; ++x)
+                {
+                    const float  SrcX = std::min(std::max((static_cast<float>(x) + 0.5f) * ScaleX - 0.5f, 0.f), static_cast<float>(SrcWidth - 1));
+                    const Uint32 X0   = static_cast<Uint32>(SrcX);
+                    const Uint32 X1   = std::min(X0 + 1, SrcWidth - 1);
+                    const float  FX   = SrcX - static_cast<float>(X0);
+
+                    const float D00 = Distance[size_t{Y0} * SrcWidth + X0];
+                    const float D10 = Distance[size_t{Y0} * SrcWidth + X1];
+                    const float D01 = Distance[size_t{Y1} * SrcWidth + X0];
+                    const float D11 = Distance[size_t{Y1} * SrcWidth + X1];
+
+                    const float D = ((D00 * (1 - FX) + D10 * FX) * (1 - FY) + (D01 * (1 - FX) + D11 * FX) * FY) * DistanceScale;
+
+                    auto* pDst = pDstRow + (size_t{x} * Attribs.NumChannels + Channel) * DstCompSize;
+                    switch (Attribs.DstComponentType)
+                    {
+                        case VT_UINT8: WriteDistance<Uint8>(D, Attribs.Spread, pDst); break;
+                        case VT_UINT16: WriteDistance<Uint16>(D, Attribs.Spread, pDst); break;
+                        case VT_FLOAT32: WriteDistance<float>(D, Attribs.Spread, pDst); break;
+                        default:
+                            UNEXPECTED("Unsupported destination component type ", GetValueTypeString(Attribs.DstComponentType));
+                    }
+                }
+            }
+        });
+    }
+}
+
 void CreateTextureFromFile(const Char*            FilePath,
                            const TextureLoadInfo& TexLoadInfo,
                            IRenderDevice*         pDevice,
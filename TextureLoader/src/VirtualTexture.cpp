@@ -0,0 +1,462 @@
+/*
+ *  Copyright 2019-2024 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "VirtualTexture.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include "zlib.h"
+
+#include "Image.h"
+#include "TextureUtilities.h"
+#include "GraphicsAccessories.hpp"
+#include "GraphicsUtilities.h"
+#include "DataBlobImpl.hpp"
+#include "Align.hpp"
+#include "ParallelFor.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+// Offsets of the page file tables
+struct VirtualTextureLayout
+{
+    size_t MipLevelsOffset = 0;
+    size_t PageTableOffset = 0;
+    size_t PagesOffset     = 0;
+    size_t DataOffset      = 0;
+
+    explicit VirtualTextureLayout(const VirtualTextureHeader& Header)
+    {
+        MipLevelsOffset = sizeof(VirtualTextureHeader);
+        PageTableOffset = MipLevelsOffset + sizeof(VirtualTextureMipLevel) * Header.MipLevels;
+        PagesOffset     = AlignUp(PageTableOffset + sizeof(Uint32) * Header.NumTiles, size_t{8});
+        DataOffset      = PagesOffset + sizeof(VirtualTexturePageEntry) * Header.NumPages;
+    }
+};
+
+// Reads the page file header and validates that the table data contains all tables.
+bool ReadVirtualTextureHeader(const void* pTableData, size_t TableDataSize, VirtualTextureHeader& Header)
+{
+    if (pTableData == nullptr || TableDataSize < sizeof(VirtualTextureHeader))
+        return false;
+
+    memcpy(&Header, pTableData, sizeof(Header));
+    if (Header.Magic != DILIGENT_VIRTUAL_TEXTURE_MAGIC || Header.Version != DILIGENT_VIRTUAL_TEXTURE_VERSION)
+        return false;
+
+    const VirtualTextureLayout Layout{Header};
+    return TableDataSize >= Layout.DataOffset;
+}
+
+Uint32 GetFullPageSize(const VirtualTextureHeader& Header)
+{
+    return Header.PageSize + Header.BorderSize * 2;
+}
+
+size_t GetPageDataSize(const VirtualTextureHeader& Header)
+{
+    const size_t FullPageSize = GetFullPageSize(Header);
+    return FullPageSize * FullPageSize * GetTextureFormatAttribs(static_cast<TEXTURE_FORMAT>(Header.Format)).GetElementSize();
+}
+
+struct MipLevelTexels
+{
+    Uint32             Width  = 0;
+    Uint32             Height = 0;
+    std::vector<Uint8> Texels; // Tightly packed rows
+};
+
+struct TileData
+{
+    std::vector<Uint8>         Data;
+    VIRTUAL_TEXTURE_PAGE_FLAGS Flags = VIRTUAL_TEXTURE_PAGE_FLAG_NONE;
+};
+
+// Copies the tile with its borders from the level. Texels outside of the level are clamped to the edge.
+void CutTile(const MipLevelTexels& Level, Uint32 TileX, Uint32 TileY, Uint32 PageSize, Uint32 BorderSize, Uint32 TexelSize, Uint8* pDst)
+{
+    const Uint32 FullPageSize = PageSize + BorderSize * 2;
+
+    const Int64 X0 = Int64{TileX} * PageSize - BorderSize;
+    const Int64 Y0 = Int64{TileY} * PageSize - BorderSize;
+
+    // The range of columns that are inside the level
+    const Uint32 FirstCol = static_cast<Uint32>(std::min(std::max(-X0, Int64{0}), Int64{FullPageSize}));
+    const Uint32 EndCol   = static_cast<Uint32>(std::max(std::min(Int64{Level.Width} - X0, Int64{FullPageSize}), Int64{FirstCol}));
+
+    const size_t SrcStride = size_t{Level.Width} * TexelSize;
+    for (Uint32 y = 0; y < FullPageSize; ++y)
+    {
+        const auto  SrcY    = static_cast<size_t>(std::min(std::max(Y0 + y, Int64{0}), Int64{Level.Height} - 1));
+        const auto* pSrcRow = Level.Texels.data() + SrcY * SrcStride;
+        auto*       pDstRow = pDst + size_t{y} * FullPageSize * TexelSize;
+
+        for (Uint32 x = 0; x < FirstCol; ++x)
+            memcpy(pDstRow + size_t{x} * TexelSize, pSrcRow, TexelSize);
+
+        if (EndCol > FirstCol)
+            memcpy(pDstRow + size_t{FirstCol} * TexelSize, pSrcRow + static_cast<size_t>(X0 + FirstCol) * TexelSize, size_t{EndCol - FirstCol} * TexelSize);
+
+        for (Uint32 x = EndCol; x < FullPageSize; ++x)
+            memcpy(pDstRow + size_t{x} * TexelSize, pSrcRow + SrcStride - TexelSize, TexelSize);
+    }
+}
+
+bool IsConstantTile(const std::vector<Uint8>& Data, Uint32 TexelSize)
+{
+    for (size_t i = TexelSize; i < Data.size(); i += TexelSize)
+    {
+        if (memcmp(&Data[i], &Data[0], TexelSize) != 0)
+            return false;
+    }
+    return true;
+}
+
+} // namespace
+
+void BuildVirtualTexture(const VirtualTextureBuildAttribs& Attribs,
+                         IDataBlob**                       ppPageFile)
+{
+    DEV_CHECK_ERR(ppPageFile != nullptr && *ppPageFile == nullptr, "ppPageFile must not be null and must point to null");
+
+    if (Attribs.pImage == nullptr)
+    {
+        LOG_ERROR_MESSAGE("Source image must not be null");
+        return;
+    }
+
+    const auto& ImgDesc = Attribs.pImage->GetDesc();
+    if (ImgDesc.ComponentType != VT_UINT8 || ImgDesc.NumComponents < 1 || ImgDesc.NumComponents > 4 ||
+        ImgDesc.Width == 0 || ImgDesc.Height == 0)
+    {
+        LOG_ERROR_MESSAGE("Virtual texture source image must be a non-empty 8-bit image with one to four components");
+        return;
+    }
+
+    if (Attribs.PageSize == 0)
+    {
+        LOG_ERROR_MESSAGE("Virtual texture page size must not be zero");
+        return;
+    }
+
+    const Uint32 NumComponents = ImgDesc.NumComponents == 3 ? 4 : ImgDesc.NumComponents;
+
+    VirtualTextureHeader Header;
+    switch (NumComponents)
+    {
+        case 1: Header.Format = TEX_FORMAT_R8_UNORM; break;
+        case 2: Header.Format = TEX_FORMAT_RG8_UNORM; break;
+        case 4: Header.Format = Attribs.IsSRGB ? TEX_FORMAT_RGBA8_UNORM_SRGB : TEX_FORMAT_RGBA8_UNORM; break;
+        default: UNEXPECTED("Unexpected number of components");
+    }
+    Header.Width      = ImgDesc.Width;
+    Header.Height     = ImgDesc.Height;
+    Header.PageSize   = Attribs.PageSize;
+    Header.BorderSize = Attribs.BorderSize;
+
+    const Uint32 MaxMipLevels = ComputeMipLevelsCount(ImgDesc.Width, ImgDesc.Height);
+    if (Attribs.MipLevels != 0)
+    {
+        Header.MipLevels = std::min(Attribs.MipLevels, MaxMipLevels);
+    }
+    else
+    {
+        // Generate levels until the level fits into a single page
+        Header.MipLevels = 1;
+        while (Header.MipLevels < MaxMipLevels &&
+               std::max(ImgDesc.Width >> (Header.MipLevels - 1), ImgDesc.Height >> (Header.MipLevels - 1)) > Attribs.PageSize)
+            ++Header.MipLevels;
+    }
+
+    const Uint32 TexelSize = NumComponents;
+
+    // Build the mip pyramid
+    std::vector<MipLevelTexels> Levels(Header.MipLevels);
+    {
+        auto& Level0  = Levels[0];
+        Level0.Width  = ImgDesc.Width;
+        Level0.Height = ImgDesc.Height;
+        Level0.Texels.resize(size_t{Level0.Width} * Level0.Height * TexelSize);
+
+        CopyPixelsAttribs CopyAttribs;
+        CopyAttribs.Width            = ImgDesc.Width;
+        CopyAttribs.Height           = ImgDesc.Height;
+        CopyAttribs.SrcComponentSize = 1;
+        CopyAttribs.pSrcPixels       = Attribs.pImage->GetData()->GetConstDataPtr();
+        CopyAttribs.SrcStride        = ImgDesc.RowStride;
+        CopyAttribs.SrcCompCount     = ImgDesc.NumComponents;
+        CopyAttribs.pDstPixels       = Level0.Texels.data();
+        CopyAttribs.DstComponentSize = 1;
+        CopyAttribs.DstStride        = Level0.Width * TexelSize;
+        CopyAttribs.DstCompCount     = NumComponents;
+        if (ImgDesc.NumComponents == 3)
+            CopyAttribs.Swizzle.A = TEXTURE_COMPONENT_SWIZZLE_ONE;
+        CopyPixels(CopyAttribs);
+    }
+    for (Uint32 Mip = 1; Mip < Header.MipLevels; ++Mip)
+    {
+        const auto& Fine   = Levels[Mip - 1];
+        auto&       Coarse = Levels[Mip];
+        Coarse.Width       = std::max(Fine.Width / 2u, 1u);
+        Coarse.Height      = std::max(Fine.Height / 2u, 1u);
+        Coarse.Texels.resize(size_t{Coarse.Width} * Coarse.Height * TexelSize);
+
+        ComputeMipLevelAttribs MipAttribs;
+        MipAttribs.Format          = static_cast<TEXTURE_FORMAT>(Header.Format);
+        MipAttribs.FineMipWidth    = Fine.Width;
+        MipAttribs.FineMipHeight   = Fine.Height;
+        MipAttribs.pFineMipData    = Fine.Texels.data();
+        MipAttribs.FineMipStride   = size_t{Fine.Width} * TexelSize;
+        MipAttribs.pCoarseMipData  = Coarse.Texels.data();
+        MipAttribs.CoarseMipStride = size_t{Coarse.Width} * TexelSize;
+        ComputeMipLevel(MipAttribs);
+    }
+
+    // Cut the levels into tiles
+    std::vector<VirtualTextureMipLevel> MipLevels(Header.MipLevels);
+    for (Uint32 Mip = 0; Mip < Header.MipLevels; ++Mip)
+    {
+        auto& MipLevel     = MipLevels[Mip];
+        MipLevel.Width     = Levels[Mip].Width;
+        MipLevel.Height    = Levels[Mip].Height;
+        MipLevel.TilesX    = (MipLevel.Width + Attribs.PageSize - 1) / Attribs.PageSize;
+        MipLevel.TilesY    = (MipLevel.Height + Attribs.PageSize - 1) / Attribs.PageSize;
+        MipLevel.FirstTile = Header.NumTiles;
+        Header.NumTiles += MipLevel.TilesX * MipLevel.TilesY;
+    }
+
+    const size_t PageDataSize = GetPageDataSize(Header);
+
+    std::vector<TileData> Tiles(Header.NumTiles);
+    ParallelFor(Attribs.pThreadPool, Header.NumTiles, [&](Uint32 Tile) {
+        const auto Mip = static_cast<Uint32>(std::upper_bound(MipLevels.begin(), MipLevels.end(), Tile,
+                                                              [](Uint32 Idx, const VirtualTextureMipLevel& Level) {
+                                                                  return Idx < Level.FirstTile;
+                                                              }) -
+                                             MipLevels.begin()) -
+            1;
+        const auto& MipLevel = MipLevels[Mip];
+        const auto  TileIdx  = Tile - MipLevel.FirstTile;
+
+        auto& Data = Tiles[Tile].Data;
+        Data.resize(PageDataSize);
+        CutTile(Levels[Mip], TileIdx % MipLevel.TilesX, TileIdx / MipLevel.TilesX, Attribs.PageSize, Attribs.BorderSize, TexelSize, Data.data());
+
+        if (IsConstantTile(Data, TexelSize))
+        {
+            Data.resize(TexelSize);
+            Tiles[Tile].Flags = VIRTUAL_TEXTURE_PAGE_FLAG_CONSTANT;
+        }
+        else if (Attribs.CompressPages)
+        {
+            std::vector<Uint8> Compressed(compressBound(static_cast<uLong>(Data.size())));
+
+            uLongf CompressedSize = static_cast<uLongf>(Compressed.size());
+            if (compress2(Compressed.data(), &CompressedSize, Data.data(), static_cast<uLong>(Data.size()), Z_DEFAULT_COMPRESSION) == Z_OK &&
+                CompressedSize < Data.size())
+            {
+                Compressed.resize(CompressedSize);
+                Data.swap(Compressed);
+                Tiles[Tile].Flags = VIRTUAL_TEXTURE_PAGE_FLAG_COMPRESSED;
+            }
+        }
+    });
+
+    // Assign pages to tiles. Tiles with the same constant color share the same page.
+    std::vector<Uint32>               PageTable(Header.NumTiles);
+    std::vector<Uint32>               PageTiles; // The tile whose data is stored in the page
+    std::unordered_map<Uint32, Uint32> ConstantPages;
+    for (Uint32 Tile = 0; Tile < Header.NumTiles; ++Tile)
+    {
+        if (Tiles[Tile].Flags & VIRTUAL_TEXTURE_PAGE_FLAG_CONSTANT)
+        {
+            Uint32 Color = 0;
+            memcpy(&Color, Tiles[Tile].Data.data(), TexelSize);
+
+            auto it = ConstantPages.emplace(Color, static_cast<Uint32>(PageTiles.size()));
+            if (it.second)
+                PageTiles.push_back(Tile);
+            PageTable[Tile] = it.first->second;
+        }
+        else
+        {
+            PageTable[Tile] = static_cast<Uint32>(PageTiles.size());
+            PageTiles.push_back(Tile);
+        }
+    }
+    Header.NumPages = static_cast<Uint32>(PageTiles.size());
+
+    const VirtualTextureLayout Layout{Header};
+
+    std::vector<VirtualTexturePageEntry> Pages(Header.NumPages);
+
+    Uint64 DataOffset = Layout.DataOffset;
+    for (Uint32 Page = 0; Page < Header.NumPages; ++Page)
+    {
+        const auto& Tile = Tiles[PageTiles[Page]];
+
+        Pages[Page].Offset = DataOffset;
+        Pages[Page].Size   = static_cast<Uint32>(Tile.Data.size());
+        Pages[Page].Flags  = Tile.Flags;
+        DataOffset += Tile.Data.size();
+    }
+
+    auto  pPageFile = DataBlobImpl::Create(static_cast<size_t>(DataOffset));
+    auto* pDstData  = static_cast<Uint8*>(pPageFile->GetDataPtr());
+    memcpy(pDstData, &Header, sizeof(Header));
+    memcpy(pDstData + Layout.MipLevelsOffset, MipLevels.data(), sizeof(VirtualTextureMipLevel) * MipLevels.size());
+    memcpy(pDstData + Layout.PageTableOffset, PageTable.data(), sizeof(Uint32) * PageTable.size());
+    if (!Pages.empty())
+        memcpy(pDstData + Layout.PagesOffset, Pages.data(), sizeof(VirtualTexturePageEntry) * Pages.size());
+    for (Uint32 Page = 0; Page < Header.NumPages; ++Page)
+    {
+        const auto& Data = Tiles[PageTiles[Page]].Data;
+        memcpy(pDstData + Pages[Page].Offset, Data.data(), Data.size());
+    }
+
+    *ppPageFile = pPageFile.Detach();
+}
+
+Bool GetVirtualTexturePage(const void*              pTableData,
+                           size_t                   TableDataSize,
+                           Uint64                   FileSize,
+                           Uint32                   MipLevel,
+                           Uint32                   TileX,
+                           Uint32                   TileY,
+                           VirtualTexturePageEntry& Entry)
+{
+    // All table reads below are bounded by TableDataSize, which is checked here
+    VirtualTextureHeader Header;
+    if (!ReadVirtualTextureHeader(pTableData, TableDataSize, Header))
+        return False;
+
+    if (MipLevel >= Header.MipLevels)
+        return False;
+
+    const VirtualTextureLayout Layout{Header};
+    const auto*                pData = static_cast<const Uint8*>(pTableData);
+
+    VirtualTextureMipLevel Level;
+    memcpy(&Level, pData + Layout.MipLevelsOffset + sizeof(VirtualTextureMipLevel) * MipLevel, sizeof(Level));
+    if (TileX >= Level.TilesX || TileY >= Level.TilesY)
+        return False;
+
+    const auto Tile = Level.FirstTile + TileY * Level.TilesX + TileX;
+    if (Tile >= Header.NumTiles)
+        return False;
+
+    Uint32 Page = 0;
+    memcpy(&Page, pData + Layout.PageTableOffset + sizeof(Uint32) * Tile, sizeof(Page));
+    if (Page >= Header.NumPages)
+        return False;
+
+    VirtualTexturePageEntry PageEntry;
+    memcpy(&PageEntry, pData + Layout.PagesOffset + sizeof(VirtualTexturePageEntry) * Page, sizeof(PageEntry));
+    // The page data must be located after the tables and within the file
+    if (PageEntry.Offset < Layout.DataOffset ||
+        PageEntry.Offset > FileSize ||
+        PageEntry.Size > FileSize - PageEntry.Offset)
+        return False;
+
+    Entry = PageEntry;
+    return True;
+}
+
+Bool DecodeVirtualTexturePage(const VirtualTextureHeader&    Header,
+                              const VirtualTexturePageEntry& Entry,
+                              const void*                    pPageData,
+                              void*                          pTexels)
+{
+    DEV_CHECK_ERR(pPageData != nullptr, "Page data must not be null");
+    DEV_CHECK_ERR(pTexels != nullptr, "Texels must not be null");
+
+    const auto   PageDataSize = GetPageDataSize(Header);
+    const Uint32 TexelSize    = GetTextureFormatAttribs(static_cast<TEXTURE_FORMAT>(Header.Format)).GetElementSize();
+    if (PageDataSize == 0)
+        return False;
+
+    auto* pDst = static_cast<Uint8*>(pTexels);
+    if (Entry.Flags & VIRTUAL_TEXTURE_PAGE_FLAG_CONSTANT)
+    {
+        if (Entry.Size != TexelSize)
+            return False;
+        for (size_t Offset = 0; Offset < PageDataSize; Offset += TexelSize)
+            memcpy(pDst + Offset, pPageData, TexelSize);
+    }
+    else if (Entry.Flags & VIRTUAL_TEXTURE_PAGE_FLAG_COMPRESSED)
+    {
+        uLongf DstSize = static_cast<uLongf>(PageDataSize);
+        if (uncompress(pDst, &DstSize, static_cast<const Bytef*>(pPageData), static_cast<uLong>(Entry.Size)) != Z_OK ||
+            DstSize != PageDataSize)
+            return False;
+    }
+    else
+    {
+        if (Entry.Size != PageDataSize)
+            return False;
+        memcpy(pDst, pPageData, PageDataSize);
+    }
+
+    return True;
+}
+
+} // namespace Diligent
+
+extern "C"
+{
+    void Diligent_BuildVirtualTexture(const Diligent::VirtualTextureBuildAttribs& Attribs,
+                                      Diligent::IDataBlob**                       ppPageFile)
+    {
+        Diligent::BuildVirtualTexture(Attribs, ppPageFile);
+    }
+
+    Diligent::Bool Diligent_GetVirtualTexturePage(const void*                        pTableData,
+                                                  size_t                             TableDataSize,
+                                                  Diligent::Uint64                   FileSize,
+                                                  Diligent::Uint32                   MipLevel,
+                                                  Diligent::Uint32                   TileX,
+                                                  Diligent::Uint32                   TileY,
+                                                  Diligent::VirtualTexturePageEntry& Entry)
+    {
+        return Diligent::GetVirtualTexturePage(pTableData, TableDataSize, FileSize, MipLevel, TileX, TileY, Entry);
+    }
+
+    Diligent::Bool Diligent_DecodeVirtualTexturePage(const Diligent::VirtualTextureHeader&    Header,
+                                                     const Diligent::VirtualTexturePageEntry& Entry,
+                                                     const void*                              pPageData,
+                                                     void*                                    pTexels)
+    {
+        return Diligent::DecodeVirtualTexturePage(Header, Entry, pPageData, pTexels);
+    }
+}